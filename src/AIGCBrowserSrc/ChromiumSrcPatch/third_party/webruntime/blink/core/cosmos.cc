@@ -236,7 +236,7 @@ void Cosmos::InitWinFormByUrl(const String& url, const int64_t formhandle) {
     setStr("openurl", url);
     setLong("BrowserWndOpenDisposition", 1965);
     setInt64("InitFormHandle", formhandle);
-    m_pRenderframeImpl->SendCosmosMessageEx(session_);
+    SendSession(this);
   }
   // if (bwait)
   //	run_loop_.Run();
@@ -261,7 +261,7 @@ void Cosmos::InitWinFormByUrl(const String& url,
       mapWebRTEventCallback_.insert(callbackid_, callback);
       m_pRenderframeImpl->m_mapWebRTSession[S2w(callbackid_)] = this;
     }
-    m_pRenderframeImpl->SendCosmosMessageEx(session_);
+    SendSession(this);
   }
   // if (bwait)
   //	run_loop_.Run();
@@ -287,7 +287,7 @@ void Cosmos::InitWinFormByUrl(const String& url,
       mapWebRTEventCallback_.insert(callbackid_, callback);
       m_pRenderframeImpl->m_mapWebRTSession[S2w(callbackid_)] = this;
     }
-    m_pRenderframeImpl->SendCosmosMessageEx(session_);
+    SendSession(this);
   }
   // if (bwait)
   //	run_loop_.Run();
@@ -312,7 +312,7 @@ CosmosWinform* Cosmos::InitWinForm(const String& strFormXml,
     form->setInt64("InitWinFormHandle", (int64_t)formhandle);
     form->setStr("formXml", strFormXml);
     // form->setLong("formType", FormType);
-    m_pRenderframeImpl->SendCosmosMessageEx(form->session_);
+    SendSession(form);
   }
   return form;
 }
@@ -340,7 +340,7 @@ CosmosWinform* Cosmos::InitWinForm(const String& strFormXml,
     form->setInt64("InitWinFormHandle", (int64_t)formhandle);
     form->setStr("formXml", strFormXml);
     // form->setLong("formType", FormType);
-    m_pRenderframeImpl->SendCosmosMessageEx(form->session_);
+    SendSession(form);
   }
   return form;
 }
@@ -367,7 +367,7 @@ CosmosWinform* Cosmos::InitWinForm(Element* elem,
     form->setInt64("form", (int64_t)form);
     form->setInt64("InitWinFormHandle", (int64_t)formhandle);
     form->setStr("formXml", elem->outerHTML());
-    m_pRenderframeImpl->SendCosmosMessageEx(form->session_);
+    SendSession(form);
   }
   return form;
 }
@@ -389,7 +389,7 @@ CosmosWinform* Cosmos::InitWinForm(Element* elem, const int64_t formhandle) {
     form->setInt64("form", (int64_t)form);
     form->setInt64("InitWinFormHandle", (int64_t)formhandle);
     form->setStr("formXml", elem->outerHTML());
-    m_pRenderframeImpl->SendCosmosMessageEx(form->session_);
+    SendSession(form);
   }
   return form;
 }
@@ -407,7 +407,7 @@ CosmosWinform* Cosmos::createWinForm(Element* elem, const long FormType) {
     form->setInt64("form", (int64_t)form);
     form->setStr("formXml", elem->outerHTML());
     form->setLong("formType", FormType);
-    m_pRenderframeImpl->SendCosmosMessageEx(form->session_);
+    SendSession(form);
   }
   return form;
 }
@@ -430,7 +430,7 @@ CosmosWinform* Cosmos::createWinForm(Element* elem,
     form->setInt64("form", (int64_t)form);
     form->setStr("formXml", elem->outerHTML());
     form->setLong("formType", FormType);
-    m_pRenderframeImpl->SendCosmosMessageEx(form->session_);
+    SendSession(form);
   }
   return form;
 }
@@ -449,7 +449,7 @@ CosmosWinform* Cosmos::createWinForm(const String& strFormXml,
     form->setInt64("form", (int64_t)form);
     form->setStr("formXml", strFormXml);
     form->setLong("formType", FormType);
-    m_pRenderframeImpl->SendCosmosMessageEx(form->session_);
+    SendSession(form);
   }
   return form;
 }
@@ -472,7 +472,7 @@ CosmosWinform* Cosmos::createWinForm(const String& strFormXml,
     form->setInt64("form", (int64_t)form);
     form->setStr("formXml", strFormXml);
     form->setLong("formType", FormType);
-    m_pRenderframeImpl->SendCosmosMessageEx(form->session_);
+    SendSession(form);
   }
   return form;
 }
@@ -487,7 +487,7 @@ CosmosXobj* Cosmos::createObject(Element* elem) {
     var->setStr("objID", "CLROBJ");
     var->setInt64("objhandle", (int64_t)var);
     var->setStr("objXml", elem->outerHTML());
-    m_pRenderframeImpl->SendCosmosMessageEx(var->session_);
+    SendSession(var);
   }
   return var;
 }
@@ -506,7 +506,7 @@ CosmosXobj* Cosmos::createObject(Element* elem,
     var->setStr("objID", "CLROBJ");
     var->setInt64("objhandle", (int64_t)var);
     var->setStr("objXml", elem->outerHTML());
-    m_pRenderframeImpl->SendCosmosMessageEx(var->session_);
+    SendSession(var);
   }
   return var;
 }
@@ -521,7 +521,7 @@ CosmosXobj* Cosmos::createObject(const String& strObjXml) {
     var->setStr("objID", "CLROBJ");
     var->setInt64("objhandle", (int64_t)var);
     var->setStr("objXml", strObjXml);
-    m_pRenderframeImpl->SendCosmosMessageEx(var->session_);
+    SendSession(var);
   }
   return var;
 }
@@ -540,7 +540,7 @@ CosmosXobj* Cosmos::createObject(const String& strObjXml,
     var->setStr("objID", "CLROBJ");
     var->setInt64("objhandle", (int64_t)var);
     var->setStr("objXml", strObjXml);
-    m_pRenderframeImpl->SendCosmosMessageEx(var->session_);
+    SendSession(var);
   }
   return var;
 }
@@ -550,7 +550,7 @@ void Cosmos::RecalcLayoutWnd(int64_t hWndHandle, long delaytime) {
     this->setStr("objID", "WebRT_RecalcLayoutWnd");
     this->setInt64("workhandle", (int64_t)hWndHandle);
     this->setLong("workdelaytime", delaytime);
-    m_pRenderframeImpl->SendCosmosMessageEx(this->session_);
+    SendSession(this);
   }
 }
 
@@ -560,7 +560,7 @@ void Cosmos::ReDrawWnd(int64_t hWndHandle, long delaytime) {
     this->setStr("objID", "WebRT_ReDrawWnd");
     this->setInt64("workhandle", (int64_t)hWndHandle);
     this->setLong("workdelaytime", delaytime);
-    m_pRenderframeImpl->SendCosmosMessageEx(this->session_);
+    SendSession(this);
   }
 }
 
@@ -847,6 +847,9 @@ void Cosmos::OnMessage(Element* e, CosmosXobj* msg, const String& eventName) {
 void Cosmos::DispatchXobjEvent(CosmosXobj* xObj,
                                const String& ctrlName,
                                const String& eventName) {
+  if (eventName == "OnTextChanged") {
+    xObj->OnCtrlValueFromHost(ctrlName);
+  }
   xObj->fireEvent(eventName + "@" + ctrlName, xObj);
   bool bFormMsgProcessed = false;
   bool bXobjMsgProcessed = false;
@@ -942,7 +945,7 @@ void Cosmos::DispatchXobjEvent(CosmosXobj* xObj,
           xobjfortarget->DispatchEvent(*pEvent);
           xobjfortarget->setMsgID(ctrlName_ + "_" + eventName);
           xobjfortarget->setStr("eventdata", elem->outerHTML());
-          m_pRenderframeImpl->SendCosmosMessageEx(xobjfortarget->session_);
+          SendSession(xobjfortarget);
         }
       }
     }
@@ -1082,7 +1085,20 @@ CosmosNode* Cosmos::createCosmosNode(CosmosXobj* xobj) {
   if (nPHandle) {
     auto it = m_mapWebRTNode.find(nPHandle);
     if (it != m_mapWebRTNode.end()) {
-      it->value->m_mapChildNode2.insert(strname, node);
+      it->value->AddChild(handle, strname, this);
+    }
+  }
+  // children that reached the page before this node: the host lists the
+  // handle of every cell under its index
+  for (auto& it : node->session_.m_mapint64) {
+    if (it.first.empty() ||
+        it.first.find_first_not_of(L"0123456789") != std::wstring::npos) {
+      continue;
+    }
+    auto itChild = m_mapWebRTNode.find(it.second);
+    if (itChild != m_mapWebRTNode.end() && itChild->value != node &&
+        itChild->value->getInt64("parenthandle") == handle) {
+      node->AddChild(it.second, itChild->value->getStr("name@page"), this);
     }
   }
   __int64 nGalaxyHandle = xobj->getInt64("Galaxyhandle");
@@ -1201,7 +1217,7 @@ CosmosNode* Cosmos::createCosmosNode(CosmosXobj* xobj) {
                 if (breferenced) {
                   node->setStr("msgID", "SET_REFGRIDS_IPC_MSG");
                   node->setStr("RefInfo", node->refElem_->outerHTML());
-                  m_pRenderframeImpl->SendCosmosMessageEx(node->session_);
+                  SendSession(node);
                 }
               }
             } else if (strTagName == "eventmap" &&
@@ -1224,7 +1240,7 @@ CosmosNode* Cosmos::createCosmosNode(CosmosXobj* xobj) {
                       node->setStr("BindObj", name2);
                       node->setStr("Bindevent", eventname);
                       node->m_mapElement.insert(strIndex, elemEvent);
-                      m_pRenderframeImpl->SendCosmosMessageEx(node->session_);
+                      SendSession(node);
                       // if (enableConsoleInfo_)
                       //  DomWindow()->GetFrame()->AddMessageToConsole(
                       //      blink::mojom::ConsoleMessageLevel::kInfo,
@@ -1247,7 +1263,7 @@ CosmosNode* Cosmos::createCosmosNode(CosmosXobj* xobj) {
             WebLocalFrameImpl::FromFrame(DomWindow()->GetFrame())->Client();
       }
       if (m_pRenderframeImpl) {
-        m_pRenderframeImpl->SendCosmosMessageEx(node->session_);
+        SendSession(node);
       }
     }
   }
@@ -1606,7 +1622,7 @@ void Cosmos::sendMessage(CosmosXobj* msg,
       mapWebRTEventCallback_.insert(callbackid_, callback);
       m_pRenderframeImpl->m_mapWebRTSession[S2w(callbackid_)] = this;
     }
-    m_pRenderframeImpl->SendCosmosMessageEx(msg->session_);
+    SendSession(msg);
   }
   // DomWindow()->GetFrame()->AddMessageToConsole(
   //    blink::mojom::ConsoleMessageLevel::kInfo, "test", true);
@@ -1622,7 +1638,7 @@ void Cosmos::sendMessage(CosmosXobj* msg) {
       msg = this;
     }
     msg->setStr("senderid", getid());
-    m_pRenderframeImpl->SendCosmosMessageEx(msg->session_);
+    SendSession(msg);
   }
   // DomWindow()->GetFrame()->AddMessageToConsole(
   //    blink::mojom::ConsoleMessageLevel::kInfo, "test", true);
@@ -1644,7 +1660,7 @@ void Cosmos::sendMessage(CosmosXobj* msg, V8ApplicationCallback* callback) {
       mapWebRTEventCallback_.insert(callbackid_, callback);
       m_pRenderframeImpl->m_mapWebRTSession[S2w(callbackid_)] = this;
     }
-    m_pRenderframeImpl->SendCosmosMessageEx(msg->session_);
+    SendSession(msg);
   }
   // DomWindow()->GetFrame()->AddMessageToConsole(
   //    blink::mojom::ConsoleMessageLevel::kInfo, "test", true);
@@ -1659,7 +1675,7 @@ void Cosmos::openMainWndUrls(String strUrls) {
     setStr("senderid", getid());
     setStr("msgID", "OPEN_MainWindowURLs");
     setStr("openurl", strUrls);
-    m_pRenderframeImpl->SendCosmosMessageEx(session_);
+    SendSession(this);
   }
 }
 
@@ -1669,7 +1685,7 @@ void Cosmos::openUrl(const String& url, long nBrowserWndOpenDisposition) {
     setStr("msgID", "OPEN_URL");
     setStr("openurl", url);
     setLong("BrowserWndOpenDisposition", nBrowserWndOpenDisposition);
-    m_pRenderframeImpl->SendCosmosMessageEx(session_);
+    SendSession(this);
   }
   // if (bwait)
   //	run_loop_.Run();
@@ -1689,7 +1705,7 @@ void Cosmos::openUrl(const String& url,
       mapWebRTEventCallback_.insert(callbackid_, callback);
       m_pRenderframeImpl->m_mapWebRTSession[S2w(callbackid_)] = this;
     }
-    m_pRenderframeImpl->SendCosmosMessageEx(session_);
+    SendSession(this);
   }
   // if (bwait)
   //	run_loop_.Run();
@@ -1710,7 +1726,7 @@ void Cosmos::openUrl(const String& url,
       mapWebRTEventCallback_.insert(callbackid_, callback);
       m_pRenderframeImpl->m_mapWebRTSession[S2w(callbackid_)] = this;
     }
-    m_pRenderframeImpl->SendCosmosMessageEx(session_);
+    SendSession(this);
   }
   // if (bwait)
   //	run_loop_.Run();
@@ -21,6 +21,7 @@
  *******************************************************************************/
 
 #include "cosmos_node.h"
+#include <algorithm>
 #include "cosmos.h"
 #include "cosmos_compositor.h"
 #include "cosmos_control.h"
@@ -102,21 +103,43 @@ CosmosXobj* CosmosNode::parentForm() {
 }
 
 CosmosNode* CosmosNode::getChild(long nIndex) {
-  return getChild(0, nIndex);
+  if (nIndex < 0 || nIndex >= (long)m_vecGridCell.size()) {
+    return nullptr;
+  }
+  return m_vecGridCell[nIndex].Get();
 }
 
 CosmosNode* CosmosNode::getChild(long row, long col) {
-  int nIndex = col + row * getLong("rows");
-  std::string strIndex = base::NumberToString(nIndex);
-  String strname = strIndex.c_str();
-  int64_t nHandle = getInt64(strname);
-  if (nHandle) {
-    auto it = cosmos_->m_mapWebRTNode.find(nHandle);
-    if (it != cosmos_->m_mapWebRTNode.end()) {
-      return it->value.Get();
+  if (row < 0 || col < 0 || row >= m_nGridRows || col >= m_nGridCols) {
+    return nullptr;
+  }
+  return m_vecGridCell[row * m_nGridCols + col].Get();
+}
+
+void CosmosNode::SetGridCell(long row, long col, CosmosNode* node) {
+  if (row < 0 || col < 0) {
+    return;
+  }
+  if (m_vecGridCell.empty()) {
+    m_nGridRows = std::max(getLong("rows"), 0L);
+    m_nGridCols = std::max(getLong("cols"), 0L);
+    m_vecGridCell.resize(m_nGridRows * m_nGridCols);
+  }
+  if (row >= m_nGridRows || col >= m_nGridCols) {
+    long nRows = std::max(m_nGridRows, row + 1);
+    long nCols = std::max(m_nGridCols, col + 1);
+    HeapVector<Member<CosmosNode>> vecCell;
+    vecCell.resize(nRows * nCols);
+    for (long r = 0; r < m_nGridRows; r++) {
+      for (long c = 0; c < m_nGridCols; c++) {
+        vecCell[r * nCols + c] = m_vecGridCell[r * m_nGridCols + c];
+      }
     }
+    m_vecGridCell.swap(vecCell);
+    m_nGridRows = nRows;
+    m_nGridCols = nCols;
   }
-  return nullptr;
+  m_vecGridCell[row * m_nGridCols + col] = node;
 }
 
 CosmosNode* CosmosNode::getChild(const String& strName) {
@@ -147,6 +170,7 @@ void CosmosNode::Trace(blink::Visitor* visitor) const {
   visitor->Trace(m_mapChildNode);
   visitor->Trace(m_mapChildNode2);
   visitor->Trace(m_mapXobj);
+  visitor->Trace(m_vecGridCell);
 }
 
 // void CosmosNode::ShowWebContent(const String& strParentDivName, const String&
@@ -259,7 +283,7 @@ void CosmosNode::Observe(const String& strKey, const String& xml) {
     setStr("msgID", "OPEN_XML");
     setStr("openkey", strKey);
     setStr("openxml", xml);
-    m_pRenderframeImpl->SendCosmosMessageEx(session_);
+    SendSession(this);
   }
 }
 
@@ -279,7 +303,7 @@ void CosmosNode::Observe(const String& strKey,
     if (callback) {
       mapWebRTEventCallback_.insert(callbackid_, callback);
     }
-    m_pRenderframeImpl->SendCosmosMessageEx(session_);
+    SendSession(this);
   }
 }
 
@@ -292,7 +316,7 @@ void CosmosNode::Observe(const String& strCtrlName,
     setStr("ctrlName", strCtrlName);
     setStr("openkey", strKey);
     setStr("openxml", xml);
-    m_pRenderframeImpl->SendCosmosMessageEx(session_);
+    SendSession(this);
     setStr("msgID", "");
   }
 }
@@ -315,7 +339,7 @@ void CosmosNode::Observe(const String& strCtrlName,
     if (callback) {
       mapWebRTEventCallback_.insert(callbackid_, callback);
     }
-    m_pRenderframeImpl->SendCosmosMessageEx(session_);
+    SendSession(this);
     setStr("msgID", "");
   }
 }
@@ -331,7 +355,7 @@ void CosmosNode::Observe(long row,
     setStr("openxml", xml);
     setLong("opencol", col);
     setLong("openrow", row);
-    m_pRenderframeImpl->SendCosmosMessageEx(session_);
+    SendSession(this);
   }
 }
 
@@ -354,7 +378,7 @@ void CosmosNode::Observe(long row,
     if (callback) {
       mapWebRTEventCallback_.insert(callbackid_, callback);
     }
-    m_pRenderframeImpl->SendCosmosMessageEx(session_);
+    SendSession(this);
   }
 }
 
@@ -364,7 +388,7 @@ void CosmosNode::ObserveEx(const String& strKey, Element* elem) {
     setStr("msgID", "OPEN_XML");
     setStr("openkey", strKey);
     setStr("openxml", elem->outerHTML());
-    m_pRenderframeImpl->SendCosmosMessageEx(session_);
+    SendSession(this);
   }
 }
 
@@ -383,7 +407,7 @@ void CosmosNode::ObserveEx(const String& strKey,
     if (callback) {
       mapWebRTEventCallback_.insert(callbackid_, callback);
     }
-    m_pRenderframeImpl->SendCosmosMessageEx(session_);
+    SendSession(this);
   }
 }
 
@@ -396,7 +420,7 @@ void CosmosNode::ObserveEx(const String& strCtrlName,
     setStr("ctrlName", strCtrlName);
     setStr("openkey", strKey);
     setStr("openxml", elem->outerHTML());
-    m_pRenderframeImpl->SendCosmosMessageEx(session_);
+    SendSession(this);
     setStr("msgID", "");
   }
 }
@@ -418,7 +442,7 @@ void CosmosNode::ObserveEx(const String& strCtrlName,
     if (callback) {
       mapWebRTEventCallback_.insert(callbackid_, callback);
     }
-    m_pRenderframeImpl->SendCosmosMessageEx(session_);
+    SendSession(this);
     setStr("msgID", "");
   }
 }
@@ -434,7 +458,7 @@ void CosmosNode::ObserveEx(long row,
     setStr("openxml", elem->outerHTML());
     setLong("opencol", col);
     setLong("openrow", row);
-    m_pRenderframeImpl->SendCosmosMessageEx(session_);
+    SendSession(this);
   }
 }
 
@@ -457,7 +481,7 @@ void CosmosNode::ObserveEx(long row,
     if (callback) {
       mapWebRTEventCallback_.insert(callbackid_, callback);
     }
-    m_pRenderframeImpl->SendCosmosMessageEx(session_);
+    SendSession(this);
   }
 }
 
@@ -500,8 +524,7 @@ void CosmosNode::DispatchXobjEvent(Element* e, const String& eventName) {
                     xobjfortarget));
                 xobjfortarget->setMsgID(msgID);
                 xobjfortarget->setStr("eventdata", elem->outerHTML());
-                m_pRenderframeImpl->SendCosmosMessageEx(
-                    xobjfortarget->session_);
+                SendSession(xobjfortarget);
               }
             }
           }
@@ -606,6 +629,10 @@ CosmosNode* CosmosNode::AddChild(int64_t nHandle,
     node = it->value;
     int nSize = (int)m_mapChildNode.size();
     m_mapChildNode.insert(nSize, node);
+    if (strNodeName != "") {
+      m_mapChildNode2.insert(strNodeName, node);
+    }
+    SetGridCell(node->getLong("row"), node->getLong("col"), node);
   }
   return node;
 }
@@ -25,6 +25,7 @@
 
 #include <map>
 #include "cosmos_xobj.h"
+#include "third_party/blink/renderer/platform/heap/collection_support/heap_vector.h"
 
 namespace blink {
 
@@ -141,6 +142,10 @@ class CORE_EXPORT CosmosNode final : public CosmosXobj {
 
   ~CosmosNode() override;
 
+  // places a child created by the host in the cell table from its own
+  // row and col, the table grows when the child lies outside of it
+  void SetGridCell(long row, long col, CosmosNode* node);
+
   int64_t handle_ = 0;
 
   String name_;
@@ -151,6 +156,11 @@ class CORE_EXPORT CosmosNode final : public CosmosXobj {
   HeapHashMap<int, Member<CosmosNode>> m_mapChildNode;
   HeapHashMap<String, Member<CosmosNode>> m_mapXobj;
   HeapHashMap<String, Member<CosmosNode>> m_mapChildNode2;
+
+  // child grid cells, row major with m_nGridCols cells per row
+  long m_nGridRows = 0;
+  long m_nGridCols = 0;
+  HeapVector<Member<CosmosNode>> m_vecGridCell;
 };
 
 }  // namespace blink
@@ -0,0 +1,146 @@
+﻿/********************************************************************************
+ *           Web Runtime for Application - Version 1.0.1.202111090001 *
+ ********************************************************************************
+ * Copyright (C) 2002-2021 by TangramTeam.   All Rights Reserved.
+ * There are Three Key Features of Webruntime:
+ * 1. Built-in Modern Web Browser: Independent Browser Window and Browser Window
+ *    as sub windows of other windows are supported in the application process;
+ * 2. DOM Plus: DOMPlus is a natural extension of the standard DOM system.
+ *    It allows the application system to support a kind of generalized web
+ *pages, which are composed of standard DOM elements and binary components
+ *supported by the application system;
+ * 3. JavaScript for Application: Similar to VBA in MS office, JavaScript will
+ *    become a built-in programmable language in the application system, so that
+ *    the application system can be expanded and developed for the Internet
+ *based on modern javscript/Web technology. Use of this source code is governed
+ *by a BSD-style license that can be found in the LICENSE file.
+ *
+ * CONTACT INFORMATION:
+ * mailto:TangramTeam@outlook.com or mailto:sunhuizlz@yeah.net
+ * https://www.webruntime.com
+ *******************************************************************************/
+
+#include "cosmos_query_index.h"
+
+#include "third_party/blink/renderer/bindings/core/v8/v8_mutation_observer_init.h"
+#include "third_party/blink/renderer/core/dom/container_node.h"
+#include "third_party/blink/renderer/core/dom/element.h"
+#include "third_party/blink/renderer/core/dom/element_traversal.h"
+#include "third_party/blink/renderer/core/dom/static_node_list.h"
+#include "third_party/blink/renderer/platform/bindings/exception_state.h"
+
+namespace blink {
+
+CosmosQueryIndex::CosmosQueryIndex(ContainerNode* scope) : scope_(scope) {}
+
+Element* CosmosQueryIndex::GetElementById(const AtomicString& id) {
+  if (id.empty()) {
+    return nullptr;
+  }
+  EnsureIndex();
+  auto it = id_map_.find(id);
+  if (it != id_map_.end()) {
+    return it->value.Get();
+  }
+  return nullptr;
+}
+
+StaticElementList* CosmosQueryIndex::GetElementsByName(
+    const AtomicString& name) {
+  EnsureIndex();
+  auto it = name_lists_.find(name);
+  if (it != name_lists_.end()) {
+    return it->value.Get();
+  }
+  HeapVector<Member<Element>> elements;
+  AppendElementsByName(name, elements);
+  StaticElementList* list = StaticElementList::Adopt(elements);
+  name_lists_.insert(name, list);
+  return list;
+}
+
+void CosmosQueryIndex::AppendElementsByName(
+    const AtomicString& name,
+    HeapVector<Member<Element>>& result) {
+  EnsureIndex();
+  auto it = name_map_.find(name);
+  if (it != name_map_.end()) {
+    result.AppendVector(*it->value);
+  }
+}
+
+void CosmosQueryIndex::Detach() {
+  if (observer_) {
+    observer_->disconnect();
+    observer_ = nullptr;
+  }
+  valid_ = false;
+}
+
+void CosmosQueryIndex::EnsureIndex() {
+  // records not delivered yet are changes made since the index was built
+  if (valid_ && !observer_->takeRecords().empty()) {
+    valid_ = false;
+  }
+  if (valid_ || scope_ == nullptr) {
+    return;
+  }
+  if (observer_ == nullptr) {
+    observer_ = MutationObserver::Create(this);
+    MutationObserverInit* init = MutationObserverInit::Create();
+    init->setChildList(true);
+    init->setSubtree(true);
+    init->setAttributes(true);
+    init->setAttributeFilter({"id", "name"});
+    observer_->observe(scope_, init, ASSERT_NO_EXCEPTION);
+  } else {
+    observer_->takeRecords();
+  }
+  id_map_.clear();
+  name_map_.clear();
+  name_lists_.clear();
+  if (auto* element = DynamicTo<Element>(scope_.Get())) {
+    AddElement(*element);
+  }
+  for (Element& element : ElementTraversal::DescendantsOf(*scope_)) {
+    AddElement(element);
+  }
+  valid_ = true;
+}
+
+void CosmosQueryIndex::AddElement(Element& element) {
+  const AtomicString& id = element.GetIdAttribute();
+  if (!id.empty()) {
+    // insert keeps the first element with this id
+    id_map_.insert(id, &element);
+  }
+  const AtomicString& name = element.GetNameAttribute();
+  if (!name.empty()) {
+    auto result = name_map_.insert(name, nullptr);
+    if (result.is_new_entry) {
+      result.stored_value->value =
+          MakeGarbageCollected<GCedHeapVector<Member<Element>>>();
+    }
+    result.stored_value->value->push_back(&element);
+  }
+}
+
+ExecutionContext* CosmosQueryIndex::GetExecutionContext() const {
+  return scope_ ? scope_->GetExecutionContext() : nullptr;
+}
+
+void CosmosQueryIndex::Deliver(const MutationRecordVector& records,
+                               MutationObserver& observer) {
+  valid_ = false;
+}
+
+void CosmosQueryIndex::Trace(Visitor* visitor) const {
+  visitor->Trace(scope_);
+  visitor->Trace(observer_);
+  visitor->Trace(id_map_);
+  visitor->Trace(name_map_);
+  visitor->Trace(name_lists_);
+  MutationObserver::Delegate::Trace(visitor);
+}
+
+}  // namespace blink
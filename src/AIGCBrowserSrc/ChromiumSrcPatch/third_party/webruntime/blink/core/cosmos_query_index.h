@@ -0,0 +1,77 @@
+/********************************************************************************
+ *           Web Runtime for Application - Version 1.0.1.202111090001 *
+ ********************************************************************************
+ * Copyright (C) 2002-2021 by TangramTeam.   All Rights Reserved.
+ * There are Three Key Features of Webruntime:
+ * 1. Built-in Modern Web Browser: Independent Browser Window and Browser Window
+ *    as sub windows of other windows are supported in the application process;
+ * 2. DOM Plus: DOMPlus is a natural extension of the standard DOM system.
+ *    It allows the application system to support a kind of generalized web
+ *pages, which are composed of standard DOM elements and binary components
+ *supported by the application system;
+ * 3. JavaScript for Application: Similar to VBA in MS office, JavaScript will
+ *    become a built-in programmable language in the application system, so that
+ *    the application system can be expanded and developed for the Internet
+ *based on modern javscript/Web technology. Use of this source code is governed
+ *by a BSD-style license that can be found in the LICENSE file.
+ *
+ * CONTACT INFORMATION:
+ * mailto:TangramTeam@outlook.com or mailto:sunhuizlz@yeah.net
+ * https://www.webruntime.com
+ *******************************************************************************/
+
+#ifndef THIRD_PARTY_BLINK_RENDERER_CORE_FRAME_COSMOS_QUERY_INDEX_H_
+#define THIRD_PARTY_BLINK_RENDERER_CORE_FRAME_COSMOS_QUERY_INDEX_H_
+
+#include "third_party/blink/renderer/core/core_export.h"
+#include "third_party/blink/renderer/core/dom/mutation_observer.h"
+#include "third_party/blink/renderer/platform/heap/collection_support/heap_hash_map.h"
+#include "third_party/blink/renderer/platform/heap/collection_support/heap_vector.h"
+#include "third_party/blink/renderer/platform/wtf/text/atomic_string.h"
+
+namespace blink {
+
+class Element;
+class ContainerNode;
+class StaticElementList;
+
+// Id and name index of the elements in one query scope of a CosmosXobj, the
+// fragment of a root node or the host element of any other node. The index
+// is built on the first query and dropped once a mutation observer on the
+// scope reports a change of its children or of an id or name attribute.
+class CORE_EXPORT CosmosQueryIndex final : public MutationObserver::Delegate {
+ public:
+  explicit CosmosQueryIndex(ContainerNode* scope);
+
+  ContainerNode* scope() const { return scope_.Get(); }
+
+  // first element in tree order, as getElementById
+  Element* GetElementById(const AtomicString& id);
+  // the same static list until the scope changes
+  StaticElementList* GetElementsByName(const AtomicString& name);
+  void AppendElementsByName(const AtomicString& name,
+                            HeapVector<Member<Element>>& result);
+  // stops observing, for an index whose scope was replaced
+  void Detach();
+
+  // MutationObserver::Delegate:
+  ExecutionContext* GetExecutionContext() const override;
+  void Deliver(const MutationRecordVector& records,
+               MutationObserver& observer) override;
+  void Trace(Visitor* visitor) const override;
+
+ private:
+  void EnsureIndex();
+  void AddElement(Element& element);
+
+  bool valid_ = false;
+  Member<ContainerNode> scope_;
+  Member<MutationObserver> observer_;
+  HeapHashMap<AtomicString, Member<Element>> id_map_;
+  HeapHashMap<AtomicString, Member<GCedHeapVector<Member<Element>>>> name_map_;
+  HeapHashMap<AtomicString, Member<StaticElementList>> name_lists_;
+};
+
+}  // namespace blink
+
+#endif  // THIRD_PARTY_BLINK_RENDERER_CORE_FRAME_COSMOS_QUERY_INDEX_H_
@@ -253,8 +253,7 @@ void CosmosWinform::DispatchXobjEvent(Element* e, const String& eventName) {
                     xobjfortarget));
                 xobjfortarget->setMsgID(msgID);
                 xobjfortarget->setStr("eventdata", elem->outerHTML());
-                m_pRenderframeImpl->SendCosmosMessageEx(
-                    xobjfortarget->session_);
+                SendSession(xobjfortarget);
               }
             }
           }
@@ -308,7 +307,7 @@ void CosmosWinform::InitWinForm() {
                 if (breferenced) {
                   setStr("msgID", "SET_REFGRIDS_IPC_MSG");
                   setStr("RefInfo", refElem_->outerHTML());
-                  m_pRenderframeImpl->SendCosmosMessageEx(session_);
+                  SendSession(this);
                 }
               }
             } else if (name == "eventmap" && eventElem_ == nullptr) {
@@ -331,7 +330,7 @@ void CosmosWinform::InitWinForm() {
                       setStr("BindObj", name2);
                       setStr("Bindevent", eventname);
                       m_mapElement.insert(strIndex, elemEvent);
-                      m_pRenderframeImpl->SendCosmosMessageEx(session_);
+                      SendSession(this);
                     }
                   }
                 }
@@ -361,7 +360,7 @@ void CosmosWinform::Observe(const String& strCtrlName,
     setStr("ctrlName", strCtrlName);
     setStr("openkey", strKey);
     setStr("openxml", xml);
-    m_pRenderframeImpl->SendCosmosMessageEx(session_);
+    SendSession(this);
     setStr("msgID", "");
   }
 }
@@ -382,7 +381,7 @@ void CosmosWinform::Observe(const String& strCtrlName,
     if (callback) {
       mapWebRTEventCallback_.insert(callbackid_, callback);
     }
-    m_pRenderframeImpl->SendCosmosMessageEx(session_);
+    SendSession(this);
     setStr("msgID", "");
   }
 }
@@ -396,7 +395,7 @@ void CosmosWinform::Observe(const String& strCtrlName,
     setStr("ctrlName", strCtrlName);
     setStr("openkey", strKey);
     setStr("openxml", elem->outerHTML());
-    m_pRenderframeImpl->SendCosmosMessageEx(session_);
+    SendSession(this);
     setStr("msgID", "");
   }
 }
@@ -417,7 +416,7 @@ void CosmosWinform::Observe(const String& strCtrlName,
     if (callback) {
       mapWebRTEventCallback_.insert(callbackid_, callback);
     }
-    m_pRenderframeImpl->SendCosmosMessageEx(session_);
+    SendSession(this);
     setStr("msgID", "");
   }
 }
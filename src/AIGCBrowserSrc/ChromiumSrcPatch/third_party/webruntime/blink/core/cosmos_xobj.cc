@@ -26,6 +26,7 @@
 #include "base/strings/utf_string_conversions.h"
 #include "cosmos.h"
 #include "cosmos_event.h"
+#include "cosmos_galaxy.h"
 #include "cosmos_node.h"
 #include "cosmos_winform.h"
 
@@ -39,12 +40,17 @@
 #include "third_party/blink/renderer/core/dom/element.h"
 #include "third_party/blink/renderer/core/dom/node.h"
 #include "third_party/blink/renderer/core/dom/node_list.h"
+#include "third_party/blink/renderer/core/dom/static_node_list.h"
+#include "third_party/blink/renderer/core/execution_context/agent.h"
 #include "third_party/blink/renderer/core/frame/local_dom_window.h"
 #include "third_party/blink/renderer/core/frame/local_frame.h"
 #include "third_party/blink/renderer/core/frame/web_local_frame_impl.h"
 #include "third_party/blink/renderer/core/html/html_element.h"
 #include "third_party/blink/renderer/core/html/html_head_element.h"
 #include "third_party/blink/renderer/core/webrt_event_target_names.h"
+#include "third_party/blink/renderer/platform/heap/persistent.h"
+#include "third_party/blink/renderer/platform/scheduler/public/event_loop.h"
+#include "third_party/blink/renderer/platform/wtf/functional.h"
 
 namespace blink {
 
@@ -91,6 +97,7 @@ void CosmosXobj::Trace(blink::Visitor* visitor) const {
   visitor->Trace(refElem_);
   visitor->Trace(DocumentFragment_);
   visitor->Trace(HostDocumentFragment_);
+  visitor->Trace(queryIndex_);
   visitor->Trace(messageElem_);
   visitor->Trace(propertyElem_);
   visitor->Trace(m_pVisibleContentElement);
@@ -288,6 +295,11 @@ DocumentFragment* CosmosXobj::hostdocFragment() {
   if (HostDocumentFragment_) {
     return HostDocumentFragment_.Get();
   }
+  // the queries no longer move the host element into a fragment of its own
+  CosmosNode* thisXobj = (CosmosNode*)grid();
+  if (thisXobj && thisXobj->root() == thisXobj) {
+    return DocumentFragment_.Get();
+  }
   return nullptr;
 }
 
@@ -312,9 +324,7 @@ void CosmosXobj::setStr(const String& strKey, const String& value) {
   session_.m_mapString[_strKey] = _strVal;
   auto it = session_.m_mapint64.find(_strKey);
   if (it != session_.m_mapint64.end()) {
-    setStr("msgID", "MODIFY_CTRL_VALUE");
-    setStr("currentsubobjformodify", strKey);
-    m_pRenderframeImpl->SendCosmosMessageEx(session_);
+    QueueCtrlValue(_strKey, _strVal);
   }
   if (value == "") {
     auto it1 = session_.m_mapString.find(_strKey);
@@ -324,6 +334,101 @@ void CosmosXobj::setStr(const String& strKey, const String& value) {
   }
 }
 
+void CosmosXobj::QueueCtrlValue(const std::wstring& strCtrl,
+                                const std::wstring& strVal) {
+  auto itPending = mapPendingCtrlValue_.find(strCtrl);
+  if (itPending == mapPendingCtrlValue_.end()) {
+    // echo suppression: a handler answering OnTextChanged with the value the
+    // host just reported would otherwise bounce it back to the host
+    auto itHost = mapHostCtrlValue_.find(strCtrl);
+    if (itHost != mapHostCtrlValue_.end() && itHost->second == strVal) {
+      return;
+    }
+  }
+  mapPendingCtrlValue_[strCtrl] = strVal;
+  if (bCtrlFlushScheduled_) {
+    return;
+  }
+  ExecutionContext* context = cosmos_ ? GetExecutionContext() : nullptr;
+  if (context == nullptr || context->GetAgent() == nullptr) {
+    FlushCtrlValues();
+    return;
+  }
+  bCtrlFlushScheduled_ = true;
+  context->GetAgent()->event_loop()->EnqueueMicrotask(WTF::BindOnce(
+      &CosmosXobj::FlushCtrlValues, WrapWeakPersistent(this)));
+}
+
+void CosmosXobj::FlushCtrlValues() {
+  bCtrlFlushScheduled_ = false;
+  if (mapPendingCtrlValue_.empty() || m_pRenderframeImpl == nullptr) {
+    return;
+  }
+  // one message for every control written since the last flush; the values
+  // travel in the session as before, the names separated by ';'
+  std::wstring strCtrls = L"";
+  std::vector<std::wstring> vecCleared;
+  for (auto& it : mapPendingCtrlValue_) {
+    session_.m_mapString[it.first] = it.second;
+    mapHostCtrlValue_[it.first] = it.second;
+    if (it.second == L"") {
+      vecCleared.push_back(it.first);
+    }
+    if (strCtrls != L"") {
+      strCtrls += L";";
+    }
+    strCtrls += it.first;
+  }
+  mapPendingCtrlValue_.clear();
+  // a flush ahead of another message must not change what that one carries
+  std::map<std::wstring, std::wstring> mapSaved;
+  for (const wchar_t* pszKey : {L"msgID", L"currentsubobjformodify"}) {
+    auto itSaved = session_.m_mapString.find(pszKey);
+    if (itSaved != session_.m_mapString.end()) {
+      mapSaved[pszKey] = itSaved->second;
+    }
+  }
+  session_.m_mapString[L"msgID"] = L"MODIFY_CTRL_VALUE";
+  session_.m_mapString[L"currentsubobjformodify"] = strCtrls;
+  m_pRenderframeImpl->SendCosmosMessageEx(session_);
+  // as setStr does, an empty value is not kept in the session
+  for (auto& it : vecCleared) {
+    session_.m_mapString.erase(it);
+  }
+  for (const wchar_t* pszKey : {L"msgID", L"currentsubobjformodify"}) {
+    auto itSaved = mapSaved.find(pszKey);
+    if (itSaved != mapSaved.end()) {
+      session_.m_mapString[pszKey] = itSaved->second;
+    } else {
+      session_.m_mapString.erase(pszKey);
+    }
+  }
+}
+
+void CosmosXobj::SendSession(CosmosXobj* msg) {
+  // queued control values were written before this message, the host has to
+  // see them first
+  FlushCtrlValues();
+  if (msg != this) {
+    msg->FlushCtrlValues();
+  }
+  m_pRenderframeImpl->SendCosmosMessageEx(msg->session_);
+}
+
+void CosmosXobj::OnCtrlValueFromHost(const String& strCtrl) {
+  std::wstring _strCtrl = Cosmos::S2w(strCtrl);
+  std::wstring _strVal = L"";
+  auto it = session_.m_mapString.find(_strCtrl);
+  if (it != session_.m_mapString.end()) {
+    _strVal = it->second;
+  }
+  mapHostCtrlValue_[_strCtrl] = _strVal;
+  auto itPending = mapPendingCtrlValue_.find(_strCtrl);
+  if (itPending != mapPendingCtrlValue_.end() && itPending->second == _strVal) {
+    mapPendingCtrlValue_.erase(itPending);
+  }
+}
+
 String CosmosXobj::getStr(const String& strKey) {
   std::wstring _strKey = Cosmos::S2w(strKey);
   auto it = session_.m_mapString.find(_strKey);
@@ -396,9 +501,7 @@ String CosmosXobj::msgID() {
 void CosmosXobj::setCaption(const String& value) {
   std::wstring _strVal = Cosmos::S2w(value);
   session_.m_mapString[L"caption"] = _strVal;
-  setStr("msgID", "MODIFY_CTRL_VALUE");
-  setStr("currentsubobjformodify", "caption");
-  m_pRenderframeImpl->SendCosmosMessageEx(session_);
+  QueueCtrlValue(L"caption", _strVal);
 }
 
 String CosmosXobj::caption() {
@@ -448,7 +551,7 @@ void CosmosXobj::addEventListener(const String& eventName,
       // 允许RenderFrameImpl根据回调id查找对应的session：
       m_pRenderframeImpl->m_mapWebRTSession[strID] = this;
       // 通知客户端建立监听连接：
-      m_pRenderframeImpl->SendCosmosMessageEx(session_);
+      SendSession(this);
     }
   }
 }
@@ -491,7 +594,7 @@ void CosmosXobj::addEventListener(const String& SubObjName,
       }
       // 通知客户端建立监听连接：
       setStr("msgID", "WINFORM_CREATED");
-      m_pRenderframeImpl->SendCosmosMessageEx(session_);
+      SendSession(this);
     }
   }
 }
@@ -540,7 +643,7 @@ void CosmosXobj::sendMessage() {
       nHandle = getInt64("formhandle");
     }
     msg->setInt64("sender", nHandle);
-    m_pRenderframeImpl->SendCosmosMessageEx(msg->session_);
+    SendSession(msg);
     msg->setStr("msgID", "");
   }
 }
@@ -560,7 +663,7 @@ void CosmosXobj::sendMessage(CosmosXobj* msg) {
       nHandle = getInt64("formhandle");
     }
     msg->setInt64("sender", nHandle);
-    m_pRenderframeImpl->SendCosmosMessageEx(msg->session_);
+    SendSession(msg);
     msg->setStr("msgID", "");
   }
 }
@@ -586,7 +689,7 @@ void CosmosXobj::sendMessage(CosmosXobj* msg, V8ApplicationCallback* callback) {
       mapWebRTEventCallback_.insert(callbackid_, callback);
       m_pRenderframeImpl->m_mapWebRTSession[Cosmos::S2w(callbackid_)] = this;
     }
-    m_pRenderframeImpl->SendCosmosMessageEx(msg->session_);
+    SendSession(msg);
     msg->setStr("msgID", "");
   }
 }
@@ -743,114 +846,109 @@ void CosmosXobj::DispatchXobjEvent(Element* e, const String& eventName) {
   }
 }
 
-Element* CosmosXobj::getElementById(const String& strID, long nLevel) {
+ContainerNode* CosmosXobj::QueryScopeNode() {
   CosmosNode* thisXobj = (CosmosNode*)grid();
-  if (thisXobj == nullptr && DocumentFragment_) {
-    return DocumentFragment_->getElementById(AtomicString(strID));
+  if (thisXobj == nullptr || thisXobj->root() == thisXobj ||
+      hostElem_ == nullptr) {
+    return DocumentFragment_.Get();
   }
-  if (thisXobj) {
-    if (HostDocumentFragment_ == nullptr) {
-      if (thisXobj->root() == thisXobj) {
-        HostDocumentFragment_ = DocumentFragment_;
-      } else {
-        HostDocumentFragment_ = cosmos_->createDocumentFragment();
-        HostDocumentFragment_->appendChild(element());
-      }
+  // the host element stays where it is in the fragment of the root node
+  return hostElem_.Get();
+}
+
+CosmosQueryIndex* CosmosXobj::QueryIndex() {
+  ContainerNode* scope = QueryScopeNode();
+  if (scope == nullptr) {
+    return nullptr;
+  }
+  if (queryIndex_ == nullptr || queryIndex_->scope() != scope) {
+    if (queryIndex_) {
+      queryIndex_->Detach();
     }
+    queryIndex_ = MakeGarbageCollected<CosmosQueryIndex>(scope);
+  }
+  return queryIndex_.Get();
+}
+
+void CosmosXobj::CollectQueryScopes(long nLevel,
+                                    HeapVector<Member<CosmosXobj>>& scopes) {
+  CosmosNode* thisXobj = (CosmosNode*)grid();
+  if (thisXobj == nullptr) {
+    scopes.push_back(this);
+    return;
   }
+  CosmosNode* rootXobj = thisXobj->root() ? thisXobj->root() : thisXobj;
   switch (nLevel) {
-    case 0: {
-      if (thisXobj) {
-        return HostDocumentFragment_->getElementById(AtomicString(strID));
+    case kQueryScopeSelf:
+      scopes.push_back(thisXobj);
+      break;
+    case kQueryScopeParent: {
+      CosmosNode* thisParentObj = thisXobj->parent();
+      if (thisParentObj) {
+        scopes.push_back(thisParentObj);
       }
     } break;
-    case 1: {
-      if (thisXobj) {
-        CosmosNode* thisParentObj = thisXobj->parent();
-        if (thisParentObj) {
-          return thisParentObj->getElementById(strID, nLevel);
+    case kQueryScopeGalaxy: {
+      CosmosGalaxy* pGalaxy = (CosmosGalaxy*)thisXobj->parentGalaxy();
+      scopes.push_back(rootXobj);
+      if (pGalaxy) {
+        for (auto& it : pGalaxy->m_mapRootNode) {
+          if (it.value && it.value != rootXobj) {
+            scopes.push_back(it.value.Get());
+          }
         }
       }
     } break;
     default:
-      if (DocumentFragment_)
-        return DocumentFragment_->getElementById(AtomicString(strID));
+      scopes.push_back(rootXobj);
+  }
+}
+
+Element* CosmosXobj::getElementById(const String& strID, long nLevel) {
+  HeapVector<Member<CosmosXobj>> scopes;
+  CollectQueryScopes(nLevel, scopes);
+  AtomicString id(strID);
+  for (auto& xobj : scopes) {
+    CosmosQueryIndex* index = xobj->QueryIndex();
+    Element* elem = index ? index->GetElementById(id) : nullptr;
+    if (elem) {
+      return elem;
+    }
   }
   return nullptr;
 }
 
 NodeList* CosmosXobj::getElementsByName(const String& localName, long nLevel) {
-  CosmosNode* thisXobj = (CosmosNode*)grid();
-  if (thisXobj == nullptr && DocumentFragment_) {
-    return DocumentFragment_->getElementsByName(AtomicString(localName));
-  }
-  if (thisXobj) {
-    if (HostDocumentFragment_ == nullptr) {
-      if (thisXobj->root() == thisXobj) {
-        HostDocumentFragment_ = DocumentFragment_;
-      } else {
-        HostDocumentFragment_ = cosmos_->createDocumentFragment();
-        HostDocumentFragment_->appendChild(element());
-      }
+  HeapVector<Member<CosmosXobj>> scopes;
+  CollectQueryScopes(nLevel, scopes);
+  AtomicString name(localName);
+  if (scopes.size() == 1) {
+    CosmosQueryIndex* index = scopes[0]->QueryIndex();
+    return index ? index->GetElementsByName(name) : nullptr;
+  }
+  HeapVector<Member<Element>> elements;
+  for (auto& xobj : scopes) {
+    CosmosQueryIndex* index = xobj->QueryIndex();
+    if (index) {
+      index->AppendElementsByName(name, elements);
     }
   }
-  switch (nLevel) {
-    case 0: {
-      if (thisXobj) {
-        return HostDocumentFragment_->getElementsByName(
-            AtomicString(localName));
-      }
-    } break;
-    case 1: {
-      if (thisXobj) {
-        CosmosNode* thisParentObj = thisXobj->parent();
-        if (thisParentObj) {
-          return thisParentObj->getElementsByName(localName, nLevel);
-        }
-      }
-    } break;
-    default:
-      if (DocumentFragment_)
-        return DocumentFragment_->getElementsByName(AtomicString(localName));
-  }
-  return nullptr;
+  return StaticElementList::Adopt(elements);
 }
 
 HTMLCollection* CosmosXobj::getElementsByTagName(const String& localName,
                                                  long nLevel) {
-  CosmosNode* thisXobj = (CosmosNode*)grid();
-  if (thisXobj == nullptr && DocumentFragment_) {
-    return DocumentFragment_->getElementsByTagName(AtomicString(localName));
-  }
-  if (thisXobj) {
-    if (HostDocumentFragment_ == nullptr) {
-      if (thisXobj->root() == thisXobj) {
-        HostDocumentFragment_ = DocumentFragment_;
-      } else {
-        HostDocumentFragment_ = cosmos_->createDocumentFragment();
-        HostDocumentFragment_->appendChild(element());
-      }
-    }
-  }
-  switch (nLevel) {
-    case 0: {
-      if (thisXobj) {
-        return HostDocumentFragment_->getElementsByTagName(
-            AtomicString(localName));
-      }
-    } break;
-    case 1: {
-      if (thisXobj) {
-        CosmosNode* thisParentObj = thisXobj->parent();
-        if (thisParentObj) {
-          return thisParentObj->getElementsByTagName(localName, nLevel);
-        }
-      }
-    } break;
-    default:
-      if (DocumentFragment_)
-        return DocumentFragment_->getElementsByTagName(AtomicString(localName));
-  }
-  return nullptr;
+  // live collections are cached by the scope node itself; a galaxy wide
+  // query answers from the root node of this nucleus
+  HeapVector<Member<CosmosXobj>> scopes;
+  CollectQueryScopes(nLevel, scopes);
+  if (scopes.empty()) {
+    return nullptr;
+  }
+  ContainerNode* scope = scopes[0]->QueryScopeNode();
+  if (scope == nullptr) {
+    return nullptr;
+  }
+  return scope->getElementsByTagName(AtomicString(localName));
 }
 }  // namespace blink
@@ -31,6 +31,7 @@
 #include "third_party/blink/renderer/core/dom/events/event_target.h"
 #include "third_party/blink/renderer/core/webrt_event_type_names.h"
 #include "third_party/blink/renderer/core/dom/element.h"
+#include "cosmos_query_index.h"
 #include "third_party/webruntime/ChromeRenderDomProxy.h"
 #include "third_party/blink/public/web/web_local_frame_client.h"
 
@@ -67,6 +68,14 @@ class CORE_EXPORT CosmosXobj :
                           RegisteredEventListener&) override;
   // EventTarget overrides:
   const AtomicString& InterfaceName() const override;
+  // nLevel of the element queries: the node itself, its parent node, the
+  // root node of its nucleus, or every root node of its galaxy
+  enum QueryScope {
+    kQueryScopeSelf = 0,
+    kQueryScopeParent = 1,
+    kQueryScopeRoot = 2,
+    kQueryScopeGalaxy = 3,
+  };
   Element* getElementById(const String& strID, long nLevel);
   NodeList* getElementsByName(const String& localName, long nLevel);
   HTMLCollection* getElementsByTagName(const String& localName, long nLevel);
@@ -107,6 +116,7 @@ class CORE_EXPORT CosmosXobj :
   mutable Member<DocumentFragment> HostDocumentFragment_;
 
   Member<Element> element_;
+  Member<CosmosQueryIndex> queryIndex_;
 
   String name();
   String getid();
@@ -166,6 +176,12 @@ class CORE_EXPORT CosmosXobj :
   void BindCtrlValue(const String& strcontrols);
   void BindCtrlValue(const String& strcontrols,
                      V8ApplicationCallback* callback);
+  // Writes to bound controls are queued per xobj, repeated writes to one
+  // control keep the last value, and the queue goes to the host as a single
+  // MODIFY_CTRL_VALUE at the next microtask checkpoint.
+  void FlushCtrlValues();
+  // The host reported a new value of a bound control, it is not sent back.
+  void OnCtrlValueFromHost(const String& strCtrl);
 
   String id_;
   String name_;
@@ -176,6 +192,21 @@ class CORE_EXPORT CosmosXobj :
   HeapHashMap<String, Member<Element>> mapVisibleElem;
   HeapHashMap<String, Member<V8ApplicationCallback>> mapWebRTEventCallback_;
   HeapHashMap<String, Member<Element>> m_mapElement;
+
+ protected:
+  // Sends msg's session (msg may be this); the control values queued on
+  // this xobj and on msg are flushed first, so the host sees them in order.
+  void SendSession(CosmosXobj* msg);
+
+ private:
+  void QueueCtrlValue(const std::wstring& strCtrl, const std::wstring& strVal);
+  ContainerNode* QueryScopeNode();
+  CosmosQueryIndex* QueryIndex();
+  void CollectQueryScopes(long nLevel, HeapVector<Member<CosmosXobj>>& scopes);
+
+  std::map<std::wstring, std::wstring> mapPendingCtrlValue_;
+  std::map<std::wstring, std::wstring> mapHostCtrlValue_;  // what the host shows
+  bool bCtrlFlushScheduled_ = false;
 };
 
 }  // namespace blink
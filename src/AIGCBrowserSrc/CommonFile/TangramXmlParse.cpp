@@ -46,6 +46,9 @@ void CTangramXmlParse::_CTangramXmlParse(CComPtr<IXMLDOMElement> _elem)
 {
 	Initialize();
 	elem = _elem;
+	CComBSTR bstrTag;
+	if (elem->get_tagName(&bstrTag) == S_OK)
+		m_strTagName = OLE2T(bstrTag);
 	//m_pUnknown = NULL;
 	//elem->QueryInterface(IID_IUnknown,(void**)&m_pUnknown);
 
@@ -84,7 +87,9 @@ void CTangramXmlParse::ModifyNameAttrByFix(CString strNameFix)
 				bstrName += strNAME;
 			else
 				bstrName += var.bstrVal;
-			var.bstrVal = bstrName;
+			::VariantClear(&var);
+			var.vt = VT_BSTR;
+			var.bstrVal = bstrName.Detach();
 			hr = elem->setAttribute(bstrAttrName, var);
 		}
 		if (hr != S_OK)
@@ -96,6 +101,7 @@ void CTangramXmlParse::ModifyNameAttrByFix(CString strNameFix)
 			hr = elem->setAttribute(bstrAttrName, var);
 		}
 		::VariantClear(&var);
+		SetDirty();
 		//::SysFreeString(bstrAttrName);
 		int nCount = GetCount();
 		for (int i = 0; i < nCount; i++)
@@ -123,7 +129,9 @@ CTangramXmlParse* CTangramXmlParse::AddNode(CTangramXmlParse* pParse, CString st
 			if (hr == S_OK)
 			{
 				CTangramXmlParse* pWebRTXmlParse = new CTangramXmlParse(pNode);
+				pWebRTXmlParse->m_pParentParse = this;
 				m_aChildElements.push_back(pWebRTXmlParse);
+				SetDirty();
 				return pWebRTXmlParse;
 			}
 		}
@@ -283,6 +291,7 @@ CTangramXmlParse* CTangramXmlParse::ReplaceNode(CTangramXmlParse* pOldParse, CTa
 					pChild->m_pParentParse = this;
 					m_aChildElements[i] = pChild;
 					delete pOldChild;
+					SetDirty();
 					CString strCap = pChild->attr(_T("caption"), _T(""));
 					if (strCap == _T("") && strCapOld != _T(""))
 						pChild->put_attr(_T("caption"), strCapOld);
@@ -327,7 +336,7 @@ CTangramXmlParse* CTangramXmlParse::GetChild(CString strName)
 {
 	for(int i = 0; i<GetCount(); i++)
 	{
-		if (m_aChildElements[i]->name().CompareNoCase(strName) == 0)
+		if (m_aChildElements[i]->m_strTagName.CompareNoCase(strName) == 0)
 			return m_aChildElements[i];
 	}
 	return NULL;
@@ -363,7 +372,7 @@ CTangramXmlParse* CTangramXmlParse::FindItem(LPCTSTR strItemname)
 		for(int i = 0; i<GetCount(); i++)
 		{
 			CTangramXmlParse* pI = GetChild(i);
-			if (pI->name().CompareNoCase(strItemname) == 0)
+			if (pI->m_strTagName.CompareNoCase(strItemname) == 0)
 			{
 				pItem = pI;
 				break;
@@ -389,41 +398,30 @@ CTangramXmlParse* CTangramXmlParse::FindItem(LPCTSTR strItemname)
 
 CTangramXmlParse* CTangramXmlParse::FindItemByName(LPCTSTR strItemname)
 {
-	CTangramXmlParse* pItem = NULL;
-
-	//if (name().CompareNoCase(strItemname) == 0)
-	//{
-	//	pItem = this;
-	//}
+	CComBSTR bstrID(L"id");
+	return _FindItemByName(bstrID, strItemname);
+}
 
-	if (pItem == NULL)
+CTangramXmlParse* CTangramXmlParse::_FindItemByName(BSTR bstrAttr, LPCTSTR strItemname)
+{
+	for(int i = 0; i<GetCount(); i++)
 	{
-		for(int i = 0; i<GetCount(); i++)
+		CTangramXmlParse* pI = GetChild(i);
+		CComVariant var;
+		if (pI->elem->getAttribute(bstrAttr, &var) == S_OK && var.vt == VT_BSTR)
 		{
-			CTangramXmlParse* pI = GetChild(i);
-			CString strName = pI->attr(_T("id"), _T(""));
-			if (strName.CompareNoCase(strItemname) == 0)
-			{
-				pItem = pI;
-				break;
-			}		
+			if (_tcsicmp(OLE2CT(var.bstrVal), strItemname) == 0)
+				return pI;
 		}
 	}
 
-	if (pItem == NULL)
+	for(int i = 0; i<GetCount(); i++)
 	{
-		for(int i = 0; i<GetCount(); i++)
-		{
-			CTangramXmlParse* pX = GetChild(i)->FindItemByName(strItemname);
-			
-			if (pX != NULL)
-			{
-				pItem = pX;
-				break;
-			}
-		}
+		CTangramXmlParse* pX = GetChild(i)->_FindItemByName(bstrAttr, strItemname);
+		if (pX != NULL)
+			return pX;
 	}
-	return pItem;
+	return NULL;
 }
 
 bool CTangramXmlParse::operator==(CTangramXmlParse& nItem)
@@ -446,6 +444,15 @@ void CTangramXmlParse::Initialize()
 {
 	m_strFile = _T("");
 	m_bCanSave = false;
+	m_bDirty = true;
+	m_strXmlCache = _T("");
+}
+
+void CTangramXmlParse::SetDirty()
+{
+	// every ancestor embeds this subtree in its own cached output
+	for (CTangramXmlParse* pParse = this; pParse; pParse = pParse->m_pParentParse)
+		pParse->m_bDirty = true;
 }
 
 CTangramXmlParse* CTangramXmlParse::_FindParseByEle(CTangramXmlParse* _pParent, IUnknown* pEle)
@@ -497,7 +504,9 @@ CTangramXmlParse* CTangramXmlParse::AddNode(CString name)
 			if (elem->appendChild(pElement,NULL) == S_OK)
 			{
 				CTangramXmlParse* pWebRTXmlParse = new CTangramXmlParse(pElement);
+				pWebRTXmlParse->m_pParentParse = this;
 				m_aChildElements.push_back(pWebRTXmlParse);
+				SetDirty();
 				return pWebRTXmlParse;
 			}
 		}
@@ -518,6 +527,7 @@ HRESULT CTangramXmlParse::RemoveNode(CTangramXmlParse* pNode)
 	HRESULT hr = elem->removeChild(pNode->elem,NULL);
 	if (hr == S_OK)
 	{
+		SetDirty();
 		//for(int i = 0; i<GetCount(); i++)
 		//{
 		//	if (m_aChildElements[i] == pNode)
@@ -571,7 +581,7 @@ bool CTangramXmlParse::put_text(CString text)
 		CComPtr<IXMLDOMNode> pChildNode = NULL;
 		if (pSubNodeList->get_item(j,&pChildNode) == S_OK)
 		{
-			BSTR subname = NULL;
+			CComBSTR subname;
 			pChildNode->get_nodeName(&subname);
 			if (wcscmp(subname,L"#text") == 0)
 			{
@@ -582,11 +592,13 @@ bool CTangramXmlParse::put_text(CString text)
 		}
 	}
 	if (!bFound) elem->put_text(CComBSTR(text));
+	SetDirty();
 	return true;
 }
 
 bool CTangramXmlParse::put_attr(CString name,CString value)
 {
+	SetDirty();
 	return (elem->setAttribute(CComBSTR(name),CComVariant(CComBSTR(value))) == S_OK);
 }
 
@@ -614,26 +626,125 @@ bool CTangramXmlParse::put_attr(CString name,bool value)
 CString CTangramXmlParse::name()
 {
 	if (!elem) return _T("");
-
-	BSTR bstr = ::SysAllocString(L"");
-	elem->get_tagName(&bstr);
-	CString strName = OLE2T(bstr);
-	::SysFreeString(bstr);
-
-	return strName;
+	return m_strTagName;
 }
 
 CString CTangramXmlParse::xml()
 {
 	if (!elem) return _T("");
 	//CComBSTR bn; 
-	BSTR bstr = ::SysAllocString(L"");
+	BSTR bstr = NULL;
 	elem->get_xml(&bstr);
 	CString strXml = OLE2T(bstr);
 	::SysFreeString(bstr);
 	return strXml;
 }
 
+CString CTangramXmlParse::xmlCached()
+{
+	if (!elem) return _T("");
+	if (m_bDirty)
+	{
+		CString strXml = _T("");
+		if (!_ComposeXml(strXml))
+			strXml = xml();
+		m_strXmlCache = strXml;
+		m_bDirty = false;
+	}
+	return m_strXmlCache;
+}
+
+static void _AppendEscapedAttr(CString& strXml, LPCWSTR lpszValue)
+{
+	if (lpszValue == NULL)
+		return;
+	LPCWSTR pRun = lpszValue;
+	for (LPCWSTR p = lpszValue; ; p++)
+	{
+		LPCTSTR lpszEntity = NULL;
+		switch (*p)
+		{
+		case L'&': lpszEntity = _T("&amp;"); break;
+		case L'<': lpszEntity = _T("&lt;"); break;
+		case L'>': lpszEntity = _T("&gt;"); break;
+		case L'\"': lpszEntity = _T("&quot;"); break;
+		case 0: break;
+		default: continue;
+		}
+		if (p > pRun)
+			strXml.Append(pRun, (int)(p - pRun));
+		if (lpszEntity == NULL)
+			break;
+		strXml += lpszEntity;
+		pRun = p + 1;
+	}
+}
+
+bool CTangramXmlParse::_ComposeXml(CString& strXml)
+{
+	// leaves are cheap to serialize, and may carry text MSXML has to escape
+	if (GetCount() == 0)
+		return false;
+	CComPtr<IXMLDOMNamedNodeMap> pAttrs;
+	CComPtr<IXMLDOMNodeList> pList;
+	if (elem->get_attributes(&pAttrs) != S_OK || elem->get_childNodes(&pList) != S_OK)
+		return false;
+
+	strXml = _T("<");
+	strXml += m_strTagName;
+	long nLen = 0;
+	pAttrs->get_length(&nLen);
+	for (long i = 0; i < nLen; i++)
+	{
+		CComPtr<IXMLDOMNode> pAttr;
+		if (pAttrs->get_item(i, &pAttr) != S_OK)
+			return false;
+		CComBSTR bstrName;
+		CComBSTR bstrValue;
+		pAttr->get_nodeName(&bstrName);
+		pAttr->get_text(&bstrValue);
+		strXml += _T(" ");
+		strXml += OLE2CT(bstrName);
+		strXml += _T("=\"");
+		_AppendEscapedAttr(strXml, bstrValue);
+		strXml += _T("\"");
+	}
+	strXml += _T(">");
+
+	// element children map 1:1 and in order onto m_aChildElements
+	int nChild = 0;
+	nLen = 0;
+	pList->get_length(&nLen);
+	for (long i = 0; i < nLen; i++)
+	{
+		CComPtr<IXMLDOMNode> pNode;
+		if (pList->get_item(i, &pNode) != S_OK)
+			return false;
+		DOMNodeType nType = NODE_INVALID;
+		pNode->get_nodeType(&nType);
+		if (nType == NODE_ELEMENT)
+		{
+			CTangramXmlParse* pChild = GetChild(nChild++);
+			if (pChild == NULL || !pChild->elem.IsEqualObject(pNode))
+				return false;
+			strXml += pChild->xmlCached();
+		}
+		else
+		{
+			CComBSTR bstrNode;
+			pNode->get_xml(&bstrNode);
+			strXml += OLE2CT(bstrNode);
+		}
+	}
+	if (nChild != GetCount())
+		return false;
+
+	strXml += _T("</");
+	strXml += m_strTagName;
+	strXml += _T(">");
+	return true;
+}
+
 CString CTangramXmlParse::text()
 {
 	if (!elem) return _T("");
@@ -762,12 +873,28 @@ bool CTangramXmlParse::LoadXml(CString strXML)
 		{
 			Clear();
 			_CTangramXmlParse(pEle);
+			SetDirty();
 			return true;
 		}
 	}
 	return false;
 }
 
+bool CTangramXmlParse::LoadDoc(CComPtr<IXMLDOMDocument> pDoc)
+{
+	if (pDoc == NULL)
+		return false;
+	CComPtr<IXMLDOMElement> pEle;
+	if (pDoc->get_documentElement(&pEle) != S_OK || pEle == NULL)
+		return false;
+	if (m_pDoc != NULL) m_pDoc.Release();
+	m_pDoc = pDoc;
+	Clear();
+	_CTangramXmlParse(pEle);
+	SetDirty();
+	return true;
+}
+
 bool CTangramXmlParse::LoadFile(CString strFile)
 {
 	//HRESULT hr = CoInitializeEx(NULL,0);
@@ -787,6 +914,7 @@ bool CTangramXmlParse::LoadFile(CString strFile)
 			{
 				Clear();
 				_CTangramXmlParse(pEle);
+				SetDirty();
 
 				m_bCanSave = true;
 				m_strFile = strFile;
@@ -821,6 +949,7 @@ bool CTangramXmlParse::Reflash()
 	Clear();
 	if(elem)
 		_CTangramXmlParse(elem);
+	SetDirty();
 	return true;
 }
 
@@ -53,11 +53,14 @@ public:
 	CTangramXmlParse(CComPtr<IXMLDOMElement> _elem)
 	{
 		//m_pUnknown = NULL;
+		m_pParentParse = NULL;
 		_CTangramXmlParse(_elem);
 	}
 	CTangramXmlParse(CComPtr<IXMLDOMNodeList> _nlist)
 	{
 		//m_pUnknown = NULL;
+		m_pParentParse = NULL;
+		Initialize();
 		_CTangramXmlParse(_nlist);
 	}
 
@@ -74,6 +77,11 @@ protected:
 	vector<CTangramXmlParse*>  m_aChildElements;
 	CComPtr<IXMLDOMElement> elem;
 	CComPtr<IXMLDOMDocument> m_pDoc;
+	// tag names are immutable in MSXML, so the name is fetched once per element
+	CString m_strTagName;
+	// serialized output of this subtree, valid while m_bDirty is false
+	bool m_bDirty;
+	CString m_strXmlCache;
 	//CComPtr<IUnknown> m_pUnknown;
 	//IUnknown*	m_pUnknown;
 
@@ -81,7 +89,14 @@ public:
 	//CComPtr<IXMLDOMElement> ReturnCurrentElement(){return elem;}
 	CComPtr<IXMLDOMElement> GetElement() { return elem;}
 	CString name();	
+	LPCTSTR tagName() const { return m_strTagName; }
 	CString xml();
+	// Like xml(), but subtrees that have not changed since the last call
+	// reuse their previous output. Only changes made through this class
+	// (put_attr, AddNode, RemoveNode, ...) are tracked.
+	CString xmlCached();
+	void SetDirty();
+	bool IsDirty() const { return m_bDirty; }
 	CString text();
 	CString attr(const CString name,CString def) const;
 
@@ -126,6 +141,8 @@ public:
 	DWORD vall() const;
 	bool LoadXml(CString strXML);
 	bool LoadFile(CString strFile);
+	// takes over a document that was already loaded, e.g. a free-threaded one parsed on a worker thread
+	bool LoadDoc(CComPtr<IXMLDOMDocument> pDoc);
 	bool SaveFile(CString strFile = _T(""));
 
 private:
@@ -135,6 +152,8 @@ private:
 protected:
 	void ModifyNameAttrByFix(CString strNameFix);
 	CTangramXmlParse* _FindParseByEle(CTangramXmlParse* _pParent, IUnknown* pEle);
+	CTangramXmlParse* _FindItemByName(BSTR bstrAttr, LPCTSTR strItemname);
+	bool _ComposeXml(CString& strXml);
 	bool Clear();
 };
 #endif
\ No newline at end of file
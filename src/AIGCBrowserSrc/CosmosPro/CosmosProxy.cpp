@@ -49,6 +49,10 @@ namespace CommonUniverse {
 }
 
 CWebRTProxy theAppProxy;
+
+// set while MODIFY_CTRL_VALUE writes page values into controls, the
+// TextChanged this raises is not sent back to the page
+static bool g_bApplyingCtrlValue = false;
 // CSpaceTelescope
 class CModalWnd : public CWindowImpl<CModalWnd, CWindow>
 {
@@ -2947,25 +2951,42 @@ void CWebRTProxy::OnCloudMsgReceived(CSession* pSession)
 		}
 		if (strMsgID == _T("MODIFY_CTRL_VALUE"))
 		{
-			CString strSubObj = pSession->GetString(L"currentsubobjformodify");
-			if (strSubObj == _T("caption"))
-			{
-				thisNode->Caption = marshal_as<String^>(pSession->GetString(L"caption"));
-			}
-			else if (pObj->GetType()->IsSubclassOf(Control::typeid))
+			// the page coalesces its writes, one message carries every control
+			// written since the last one, separated by ';' as in BindCtrlValue
+			CString strSubObjs = pSession->GetString(L"currentsubobjformodify");
+			int nPos = 0;
+			CString strSubObj = strSubObjs.Tokenize(_T(";"), nPos);
+			while (strSubObj != _T(""))
 			{
-				Control^ pCtrl = (Control^)pObj;
-				Control^ pSubCtrl = nullptr;
-				String^ _strSubObjName = marshal_as<String^>(strSubObj);
-				if (String::IsNullOrEmpty(_strSubObjName) == false)
+				if (strSubObj == _T("caption"))
 				{
+					thisNode->Caption = marshal_as<String^>(pSession->GetString(L"caption"));
+				}
+				else if (pObj != nullptr && pObj->GetType()->IsSubclassOf(Control::typeid))
+				{
+					Control^ pCtrl = (Control^)pObj;
+					Control^ pSubCtrl = nullptr;
+					String^ _strSubObjName = marshal_as<String^>(strSubObj);
 					cli::array<Control^, 1>^ pArray = pCtrl->Controls->Find(_strSubObjName, true);
 					if (pArray != nullptr && pArray->Length)
 					{
 						pSubCtrl = pArray[0];
-						pSubCtrl->Text = marshal_as<String^>(pSession->GetString(strSubObj));
+						String^ strText = marshal_as<String^>(pSession->GetString(strSubObj));
+						if (String::Equals(pSubCtrl->Text, strText) == false)
+						{
+							g_bApplyingCtrlValue = true;
+							try
+							{
+								pSubCtrl->Text = strText;
+							}
+							finally
+							{
+								g_bApplyingCtrlValue = false;
+							}
+						}
 					}
 				}
+				strSubObj = strSubObjs.Tokenize(_T(";"), nPos);
 			}
 		}
 		else if (strMsgID == _T("WINFORM_CREATED"))
@@ -3314,6 +3335,9 @@ void CWebRTProxy::OnClick(Object^ sender, EventArgs^ e)
 
 void CWebRTProxy::OnTextChanged(System::Object^ sender, System::EventArgs^ e)
 {
+	// the page already has the value it just wrote
+	if (g_bApplyingCtrlValue)
+		return;
 	Control^ pTextCtrl = (Control^)sender;
 	Universe::Wormhole^ pCloudSession = nullptr;
 	if (Universe::WebRT::Wormholes->TryGetValue(sender, pCloudSession))
@@ -186,6 +186,11 @@ CSpaceTelescope::CSpaceTelescope()
 	m_nJVMVersion = JNI_VERSION_10;
 	m_bIsWin7 = false;
 	m_bIsClrCoreApp = false;
+#ifdef _DEBUG
+	m_bAuditLayouts = true;
+#else
+	m_bAuditLayouts = false;
+#endif
 	m_bMainWndNotFound = false;
 	m_bOfficeAddinUnLoad = true;
 	m_bWinFormActived = false;
@@ -665,6 +670,8 @@ void CSpaceTelescope::Init()
 			}
 
 			m_strWebRTVer = m_Parse.attr(_T("webrtver"), _T(""));
+			// release builds audit layouts only when the application asks for it
+			m_bAuditLayouts = m_Parse.attrBool(_T("auditlayouts"), m_bAuditLayouts);
 			CString _strUrl = m_Parse.attr(_T("url"), _T(""));
 			if (_strUrl != _T(""))
 			{
@@ -913,37 +920,52 @@ std::string wide_string_to_string(const std::wstring& wide_string)
 
 wstring CSpaceTelescope::Json2Xml(wstring _strJson, bool bJsonstr)
 {
-	wstring strJson = L"";
-	if (bJsonstr == false)
+	// runs on the layout prepare tasks as well, an exception escaping from
+	// here would end the process, so any failure becomes an empty result
+	try
 	{
-		std::string jsonStr;
+		string s;
+		if (bJsonstr == false)
+		{
+			// the file holds UTF-8; streaming its narrow buffer into a wide
+			// stream would write the address of the buffer instead
+			std::ifstream ifs(_strJson, std::ios::binary);
+			std::stringstream ss;
+			ss << ifs.rdbuf();
+			s = ss.str();
+			ifs.close();
+			if (s.size() >= 3 && s.compare(0, 3, "\xEF\xBB\xBF") == 0)
+				s.erase(0, 3);
+			if (s == "") {
+				std::cerr << "Cannot read file provided !" << std::endl;
+				return L"";
+			}
+		}
+		else {
+			if (_strJson == L"") {
+				std::cerr << "Cannot read file provided !" << std::endl;
+				return L"";
+			}
+			s = wide_string_to_string(_strJson);
+		}
 
-		std::ifstream ifs(_strJson);
-		std::wstringstream ss;
-		ss << ifs.rdbuf();
-		strJson = ss.str();
-		ifs.close();
-	}
-	else {
-		strJson = _strJson;
-		if (strJson == L"") {
-			std::cerr << "Cannot read file provided !" << std::endl;
+		// Consume json to build xml:
+		ert::JsonSaxConsumer consumer(2);
+		bool success = nlohmann::json::sax_parse(s, &consumer);
+
+		if (!success) {
+			std::cerr << "Conversion error !" << std::endl;
 			return L"";
 		}
-	}
-
-	// Consume json to build xml:
-	ert::JsonSaxConsumer consumer(2);
-	string s = wide_string_to_string(strJson);
-	bool success = nlohmann::json::sax_parse(s, &consumer);
 
-	if (!success) {
-		std::cerr << "Conversion error !" << std::endl;
+		// output xml
+		return string_to_wide_string(consumer.getXmlString());
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << "Conversion error: " << e.what() << std::endl;
 		return L"";
 	}
-
-	// output xml
-	return string_to_wide_string(consumer.getXmlString());
 }
 
 void CSpaceTelescope::OnCLRHostExit()
@@ -3522,12 +3544,15 @@ CString CSpaceTelescope::RemoveUTF8BOM(CString strUTF8)
 	return strUTF8;
 }
 
-CXobj* CSpaceTelescope::ObserveEx(long hWnd, CString strExXml, CString strXml)
+CXobj* CSpaceTelescope::ObserveEx(long hWnd, CString strExXml, CString strXml, IXMLDOMDocument* pPreparedDoc)
 {
 	strXml = RemoveUTF8BOM(strXml);
 	AFX_MANAGE_STATE(AfxGetStaticModuleState());
 	CTangramXmlParse* m_pParse = new CTangramXmlParse();
-	bool bXml = m_pParse->LoadXml(strXml);
+	// a layout plan carries strXml already parsed off the UI thread
+	bool bXml = pPreparedDoc && m_pParse->LoadDoc(pPreparedDoc);
+	if (bXml == false)
+		bXml = m_pParse->LoadXml(strXml);
 	if (bXml == false)
 		bXml = m_pParse->LoadFile(strXml);
 
@@ -4599,7 +4624,7 @@ STDMETHODIMP CSpaceTelescope::UpdateXobj(IXobj* pXobj)
 	{
 		if (pWndXobj->m_pWindow)
 		{
-			if (pWndXobj->m_nActivePage > 0)
+			if (pWndXobj->m_nActivePage > 0 && pWndXobj->m_pHostParse->attrInt(_T("activepage"), 0) != pWndXobj->m_nActivePage)
 			{
 				CString strVal = _T("");
 				strVal.Format(_T("%d"), pWndXobj->m_nActivePage);
@@ -4618,7 +4643,7 @@ STDMETHODIMP CSpaceTelescope::UpdateXobj(IXobj* pXobj)
 		if ((pWndXobj == pWndXobj->m_pRootObj || pWndXobj->m_pParentObj == nullptr) && pWndXobj->m_pXobjShareData->m_pOfficeObj)
 		{
 			CTangramXmlParse* pWndParse = pWndXobj->m_pXobjShareData->m_pWebRTParse->GetChild(TGM_NUCLEUS);
-			CString strXml = pWndParse->xml();
+			CString strXml = pWndParse->xmlCached();
 			CString strNodeName = pWndXobj->m_pXobjShareData->m_pWebRTParse->name();
 			UpdateOfficeObj(pWndXobj->m_pXobjShareData->m_pOfficeObj, strXml, strNodeName);
 		}
@@ -68,6 +68,7 @@
 #include "universe.h"
 #include "ObjSafe.h"
 #include "wpfview.h"
+#include "LayoutEviction.h"
 
 #include "chromium\BrowserWnd.h"
 
@@ -177,6 +178,7 @@ public:
 	int										m_nTangramNodeCommonData;
 #endif
 	bool									m_bIsClrCoreApp;
+	bool									m_bAuditLayouts;		// compare the CMarkup and MSXML reading of committed layouts, see CLayoutDiff::Audit
 	bool									m_bIsProcessCmdforNewOrOpen = false;;
 	bool									m_bMainWndNotFound = true;
 	bool									m_bIsWin7;
@@ -239,6 +241,7 @@ public:
 	map<HWND, CBrowser*>					m_mapDpiChangedBrowser;
 	map<IPCSession*, CWormhole*>			m_mapWormhole;
 	map<int, HWND>							m_mapControlBar;
+	CLayoutEvictionManager					m_LayoutEviction;
 
 	BEGIN_COM_MAP(CSpaceTelescope)
 		COM_INTERFACE_ENTRY(IWebRT)
@@ -331,7 +334,7 @@ public:
 	CString	GetDataFromStr(CString strCoded, CString& strTime, CString strPrev, CString strFix, int n1);
 	CString tangram_for_eclipse(CString strKey, CString strData, CString strFeatures);
 	LRESULT Close(void);
-	CXobj* ObserveEx(long hHostMainWnd, CString strExXml, CString strXTMLFile);
+	CXobj* ObserveEx(long hHostMainWnd, CString strExXml, CString strXTMLFile, IXMLDOMDocument* pPreparedDoc = nullptr);
 	CXobj* ObserveEx2(HWND hHostMainWnd, CTangramXmlParse* pParse);
 	CommonThreadInfo* GetThreadInfo(DWORD dwInfo = 0);
 #ifndef _WIN64
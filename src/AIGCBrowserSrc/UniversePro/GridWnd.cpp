@@ -31,6 +31,7 @@
 #include "XobjWnd.h"
 #include "WPFView.h"
 #include "GridWnd.h"
+#include "XmlQuery.h"
 #include "TangramHtmlTreeWnd.h"
 #include "chromium/WebPage.h"
 #include "chromium/BrowserWnd.h"
@@ -883,17 +884,12 @@ BOOL CGridWnd::Create(LPCTSTR lpszClassName, LPCTSTR lpszWindowName, DWORD dwSty
 		CString strW, strH, strOldWidth, strName = _T("");
 
 		strOldWidth = strWidth;
+		// the cells are the xobj children, in document order
+		static const CTangramXmlQuery s_queryCells(TGM_XOBJ);
 		vector<CTangramXmlParse*> vecParse;
-		long nSize = m_pXobj->m_pHostParse->GetCount();
-		for (int i = 0; i < nSize; i++)
-		{
-			CTangramXmlParse* _pChild = m_pXobj->m_pHostParse->GetChild(i);
-			if (_pChild->name().CompareNoCase(TGM_XOBJ) == 0)
-				vecParse.push_back(_pChild);
-		}
-		nSize = vecParse.size();
+		long nSize = s_queryCells.SelectAll(m_pXobj->m_pHostParse, vecParse);
 		int nIndex = 0;
-		CTangramXmlParse* pSubItem = vecParse[nIndex];
+		CTangramXmlParse* pSubItem = nSize ? vecParse[nIndex] : nullptr;
 		if (pSubItem == nullptr)
 		{
 			strName.Format(_T("%s_splitterchild_%i"), m_pXobj->m_strName, 0);
@@ -1238,8 +1234,11 @@ void CGridWnd::Save()
 		strWidth += strW;
 	}
 
-	m_pXobj->put_Attribute(CComBSTR(TGM_HEIGHT), CComBSTR(strHeight));
-	m_pXobj->put_Attribute(CComBSTR(TGM_WIDTH), CComBSTR(strWidth));
+	// unchanged sizes must not invalidate the cached layout xml
+	if (strHeight != m_pXobj->m_pHostParse->attr(TGM_HEIGHT, _T("")))
+		m_pXobj->put_Attribute(CComBSTR(TGM_HEIGHT), CComBSTR(strHeight));
+	if (strWidth != m_pXobj->m_pHostParse->attr(TGM_WIDTH, _T("")))
+		m_pXobj->put_Attribute(CComBSTR(TGM_WIDTH), CComBSTR(strWidth));
 }
 
 void CGridWnd::OnMouseMove(UINT nFlags, CPoint point)
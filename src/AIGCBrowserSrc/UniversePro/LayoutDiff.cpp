@@ -0,0 +1,242 @@
+/********************************************************************************
+ *           Web Runtime for Application - Version 1.0.0.202203120001           *
+ ********************************************************************************
+ * Copyright (C) 2002-2021 by Tangram Team.   All Rights Reserved.
+ * There are Three Key Features of Webruntime:
+ * 1. Built-in Modern Web Browser: Independent Browser Window and Browser Window
+ *    as sub windows of other windows are supported in the application process;
+ * 2. DOM Plus: DOMPlus is a natural extension of the standard DOM system.
+ *    It allows the application system to support a kind of generalized web pages,
+ *    which are composed of standard DOM elements and binary components supported
+ *    by the application system;
+ * 3. JavaScript for Application: Similar to VBA in MS office, JavaScript will
+ *    become a built-in programmable language in the application system, so that
+ *    the application system can be expanded and developed for the Internet based
+ *    on modern javscript/Web technology.
+ * Use of this source code is governed by a BSD-style license that
+ * can be found in the LICENSE file.
+ *
+ * CONTACT INFORMATION:
+ * mailto:tangramteam@outlook.com or mailto:sunhuizlz@yeah.net
+ * https://www.webruntime.com
+ *******************************************************************************/
+
+#include "stdafx.h"
+#include "LayoutDiff.h"
+#include <mutex>
+#include <set>
+
+#define LAYOUTDIFF_REPRO_DIR _T("LayoutDiff\\")
+
+static unsigned int LayoutDiffHash(const CString& str)
+{
+	// FNV-1a over the characters
+	unsigned int nHash = 2166136261u;
+	for (int i = 0; i < str.GetLength(); i++)
+		nHash = (nHash ^ (unsigned int)str[i]) * 16777619u;
+	return nHash;
+}
+
+bool CLayoutDiff::Compare(const CString& strXml, LayoutDiffResult& result)
+{
+	result.m_bDiverged = false;
+	result.m_strPath = _T("");
+	result.m_strReason = _T("");
+	result.m_strRepro = _T("");
+	result.m_nTests = 0;
+
+	// SetDoc rather than Load and the DOM's loadXML rather than load: the
+	// text is the document, never a file name or URL
+	CMarkup xml;
+	bool bMarkup = xml.SetDoc(strXml) && xml.FindElem();
+	unique_ptr<CTangramXmlParse> pParse;
+	CComPtr<IXMLDOMDocument> pDoc;
+	if (pDoc.CoCreateInstance(CLSID_DOMDocument) == S_OK)
+	{
+		VARIANT_BOOL vb = VARIANT_FALSE;
+		pDoc->put_async(VARIANT_FALSE);
+		pDoc->put_resolveExternals(VARIANT_FALSE);
+		CComPtr<IXMLDOMElement> pEle;
+		if (pDoc->loadXML(CComBSTR(strXml), &vb) == S_OK && vb && pDoc->get_documentElement(&pEle) == S_OK && pEle)
+			pParse.reset(new CTangramXmlParse(pEle));
+	}
+	bool bDom = pParse != nullptr;
+
+	if (bMarkup != bDom)
+	{
+		result.m_bDiverged = true;
+		result.m_strPath = _T("/");
+		result.m_strReason = bMarkup ? _T("accepted by CMarkup only") : _T("accepted by MSXML only");
+		return true;
+	}
+	if (bMarkup == false)
+		return false;
+	return CompareElem(xml, pParse.get(), _T(""), result);
+}
+
+bool CLayoutDiff::CompareElem(CMarkup& xml, CTangramXmlParse* pParse, const CString& strPath, LayoutDiffResult& result)
+{
+	CString strTag = xml.GetTagName();
+	CString strElemPath = strPath + _T("/") + strTag;
+	if (strTag != pParse->name())
+	{
+		result.m_bDiverged = true;
+		result.m_strPath = strElemPath;
+		result.m_strReason = _T("tag name");
+		return true;
+	}
+
+	// same attribute names with the same values, in any order
+	CComPtr<IXMLDOMNamedNodeMap> pAttrs;
+	long nDomAttrs = 0;
+	if (pParse->GetElement()->get_attributes(&pAttrs) == S_OK && pAttrs)
+		pAttrs->get_length(&nDomAttrs);
+	int nAttrs = 0;
+	for (CString strName = xml.GetAttribName(0); strName != _T(""); strName = xml.GetAttribName(++nAttrs))
+	{
+		CComVariant var;
+		if (pParse->GetElement()->getAttribute(CComBSTR(strName), &var) != S_OK || var.vt != VT_BSTR ||
+			CString(xml.GetAttrib(strName)) != CString(var.bstrVal))
+		{
+			result.m_bDiverged = true;
+			result.m_strPath = strElemPath + _T("/@") + strName;
+			result.m_strReason = _T("attribute value");
+			return true;
+		}
+	}
+	if (nAttrs != nDomAttrs)
+	{
+		result.m_bDiverged = true;
+		result.m_strPath = strElemPath;
+		result.m_strReason = _T("attribute count");
+		return true;
+	}
+
+	int nCount = pParse->GetCount();
+	int nIndex = 0;
+	xml.IntoElem();
+	while (xml.FindElem())
+	{
+		CString strChildPath;
+		strChildPath.Format(_T("%s[%d]"), (LPCTSTR)strElemPath, nIndex + 1);
+		if (nIndex >= nCount)
+		{
+			result.m_bDiverged = true;
+			result.m_strPath = strChildPath;
+			result.m_strReason = _T("child count");
+			return true;
+		}
+		if (CompareElem(xml, pParse->GetChild(nIndex), strChildPath, result))
+			return true;
+		nIndex++;
+	}
+	xml.OutOfElem();
+	if (nIndex != nCount)
+	{
+		result.m_bDiverged = true;
+		result.m_strPath = strElemPath;
+		result.m_strReason = _T("child count");
+		return true;
+	}
+	return false;
+}
+
+bool CLayoutDiff::Diverges(const CString& strXml, const CString& strReason)
+{
+	LayoutDiffResult result;
+	return Compare(strXml, result) && result.m_strReason == strReason;
+}
+
+bool CLayoutDiff::Check(const CString& strXml, LayoutDiffResult& result, int nMaxTests)
+{
+	if (Compare(strXml, result) == false)
+		return false;
+	int nTests = 0;
+	CString strRepro = Minimize(strXml, result.m_strReason, nMaxTests, nTests);
+	// the repro diverges the same way, the path is reported where it does
+	Compare(strRepro, result);
+	result.m_strRepro = strRepro;
+	result.m_nTests = nTests;
+	return true;
+}
+
+CString CLayoutDiff::Minimize(const CString& strXml, const CString& strReason, int nMaxTests, int& nTests)
+{
+	// delta debugging over the text: drop one of nParts chunks at a time,
+	// keep any drop that still diverges the same way, and cut finer when
+	// none does
+	CString strDoc = strXml;
+	int nParts = 2;
+	nTests = 0;
+	while (strDoc.GetLength() >= 2 && nTests < nMaxTests)
+	{
+		int nLength = strDoc.GetLength();
+		if (nParts > nLength)
+			nParts = nLength;
+		bool bReduced = false;
+		for (int i = 0; i < nParts && nTests < nMaxTests; i++)
+		{
+			int nBegin = (int)((__int64)nLength * i / nParts);
+			int nEnd = (int)((__int64)nLength * (i + 1) / nParts);
+			CString strTry = strDoc.Left(nBegin) + strDoc.Mid(nEnd);
+			nTests++;
+			if (Diverges(strTry, strReason))
+			{
+				strDoc = strTry;
+				nParts = max(nParts - 1, 2);
+				bReduced = true;
+				break;
+			}
+		}
+		if (bReduced)
+			continue;
+		if (nParts >= nLength)
+			break;
+		nParts = min(nParts * 2, nLength);
+	}
+	return strDoc;
+}
+
+void CLayoutDiff::Audit(const CString& strKey, const CString& strXml)
+{
+	// a session commits the same few layouts over and over
+	static std::mutex s_lock;
+	static std::set<unsigned int> s_setChecked;
+	{
+		std::lock_guard<std::mutex> lock(s_lock);
+		if (s_setChecked.insert(LayoutDiffHash(strXml)).second == false)
+			return;
+	}
+	HRESULT hrInit = ::CoInitializeEx(NULL, COINIT_MULTITHREADED);
+	LayoutDiffResult diff;
+	if (Check(strXml, diff))
+	{
+		CString strFile = SaveRepro(strKey, diff);
+		TRACE(_T("layout parsers diverge on %s: %s at %s, repro after %d tests in %s\n"), (LPCTSTR)strKey, (LPCTSTR)diff.m_strReason, (LPCTSTR)diff.m_strPath, diff.m_nTests, (LPCTSTR)strFile);
+	}
+	if (SUCCEEDED(hrInit))
+		::CoUninitialize();
+}
+
+CString CLayoutDiff::SaveRepro(const CString& strKey, const LayoutDiffResult& result)
+{
+	TCHAR szTemp[MAX_PATH] = { 0 };
+	if (::GetTempPath(MAX_PATH, szTemp) == 0)
+		return _T("");
+	CString strDir = CString(szTemp) + LAYOUTDIFF_REPRO_DIR;
+	::CreateDirectory(strDir, NULL);
+	CString strFile;
+	strFile.Format(_T("%s%08x.xml"), (LPCTSTR)strDir, LayoutDiffHash(result.m_strRepro));
+
+	// the comment must not end early, the repro after it is replayed as is
+	CString strNote;
+	strNote.Format(_T("layout parsers diverge on %s: %s at %s"), (LPCTSTR)strKey, (LPCTSTR)result.m_strReason, (LPCTSTR)result.m_strPath);
+	strNote.Replace(_T("--"), _T("- -"));
+	CStringA strText = CW2A(_T("<!-- ") + strNote + _T(" -->\n") + result.m_strRepro, CP_UTF8);
+	FILE* pFile = nullptr;
+	if (_tfopen_s(&pFile, strFile, _T("wb")) != 0 || pFile == nullptr)
+		return _T("");
+	fwrite((LPCSTR)strText, 1, strText.GetLength(), pFile);
+	fclose(pFile);
+	return strFile;
+}
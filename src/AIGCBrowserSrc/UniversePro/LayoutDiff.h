@@ -0,0 +1,77 @@
+/********************************************************************************
+ *           Web Runtime for Application - Version 1.0.0.202203120001           *
+ ********************************************************************************
+ * Copyright (C) 2002-2021 by Tangram Team.   All Rights Reserved.
+ * There are Three Key Features of Webruntime:
+ * 1. Built-in Modern Web Browser: Independent Browser Window and Browser Window
+ *    as sub windows of other windows are supported in the application process;
+ * 2. DOM Plus: DOMPlus is a natural extension of the standard DOM system.
+ *    It allows the application system to support a kind of generalized web pages,
+ *    which are composed of standard DOM elements and binary components supported
+ *    by the application system;
+ * 3. JavaScript for Application: Similar to VBA in MS office, JavaScript will
+ *    become a built-in programmable language in the application system, so that
+ *    the application system can be expanded and developed for the Internet based
+ *    on modern javscript/Web technology.
+ * Use of this source code is governed by a BSD-style license that
+ * can be found in the LICENSE file.
+ *
+ * CONTACT INFORMATION:
+ * mailto:tangramteam@outlook.com or mailto:sunhuizlz@yeah.net
+ * https://www.webruntime.com
+ *******************************************************************************/
+
+// LayoutDiff.h : differential check of the two layout parsers
+//
+// A layout is read by two parsers: the windows are built from the MSXML
+// tree of CTangramXmlParse, the layout tools (CTangramXmlQuery, the layout
+// editor) read the same text with CMarkup. A document the two read
+// differently is shown one way and edited another, and hostile or truncated
+// input from remote pages is where that happens. CLayoutDiff parses a
+// document with both, compares the element names, attributes and children,
+// which is all a layout reads, and on a divergence shrinks the document to a
+// small one that still diverges the same way, so it can be reported and
+// replayed.
+//
+// Every build audits the layouts it commits. The headless tests fuzz the
+// json conversion and CMarkup on their own (tests/*Fuzz.cpp), MSXML only
+// exists here.
+//
+// MSXML is a COM object: Compare, Check and Minimize run on a thread with
+// COM initialized, Audit initializes it itself.
+
+#pragma once
+
+#include <memory>
+#include "Markup.h"
+
+struct LayoutDiffResult
+{
+	bool		m_bDiverged;
+	CString		m_strPath;		// first difference, e.g. /layout/nucleus/xobj[2]
+	CString		m_strReason;	// kind of difference, kept while minimizing
+	CString		m_strRepro;		// smallest document found that still diverges
+	int			m_nTests;		// documents parsed while minimizing
+};
+
+class CLayoutDiff
+{
+public:
+	// true when CMarkup and MSXML disagree on strXml
+	static bool Compare(const CString& strXml, LayoutDiffResult& result);
+	// Compare, and on a divergence fill m_strRepro by Minimize
+	static bool Check(const CString& strXml, LayoutDiffResult& result, int nMaxTests = 2000);
+	// strXml with as much removed as possible while Compare still reports
+	// strReason, trying at most nMaxTests documents
+	static CString Minimize(const CString& strXml, const CString& strReason, int nMaxTests, int& nTests);
+	// Check each distinct document once per process; a divergence is traced
+	// and its repro saved by SaveRepro. Meant for the worker pool.
+	static void Audit(const CString& strKey, const CString& strXml);
+	// writes the repro to %TEMP%\LayoutDiff\<hash>.xml, with the key,
+	// reason and path in a leading comment, and returns the file name
+	static CString SaveRepro(const CString& strKey, const LayoutDiffResult& result);
+
+private:
+	static bool CompareElem(CMarkup& xml, CTangramXmlParse* pParse, const CString& strPath, LayoutDiffResult& result);
+	static bool Diverges(const CString& strXml, const CString& strReason);
+};
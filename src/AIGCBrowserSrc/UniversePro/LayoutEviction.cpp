@@ -0,0 +1,185 @@
+/********************************************************************************
+ *           Web Runtime for Application - Version 1.0.0.202203120001           *
+ ********************************************************************************
+ * Copyright (C) 2002-2021 by Tangram Team.   All Rights Reserved.
+ * There are Three Key Features of Webruntime:
+ * 1. Built-in Modern Web Browser: Independent Browser Window and Browser Window
+ *    as sub windows of other windows are supported in the application process;
+ * 2. DOM Plus: DOMPlus is a natural extension of the standard DOM system.
+ *    It allows the application system to support a kind of generalized web pages,
+ *    which are composed of standard DOM elements and binary components supported
+ *    by the application system;
+ * 3. JavaScript for Application: Similar to VBA in MS office, JavaScript will
+ *    become a built-in programmable language in the application system, so that
+ *    the application system can be expanded and developed for the Internet based
+ *    on modern javscript/Web technology.
+ * Use of this source code is governed by a BSD-style license that
+ * can be found in the LICENSE file.
+ *
+ * CONTACT INFORMATION:
+ * mailto:tangramteam@outlook.com or mailto:sunhuizlz@yeah.net
+ * https://www.webruntime.com
+ *******************************************************************************/
+
+#include "stdafx.h"
+#include "LayoutEviction.h"
+
+// default budgets, well below the 10000 USER handles a process may own
+#define LAYOUT_NUCLEUS_HANDLES		2000
+#define LAYOUT_NUCLEUS_BYTES		(64 * 1024 * 1024)
+#define LAYOUT_GLOBAL_HANDLES		6000
+#define LAYOUT_GLOBAL_BYTES			(256 * 1024 * 1024)
+
+static void AddUsage(LayoutUsage& total, const LayoutUsage& usage, int nSign)
+{
+	total.m_nNodes += nSign * usage.m_nNodes;
+	total.m_nHandles += nSign * usage.m_nHandles;
+	if (nSign > 0)
+		total.m_nBytes += usage.m_nBytes;
+	else
+		total.m_nBytes -= min(total.m_nBytes, usage.m_nBytes);
+}
+
+void CLruLayoutEvictionPolicy::SelectVictims(const vector<LayoutEntry>& vEntries, const LayoutBudget& budgetOwner, const LayoutBudget& budgetGlobal, vector<int>& vVictims)
+{
+	LayoutUsage global = { 0, 0, 0 };
+	map<void*, LayoutUsage> mapOwner;
+	vector<int> vCandidates;
+	for (int i = 0; i < (int)vEntries.size(); i++)
+	{
+		const LayoutEntry& entry = vEntries[i];
+		AddUsage(mapOwner[entry.m_pOwner], entry.m_Usage, 1);
+		AddUsage(global, entry.m_Usage, 1);
+		if (entry.m_bHidden && entry.m_bPinned == false)
+			vCandidates.push_back(i);
+	}
+	stable_sort(vCandidates.begin(), vCandidates.end(), [&vEntries](int a, int b) { return vEntries[a].m_nLastUse < vEntries[b].m_nLastUse; });
+
+	for (int i : vCandidates)
+	{
+		const LayoutEntry& entry = vEntries[i];
+		LayoutUsage& owner = mapOwner[entry.m_pOwner];
+		if (CLayoutEvictionManager::IsOver(owner, budgetOwner) || CLayoutEvictionManager::IsOver(global, budgetGlobal))
+		{
+			vVictims.push_back(i);
+			AddUsage(owner, entry.m_Usage, -1);
+			AddUsage(global, entry.m_Usage, -1);
+		}
+	}
+}
+
+CLayoutEvictionManager::CLayoutEvictionManager()
+{
+	m_budgetNucleus.m_nNodes = 0;
+	m_budgetNucleus.m_nHandles = LAYOUT_NUCLEUS_HANDLES;
+	m_budgetNucleus.m_nBytes = LAYOUT_NUCLEUS_BYTES;
+	m_budgetGlobal.m_nNodes = 0;
+	m_budgetGlobal.m_nHandles = LAYOUT_GLOBAL_HANDLES;
+	m_budgetGlobal.m_nBytes = LAYOUT_GLOBAL_BYTES;
+	m_nEvicted = 0;
+	m_nRestored = 0;
+	m_nClock = 0;
+	m_pPolicy = make_shared<CLruLayoutEvictionPolicy>();
+}
+
+bool CLayoutEvictionManager::IsOver(const LayoutUsage& usage, const LayoutBudget& budget)
+{
+	return (budget.m_nNodes && usage.m_nNodes > budget.m_nNodes)
+		|| (budget.m_nHandles && usage.m_nHandles > budget.m_nHandles)
+		|| (budget.m_nBytes && usage.m_nBytes > budget.m_nBytes);
+}
+
+void CLayoutEvictionManager::SetPolicy(shared_ptr<ILayoutEvictionPolicy> pPolicy)
+{
+	if (pPolicy)
+		m_pPolicy = pPolicy;
+}
+
+int CLayoutEvictionManager::Find(void* pOwner, const CString& strKey) const
+{
+	for (int i = 0; i < (int)m_vEntries.size(); i++)
+	{
+		if (m_vEntries[i].m_pOwner == pOwner && m_vEntries[i].m_strKey == strKey)
+			return i;
+	}
+	return -1;
+}
+
+void CLayoutEvictionManager::Track(void* pOwner, const CString& strKey, const LayoutUsage& usage, bool bHidden)
+{
+	int nIndex = Find(pOwner, strKey);
+	if (nIndex == -1)
+	{
+		LayoutEntry entry;
+		entry.m_pOwner = pOwner;
+		entry.m_strKey = strKey;
+		entry.m_Usage = usage;
+		entry.m_bHidden = bHidden;
+		entry.m_bPinned = false;
+		entry.m_nLastUse = ++m_nClock;
+		m_vEntries.push_back(entry);
+		nIndex = (int)m_vEntries.size() - 1;
+	}
+	LayoutEntry& entry = m_vEntries[nIndex];
+	entry.m_Usage = usage;
+	entry.m_bHidden = bHidden;
+	if (bHidden == false)
+		entry.m_nLastUse = ++m_nClock;
+}
+
+void CLayoutEvictionManager::SetPinned(void* pOwner, const CString& strKey, bool bPinned)
+{
+	int nIndex = Find(pOwner, strKey);
+	if (nIndex == -1)
+	{
+		// pinned ahead of its first Track, it counts as visible until then
+		LayoutUsage usage = { 0, 0, 0 };
+		Track(pOwner, strKey, usage, false);
+		nIndex = (int)m_vEntries.size() - 1;
+	}
+	m_vEntries[nIndex].m_bPinned = bPinned;
+}
+
+bool CLayoutEvictionManager::IsPinned(void* pOwner, const CString& strKey) const
+{
+	int nIndex = Find(pOwner, strKey);
+	return nIndex != -1 && m_vEntries[nIndex].m_bPinned;
+}
+
+void CLayoutEvictionManager::Remove(void* pOwner, const CString& strKey)
+{
+	int nIndex = Find(pOwner, strKey);
+	if (nIndex != -1)
+		m_vEntries.erase(m_vEntries.begin() + nIndex);
+}
+
+void CLayoutEvictionManager::RemoveOwner(void* pOwner)
+{
+	m_vEntries.erase(remove_if(m_vEntries.begin(), m_vEntries.end(), [pOwner](const LayoutEntry& entry) { return entry.m_pOwner == pOwner; }), m_vEntries.end());
+}
+
+int CLayoutEvictionManager::Collect(vector<LayoutEntry>& vVictims)
+{
+	vVictims.clear();
+	vector<int> vIndex;
+	m_pPolicy->SelectVictims(m_vEntries, m_budgetNucleus, m_budgetGlobal, vIndex);
+	if (vIndex.size() == 0)
+		return 0;
+	sort(vIndex.begin(), vIndex.end());
+	vIndex.erase(unique(vIndex.begin(), vIndex.end()), vIndex.end());
+	for (auto it = vIndex.rbegin(); it != vIndex.rend(); ++it)
+	{
+		// the policy is pluggable, never trust it with visible or pinned layouts
+		if (*it < 0 || *it >= (int)m_vEntries.size() || m_vEntries[*it].m_bHidden == false || m_vEntries[*it].m_bPinned)
+			continue;
+		vVictims.push_back(m_vEntries[*it]);
+	}
+	reverse(vVictims.begin(), vVictims.end());
+	return (int)vVictims.size();
+}
+
+void CLayoutEvictionManager::Evicted(void* pOwner, const CString& strKey)
+{
+	Remove(pOwner, strKey);
+	m_nEvicted++;
+}
@@ -0,0 +1,110 @@
+/********************************************************************************
+ *           Web Runtime for Application - Version 1.0.0.202203120001           *
+ ********************************************************************************
+ * Copyright (C) 2002-2021 by Tangram Team.   All Rights Reserved.
+ * There are Three Key Features of Webruntime:
+ * 1. Built-in Modern Web Browser: Independent Browser Window and Browser Window
+ *    as sub windows of other windows are supported in the application process;
+ * 2. DOM Plus: DOMPlus is a natural extension of the standard DOM system.
+ *    It allows the application system to support a kind of generalized web pages,
+ *    which are composed of standard DOM elements and binary components supported
+ *    by the application system;
+ * 3. JavaScript for Application: Similar to VBA in MS office, JavaScript will
+ *    become a built-in programmable language in the application system, so that
+ *    the application system can be expanded and developed for the Internet based
+ *    on modern javscript/Web technology.
+ * Use of this source code is governed by a BSD-style license that
+ * can be found in the LICENSE file.
+ *
+ * CONTACT INFORMATION:
+ * mailto:tangramteam@outlook.com or mailto:sunhuizlz@yeah.net
+ * https://www.webruntime.com
+ *******************************************************************************/
+
+// LayoutEviction.h : budgets and eviction of hidden nucleus layouts
+//
+// When CNucleus::Observe switches keys the previous root xobj is only hidden,
+// so long sessions pile up window trees. Every root layout is tracked here
+// with its owner (the nucleus), its usage and when it was last shown. When a
+// nucleus or the whole process goes over budget the policy picks hidden,
+// unpinned layouts to evict; the nucleus then serializes each victim to its
+// XML and destroys its windows, and recreates it from that XML on demand.
+//
+// Nothing in here touches a window, owners are opaque pointers.
+
+#pragma once
+
+// a zero limit means unlimited
+struct LayoutBudget
+{
+	long		m_nNodes;
+	long		m_nHandles;
+	size_t		m_nBytes;
+};
+
+struct LayoutUsage
+{
+	long		m_nNodes;
+	long		m_nHandles;
+	size_t		m_nBytes;
+};
+
+struct LayoutEntry
+{
+	void*		m_pOwner;
+	CString		m_strKey;
+	LayoutUsage	m_Usage;
+	__int64		m_nLastUse;
+	bool		m_bHidden;
+	bool		m_bPinned;
+};
+
+class ILayoutEvictionPolicy
+{
+public:
+	virtual ~ILayoutEvictionPolicy() {}
+	// appends to vVictims the indexes into vEntries to evict so that every
+	// owner fits budgetOwner and all entries together fit budgetGlobal;
+	// only hidden, unpinned entries may be chosen
+	virtual void SelectVictims(const vector<LayoutEntry>& vEntries, const LayoutBudget& budgetOwner, const LayoutBudget& budgetGlobal, vector<int>& vVictims) = 0;
+};
+
+// least recently shown first
+class CLruLayoutEvictionPolicy : public ILayoutEvictionPolicy
+{
+public:
+	virtual void SelectVictims(const vector<LayoutEntry>& vEntries, const LayoutBudget& budgetOwner, const LayoutBudget& budgetGlobal, vector<int>& vVictims);
+};
+
+class CLayoutEvictionManager
+{
+public:
+	CLayoutEvictionManager();
+
+	LayoutBudget								m_budgetNucleus;
+	LayoutBudget								m_budgetGlobal;
+	long										m_nEvicted;
+	long										m_nRestored;
+
+	void SetPolicy(shared_ptr<ILayoutEvictionPolicy> pPolicy);
+	// records the current usage of a layout; showing it counts as a use
+	void Track(void* pOwner, const CString& strKey, const LayoutUsage& usage, bool bHidden);
+	void SetPinned(void* pOwner, const CString& strKey, bool bPinned);
+	bool IsPinned(void* pOwner, const CString& strKey) const;
+	void Remove(void* pOwner, const CString& strKey);
+	void RemoveOwner(void* pOwner);
+	// returns the layouts the policy wants gone; they stay tracked until the
+	// owner reports each one it really evicted through Evicted
+	int Collect(vector<LayoutEntry>& vVictims);
+	void Evicted(void* pOwner, const CString& strKey);
+
+	const vector<LayoutEntry>& GetEntries() const { return m_vEntries; }
+	static bool IsOver(const LayoutUsage& usage, const LayoutBudget& budget);
+
+private:
+	__int64										m_nClock;
+	vector<LayoutEntry>							m_vEntries;
+	shared_ptr<ILayoutEvictionPolicy>			m_pPolicy;
+
+	int Find(void* pOwner, const CString& strKey) const;
+};
@@ -0,0 +1,106 @@
+/********************************************************************************
+ *           Web Runtime for Application - Version 1.0.0.202203120001           *
+ ********************************************************************************
+ * Copyright (C) 2002-2021 by Tangram Team.   All Rights Reserved.
+ * There are Three Key Features of Webruntime:
+ * 1. Built-in Modern Web Browser: Independent Browser Window and Browser Window
+ *    as sub windows of other windows are supported in the application process;
+ * 2. DOM Plus: DOMPlus is a natural extension of the standard DOM system.
+ *    It allows the application system to support a kind of generalized web pages,
+ *    which are composed of standard DOM elements and binary components supported
+ *    by the application system;
+ * 3. JavaScript for Application: Similar to VBA in MS office, JavaScript will
+ *    become a built-in programmable language in the application system, so that
+ *    the application system can be expanded and developed for the Internet based
+ *    on modern javscript/Web technology.
+ * Use of this source code is governed by a BSD-style license that
+ * can be found in the LICENSE file.
+ *
+ * CONTACT INFORMATION:
+ * mailto:tangramteam@outlook.com or mailto:sunhuizlz@yeah.net
+ * https://www.webruntime.com
+ *******************************************************************************/
+
+#include "stdafx.h"
+#include "LayoutPlan.h"
+
+CLayoutPlan::CLayoutPlan()
+{
+	m_bValid = false;
+	m_nGeneration = 0;
+}
+
+CLayoutPlanPtr CLayoutPlan::Prepare(const CString& strKey, const CString& strSourceXml, long nGeneration, const std::atomic<long>& nCurrentGeneration, LayoutJsonConverter pConverter)
+{
+	shared_ptr<CLayoutPlan> pPlan = make_shared<CLayoutPlan>();
+	pPlan->m_strKey = strKey;
+	pPlan->m_strSourceXml = strSourceXml;
+	pPlan->m_nGeneration = nGeneration;
+	pPlan->m_strXml = CLayoutTree::Normalize(strSourceXml, pConverter, pPlan->m_strError);
+	if (pPlan->m_strXml == _T(""))
+		return pPlan;
+	if (nCurrentGeneration.load() != nGeneration)
+		return nullptr;
+
+	// a layout without an xobj tree is left to ObserveEx, which parses the
+	// text itself as it always did
+	if (pPlan->m_Tree.Build(pPlan->m_strXml, nGeneration, nCurrentGeneration) == false)
+		return nullptr;
+	if (pPlan->m_Tree.IsValid() == false)
+	{
+		pPlan->m_strError = pPlan->m_Tree.m_strError;
+		return pPlan;
+	}
+
+	// worker threads have no apartment of their own; the free-threaded
+	// document outlives this one because the UI thread's apartment keeps
+	// MSXML loaded
+	HRESULT hrInit = ::CoInitializeEx(NULL, COINIT_MULTITHREADED);
+	CComPtr<IXMLDOMDocument> pDoc;
+	if (pDoc.CoCreateInstance(CLSID_FreeThreadedDOMDocument, NULL, CLSCTX_INPROC_SERVER) == S_OK)
+	{
+		// there is no message loop here to finish an asynchronous load
+		pDoc->put_async(VARIANT_FALSE);
+		VARIANT_BOOL vb = VARIANT_FALSE;
+		if (pPlan->m_strXml.Find(_T("<")) == 0)
+			pDoc->loadXML(CComBSTR(pPlan->m_strXml), &vb);
+		else
+			pDoc->load(CComVariant(pPlan->m_strXml), &vb);
+		if (vb)
+			pPlan->m_pDoc = pDoc;
+		else
+		{
+			CComPtr<IXMLDOMParseError> pError;
+			CComBSTR bstrReason;
+			if (pDoc->get_parseError(&pError) == S_OK && pError && pError->get_reason(&bstrReason) == S_OK)
+				pPlan->m_strError = bstrReason;
+			if (pPlan->m_strError == _T(""))
+				pPlan->m_strError = _T("xml load failed");
+		}
+	}
+	else
+		pPlan->m_strError = _T("no free-threaded xml document");
+	pDoc.Release();
+	if (SUCCEEDED(hrInit))
+		::CoUninitialize();
+	if (nCurrentGeneration.load() != nGeneration)
+		return nullptr;
+	pPlan->m_bValid = pPlan->m_pDoc != nullptr;
+	return pPlan;
+}
+
+void CLayoutPlanQueue::Push(CLayoutPlanPtr pPlan)
+{
+	std::lock_guard<std::mutex> lock(m_lock);
+	m_vPlans.push_back(pPlan);
+}
+
+CLayoutPlanPtr CLayoutPlanQueue::Pop()
+{
+	std::lock_guard<std::mutex> lock(m_lock);
+	if (m_vPlans.size() == 0)
+		return nullptr;
+	CLayoutPlanPtr pPlan = m_vPlans.front();
+	m_vPlans.pop_front();
+	return pPlan;
+}
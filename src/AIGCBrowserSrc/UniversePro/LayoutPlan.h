@@ -0,0 +1,82 @@
+/********************************************************************************
+ *           Web Runtime for Application - Version 1.0.0.202203120001           *
+ ********************************************************************************
+ * Copyright (C) 2002-2021 by Tangram Team.   All Rights Reserved.
+ * There are Three Key Features of Webruntime:
+ * 1. Built-in Modern Web Browser: Independent Browser Window and Browser Window
+ *    as sub windows of other windows are supported in the application process;
+ * 2. DOM Plus: DOMPlus is a natural extension of the standard DOM system.
+ *    It allows the application system to support a kind of generalized web pages,
+ *    which are composed of standard DOM elements and binary components supported
+ *    by the application system;
+ * 3. JavaScript for Application: Similar to VBA in MS office, JavaScript will
+ *    become a built-in programmable language in the application system, so that
+ *    the application system can be expanded and developed for the Internet based
+ *    on modern javscript/Web technology.
+ * Use of this source code is governed by a BSD-style license that
+ * can be found in the LICENSE file.
+ *
+ * CONTACT INFORMATION:
+ * mailto:tangramteam@outlook.com or mailto:sunhuizlz@yeah.net
+ * https://www.webruntime.com
+ *******************************************************************************/
+
+// LayoutPlan.h : off-UI-thread preparation of nucleus layouts
+//
+// CNucleus::Observe is split into two phases. The prepare phase normalizes
+// the layout source (BOM, JSON conversion), reads its xobj tree and splitter
+// sizes with CLayoutTree, and then parses it, or loads the file it names,
+// into a free-threaded MSXML document. A free-threaded document may be built
+// on the concurrency runtime's worker pool and handed over to the UI thread,
+// where the commit phase wraps it with CTangramXmlParse::LoadDoc instead of
+// parsing the text again, and creates and positions the windows.
+//
+// Every plan is stamped with the generation of the request that produced it.
+// Starting a new request bumps the generation, which makes the prepare phase
+// of any older request stop at its next checkpoint and makes its result be
+// dropped instead of committed.
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <deque>
+#include "LayoutTree.h"
+
+class CLayoutPlan
+{
+public:
+	CLayoutPlan();
+
+	bool										m_bValid;
+	long										m_nGeneration;
+	CString										m_strKey;
+	CString										m_strSourceXml;	// what the request handed in
+	CString										m_strXml;		// normalized XML or file name handed to the commit phase
+	CString										m_strError;
+	CLayoutTree									m_Tree;			// m_strXml read by CMarkup
+	CComPtr<IXMLDOMDocument>					m_pDoc;			// m_strXml parsed, owned by the one commit that takes the plan
+
+	// Pure prepare phase, safe on any thread. Returns nullptr when
+	// nCurrentGeneration moves away from nGeneration before it finishes.
+	static shared_ptr<const CLayoutPlan> Prepare(const CString& strKey, const CString& strSourceXml, long nGeneration, const std::atomic<long>& nCurrentGeneration, LayoutJsonConverter pConverter);
+};
+
+typedef shared_ptr<const CLayoutPlan> CLayoutPlanPtr;
+
+// Hands plans from the worker pool to the UI thread. The tasks only post a
+// notification; the plans stay here, so a plan whose window is gone before
+// the notification arrives is released with the queue instead of leaking.
+class CLayoutPlanQueue
+{
+public:
+	void Push(CLayoutPlanPtr pPlan);
+	CLayoutPlanPtr Pop();
+
+private:
+	std::mutex									m_lock;
+	deque<CLayoutPlanPtr>						m_vPlans;
+};
+
+typedef shared_ptr<CLayoutPlanQueue> CLayoutPlanQueuePtr;
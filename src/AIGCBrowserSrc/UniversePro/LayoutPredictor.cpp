@@ -0,0 +1,280 @@
+/********************************************************************************
+ *           Web Runtime for Application - Version 1.0.0.202203120001           *
+ ********************************************************************************
+ * Copyright (C) 2002-2021 by Tangram Team.   All Rights Reserved.
+ * There are Three Key Features of Webruntime:
+ * 1. Built-in Modern Web Browser: Independent Browser Window and Browser Window
+ *    as sub windows of other windows are supported in the application process;
+ * 2. DOM Plus: DOMPlus is a natural extension of the standard DOM system.
+ *    It allows the application system to support a kind of generalized web pages,
+ *    which are composed of standard DOM elements and binary components supported
+ *    by the application system;
+ * 3. JavaScript for Application: Similar to VBA in MS office, JavaScript will
+ *    become a built-in programmable language in the application system, so that
+ *    the application system can be expanded and developed for the Internet based
+ *    on modern javscript/Web technology.
+ * Use of this source code is governed by a BSD-style license that
+ * can be found in the LICENSE file.
+ *
+ * CONTACT INFORMATION:
+ * mailto:tangramteam@outlook.com or mailto:sunhuizlz@yeah.net
+ * https://www.webruntime.com
+ *******************************************************************************/
+
+#include "stdafx.h"
+#include "LayoutPredictor.h"
+#include "Markup.h"
+
+// counts are halved once any of them reaches this, so old habits fade out
+#define LAYOUTPREDICTOR_AGE_LIMIT	4096
+#define LAYOUTPREDICTOR_BUDGET		(4 * 1024 * 1024)
+#define LAYOUTPREDICTOR_DOM_FACTOR	4
+
+CLayoutPredictor::CLayoutPredictor()
+{
+	m_nBudget = LAYOUTPREDICTOR_BUDGET;
+	m_nUsed = 0;
+	m_nHits = 0;
+	m_nMisses = 0;
+	m_nPrewarmed = 0;
+	m_nEvicted = 0;
+	m_bDirty = false;
+}
+
+void CLayoutPredictor::Record(const CString& strFrom, const CString& strTo)
+{
+	if (strTo == _T("") || strFrom == strTo)
+		return;
+	long nCount = ++m_mapVisit[strTo];
+	if (strFrom != _T(""))
+		nCount = max(nCount, ++m_mapTransition[strFrom][strTo]);
+	m_bDirty = true;
+	if (nCount >= LAYOUTPREDICTOR_AGE_LIMIT)
+		Age();
+}
+
+void CLayoutPredictor::Age()
+{
+	for (auto it = m_mapVisit.begin(); it != m_mapVisit.end();)
+	{
+		it->second /= 2;
+		if (it->second == 0)
+			it = m_mapVisit.erase(it);
+		else
+			++it;
+	}
+	for (auto it = m_mapTransition.begin(); it != m_mapTransition.end();)
+	{
+		for (auto it2 = it->second.begin(); it2 != it->second.end();)
+		{
+			it2->second /= 2;
+			if (it2->second == 0)
+				it2 = it->second.erase(it2);
+			else
+				++it2;
+		}
+		if (it->second.size() == 0)
+			it = m_mapTransition.erase(it);
+		else
+			++it;
+	}
+}
+
+int CLayoutPredictor::Predict(const CString& strFrom, int nMax, vector<CString>& vKeys) const
+{
+	vKeys.clear();
+	vector<pair<long, CString>> vRank;
+	auto it = m_mapTransition.find(strFrom);
+	if (it != m_mapTransition.end())
+	{
+		for (auto& it2 : it->second)
+			vRank.push_back(make_pair(it2.second, it2.first));
+	}
+	// successors first, ordered by count; ties keep key order for stable output
+	stable_sort(vRank.begin(), vRank.end(), [](const pair<long, CString>& a, const pair<long, CString>& b) { return a.first > b.first; });
+	for (auto& it2 : vRank)
+	{
+		if ((int)vKeys.size() >= nMax)
+			return (int)vKeys.size();
+		vKeys.push_back(it2.second);
+	}
+
+	vRank.clear();
+	for (auto& it2 : m_mapVisit)
+	{
+		if (it2.first != strFrom && find(vKeys.begin(), vKeys.end(), it2.first) == vKeys.end())
+			vRank.push_back(make_pair(it2.second, it2.first));
+	}
+	stable_sort(vRank.begin(), vRank.end(), [](const pair<long, CString>& a, const pair<long, CString>& b) { return a.first > b.first; });
+	for (auto& it2 : vRank)
+	{
+		if ((int)vKeys.size() >= nMax)
+			break;
+		vKeys.push_back(it2.second);
+	}
+	return (int)vKeys.size();
+}
+
+long CLayoutPredictor::Score(const CString& strFrom, const CString& strTo) const
+{
+	// transition count first, overall visits break ties; both stay below the age limit
+	long nTransition = 0;
+	long nVisit = 0;
+	auto it = m_mapTransition.find(strFrom);
+	if (it != m_mapTransition.end())
+	{
+		auto it2 = it->second.find(strTo);
+		if (it2 != it->second.end())
+			nTransition = it2->second;
+	}
+	auto it3 = m_mapVisit.find(strTo);
+	if (it3 != m_mapVisit.end())
+		nVisit = it3->second;
+	return nTransition * LAYOUTPREDICTOR_AGE_LIMIT + nVisit;
+}
+
+size_t CLayoutPredictor::EstimateSize(const CLayoutPlan& plan)
+{
+	size_t nSize = sizeof(CLayoutPlan) + (plan.m_strXml.GetLength() + plan.m_strSourceXml.GetLength()) * sizeof(TCHAR) + plan.m_Tree.GetSize();
+	// an MSXML tree runs at a few times the size of its text
+	if (plan.m_pDoc)
+		nSize += plan.m_strXml.GetLength() * sizeof(TCHAR) * LAYOUTPREDICTOR_DOM_FACTOR;
+	return nSize;
+}
+
+bool CLayoutPredictor::Park(CLayoutPlanPtr pPlan, long nScore)
+{
+	if (pPlan == nullptr || pPlan->m_strXml == _T(""))
+		return false;
+	size_t nSize = EstimateSize(*pPlan);
+	if (nSize > m_nBudget)
+		return false;
+	if (m_mapParked.find(pPlan->m_strKey) != m_mapParked.end())
+	{
+		m_nUsed -= m_mapParked[pPlan->m_strKey].nSize;
+		m_mapParked.erase(pPlan->m_strKey);
+	}
+	while (m_nUsed + nSize > m_nBudget)
+	{
+		auto itLow = m_mapParked.end();
+		for (auto it = m_mapParked.begin(); it != m_mapParked.end(); ++it)
+		{
+			if (itLow == m_mapParked.end() || it->second.nScore < itLow->second.nScore)
+				itLow = it;
+		}
+		if (itLow == m_mapParked.end() || itLow->second.nScore > nScore)
+			return false;	// everything parked is more likely than the newcomer
+		Evict(itLow->first);
+	}
+	ParkedPlan& parked = m_mapParked[pPlan->m_strKey];
+	parked.pPlan = pPlan;
+	parked.nScore = nScore;
+	parked.nSize = nSize;
+	m_nUsed += nSize;
+	m_nPrewarmed++;
+	return true;
+}
+
+void CLayoutPredictor::Evict(const CString& strKey)
+{
+	auto it = m_mapParked.find(strKey);
+	if (it != m_mapParked.end())
+	{
+		m_nUsed -= it->second.nSize;
+		m_mapParked.erase(it);
+		m_nEvicted++;
+	}
+}
+
+bool CLayoutPredictor::IsParked(const CString& strKey) const
+{
+	return m_mapParked.find(strKey) != m_mapParked.end();
+}
+
+CLayoutPlanPtr CLayoutPredictor::Take(const CString& strKey, const CString& strSourceXml)
+{
+	auto it = m_mapParked.find(strKey);
+	if (it == m_mapParked.end())
+	{
+		m_nMisses++;
+		return nullptr;
+	}
+	CLayoutPlanPtr pPlan = it->second.pPlan;
+	m_nUsed -= it->second.nSize;
+	m_mapParked.erase(it);
+	if (pPlan->m_strSourceXml != strSourceXml)
+	{
+		// the source changed since the plan was prepared
+		m_nMisses++;
+		m_nEvicted++;
+		return nullptr;
+	}
+	m_nHits++;
+	return pPlan;
+}
+
+void CLayoutPredictor::Clear()
+{
+	m_nEvicted += (long)m_mapParked.size();
+	m_mapParked.clear();
+	m_nUsed = 0;
+}
+
+bool CLayoutPredictor::Load(const CString& strFile)
+{
+	CMarkup xml;
+	if (xml.Load(strFile) == false || xml.FindElem(_T("layoutprediction")) == false)
+		return false;
+	m_mapTransition.clear();
+	m_mapVisit.clear();
+	xml.IntoElem();
+	while (xml.FindElem())
+	{
+		CString strTag = xml.GetTagName();
+		long nCount = _ttol(CString(xml.GetAttrib(_T("n"))));
+		if (nCount <= 0)
+			continue;
+		if (strTag == _T("visit"))
+			m_mapVisit[CString(xml.GetAttrib(_T("key")))] = nCount;
+		else if (strTag == _T("transition"))
+			m_mapTransition[CString(xml.GetAttrib(_T("from")))][CString(xml.GetAttrib(_T("to")))] = nCount;
+	}
+	m_bDirty = false;
+	return true;
+}
+
+bool CLayoutPredictor::Save(const CString& strFile)
+{
+	CMarkup xml;
+	xml.AddElem(_T("layoutprediction"));
+	xml.IntoElem();
+	for (auto& it : m_mapVisit)
+	{
+		xml.AddElem(_T("visit"));
+		xml.SetAttrib(_T("key"), it.first);
+		xml.SetAttrib(_T("n"), (int)it.second);
+	}
+	for (auto& it : m_mapTransition)
+	{
+		for (auto& it2 : it.second)
+		{
+			xml.AddElem(_T("transition"));
+			xml.SetAttrib(_T("from"), it.first);
+			xml.SetAttrib(_T("to"), it2.first);
+			xml.SetAttrib(_T("n"), (int)it2.second);
+		}
+	}
+	if (xml.Save(strFile) == false)
+		return false;
+	m_bDirty = false;
+	return true;
+}
+
+CString CLayoutPredictor::GetStats() const
+{
+	CString strStats;
+	long nTotal = m_nHits + m_nMisses;
+	strStats.Format(_T("layout prewarm: %ld/%ld hits (%ld%%), %ld prewarmed, %ld evicted, %d parked, %d/%d bytes"),
+		m_nHits, nTotal, nTotal ? m_nHits * 100 / nTotal : 0L, m_nPrewarmed, m_nEvicted, (int)m_mapParked.size(), (int)m_nUsed, (int)m_nBudget);
+	return strStats;
+}
@@ -0,0 +1,82 @@
+/********************************************************************************
+ *           Web Runtime for Application - Version 1.0.0.202203120001           *
+ ********************************************************************************
+ * Copyright (C) 2002-2021 by Tangram Team.   All Rights Reserved.
+ * There are Three Key Features of Webruntime:
+ * 1. Built-in Modern Web Browser: Independent Browser Window and Browser Window
+ *    as sub windows of other windows are supported in the application process;
+ * 2. DOM Plus: DOMPlus is a natural extension of the standard DOM system.
+ *    It allows the application system to support a kind of generalized web pages,
+ *    which are composed of standard DOM elements and binary components supported
+ *    by the application system;
+ * 3. JavaScript for Application: Similar to VBA in MS office, JavaScript will
+ *    become a built-in programmable language in the application system, so that
+ *    the application system can be expanded and developed for the Internet based
+ *    on modern javscript/Web technology.
+ * Use of this source code is governed by a BSD-style license that
+ * can be found in the LICENSE file.
+ *
+ * CONTACT INFORMATION:
+ * mailto:tangramteam@outlook.com or mailto:sunhuizlz@yeah.net
+ * https://www.webruntime.com
+ *******************************************************************************/
+
+// LayoutPredictor.h : key-transition history and prewarmed layout plans
+//
+// Each CNucleus records how often navigating away from one layout key led to
+// another one. After a navigation the most likely next keys that are not
+// alive in m_mapXobj yet are prepared during idle time (CLayoutPlan::Prepare
+// on the worker pool) and parked here, so the following Observe only has to
+// commit. Parked plans live under a byte budget; the least likely plan goes
+// first when the budget is exceeded.
+
+#pragma once
+
+#include "LayoutPlan.h"
+
+class CLayoutPredictor
+{
+public:
+	CLayoutPredictor();
+
+	size_t										m_nBudget;			// bytes of parked plans
+	size_t										m_nUsed;
+	long										m_nHits;
+	long										m_nMisses;
+	long										m_nPrewarmed;
+	long										m_nEvicted;			// parked plans dropped without being used
+	bool										m_bDirty;			// history changed since Load/Save
+
+	void Record(const CString& strFrom, const CString& strTo);
+	// most likely successors of strFrom, falling back to the overall most used keys
+	int Predict(const CString& strFrom, int nMax, vector<CString>& vKeys) const;
+	// likelihood of strTo following strFrom, comparable between keys
+	long Score(const CString& strFrom, const CString& strTo) const;
+
+	bool Park(CLayoutPlanPtr pPlan, long nScore);
+	bool IsParked(const CString& strKey) const;
+	// hands out the parked plan for strKey if it was prepared from strSourceXml
+	CLayoutPlanPtr Take(const CString& strKey, const CString& strSourceXml);
+	void Clear();
+
+	bool Load(const CString& strFile);
+	bool Save(const CString& strFile);
+	CString GetStats() const;
+
+	static size_t EstimateSize(const CLayoutPlan& plan);
+
+private:
+	struct ParkedPlan
+	{
+		CLayoutPlanPtr pPlan;
+		long nScore;
+		size_t nSize;
+	};
+
+	map<CString, map<CString, long>>			m_mapTransition;
+	map<CString, long>							m_mapVisit;
+	map<CString, ParkedPlan>					m_mapParked;
+
+	void Age();
+	void Evict(const CString& strKey);
+};
@@ -0,0 +1,228 @@
+/********************************************************************************
+ *           Web Runtime for Application - Version 1.0.0.202203120001           *
+ ********************************************************************************
+ * Copyright (C) 2002-2021 by Tangram Team.   All Rights Reserved.
+ * There are Three Key Features of Webruntime:
+ * 1. Built-in Modern Web Browser: Independent Browser Window and Browser Window
+ *    as sub windows of other windows are supported in the application process;
+ * 2. DOM Plus: DOMPlus is a natural extension of the standard DOM system.
+ *    It allows the application system to support a kind of generalized web pages,
+ *    which are composed of standard DOM elements and binary components supported
+ *    by the application system;
+ * 3. JavaScript for Application: Similar to VBA in MS office, JavaScript will
+ *    become a built-in programmable language in the application system, so that
+ *    the application system can be expanded and developed for the Internet based
+ *    on modern javscript/Web technology.
+ * Use of this source code is governed by a BSD-style license that
+ * can be found in the LICENSE file.
+ *
+ * CONTACT INFORMATION:
+ * mailto:tangramteam@outlook.com or mailto:sunhuizlz@yeah.net
+ * https://www.webruntime.com
+ *******************************************************************************/
+
+#include "stdafx.h"
+#include "LayoutTree.h"
+
+// the tree is built with a cancellation check once per this many xobj nodes
+#define LAYOUTTREE_CHECKPOINT	64
+
+CLayoutTree::CLayoutTree()
+{
+	m_bSizable = false;
+	m_nSplitterCount = 0;
+}
+
+CString CLayoutTree::Normalize(const CString& strSourceXml, LayoutJsonConverter pConverter, CString& strError)
+{
+	CString strXml = strSourceXml;
+	if (strXml.GetLength() && strXml[0] == 0xFEFF)
+		strXml = strXml.Mid(1);
+	strXml.Trim();
+	if (strXml.Find(_T("{")) == 0)
+	{
+		strXml = pConverter ? pConverter(strXml) : CString(_T(""));
+		if (strXml == _T(""))
+			strError = _T("json conversion failed");
+	}
+	return strXml;
+}
+
+bool CLayoutTree::Build(const CString& strXml, long nGeneration, const std::atomic<long>& nCurrentGeneration)
+{
+	CMarkup xml;
+	bool bXml = false;
+	if (strXml.Find(_T("<")) == 0)
+		bXml = xml.SetDoc((LPCTSTR)strXml);
+	else if (strXml != _T(""))
+		bXml = xml.Load((LPCTSTR)strXml);
+	if (bXml == false)
+	{
+		m_strError = CString(xml.GetError());
+		if (m_strError == _T(""))
+			m_strError = _T("layout is not readable");
+		return nCurrentGeneration.load() == nGeneration;
+	}
+	if (nCurrentGeneration.load() != nGeneration)
+		return false;
+
+	xml.ResetPos();
+	if (xml.FindElem())
+	{
+		m_bSizable = CString(xml.GetAttrib(_T("sizable"))).CompareNoCase(_T("true")) == 0;
+		m_strCaption = CString(xml.GetAttrib(_T("caption")));
+		if (BuildNodes(xml, nGeneration, nCurrentGeneration) == false)
+			return false;
+	}
+	if (m_vNodes.size() == 0)
+		m_strError = _T("layout has no nucleus/xobj element");
+	return true;
+}
+
+bool CLayoutTree::BuildNodes(CMarkup& xml, long nGeneration, const std::atomic<long>& nCurrentGeneration)
+{
+	// positioned on the document element, looking for <nucleus><xobj>
+	xml.IntoElem();
+	bool bFound = false;
+	while (xml.FindElem())
+	{
+		if (CString(xml.GetTagName()).CompareNoCase(TGM_NUCLEUS) == 0)
+		{
+			bFound = true;
+			break;
+		}
+	}
+	if (bFound == false)
+		return true;
+	xml.IntoElem();
+	bFound = false;
+	while (xml.FindElem())
+	{
+		if (CString(xml.GetTagName()).CompareNoCase(TGM_XOBJ) == 0)
+		{
+			bFound = true;
+			break;
+		}
+	}
+	if (bFound == false)
+		return true;
+
+	// iterative pre-order walk over nested xobj elements, the CMarkup position
+	// itself is the stack; vParents holds the node index of each open level
+	vector<int> vParents;
+	int nParent = -1;
+	while (true)
+	{
+		if (CString(xml.GetTagName()).CompareNoCase(TGM_XOBJ) == 0)
+		{
+			LayoutTreeNode node;
+			node.m_strTag = CString(xml.GetTagName());
+			node.m_strName = CString(xml.GetAttrib(TGM_NAME));
+			node.m_strObjID = CString(xml.GetAttrib(TGM_OBJ_ID));
+			node.m_nParent = nParent;
+			node.m_nDepth = (int)vParents.size();
+			node.m_nRows = _ttoi(CString(xml.GetAttrib(TGM_ROWS)));
+			node.m_nCols = _ttoi(CString(xml.GetAttrib(TGM_COLS)));
+			if (node.m_nRows > 0 && node.m_nCols > 0)
+			{
+				ParseSizeList(CString(xml.GetAttrib(TGM_WIDTH)), node.m_nCols, node.m_vWidth);
+				ParseSizeList(CString(xml.GetAttrib(TGM_HEIGHT)), node.m_nRows, node.m_vHeight);
+				m_nSplitterCount++;
+			}
+			if (m_vNodes.size() == 0)
+				m_strGalaxy = CString(xml.GetAttrib(_T("galaxy")));
+			m_vNodes.push_back(node);
+			if ((m_vNodes.size() % LAYOUTTREE_CHECKPOINT) == 0 && nCurrentGeneration.load() != nGeneration)
+				return false;
+
+			if (xml.IntoElem())
+			{
+				if (xml.FindElem())
+				{
+					vParents.push_back(nParent);
+					nParent = (int)m_vNodes.size() - 1;
+					continue;
+				}
+				xml.OutOfElem();
+			}
+		}
+		// next sibling, or climb until one is found; the root xobj has no
+		// siblings of interest, only the first xobj under <nucleus> is the layout
+		while (true)
+		{
+			if (vParents.size() == 0)
+				return true;
+			if (xml.FindElem())
+				break;
+			xml.OutOfElem();
+			nParent = vParents.back();
+			vParents.pop_back();
+		}
+	}
+}
+
+size_t CLayoutTree::GetSize() const
+{
+	size_t nSize = (m_strCaption.GetLength() + m_strGalaxy.GetLength() + m_strError.GetLength()) * sizeof(TCHAR);
+	for (auto& node : m_vNodes)
+	{
+		nSize += sizeof(LayoutTreeNode) + (node.m_strTag.GetLength() + node.m_strName.GetLength() + node.m_strObjID.GetLength()) * sizeof(TCHAR);
+		nSize += (node.m_vWidth.size() + node.m_vHeight.size()) * sizeof(int);
+	}
+	return nSize;
+}
+
+void CLayoutTree::ParseSizeList(const CString& strList, int nCount, vector<int>& vSize)
+{
+	// same reading as CGridWnd::Create: comma separated, missing entries are 0
+	vSize.assign(nCount, 0);
+	LPCTSTR p = strList;
+	for (int i = 0; i < nCount && *p; i++)
+	{
+		vSize[i] = _ttoi(p);
+		while (*p && *p != _T(','))
+			p++;
+		if (*p == _T(','))
+			p++;
+	}
+}
+
+bool CLayoutTree::FindChild(CMarkup& xml, LPCTSTR lpszName)
+{
+	// CMarkup::FindElem compares names case-sensitively
+	xml.ResetMainPos();
+	while (xml.FindElem())
+	{
+		if (CString(xml.GetTagName()).CompareNoCase(lpszName) == 0)
+			return true;
+	}
+	return false;
+}
+
+bool CLayoutTree::ReadPageLayouts(const CString& strPageFile, const CString& strConfig, map<CString, CString>& mapXml)
+{
+	CMarkup xml;
+	if (xml.Load((LPCTSTR)strPageFile) == false || xml.FindElem() == false)
+		return false;
+	// the document element is named after the application, hubblepage is one of its children
+	xml.IntoElem();
+	if (FindChild(xml, _T("hubblepage")) == false)
+		return false;
+	xml.IntoElem();
+	if (FindChild(xml, strConfig) == false)
+		return false;
+	xml.IntoElem();
+	while (xml.FindElem())
+	{
+		CString strSuffix = _T("@") + CString(xml.GetTagName()) + _T("@") + strConfig;
+		xml.IntoElem();
+		while (xml.FindElem())
+		{
+			CString strKey = CString(xml.GetTagName());
+			CString strXml = CString(xml.GetSubDoc());
+			mapXml[strKey.MakeLower() + strSuffix] = strXml.Trim();
+		}
+		xml.OutOfElem();
+	}
+	return true;
+}
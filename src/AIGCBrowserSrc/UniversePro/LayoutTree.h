@@ -0,0 +1,85 @@
+/********************************************************************************
+ *           Web Runtime for Application - Version 1.0.0.202203120001           *
+ ********************************************************************************
+ * Copyright (C) 2002-2021 by Tangram Team.   All Rights Reserved.
+ * There are Three Key Features of Webruntime:
+ * 1. Built-in Modern Web Browser: Independent Browser Window and Browser Window
+ *    as sub windows of other windows are supported in the application process;
+ * 2. DOM Plus: DOMPlus is a natural extension of the standard DOM system.
+ *    It allows the application system to support a kind of generalized web pages,
+ *    which are composed of standard DOM elements and binary components supported
+ *    by the application system;
+ * 3. JavaScript for Application: Similar to VBA in MS office, JavaScript will
+ *    become a built-in programmable language in the application system, so that
+ *    the application system can be expanded and developed for the Internet based
+ *    on modern javscript/Web technology.
+ * Use of this source code is governed by a BSD-style license that
+ * can be found in the LICENSE file.
+ *
+ * CONTACT INFORMATION:
+ * mailto:tangramteam@outlook.com or mailto:sunhuizlz@yeah.net
+ * https://www.webruntime.com
+ *******************************************************************************/
+
+// LayoutTree.h : the COM-free part of preparing a nucleus layout
+//
+// CLayoutTree reads a layout with CMarkup: the xobj tree in document order
+// and the splitter row/column sizes, read the way CGridWnd does. It touches
+// no window and no COM object, so CLayoutPlan::Prepare runs it on the worker
+// pool ahead of the MSXML parse, and only a layout it finds an xobj tree in
+// is handed to MSXML at all. ReadPageLayouts reads the layouts stored in a
+// hubble page file the same way, for CNucleus::GetLayoutXml and for the
+// prewarming that runs ahead of it.
+
+#pragma once
+
+#include <atomic>
+#include "Markup.h"
+
+// converts a JSON layout into XML, returns an empty string on failure
+typedef CString (*LayoutJsonConverter)(const CString& strJson);
+
+struct LayoutTreeNode
+{
+	CString			m_strTag;
+	CString			m_strName;
+	CString			m_strObjID;
+	int				m_nParent;		// index into CLayoutTree::m_vNodes, -1 for the root xobj
+	int				m_nDepth;
+	int				m_nRows;
+	int				m_nCols;
+	vector<int>		m_vWidth;		// one entry per column, as CGridWnd reads the width attribute
+	vector<int>		m_vHeight;		// one entry per row
+};
+
+class CLayoutTree
+{
+public:
+	CLayoutTree();
+
+	bool										m_bSizable;
+	int											m_nSplitterCount;
+	CString										m_strCaption;
+	CString										m_strGalaxy;
+	CString										m_strError;
+	vector<LayoutTreeNode>						m_vNodes;		// xobj tree in document order
+
+	// Reads strXml, layout text or the name of a layout file. Returns false
+	// when nCurrentGeneration moves away from nGeneration before it finishes.
+	bool Build(const CString& strXml, long nGeneration, const std::atomic<long>& nCurrentGeneration);
+	bool IsValid() const { return m_vNodes.size() > 0; }
+	size_t GetSize() const;
+
+	// BOM, whitespace and JSON conversion of a layout source
+	static CString Normalize(const CString& strSourceXml, LayoutJsonConverter pConverter, CString& strError);
+	static void ParseSizeList(const CString& strList, int nCount, vector<int>& vSize);
+	// Reads every <root><hubblepage><strConfig><nucleus><key> layout of a page
+	// file into mapXml, keyed "key@nucleus@strConfig" like CNuclei::m_strMapKey.
+	// Element names match case-insensitively and the key is lowercased, the
+	// way Observe lowercases the key it looks up.
+	static bool ReadPageLayouts(const CString& strPageFile, const CString& strConfig, map<CString, CString>& mapXml);
+
+private:
+	static bool FindChild(CMarkup& xml, LPCTSTR lpszName);
+	bool BuildNodes(CMarkup& xml, long nGeneration, const std::atomic<long>& nCurrentGeneration);
+};
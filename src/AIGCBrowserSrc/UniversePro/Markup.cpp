@@ -469,34 +469,41 @@ MCD_STR CMarkup::UnescapeText( MCD_CSTR szText, int nTextLength /*=-1*/ )
 				if ( cChar == _T(';') )
 				{
 					int nUnicode = MCD_PSZTOL( &pSource[nNumericChar], NULL, nBase );
+					// "&#;", "&#0;" and "&#-1;" are left as is rather than
+					// decoded to a NUL that ends the text early
+					if ( nUnicode < 0 )
+						nUnicode = 0;
+					if ( nUnicode )
+					{
 #if defined(UNICODE)
-					MCD_BLDAPPEND1(strText,nUnicode);
+						MCD_BLDAPPEND1(strText,nUnicode);
 #elif defined(_MBCS)
-					MCD_CHAR szANSI[2];
-					int nMBLen = wctomb( szANSI, (wchar_t)nUnicode );
-					if ( nMBLen > 0 )
-					{
-						MCD_BLDAPPENDN(strText,szANSI,nMBLen);
-					}
-					else
-						nUnicode = 0;
+						MCD_CHAR szANSI[2];
+						int nMBLen = wctomb( szANSI, (wchar_t)nUnicode );
+						if ( nMBLen > 0 )
+						{
+							MCD_BLDAPPENDN(strText,szANSI,nMBLen);
+						}
+						else
+							nUnicode = 0;
 #else
-					if ( nUnicode < 0x80 )
-						MCD_BLDAPPEND1(strText,nUnicode);
-					else if ( nUnicode < 0x800 )
-					{
-						// Convert to 2-byte UTF-8
-						MCD_BLDAPPEND1(strText,((nUnicode&0x7c0)>>6)|0xc0);
-						MCD_BLDAPPEND1(strText,(nUnicode&0x3f)|0x80);
-					}
-					else
-					{
-						// Convert to 3-byte UTF-8
-						MCD_BLDAPPEND1(strText,((nUnicode&0xf000)>>12)|0xe0);
-						MCD_BLDAPPEND1(strText,((nUnicode&0xfc0)>>6)|0x80);
-						MCD_BLDAPPEND1(strText,(nUnicode&0x3f)|0x80);
-					}
+						if ( nUnicode < 0x80 )
+							MCD_BLDAPPEND1(strText,nUnicode);
+						else if ( nUnicode < 0x800 )
+						{
+							// Convert to 2-byte UTF-8
+							MCD_BLDAPPEND1(strText,((nUnicode&0x7c0)>>6)|0xc0);
+							MCD_BLDAPPEND1(strText,(nUnicode&0x3f)|0x80);
+						}
+						else
+						{
+							// Convert to 3-byte UTF-8
+							MCD_BLDAPPEND1(strText,((nUnicode&0xf000)>>12)|0xe0);
+							MCD_BLDAPPEND1(strText,((nUnicode&0xfc0)>>6)|0x80);
+							MCD_BLDAPPEND1(strText,(nUnicode&0x3f)|0x80);
+						}
 #endif
+					}
 					if ( nUnicode )
 					{
 						// Increment index past ampersand semi-colon
@@ -171,6 +171,7 @@
 
 class CMarkup  
 {
+	friend class CTangramXmlQuery;
 public:
 	// allow function args to accept string objects as constant string pointers
 	struct MCD_CSTR
@@ -1230,14 +1230,18 @@ STDMETHODIMP CNuclei::ObserveNuclei(BSTR bstrGalaxys, BSTR bstrKey, BSTR bstrXml
 	CString strGalaxys = OLE2T(bstrGalaxys);
 	CString strKey = OLE2T(bstrKey);
 	CString strXml = OLE2T(bstrXml);
+	// the nuclei prepare their layouts side by side on the worker pool; each
+	// one is committed here before this returns, as a single Observe would
+	vector<pair<CNucleus*, task<CLayoutPlanPtr>>> vPrepare;
 	if (strGalaxys == _T(""))
 	{
 		for (auto &it : m_mapGalaxy)
 		{
 			if (it.second != m_pBKGalaxy)
 			{
-				IXobj* pXobj = nullptr;
-				it.second->Observe(bstrKey, bstrXml, &pXobj);
+				CString _strKey = strKey;
+				CString _strXml = strXml;
+				vPrepare.push_back(make_pair(it.second, it.second->PrepareLayout(_strKey, _strXml)));
 			}
 		}
 	}
@@ -1249,11 +1253,17 @@ STDMETHODIMP CNuclei::ObserveNuclei(BSTR bstrGalaxys, BSTR bstrKey, BSTR bstrXml
 			CString strName = _T(",") + it.second->m_strNucleusName + _T(",");
 			if (strGalaxys.Find(strName) != -1)
 			{
-				IXobj* pXobj = nullptr;
-				it.second->Observe(bstrKey, bstrXml, &pXobj);
+				CString _strKey = strKey;
+				CString _strXml = strXml;
+				vPrepare.push_back(make_pair(it.second, it.second->PrepareLayout(_strKey, _strXml)));
 			}
 		}
 	}
+	for (auto& it : vPrepare)
+	{
+		IXobj* pXobj = nullptr;
+		it.first->ObserveLayout(strKey, strXml, it.second.get(), &pXobj);
+	}
 
 	return S_OK;
 }
@@ -23,6 +23,7 @@
 
 #include "stdafx.h"
 #include "PPDrawManager.h"
+#include "PPPixelOps.h"
 
 #pragma warning(push, 3)
 
@@ -40,6 +41,8 @@ static char THIS_FILE[]=__FILE__;
 #define CLR_TO_RGBQUAD(clr)     (RGB(GetBValue(clr), GetGValue(clr), GetRValue(clr)))
 #endif
 
+CPPGradientCache CPPDrawManager::m_GradientCache;
+
 //////////////////////////////////////////////////////////////////////
 // Construction/Destruction
 //////////////////////////////////////////////////////////////////////
@@ -161,13 +164,8 @@ void CPPDrawManager::AlphaBitBlt(HDC hDestDC, int nDestX, int nDestY, DWORD dwWi
 			::BitBlt (hTempDC, 0, 0, dwWidth, dwHeight, hDestDC, nDestX, nDestY, SRCCOPY);
 			::SelectObject (hTempDC, hOldTempBmp);
 
-			double src_darken = (double)percent / 100.0;
-			double dest_darken = 1.0 - src_darken;
-			
-			for (DWORD pixel = 0; pixel < dwWidth * dwHeight; pixel++, pSrcBits++, pDestBits++)
-			{
-				*pDestBits = PixelAlpha(*pSrcBits, src_darken, *pDestBits, dest_darken);
-			} //for
+			BYTE nAlpha = (BYTE)((percent <= 0) ? 0 : (percent * 255 + 50) / 100);
+			CPPPixelOps::Blend((uint32_t*)pDestBits, (const uint32_t*)pSrcBits, dwWidth * dwHeight, nAlpha);
 			
 			::SelectObject (hTempDC, hDestDib);
 			::BitBlt (hDestDC, nDestX, nDestY, dwWidth, dwHeight, hTempDC, 0, 0, SRCCOPY);
@@ -245,15 +243,9 @@ void CPPDrawManager::AlphaChannelBitBlt(HDC hDestDC, int nDestX, int nDestY, DWO
 			::BitBlt (hTempDC, 0, 0, dwWidth, dwHeight, hDestDC, nDestX, nDestY, SRCCOPY);
 			::SelectObject (hTempDC, hOldTempBmp);
 
-			double src_darken;
-			BYTE nAlpha;
-			
-			for (DWORD pixel = 0; pixel < dwWidth * dwHeight; pixel++, pSrcBits++, pDestBits++)
-			{
-				nAlpha = LOBYTE(*pSrcBits >> 24);
-				src_darken = (double)nAlpha / 255.0;
-				*pDestBits = PixelAlpha(*pSrcBits, src_darken, *pDestBits, 1.0 - src_darken);
-			} //for
+			//ENG: The source is a private copy, so it is premultiplied in place
+			CPPPixelOps::Premultiply((uint32_t*)pSrcBits, dwWidth * dwHeight);
+			CPPPixelOps::BlendOver((uint32_t*)pDestBits, (const uint32_t*)pSrcBits, dwWidth * dwHeight);
 			
 			::SelectObject (hTempDC, hDestDib);
 			::BitBlt (hDestDC, nDestX, nDestY, dwWidth, dwHeight, hTempDC, 0, 0, SRCCOPY);
@@ -317,31 +309,32 @@ HBITMAP CPPDrawManager::CreateImageEffect(HBITMAP hBitmap, DWORD dwWidth, DWORD
 	clrMask = CLR_TO_RGBQUAD(clrMask);
 	clrMono = CLR_TO_RGBQUAD(clrMono);
 
-	DWORD dwAlpha;
-	for (DWORD pixel = 0; pixel < dwWidth * dwHeight; pixel++, *pBits++)
+	uint32_t * pPixels = (uint32_t*)pBits;
+	size_t nPixels = dwWidth * dwHeight;
+	//ENG: The original alpha values are kept by every effect below
+	if (CPPPixelOps::HasAlpha(pPixels, nPixels))
+		m_bIsAlpha = true;
+	
+	size_t nStart = 0;
+	while (nStart < nPixels)
 	{
-		COLORREF color = (COLORREF)*pBits;
-		//ENG: Extract an original alpha value
-		dwAlpha = color & 0xFF000000;
-		if (dwAlpha != 0) 
-			m_bIsAlpha = true;
-		if (bUseMask && (color == clrMask))
+		//ENG: The run of pixels up to the next transparent one
+		size_t nEnd = bUseMask ? nStart + CPPPixelOps::FindColorKey(pPixels + nStart, nPixels - nStart, clrMask) : nPixels;
+		size_t nRun = nEnd - nStart;
+		//ENG: Color conversion
+		if (dwEffect & IMAGE_EFFECT_GRAYEN) CPPPixelOps::Grayscale(pPixels + nStart, nRun);
+		if (dwEffect & IMAGE_EFFECT_DARKEN) CPPPixelOps::Scale(pPixels + nStart, nRun, 192);
+		if (dwEffect & IMAGE_EFFECT_LIGHTEN) CPPPixelOps::Scale(pPixels + nStart, nRun, 320);
+		if (dwEffect & IMAGE_EFFECT_MONOCHROME) CPPPixelOps::Tint(pPixels + nStart, nRun, clrMono, 255);
+		if (nEnd < nPixels)
 		{
 			//This is transparent area
-			color = RGB(0, 0, 0);
-		}
-		else 
-		{
-			//ENG: Color conversion
-			if (dwEffect & IMAGE_EFFECT_GRAYEN) color = GrayMirrorColor(color);
-			if (dwEffect & IMAGE_EFFECT_DARKEN) color = DarkenColor(color, 0.75);
-			if (dwEffect & IMAGE_EFFECT_LIGHTEN) color = LightenColor(color, 0.25);
-			if (dwEffect & IMAGE_EFFECT_MONOCHROME) color = clrMono;
+			pPixels[nEnd] = 0;
+			nEnd++;
 		} //if
-		if (dwEffect & IMAGE_EFFECT_INVERT) color = InvertColor(color);
-		//ENG: Merges a color with an original alpha value
-		*pBits = (color | dwAlpha);
-	} //for
+		nStart = nEnd;
+	} //while
+	if (dwEffect & IMAGE_EFFECT_INVERT) CPPPixelOps::Invert(pPixels, nPixels);
 
 	::SelectObject(hSrcDC, hOldSrcBmp);
 	::SelectObject(hResDC, hOldResBmp);
@@ -497,6 +490,63 @@ void CPPDrawManager::FillGradient (HDC hDC, LPCRECT lpRect,
     int nShift = 6;
     int nSteps = 1 << nShift;
 
+	int nHeight = lpRect->bottom - lpRect->top;
+	int nWidth = lpRect->right - lpRect->left;
+	if ((nHeight <= 0) || (nWidth <= 0))
+		return;
+
+	//ENG: The gradient is cached as a strip of one pixel across its direction
+	int nLength = bHorz ? nWidth : nHeight;
+	CPPGradientCache::STRUCT_GRADIENTKEY key;
+	key.dwEffect = bHorz ? EFFECT_HGRADIENT : EFFECT_VGRADIENT;
+	key.clrBegin = colorStart;
+	key.clrMid = 0;
+	key.clrEnd = colorFinish;
+	key.granularity = 0;
+	key.coloring = 0;
+	key.cx = bHorz ? nLength : 1;
+	key.cy = bHorz ? 1 : nLength;
+	if (m_GradientCache.Draw(hDC, key, lpRect->left, lpRect->top, nWidth, nHeight))
+		return;
+
+	DWORD * pBits = NULL;
+	HBITMAP hStrip = CPPGradientCache::CreateBitmap(key.cx, key.cy, &pBits);
+	if (NULL == hStrip)
+	{
+		FillGradientBands(hDC, lpRect, colorStart, colorFinish, bHorz);
+		return;
+	} //if
+
+	for (int i = 0; i < nSteps; i++)
+    {
+        // do a little alpha blending
+        BYTE bR = (BYTE) ((GetRValue(colorStart) * (nSteps - i) +
+                   GetRValue(colorFinish) * i) >> nShift);
+        BYTE bG = (BYTE) ((GetGValue(colorStart) * (nSteps - i) +
+                   GetGValue(colorFinish) * i) >> nShift);
+        BYTE bB = (BYTE) ((GetBValue(colorStart) * (nSteps - i) +
+                   GetBValue(colorFinish) * i) >> nShift);
+
+		// the same bands FillGradientBands paints, as RGBQUAD pixels
+		DWORD dwColor = ((DWORD)bR << 16) | ((DWORD)bG << 8) | bB;
+		int nEnd = ((i + 1) * nLength) >> nShift;
+		for (int nPos = (i * nLength) >> nShift; nPos < nEnd; nPos++)
+			pBits[nPos] = dwColor;
+    } //for
+
+	CPPGradientCache::DrawBitmap(hDC, lpRect->left, lpRect->top, nWidth, nHeight, hStrip, key.cx, key.cy);
+	if (!m_GradientCache.Insert(key, hStrip))
+		::DeleteObject(hStrip);
+} //End FillGradient
+
+void CPPDrawManager::FillGradientBands (HDC hDC, LPCRECT lpRect, 
+								COLORREF colorStart, COLORREF colorFinish, 
+								BOOL bHorz/* = true*/)
+{
+    // this will make 2^6 = 64 fountain steps
+    int nShift = 6;
+    int nSteps = 1 << nShift;
+
 	RECT r2;
 	r2.top = lpRect->top;
 	r2.left = lpRect->left;
@@ -541,7 +591,7 @@ void CPPDrawManager::FillGradient (HDC hDC, LPCRECT lpRect,
 			hBrush = NULL;
 		} //if
     } //for
-} //End FillGradient
+} //End FillGradientBands
 
 #ifdef USE_SHADE
 void CPPDrawManager::SetShade(LPCRECT lpRect, UINT shadeID /* = 0 */, BYTE granularity /* = 8 */, 
@@ -793,12 +843,46 @@ void CPPDrawManager::FillEffect(HDC hDC, DWORD dwEffect, LPCRECT lpRect, COLORRE
 	case EFFECT_SOFTBUMP:
 	case EFFECT_HARDBUMP:
 	case EFFECT_METAL:
-		rect.left = 0;
-		rect.top = 0;
-		rect.right = nWidth;
-		rect.bottom = nHeight;
-		SetShade(&rect, dwEffect, granularity, coloring, clrBegin, clrMid, clrEnd);
-		m_dNormal.Draw(hDC, lpRect->left, lpRect->top);
+		{
+			//ENG: The shade is cached with its noise, so repaints look the same
+			CPPGradientCache::STRUCT_GRADIENTKEY key;
+			key.dwEffect = dwEffect;
+			key.clrBegin = clrBegin;
+			key.clrMid = clrMid;
+			key.clrEnd = clrEnd;
+			key.granularity = granularity;
+			key.coloring = coloring;
+			key.cx = nWidth;
+			key.cy = nHeight;
+			if (m_GradientCache.Draw(hDC, key, lpRect->left, lpRect->top, nWidth, nHeight))
+				break;
+
+			rect.left = 0;
+			rect.top = 0;
+			rect.right = nWidth;
+			rect.bottom = nHeight;
+			SetShade(&rect, dwEffect, granularity, coloring, clrBegin, clrMid, clrEnd);
+
+			DWORD * pBits = NULL;
+			HBITMAP hShade = CPPGradientCache::CreateBitmap(nWidth, nHeight, &pBits);
+			HDC hMemDC = (NULL != hShade) ? ::CreateCompatibleDC(hDC) : NULL;
+			if (NULL != hMemDC)
+			{
+				HBITMAP hOldBmp = (HBITMAP)::SelectObject(hMemDC, hShade);
+				m_dNormal.Draw(hMemDC, 0, 0);
+				::BitBlt(hDC, lpRect->left, lpRect->top, nWidth, nHeight, hMemDC, 0, 0, SRCCOPY);
+				::SelectObject(hMemDC, hOldBmp);
+				::DeleteDC(hMemDC);
+				if (!m_GradientCache.Insert(key, hShade))
+					::DeleteObject(hShade);
+			}
+			else
+			{
+				if (NULL != hShade)
+					::DeleteObject(hShade);
+				m_dNormal.Draw(hDC, lpRect->left, lpRect->top);
+			} //if
+		}
 		break; 
 #endif
 	} //switch
@@ -1084,8 +1168,7 @@ void CPPDrawManager::DrawShadow(HDC hDestDC, int nDestX, int nDestY, DWORD dwWid
 			}
 			else
 			{
-				for(DWORD pixel = 0; pixel < dwWidth * dwHeight; pixel++, pSrcBits++, pDestBits++)
-					*pDestBits = DarkenColor(*pDestBits, (double)GetRValue(*pSrcBits) / 255.0);
+				CPPPixelOps::DarkenByMask((uint32_t*)pDestBits, (const uint32_t*)pSrcBits, dwWidth * dwHeight);
 			} //if
 				
 			
@@ -27,6 +27,8 @@
 
 #define USE_SHADE
 
+#include "PPGradientCache.h"
+
 #ifdef USE_SHADE
 #include "CeXDib.h"
 #endif
@@ -161,6 +163,8 @@ public:
 
 	void FillEffect(HDC hDC, DWORD dwEffect, LPCRECT lpRect, COLORREF clrBegin, COLORREF clrMid = 0, COLORREF clrEnd = 0,  BYTE granularity = 0, BYTE coloring = 0);
 	void FillGradient(HDC hDC, LPCRECT lpRect, COLORREF colorStart, COLORREF colorFinish, BOOL bHorz = true);
+	//ENG: Gradients and shades drawn by every draw manager of the process
+	static CPPGradientCache & GetGradientCache() {return m_GradientCache;};
 	void MultipleCopy(HDC hDestDC, int nDestX, int nDestY, DWORD dwDestWidth, DWORD dwDestHeight, HDC hSrcDC, int nSrcX, int nSrcY, DWORD dwSrcWidth, DWORD dwSrcHeight);
 #ifdef USE_SHADE
 	void SetShade(LPCRECT lpRect, UINT shadeID = 0, BYTE granularity = 8, BYTE coloring = 0, COLORREF hicr = 0, COLORREF midcr = 0, COLORREF locr = 0);
@@ -172,6 +176,10 @@ public:
 
 protected:
 	BOOL m_bIsAlpha;
+	static CPPGradientCache m_GradientCache;
+
+	//ENG: Paints a gradient as solid bands, when no strip can be cached
+	void FillGradientBands(HDC hDC, LPCRECT lpRect, COLORREF colorStart, COLORREF colorFinish, BOOL bHorz);
 };
 
 #endif //_PPDRAWMANAGER_H_
@@ -0,0 +1,190 @@
+/********************************************************************************
+ *           Web Runtime for Application - Version 1.0.0.202203120001           *
+ ********************************************************************************
+ * Copyright (C) 2002-2021 by Tangram Team.   All Rights Reserved.
+ * There are Three Key Features of Webruntime:
+ * 1. Built-in Modern Web Browser: Independent Browser Window and Browser Window
+ *    as sub windows of other windows are supported in the application process;
+ * 2. DOM Plus: DOMPlus is a natural extension of the standard DOM system.
+ *    It allows the application system to support a kind of generalized web pages,
+ *    which are composed of standard DOM elements and binary components supported
+ *    by the application system;
+ * 3. JavaScript for Application: Similar to VBA in MS office, JavaScript will
+ *    become a built-in programmable language in the application system, so that
+ *    the application system can be expanded and developed for the Internet based
+ *    on modern javscript/Web technology.
+ * Use of this source code is governed by a BSD-style license that
+ * can be found in the LICENSE file.
+ *
+ * CONTACT INFORMATION:
+ * mailto:tangramteam@outlook.com or mailto:sunhuizlz@yeah.net
+ * https://www.webruntime.com
+ *******************************************************************************/
+
+// PPGradientCache.cpp : cached gradient strips and shade bitmaps
+
+#include "stdafx.h"
+#include "PPGradientCache.h"
+
+bool CPPGradientCache::_STRUCT_GRADIENTKEY::operator < (const _STRUCT_GRADIENTKEY & key) const
+{
+	if (dwEffect != key.dwEffect) return dwEffect < key.dwEffect;
+	if (clrBegin != key.clrBegin) return clrBegin < key.clrBegin;
+	if (clrMid != key.clrMid) return clrMid < key.clrMid;
+	if (clrEnd != key.clrEnd) return clrEnd < key.clrEnd;
+	if (granularity != key.granularity) return granularity < key.granularity;
+	if (coloring != key.coloring) return coloring < key.coloring;
+	if (cx != key.cx) return cx < key.cx;
+	return cy < key.cy;
+} //End operator <
+
+CPPGradientCache::CPPGradientCache(size_t nMaxBytes /* = 4 * 1024 * 1024 */)
+{
+	m_nMaxBytes = nMaxBytes;
+	m_nBytes = 0;
+	m_nHits = 0;
+	m_nMisses = 0;
+	::InitializeCriticalSection(&m_cs);
+} //End CPPGradientCache
+
+CPPGradientCache::~CPPGradientCache()
+{
+	Clear();
+	::DeleteCriticalSection(&m_cs);
+} //End ~CPPGradientCache
+
+BOOL CPPGradientCache::Draw(HDC hDC, const STRUCT_GRADIENTKEY & key, int x, int y, int cx, int cy)
+{
+	BOOL bFound = FALSE;
+
+	::EnterCriticalSection(&m_cs);
+	mapEntries::iterator iter = m_mapEntries.find(key);
+	if (iter != m_mapEntries.end())
+	{
+		m_nHits++;
+		//ENG: Moves the entry to the front of the LRU list
+		m_listEntries.splice(m_listEntries.begin(), m_listEntries, iter->second);
+		DrawBitmap(hDC, x, y, cx, cy, iter->second->hBitmap, key.cx, key.cy);
+		bFound = TRUE;
+	}
+	else
+	{
+		m_nMisses++;
+	} //if
+	::LeaveCriticalSection(&m_cs);
+
+	return bFound;
+} //End Draw
+
+BOOL CPPGradientCache::Insert(const STRUCT_GRADIENTKEY & key, HBITMAP hBitmap)
+{
+	size_t nBytes = (size_t)key.cx * key.cy * sizeof(DWORD);
+	if ((NULL == hBitmap) || (nBytes > m_nMaxBytes))
+		return FALSE;
+
+	::EnterCriticalSection(&m_cs);
+	mapEntries::iterator iter = m_mapEntries.find(key);
+	if (iter != m_mapEntries.end())
+	{
+		//ENG: Another thread rendered the same bitmap meanwhile
+		m_nBytes -= iter->second->nBytes;
+		::DeleteObject(iter->second->hBitmap);
+		m_listEntries.erase(iter->second);
+		m_mapEntries.erase(iter);
+	} //if
+	Trim(m_nMaxBytes - nBytes);
+
+	STRUCT_GRADIENTENTRY entry;
+	entry.key = key;
+	entry.hBitmap = hBitmap;
+	entry.nBytes = nBytes;
+	m_listEntries.push_front(entry);
+	m_mapEntries[key] = m_listEntries.begin();
+	m_nBytes += nBytes;
+	::LeaveCriticalSection(&m_cs);
+
+	return TRUE;
+} //End Insert
+
+void CPPGradientCache::Clear()
+{
+	::EnterCriticalSection(&m_cs);
+	Trim(0);
+	::LeaveCriticalSection(&m_cs);
+} //End Clear
+
+void CPPGradientCache::SetMaxBytes(size_t nMaxBytes)
+{
+	::EnterCriticalSection(&m_cs);
+	m_nMaxBytes = nMaxBytes;
+	Trim(m_nMaxBytes);
+	::LeaveCriticalSection(&m_cs);
+} //End SetMaxBytes
+
+int CPPGradientCache::GetHitRate() const
+{
+	size_t nTotal = m_nHits + m_nMisses;
+	if (!nTotal)
+		return 0;
+	return (int)((m_nHits * 100 + nTotal / 2) / nTotal);
+} //End GetHitRate
+
+void CPPGradientCache::Trim(size_t nMaxBytes)
+{
+	//ENG: Drops the least recently used entries until nMaxBytes are left
+	while (!m_listEntries.empty() && (m_nBytes > nMaxBytes))
+	{
+		STRUCT_GRADIENTENTRY & entry = m_listEntries.back();
+		m_nBytes -= entry.nBytes;
+		::DeleteObject(entry.hBitmap);
+		m_mapEntries.erase(entry.key);
+		m_listEntries.pop_back();
+	} //while
+} //End Trim
+
+HBITMAP CPPGradientCache::CreateBitmap(int cx, int cy, DWORD ** ppBits)
+{
+	*ppBits = NULL;
+	if ((cx <= 0) || (cy <= 0))
+		return NULL;
+
+	BITMAPINFO bmi;
+	ZeroMemory(&bmi, sizeof(bmi));
+	bmi.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+	bmi.bmiHeader.biWidth = cx;
+	bmi.bmiHeader.biHeight = -cy;
+	bmi.bmiHeader.biPlanes = 1;
+	bmi.bmiHeader.biBitCount = 32;
+	bmi.bmiHeader.biCompression = BI_RGB;
+
+	HBITMAP hBitmap = ::CreateDIBSection(NULL, &bmi, DIB_RGB_COLORS, (void **)ppBits, NULL, 0);
+	if ((NULL != hBitmap) && (NULL == *ppBits))
+	{
+		::DeleteObject(hBitmap);
+		hBitmap = NULL;
+	} //if
+	return hBitmap;
+} //End CreateBitmap
+
+void CPPGradientCache::DrawBitmap(HDC hDC, int x, int y, int cx, int cy, HBITMAP hBitmap, int nSrcWidth, int nSrcHeight)
+{
+	HDC hMemDC = ::CreateCompatibleDC(hDC);
+	if (NULL == hMemDC)
+		return;
+
+	HBITMAP hOldBmp = (HBITMAP)::SelectObject(hMemDC, hBitmap);
+	if ((cx == nSrcWidth) && (cy == nSrcHeight))
+	{
+		::BitBlt(hDC, x, y, cx, cy, hMemDC, 0, 0, SRCCOPY);
+	}
+	else
+	{
+		//ENG: A strip is only stretched across its direction, which
+		//     repeats its pixels
+		int nOldMode = ::SetStretchBltMode(hDC, COLORONCOLOR);
+		::StretchBlt(hDC, x, y, cx, cy, hMemDC, 0, 0, nSrcWidth, nSrcHeight, SRCCOPY);
+		::SetStretchBltMode(hDC, nOldMode);
+	} //if
+	::SelectObject(hMemDC, hOldBmp);
+	::DeleteDC(hMemDC);
+} //End DrawBitmap
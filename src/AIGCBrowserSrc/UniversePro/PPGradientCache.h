@@ -0,0 +1,102 @@
+/********************************************************************************
+ *           Web Runtime for Application - Version 1.0.0.202203120001           *
+ ********************************************************************************
+ * Copyright (C) 2002-2021 by Tangram Team.   All Rights Reserved.
+ * There are Three Key Features of Webruntime:
+ * 1. Built-in Modern Web Browser: Independent Browser Window and Browser Window
+ *    as sub windows of other windows are supported in the application process;
+ * 2. DOM Plus: DOMPlus is a natural extension of the standard DOM system.
+ *    It allows the application system to support a kind of generalized web pages,
+ *    which are composed of standard DOM elements and binary components supported
+ *    by the application system;
+ * 3. JavaScript for Application: Similar to VBA in MS office, JavaScript will
+ *    become a built-in programmable language in the application system, so that
+ *    the application system can be expanded and developed for the Internet based
+ *    on modern javscript/Web technology.
+ * Use of this source code is governed by a BSD-style license that
+ * can be found in the LICENSE file.
+ *
+ * CONTACT INFORMATION:
+ * mailto:tangramteam@outlook.com or mailto:sunhuizlz@yeah.net
+ * https://www.webruntime.com
+ *******************************************************************************/
+
+// PPGradientCache.h : cached gradient strips and shade bitmaps
+//
+// CPPDrawManager::FillGradient used to paint 64 solid bands per call and
+// FillEffect rebuilt a shade bitmap pixel by pixel, on every repaint of
+// every tooltip, button and table cell that uses them. The cache keeps what
+// they render as 32-bit DIB sections, keyed by effect, colors and size: a
+// gradient is kept as a strip one pixel thick along its direction and
+// stretched across the rectangle, a shade as the whole bitmap. Entries are
+// dropped least recently used first once the cache is over its byte limit.
+// One cache is shared by all draw managers of the process.
+
+#pragma once
+
+#pragma warning(push, 3)
+#include <list>
+#include <map>
+#pragma warning(pop)
+
+class CPPGradientCache
+{
+public:
+	CPPGradientCache(size_t nMaxBytes = 4 * 1024 * 1024);
+	virtual ~CPPGradientCache();
+
+	typedef struct _STRUCT_GRADIENTKEY
+	{
+		DWORD dwEffect;			// CPPDrawManager::EFFECT_xxx
+		COLORREF clrBegin;
+		COLORREF clrMid;
+		COLORREF clrEnd;
+		BYTE granularity;
+		BYTE coloring;
+		int cx;					// Size of the cached bitmap
+		int cy;
+
+		bool operator < (const _STRUCT_GRADIENTKEY & key) const;
+	} STRUCT_GRADIENTKEY;
+
+	//ENG: Stretches the cached bitmap of key over the rectangle; FALSE if
+	//     there is none
+	BOOL Draw(HDC hDC, const STRUCT_GRADIENTKEY & key, int x, int y, int cx, int cy);
+	//ENG: Takes hBitmap, of the size in key, into the cache. FALSE if it
+	//     is too large to cache, it then still belongs to the caller
+	BOOL Insert(const STRUCT_GRADIENTKEY & key, HBITMAP hBitmap);
+	void Clear();
+
+	void SetMaxBytes(size_t nMaxBytes);
+	size_t GetMaxBytes() const {return m_nMaxBytes;};
+	size_t GetBytes() const {return m_nBytes;};
+	size_t GetCount() const {return m_mapEntries.size();};
+	size_t GetHits() const {return m_nHits;};
+	size_t GetMisses() const {return m_nMisses;};
+	//ENG: Percent of Draw calls that found their bitmap
+	int GetHitRate() const;
+
+	//ENG: A top-down 32-bit DIB section, its pixels are returned in ppBits
+	static HBITMAP CreateBitmap(int cx, int cy, DWORD ** ppBits);
+	static void DrawBitmap(HDC hDC, int x, int y, int cx, int cy, HBITMAP hBitmap, int nSrcWidth, int nSrcHeight);
+
+protected:
+	typedef struct _STRUCT_GRADIENTENTRY
+	{
+		STRUCT_GRADIENTKEY key;
+		HBITMAP hBitmap;
+		size_t nBytes;
+	} STRUCT_GRADIENTENTRY;
+	typedef std::list<STRUCT_GRADIENTENTRY> listEntries;	// Most recently used first
+	typedef std::map<STRUCT_GRADIENTKEY, listEntries::iterator> mapEntries;
+
+	listEntries m_listEntries;
+	mapEntries m_mapEntries;
+	size_t m_nMaxBytes;
+	size_t m_nBytes;
+	size_t m_nHits;
+	size_t m_nMisses;
+	CRITICAL_SECTION m_cs;
+
+	void Trim(size_t nMaxBytes);
+};
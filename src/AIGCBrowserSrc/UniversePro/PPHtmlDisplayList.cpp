@@ -0,0 +1,191 @@
+/********************************************************************************
+ *           Web Runtime for Application - Version 1.0.0.202203120001           *
+ ********************************************************************************
+ * Copyright (C) 2002-2021 by Tangram Team.   All Rights Reserved.
+ * There are Three Key Features of Webruntime:
+ * 1. Built-in Modern Web Browser: Independent Browser Window and Browser Window
+ *    as sub windows of other windows are supported in the application process;
+ * 2. DOM Plus: DOMPlus is a natural extension of the standard DOM system.
+ *    It allows the application system to support a kind of generalized web pages,
+ *    which are composed of standard DOM elements and binary components supported
+ *    by the application system;
+ * 3. JavaScript for Application: Similar to VBA in MS office, JavaScript will
+ *    become a built-in programmable language in the application system, so that
+ *    the application system can be expanded and developed for the Internet based
+ *    on modern javscript/Web technology.
+ * Use of this source code is governed by a BSD-style license that
+ * can be found in the LICENSE file.
+ *
+ * CONTACT INFORMATION:
+ * mailto:tangramteam@outlook.com or mailto:sunhuizlz@yeah.net
+ * https://www.webruntime.com
+ *******************************************************************************/
+
+// PPHtmlDisplayList.cpp : tokenized html segments for CPPHtmlDrawer
+
+#include "stdafx.h"
+#include "PPHtmlDisplayList.h"
+
+#define FNV_OFFSET	0xCBF29CE484222325ULL
+#define FNV_PRIME	0x00000100000001B3ULL
+
+CPPHtmlDisplayList::CPPHtmlDisplayList(size_t nMaxSegments)
+{
+	m_nMaxSegments = nMaxSegments;
+	m_nHits = 0;
+	m_nMisses = 0;
+}
+
+uint64_t CPPHtmlDisplayList::Hash(const CPPString & sHtml)
+{
+	const uint8_t * p = (const uint8_t *)(LPCTSTR)sHtml;
+	size_t nSize = sHtml.GetLength() * sizeof(TCHAR);
+	uint64_t nHash = FNV_OFFSET;
+	for (size_t i = 0; i < nSize; i++)
+	{
+		nHash ^= p[i];
+		nHash *= FNV_PRIME;
+	} //for
+	return nHash;
+} //End Hash
+
+CPPHtmlDisplayList::ITEMSPTR CPPHtmlDisplayList::Find(const CPPString & sHtml)
+{
+	mapSegments::iterator iter = m_mapSegments.find(Hash(sHtml));
+	//ENG: A hash collision is a miss, the segment is replaced on Insert
+	if ((iter == m_mapSegments.end()) || (iter->second->sHtml != sHtml))
+	{
+		m_nMisses++;
+		return ITEMSPTR();
+	} //if
+	m_nHits++;
+	m_listSegments.splice(m_listSegments.begin(), m_listSegments, iter->second);
+	return iter->second->pItems;
+} //End of Find
+
+CPPHtmlDisplayList::ITEMSPTR CPPHtmlDisplayList::Insert(const CPPString & sHtml, vecItems & items)
+{
+	std::shared_ptr<vecItems> pItems = std::make_shared<vecItems>();
+	pItems->swap(items);
+	if (!m_nMaxSegments)
+		return pItems;
+
+	STRUCT_SEGMENT segment;
+	segment.nHash = Hash(sHtml);
+	segment.sHtml = sHtml;
+	segment.pItems = pItems;
+
+	mapSegments::iterator iter = m_mapSegments.find(segment.nHash);
+	if (iter != m_mapSegments.end())
+		m_listSegments.erase(iter->second);
+	m_listSegments.push_front(segment);
+	m_mapSegments[segment.nHash] = m_listSegments.begin();
+	Trim();
+	return pItems;
+} //End of Insert
+
+void CPPHtmlDisplayList::Clear()
+{
+	m_mapSegments.clear();
+	m_listSegments.clear();
+} //End of Clear
+
+void CPPHtmlDisplayList::SetMaxSegments(size_t nMaxSegments)
+{
+	m_nMaxSegments = nMaxSegments;
+	Trim();
+} //End of SetMaxSegments
+
+void CPPHtmlDisplayList::Trim()
+{
+	//ENG: Drops the least recently used segments
+	while (m_listSegments.size() > m_nMaxSegments)
+	{
+		m_mapSegments.erase(m_listSegments.back().nHash);
+		m_listSegments.pop_back();
+	} //while
+} //End of Trim
+
+void CPPHtmlDisplayList::Parse(const CPPString & sHtml, vecItems & items)
+{
+	items.clear();
+
+	STRUCT_DISPLAYITEM item;
+	item.dwTag = 0;
+	item.bCloseTag = false;
+
+	int i = 0;
+	while (i < sHtml.GetLength())
+	{
+		item.sText = SearchNextTag(sHtml, item.sTag, i);
+		item.sProperties = SplitTag(item.sTag);
+		items.push_back(item);
+	} //while
+} //End of Parse
+
+CPPString CPPHtmlDisplayList::SearchNextTag(const CPPString & str, CPPString & strTag, int & nIndex)
+{
+	int nBegin;
+	CPPString sText = _T("");
+	strTag.Empty();
+
+	while (nIndex < str.GetLength())
+	{
+		nBegin = nIndex;
+		//Searching a chars of the begin tag
+		nIndex = str.Find(_T("<"), nIndex);
+		if (nIndex < 0)
+			nIndex = str.GetLength(); //A tag wasn't found
+		sText += str.Mid(nBegin, nIndex - nBegin);
+		if (nIndex < str.GetLength())
+		{
+			//May be it is a begin of the tag?
+			if ((nIndex < (str.GetLength() - 1)) && (_T('<') != str.GetAt(nIndex + 1)))
+			{
+				//Yes of cause!!!
+				strTag = GetTagBody(str, nIndex);
+				return sText;
+			}
+			//No, it is a char '<'
+			sText += _T("<");
+			nIndex += 2;
+			break;
+		} //if
+	} //while
+	return sText;
+} //End SearchNextTag
+
+CPPString CPPHtmlDisplayList::GetTagBody(const CPPString & str, int & nIndex)
+{
+	CPPString sTagName = _T("");
+	//ENG: Search the tag's end 
+	int nEndOfTag = str.Find(_T('>'), nIndex);
+	//ENG: The tag's end was found. Passes a tag's begin char ('<')
+	nIndex++;
+	if (nEndOfTag > nIndex)
+	{
+		//ENG: Gets a full body of tag
+		sTagName = str.Mid(nIndex, nEndOfTag - nIndex);
+		//ENG: Jump to next char after the tag
+		nIndex = nEndOfTag + 1;
+	} //if
+	return sTagName;
+} //End of GetTagBody
+
+CPPString CPPHtmlDisplayList::SplitTag(CPPString & sTag)
+{
+	CPPString sParam(_T(""));
+	int nIndex;
+	for (nIndex = 0; nIndex < sTag.GetLength(); nIndex++)
+	{
+		if ((_T(' ') == sTag.GetAt(nIndex)) || (_T('=') == sTag.GetAt(nIndex)))
+		{
+			//ENG: The separator was found. Splits a tag's body to his name and his parameteres 
+			sParam = sTag.Mid(nIndex);
+			sTag = sTag.Left(nIndex);
+			sParam.TrimLeft(_T(' '));
+			break;
+		} //if
+	} //for
+	return sParam;
+} //End of SplitTag
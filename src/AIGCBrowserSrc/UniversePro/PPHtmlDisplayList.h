@@ -0,0 +1,111 @@
+/********************************************************************************
+ *           Web Runtime for Application - Version 1.0.0.202203120001           *
+ ********************************************************************************
+ * Copyright (C) 2002-2021 by Tangram Team.   All Rights Reserved.
+ * There are Three Key Features of Webruntime:
+ * 1. Built-in Modern Web Browser: Independent Browser Window and Browser Window
+ *    as sub windows of other windows are supported in the application process;
+ * 2. DOM Plus: DOMPlus is a natural extension of the standard DOM system.
+ *    It allows the application system to support a kind of generalized web pages,
+ *    which are composed of standard DOM elements and binary components supported
+ *    by the application system;
+ * 3. JavaScript for Application: Similar to VBA in MS office, JavaScript will
+ *    become a built-in programmable language in the application system, so that
+ *    the application system can be expanded and developed for the Internet based
+ *    on modern javscript/Web technology.
+ * Use of this source code is governed by a BSD-style license that
+ * can be found in the LICENSE file.
+ *
+ * CONTACT INFORMATION:
+ * mailto:tangramteam@outlook.com or mailto:sunhuizlz@yeah.net
+ * https://www.webruntime.com
+ *******************************************************************************/
+
+// PPHtmlDisplayList.h : tokenized html segments for CPPHtmlDrawer
+//
+// CPPHtmlDrawer walks every html segment twice per output (first pass and
+// draw pass) and again for every repaint, each time rescanning the text with
+// SearchNextTag/SplitTag and looking the tag up in m_mapTags. The display
+// list keeps the result of that scan per segment: one item per scanner step
+// with the text before the tag, the split tag and its resolved tag id, so the
+// drawer only replays the items. The segments are kept by a hash of their
+// text, the least recently used one is dropped when the list is full, and the
+// items stay valid for whoever holds them after their segment was dropped.
+
+#pragma once
+
+#pragma warning(push, 3)
+#include <stdint.h>
+#include <vector>
+#include <list>
+#include <map>
+#include <memory>
+#pragma warning(pop)
+
+#ifndef CPPString
+#ifdef _MFC_VER
+	#define CPPString	CString //MFC program
+#else
+	#include "StdString.h"
+	#ifdef _UNICODE
+	#define CPPString	CStdStringW	//non-MFC program UNICODE
+	#else
+	#define CPPString	CStdStringA	//non-MFC program ANSI
+	#endif
+#endif
+#endif
+
+class CPPHtmlDisplayList
+{
+public:
+	CPPHtmlDisplayList(size_t nMaxSegments = 256);
+
+	typedef struct _STRUCT_DISPLAYITEM
+	{
+		CPPString sText;		// The text before the tag
+		CPPString sTag;			// The tag's name (with '/' for the close tag)
+		CPPString sProperties;	// The tag's properties
+		DWORD dwTag;			// Resolved tag id, TAG_NONE if unknown
+		CPPString strFullName;	// The custom name of the tag
+		BOOL bCloseTag;			// true if tag have symbol '/'
+	} STRUCT_DISPLAYITEM;
+	typedef std::vector<STRUCT_DISPLAYITEM> vecItems;
+	typedef std::shared_ptr<const vecItems> ITEMSPTR;
+
+	//ENG: The items of the segment, NULL if it wasn't inserted or was dropped
+	ITEMSPTR Find(const CPPString & sHtml);
+	//ENG: Takes the items over (items is left empty) and keeps them for sHtml
+	ITEMSPTR Insert(const CPPString & sHtml, vecItems & items);
+	void Clear();
+
+	void SetMaxSegments(size_t nMaxSegments);
+	size_t GetMaxSegments() const {return m_nMaxSegments;};
+	size_t GetCount() const {return m_listSegments.size();};
+	size_t GetHits() const {return m_nHits;};
+	size_t GetMisses() const {return m_nMisses;};
+
+	//ENG: Scans a segment exactly the way SearchNextTag and SplitTag do
+	static void Parse(const CPPString & sHtml, vecItems & items);
+	static CPPString SearchNextTag(const CPPString & str, CPPString & strTag, int & nIndex);
+	static CPPString GetTagBody(const CPPString & str, int & nIndex);
+	static CPPString SplitTag(CPPString & sTag);
+
+protected:
+	typedef struct _STRUCT_SEGMENT
+	{
+		uint64_t nHash;
+		CPPString sHtml;
+		ITEMSPTR pItems;
+	} STRUCT_SEGMENT;
+	typedef std::list<STRUCT_SEGMENT> listSegments;		// Most recently used first
+	typedef std::map<uint64_t, listSegments::iterator> mapSegments;
+
+	listSegments m_listSegments;
+	mapSegments m_mapSegments;
+	size_t m_nMaxSegments;
+	size_t m_nHits;
+	size_t m_nMisses;
+
+	void Trim();
+	static uint64_t Hash(const CPPString & sHtml);
+};
@@ -25,6 +25,7 @@
 #include "stdafx.h"
 #pragma warning(push, 3)
 #include "PPHtmlDrawer.h"
+#include "PPSurface.h"
 #include "atlconv.h"    // for Unicode conversion - requires #include <afxdisp.h> // MFC OLE automation classes
 
 #include <shellapi.h>
@@ -56,16 +57,25 @@ enum {
 */
 
 
+CPPTextMetrics CPPHtmlDrawer::m_TextMetrics;
+
 /////////////////////////////////////////////////////////////////////////////
 // CPPHtmlDrawer
 
 CPPHtmlDrawer::CPPHtmlDrawer()
 {
 	m_nNumPass = MODE_FIRSTPASS;
+	m_dwStyleVersion = 0;
+	m_bPrepared = false;
+	m_nPreparedWidth = 0;
+	m_nPreparedDpi = 0;
+	m_dwPreparedVersion = 0;
+	m_szPrepared.cx = m_szPrepared.cy = 0;
 
 	m_hInstDll = NULL;
 	m_bFreeInstDll = false;
 	m_hDC = NULL;
+	m_pTextMeasurer = NULL;
 	m_hImageList = NULL;
 	
 	m_csCallbackRepaint.hWnd = NULL;
@@ -115,6 +125,7 @@ CPPHtmlDrawer::~CPPHtmlDrawer()
 void CPPHtmlDrawer::EnableOutput(BOOL bEnable /* = true */)
 {
 	m_bIsEnable = bEnable;
+	m_dwStyleVersion++;
 } //End of EnableOutput
 
 void CPPHtmlDrawer::SetDisabledColor(COLORREF color)
@@ -199,6 +210,23 @@ HBITMAP CPPHtmlDrawer::GetBitmapFromFile(LPCTSTR lpszPath) const
 	HBITMAP hBitmap = (HBITMAP)::LoadImage(NULL, lpszPath, IMAGE_BITMAP,
 		0, 0, LR_LOADFROMFILE | LR_CREATEDIBSECTION | LR_DEFAULTSIZE);
 
+	//ENG: LoadImage only reads BMP, a PNG <img src> is decoded by CPPSurface
+	if (NULL == hBitmap)
+	{
+		CPPSurface surface;
+		if (surface.LoadFile(lpszPath))
+		{
+			//ENG: The draw manager premultiplies when it blends, it wants straight alpha
+			for (int y = 0; y < surface.GetHeight(); y++)
+			{
+				uint32_t * pRow = surface.GetRow(y);
+				for (int x = 0; x < surface.GetWidth(); x++)
+					pRow[x] = CPPSurface::Unpremultiply(pRow[x]);
+			} //for
+			hBitmap = surface.CreateDIBSection();
+		} //if
+	} //if
+
 	return hBitmap;
 }
 
@@ -389,6 +417,7 @@ void CPPHtmlDrawer::AddSpecChar(LPCTSTR lpszAlias, LPCTSTR lpszValue)
 		iter->second = lpszValue;		//Modifies
 	else
 		m_mapSpecChars.insert(std::make_pair(lpszAlias, lpszValue)); //Add new
+	m_dwStyleVersion++;
 } //End of AddSpecialChar
 
 void CPPHtmlDrawer::ReplaceSpecChars()
@@ -472,6 +501,11 @@ void CPPHtmlDrawer::AddTagToList(LPCTSTR lpszName, DWORD dwTagIndex, LPCTSTR lps
 	tp.dwTagIndex = dwTagIndex;
 	tp.strTagName = lpszFullName;
 
+	//ENG: The tokenized segments hold the resolved tag ids
+	m_DisplayList.Clear();
+	m_hashTags.Invalidate();
+	m_dwStyleVersion++;
+
 	iterMapTags iterMap = m_mapTags.find(lpszName);
 	
 	if (iterMap != m_mapTags.end())
@@ -488,11 +522,11 @@ DWORD CPPHtmlDrawer::GetTagFromList(CPPString sTagName, CPPString & strFullName,
 	if (bCloseTag)
 		sTagName = sTagName.Mid(1);
 
-	iterMapTags iterMap = m_mapTags.find(sTagName);
+	iterMapTags iterMap = m_hashTags.Find(m_mapTags, (LPCTSTR)sTagName, sTagName.GetLength());
 	
 	if (iterMap != m_mapTags.end())
 	{
-		STRUCT_TAGPROP tp = iterMap->second;
+		STRUCT_TAGPROP & tp = iterMap->second;
 		strFullName = tp.strTagName;
 		
 		return tp.dwTagIndex;
@@ -689,6 +723,7 @@ void CPPHtmlDrawer::SetColorName(LPCTSTR lpszColorName, COLORREF color)
 		iterMap->second = color; //Modifies
 	else
 		m_mapColors.insert(std::make_pair(lpszColorName, color)); //Add new
+	m_dwStyleVersion++;
 } //End SetColorName
 
 COLORREF CPPHtmlDrawer::GetColorByName(LPCTSTR lpszColorName, COLORREF crDefColor /* = RGB(0, 0, 0) */)
@@ -1681,11 +1716,30 @@ SIZE CPPHtmlDrawer::DrawHtmlString (CPPString & sHtml, LPCRECT lpRect)
 	int nIndex = 0;
 	int nBegin = 0;
 	int i = 0;
-	while (i < sHtml.GetLength())
+
+	//ENG: Gets the tokenized segment. It is scanned only once per a text
+	CPPHtmlDisplayList::ITEMSPTR pItems = m_DisplayList.Find(sHtml);
+	if (NULL == pItems)
+	{
+		CPPHtmlDisplayList::vecItems items;
+		CPPHtmlDisplayList::Parse(sHtml, items);
+		for (size_t nItem = 0; nItem < items.size(); nItem++)
+		{
+			CPPHtmlDisplayList::STRUCT_DISPLAYITEM & item = items [nItem];
+			if (!item.sTag.IsEmpty())
+				item.dwTag = GetTagFromList(item.sTag, item.strFullName, item.bCloseTag);
+		} //for
+		pItems = m_DisplayList.Insert(sHtml, items);
+	} //if
+
+	for (size_t nItem = 0; nItem < pItems->size(); nItem++)
 	{
-		//ENG: Searching a first tag
-		sText = SearchNextTag(sHtml, sTag, i);
-		sProperties = SplitTag(sTag);
+		const CPPHtmlDisplayList::STRUCT_DISPLAYITEM & item = (*pItems) [nItem];
+
+		//ENG: Replays a next tag
+		sText = item.sText;
+		sTag = item.sTag;
+		sProperties = item.sProperties;
 
 		//ENG: Before a tag was exist a text
 		if (!sText.IsEmpty())
@@ -1715,7 +1769,7 @@ SIZE CPPHtmlDrawer::DrawHtmlString (CPPString & sHtml, LPCRECT lpRect)
 			{
 				::SetTextJustification(m_hDC, 0, 0);
 
-				::GetTextExtentPoint32(m_hDC, sText, sText.GetLength(), &sz);
+				sz = GetTextExtent(sText, sText.GetLength());
 
 				y = VerticalAlignText(ptOutput.y, sz.cy);
 
@@ -1742,8 +1796,7 @@ SIZE CPPHtmlDrawer::DrawHtmlString (CPPString & sHtml, LPCRECT lpRect)
 						{
 							sTemp.TrimRight();
 							nSpacesInLine = GetCountOfChars(sTemp);
-							SIZE szTemp;
-							::GetTextExtentPoint32(m_hDC, sTemp, sTemp.GetLength(), &szTemp);
+							SIZE szTemp = GetTextExtent(sTemp, sTemp.GetLength());
 							nRealWidth -= (sz.cx - szTemp.cx);
 						} //if
 
@@ -1752,7 +1805,10 @@ SIZE CPPHtmlDrawer::DrawHtmlString (CPPString & sHtml, LPCRECT lpRect)
 						nRealWidth -= sz.cx;
 						
 						//ENG: Gets a size a output text
-						::GetTextExtentPoint32(m_hDC, sTemp, sTemp.GetLength(), &sz);
+						if ((ALIGN_JUSTIFY == m_hline.nHorzAlign) && m_hline.bWrappedLine)
+							::GetTextExtentPoint32(m_hDC, sTemp, sTemp.GetLength(), &sz);
+						else
+							sz = GetTextExtent(sTemp, sTemp.GetLength());
 						
 						//ENG: Stores a current area as a hyperlink area if it available
 						StoreHyperlinkArea(ptOutput.x, y, ptOutput.x + sz.cx, y + sz.cy);
@@ -1807,8 +1863,10 @@ SIZE CPPHtmlDrawer::DrawHtmlString (CPPString & sHtml, LPCRECT lpRect)
 			//ENG: Get Tag's name
 			nIndex = 0;
 			
-			//ENG: Searching a tag's value
-			DWORD dwTag = GetTagFromList(sTag, m_defStyle.strTag, bCloseTag);
+			//ENG: A tag's value was resolved at the scanning
+			DWORD dwTag = item.dwTag;
+			m_defStyle.strTag = item.strFullName;
+			bCloseTag = item.bCloseTag;
 			
 			//ENG: If a tag was found in a list of the tags
 			if (TAG_NONE != dwTag)
@@ -2821,6 +2879,20 @@ void CPPHtmlDrawer::PrepareOutput(HDC hDC, LPCTSTR lpszHtml, LPSIZE lpSize)
 	rect.left = rect.right = rect.top = rect.bottom = 0;
 //	if (m_bIsTextWrapEnabled)
 		rect.right = m_nMaxWidth;
+	//ENG: If the same text was prepared with the same parameters then the lines,
+	//tables and animations of the first pass are still valid
+	int nDpi = ::GetDeviceCaps(m_hDC, LOGPIXELSY);
+	if (m_bPrepared && (m_dwPreparedVersion == m_dwStyleVersion) &&
+		(m_nPreparedWidth == m_nMaxWidth) && (m_nPreparedDpi == nDpi) &&
+		(m_sPreparedHtml == lpszHtml))
+	{
+		//ENG: The hot areas of the links are collected by the draw pass
+		m_arrLinks.clear();
+		*lpSize = m_szPrepared;
+		return;
+	} //if
+
+	m_bPrepared = false;
 	m_csHtmlText = lpszHtml;
 	ReplaceSpecChars();
 	lpSize->cx = lpSize->cy = 0;
@@ -2846,6 +2918,13 @@ void CPPHtmlDrawer::PrepareOutput(HDC hDC, LPCTSTR lpszHtml, LPSIZE lpSize)
 		lpSize->cx ++;
 		lpSize->cy ++;
 	} //if
+
+	m_bPrepared = true;
+	m_sPreparedHtml = lpszHtml;
+	m_nPreparedWidth = m_nMaxWidth;
+	m_nPreparedDpi = nDpi;
+	m_dwPreparedVersion = m_dwStyleVersion;
+	m_szPrepared = *lpSize;
 } //End PrepareOutput
 
 ////////////////////////////////////////////////////////////////////
@@ -3018,6 +3097,7 @@ void CPPHtmlDrawer::SetImageList(HBITMAP hBitmap, int cx, int cy, int nCount, CO
 	//ENG: Removes previously image list
 	if (NULL != m_hImageList)
 		::DeleteObject(m_hImageList);
+	m_dwStyleVersion++;
 
 	//ENG: If don't need to create a new image list
 	if (NULL == hBitmap)
@@ -3051,6 +3131,7 @@ void CPPHtmlDrawer::SetImageList(HBITMAP hBitmap, int cx, int cy, int nCount, CO
 void CPPHtmlDrawer::EnableEscapeSequences(BOOL bEnable /* = true */)
 {
 	m_bEnableEscapeSequences = bEnable;
+	m_dwStyleVersion++;
 }
 
 void CPPHtmlDrawer::LoadResourceDll(LPCTSTR lpszPathDll, DWORD dwFlags /* = 0 */)
@@ -3067,6 +3148,7 @@ void CPPHtmlDrawer::LoadResourceDll(LPCTSTR lpszPathDll, DWORD dwFlags /* = 0 */
 
 void CPPHtmlDrawer::SetResourceDll(HINSTANCE hInstDll /* = NULL */)
 {
+	m_dwStyleVersion++;
 	if (NULL != m_hInstDll)
 	{
 		if (!m_bFreeInstDll)
@@ -3138,6 +3220,7 @@ void CPPHtmlDrawer::SetCssStyles(DWORD dwIdCssString, LPCTSTR lpszPathDll /* = N
 void CPPHtmlDrawer::SetCssStyles(LPCTSTR lpszCssString /* = NULL */)
 {
 	m_mapStyles.clear(); //removes previously styles
+	m_dwStyleVersion++;
 
 	if (NULL == lpszCssString)
 	{
@@ -3222,6 +3305,7 @@ void CPPHtmlDrawer::SetTextStyle(LPCTSTR lpszStyleName, LPCTSTR lpszStyleValue)
 		//Add new
 		m_mapStyles.insert(std::make_pair(name, (CPPString)lpszStyleValue));
 	} //if
+	m_dwStyleVersion++;
 } //End SetTextStyle
 
 void CPPHtmlDrawer::RemoveTextStyle(LPCTSTR lpszStyleName)
@@ -3234,6 +3318,7 @@ void CPPHtmlDrawer::RemoveTextStyle(LPCTSTR lpszStyleName)
 		return; //item was not found
 	
 	m_mapStyles.erase(iterMap);
+	m_dwStyleVersion++;
 } //End RemoveTextStyle
 
 void CPPHtmlDrawer::AddToTextStyle(LPCTSTR lpszStyleName, LPCTSTR lpszAddStyle)
@@ -3668,34 +3753,7 @@ void CPPHtmlDrawer::SetDefaultStyles(_STRUCT_CHANGESTYLE & cs)
 /////////////////////////////////////////////////////////////////
 CPPString CPPHtmlDrawer::SearchNextTag(CPPString & str, CPPString & strTag, int & nIndex)
 {
-	int nBegin;
-	CPPString sText = _T("");
-	strTag.Empty();
-
-	while (nIndex < str.GetLength())
-	{
-		nBegin = nIndex;
-		//Searching a chars of the begin tag
-		nIndex = str.Find(_T("<"), nIndex);
-		if (nIndex < 0)
-			nIndex = str.GetLength(); //A tag wasn't found
-		sText += str.Mid(nBegin, nIndex - nBegin);
-		if (nIndex < str.GetLength())
-		{
-			//May be it is a begin of the tag?
-			if ((nIndex < (str.GetLength() - 1)) && (_T('<') != str.GetAt(nIndex + 1)))
-			{
-				//Yes of cause!!!
-				strTag = GetTagBody(str, nIndex);
-				return sText;
-			}
-			//No, it is a char '<'
-			sText += _T("<");
-			nIndex += 2;
-			break;
-		} //if
-	} //while
-	return sText;
+	return CPPHtmlDisplayList::SearchNextTag(str, strTag, nIndex);
 } //End SearchNextTag
 
 /////////////////////////////////////////////////////////////////
@@ -3714,19 +3772,7 @@ CPPString CPPHtmlDrawer::SearchNextTag(CPPString & str, CPPString & strTag, int
 /////////////////////////////////////////////////////////////////
 CPPString CPPHtmlDrawer::GetTagBody(CPPString & str, int & nIndex)
 {
-	CPPString sTagName = _T("");
-	//ENG: Search the tag's end 
-	int nEndOfTag = str.Find(_T('>'), nIndex);
-	//ENG: The tag's end was found. Passes a tag's begin char ('<')
-	nIndex++;
-	if (nEndOfTag > nIndex)
-	{
-		//ENG: Gets a full body of tag
-		sTagName = str.Mid(nIndex, nEndOfTag - nIndex);
-		//ENG: Jump to next char after the tag
-		nIndex = nEndOfTag + 1;
-	} //if
-	return sTagName;
+	return CPPHtmlDisplayList::GetTagBody(str, nIndex);
 } //End of GetTagBody
 
 /////////////////////////////////////////////////////////////////
@@ -3739,17 +3785,7 @@ CPPString CPPHtmlDrawer::GetTagBody(CPPString & str, int & nIndex)
 /////////////////////////////////////////////////////////////////
 CPPString CPPHtmlDrawer::SplitTag(CPPString & sTag)
 {
-	CPPString sParam(_T(""));
-	int nIndex = 0;
-	TCHAR tch = GetIndexNextChars(sTag, nIndex, _T(" ="));
-	if (tch != _T('\0'))
-	{
-		//ENG: The separator was found. Splits a tag's body to his name and his parameteres 
-		sParam = sTag.Mid(nIndex);
-		sTag = sTag.Left(nIndex);
-		sParam.TrimLeft(_T(' '));
-	} //if
-	return sParam;
+	return CPPHtmlDisplayList::SplitTag(sTag);
 } //End of SplitTag
 
 CPPString CPPHtmlDrawer::GetNextProperty(CPPString & str, int & nIndex, CPPString & sProp)
@@ -4711,72 +4747,50 @@ void CPPHtmlDrawer::SetImageShadow(int nOffsetX, int nOffsetY, BYTE nDarkenPerce
 	m_bGradientShadow = bGradient;
 	BYTE nColor = ::MulDiv(255, 100 - m_nDarkenShadow, 100);
 	m_crShadow = RGB(nColor, nColor, nColor);
+	m_dwStyleVersion++;
 } //End of SetTooltipShadow
 
 CPPString CPPHtmlDrawer::GetWordWrap(CPPString & str, int nMaxSize, int & nRealSize)
 {
-	int nCurIndex = 0;
-	int nLastIndex = 0;
-	SIZE sz = {0, 0};
-	TCHAR tch = _T(' ');
-	CPPString sResult = _T("");
-	while ((sz.cx <= nRealSize) && (0 != tch))
-	{
-		nLastIndex = nCurIndex;
-		nCurIndex ++;
-		tch = GetIndexNextChars(str, nCurIndex, PPHTMLDRAWER_BREAK_CHARS);
-		::GetTextExtentPoint32(m_hDC, str, nCurIndex, &sz);
-
-		//+++hd
-		// arw - Begin Change
-		// Get the break character as well, trim it if it's a space,
-		// and get the new correct length.
-		sResult = str.Left(nCurIndex + 1);
-		sResult.TrimRight();
-		::GetTextExtentPoint32(m_hDC, sResult, sResult.GetLength(), &sz);
-		// End Change
-
-	} //while
+	//ENG: Every string measured here is a beginning of str, so the extents
+	//     of str give the widths of all of them
+	CPPTextMetrics::TEXTRUNPTR pRun = GetTextRun(str, str.GetLength());
+	return PPGetWordWrap(*pRun, str, nMaxSize, nRealSize, PPHTMLDRAWER_BREAK_CHARS);
+} //End of GetWordWrap
 
-	if (0 == nLastIndex)
-	{
-		if (nMaxSize == nRealSize)
-		{
-			sz.cx = 0;
-			int i = 0;
-			for (i = 1; i < str.GetLength(); i++)
-			{
-				::GetTextExtentPoint32(m_hDC, str, i + 1, &sz);
-				if (sz.cx > nRealSize)
-				{
-					sResult = str.Left(i);
-					str = str.Mid(i);
-					::GetTextExtentPoint32(m_hDC, sResult, i, &sz);
-					nRealSize = sz.cx;
-					return sResult;
-				} //if
-			} //for
-			::GetTextExtentPoint32(m_hDC, str, i, &sz);
-			sResult = str;
-			str.Empty();
-		}
-		else
-		{
-			sz.cx = 0;
-		} //if
-	}
-	else 
+////////////////////////////////////////////////////////////////////
+// CPPHtmlDrawer::GetTextRun()
+//		Gets the extents of all beginnings of the text in the current
+//	font. The runs are kept in a cache shared by the drawers, so the
+//	text must be measured without a justification.
+//------------------------------------------------------------------
+// Parameters:
+//		lpszText		- The text to measure.
+//		nLength			- The number of chars of the text.
+////////////////////////////////////////////////////////////////////
+CPPTextMetrics::TEXTRUNPTR CPPHtmlDrawer::GetTextRun(LPCTSTR lpszText, int nLength)
+{
+	m_GdiMeasurer.SetDC(m_hDC);
+	CPPTextMeasurer & measurer = (NULL != m_pTextMeasurer) ? *m_pTextMeasurer : m_GdiMeasurer;
+	CPPTextMetrics::TEXTRUNPTR pRun = m_TextMetrics.GetRun(measurer, lpszText, nLength);
+	if (NULL == pRun)
 	{
-		sResult = str.Left(nLastIndex + 1);
-		str = str.Mid(nLastIndex + 1);
-		sResult.TrimRight();
-		::GetTextExtentPoint32(m_hDC, sResult, sResult.GetLength(), &sz);
-//		str.TrimRight();
-		str.TrimLeft();
+		//ENG: As a failed GetTextExtentPoint32, the text has no size
+		std::shared_ptr<CPPTextMetrics::STRUCT_TEXTRUN> pEmpty = std::make_shared<CPPTextMetrics::STRUCT_TEXTRUN>();
+		pEmpty->nFontKey = 0;
+		pEmpty->vExtents.assign((nLength > 0) ? nLength : 0, 0);
+		pEmpty->nHeight = 0;
+		pRun = pEmpty;
 	} //if
-	nRealSize = sz.cx;
-	return sResult;
-} //End of GetWordWrap
+	return pRun;
+} //End of GetTextRun
+
+SIZE CPPHtmlDrawer::GetTextExtent(LPCTSTR lpszText, int nLength)
+{
+	CPPTextMetrics::TEXTRUNPTR pRun = GetTextRun(lpszText, nLength);
+	SIZE sz = {pRun->GetWidth(nLength), pRun->nHeight};
+	return sz;
+} //End of GetTextExtent
 
 int CPPHtmlDrawer::GetCountOfChars(CPPString str, TCHAR tchar /*= _T(' ')*/)
 {
@@ -43,6 +43,10 @@
 	#endif
 #endif
 
+#include "PPHtmlDisplayList.h"
+#include "XPerfectHash.h"
+#include "PPTextMetrics.h"
+
 /////////////////////////////////////////////////////////////////////////////
 // CPPHtmlDrawer window
 
@@ -100,10 +104,16 @@ public:
 //		m_bIsTextWrapEnabled = bEnable;};
 //	BOOL IsTextWrapEnabled() {return m_bIsTextWrapEnabled;};
 
-	void SetTabSize(int nSize) {m_nTabSize = nSize;};
+	void SetTabSize(int nSize) {m_nTabSize = nSize; m_dwStyleVersion++;};
 
 	CPPDrawManager * GetDrawManager();
 
+	//Measures the text with the given measurer instead of the output DC,
+	//NULL restores the DC. The measurer must outlive the drawer
+	void SetTextMeasurer(CPPTextMeasurer * pMeasurer = NULL) {m_pTextMeasurer = pMeasurer; m_dwStyleVersion++;};
+	//Text extents measured by every html drawer of the process
+	static CPPTextMetrics & GetTextMetrics() {return m_TextMetrics;};
+
 	static short GetVersionI()		{return 0x13;}
 	static LPCTSTR GetVersionC()	{return (LPCTSTR)_T("1.3 beta");}
 	
@@ -433,6 +443,27 @@ protected:
 	mapTags m_mapTags;
 //	mapTags m_mapTableProp;
 
+	//Perfect hash over the names of m_mapTags, rebuilt after AddTagToList
+	CXPerfectHashMap<mapTags> m_hashTags;
+
+	//Tokenized segments of the html text
+	CPPHtmlDisplayList m_DisplayList;
+
+	//Measuring of the text runs, see GetTextRun
+	CPPGdiTextMeasurer m_GdiMeasurer;
+	CPPTextMeasurer * m_pTextMeasurer;
+	static CPPTextMetrics m_TextMetrics;
+
+	//Result of the last first pass. PrepareOutput with the same text, width,
+	//DPI and unchanged styles reuses the lines, tables and animations of it
+	DWORD m_dwStyleVersion; //Increments on any change that affects a layout
+	BOOL m_bPrepared;
+	CPPString m_sPreparedHtml;
+	int m_nPreparedWidth;
+	int m_nPreparedDpi;
+	DWORD m_dwPreparedVersion;
+	SIZE m_szPrepared;
+
 protected:
 	void SetListOfTags(); //Fill a map of tags
 	void AddTagToList(LPCTSTR lpszName, DWORD dwTagIndex, LPCTSTR lpszFullName); //Add tag to the list of tags
@@ -519,6 +550,8 @@ protected:
 	CPPString GetParameterString(CPPString & str, int & nIndex, TCHAR chBeginParam = _T(':'), CPPString strSeparators = _T(";"));
 	CPPString GetNameOfTag(CPPString & str, int & nIndex);
 	CPPString GetWordWrap(CPPString & str, int nMaxSize, int & nRealSize);
+	CPPTextMetrics::TEXTRUNPTR GetTextRun(LPCTSTR lpszText, int nLength); //Extents of the text without a justification
+	SIZE GetTextExtent(LPCTSTR lpszText, int nLength); //As GetTextExtentPoint32 without a justification
 
 	//Functions for the map of the styles
 	LPCTSTR GetTextStyle(LPCTSTR lpszStyleName);
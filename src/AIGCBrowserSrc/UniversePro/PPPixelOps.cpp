@@ -0,0 +1,787 @@
+/********************************************************************************
+ *           Web Runtime for Application - Version 1.0.0.202203120001           *
+ ********************************************************************************
+ * Copyright (C) 2002-2021 by Tangram Team.   All Rights Reserved.
+ * There are Three Key Features of Webruntime:
+ * 1. Built-in Modern Web Browser: Independent Browser Window and Browser Window
+ *    as sub windows of other windows are supported in the application process;
+ * 2. DOM Plus: DOMPlus is a natural extension of the standard DOM system.
+ *    It allows the application system to support a kind of generalized web pages,
+ *    which are composed of standard DOM elements and binary components supported
+ *    by the application system;
+ * 3. JavaScript for Application: Similar to VBA in MS office, JavaScript will
+ *    become a built-in programmable language in the application system, so that
+ *    the application system can be expanded and developed for the Internet based
+ *    on modern javscript/Web technology.
+ * Use of this source code is governed by a BSD-style license that
+ * can be found in the LICENSE file.
+ *
+ * CONTACT INFORMATION:
+ * mailto:tangramteam@outlook.com or mailto:sunhuizlz@yeah.net
+ * https://www.webruntime.com
+ *******************************************************************************/
+
+// PPPixelOps.cpp : per-pixel operations for CPPDrawManager
+
+#include "stdafx.h"
+#include "PPPixelOps.h"
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+	#define PIXELOPS_X86
+	#include <emmintrin.h>
+	#include <immintrin.h>
+	#ifdef _MSC_VER
+		#include <intrin.h>
+	#endif
+#elif defined(_M_ARM64) || defined(__aarch64__)
+	#define PIXELOPS_ARM64
+	#include <arm_neon.h>
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+	#define PIXELOPS_TARGET(x)	__attribute__((target(x)))
+#else
+	#define PIXELOPS_TARGET(x)
+#endif
+
+#define PIXEL_ALPHA		0xFF000000
+#define PIXEL_COLOR		0x00FFFFFF
+
+//ENG: x / 255 rounding down, exact for 0 <= x <= 65280
+static inline uint32_t Div255(uint32_t x)
+{
+	return (x + 1 + (x >> 8)) >> 8;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Scalar reference
+//////////////////////////////////////////////////////////////////////
+
+static void BlendScalar(uint32_t * pDest, const uint32_t * pSrc, size_t nCount, uint8_t nAlpha)
+{
+	uint32_t a = nAlpha, na = 255 - nAlpha;
+	for (size_t i = 0; i < nCount; i++)
+	{
+		uint32_t s = pSrc[i], d = pDest[i], r = 0;
+		for (int nShift = 0; nShift < 32; nShift += 8)
+			r |= Div255(((s >> nShift) & 0xFF) * a + ((d >> nShift) & 0xFF) * na) << nShift;
+		pDest[i] = r;
+	} //for
+} //End BlendScalar
+
+static void BlendOverScalar(uint32_t * pDest, const uint32_t * pSrc, size_t nCount)
+{
+	for (size_t i = 0; i < nCount; i++)
+	{
+		uint32_t s = pSrc[i], d = pDest[i], r = 0;
+		uint32_t na = 255 - (s >> 24);
+		for (int nShift = 0; nShift < 32; nShift += 8)
+		{
+			uint32_t c = ((s >> nShift) & 0xFF) + Div255(((d >> nShift) & 0xFF) * na);
+			r |= (c > 255 ? 255 : c) << nShift;
+		} //for
+		pDest[i] = r;
+	} //for
+} //End BlendOverScalar
+
+static void PremultiplyScalar(uint32_t * pBits, size_t nCount)
+{
+	for (size_t i = 0; i < nCount; i++)
+	{
+		uint32_t c = pBits[i], a = c >> 24;
+		pBits[i] = (c & PIXEL_ALPHA) | 
+				   (Div255(((c >> 16) & 0xFF) * a) << 16) | 
+				   (Div255(((c >> 8) & 0xFF) * a) << 8) | 
+				   Div255((c & 0xFF) * a);
+	} //for
+} //End PremultiplyScalar
+
+static void GrayscaleScalar(uint32_t * pBits, size_t nCount)
+{
+	for (size_t i = 0; i < nCount; i++)
+	{
+		uint32_t c = pBits[i];
+		uint32_t g = (((c >> 16) & 0xFF) * 77 + ((c >> 8) & 0xFF) * 150 + (c & 0xFF) * 29) >> 8;
+		pBits[i] = (c & PIXEL_ALPHA) | (g * 0x010101);
+	} //for
+} //End GrayscaleScalar
+
+static void ScaleScalar(uint32_t * pBits, size_t nCount, unsigned int nScale)
+{
+	for (size_t i = 0; i < nCount; i++)
+	{
+		uint32_t c = pBits[i], r = c & PIXEL_ALPHA;
+		for (int nShift = 0; nShift < 24; nShift += 8)
+		{
+			uint32_t v = (((c >> nShift) & 0xFF) * nScale) >> 8;
+			r |= (v > 255 ? 255 : v) << nShift;
+		} //for
+		pBits[i] = r;
+	} //for
+} //End ScaleScalar
+
+static void TintScalar(uint32_t * pBits, size_t nCount, uint32_t dwColor, uint8_t nAlpha)
+{
+	uint32_t a = nAlpha, na = 255 - nAlpha;
+	for (size_t i = 0; i < nCount; i++)
+	{
+		uint32_t c = pBits[i], r = c & PIXEL_ALPHA;
+		for (int nShift = 0; nShift < 24; nShift += 8)
+			r |= Div255(((dwColor >> nShift) & 0xFF) * a + ((c >> nShift) & 0xFF) * na) << nShift;
+		pBits[i] = r;
+	} //for
+} //End TintScalar
+
+static void DarkenByMaskScalar(uint32_t * pBits, const uint32_t * pMask, size_t nCount)
+{
+	for (size_t i = 0; i < nCount; i++)
+	{
+		uint32_t c = pBits[i], m = pMask[i] & 0xFF, r = c & PIXEL_ALPHA;
+		for (int nShift = 0; nShift < 24; nShift += 8)
+			r |= Div255(((c >> nShift) & 0xFF) * m) << nShift;
+		pBits[i] = r;
+	} //for
+} //End DarkenByMaskScalar
+
+static size_t FindColorKeyScalar(const uint32_t * pBits, size_t nCount, uint32_t dwKey)
+{
+	for (size_t i = 0; i < nCount; i++)
+	{
+		if (pBits[i] == dwKey)
+			return i;
+	} //for
+	return nCount;
+} //End FindColorKeyScalar
+
+static const CPPPixelOps::STRUCT_PIXELOPS g_opsScalar = {
+	BlendScalar, BlendOverScalar, PremultiplyScalar, GrayscaleScalar,
+	ScaleScalar, TintScalar, DarkenByMaskScalar, FindColorKeyScalar
+};
+
+#ifdef PIXELOPS_X86
+//////////////////////////////////////////////////////////////////////
+// SSE2, four pixels at a time as 16-bit lanes
+//////////////////////////////////////////////////////////////////////
+
+PIXELOPS_TARGET("sse2") static inline __m128i Div255_SSE2(__m128i x)
+{
+	x = _mm_add_epi16(x, _mm_add_epi16(_mm_set1_epi16(1), _mm_srli_epi16(x, 8)));
+	return _mm_srli_epi16(x, 8);
+}
+
+//ENG: Alpha of each pixel in all four of its lanes
+PIXELOPS_TARGET("sse2") static inline __m128i Alpha_SSE2(__m128i x)
+{
+	return _mm_shufflehi_epi16(_mm_shufflelo_epi16(x, 0xFF), 0xFF);
+}
+
+PIXELOPS_TARGET("sse2") static void BlendSSE2(uint32_t * pDest, const uint32_t * pSrc, size_t nCount, uint8_t nAlpha)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i a = _mm_set1_epi16(nAlpha);
+	const __m128i na = _mm_set1_epi16(255 - nAlpha);
+	size_t i = 0;
+	for (; i + 4 <= nCount; i += 4)
+	{
+		__m128i s = _mm_loadu_si128((const __m128i *)(pSrc + i));
+		__m128i d = _mm_loadu_si128((const __m128i *)(pDest + i));
+		__m128i lo = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(s, zero), a), _mm_mullo_epi16(_mm_unpacklo_epi8(d, zero), na));
+		__m128i hi = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(s, zero), a), _mm_mullo_epi16(_mm_unpackhi_epi8(d, zero), na));
+		_mm_storeu_si128((__m128i *)(pDest + i), _mm_packus_epi16(Div255_SSE2(lo), Div255_SSE2(hi)));
+	} //for
+	BlendScalar(pDest + i, pSrc + i, nCount - i, nAlpha);
+} //End BlendSSE2
+
+PIXELOPS_TARGET("sse2") static void BlendOverSSE2(uint32_t * pDest, const uint32_t * pSrc, size_t nCount)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i full = _mm_set1_epi16(255);
+	size_t i = 0;
+	for (; i + 4 <= nCount; i += 4)
+	{
+		__m128i s = _mm_loadu_si128((const __m128i *)(pSrc + i));
+		__m128i d = _mm_loadu_si128((const __m128i *)(pDest + i));
+		__m128i slo = _mm_unpacklo_epi8(s, zero), shi = _mm_unpackhi_epi8(s, zero);
+		__m128i lo = Div255_SSE2(_mm_mullo_epi16(_mm_unpacklo_epi8(d, zero), _mm_sub_epi16(full, Alpha_SSE2(slo))));
+		__m128i hi = Div255_SSE2(_mm_mullo_epi16(_mm_unpackhi_epi8(d, zero), _mm_sub_epi16(full, Alpha_SSE2(shi))));
+		_mm_storeu_si128((__m128i *)(pDest + i), _mm_packus_epi16(_mm_add_epi16(slo, lo), _mm_add_epi16(shi, hi)));
+	} //for
+	BlendOverScalar(pDest + i, pSrc + i, nCount - i);
+} //End BlendOverSSE2
+
+PIXELOPS_TARGET("sse2") static void PremultiplySSE2(uint32_t * pBits, size_t nCount)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i color = _mm_set_epi16(0, -1, -1, -1, 0, -1, -1, -1);
+	const __m128i keep = _mm_set_epi16(255, 0, 0, 0, 255, 0, 0, 0);
+	size_t i = 0;
+	for (; i + 4 <= nCount; i += 4)
+	{
+		__m128i c = _mm_loadu_si128((const __m128i *)(pBits + i));
+		__m128i lo = _mm_unpacklo_epi8(c, zero), hi = _mm_unpackhi_epi8(c, zero);
+		//ENG: times 255 in the alpha lane leaves alpha as it is
+		__m128i alo = _mm_or_si128(_mm_and_si128(Alpha_SSE2(lo), color), keep);
+		__m128i ahi = _mm_or_si128(_mm_and_si128(Alpha_SSE2(hi), color), keep);
+		lo = Div255_SSE2(_mm_mullo_epi16(lo, alo));
+		hi = Div255_SSE2(_mm_mullo_epi16(hi, ahi));
+		_mm_storeu_si128((__m128i *)(pBits + i), _mm_packus_epi16(lo, hi));
+	} //for
+	PremultiplyScalar(pBits + i, nCount - i);
+} //End PremultiplySSE2
+
+PIXELOPS_TARGET("sse2") static void GrayscaleSSE2(uint32_t * pBits, size_t nCount)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i weights = _mm_set_epi16(0, 77, 150, 29, 0, 77, 150, 29);
+	const __m128i alpha = _mm_set1_epi32((int)PIXEL_ALPHA);
+	size_t i = 0;
+	for (; i + 4 <= nCount; i += 4)
+	{
+		__m128i c = _mm_loadu_si128((const __m128i *)(pBits + i));
+		//ENG: B * 29 + G * 150 and R * 77 per pixel, then summed
+		__m128 lo = _mm_castsi128_ps(_mm_madd_epi16(_mm_unpacklo_epi8(c, zero), weights));
+		__m128 hi = _mm_castsi128_ps(_mm_madd_epi16(_mm_unpackhi_epi8(c, zero), weights));
+		__m128i g = _mm_add_epi32(_mm_castps_si128(_mm_shuffle_ps(lo, hi, _MM_SHUFFLE(2, 0, 2, 0))),
+								  _mm_castps_si128(_mm_shuffle_ps(lo, hi, _MM_SHUFFLE(3, 1, 3, 1))));
+		g = _mm_srli_epi32(g, 8);
+		g = _mm_or_si128(g, _mm_or_si128(_mm_slli_epi32(g, 8), _mm_slli_epi32(g, 16)));
+		_mm_storeu_si128((__m128i *)(pBits + i), _mm_or_si128(g, _mm_and_si128(c, alpha)));
+	} //for
+	GrayscaleScalar(pBits + i, nCount - i);
+} //End GrayscaleSSE2
+
+PIXELOPS_TARGET("sse2") static void ScaleSSE2(uint32_t * pBits, size_t nCount, unsigned int nScale)
+{
+	const __m128i zero = _mm_setzero_si128();
+	//ENG: (c << 8) * nScale >> 16, with 256 (unchanged) in the alpha lane
+	const __m128i scale = _mm_set_epi16(256, (short)nScale, (short)nScale, (short)nScale, 256, (short)nScale, (short)nScale, (short)nScale);
+	size_t i = 0;
+	for (; i + 4 <= nCount; i += 4)
+	{
+		__m128i c = _mm_loadu_si128((const __m128i *)(pBits + i));
+		__m128i lo = _mm_mulhi_epu16(_mm_slli_epi16(_mm_unpacklo_epi8(c, zero), 8), scale);
+		__m128i hi = _mm_mulhi_epu16(_mm_slli_epi16(_mm_unpackhi_epi8(c, zero), 8), scale);
+		_mm_storeu_si128((__m128i *)(pBits + i), _mm_packus_epi16(lo, hi));
+	} //for
+	ScaleScalar(pBits + i, nCount - i, nScale);
+} //End ScaleSSE2
+
+PIXELOPS_TARGET("sse2") static void TintSSE2(uint32_t * pBits, size_t nCount, uint32_t dwColor, uint8_t nAlpha)
+{
+	const __m128i zero = _mm_setzero_si128();
+	short b = (short)((dwColor & 0xFF) * nAlpha);
+	short g = (short)(((dwColor >> 8) & 0xFF) * nAlpha);
+	short r = (short)(((dwColor >> 16) & 0xFF) * nAlpha);
+	short na = (short)(255 - nAlpha);
+	//ENG: the alpha lane gets Div255(a * 255), which is a
+	const __m128i tint = _mm_set_epi16(0, r, g, b, 0, r, g, b);
+	const __m128i keep = _mm_set_epi16(255, na, na, na, 255, na, na, na);
+	size_t i = 0;
+	for (; i + 4 <= nCount; i += 4)
+	{
+		__m128i c = _mm_loadu_si128((const __m128i *)(pBits + i));
+		__m128i lo = Div255_SSE2(_mm_add_epi16(tint, _mm_mullo_epi16(_mm_unpacklo_epi8(c, zero), keep)));
+		__m128i hi = Div255_SSE2(_mm_add_epi16(tint, _mm_mullo_epi16(_mm_unpackhi_epi8(c, zero), keep)));
+		_mm_storeu_si128((__m128i *)(pBits + i), _mm_packus_epi16(lo, hi));
+	} //for
+	TintScalar(pBits + i, nCount - i, dwColor, nAlpha);
+} //End TintSSE2
+
+PIXELOPS_TARGET("sse2") static void DarkenByMaskSSE2(uint32_t * pBits, const uint32_t * pMask, size_t nCount)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i color = _mm_set_epi16(0, -1, -1, -1, 0, -1, -1, -1);
+	const __m128i keep = _mm_set_epi16(255, 0, 0, 0, 255, 0, 0, 0);
+	size_t i = 0;
+	for (; i + 4 <= nCount; i += 4)
+	{
+		__m128i c = _mm_loadu_si128((const __m128i *)(pBits + i));
+		__m128i m = _mm_loadu_si128((const __m128i *)(pMask + i));
+		__m128i mlo = _mm_shufflehi_epi16(_mm_shufflelo_epi16(_mm_unpacklo_epi8(m, zero), 0x00), 0x00);
+		__m128i mhi = _mm_shufflehi_epi16(_mm_shufflelo_epi16(_mm_unpackhi_epi8(m, zero), 0x00), 0x00);
+		mlo = _mm_or_si128(_mm_and_si128(mlo, color), keep);
+		mhi = _mm_or_si128(_mm_and_si128(mhi, color), keep);
+		__m128i lo = Div255_SSE2(_mm_mullo_epi16(_mm_unpacklo_epi8(c, zero), mlo));
+		__m128i hi = Div255_SSE2(_mm_mullo_epi16(_mm_unpackhi_epi8(c, zero), mhi));
+		_mm_storeu_si128((__m128i *)(pBits + i), _mm_packus_epi16(lo, hi));
+	} //for
+	DarkenByMaskScalar(pBits + i, pMask + i, nCount - i);
+} //End DarkenByMaskSSE2
+
+PIXELOPS_TARGET("sse2") static size_t FindColorKeySSE2(const uint32_t * pBits, size_t nCount, uint32_t dwKey)
+{
+	const __m128i key = _mm_set1_epi32((int)dwKey);
+	size_t i = 0;
+	for (; i + 4 <= nCount; i += 4)
+	{
+		__m128i c = _mm_loadu_si128((const __m128i *)(pBits + i));
+		if (_mm_movemask_epi8(_mm_cmpeq_epi32(c, key)))
+			break;
+	} //for
+	return i + FindColorKeyScalar(pBits + i, nCount - i, dwKey);
+} //End FindColorKeySSE2
+
+static const CPPPixelOps::STRUCT_PIXELOPS g_opsSSE2 = {
+	BlendSSE2, BlendOverSSE2, PremultiplySSE2, GrayscaleSSE2,
+	ScaleSSE2, TintSSE2, DarkenByMaskSSE2, FindColorKeySSE2
+};
+
+//////////////////////////////////////////////////////////////////////
+// AVX2, the SSE2 kernels on eight pixels
+//////////////////////////////////////////////////////////////////////
+
+PIXELOPS_TARGET("avx2") static inline __m256i Div255_AVX2(__m256i x)
+{
+	x = _mm256_add_epi16(x, _mm256_add_epi16(_mm256_set1_epi16(1), _mm256_srli_epi16(x, 8)));
+	return _mm256_srli_epi16(x, 8);
+}
+
+PIXELOPS_TARGET("avx2") static inline __m256i Alpha_AVX2(__m256i x)
+{
+	return _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(x, 0xFF), 0xFF);
+}
+
+PIXELOPS_TARGET("avx2") static void BlendAVX2(uint32_t * pDest, const uint32_t * pSrc, size_t nCount, uint8_t nAlpha)
+{
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i a = _mm256_set1_epi16(nAlpha);
+	const __m256i na = _mm256_set1_epi16(255 - nAlpha);
+	size_t i = 0;
+	for (; i + 8 <= nCount; i += 8)
+	{
+		__m256i s = _mm256_loadu_si256((const __m256i *)(pSrc + i));
+		__m256i d = _mm256_loadu_si256((const __m256i *)(pDest + i));
+		__m256i lo = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpacklo_epi8(s, zero), a), _mm256_mullo_epi16(_mm256_unpacklo_epi8(d, zero), na));
+		__m256i hi = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpackhi_epi8(s, zero), a), _mm256_mullo_epi16(_mm256_unpackhi_epi8(d, zero), na));
+		_mm256_storeu_si256((__m256i *)(pDest + i), _mm256_packus_epi16(Div255_AVX2(lo), Div255_AVX2(hi)));
+	} //for
+	BlendSSE2(pDest + i, pSrc + i, nCount - i, nAlpha);
+} //End BlendAVX2
+
+PIXELOPS_TARGET("avx2") static void BlendOverAVX2(uint32_t * pDest, const uint32_t * pSrc, size_t nCount)
+{
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i full = _mm256_set1_epi16(255);
+	size_t i = 0;
+	for (; i + 8 <= nCount; i += 8)
+	{
+		__m256i s = _mm256_loadu_si256((const __m256i *)(pSrc + i));
+		__m256i d = _mm256_loadu_si256((const __m256i *)(pDest + i));
+		__m256i slo = _mm256_unpacklo_epi8(s, zero), shi = _mm256_unpackhi_epi8(s, zero);
+		__m256i lo = Div255_AVX2(_mm256_mullo_epi16(_mm256_unpacklo_epi8(d, zero), _mm256_sub_epi16(full, Alpha_AVX2(slo))));
+		__m256i hi = Div255_AVX2(_mm256_mullo_epi16(_mm256_unpackhi_epi8(d, zero), _mm256_sub_epi16(full, Alpha_AVX2(shi))));
+		_mm256_storeu_si256((__m256i *)(pDest + i), _mm256_packus_epi16(_mm256_add_epi16(slo, lo), _mm256_add_epi16(shi, hi)));
+	} //for
+	BlendOverSSE2(pDest + i, pSrc + i, nCount - i);
+} //End BlendOverAVX2
+
+PIXELOPS_TARGET("avx2") static void PremultiplyAVX2(uint32_t * pBits, size_t nCount)
+{
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i color = _mm256_set_epi16(0, -1, -1, -1, 0, -1, -1, -1, 0, -1, -1, -1, 0, -1, -1, -1);
+	const __m256i keep = _mm256_set_epi16(255, 0, 0, 0, 255, 0, 0, 0, 255, 0, 0, 0, 255, 0, 0, 0);
+	size_t i = 0;
+	for (; i + 8 <= nCount; i += 8)
+	{
+		__m256i c = _mm256_loadu_si256((const __m256i *)(pBits + i));
+		__m256i lo = _mm256_unpacklo_epi8(c, zero), hi = _mm256_unpackhi_epi8(c, zero);
+		__m256i alo = _mm256_or_si256(_mm256_and_si256(Alpha_AVX2(lo), color), keep);
+		__m256i ahi = _mm256_or_si256(_mm256_and_si256(Alpha_AVX2(hi), color), keep);
+		lo = Div255_AVX2(_mm256_mullo_epi16(lo, alo));
+		hi = Div255_AVX2(_mm256_mullo_epi16(hi, ahi));
+		_mm256_storeu_si256((__m256i *)(pBits + i), _mm256_packus_epi16(lo, hi));
+	} //for
+	PremultiplySSE2(pBits + i, nCount - i);
+} //End PremultiplyAVX2
+
+PIXELOPS_TARGET("avx2") static void GrayscaleAVX2(uint32_t * pBits, size_t nCount)
+{
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i weights = _mm256_set_epi16(0, 77, 150, 29, 0, 77, 150, 29, 0, 77, 150, 29, 0, 77, 150, 29);
+	const __m256i alpha = _mm256_set1_epi32((int)PIXEL_ALPHA);
+	size_t i = 0;
+	for (; i + 8 <= nCount; i += 8)
+	{
+		__m256i c = _mm256_loadu_si256((const __m256i *)(pBits + i));
+		__m256 lo = _mm256_castsi256_ps(_mm256_madd_epi16(_mm256_unpacklo_epi8(c, zero), weights));
+		__m256 hi = _mm256_castsi256_ps(_mm256_madd_epi16(_mm256_unpackhi_epi8(c, zero), weights));
+		__m256i g = _mm256_add_epi32(_mm256_castps_si256(_mm256_shuffle_ps(lo, hi, _MM_SHUFFLE(2, 0, 2, 0))),
+									 _mm256_castps_si256(_mm256_shuffle_ps(lo, hi, _MM_SHUFFLE(3, 1, 3, 1))));
+		g = _mm256_srli_epi32(g, 8);
+		g = _mm256_or_si256(g, _mm256_or_si256(_mm256_slli_epi32(g, 8), _mm256_slli_epi32(g, 16)));
+		_mm256_storeu_si256((__m256i *)(pBits + i), _mm256_or_si256(g, _mm256_and_si256(c, alpha)));
+	} //for
+	GrayscaleSSE2(pBits + i, nCount - i);
+} //End GrayscaleAVX2
+
+PIXELOPS_TARGET("avx2") static void ScaleAVX2(uint32_t * pBits, size_t nCount, unsigned int nScale)
+{
+	const __m256i zero = _mm256_setzero_si256();
+	short s = (short)nScale;
+	const __m256i scale = _mm256_set_epi16(256, s, s, s, 256, s, s, s, 256, s, s, s, 256, s, s, s);
+	size_t i = 0;
+	for (; i + 8 <= nCount; i += 8)
+	{
+		__m256i c = _mm256_loadu_si256((const __m256i *)(pBits + i));
+		__m256i lo = _mm256_mulhi_epu16(_mm256_slli_epi16(_mm256_unpacklo_epi8(c, zero), 8), scale);
+		__m256i hi = _mm256_mulhi_epu16(_mm256_slli_epi16(_mm256_unpackhi_epi8(c, zero), 8), scale);
+		_mm256_storeu_si256((__m256i *)(pBits + i), _mm256_packus_epi16(lo, hi));
+	} //for
+	ScaleSSE2(pBits + i, nCount - i, nScale);
+} //End ScaleAVX2
+
+PIXELOPS_TARGET("avx2") static void TintAVX2(uint32_t * pBits, size_t nCount, uint32_t dwColor, uint8_t nAlpha)
+{
+	const __m256i zero = _mm256_setzero_si256();
+	short b = (short)((dwColor & 0xFF) * nAlpha);
+	short g = (short)(((dwColor >> 8) & 0xFF) * nAlpha);
+	short r = (short)(((dwColor >> 16) & 0xFF) * nAlpha);
+	short na = (short)(255 - nAlpha);
+	const __m256i tint = _mm256_set_epi16(0, r, g, b, 0, r, g, b, 0, r, g, b, 0, r, g, b);
+	const __m256i keep = _mm256_set_epi16(255, na, na, na, 255, na, na, na, 255, na, na, na, 255, na, na, na);
+	size_t i = 0;
+	for (; i + 8 <= nCount; i += 8)
+	{
+		__m256i c = _mm256_loadu_si256((const __m256i *)(pBits + i));
+		__m256i lo = Div255_AVX2(_mm256_add_epi16(tint, _mm256_mullo_epi16(_mm256_unpacklo_epi8(c, zero), keep)));
+		__m256i hi = Div255_AVX2(_mm256_add_epi16(tint, _mm256_mullo_epi16(_mm256_unpackhi_epi8(c, zero), keep)));
+		_mm256_storeu_si256((__m256i *)(pBits + i), _mm256_packus_epi16(lo, hi));
+	} //for
+	TintSSE2(pBits + i, nCount - i, dwColor, nAlpha);
+} //End TintAVX2
+
+PIXELOPS_TARGET("avx2") static void DarkenByMaskAVX2(uint32_t * pBits, const uint32_t * pMask, size_t nCount)
+{
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i color = _mm256_set_epi16(0, -1, -1, -1, 0, -1, -1, -1, 0, -1, -1, -1, 0, -1, -1, -1);
+	const __m256i keep = _mm256_set_epi16(255, 0, 0, 0, 255, 0, 0, 0, 255, 0, 0, 0, 255, 0, 0, 0);
+	size_t i = 0;
+	for (; i + 8 <= nCount; i += 8)
+	{
+		__m256i c = _mm256_loadu_si256((const __m256i *)(pBits + i));
+		__m256i m = _mm256_loadu_si256((const __m256i *)(pMask + i));
+		__m256i mlo = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(_mm256_unpacklo_epi8(m, zero), 0x00), 0x00);
+		__m256i mhi = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(_mm256_unpackhi_epi8(m, zero), 0x00), 0x00);
+		mlo = _mm256_or_si256(_mm256_and_si256(mlo, color), keep);
+		mhi = _mm256_or_si256(_mm256_and_si256(mhi, color), keep);
+		__m256i lo = Div255_AVX2(_mm256_mullo_epi16(_mm256_unpacklo_epi8(c, zero), mlo));
+		__m256i hi = Div255_AVX2(_mm256_mullo_epi16(_mm256_unpackhi_epi8(c, zero), mhi));
+		_mm256_storeu_si256((__m256i *)(pBits + i), _mm256_packus_epi16(lo, hi));
+	} //for
+	DarkenByMaskSSE2(pBits + i, pMask + i, nCount - i);
+} //End DarkenByMaskAVX2
+
+PIXELOPS_TARGET("avx2") static size_t FindColorKeyAVX2(const uint32_t * pBits, size_t nCount, uint32_t dwKey)
+{
+	const __m256i key = _mm256_set1_epi32((int)dwKey);
+	size_t i = 0;
+	for (; i + 8 <= nCount; i += 8)
+	{
+		__m256i c = _mm256_loadu_si256((const __m256i *)(pBits + i));
+		if (_mm256_movemask_epi8(_mm256_cmpeq_epi32(c, key)))
+			break;
+	} //for
+	return i + FindColorKeySSE2(pBits + i, nCount - i, dwKey);
+} //End FindColorKeyAVX2
+
+static const CPPPixelOps::STRUCT_PIXELOPS g_opsAVX2 = {
+	BlendAVX2, BlendOverAVX2, PremultiplyAVX2, GrayscaleAVX2,
+	ScaleAVX2, TintAVX2, DarkenByMaskAVX2, FindColorKeyAVX2
+};
+#endif //PIXELOPS_X86
+
+#ifdef PIXELOPS_ARM64
+//////////////////////////////////////////////////////////////////////
+// NEON, sixteen pixels at a time split into B, G, R and A planes
+//////////////////////////////////////////////////////////////////////
+
+static inline uint8x8_t Div255_NEON(uint16x8_t x)
+{
+	return vshrn_n_u16(vaddq_u16(x, vaddq_u16(vdupq_n_u16(1), vshrq_n_u16(x, 8))), 8);
+}
+
+//ENG: Div255(a * b) of two planes
+static inline uint8x16_t MulDiv255_NEON(uint8x16_t a, uint8x16_t b)
+{
+	return vcombine_u8(Div255_NEON(vmull_u8(vget_low_u8(a), vget_low_u8(b))),
+					   Div255_NEON(vmull_u8(vget_high_u8(a), vget_high_u8(b))));
+}
+
+//ENG: Div255(a * x + b * y) of two planes
+static inline uint8x16_t Lerp_NEON(uint8x16_t a, uint8x8_t x, uint8x16_t b, uint8x8_t y)
+{
+	return vcombine_u8(Div255_NEON(vmlal_u8(vmull_u8(vget_low_u8(a), x), vget_low_u8(b), y)),
+					   Div255_NEON(vmlal_u8(vmull_u8(vget_high_u8(a), x), vget_high_u8(b), y)));
+}
+
+static void BlendNEON(uint32_t * pDest, const uint32_t * pSrc, size_t nCount, uint8_t nAlpha)
+{
+	const uint8x8_t a = vdup_n_u8(nAlpha);
+	const uint8x8_t na = vdup_n_u8(255 - nAlpha);
+	size_t i = 0;
+	for (; i + 16 <= nCount; i += 16)
+	{
+		uint8x16x4_t s = vld4q_u8((const uint8_t *)(pSrc + i));
+		uint8x16x4_t d = vld4q_u8((const uint8_t *)(pDest + i));
+		for (int n = 0; n < 4; n++)
+			d.val[n] = Lerp_NEON(s.val[n], a, d.val[n], na);
+		vst4q_u8((uint8_t *)(pDest + i), d);
+	} //for
+	BlendScalar(pDest + i, pSrc + i, nCount - i, nAlpha);
+} //End BlendNEON
+
+static void BlendOverNEON(uint32_t * pDest, const uint32_t * pSrc, size_t nCount)
+{
+	size_t i = 0;
+	for (; i + 16 <= nCount; i += 16)
+	{
+		uint8x16x4_t s = vld4q_u8((const uint8_t *)(pSrc + i));
+		uint8x16x4_t d = vld4q_u8((const uint8_t *)(pDest + i));
+		uint8x16_t na = vmvnq_u8(s.val[3]);
+		for (int n = 0; n < 4; n++)
+			d.val[n] = vqaddq_u8(s.val[n], MulDiv255_NEON(d.val[n], na));
+		vst4q_u8((uint8_t *)(pDest + i), d);
+	} //for
+	BlendOverScalar(pDest + i, pSrc + i, nCount - i);
+} //End BlendOverNEON
+
+static void PremultiplyNEON(uint32_t * pBits, size_t nCount)
+{
+	size_t i = 0;
+	for (; i + 16 <= nCount; i += 16)
+	{
+		uint8x16x4_t c = vld4q_u8((const uint8_t *)(pBits + i));
+		for (int n = 0; n < 3; n++)
+			c.val[n] = MulDiv255_NEON(c.val[n], c.val[3]);
+		vst4q_u8((uint8_t *)(pBits + i), c);
+	} //for
+	PremultiplyScalar(pBits + i, nCount - i);
+} //End PremultiplyNEON
+
+static void GrayscaleNEON(uint32_t * pBits, size_t nCount)
+{
+	const uint8x8_t wr = vdup_n_u8(77), wg = vdup_n_u8(150), wb = vdup_n_u8(29);
+	size_t i = 0;
+	for (; i + 16 <= nCount; i += 16)
+	{
+		uint8x16x4_t c = vld4q_u8((const uint8_t *)(pBits + i));
+		uint16x8_t lo = vmlal_u8(vmlal_u8(vmull_u8(vget_low_u8(c.val[2]), wr), vget_low_u8(c.val[1]), wg), vget_low_u8(c.val[0]), wb);
+		uint16x8_t hi = vmlal_u8(vmlal_u8(vmull_u8(vget_high_u8(c.val[2]), wr), vget_high_u8(c.val[1]), wg), vget_high_u8(c.val[0]), wb);
+		c.val[0] = c.val[1] = c.val[2] = vcombine_u8(vshrn_n_u16(lo, 8), vshrn_n_u16(hi, 8));
+		vst4q_u8((uint8_t *)(pBits + i), c);
+	} //for
+	GrayscaleScalar(pBits + i, nCount - i);
+} //End GrayscaleNEON
+
+static void ScaleNEON(uint32_t * pBits, size_t nCount, unsigned int nScale)
+{
+	//ENG: c * nScale / 256 = c * q + c * r / 256, each part fits 16 bits
+	const uint8x8_t q = vdup_n_u8((uint8_t)(nScale >> 8));
+	const uint8x8_t r = vdup_n_u8((uint8_t)(nScale & 0xFF));
+	size_t i = 0;
+	for (; i + 16 <= nCount; i += 16)
+	{
+		uint8x16x4_t c = vld4q_u8((const uint8_t *)(pBits + i));
+		for (int n = 0; n < 3; n++)
+		{
+			uint8x8_t lo = vget_low_u8(c.val[n]), hi = vget_high_u8(c.val[n]);
+			uint16x8_t vlo = vaddq_u16(vmull_u8(lo, q), vshrq_n_u16(vmull_u8(lo, r), 8));
+			uint16x8_t vhi = vaddq_u16(vmull_u8(hi, q), vshrq_n_u16(vmull_u8(hi, r), 8));
+			c.val[n] = vcombine_u8(vqmovn_u16(vlo), vqmovn_u16(vhi));
+		} //for
+		vst4q_u8((uint8_t *)(pBits + i), c);
+	} //for
+	ScaleScalar(pBits + i, nCount - i, nScale);
+} //End ScaleNEON
+
+static void TintNEON(uint32_t * pBits, size_t nCount, uint32_t dwColor, uint8_t nAlpha)
+{
+	const uint8x8_t na = vdup_n_u8(255 - nAlpha);
+	uint16x8_t tint[3];
+	for (int n = 0; n < 3; n++)
+		tint[n] = vdupq_n_u16((uint16_t)(((dwColor >> (n * 8)) & 0xFF) * nAlpha));
+	size_t i = 0;
+	for (; i + 16 <= nCount; i += 16)
+	{
+		uint8x16x4_t c = vld4q_u8((const uint8_t *)(pBits + i));
+		for (int n = 0; n < 3; n++)
+			c.val[n] = vcombine_u8(Div255_NEON(vmlal_u8(tint[n], vget_low_u8(c.val[n]), na)),
+								   Div255_NEON(vmlal_u8(tint[n], vget_high_u8(c.val[n]), na)));
+		vst4q_u8((uint8_t *)(pBits + i), c);
+	} //for
+	TintScalar(pBits + i, nCount - i, dwColor, nAlpha);
+} //End TintNEON
+
+static void DarkenByMaskNEON(uint32_t * pBits, const uint32_t * pMask, size_t nCount)
+{
+	size_t i = 0;
+	for (; i + 16 <= nCount; i += 16)
+	{
+		uint8x16x4_t c = vld4q_u8((const uint8_t *)(pBits + i));
+		uint8x16_t m = vld4q_u8((const uint8_t *)(pMask + i)).val[0];
+		for (int n = 0; n < 3; n++)
+			c.val[n] = MulDiv255_NEON(c.val[n], m);
+		vst4q_u8((uint8_t *)(pBits + i), c);
+	} //for
+	DarkenByMaskScalar(pBits + i, pMask + i, nCount - i);
+} //End DarkenByMaskNEON
+
+static size_t FindColorKeyNEON(const uint32_t * pBits, size_t nCount, uint32_t dwKey)
+{
+	const uint32x4_t key = vdupq_n_u32(dwKey);
+	size_t i = 0;
+	for (; i + 4 <= nCount; i += 4)
+	{
+		if (vmaxvq_u32(vceqq_u32(vld1q_u32(pBits + i), key)))
+			break;
+	} //for
+	return i + FindColorKeyScalar(pBits + i, nCount - i, dwKey);
+} //End FindColorKeyNEON
+
+static const CPPPixelOps::STRUCT_PIXELOPS g_opsNEON = {
+	BlendNEON, BlendOverNEON, PremultiplyNEON, GrayscaleNEON,
+	ScaleNEON, TintNEON, DarkenByMaskNEON, FindColorKeyNEON
+};
+#endif //PIXELOPS_ARM64
+
+//////////////////////////////////////////////////////////////////////
+// CPPPixelOps
+//////////////////////////////////////////////////////////////////////
+
+const CPPPixelOps::STRUCT_PIXELOPS * CPPPixelOps::m_pOps = NULL;
+int CPPPixelOps::m_nLevel = CPPPixelOps::PIXELOPS_SCALAR;
+
+int CPPPixelOps::GetBestLevel()
+{
+	//ENG: Probed once, by the first caller (thread-safe static)
+	static const int nBest = []
+	{
+		int nLevel = PIXELOPS_SCALAR;
+#if defined(PIXELOPS_X86) && defined(_MSC_VER)
+		int info[4];
+		__cpuid(info, 0);
+		int nIds = info[0];
+		__cpuid(info, 1);
+		if (info[3] & (1 << 26))
+			nLevel = PIXELOPS_SSE2;
+		//ENG: AVX2 also needs the OS to save the YMM registers
+		bool bAVX = (info[2] & (1 << 27)) && (info[2] & (1 << 28)) && ((_xgetbv(0) & 6) == 6);
+		if (bAVX && nIds >= 7)
+		{
+			__cpuidex(info, 7, 0);
+			if (info[1] & (1 << 5))
+				nLevel = PIXELOPS_AVX2;
+		}
+#elif defined(PIXELOPS_X86)
+		__builtin_cpu_init();
+		if (__builtin_cpu_supports("sse2"))
+			nLevel = PIXELOPS_SSE2;
+		if (__builtin_cpu_supports("avx2"))
+			nLevel = PIXELOPS_AVX2;
+#elif defined(PIXELOPS_ARM64)
+		nLevel = PIXELOPS_NEON;
+#endif
+		return nLevel;
+	}();
+	return nBest;
+} //End GetBestLevel
+
+int CPPPixelOps::SetLevel(int nLevel)
+{
+	int nBest = GetBestLevel();
+	if (nLevel > nBest || (nLevel == PIXELOPS_NEON) != (nBest == PIXELOPS_NEON))
+		nLevel = nBest;
+
+	switch (nLevel)
+	{
+#ifdef PIXELOPS_X86
+	case PIXELOPS_SSE2:
+		m_pOps = &g_opsSSE2;
+		break;
+	case PIXELOPS_AVX2:
+		m_pOps = &g_opsAVX2;
+		break;
+#endif
+#ifdef PIXELOPS_ARM64
+	case PIXELOPS_NEON:
+		m_pOps = &g_opsNEON;
+		break;
+#endif
+	default:
+		nLevel = PIXELOPS_SCALAR;
+		m_pOps = &g_opsScalar;
+		break;
+	} //switch
+	m_nLevel = nLevel;
+	return m_nLevel;
+} //End SetLevel
+
+int CPPPixelOps::GetLevel()
+{
+	GetOps();
+	return m_nLevel;
+} //End GetLevel
+
+const CPPPixelOps::STRUCT_PIXELOPS & CPPPixelOps::GetOps()
+{
+	if (m_pOps == NULL)
+		SetLevel(GetBestLevel());
+	return *m_pOps;
+} //End GetOps
+
+void CPPPixelOps::Blend(uint32_t * pDest, const uint32_t * pSrc, size_t nCount, uint8_t nAlpha)
+{
+	GetOps().pfnBlend(pDest, pSrc, nCount, nAlpha);
+} //End Blend
+
+void CPPPixelOps::BlendOver(uint32_t * pDest, const uint32_t * pSrc, size_t nCount)
+{
+	GetOps().pfnBlendOver(pDest, pSrc, nCount);
+} //End BlendOver
+
+void CPPPixelOps::Premultiply(uint32_t * pBits, size_t nCount)
+{
+	GetOps().pfnPremultiply(pBits, nCount);
+} //End Premultiply
+
+void CPPPixelOps::Grayscale(uint32_t * pBits, size_t nCount)
+{
+	GetOps().pfnGrayscale(pBits, nCount);
+} //End Grayscale
+
+void CPPPixelOps::Scale(uint32_t * pBits, size_t nCount, unsigned int nScale)
+{
+	if (nScale > 1024)
+		nScale = 1024;
+	GetOps().pfnScale(pBits, nCount, nScale);
+} //End Scale
+
+void CPPPixelOps::Tint(uint32_t * pBits, size_t nCount, uint32_t dwColor, uint8_t nAlpha)
+{
+	GetOps().pfnTint(pBits, nCount, dwColor, nAlpha);
+} //End Tint
+
+void CPPPixelOps::Invert(uint32_t * pBits, size_t nCount)
+{
+	//ENG: a plain XOR, which compilers vectorize on their own
+	for (size_t i = 0; i < nCount; i++)
+		pBits[i] ^= PIXEL_COLOR;
+} //End Invert
+
+void CPPPixelOps::DarkenByMask(uint32_t * pBits, const uint32_t * pMask, size_t nCount)
+{
+	GetOps().pfnDarkenByMask(pBits, pMask, nCount);
+} //End DarkenByMask
+
+size_t CPPPixelOps::FindColorKey(const uint32_t * pBits, size_t nCount, uint32_t dwKey)
+{
+	return GetOps().pfnFindColorKey(pBits, nCount, dwKey);
+} //End FindColorKey
+
+bool CPPPixelOps::HasAlpha(const uint32_t * pBits, size_t nCount)
+{
+	uint32_t dwAlpha = 0;
+	for (size_t i = 0; i < nCount; i++)
+		dwAlpha |= pBits[i];
+	return (dwAlpha & PIXEL_ALPHA) != 0;
+} //End HasAlpha
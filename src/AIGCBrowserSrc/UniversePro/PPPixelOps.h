@@ -0,0 +1,93 @@
+/********************************************************************************
+ *           Web Runtime for Application - Version 1.0.0.202203120001           *
+ ********************************************************************************
+ * Copyright (C) 2002-2021 by Tangram Team.   All Rights Reserved.
+ * There are Three Key Features of Webruntime:
+ * 1. Built-in Modern Web Browser: Independent Browser Window and Browser Window
+ *    as sub windows of other windows are supported in the application process;
+ * 2. DOM Plus: DOMPlus is a natural extension of the standard DOM system.
+ *    It allows the application system to support a kind of generalized web pages,
+ *    which are composed of standard DOM elements and binary components supported
+ *    by the application system;
+ * 3. JavaScript for Application: Similar to VBA in MS office, JavaScript will
+ *    become a built-in programmable language in the application system, so that
+ *    the application system can be expanded and developed for the Internet based
+ *    on modern javscript/Web technology.
+ * Use of this source code is governed by a BSD-style license that
+ * can be found in the LICENSE file.
+ *
+ * CONTACT INFORMATION:
+ * mailto:tangramteam@outlook.com or mailto:sunhuizlz@yeah.net
+ * https://www.webruntime.com
+ *******************************************************************************/
+
+// PPPixelOps.h : per-pixel operations for CPPDrawManager
+//
+// The loops CPPDrawManager runs over its 32-bit DIB sections, on plain
+// buffers of BGRA pixels (byte 0 is blue, byte 3 alpha). Every operation
+// has a scalar version, which is the reference, and SSE2, AVX2 or NEON
+// versions that give exactly the same bytes; the best one the CPU supports
+// is picked on first use. All arithmetic is integer, a product of two
+// channels is divided by 255 rounding down.
+
+#pragma once
+
+#pragma warning(push, 3)
+#include <stddef.h>
+#include <stdint.h>
+#pragma warning(pop)
+
+class CPPPixelOps
+{
+public:
+	enum {	PIXELOPS_SCALAR = 0,
+			PIXELOPS_SSE2,
+			PIXELOPS_AVX2,
+			PIXELOPS_NEON
+		};
+
+	//ENG: The instruction set in use, and the best one this CPU has
+	static int GetLevel();
+	static int GetBestLevel();
+	//ENG: Forces a level, e.g. the scalar reference; a level the CPU does
+	//     not have falls back to the best one. Returns the level now in use
+	static int SetLevel(int nLevel);
+
+	//ENG: pDest = pSrc * nAlpha + pDest * (255 - nAlpha), all four channels
+	static void Blend(uint32_t * pDest, const uint32_t * pSrc, size_t nCount, uint8_t nAlpha);
+	//ENG: pDest = pSrc + pDest * (255 - alpha of pSrc), pSrc premultiplied
+	static void BlendOver(uint32_t * pDest, const uint32_t * pSrc, size_t nCount);
+	//ENG: Multiplies the color channels by the pixel's own alpha
+	static void Premultiply(uint32_t * pBits, size_t nCount);
+	//ENG: R = G = B = (77 * R + 150 * G + 29 * B) / 256, alpha is kept
+	static void Grayscale(uint32_t * pBits, size_t nCount);
+	//ENG: Color channels times nScale / 256 (0 - 1024), saturated; 192
+	//     darkens by a quarter, 320 lightens by a quarter
+	static void Scale(uint32_t * pBits, size_t nCount, unsigned int nScale);
+	//ENG: Moves the color channels towards the BGR of dwColor by nAlpha
+	static void Tint(uint32_t * pBits, size_t nCount, uint32_t dwColor, uint8_t nAlpha);
+	static void Invert(uint32_t * pBits, size_t nCount);
+	//ENG: Color channels times the gray level of the mask (its byte 0)
+	static void DarkenByMask(uint32_t * pBits, const uint32_t * pMask, size_t nCount);
+	//ENG: Index of the first pixel equal to dwKey, nCount if there is none
+	static size_t FindColorKey(const uint32_t * pBits, size_t nCount, uint32_t dwKey);
+	static bool HasAlpha(const uint32_t * pBits, size_t nCount);
+
+	//ENG: One set of kernels, per instruction set
+	typedef struct _STRUCT_PIXELOPS
+	{
+		void (*pfnBlend)(uint32_t *, const uint32_t *, size_t, uint8_t);
+		void (*pfnBlendOver)(uint32_t *, const uint32_t *, size_t);
+		void (*pfnPremultiply)(uint32_t *, size_t);
+		void (*pfnGrayscale)(uint32_t *, size_t);
+		void (*pfnScale)(uint32_t *, size_t, unsigned int);
+		void (*pfnTint)(uint32_t *, size_t, uint32_t, uint8_t);
+		void (*pfnDarkenByMask)(uint32_t *, const uint32_t *, size_t);
+		size_t (*pfnFindColorKey)(const uint32_t *, size_t, uint32_t);
+	} STRUCT_PIXELOPS;
+
+protected:
+	static const STRUCT_PIXELOPS & GetOps();
+	static const STRUCT_PIXELOPS * m_pOps;
+	static int m_nLevel;
+};
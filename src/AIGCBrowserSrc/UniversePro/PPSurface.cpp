@@ -0,0 +1,1337 @@
+/********************************************************************************
+ *           Web Runtime for Application - Version 1.0.0.202203120001           *
+ ********************************************************************************
+ * Copyright (C) 2002-2021 by Tangram Team.   All Rights Reserved.
+ * There are Three Key Features of Webruntime:
+ * 1. Built-in Modern Web Browser: Independent Browser Window and Browser Window
+ *    as sub windows of other windows are supported in the application process;
+ * 2. DOM Plus: DOMPlus is a natural extension of the standard DOM system.
+ *    It allows the application system to support a kind of generalized web pages,
+ *    which are composed of standard DOM elements and binary components supported
+ *    by the application system;
+ * 3. JavaScript for Application: Similar to VBA in MS office, JavaScript will
+ *    become a built-in programmable language in the application system, so that
+ *    the application system can be expanded and developed for the Internet based
+ *    on modern javscript/Web technology.
+ * Use of this source code is governed by a BSD-style license that
+ * can be found in the LICENSE file.
+ *
+ * CONTACT INFORMATION:
+ * mailto:tangramteam@outlook.com or mailto:sunhuizlz@yeah.net
+ * https://www.webruntime.com
+ *******************************************************************************/
+
+// PPSurface.cpp : 32-bit premultiplied ARGB surface
+
+#include "stdafx.h"
+#include "PPSurface.h"
+#include "PPPixelOps.h"
+
+#pragma warning(push, 3)
+#include <stdio.h>
+#include <string.h>
+#pragma warning(pop)
+
+//ENG: Larger images are refused by the decoders
+#define PPSURFACE_MAX_PIXELS	(1 << 26)
+
+//////////////////////////////////////////////////////////////////////
+// CPPSurface
+//////////////////////////////////////////////////////////////////////
+
+CPPSurface::CPPSurface()
+{
+	m_pBits = NULL;
+	m_nWidth = 0;
+	m_nHeight = 0;
+	m_nStride = 0;
+} //End CPPSurface
+
+bool CPPSurface::Create(int nWidth, int nHeight)
+{
+	Destroy();
+	if ((nWidth <= 0) || (nHeight <= 0) || ((int64_t)nWidth * nHeight > PPSURFACE_MAX_PIXELS))
+		return false;
+
+	m_pStorage = std::make_shared<std::vector<uint32_t> >((size_t)nWidth * nHeight, 0);
+	m_pBits = &(*m_pStorage)[0];
+	m_nWidth = nWidth;
+	m_nHeight = nHeight;
+	m_nStride = nWidth;
+	return true;
+} //End Create
+
+void CPPSurface::Attach(uint32_t * pBits, int nWidth, int nHeight, ptrdiff_t nStride)
+{
+	Destroy();
+	if ((NULL == pBits) || (nWidth <= 0) || (nHeight <= 0))
+		return;
+
+	m_pBits = pBits;
+	m_nWidth = nWidth;
+	m_nHeight = nHeight;
+	m_nStride = nStride;
+} //End Attach
+
+void CPPSurface::Destroy()
+{
+	m_pStorage.reset();
+	m_pBits = NULL;
+	m_nWidth = 0;
+	m_nHeight = 0;
+	m_nStride = 0;
+} //End Destroy
+
+uint32_t CPPSurface::GetPixel(int x, int y) const
+{
+	if ((x < 0) || (y < 0) || (x >= m_nWidth) || (y >= m_nHeight))
+		return 0;
+	return GetRow(y)[x];
+} //End GetPixel
+
+void CPPSurface::SetPixel(int x, int y, uint32_t dwPixel)
+{
+	if ((x < 0) || (y < 0) || (x >= m_nWidth) || (y >= m_nHeight))
+		return;
+	GetRow(y)[x] = dwPixel;
+} //End SetPixel
+
+CPPSurface CPPSurface::GetView(int x, int y, int nWidth, int nHeight) const
+{
+	CPPSurface view;
+	if (x < 0) { nWidth += x; x = 0; }
+	if (y < 0) { nHeight += y; y = 0; }
+	if (nWidth > m_nWidth - x) nWidth = m_nWidth - x;
+	if (nHeight > m_nHeight - y) nHeight = m_nHeight - y;
+	if (IsEmpty() || (nWidth <= 0) || (nHeight <= 0))
+		return view;
+
+	view.m_pStorage = m_pStorage;
+	view.m_pBits = m_pBits + y * m_nStride + x;
+	view.m_nWidth = nWidth;
+	view.m_nHeight = nHeight;
+	view.m_nStride = m_nStride;
+	return view;
+} //End GetView
+
+CPPSurface CPPSurface::Clone() const
+{
+	CPPSurface copy;
+	if (copy.Create(m_nWidth, m_nHeight))
+		copy.Copy(*this, 0, 0);
+	return copy;
+} //End Clone
+
+void CPPSurface::Fill(uint32_t dwPixel)
+{
+	for (int y = 0; y < m_nHeight; y++)
+	{
+		uint32_t * pRow = GetRow(y);
+		for (int x = 0; x < m_nWidth; x++)
+			pRow[x] = dwPixel;
+	} //for
+} //End Fill
+
+void CPPSurface::Copy(const CPPSurface & src, int x, int y)
+{
+	CPPSurface dest = GetView(x, y, src.m_nWidth, src.m_nHeight);
+	if (dest.IsEmpty())
+		return;
+	//ENG: Skips the part of src that was clipped on the top or the left
+	CPPSurface from = src.GetView(x < 0 ? -x : 0, y < 0 ? -y : 0, dest.m_nWidth, dest.m_nHeight);
+	for (int nRow = 0; nRow < from.m_nHeight; nRow++)
+		memmove(dest.GetRow(nRow), from.GetRow(nRow), from.m_nWidth * sizeof(uint32_t));
+} //End Copy
+
+void CPPSurface::Blend(const CPPSurface & src, int x, int y)
+{
+	CPPSurface dest = GetView(x, y, src.m_nWidth, src.m_nHeight);
+	if (dest.IsEmpty())
+		return;
+	CPPSurface from = src.GetView(x < 0 ? -x : 0, y < 0 ? -y : 0, dest.m_nWidth, dest.m_nHeight);
+	for (int nRow = 0; nRow < from.m_nHeight; nRow++)
+		CPPPixelOps::BlendOver(dest.GetRow(nRow), from.GetRow(nRow), from.m_nWidth);
+} //End Blend
+
+uint32_t CPPSurface::Premultiply(uint32_t dwPixel)
+{
+	uint32_t a = dwPixel >> 24;
+	uint32_t dwResult = dwPixel & 0xFF000000;
+	for (int nShift = 0; nShift < 24; nShift += 8)
+	{
+		uint32_t c = ((dwPixel >> nShift) & 0xFF) * a;
+		dwResult |= ((c + 1 + (c >> 8)) >> 8) << nShift;
+	} //for
+	return dwResult;
+} //End Premultiply
+
+uint32_t CPPSurface::Unpremultiply(uint32_t dwPixel)
+{
+	uint32_t a = dwPixel >> 24;
+	if (0 == a)
+		return 0;
+	if (255 == a)
+		return dwPixel;
+
+	uint32_t dwResult = dwPixel & 0xFF000000;
+	for (int nShift = 0; nShift < 24; nShift += 8)
+	{
+		uint32_t c = (((dwPixel >> nShift) & 0xFF) * 255 + a / 2) / a;
+		dwResult |= (c > 255 ? 255 : c) << nShift;
+	} //for
+	return dwResult;
+} //End Unpremultiply
+
+//////////////////////////////////////////////////////////////////////
+// zlib streams
+//////////////////////////////////////////////////////////////////////
+
+static uint32_t Crc32(uint32_t dwCrc, const uint8_t * pData, size_t nSize)
+{
+	static uint32_t table[256];
+	static bool bTable = false;
+	if (!bTable)
+	{
+		for (uint32_t n = 0; n < 256; n++)
+		{
+			uint32_t c = n;
+			for (int k = 0; k < 8; k++)
+				c = (c & 1) ? 0xEDB88320 ^ (c >> 1) : c >> 1;
+			table[n] = c;
+		} //for
+		bTable = true;
+	} //if
+
+	dwCrc ^= 0xFFFFFFFF;
+	for (size_t i = 0; i < nSize; i++)
+		dwCrc = table[(dwCrc ^ pData[i]) & 0xFF] ^ (dwCrc >> 8);
+	return dwCrc ^ 0xFFFFFFFF;
+} //End Crc32
+
+static uint32_t Adler32(const uint8_t * pData, size_t nSize)
+{
+	uint32_t a = 1, b = 0;
+	while (nSize)
+	{
+		//ENG: 5552 bytes cannot overflow before the modulo
+		size_t nBlock = nSize < 5552 ? nSize : 5552;
+		nSize -= nBlock;
+		while (nBlock--)
+		{
+			a += *pData++;
+			b += a;
+		} //while
+		a %= 65521;
+		b %= 65521;
+	} //while
+	return (b << 16) | a;
+} //End Adler32
+
+static const short s_nLengthBase[29] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+static const short s_nLengthExtra[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+static const short s_nDistBase[30] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+static const short s_nDistExtra[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+typedef struct _STRUCT_HUFFMAN
+{
+	short count[16];		// Codes of each length
+	short symbol[288];		// Symbols ordered by code
+} STRUCT_HUFFMAN;
+
+typedef struct _STRUCT_INFLATE
+{
+	const uint8_t * pIn;
+	size_t nIn;
+	size_t nPos;
+	uint32_t dwBits;
+	int nBits;
+	std::vector<uint8_t> * pOut;
+	size_t nMaxOut;
+} STRUCT_INFLATE;
+
+//ENG: The next nNeed bits, -1 at the end of the input
+static int GetBits(STRUCT_INFLATE & s, int nNeed)
+{
+	uint32_t dwValue = s.dwBits;
+	while (s.nBits < nNeed)
+	{
+		if (s.nPos >= s.nIn)
+			return -1;
+		dwValue |= (uint32_t)s.pIn[s.nPos++] << s.nBits;
+		s.nBits += 8;
+	} //while
+	s.dwBits = dwValue >> nNeed;
+	s.nBits -= nNeed;
+	return (int)(dwValue & ((1u << nNeed) - 1));
+} //End GetBits
+
+//ENG: Canonical code from code lengths. Returns 0 for a complete code, more
+//     for an incomplete one and less than 0 for one that is oversubscribed
+static int BuildHuffman(STRUCT_HUFFMAN & h, const short * pLengths, int nSymbols)
+{
+	short offs[16];
+	for (int nLen = 0; nLen < 16; nLen++)
+		h.count[nLen] = 0;
+	for (int nSym = 0; nSym < nSymbols; nSym++)
+		h.count[pLengths[nSym]]++;
+	if (h.count[0] == nSymbols)
+		return 0;
+
+	int nLeft = 1;
+	for (int nLen = 1; nLen < 16; nLen++)
+	{
+		nLeft <<= 1;
+		nLeft -= h.count[nLen];
+		if (nLeft < 0)
+			return nLeft;
+	} //for
+
+	offs[1] = 0;
+	for (int nLen = 1; nLen < 15; nLen++)
+		offs[nLen + 1] = offs[nLen] + h.count[nLen];
+	for (int nSym = 0; nSym < nSymbols; nSym++)
+	{
+		if (pLengths[nSym])
+			h.symbol[offs[pLengths[nSym]]++] = (short)nSym;
+	} //for
+	return nLeft;
+} //End BuildHuffman
+
+static int DecodeSymbol(STRUCT_INFLATE & s, const STRUCT_HUFFMAN & h)
+{
+	int nCode = 0, nFirst = 0, nIndex = 0;
+	for (int nLen = 1; nLen < 16; nLen++)
+	{
+		int nBit = GetBits(s, 1);
+		if (nBit < 0)
+			return -1;
+		nCode |= nBit;
+		int nCount = h.count[nLen];
+		if (nCode - nCount < nFirst)
+			return h.symbol[nIndex + (nCode - nFirst)];
+		nIndex += nCount;
+		nFirst += nCount;
+		nFirst <<= 1;
+		nCode <<= 1;
+	} //for
+	return -1;
+} //End DecodeSymbol
+
+static bool InflateCodes(STRUCT_INFLATE & s, const STRUCT_HUFFMAN & lencode, const STRUCT_HUFFMAN & distcode)
+{
+	std::vector<uint8_t> & out = *s.pOut;
+	for (;;)
+	{
+		int nSym = DecodeSymbol(s, lencode);
+		if (nSym < 0)
+			return false;
+		if (nSym < 256)
+		{
+			if (out.size() >= s.nMaxOut)
+				return false;
+			out.push_back((uint8_t)nSym);
+			continue;
+		} //if
+		if (256 == nSym)
+			return true;
+
+		nSym -= 257;
+		if (nSym >= 29)
+			return false;
+		int nExtra = GetBits(s, s_nLengthExtra[nSym]);
+		if (nExtra < 0)
+			return false;
+		size_t nLength = s_nLengthBase[nSym] + nExtra;
+
+		nSym = DecodeSymbol(s, distcode);
+		if ((nSym < 0) || (nSym >= 30))
+			return false;
+		nExtra = GetBits(s, s_nDistExtra[nSym]);
+		if (nExtra < 0)
+			return false;
+		size_t nDist = s_nDistBase[nSym] + nExtra;
+
+		if ((nDist > out.size()) || (out.size() + nLength > s.nMaxOut))
+			return false;
+		//ENG: Byte by byte, the copy may overlap what it writes
+		size_t nFrom = out.size() - nDist;
+		for (size_t i = 0; i < nLength; i++)
+			out.push_back(out[nFrom + i]);
+	} //for
+} //End InflateCodes
+
+static bool InflateStored(STRUCT_INFLATE & s)
+{
+	//ENG: A stored block starts on a byte boundary
+	s.dwBits = 0;
+	s.nBits = 0;
+	if (s.nPos + 4 > s.nIn)
+		return false;
+	size_t nLength = s.pIn[s.nPos] | (s.pIn[s.nPos + 1] << 8);
+	size_t nCheck = s.pIn[s.nPos + 2] | (s.pIn[s.nPos + 3] << 8);
+	s.nPos += 4;
+	if ((nLength != (~nCheck & 0xFFFF)) || (s.nPos + nLength > s.nIn) || (s.pOut->size() + nLength > s.nMaxOut))
+		return false;
+	s.pOut->insert(s.pOut->end(), s.pIn + s.nPos, s.pIn + s.nPos + nLength);
+	s.nPos += nLength;
+	return true;
+} //End InflateStored
+
+static bool InflateFixed(STRUCT_INFLATE & s)
+{
+	static STRUCT_HUFFMAN lencode, distcode;
+	static bool bBuilt = false;
+	if (!bBuilt)
+	{
+		short lengths[288];
+		int nSym = 0;
+		for (; nSym < 144; nSym++) lengths[nSym] = 8;
+		for (; nSym < 256; nSym++) lengths[nSym] = 9;
+		for (; nSym < 280; nSym++) lengths[nSym] = 7;
+		for (; nSym < 288; nSym++) lengths[nSym] = 8;
+		BuildHuffman(lencode, lengths, 288);
+		for (nSym = 0; nSym < 30; nSym++) lengths[nSym] = 5;
+		BuildHuffman(distcode, lengths, 30);
+		bBuilt = true;
+	} //if
+	return InflateCodes(s, lencode, distcode);
+} //End InflateFixed
+
+static bool InflateDynamic(STRUCT_INFLATE & s)
+{
+	static const short order[19] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+	short lengths[320];
+	STRUCT_HUFFMAN lencode, distcode;
+
+	int nLen = GetBits(s, 5);
+	int nDist = GetBits(s, 5);
+	int nCode = GetBits(s, 4);
+	if ((nLen < 0) || (nDist < 0) || (nCode < 0))
+		return false;
+	nLen += 257;
+	nDist += 1;
+	nCode += 4;
+	if ((nLen > 286) || (nDist > 30))
+		return false;
+
+	int nIndex = 0;
+	for (; nIndex < nCode; nIndex++)
+	{
+		int nBits = GetBits(s, 3);
+		if (nBits < 0)
+			return false;
+		lengths[order[nIndex]] = (short)nBits;
+	} //for
+	for (; nIndex < 19; nIndex++)
+		lengths[order[nIndex]] = 0;
+	if (BuildHuffman(lencode, lengths, 19) != 0)
+		return false;
+
+	nIndex = 0;
+	while (nIndex < nLen + nDist)
+	{
+		int nSym = DecodeSymbol(s, lencode);
+		if (nSym < 0)
+			return false;
+		if (nSym < 16)
+		{
+			lengths[nIndex++] = (short)nSym;
+			continue;
+		} //if
+
+		short nRepeat = 0;
+		int nCount;
+		if (16 == nSym)
+		{
+			if (0 == nIndex)
+				return false;
+			nRepeat = lengths[nIndex - 1];
+			nCount = GetBits(s, 2);
+			nCount = (nCount < 0) ? -1 : 3 + nCount;
+		}
+		else if (17 == nSym)
+		{
+			nCount = GetBits(s, 3);
+			nCount = (nCount < 0) ? -1 : 3 + nCount;
+		}
+		else
+		{
+			nCount = GetBits(s, 7);
+			nCount = (nCount < 0) ? -1 : 11 + nCount;
+		} //if
+		if ((nCount < 0) || (nIndex + nCount > nLen + nDist))
+			return false;
+		while (nCount--)
+			lengths[nIndex++] = nRepeat;
+	} //while
+
+	//ENG: Without an end-of-block code the block could not end
+	if (0 == lengths[256])
+		return false;
+	int nErr = BuildHuffman(lencode, lengths, nLen);
+	if ((nErr < 0) || ((nErr > 0) && (nLen - lencode.count[0] != 1)))
+		return false;
+	nErr = BuildHuffman(distcode, lengths + nLen, nDist);
+	if ((nErr < 0) || ((nErr > 0) && (nDist - distcode.count[0] != 1)))
+		return false;
+
+	return InflateCodes(s, lencode, distcode);
+} //End InflateDynamic
+
+//ENG: Unpacks a zlib stream of at most nMaxOut bytes
+static bool ZlibInflate(const uint8_t * pIn, size_t nIn, std::vector<uint8_t> & vOut, size_t nMaxOut)
+{
+	if ((nIn < 2) || ((pIn[0] & 0x0F) != 8) || ((pIn[0] >> 4) > 7) || ((pIn[0] * 256 + pIn[1]) % 31) || (pIn[1] & 0x20))
+		return false;
+
+	STRUCT_INFLATE s;
+	s.pIn = pIn;
+	s.nIn = nIn;
+	s.nPos = 2;
+	s.dwBits = 0;
+	s.nBits = 0;
+	s.pOut = &vOut;
+	s.nMaxOut = nMaxOut;
+
+	int nLast;
+	do
+	{
+		nLast = GetBits(s, 1);
+		int nType = GetBits(s, 2);
+		if ((nLast < 0) || (nType < 0))
+			return false;
+		bool bResult = false;
+		switch (nType)
+		{
+		case 0: bResult = InflateStored(s); break;
+		case 1: bResult = InflateFixed(s); break;
+		case 2: bResult = InflateDynamic(s); break;
+		} //switch
+		if (!bResult)
+			return false;
+	} while (!nLast);
+
+	//ENG: The Adler-32 of the data follows on a byte boundary
+	if (s.nPos + 4 > s.nIn)
+		return false;
+	const uint8_t * p = s.pIn + s.nPos;
+	uint32_t dwAdler = ((uint32_t)p[0] << 24) | (p[1] << 16) | (p[2] << 8) | p[3];
+	return vOut.empty() ? (1 == dwAdler) : (Adler32(&vOut[0], vOut.size()) == dwAdler);
+} //End ZlibInflate
+
+typedef struct _STRUCT_BITWRITER
+{
+	std::vector<uint8_t> * pOut;
+	uint32_t dwBits;
+	int nBits;
+} STRUCT_BITWRITER;
+
+static void PutBits(STRUCT_BITWRITER & w, uint32_t dwValue, int nCount)
+{
+	w.dwBits |= dwValue << w.nBits;
+	w.nBits += nCount;
+	while (w.nBits >= 8)
+	{
+		w.pOut->push_back((uint8_t)w.dwBits);
+		w.dwBits >>= 8;
+		w.nBits -= 8;
+	} //while
+} //End PutBits
+
+//ENG: Huffman codes go out starting with their most significant bit
+static void PutCode(STRUCT_BITWRITER & w, uint32_t dwCode, int nLen)
+{
+	uint32_t dwReversed = 0;
+	for (int i = 0; i < nLen; i++)
+		dwReversed |= ((dwCode >> i) & 1) << (nLen - 1 - i);
+	PutBits(w, dwReversed, nLen);
+} //End PutCode
+
+static void PutFixedSymbol(STRUCT_BITWRITER & w, int nSym)
+{
+	if (nSym < 144)
+		PutCode(w, 0x30 + nSym, 8);
+	else if (nSym < 256)
+		PutCode(w, 0x190 + nSym - 144, 9);
+	else if (nSym < 280)
+		PutCode(w, nSym - 256, 7);
+	else
+		PutCode(w, 0xC0 + nSym - 280, 8);
+} //End PutFixedSymbol
+
+//ENG: Packs data as a zlib stream of one block with the fixed codes; the
+//     matches come from hash chains over the last 32K
+static void ZlibDeflate(const uint8_t * pIn, size_t nIn, std::vector<uint8_t> & vOut)
+{
+	const int nHashSize = 1 << 15;
+	const int nMaxChain = 32;
+
+	vOut.push_back(0x78);
+	vOut.push_back(0x01);
+
+	STRUCT_BITWRITER w;
+	w.pOut = &vOut;
+	w.dwBits = 0;
+	w.nBits = 0;
+	PutBits(w, 1, 1);		// The last block
+	PutBits(w, 1, 2);		// Fixed codes
+
+	std::vector<int> head(nHashSize, -1);
+	std::vector<int> prev(nIn > 0 ? nIn : 1, -1);
+	size_t i = 0;
+	while (i < nIn)
+	{
+		size_t nBest = 0, nBestDist = 0;
+		int nHash = 0;
+		if (i + 3 <= nIn)
+		{
+			nHash = ((pIn[i] << 10) ^ (pIn[i + 1] << 5) ^ pIn[i + 2]) & (nHashSize - 1);
+			size_t nMax = (nIn - i < 258) ? nIn - i : 258;
+			int nChain = nMaxChain;
+			for (int nPos = head[nHash]; (nPos >= 0) && (i - nPos <= 32768) && nChain--; nPos = prev[nPos])
+			{
+				size_t nLen = 0;
+				while ((nLen < nMax) && (pIn[nPos + nLen] == pIn[i + nLen]))
+					nLen++;
+				if (nLen > nBest)
+				{
+					nBest = nLen;
+					nBestDist = i - nPos;
+					if (nLen == nMax)
+						break;
+				} //if
+			} //for
+			prev[i] = head[nHash];
+			head[nHash] = (int)i;
+		} //if
+
+		if (nBest < 3)
+		{
+			PutFixedSymbol(w, pIn[i]);
+			i++;
+			continue;
+		} //if
+
+		int nCode = 28;
+		while (s_nLengthBase[nCode] > (int)nBest)
+			nCode--;
+		PutFixedSymbol(w, 257 + nCode);
+		PutBits(w, (uint32_t)(nBest - s_nLengthBase[nCode]), s_nLengthExtra[nCode]);
+		nCode = 29;
+		while (s_nDistBase[nCode] > (int)nBestDist)
+			nCode--;
+		PutCode(w, nCode, 5);
+		PutBits(w, (uint32_t)(nBestDist - s_nDistBase[nCode]), s_nDistExtra[nCode]);
+
+		//ENG: The bytes inside the match can start later matches
+		for (size_t k = 1; k < nBest; k++)
+		{
+			size_t j = i + k;
+			if (j + 3 > nIn)
+				break;
+			nHash = ((pIn[j] << 10) ^ (pIn[j + 1] << 5) ^ pIn[j + 2]) & (nHashSize - 1);
+			prev[j] = head[nHash];
+			head[nHash] = (int)j;
+		} //for
+		i += nBest;
+	} //while
+	PutFixedSymbol(w, 256);
+	if (w.nBits)
+		PutBits(w, 0, 8 - w.nBits);
+
+	uint32_t dwAdler = Adler32(pIn, nIn);
+	vOut.push_back((uint8_t)(dwAdler >> 24));
+	vOut.push_back((uint8_t)(dwAdler >> 16));
+	vOut.push_back((uint8_t)(dwAdler >> 8));
+	vOut.push_back((uint8_t)dwAdler);
+} //End ZlibDeflate
+
+//////////////////////////////////////////////////////////////////////
+// PNG
+//////////////////////////////////////////////////////////////////////
+
+static const uint8_t s_PngSignature[8] = {0x89, 'P', 'N', 'G', 0x0D, 0x0A, 0x1A, 0x0A};
+
+static uint32_t ReadBE32(const uint8_t * p)
+{
+	return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+} //End ReadBE32
+
+static void WriteBE32(std::vector<uint8_t> & vData, uint32_t dwValue)
+{
+	vData.push_back((uint8_t)(dwValue >> 24));
+	vData.push_back((uint8_t)(dwValue >> 16));
+	vData.push_back((uint8_t)(dwValue >> 8));
+	vData.push_back((uint8_t)dwValue);
+} //End WriteBE32
+
+//ENG: Sample nIndex of a row of nDepth bit samples
+static unsigned int ReadSample(const uint8_t * pRow, int nIndex, int nDepth)
+{
+	if (8 == nDepth)
+		return pRow[nIndex];
+	if (16 == nDepth)
+		return (pRow[nIndex * 2] << 8) | pRow[nIndex * 2 + 1];
+	int nBit = nIndex * nDepth;
+	return (pRow[nBit >> 3] >> (8 - nDepth - (nBit & 7))) & ((1 << nDepth) - 1);
+} //End ReadSample
+
+static uint8_t PaethPredictor(int a, int b, int c)
+{
+	int p = a + b - c;
+	int pa = p > a ? p - a : a - p;
+	int pb = p > b ? p - b : b - p;
+	int pc = p > c ? p - c : c - p;
+	if ((pa <= pb) && (pa <= pc))
+		return (uint8_t)a;
+	return (uint8_t)((pb <= pc) ? b : c);
+} //End PaethPredictor
+
+bool CPPSurface::LoadPNG(const uint8_t * pData, size_t nSize)
+{
+	Destroy();
+	if ((nSize < 8) || memcmp(pData, s_PngSignature, 8))
+		return false;
+
+	int nWidth = 0, nHeight = 0, nDepth = 0, nColorType = 0, nInterlace = 0;
+	uint32_t palette[256];
+	int nPalette = 0;
+	unsigned int trans[3] = {0, 0, 0};
+	bool bTrans = false;
+	std::vector<uint8_t> vCompressed;
+	bool bHeader = false, bEnd = false;
+
+	for (int nEntry = 0; nEntry < 256; nEntry++)
+		palette[nEntry] = 0xFF000000;
+
+	size_t nPos = 8;
+	while (!bEnd)
+	{
+		if (nPos + 12 > nSize)
+			return false;
+		uint32_t dwLength = ReadBE32(pData + nPos);
+		if (dwLength > nSize - nPos - 12)
+			return false;
+		const uint8_t * pType = pData + nPos + 4;
+		const uint8_t * pChunk = pType + 4;
+		if (Crc32(0, pType, dwLength + 4) != ReadBE32(pChunk + dwLength))
+			return false;
+		nPos += dwLength + 12;
+
+		if (!memcmp(pType, "IHDR", 4))
+		{
+			if ((dwLength != 13) || bHeader)
+				return false;
+			uint32_t dwWidth = ReadBE32(pChunk), dwHeight = ReadBE32(pChunk + 4);
+			if (!dwWidth || !dwHeight || (dwWidth > PPSURFACE_MAX_PIXELS) || (dwHeight > PPSURFACE_MAX_PIXELS) || 
+				((uint64_t)dwWidth * dwHeight > PPSURFACE_MAX_PIXELS))
+				return false;
+			nWidth = (int)dwWidth;
+			nHeight = (int)dwHeight;
+			nDepth = pChunk[8];
+			nColorType = pChunk[9];
+			nInterlace = pChunk[12];
+			bool bValid;
+			switch (nColorType)
+			{
+			case 0: bValid = (1 == nDepth) || (2 == nDepth) || (4 == nDepth) || (8 == nDepth) || (16 == nDepth); break;
+			case 3: bValid = (1 == nDepth) || (2 == nDepth) || (4 == nDepth) || (8 == nDepth); break;
+			case 2:
+			case 4:
+			case 6: bValid = (8 == nDepth) || (16 == nDepth); break;
+			default: bValid = false; break;
+			} //switch
+			if (!bValid || pChunk[10] || pChunk[11] || (nInterlace > 1))
+				return false;
+			bHeader = true;
+		}
+		else if (!bHeader)
+		{
+			return false;
+		}
+		else if (!memcmp(pType, "PLTE", 4))
+		{
+			if ((dwLength % 3) || (dwLength > 768))
+				return false;
+			nPalette = dwLength / 3;
+			for (int nEntry = 0; nEntry < nPalette; nEntry++)
+				palette[nEntry] = 0xFF000000 | (pChunk[nEntry * 3] << 16) | (pChunk[nEntry * 3 + 1] << 8) | pChunk[nEntry * 3 + 2];
+		}
+		else if (!memcmp(pType, "tRNS", 4))
+		{
+			if (3 == nColorType)
+			{
+				for (uint32_t nEntry = 0; (nEntry < dwLength) && (nEntry < 256); nEntry++)
+					palette[nEntry] = (palette[nEntry] & 0x00FFFFFF) | ((uint32_t)pChunk[nEntry] << 24);
+			}
+			else if ((0 == nColorType) && (dwLength >= 2))
+			{
+				trans[0] = (pChunk[0] << 8) | pChunk[1];
+				bTrans = true;
+			}
+			else if ((2 == nColorType) && (dwLength >= 6))
+			{
+				for (int n = 0; n < 3; n++)
+					trans[n] = (pChunk[n * 2] << 8) | pChunk[n * 2 + 1];
+				bTrans = true;
+			} //if
+		}
+		else if (!memcmp(pType, "IDAT", 4))
+		{
+			vCompressed.insert(vCompressed.end(), pChunk, pChunk + dwLength);
+		}
+		else if (!memcmp(pType, "IEND", 4))
+		{
+			bEnd = true;
+		} //if
+	} //while
+
+	if (!bHeader || vCompressed.empty() || ((3 == nColorType) && !nPalette))
+		return false;
+
+	static const int s_nChannels[7] = {1, 0, 3, 1, 2, 0, 4};
+	int nChannels = s_nChannels[nColorType];
+	int nPixelBytes = (nChannels * nDepth + 7) / 8;
+
+	//ENG: Adam7 passes, or the whole image as a single pass
+	static const int s_nStartX[7] = {0, 4, 0, 2, 0, 1, 0};
+	static const int s_nStartY[7] = {0, 0, 4, 0, 2, 0, 1};
+	static const int s_nStepX[7] = {8, 8, 4, 4, 2, 2, 1};
+	static const int s_nStepY[7] = {8, 8, 8, 4, 4, 2, 2};
+	int nPasses = nInterlace ? 7 : 1;
+	int nPassWidth[7], nPassHeight[7];
+	size_t nRawSize = 0;
+	for (int nPass = 0; nPass < nPasses; nPass++)
+	{
+		int nStartX = nInterlace ? s_nStartX[nPass] : 0, nStepX = nInterlace ? s_nStepX[nPass] : 1;
+		int nStartY = nInterlace ? s_nStartY[nPass] : 0, nStepY = nInterlace ? s_nStepY[nPass] : 1;
+		nPassWidth[nPass] = (nWidth > nStartX) ? (nWidth - nStartX + nStepX - 1) / nStepX : 0;
+		nPassHeight[nPass] = (nHeight > nStartY) ? (nHeight - nStartY + nStepY - 1) / nStepY : 0;
+		if (nPassWidth[nPass] && nPassHeight[nPass])
+			nRawSize += (size_t)nPassHeight[nPass] * (1 + ((size_t)nPassWidth[nPass] * nChannels * nDepth + 7) / 8);
+	} //for
+
+	std::vector<uint8_t> vRaw;
+	if (!ZlibInflate(&vCompressed[0], vCompressed.size(), vRaw, nRawSize) || (vRaw.size() != nRawSize))
+		return false;
+	if (!Create(nWidth, nHeight))
+		return false;
+
+	uint8_t * pRaw = &vRaw[0];
+	for (int nPass = 0; nPass < nPasses; nPass++)
+	{
+		if (!nPassWidth[nPass] || !nPassHeight[nPass])
+			continue;
+		int nStartX = nInterlace ? s_nStartX[nPass] : 0, nStepX = nInterlace ? s_nStepX[nPass] : 1;
+		int nStartY = nInterlace ? s_nStartY[nPass] : 0, nStepY = nInterlace ? s_nStepY[nPass] : 1;
+		size_t nRowBytes = ((size_t)nPassWidth[nPass] * nChannels * nDepth + 7) / 8;
+		std::vector<uint8_t> vZero(nRowBytes, 0);
+		const uint8_t * pPrev = &vZero[0];
+
+		for (int y = 0; y < nPassHeight[nPass]; y++)
+		{
+			int nFilter = *pRaw++;
+			uint8_t * pCur = pRaw;
+			for (size_t i = 0; i < nRowBytes; i++)
+			{
+				int a = (i >= (size_t)nPixelBytes) ? pCur[i - nPixelBytes] : 0;
+				int b = pPrev[i];
+				int c = (i >= (size_t)nPixelBytes) ? pPrev[i - nPixelBytes] : 0;
+				switch (nFilter)
+				{
+				case 0: break;
+				case 1: pCur[i] = (uint8_t)(pCur[i] + a); break;
+				case 2: pCur[i] = (uint8_t)(pCur[i] + b); break;
+				case 3: pCur[i] = (uint8_t)(pCur[i] + ((a + b) >> 1)); break;
+				case 4: pCur[i] = (uint8_t)(pCur[i] + PaethPredictor(a, b, c)); break;
+				default:
+					Destroy();
+					return false;
+				} //switch
+			} //for
+
+			uint32_t * pRow = GetRow(nStartY + y * nStepY);
+			for (int x = 0; x < nPassWidth[nPass]; x++)
+			{
+				unsigned int s[4];
+				for (int n = 0; n < nChannels; n++)
+					s[n] = ReadSample(pCur, x * nChannels + n, nDepth);
+
+				uint32_t dwPixel;
+				if (3 == nColorType)
+				{
+					if ((int)s[0] >= nPalette)
+					{
+						Destroy();
+						return false;
+					} //if
+					dwPixel = palette[s[0]];
+				}
+				else
+				{
+					bool bClear = bTrans && (s[0] == trans[0]) && ((0 == nColorType) || ((s[1] == trans[1]) && (s[2] == trans[2])));
+					//ENG: Samples to 8 bits
+					for (int n = 0; n < nChannels; n++)
+						s[n] = (16 == nDepth) ? s[n] >> 8 : (8 == nDepth) ? s[n] : s[n] * 255 / ((1 << nDepth) - 1);
+					switch (nColorType)
+					{
+					case 0: dwPixel = 0xFF000000 | (s[0] * 0x010101); break;
+					case 2: dwPixel = 0xFF000000 | (s[0] << 16) | (s[1] << 8) | s[2]; break;
+					case 4: dwPixel = (s[1] << 24) | (s[0] * 0x010101); break;
+					default: dwPixel = (s[3] << 24) | (s[0] << 16) | (s[1] << 8) | s[2]; break;
+					} //switch
+					if (bClear)
+						dwPixel &= 0x00FFFFFF;
+				} //if
+				pRow[nStartX + x * nStepX] = dwPixel;
+			} //for
+
+			pPrev = pCur;
+			pRaw += nRowBytes;
+		} //for
+	} //for
+
+	for (int y = 0; y < m_nHeight; y++)
+		CPPPixelOps::Premultiply(GetRow(y), m_nWidth);
+	return true;
+} //End LoadPNG
+
+static void WritePngChunk(std::vector<uint8_t> & vData, const char * pszType, const std::vector<uint8_t> & vChunk)
+{
+	WriteBE32(vData, (uint32_t)vChunk.size());
+	size_t nStart = vData.size();
+	vData.insert(vData.end(), pszType, pszType + 4);
+	vData.insert(vData.end(), vChunk.begin(), vChunk.end());
+	WriteBE32(vData, Crc32(0, &vData[nStart], vChunk.size() + 4));
+} //End WritePngChunk
+
+void CPPSurface::SavePNG(std::vector<uint8_t> & vData) const
+{
+	vData.clear();
+	if (IsEmpty())
+		return;
+
+	vData.insert(vData.end(), s_PngSignature, s_PngSignature + 8);
+	std::vector<uint8_t> vChunk;
+	WriteBE32(vChunk, m_nWidth);
+	WriteBE32(vChunk, m_nHeight);
+	vChunk.push_back(8);		// Bit depth
+	vChunk.push_back(6);		// RGBA
+	vChunk.push_back(0);
+	vChunk.push_back(0);
+	vChunk.push_back(0);		// Not interlaced
+	WritePngChunk(vData, "IHDR", vChunk);
+
+	//ENG: Each row gets the filter with the smallest sum of differences
+	size_t nRowBytes = (size_t)m_nWidth * 4;
+	std::vector<uint8_t> vRaw, vPrev(nRowBytes, 0), vCur(nRowBytes), vFiltered(nRowBytes), vBest(nRowBytes);
+	vRaw.reserve((nRowBytes + 1) * m_nHeight);
+	for (int y = 0; y < m_nHeight; y++)
+	{
+		const uint32_t * pRow = GetRow(y);
+		for (int x = 0; x < m_nWidth; x++)
+		{
+			uint32_t dwPixel = Unpremultiply(pRow[x]);
+			vCur[x * 4] = (uint8_t)(dwPixel >> 16);
+			vCur[x * 4 + 1] = (uint8_t)(dwPixel >> 8);
+			vCur[x * 4 + 2] = (uint8_t)dwPixel;
+			vCur[x * 4 + 3] = (uint8_t)(dwPixel >> 24);
+		} //for
+
+		int nBestFilter = 0;
+		size_t nBestSum = (size_t)-1;
+		for (int nFilter = 0; nFilter < 5; nFilter++)
+		{
+			size_t nSum = 0;
+			for (size_t i = 0; i < nRowBytes; i++)
+			{
+				int a = (i >= 4) ? vCur[i - 4] : 0;
+				int b = vPrev[i];
+				int c = (i >= 4) ? vPrev[i - 4] : 0;
+				int nPredict = 0;
+				switch (nFilter)
+				{
+				case 1: nPredict = a; break;
+				case 2: nPredict = b; break;
+				case 3: nPredict = (a + b) >> 1; break;
+				case 4: nPredict = PaethPredictor(a, b, c); break;
+				} //switch
+				uint8_t nValue = (uint8_t)(vCur[i] - nPredict);
+				vFiltered[i] = nValue;
+				nSum += (nValue < 128) ? nValue : 256 - nValue;
+			} //for
+			if (nSum < nBestSum)
+			{
+				nBestSum = nSum;
+				nBestFilter = nFilter;
+				vBest.swap(vFiltered);
+			} //if
+		} //for
+
+		vRaw.push_back((uint8_t)nBestFilter);
+		vRaw.insert(vRaw.end(), vBest.begin(), vBest.end());
+		vPrev.swap(vCur);
+	} //for
+
+	vChunk.clear();
+	ZlibDeflate(&vRaw[0], vRaw.size(), vChunk);
+	WritePngChunk(vData, "IDAT", vChunk);
+	vChunk.clear();
+	WritePngChunk(vData, "IEND", vChunk);
+} //End SavePNG
+
+//////////////////////////////////////////////////////////////////////
+// BMP
+//////////////////////////////////////////////////////////////////////
+
+static uint32_t ReadLE32(const uint8_t * p)
+{
+	return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+} //End ReadLE32
+
+static void WriteLE32(std::vector<uint8_t> & vData, uint32_t dwValue)
+{
+	vData.push_back((uint8_t)dwValue);
+	vData.push_back((uint8_t)(dwValue >> 8));
+	vData.push_back((uint8_t)(dwValue >> 16));
+	vData.push_back((uint8_t)(dwValue >> 24));
+} //End WriteLE32
+
+//ENG: A channel given by a bit mask, scaled to 8 bits
+typedef struct _STRUCT_BMPCHANNEL
+{
+	int nShift;
+	uint32_t dwMax;
+} STRUCT_BMPCHANNEL;
+
+static STRUCT_BMPCHANNEL GetBmpChannel(uint32_t dwMask)
+{
+	STRUCT_BMPCHANNEL channel = {0, 0};
+	if (dwMask)
+	{
+		while (!(dwMask & 1))
+		{
+			dwMask >>= 1;
+			channel.nShift++;
+		} //while
+		channel.dwMax = dwMask;
+	} //if
+	return channel;
+} //End GetBmpChannel
+
+static uint32_t GetBmpValue(uint32_t dwPixel, const STRUCT_BMPCHANNEL & channel)
+{
+	if (!channel.dwMax)
+		return 0;
+	return (uint32_t)(((uint64_t)((dwPixel >> channel.nShift) & channel.dwMax) * 255 + channel.dwMax / 2) / channel.dwMax);
+} //End GetBmpValue
+
+bool CPPSurface::LoadBMP(const uint8_t * pData, size_t nSize)
+{
+	Destroy();
+	if ((nSize < 14 + 40) || (pData[0] != 'B') || (pData[1] != 'M'))
+		return false;
+
+	uint32_t dwOffBits = ReadLE32(pData + 10);
+	const uint8_t * pInfo = pData + 14;
+	uint32_t dwInfoSize = ReadLE32(pInfo);
+	if ((dwInfoSize < 40) || (dwInfoSize > nSize - 14))
+		return false;
+	int32_t nWidth = (int32_t)ReadLE32(pInfo + 4);
+	int32_t nHeight = (int32_t)ReadLE32(pInfo + 8);
+	int nBitCount = pInfo[14] | (pInfo[15] << 8);
+	uint32_t dwCompression = ReadLE32(pInfo + 16);
+	uint32_t dwClrUsed = ReadLE32(pInfo + 32);
+
+	bool bTopDown = nHeight < 0;
+	if (bTopDown)
+		nHeight = (nHeight == INT32_MIN) ? 0 : -nHeight;
+	if ((nWidth <= 0) || (nHeight <= 0) || ((int64_t)nWidth * nHeight > PPSURFACE_MAX_PIXELS))
+		return false;
+
+	//ENG: Masks of 16 and 32 bit pixels, after the header or in it
+	uint32_t masks[4] = {0, 0, 0, 0};
+	if (3 == dwCompression)
+	{
+		if ((16 != nBitCount) && (32 != nBitCount))
+			return false;
+		size_t nMasks = (dwInfoSize >= 56) ? 4 : 3;
+		const uint8_t * pMasks = pInfo + 40;
+		if ((size_t)(pMasks - pData) + nMasks * 4 > nSize)
+			return false;
+		for (size_t n = 0; n < nMasks; n++)
+			masks[n] = ReadLE32(pMasks + n * 4);
+	}
+	else if (0 == dwCompression)
+	{
+		if (16 == nBitCount)
+		{
+			masks[0] = 0x7C00; masks[1] = 0x03E0; masks[2] = 0x001F;
+		}
+		else if (32 == nBitCount)
+		{
+			masks[0] = 0x00FF0000; masks[1] = 0x0000FF00; masks[2] = 0x000000FF; masks[3] = 0xFF000000;
+		}
+		else if ((1 != nBitCount) && (4 != nBitCount) && (8 != nBitCount) && (24 != nBitCount))
+		{
+			return false;
+		} //if
+	}
+	else
+	{
+		//ENG: RLE and embedded JPEG or PNG are not read
+		return false;
+	} //if
+
+	uint32_t palette[256];
+	if (nBitCount <= 8)
+	{
+		uint32_t dwColors = dwClrUsed ? dwClrUsed : (1u << nBitCount);
+		if (dwColors > 256)
+			return false;
+		const uint8_t * pPalette = pInfo + dwInfoSize;
+		if ((size_t)(pPalette - pData) + dwColors * 4 > nSize)
+			return false;
+		for (uint32_t n = 0; n < 256; n++)
+			palette[n] = (n < dwColors) ? (0xFF000000 | (ReadLE32(pPalette + n * 4) & 0x00FFFFFF)) : 0xFF000000;
+	} //if
+
+	uint64_t nStride = (((uint64_t)nWidth * nBitCount + 31) / 32) * 4;
+	if ((dwOffBits > nSize) || (nStride * nHeight > nSize - dwOffBits))
+		return false;
+	if (!Create(nWidth, nHeight))
+		return false;
+
+	STRUCT_BMPCHANNEL channels[4];
+	for (int n = 0; n < 4; n++)
+		channels[n] = GetBmpChannel(masks[n]);
+
+	bool bAlpha = false;
+	for (int nLine = 0; nLine < nHeight; nLine++)
+	{
+		const uint8_t * pLine = pData + dwOffBits + nStride * nLine;
+		uint32_t * pRow = GetRow(bTopDown ? nLine : nHeight - 1 - nLine);
+		for (int x = 0; x < nWidth; x++)
+		{
+			uint32_t dwPixel;
+			switch (nBitCount)
+			{
+			case 1:
+			case 4:
+			case 8:
+				dwPixel = palette[ReadSample(pLine, x, nBitCount)];
+				break;
+			case 24:
+				dwPixel = 0xFF000000 | pLine[x * 3] | (pLine[x * 3 + 1] << 8) | (pLine[x * 3 + 2] << 16);
+				break;
+			default:
+				{
+					uint32_t dwValue = (16 == nBitCount) ? (pLine[x * 2] | (pLine[x * 2 + 1] << 8)) : ReadLE32(pLine + x * 4);
+					dwPixel = (GetBmpValue(dwValue, channels[0]) << 16) | (GetBmpValue(dwValue, channels[1]) << 8) | GetBmpValue(dwValue, channels[2]);
+					if (channels[3].dwMax)
+					{
+						dwPixel |= GetBmpValue(dwValue, channels[3]) << 24;
+						bAlpha = bAlpha || (dwPixel >> 24);
+					}
+					else
+					{
+						dwPixel |= 0xFF000000;
+					} //if
+				}
+				break;
+			} //switch
+			pRow[x] = dwPixel;
+		} //for
+	} //for
+
+	//ENG: An alpha channel that is all zero is only unused
+	if (channels[3].dwMax && !bAlpha)
+	{
+		for (int y = 0; y < nHeight; y++)
+		{
+			uint32_t * pRow = GetRow(y);
+			for (int x = 0; x < nWidth; x++)
+				pRow[x] |= 0xFF000000;
+		} //for
+	} //if
+
+	for (int y = 0; y < m_nHeight; y++)
+		CPPPixelOps::Premultiply(GetRow(y), m_nWidth);
+	return true;
+} //End LoadBMP
+
+void CPPSurface::SaveBMP(std::vector<uint8_t> & vData) const
+{
+	vData.clear();
+	if (IsEmpty())
+		return;
+
+	//ENG: 32 bits bottom-up, with straight alpha
+	uint32_t dwImageSize = (uint32_t)m_nWidth * m_nHeight * 4;
+	vData.reserve(14 + 40 + dwImageSize);
+	vData.push_back('B');
+	vData.push_back('M');
+	WriteLE32(vData, 14 + 40 + dwImageSize);
+	WriteLE32(vData, 0);
+	WriteLE32(vData, 14 + 40);
+
+	WriteLE32(vData, 40);
+	WriteLE32(vData, m_nWidth);
+	WriteLE32(vData, m_nHeight);
+	WriteLE32(vData, 1 | (32 << 16));	// Planes and bit count
+	WriteLE32(vData, 0);				// BI_RGB
+	WriteLE32(vData, dwImageSize);
+	WriteLE32(vData, 0);
+	WriteLE32(vData, 0);
+	WriteLE32(vData, 0);
+	WriteLE32(vData, 0);
+
+	for (int y = m_nHeight - 1; y >= 0; y--)
+	{
+		const uint32_t * pRow = GetRow(y);
+		for (int x = 0; x < m_nWidth; x++)
+			WriteLE32(vData, Unpremultiply(pRow[x]));
+	} //for
+} //End SaveBMP
+
+bool CPPSurface::Load(const uint8_t * pData, size_t nSize)
+{
+	if ((nSize >= 8) && !memcmp(pData, s_PngSignature, 8))
+		return LoadPNG(pData, nSize);
+	return LoadBMP(pData, nSize);
+} //End Load
+
+//ENG: Decodes what is left of pFile and closes it
+bool CPPSurface::LoadStream(FILE * pFile)
+{
+	Destroy();
+	if (NULL == pFile)
+		return false;
+
+	std::vector<uint8_t> vData;
+	uint8_t buffer[4096];
+	size_t nRead;
+	while ((nRead = fread(buffer, 1, sizeof(buffer), pFile)) > 0)
+		vData.insert(vData.end(), buffer, buffer + nRead);
+	fclose(pFile);
+
+	return !vData.empty() && Load(&vData[0], vData.size());
+} //End LoadStream
+
+bool CPPSurface::LoadFile(const char * pszFileName)
+{
+	return LoadStream(fopen(pszFileName, "rb"));
+} //End LoadFile
+
+#ifdef _WIN32
+bool CPPSurface::LoadFile(const wchar_t * pszFileName)
+{
+	return LoadStream(_wfopen(pszFileName, L"rb"));
+} //End LoadFile
+#endif
+
+bool CPPSurface::SaveFile(const char * pszFileName, bool bPNG /* = true */) const
+{
+	std::vector<uint8_t> vData;
+	if (bPNG)
+		SavePNG(vData);
+	else
+		SaveBMP(vData);
+	if (vData.empty())
+		return false;
+
+	FILE * pFile = fopen(pszFileName, "wb");
+	if (NULL == pFile)
+		return false;
+	bool bResult = fwrite(&vData[0], 1, vData.size(), pFile) == vData.size();
+	return (0 == fclose(pFile)) && bResult;
+} //End SaveFile
+
+#ifdef _WIN32
+//////////////////////////////////////////////////////////////////////
+// DIB section adapters
+//////////////////////////////////////////////////////////////////////
+
+HBITMAP CPPSurface::CreateDIBSection() const
+{
+	if (IsEmpty())
+		return NULL;
+
+	BITMAPINFO bmi;
+	ZeroMemory(&bmi, sizeof(bmi));
+	bmi.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+	bmi.bmiHeader.biWidth = m_nWidth;
+	bmi.bmiHeader.biHeight = -m_nHeight;
+	bmi.bmiHeader.biPlanes = 1;
+	bmi.bmiHeader.biBitCount = 32;
+	bmi.bmiHeader.biCompression = BI_RGB;
+
+	uint32_t * pBits = NULL;
+	HBITMAP hBitmap = ::CreateDIBSection(NULL, &bmi, DIB_RGB_COLORS, (void **)&pBits, NULL, 0);
+	if ((NULL == hBitmap) || (NULL == pBits))
+	{
+		if (NULL != hBitmap)
+			::DeleteObject(hBitmap);
+		return NULL;
+	} //if
+
+	for (int y = 0; y < m_nHeight; y++)
+		memcpy(pBits + (size_t)y * m_nWidth, GetRow(y), m_nWidth * sizeof(uint32_t));
+	return hBitmap;
+} //End CreateDIBSection
+
+bool CPPSurface::FromBitmap(HBITMAP hBitmap)
+{
+	BITMAP bm;
+	if ((NULL == hBitmap) || !::GetObject(hBitmap, sizeof(bm), &bm))
+		return false;
+	if (!Create(bm.bmWidth, abs(bm.bmHeight)))
+		return false;
+
+	BITMAPINFO bmi;
+	ZeroMemory(&bmi, sizeof(bmi));
+	bmi.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+	bmi.bmiHeader.biWidth = m_nWidth;
+	bmi.bmiHeader.biHeight = -m_nHeight;
+	bmi.bmiHeader.biPlanes = 1;
+	bmi.bmiHeader.biBitCount = 32;
+	bmi.bmiHeader.biCompression = BI_RGB;
+
+	HDC hDC = ::GetDC(NULL);
+	int nLines = ::GetDIBits(hDC, hBitmap, 0, m_nHeight, m_pBits, &bmi, DIB_RGB_COLORS);
+	::ReleaseDC(NULL, hDC);
+	if (nLines != m_nHeight)
+	{
+		Destroy();
+		return false;
+	} //if
+
+	//ENG: 32-bit bitmaps are taken as premultiplied, anything else is opaque
+	size_t nPixels = (size_t)m_nWidth * m_nHeight;
+	if ((32 != bm.bmBitsPixel) || !CPPPixelOps::HasAlpha(m_pBits, nPixels))
+	{
+		for (size_t i = 0; i < nPixels; i++)
+			m_pBits[i] |= 0xFF000000;
+	} //if
+	return true;
+} //End FromBitmap
+
+bool CPPSurface::AttachDIBSection(HBITMAP hBitmap)
+{
+	DIBSECTION ds;
+	if ((NULL == hBitmap) || (::GetObject(hBitmap, sizeof(ds), &ds) != sizeof(ds)) || 
+		(32 != ds.dsBm.bmBitsPixel) || (NULL == ds.dsBm.bmBits))
+		return false;
+
+	//ENG: GDI may still be drawing into the bits
+	::GdiFlush();
+	uint32_t * pBits = (uint32_t *)ds.dsBm.bmBits;
+	ptrdiff_t nStride = ds.dsBm.bmWidthBytes / 4;
+	int nHeight = ds.dsBm.bmHeight;
+	if (ds.dsBmih.biHeight > 0)
+		Attach(pBits + (nHeight - 1) * nStride, ds.dsBm.bmWidth, nHeight, -nStride);
+	else
+		Attach(pBits, ds.dsBm.bmWidth, nHeight, nStride);
+	return !IsEmpty();
+} //End AttachDIBSection
+#endif //_WIN32
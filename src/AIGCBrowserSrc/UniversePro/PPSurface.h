@@ -0,0 +1,108 @@
+/********************************************************************************
+ *           Web Runtime for Application - Version 1.0.0.202203120001           *
+ ********************************************************************************
+ * Copyright (C) 2002-2021 by Tangram Team.   All Rights Reserved.
+ * There are Three Key Features of Webruntime:
+ * 1. Built-in Modern Web Browser: Independent Browser Window and Browser Window
+ *    as sub windows of other windows are supported in the application process;
+ * 2. DOM Plus: DOMPlus is a natural extension of the standard DOM system.
+ *    It allows the application system to support a kind of generalized web pages,
+ *    which are composed of standard DOM elements and binary components supported
+ *    by the application system;
+ * 3. JavaScript for Application: Similar to VBA in MS office, JavaScript will
+ *    become a built-in programmable language in the application system, so that
+ *    the application system can be expanded and developed for the Internet based
+ *    on modern javscript/Web technology.
+ * Use of this source code is governed by a BSD-style license that
+ * can be found in the LICENSE file.
+ *
+ * CONTACT INFORMATION:
+ * mailto:tangramteam@outlook.com or mailto:sunhuizlz@yeah.net
+ * https://www.webruntime.com
+ *******************************************************************************/
+
+// PPSurface.h : 32-bit premultiplied ARGB surface
+//
+// CCeXDib only knows palettized DIBs. A CPPSurface holds true color with
+// alpha as 32-bit pixels in the layout of a DIB section (byte 0 is blue,
+// byte 3 alpha), premultiplied the way AlphaBlend wants them. Rows are
+// reached through a stride, which is negative for bottom-up storage, so a
+// surface can also be a view into another surface or into the bits of a
+// DIB section without copying. Copies of a surface share its pixels; use
+// Clone for a private copy.
+//
+// Everything but the adapters at the end works without a device context,
+// so image effects can run and be checked off screen on any platform. PNG
+// and BMP are read and written with the small codec in PPSurface.cpp.
+
+#pragma once
+
+#pragma warning(push, 3)
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <vector>
+#include <memory>
+#pragma warning(pop)
+
+class CPPSurface
+{
+public:
+	CPPSurface();
+
+	//ENG: A new surface of transparent black pixels
+	bool Create(int nWidth, int nHeight);
+	//ENG: Uses pixels owned by the caller, nStride is in pixels
+	void Attach(uint32_t * pBits, int nWidth, int nHeight, ptrdiff_t nStride);
+	void Destroy();
+
+	bool IsEmpty() const {return (NULL == m_pBits);};
+	int GetWidth() const {return m_nWidth;};
+	int GetHeight() const {return m_nHeight;};
+	ptrdiff_t GetStride() const {return m_nStride;};
+	uint32_t * GetRow(int y) {return m_pBits + y * m_nStride;};
+	const uint32_t * GetRow(int y) const {return m_pBits + y * m_nStride;};
+	uint32_t GetPixel(int x, int y) const;
+	void SetPixel(int x, int y, uint32_t dwPixel);
+
+	//ENG: A view of a rectangle of this surface, clipped to its bounds
+	CPPSurface GetView(int x, int y, int nWidth, int nHeight) const;
+	CPPSurface Clone() const;
+
+	void Fill(uint32_t dwPixel);
+	//ENG: Copies src to (x, y), or blends it over this surface
+	void Copy(const CPPSurface & src, int x, int y);
+	void Blend(const CPPSurface & src, int x, int y);
+
+	//ENG: Conversion of a single pixel from and to straight alpha
+	static uint32_t Premultiply(uint32_t dwPixel);
+	static uint32_t Unpremultiply(uint32_t dwPixel);
+
+	//ENG: Decodes a PNG or a BMP, by its signature
+	bool Load(const uint8_t * pData, size_t nSize);
+	bool LoadPNG(const uint8_t * pData, size_t nSize);
+	bool LoadBMP(const uint8_t * pData, size_t nSize);
+	void SavePNG(std::vector<uint8_t> & vData) const;
+	void SaveBMP(std::vector<uint8_t> & vData) const;
+	bool LoadFile(const char * pszFileName);
+	bool SaveFile(const char * pszFileName, bool bPNG = true) const;
+
+#ifdef _WIN32
+	bool LoadFile(const wchar_t * pszFileName);
+	//ENG: A top-down 32-bit DIB section with a copy of the pixels
+	HBITMAP CreateDIBSection() const;
+	//ENG: Copies any bitmap; one without alpha becomes opaque
+	bool FromBitmap(HBITMAP hBitmap);
+	//ENG: A view of the bits of a 32-bit DIB section, which must outlive it
+	bool AttachDIBSection(HBITMAP hBitmap);
+#endif
+
+protected:
+	bool LoadStream(FILE * pFile);
+
+	std::shared_ptr<std::vector<uint32_t> > m_pStorage;	// NULL when attached
+	uint32_t * m_pBits;		// The top row
+	int m_nWidth;
+	int m_nHeight;
+	ptrdiff_t m_nStride;	// Pixels from one row to the next
+};
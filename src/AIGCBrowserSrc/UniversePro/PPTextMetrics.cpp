@@ -0,0 +1,259 @@
+/********************************************************************************
+ *           Web Runtime for Application - Version 1.0.0.202203120001           *
+ ********************************************************************************
+ * Copyright (C) 2002-2021 by Tangram Team.   All Rights Reserved.
+ * There are Three Key Features of Webruntime:
+ * 1. Built-in Modern Web Browser: Independent Browser Window and Browser Window
+ *    as sub windows of other windows are supported in the application process;
+ * 2. DOM Plus: DOMPlus is a natural extension of the standard DOM system.
+ *    It allows the application system to support a kind of generalized web pages,
+ *    which are composed of standard DOM elements and binary components supported
+ *    by the application system;
+ * 3. JavaScript for Application: Similar to VBA in MS office, JavaScript will
+ *    become a built-in programmable language in the application system, so that
+ *    the application system can be expanded and developed for the Internet based
+ *    on modern javscript/Web technology.
+ * Use of this source code is governed by a BSD-style license that
+ * can be found in the LICENSE file.
+ *
+ * CONTACT INFORMATION:
+ * mailto:tangramteam@outlook.com or mailto:sunhuizlz@yeah.net
+ * https://www.webruntime.com
+ *******************************************************************************/
+
+// PPTextMetrics.cpp : cached text extents for the html drawers
+
+#include "stdafx.h"
+#include "PPTextMetrics.h"
+
+#pragma warning(push, 3)
+#include <stddef.h>
+#pragma warning(pop)
+
+//ENG: Longer texts are measured but not kept
+#define PPTEXTMETRICS_MAX_LENGTH	4096
+
+#define FNV_OFFSET	0xCBF29CE484222325ULL
+#define FNV_PRIME	0x00000100000001B3ULL
+
+static uint64_t HashBytes(uint64_t nHash, const void * pData, size_t nSize)
+{
+	const uint8_t * p = (const uint8_t *)pData;
+	for (size_t i = 0; i < nSize; i++)
+	{
+		nHash ^= p[i];
+		nHash *= FNV_PRIME;
+	} //for
+	return nHash;
+} //End HashBytes
+
+#ifdef _WIN32
+//////////////////////////////////////////////////////////////////////
+// CPPGdiTextMeasurer
+//////////////////////////////////////////////////////////////////////
+
+uint64_t CPPGdiTextMeasurer::GetFontKey()
+{
+	LOGFONT lf;
+	HFONT hFont = (HFONT)::GetCurrentObject(m_hDC, OBJ_FONT);
+	if ((NULL == hFont) || !::GetObject(hFont, sizeof(lf), &lf))
+		return 0;
+
+	//ENG: The face name is hashed up to its end only, the rest of the
+	//     buffer may hold anything
+	uint64_t nKey = HashBytes(FNV_OFFSET, &lf, offsetof(LOGFONT, lfFaceName));
+	nKey = HashBytes(nKey, lf.lfFaceName, _tcslen(lf.lfFaceName) * sizeof(TCHAR));
+	int nDevice[3] = {::GetTextCharacterExtra(m_hDC), ::GetMapMode(m_hDC), ::GetDeviceCaps(m_hDC, LOGPIXELSY)};
+	return HashBytes(nKey, nDevice, sizeof(nDevice));
+} //End GetFontKey
+
+bool CPPGdiTextMeasurer::Measure(const TCHAR * lpszText, int nLength, int * pExtents, int & nHeight)
+{
+	SIZE sz = {0, 0};
+	if (!::GetTextExtentExPoint(m_hDC, lpszText, nLength, 0, NULL, pExtents, &sz))
+		return false;
+	nHeight = sz.cy;
+	return true;
+} //End Measure
+#endif //_WIN32
+
+//////////////////////////////////////////////////////////////////////
+// CPPFixedTextMeasurer
+//////////////////////////////////////////////////////////////////////
+
+CPPFixedTextMeasurer::CPPFixedTextMeasurer(int nAdvance /* = 8 */, int nHeight /* = 16 */)
+{
+	m_nAdvance = nAdvance;
+	m_nHeight = nHeight;
+	m_nCalls = 0;
+} //End CPPFixedTextMeasurer
+
+void CPPFixedTextMeasurer::SetFont(int nAdvance, int nHeight)
+{
+	m_nAdvance = nAdvance;
+	m_nHeight = nHeight;
+} //End SetFont
+
+uint64_t CPPFixedTextMeasurer::GetFontKey()
+{
+	int nFont[2] = {m_nAdvance, m_nHeight};
+	return HashBytes(FNV_OFFSET, nFont, sizeof(nFont));
+} //End GetFontKey
+
+bool CPPFixedTextMeasurer::Measure(const TCHAR * lpszText, int nLength, int * pExtents, int & nHeight)
+{
+	m_nCalls++;
+	int nWidth = 0;
+	for (int i = 0; i < nLength; i++)
+	{
+		unsigned int ch = (unsigned int)lpszText[i];
+		nWidth += ((ch >= 0x1100) && (ch < 0xD800)) ? m_nAdvance * 2 : m_nAdvance;
+		pExtents[i] = nWidth;
+	} //for
+	nHeight = m_nHeight;
+	return true;
+} //End Measure
+
+//////////////////////////////////////////////////////////////////////
+// CPPTextMetrics
+//////////////////////////////////////////////////////////////////////
+
+int CPPTextMetrics::_STRUCT_TEXTRUN::GetWidth(int nLength) const
+{
+	if (nLength <= 0)
+		return 0;
+	if (nLength > (int)vExtents.size())
+		nLength = (int)vExtents.size();
+	return nLength ? vExtents[nLength - 1] : 0;
+} //End GetWidth
+
+int CPPTextMetrics::_STRUCT_TEXTRUN::GetFit(int nMaxWidth) const
+{
+	//ENG: The extents only grow, so the first one too wide is searched
+	int nLow = 0, nHigh = (int)vExtents.size();
+	while (nLow < nHigh)
+	{
+		int nMiddle = (nLow + nHigh) / 2;
+		if (vExtents[nMiddle] <= nMaxWidth)
+			nLow = nMiddle + 1;
+		else
+			nHigh = nMiddle;
+	} //while
+	return nLow;
+} //End GetFit
+
+CPPTextMetrics::CPPTextMetrics(size_t nMaxRuns /* = 2048 */)
+{
+	m_nMaxRuns = nMaxRuns;
+	m_nHits = 0;
+	m_nMisses = 0;
+#ifdef _WIN32
+	::InitializeCriticalSection(&m_cs);
+#endif
+} //End CPPTextMetrics
+
+CPPTextMetrics::~CPPTextMetrics()
+{
+	Clear();
+#ifdef _WIN32
+	::DeleteCriticalSection(&m_cs);
+#endif
+} //End ~CPPTextMetrics
+
+void CPPTextMetrics::Lock()
+{
+#ifdef _WIN32
+	::EnterCriticalSection(&m_cs);
+#endif
+} //End Lock
+
+void CPPTextMetrics::Unlock()
+{
+#ifdef _WIN32
+	::LeaveCriticalSection(&m_cs);
+#endif
+} //End Unlock
+
+uint64_t CPPTextMetrics::Hash(uint64_t nFontKey, const TCHAR * lpszText, int nLength)
+{
+	uint64_t nHash = HashBytes(FNV_OFFSET, &nFontKey, sizeof(nFontKey));
+	return HashBytes(nHash, lpszText, nLength * sizeof(TCHAR));
+} //End Hash
+
+CPPTextMetrics::TEXTRUNPTR CPPTextMetrics::GetRun(CPPTextMeasurer & measurer, const TCHAR * lpszText, int nLength)
+{
+	if (nLength < 0)
+		nLength = 0;
+	uint64_t nFontKey = measurer.GetFontKey();
+	uint64_t nHash = Hash(nFontKey, lpszText, nLength);
+
+	Lock();
+	mapRuns::iterator iter = m_mapRuns.find(nHash);
+	if (iter != m_mapRuns.end())
+	{
+		const STRUCT_TEXTRUN & run = **iter->second;
+		if ((run.nFontKey == nFontKey) && (run.sText.size() == (size_t)nLength) && 
+			!run.sText.compare(0, nLength, lpszText, nLength))
+		{
+			m_nHits++;
+			m_listRuns.splice(m_listRuns.begin(), m_listRuns, iter->second);
+			TEXTRUNPTR pRun = *iter->second;
+			Unlock();
+			return pRun;
+		} //if
+	} //if
+	m_nMisses++;
+	Unlock();
+
+	//ENG: Measured outside the lock, GDI calls may take a while
+	std::shared_ptr<STRUCT_TEXTRUN> pRun = std::make_shared<STRUCT_TEXTRUN>();
+	pRun->nFontKey = nFontKey;
+	pRun->sText.assign(lpszText, nLength);
+	pRun->vExtents.resize(nLength);
+	pRun->nHeight = 0;
+	if (!measurer.Measure(lpszText, nLength, nLength ? &pRun->vExtents[0] : NULL, pRun->nHeight))
+		return TEXTRUNPTR();
+	if ((nLength > PPTEXTMETRICS_MAX_LENGTH) || !m_nMaxRuns)
+		return pRun;
+
+	Lock();
+	iter = m_mapRuns.find(nHash);
+	if (iter != m_mapRuns.end())
+	{
+		//ENG: Measured by another thread meanwhile, or a hash collision
+		m_listRuns.erase(iter->second);
+		m_mapRuns.erase(iter);
+	} //if
+	m_listRuns.push_front(pRun);
+	m_mapRuns[nHash] = m_listRuns.begin();
+	while (m_listRuns.size() > m_nMaxRuns)
+	{
+		const STRUCT_TEXTRUN & oldest = *m_listRuns.back();
+		m_mapRuns.erase(Hash(oldest.nFontKey, oldest.sText.c_str(), (int)oldest.sText.size()));
+		m_listRuns.pop_back();
+	} //while
+	Unlock();
+
+	return pRun;
+} //End GetRun
+
+void CPPTextMetrics::Clear()
+{
+	Lock();
+	m_listRuns.clear();
+	m_mapRuns.clear();
+	Unlock();
+} //End Clear
+
+void CPPTextMetrics::SetMaxRuns(size_t nMaxRuns)
+{
+	Lock();
+	m_nMaxRuns = nMaxRuns;
+	while (m_listRuns.size() > m_nMaxRuns)
+	{
+		const STRUCT_TEXTRUN & oldest = *m_listRuns.back();
+		m_mapRuns.erase(Hash(oldest.nFontKey, oldest.sText.c_str(), (int)oldest.sText.size()));
+		m_listRuns.pop_back();
+	} //while
+	Unlock();
+} //End SetMaxRuns
@@ -0,0 +1,232 @@
+/********************************************************************************
+ *           Web Runtime for Application - Version 1.0.0.202203120001           *
+ ********************************************************************************
+ * Copyright (C) 2002-2021 by Tangram Team.   All Rights Reserved.
+ * There are Three Key Features of Webruntime:
+ * 1. Built-in Modern Web Browser: Independent Browser Window and Browser Window
+ *    as sub windows of other windows are supported in the application process;
+ * 2. DOM Plus: DOMPlus is a natural extension of the standard DOM system.
+ *    It allows the application system to support a kind of generalized web pages,
+ *    which are composed of standard DOM elements and binary components supported
+ *    by the application system;
+ * 3. JavaScript for Application: Similar to VBA in MS office, JavaScript will
+ *    become a built-in programmable language in the application system, so that
+ *    the application system can be expanded and developed for the Internet based
+ *    on modern javscript/Web technology.
+ * Use of this source code is governed by a BSD-style license that
+ * can be found in the LICENSE file.
+ *
+ * CONTACT INFORMATION:
+ * mailto:tangramteam@outlook.com or mailto:sunhuizlz@yeah.net
+ * https://www.webruntime.com
+ *******************************************************************************/
+
+// PPTextMetrics.h : cached text extents for the html drawers
+//
+// Word wrapping in CPPHtmlDrawer measured every prefix of a run with its own
+// GetTextExtentPoint32 call, and every tooltip repaint measured the same
+// runs again. CPPTextMetrics measures a run once, as the extents of all its
+// prefixes, and keeps it keyed by font and text, so the width of any prefix
+// and the point where a run must wrap come without further calls.
+//
+// The measuring itself is done by a CPPTextMeasurer: the GDI one measures
+// with the font selected into a DC, the fixed one gives every character the
+// same advance so layout can be checked off screen.
+
+#pragma once
+
+#pragma warning(push, 3)
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <list>
+#include <map>
+#include <memory>
+#pragma warning(pop)
+
+class CPPTextMeasurer
+{
+public:
+	virtual ~CPPTextMeasurer() {};
+
+	//ENG: Identity of the font in use; fonts that measure alike share it
+	virtual uint64_t GetFontKey() = 0;
+	//ENG: pExtents[i] gets the width of the first i + 1 characters
+	virtual bool Measure(const TCHAR * lpszText, int nLength, int * pExtents, int & nHeight) = 0;
+};
+
+#ifdef _WIN32
+class CPPGdiTextMeasurer : public CPPTextMeasurer
+{
+public:
+	CPPGdiTextMeasurer(HDC hDC = NULL) {m_hDC = hDC;};
+
+	void SetDC(HDC hDC) {m_hDC = hDC;};
+	HDC GetDC() const {return m_hDC;};
+
+	virtual uint64_t GetFontKey();
+	virtual bool Measure(const TCHAR * lpszText, int nLength, int * pExtents, int & nHeight);
+
+protected:
+	HDC m_hDC;
+};
+#endif
+
+class CPPFixedTextMeasurer : public CPPTextMeasurer
+{
+public:
+	CPPFixedTextMeasurer(int nAdvance = 8, int nHeight = 16);
+
+	//ENG: Characters of East Asian scripts get twice the advance
+	void SetFont(int nAdvance, int nHeight);
+	size_t GetCalls() const {return m_nCalls;};
+
+	virtual uint64_t GetFontKey();
+	virtual bool Measure(const TCHAR * lpszText, int nLength, int * pExtents, int & nHeight);
+
+protected:
+	int m_nAdvance;
+	int m_nHeight;
+	size_t m_nCalls;
+};
+
+class CPPTextMetrics
+{
+public:
+	CPPTextMetrics(size_t nMaxRuns = 2048);
+	virtual ~CPPTextMetrics();
+
+	typedef struct _STRUCT_TEXTRUN
+	{
+		uint64_t nFontKey;
+		std::basic_string<TCHAR> sText;
+		std::vector<int> vExtents;	// Width of the first i + 1 characters
+		int nHeight;				// Height of the line
+
+		//ENG: Width of the first nLength characters
+		int GetWidth(int nLength) const;
+		//ENG: How many characters fit into nMaxWidth
+		int GetFit(int nMaxWidth) const;
+	} STRUCT_TEXTRUN;
+	typedef std::shared_ptr<const STRUCT_TEXTRUN> TEXTRUNPTR;
+
+	//ENG: The run measured in the current font of measurer, NULL if it
+	//     cannot be measured
+	TEXTRUNPTR GetRun(CPPTextMeasurer & measurer, const TCHAR * lpszText, int nLength);
+	void Clear();
+
+	void SetMaxRuns(size_t nMaxRuns);
+	size_t GetMaxRuns() const {return m_nMaxRuns;};
+	size_t GetCount() const {return m_listRuns.size();};
+	size_t GetHits() const {return m_nHits;};
+	size_t GetMisses() const {return m_nMisses;};
+
+protected:
+	typedef std::list<TEXTRUNPTR> listRuns;		// Most recently used first
+	typedef std::map<uint64_t, listRuns::iterator> mapRuns;
+
+	listRuns m_listRuns;
+	mapRuns m_mapRuns;
+	size_t m_nMaxRuns;
+	size_t m_nHits;
+	size_t m_nMisses;
+#ifdef _WIN32
+	CRITICAL_SECTION m_cs;
+#endif
+
+	void Lock();
+	void Unlock();
+	static uint64_t Hash(uint64_t nFontKey, const TCHAR * lpszText, int nLength);
+};
+
+//ENG: Length of the beginning of str without its trailing spaces, as
+//     TrimRight of str.Left(nLength) would leave it
+template <class S>
+int PPGetTrimmedLength(const S & str, int nLength)
+{
+	if (nLength > str.GetLength())
+		nLength = str.GetLength();
+	while ((nLength > 0) && _istspace(str.GetAt(nLength - 1)))
+		nLength--;
+	return (nLength > 0) ? nLength : 0;
+} //End PPGetTrimmedLength
+
+//ENG: Cuts off the beginning of str that fits into nRealSize and returns
+//     it, with its width in nRealSize. The line breaks after one of
+//     lpszBreakChars; when none fits and nMaxSize equals nRealSize, the
+//     first word is broken after its last char that fits. run holds the
+//     extents of str, S is a CString like string
+template <class S>
+S PPGetWordWrap(const CPPTextMetrics::STRUCT_TEXTRUN & run, S & str, int nMaxSize, int & nRealSize, const TCHAR * lpszBreakChars)
+{
+	int nCurIndex = 0;
+	int nLastIndex = 0;
+	int nWidth = 0;
+	TCHAR tch = _T(' ');
+	S sResult = _T("");
+
+	while ((nWidth <= nRealSize) && (0 != tch))
+	{
+		nLastIndex = nCurIndex;
+		nCurIndex ++;
+		for (tch = 0; nCurIndex < str.GetLength(); nCurIndex++)
+		{
+			if ((0 != str.GetAt(nCurIndex)) && (NULL != _tcschr(lpszBreakChars, str.GetAt(nCurIndex))))
+			{
+				tch = str.GetAt(nCurIndex);
+				break;
+			} //if
+		} //for
+
+		//+++hd
+		// arw - Begin Change
+		// Get the break character as well, trim it if it's a space,
+		// and get the new correct length.
+		nWidth = run.GetWidth(PPGetTrimmedLength(str, nCurIndex + 1));
+		// End Change
+
+	} //while
+
+	if (0 != nCurIndex)
+	{
+		sResult = str.Left(nCurIndex + 1);
+		sResult.TrimRight();
+	} //if
+
+	if (0 == nLastIndex)
+	{
+		if (nMaxSize == nRealSize)
+		{
+			//ENG: No break char fits, the word is broken after the last
+			//     char that fits, but at least one char
+			int i = run.GetFit(nRealSize);
+			if (i < 1)
+				i = 1;
+			if (i < str.GetLength())
+			{
+				sResult = str.Left(i);
+				str = str.Mid(i);
+				nRealSize = run.GetWidth(i);
+				return sResult;
+			} //if
+			nWidth = run.GetWidth(i);
+			sResult = str;
+			str.Empty();
+		}
+		else
+		{
+			nWidth = 0;
+		} //if
+	}
+	else 
+	{
+		nWidth = run.GetWidth(PPGetTrimmedLength(str, nLastIndex + 1));
+		sResult = str.Left(nLastIndex + 1);
+		str = str.Mid(nLastIndex + 1);
+		sResult.TrimRight();
+//		str.TrimRight();
+		str.TrimLeft();
+	} //if
+	nRealSize = nWidth;
+	return sResult;
+} //End PPGetWordWrap
@@ -75,6 +75,8 @@ UINT WM_XHTMLTREE_DROP_HOVER       = ::RegisterWindowMessage(_T("WM_XHTMLTREE_DR
 #ifdef XHTMLTREE_DEMO
 UINT WM_XHTMLTREE_SCROLL_SPEED     = ::RegisterWindowMessage(_T("WM_XHTMLTREE_SCROLL_SPEED"));
 #endif // XHTMLTREE_DEMO
+// posted to the tree itself when the stub of a partly loaded branch is drawn
+static UINT WM_XHTMLTREE_LOAD_XML_PAGE = ::RegisterWindowMessage(_T("WM_XHTMLTREE_LOAD_XML_PAGE"));
 
 #pragma warning(disable : 4996)	// disable bogus deprecation warning
 
@@ -86,6 +88,9 @@ const UINT SELECT_TIMER			= 5;
 const UINT TOOLTIP_BASE_ID		= 10000;
 const DWORD MIN_HOVER_TIME		= 1500;		// 1.5 seconds
 const int SCROLL_ZONE			= 16;		// pixels for scrolling
+const int XML_VIRTUAL_THRESHOLD	= 2000;		// XML nodes before loading is virtual
+const int XML_ITEM_BUDGET		= 20000;	// items kept in a virtual tree
+const int XML_PAGE_SIZE			= 500;		// children loaded at a time
 
 int CTangramXHtmlTreeNode::m_nCount		= 0;
 
@@ -130,6 +135,8 @@ BEGIN_MESSAGE_MAP(CTangramHtmlTreeWnd, CTreeCtrl)
 
 	ON_NOTIFY_REFLECT_EX(TVN_SELCHANGED, OnSelchanged)
 	ON_NOTIFY_REFLECT_EX(TVN_SELCHANGING, OnSelchanging)
+	ON_NOTIFY_REFLECT_EX(TVN_ITEMEXPANDING, OnItemexpanding)
+	ON_REGISTERED_MESSAGE(WM_XHTMLTREE_LOAD_XML_PAGE, OnLoadXmlPage)
 END_MESSAGE_MAP()
 
 //=============================================================================
@@ -158,6 +165,15 @@ CTangramHtmlTreeWnd::CTangramHtmlTreeWnd()
 	m_nImageHeight(16),
 	m_nToolCount(0),
 	m_nDefaultTipWidth(0),
+	m_nCheckedItems(0),
+	m_nTristateItems(0),
+	m_nHtmlParses(0),
+	m_nHtmlCacheHits(0),
+	m_bVirtualXml(false),
+	m_bDeferCounts(false),
+	m_nXmlVirtualThreshold(XML_VIRTUAL_THRESHOLD),
+	m_nXmlItemBudget(XML_ITEM_BUDGET),
+	m_nXmlPageSize(XML_PAGE_SIZE),
 	m_nScrollTime(0),
 	m_crCustomWindow(COLOR_NONE),
 	m_crCustomWindowText(COLOR_NONE),
@@ -593,6 +609,10 @@ void CTangramHtmlTreeWnd::OnCustomDraw(NMHDR* pNMHDR, LRESULT* pResult)
 				CBrush brush(m_crWindow);
 				pDC->FillRect(&rectItem1, &brush);		// erase entire background
 			}
+
+			// the stub of a partly loaded branch came into view
+			if (m_bVirtualXml && IsXmlStub(hItem))
+				PostMessage(WM_XHTMLTREE_LOAD_XML_PAGE, (WPARAM)GetParentItem(hItem));
 		}
 		*pResult = CDRF_NOTIFYPOSTPAINT | CDRF_NEWFONT;
 	}
@@ -1154,7 +1174,13 @@ int CTangramHtmlTreeWnd::DrawItemTextHtml(CDC *pDC,
 
 	CXHtmlDraw htmldraw;
 
-	int nWidth = htmldraw.Draw(pDC->m_hDC, strText, &pXTCD->ds, hItem == m_hAnchorItem);
+	UINT nParses = pXTCD->dcache.nParses;
+	UINT nHits = pXTCD->dcache.nHits;
+
+	int nWidth = htmldraw.Draw(pDC->m_hDC, strText, &pXTCD->ds, hItem == m_hAnchorItem, &pXTCD->dcache);
+
+	m_nHtmlParses += pXTCD->dcache.nParses - nParses;
+	m_nHtmlCacheHits += pXTCD->dcache.nHits - nHits;
 
 	pXTCD->ds.crText = crTextOld;
 	pXTCD->ds.crTextBackground = crTextBackgroundOld;
@@ -1255,6 +1281,10 @@ void CTangramHtmlTreeWnd::DeleteMap()
 	ASSERT(n == 0);
 
 	m_DataMap.RemoveAll();
+	m_nCheckedItems = 0;
+	m_nTristateItems = 0;
+	m_XmlModel.Clear();
+	m_bVirtualXml = false;
 	if (m_pHostXmlParse)
 	{
 		//m_pHostXmlParse->Reflash();
@@ -1999,46 +2029,30 @@ CTangramHtmlTreeWnd& CTangramHtmlTreeWnd::SetCheck(HTREEITEM hItem, BOOL fCheck
 
 		if (pXTCD && pXTCD->m_bEnabled && !pXTCD->m_bSeparator)		//+++1.6
 		{
-			BOOL bOldChecked = pXTCD->m_bChecked;
-			pXTCD->m_bChecked = fCheck;
+			fCheck = fCheck ? TRUE : FALSE;
+			BOOL bOldChecked = pXTCD->m_bChecked ? TRUE : FALSE;
 
-			CString strID = pXTCD->m_strTangramItemID;
-			if(strID!=_T(""))
+			if (m_bSmartCheck && (bOldChecked != fCheck))
 			{
-				if(fCheck)
-				{
-					m_mapSelectedNodeDic[strID] = pXTCD;
-				}
-				else
-				{
-					auto it = m_mapSelectedNodeDic.find(strID);
-					if(it!=m_mapSelectedNodeDic.end())
-						m_mapSelectedNodeDic.erase(it);
-				}
-				TRACE(_T("CurentSelected Node Count:%d\n"), m_mapSelectedNodeDic.size());
+				// the branch follows, then its parents are recounted
+				SetCheckChildren(hItem, fCheck);
 			}
+			else
+			{
+				pXTCD->m_bChecked = fCheck;
 
-			UINT nState = GetStateImage(hItem);
+				// keeps the copy in the XML model in step
+				if (m_bVirtualXml && pXTCD->m_nXmlIndex >= 0 && !m_bSmartCheck)
+					m_XmlModel.SetCheck(pXTCD->m_nXmlIndex, fCheck ? true : false);
 
-			SetItemState(hItem, INDEXTOSTATEIMAGEMASK(nState), TVIS_STATEIMAGEMASK);
+				UpdateSelectedNode(pXTCD);
 
-			if (m_bSmartCheck && (bOldChecked != fCheck))
-			{
-				HTREEITEM hParent = hItem;
-				int nCount = 0;
-				if (fCheck)
-					nCount = pXTCD->m_nChildren - pXTCD->m_nChecked + 1;//bOldCheck ? 1 : 0;
-				else
-					nCount = -(pXTCD->m_nChecked + 1);//bOldCheck ? 1 : 0);
+				UINT nState = GetStateImage(hItem);
 
-				SetCheckChildren(hItem, fCheck);
+				SetItemState(hItem, INDEXTOSTATEIMAGEMASK(nState), TVIS_STATEIMAGEMASK);
 
-				// find all parents, adjust their checked counts
-				TRACE(_T("starting nCount=%d\n"), nCount);
-				while ((hParent = GetParentItem(hParent)) != NULL)
-				{
-					nCount = SetCheckParent(hParent, nCount);
-				}
+				if (bOldChecked != fCheck)
+					UpdateParents(hItem, 0, fCheck ? 1 : -1, 0, 0);
 			}
 
 			SendRegisteredMessage(WM_XHTMLTREE_CHECKBOX_CLICKED, hItem, fCheck);
@@ -2119,7 +2133,7 @@ int CTangramHtmlTreeWnd::GetStateImage(HTREEITEM hItem)
 
 	if (pXTCD)
 	{
-		if (m_bSmartCheck && (pXTCD->m_nChildren != 0))
+		if (m_bSmartCheck && (pXTCD->m_nChildren - pXTCD->m_nSeparators > 0))
 		{
 			if (pXTCD->m_nChecked == 0)
 				nState = UNCHECKED;
@@ -2145,56 +2159,107 @@ int CTangramHtmlTreeWnd::GetStateImage(HTREEITEM hItem)
 }
 
 //=============================================================================
-int CTangramHtmlTreeWnd::SetCheckParent(HTREEITEM hItem, int nCount)
+BOOL CTangramHtmlTreeWnd::IsMixed(HTREEITEM hItem)
 //=============================================================================
 {
-	TRACE(_T("in CTangramHtmlTreeWnd::SetCheckParent:  nCount=%d  <%s>\n"), nCount, GetItemText(hItem));
-	ASSERT(hItem);
-
-	int nState = 0;
+	BOOL rc = false;
 
 	CTangramXHtmlTreeNode *pXTCD = GetItemDataStruct(hItem);
 
-	if (pXTCD)
+	// some, but not all, of the children are checked
+	if (m_bSmartCheck && pXTCD && !pXTCD->m_bSeparator && (pXTCD->m_nChecked != 0))
+		rc = pXTCD->m_nChecked != (pXTCD->m_nChildren - pXTCD->m_nSeparators);
+
+	return rc;
+}
+
+//=============================================================================
+void CTangramHtmlTreeWnd::UpdateSelectedNode(CTangramXHtmlTreeNode *pXTCD)
+//=============================================================================
+{
+	ASSERT(pXTCD);
+
+	CString strID = pXTCD->m_strTangramItemID;
+	if(strID!=_T(""))
 	{
-		TRACE(_T("pXTCD->m_nChecked=%d  pXTCD->m_nChildren=%d \n"), pXTCD->m_nChecked, pXTCD->m_nChildren);
-		pXTCD->m_nChecked += nCount;
+		if(pXTCD->m_bChecked)
+		{
+			m_mapSelectedNodeDic[strID] = pXTCD;
+		}
+		else
+		{
+			auto it = m_mapSelectedNodeDic.find(strID);
+			if(it!=m_mapSelectedNodeDic.end())
+				m_mapSelectedNodeDic.erase(it);
+		}
+		TRACE(_T("CurentSelected Node Count:%d\n"), m_mapSelectedNodeDic.size());
+	}
+}
+
+//=============================================================================
+void CTangramHtmlTreeWnd::UpdateParents(HTREEITEM hItem,
+										int nChildren,
+										int nChecked,
+										int nTristate,
+										int nSeparators)
+//=============================================================================
+{
+	TRACE(_T("in CTangramHtmlTreeWnd::UpdateParents:  %d %d %d %d  <%s>\n"),
+		nChildren, nChecked, nTristate, nSeparators, GetItemText(hItem));
+	ASSERT(hItem);
+
+	// the counts of hItem as seen by its parents changed by the given
+	// amounts; a parent that becomes checked, unchecked or mixed itself
+	// adds that for the levels above, so this costs one step per level
+	HTREEITEM hParent = hItem;
+	while ((nChildren || nChecked || nTristate || nSeparators) &&
+		   (hParent = GetParentItem(hParent)) != NULL)
+	{
+		CTangramXHtmlTreeNode *pXTCD = GetItemDataStruct(hParent);
+
+		if (pXTCD == NULL)
+			continue;
+
+		BOOL bOldChecked = pXTCD->m_bChecked;
+		BOOL bOldMixed = IsMixed(hParent);
+
+		pXTCD->m_nChildren += nChildren;
+		if (pXTCD->m_nChildren < 0)
+			pXTCD->m_nChildren = 0;
+		pXTCD->m_nChecked += nChecked;
 		if (pXTCD->m_nChecked < 0)
 			pXTCD->m_nChecked = 0;
+		pXTCD->m_nTristate += nTristate;
+		if (pXTCD->m_nTristate < 0)
+			pXTCD->m_nTristate = 0;
+		pXTCD->m_nSeparators += nSeparators;
+		if (pXTCD->m_nSeparators < 0)
+			pXTCD->m_nSeparators = 0;
 
-		BOOL bOldCheck = pXTCD->m_bChecked;
-		if (pXTCD->m_nChecked == (pXTCD->m_nChildren - pXTCD->m_nSeparators))	//+++1.6
-			pXTCD->m_bChecked = true;
-		else
-			pXTCD->m_bChecked = false;
-
-		if (pXTCD->m_bChecked != bOldCheck)
-			nCount += pXTCD->m_bChecked ? 1 : -1;
+		if (!m_bSmartCheck || pXTCD->m_bSeparator)
+			continue;
 
-		nState = GetStateImage(hItem);
+		int nCheckable = pXTCD->m_nChildren - pXTCD->m_nSeparators;	//+++1.6
+		if (nCheckable > 0)
+			pXTCD->m_bChecked = pXTCD->m_nChecked == nCheckable;
 
-		CString strID = pXTCD->m_strTangramItemID;
-		if(strID!=_T(""))
+		if ((pXTCD->m_bChecked ? TRUE : FALSE) != (bOldChecked ? TRUE : FALSE))
 		{
-			if(pXTCD->m_bChecked)
-			{
-				m_mapSelectedNodeDic[strID] = pXTCD;
-			}
-			else
-			{
-				auto it = m_mapSelectedNodeDic.find(strID);
-				if(it!=m_mapSelectedNodeDic.end())
-					m_mapSelectedNodeDic.erase(it);
-			}
+			nChecked += pXTCD->m_bChecked ? 1 : -1;
+			UpdateSelectedNode(pXTCD);
 		}
-		//TRACE(_T("CurentSelected Node Count:%d\n"), m_mapSelectedNodeDic.size());
-		SetItemState(hItem, INDEXTOSTATEIMAGEMASK(nState), TVIS_STATEIMAGEMASK);
 
-		TRACE(_T("nState=%d\n"), nState);				
-		TRACE(_T("CurentSelected Node Count:%d\n"), m_mapSelectedNodeDic.size());
+		BOOL bMixed = IsMixed(hParent);
+		if (bMixed != bOldMixed)
+			nTristate += bMixed ? 1 : -1;
+
+		int nState = GetStateImage(hParent);
+		SetItemState(hParent, INDEXTOSTATEIMAGEMASK(nState), TVIS_STATEIMAGEMASK);
 	}
 
-	return nCount;
+	// whatever is left reached the root level
+	m_nCheckedItems += nChecked;
+	m_nTristateItems += nTristate;
 }
 
 //=============================================================================
@@ -2203,28 +2268,66 @@ CTangramHtmlTreeWnd& CTangramHtmlTreeWnd::SetCheckChildren(HTREEITEM hItem, BOOL
 {
 	TRACE(_T("in CTangramHtmlTreeWnd::SetCheckChildren\n"));
 
-	// first set item state for this item
-	SetItemStateChildren(hItem, fCheck);
+	CTangramXHtmlTreeNode *pXTCD = GetItemDataStruct(hItem);
 
-	HTREEITEM hNext = GetChildItem(hItem);
-	
-	// loop to set item state for children
-	while (hNext)
+	if (pXTCD)
 	{
-		TRACE(_T("SetCheckChildren: %d  <%s>\n"), fCheck, GetItemText(hNext));
+		int nOldChecked = pXTCD->m_nChecked + (pXTCD->m_bChecked ? 1 : 0);
+		int nOldTristate = pXTCD->m_nTristate + (IsMixed(hItem) ? 1 : 0);
 
-		// recurse into children
-		if (ItemHasChildren(hNext))
-			SetCheckChildren(hNext, fCheck);
+		// the children that are not loaded follow in the XML model
+		if (m_bVirtualXml && pXTCD->m_nXmlIndex >= 0 && m_bSmartCheck)
+			m_XmlModel.SetCheck(pXTCD->m_nXmlIndex, fCheck ? true : false);
 
-		SetItemStateChildren(hNext, fCheck);
+		SetCheckBranch(hItem, fCheck);
 
-		hNext = GetNextItem(hNext, TVGN_NEXT);
+		int nChecked = pXTCD->m_nChecked + (pXTCD->m_bChecked ? 1 : 0);
+		int nTristate = pXTCD->m_nTristate + (IsMixed(hItem) ? 1 : 0);
+		UpdateParents(hItem, 0, nChecked - nOldChecked, nTristate - nOldTristate, 0);
 	}
 
 	return *this;
 }
 
+//=============================================================================
+void CTangramHtmlTreeWnd::SetCheckBranch(HTREEITEM hItem, BOOL fCheck)
+//=============================================================================
+{
+	CTangramXHtmlTreeNode *pXTCD = GetItemDataStruct(hItem);
+
+	int nChecked = 0;
+	int nTristate = 0;
+
+	// children without items are counted by the XML model
+	if (m_bVirtualXml && pXTCD && pXTCD->m_nXmlIndex >= 0)
+	{
+		int nPending = 0, nPendingSeparators = 0;
+		m_XmlModel.GetPendingCounts(pXTCD->m_nXmlIndex, nPending, nChecked, nTristate, nPendingSeparators);
+	}
+
+	// children first, so each one is final when it is added up
+	for (HTREEITEM hChild = GetChildItem(hItem); hChild; hChild = GetNextSiblingItem(hChild))
+	{
+		CTangramXHtmlTreeNode *pChild = GetItemDataStruct(hChild);
+		if (pChild == NULL || (pXTCD && pXTCD->m_hXmlStub == hChild))
+			continue;
+
+		TRACE(_T("SetCheckBranch: %d  <%s>\n"), fCheck, GetItemText(hChild));
+
+		SetCheckBranch(hChild, fCheck);
+
+		nChecked += pChild->m_nChecked + (pChild->m_bChecked ? 1 : 0);
+		nTristate += pChild->m_nTristate + (IsMixed(hChild) ? 1 : 0);
+	}
+
+	if (pXTCD)
+	{
+		pXTCD->m_nChecked = nChecked;
+		pXTCD->m_nTristate = nTristate;
+		SetItemStateChildren(hItem, fCheck);
+	}
+}
+
 //=============================================================================
 CTangramHtmlTreeWnd& CTangramHtmlTreeWnd::SetItemStateChildren(HTREEITEM hItem, BOOL fCheck)
 //=============================================================================
@@ -2233,46 +2336,28 @@ CTangramHtmlTreeWnd& CTangramHtmlTreeWnd::SetItemStateChildren(HTREEITEM hItem,
 
 	CTangramXHtmlTreeNode *pXTCD = GetItemDataStruct(hItem);
 
-	if (pXTCD && pXTCD->m_bEnabled)
+	if (pXTCD)
 	{
-		int nState = GetStateImage(hItem);
-		if (pXTCD->m_bSeparator)				//+++1.6
-		{
-			nState = 0;
-		}
-		else
+		int nState = 0;
+		if (!pXTCD->m_bSeparator)				//+++1.6
 		{
-			int nStateHot = nState & HDCheckboxImageList::HOT_INDEX;			// save hot
-			int nStateDisabled = nState & HDCheckboxImageList::DISABLED_INDEX;	// save disabled
-			nState &= ~(HDCheckboxImageList::HOT_INDEX | 
-						HDCheckboxImageList::DISABLED_INDEX);	// remove hot & disabled
-
-			pXTCD->m_bChecked = fCheck;
-
-			CString strID = pXTCD->m_strTangramItemID;
-			if(strID!=_T(""))
+			if (pXTCD->m_bEnabled)
 			{
-				if (fCheck)
-				{
-					m_mapSelectedNodeDic[strID] = pXTCD;
-					pXTCD->m_nChecked = pXTCD->m_nChildren - pXTCD->m_nSeparators;	//+++1.6
-					if (pXTCD->m_nChecked < 0)
-						pXTCD->m_nChecked = 0;
-					nState = CHECKED;
-				}
-				else
-				{
-					auto it = m_mapSelectedNodeDic.find(strID);
-					if(it!=m_mapSelectedNodeDic.end())
-						m_mapSelectedNodeDic.erase(it);
-					pXTCD->m_nChecked = 0;
-					nState = UNCHECKED;
-				}
-				TRACE(_T("CurentSelected Node Count:%d\n"), m_mapSelectedNodeDic.size());
+				pXTCD->m_bChecked = fCheck;
+
+				if (m_bVirtualXml && pXTCD->m_nXmlIndex >= 0 && !m_bSmartCheck)
+					m_XmlModel.SetCheck(pXTCD->m_nXmlIndex, fCheck ? true : false);
 			}
 
-			nState |= nStateHot;		// restore hot
-			nState |= nStateDisabled;	// restore disabled
+			// a parent is checked when all of its children are, which a
+			// disabled child can prevent
+			int nCheckable = pXTCD->m_nChildren - pXTCD->m_nSeparators;
+			if (m_bSmartCheck && nCheckable > 0)
+				pXTCD->m_bChecked = pXTCD->m_nChecked == nCheckable;
+
+			UpdateSelectedNode(pXTCD);
+
+			nState = GetStateImage(hItem);
 			TRACE(_T("setting state to %d\n"), nState);
 		}
 		SetItemState(hItem, INDEXTOSTATEIMAGEMASK(nState), TVIS_STATEIMAGEMASK);
@@ -2281,6 +2366,77 @@ CTangramHtmlTreeWnd& CTangramHtmlTreeWnd::SetItemStateChildren(HTREEITEM hItem,
 	return *this;
 }
 
+//=============================================================================
+void CTangramHtmlTreeWnd::RebuildCheckCounts()
+//=============================================================================
+{
+	TRACE(_T("in CTangramHtmlTreeWnd::RebuildCheckCounts\n"));
+
+	// recounts every item in one pass, for bulk loads and changes that
+	// would otherwise walk the parents of each item they touch
+	m_nCheckedItems = 0;
+	m_nTristateItems = 0;
+
+	for (HTREEITEM hRoot = GetRootItem(); hRoot; hRoot = GetNextSiblingItem(hRoot))
+	{
+		RebuildCheckCounts(hRoot);
+
+		CTangramXHtmlTreeNode *pXTCD = GetItemDataStruct(hRoot);
+
+		if (pXTCD)
+		{
+			m_nCheckedItems += pXTCD->m_nChecked + (pXTCD->m_bChecked ? 1 : 0);
+			m_nTristateItems += pXTCD->m_nTristate + (IsMixed(hRoot) ? 1 : 0);
+		}
+	}
+}
+
+//=============================================================================
+void CTangramHtmlTreeWnd::RebuildCheckCounts(HTREEITEM hItem)
+//=============================================================================
+{
+	CTangramXHtmlTreeNode *pXTCD = GetItemDataStruct(hItem);
+
+	int nChildren = 0;
+	int nChecked = 0;
+	int nTristate = 0;
+	int nSeparators = 0;
+
+	// children without items are counted by the XML model
+	if (m_bVirtualXml && pXTCD && pXTCD->m_nXmlIndex >= 0)
+		m_XmlModel.GetPendingCounts(pXTCD->m_nXmlIndex, nChildren, nChecked, nTristate, nSeparators);
+
+	for (HTREEITEM hChild = GetChildItem(hItem); hChild; hChild = GetNextSiblingItem(hChild))
+	{
+		CTangramXHtmlTreeNode *pChild = GetItemDataStruct(hChild);
+		if (pChild == NULL || (pXTCD && pXTCD->m_hXmlStub == hChild))
+			continue;
+
+		RebuildCheckCounts(hChild);
+
+		nChildren += 1 + pChild->m_nChildren;
+		nChecked += pChild->m_nChecked + (pChild->m_bChecked ? 1 : 0);
+		nTristate += pChild->m_nTristate + (IsMixed(hChild) ? 1 : 0);
+		nSeparators += pChild->m_nSeparators + (pChild->m_bSeparator ? 1 : 0);
+	}
+
+	if (pXTCD)
+	{
+		pXTCD->m_nChildren = nChildren;
+		pXTCD->m_nChecked = nChecked;
+		pXTCD->m_nTristate = nTristate;
+		pXTCD->m_nSeparators = nSeparators;
+
+		if (m_bSmartCheck && !pXTCD->m_bSeparator)
+		{
+			if (nChildren - nSeparators > 0)
+				pXTCD->m_bChecked = nChecked == (nChildren - nSeparators);
+			UpdateSelectedNode(pXTCD);
+			SetItemState(hItem, INDEXTOSTATEIMAGEMASK(GetStateImage(hItem)), TVIS_STATEIMAGEMASK);
+		}
+	}
+}
+
 //=============================================================================
 BOOL CTangramHtmlTreeWnd::EnableItem(HTREEITEM hItem, BOOL m_bEnabled)
 //=============================================================================
@@ -2352,7 +2508,7 @@ BOOL CTangramHtmlTreeWnd::GetCheck(HTREEITEM hItem)
 		{
 			if (m_bSmartCheck)
 			{
-				if (pXTCD->m_nChildren == 0)
+				if (pXTCD->m_nChildren - pXTCD->m_nSeparators <= 0)
 				{
 					rc = pXTCD->m_bChecked;
 				}
@@ -2454,17 +2610,23 @@ BOOL CTangramHtmlTreeWnd::DeleteItem(HTREEITEM hItem)
 			if (pXTCD->m_bChecked)
 				m_nDeletedChecked++;
 
-			HTREEITEM hParent = hItem;
-
-			// find all parents, decrement their children counts,
-			// adjust their checked counts and separator counts
-			while ((hParent = GetParentItem(hParent)) != NULL)
+			// a stub was never counted; an item from the XML model still
+			// counts the children that were never loaded
+			if (pPXTCD && pPXTCD->m_hXmlStub == hItem)
+			{
+				pPXTCD->m_hXmlStub = NULL;
+			}
+			else
 			{
-				IncrementChildren(hParent, -1);
-				if (pXTCD->m_bChecked)
-					SetCheckParent(hParent, -1);
-				if (pXTCD->m_bSeparator)					//+++1.6
-					IncrementSeparators(hParent, -1);
+				if (m_bVirtualXml && pXTCD->m_nXmlIndex >= 0)
+					m_XmlModel.Remove(pXTCD->m_nXmlIndex);
+
+				// take the item out of the counts of all its parents
+				UpdateParents(hItem, 
+							  -(1 + pXTCD->m_nChildren), 
+							  -(pXTCD->m_nChecked + (pXTCD->m_bChecked ? 1 : 0)), 
+							  -(pXTCD->m_nTristate + (IsMixed(hItem) ? 1 : 0)), 
+							  -(pXTCD->m_nSeparators + (pXTCD->m_bSeparator ? 1 : 0)));	//+++1.6
 			}
 
 			m_bDestroyingTree = true;
@@ -2488,6 +2650,8 @@ BOOL CTangramHtmlTreeWnd::DeleteItem(HTREEITEM hItem)
 			m_pHostXmlParse->Reflash();
 			delete m_pHostXmlParse;
 			m_pHostXmlParse = NULL;
+			m_XmlModel.Clear();
+			m_bVirtualXml = false;
 		}
 	}
 	return CTreeCtrl::DeleteItem(hItem);
@@ -2696,22 +2860,15 @@ HTREEITEM CTangramHtmlTreeWnd::InsertItem(LPTVINSERTSTRUCT lpInsertStruct, CTang
 		pXTCD->m_hItem = hItem;
 		TRACE(_T("count=%d\n"), m_DataMap.GetCount());
 
-		if (m_bSmartCheck)
-		{
-			HTREEITEM hParent = hItem;
-
-			// find all parents, increment their children counts,
-			// adjust their checked counts
-			int nCount = pXTCD->m_bChecked ? 1 : 0;
-			while ((hParent = GetParentItem(hParent)) != NULL)
-			{
-				IncrementChildren(hParent);
-				nCount = SetCheckParent(hParent, nCount);
-			}
-		}
+		// add the item to the counts of all its parents
+		if (!m_bDeferCounts)
+			UpdateParents(hItem, 1, pXTCD->m_bChecked ? 1 : 0, 0, 0);
 		if(pXTCD->m_bWaitingFor)
 		{
+			BOOL bOldDefer = m_bDeferCounts;
+			m_bDeferCounts = false;
 			pXTCD->m_hWaitItemMsg = InsertItem(_T("Loading..."),hItem,0);
+			m_bDeferCounts = bOldDefer;
 		}
 	}
 
@@ -2826,11 +2983,7 @@ HTREEITEM CTangramHtmlTreeWnd::InsertSeparator(HTREEITEM hItem)	//+++1.6
 	SetItemState(hSep, INDEXTOSTATEIMAGEMASK(0), TVIS_STATEIMAGEMASK);
 
 	// increment separator count in parents
-	hParent = hSep;
-	while ((hParent = GetParentItem(hParent)) != NULL)
-	{
-		IncrementSeparators(hParent, 1);
-	}
+	UpdateParents(hSep, 0, 0, 0, 1);
 
 	return hSep;
 }
@@ -3376,7 +3529,11 @@ void CTangramHtmlTreeWnd::ExpandBranch(HTREEITEM hItem)
 		{
 			do
 			{
-				ExpandBranch(hItem);
+				// a virtual tree only opens further what was loaded before
+				CTangramXHtmlTreeNode *pXTCD = GetItemDataStruct(hItem);
+				if (!m_bVirtualXml || !pXTCD || pXTCD->m_nXmlIndex < 0 || 
+					m_XmlModel.IsLoaded(pXTCD->m_nXmlIndex))
+					ExpandBranch(hItem);
 
 			} while ((hItem = GetNextSiblingItem(hItem)) != NULL);
 		}
@@ -3442,6 +3599,9 @@ BOOL CTangramHtmlTreeWnd::Expand(HTREEITEM hItem, UINT nCode)
 			else
 				pXTCD->m_bHasBeenExpanded = false;
 
+			if (pXTCD->m_bExpanded && m_bVirtualXml)
+				LoadXmlChildren(hItem);
+
 			if (pXTCD->m_bExpanded != bOldExpanded)
 				SendRegisteredMessage(WM_XHTMLTREE_ITEM_EXPANDED, hItem, 
 					pXTCD->m_bExpanded);
@@ -3792,14 +3952,27 @@ void CTangramHtmlTreeWnd::CheckAll(BOOL bCheck)
 		}
 		else
 		{
-			// check all items
+			// check all items, then count them once
 			HTREEITEM hItem = GetRootItem();
 
 			while (hItem)
 			{
-				SetCheck(hItem, bCheck);
+				CTangramXHtmlTreeNode *pXTCD = GetItemDataStruct(hItem);
+
+				if (pXTCD && pXTCD->m_bEnabled && !pXTCD->m_bSeparator)
+				{
+					pXTCD->m_bChecked = bCheck;
+					UpdateSelectedNode(pXTCD);
+					SetItemState(hItem, INDEXTOSTATEIMAGEMASK(GetStateImage(hItem)), TVIS_STATEIMAGEMASK);
+					SendRegisteredMessage(WM_XHTMLTREE_CHECKBOX_CLICKED, hItem, bCheck);
+				}
 				hItem = GetNextItem(hItem);		// get next sequential item
 			}
+
+			if (m_bVirtualXml)
+				m_XmlModel.SetCheckAll(bCheck ? true : false);
+
+			RebuildCheckCounts();
 		}
 	}
 }
@@ -3807,25 +3980,39 @@ void CTangramHtmlTreeWnd::CheckAll(BOOL bCheck)
 //=============================================================================
 int CTangramHtmlTreeWnd::GetCheckedCount()
 //=============================================================================
+{
+	if (!m_bCheckBoxes)
+		return 0;
+
+	// kept up to date by UpdateParents, including the items of the XML
+	// model that are not loaded
+	return m_nCheckedItems;
+}
+
+//=============================================================================
+int CTangramHtmlTreeWnd::GetChildrenCheckedCount(HTREEITEM hItem)
+//=============================================================================
 {
 	int rc = 0;
 
 	if (!m_bCheckBoxes)
 		return 0;
 
-	for (HTREEITEM hItem = GetRootItem();
-		 hItem != NULL; 
-		 hItem = GetNextItem(hItem))
+	if (!hItem)
+		hItem = GetRootItem();
+
+	CTangramXHtmlTreeNode *pXTCD = GetItemDataStruct(hItem);
+
+	if (pXTCD)
 	{
-		if (GetCheck(hItem))
-			rc++;
+		rc = pXTCD->m_nChecked;
 	}
 
 	return rc;
 }
 
 //=============================================================================
-int CTangramHtmlTreeWnd::GetChildrenCheckedCount(HTREEITEM hItem)
+int CTangramHtmlTreeWnd::GetChildrenTristateCount(HTREEITEM hItem)
 //=============================================================================
 {
 	int rc = 0;
@@ -3836,29 +4023,35 @@ int CTangramHtmlTreeWnd::GetChildrenCheckedCount(HTREEITEM hItem)
 	if (!hItem)
 		hItem = GetRootItem();
 
-	if (hItem && m_bSmartCheck)
-	{
-		CTangramXHtmlTreeNode *pXTCD = GetItemDataStruct(hItem);
+	CTangramXHtmlTreeNode *pXTCD = GetItemDataStruct(hItem);
 
-		if (pXTCD)
-		{
-			rc = pXTCD->m_nChecked;
-		}
-	}
-	else if (hItem && ItemHasChildren(hItem))
+	if (pXTCD)
 	{
-		HTREEITEM hChild = GetChildItem(hItem);
-		if (hChild)
-		{
-			do
-			{
-				if (GetCheck(hChild))
-					rc++;
+		rc = pXTCD->m_nTristate;
+	}
+
+	return rc;
+}
+
+//=============================================================================
+int CTangramHtmlTreeWnd::GetChildrenUncheckedCount(HTREEITEM hItem)
+//=============================================================================
+{
+	int rc = 0;
 
-				rc += GetChildrenCheckedCount(hChild);
+	if (!hItem)
+		hItem = GetRootItem();
 
-			} while ((hChild = GetNextSiblingItem(hChild)) != NULL);
-		}
+	CTangramXHtmlTreeNode *pXTCD = GetItemDataStruct(hItem);
+
+	if (pXTCD)
+	{
+		// separators have no checkbox, mixed items are not counted twice
+		rc = pXTCD->m_nChildren - pXTCD->m_nSeparators - pXTCD->m_nTristate;
+		if (m_bCheckBoxes)
+			rc -= pXTCD->m_nChecked;
+		if (rc < 0)
+			rc = 0;
 	}
 
 	return rc;
@@ -3901,27 +4094,11 @@ int CTangramHtmlTreeWnd::GetChildrenCount(HTREEITEM hItem)
 	if (!hItem)
 		hItem = GetRootItem();
 
-	if (hItem && m_bSmartCheck)
-	{
-		CTangramXHtmlTreeNode *pXTCD = GetItemDataStruct(hItem);
+	CTangramXHtmlTreeNode *pXTCD = GetItemDataStruct(hItem);
 
-		if (pXTCD)
-		{
-			rc = pXTCD->m_nChildren;
-		}
-	}
-	else if (hItem && ItemHasChildren(hItem))
+	if (pXTCD)
 	{
-		HTREEITEM hChild = GetChildItem(hItem);
-		if (hChild)
-		{
-			do
-			{
-				rc++;
-				rc += GetChildrenCount(hChild);
-
-			} while ((hChild = GetNextSiblingItem(hChild)) != NULL);
-		}
+		rc = pXTCD->m_nChildren;
 	}
 
 	return rc;
@@ -4484,6 +4661,41 @@ BOOL CTangramHtmlTreeWnd::OnSelchanging(NMHDR* pNMHDR, LRESULT* pResult)
 	return rc;
 }
 
+//=============================================================================
+BOOL CTangramHtmlTreeWnd::OnItemexpanding(NMHDR* pNMHDR, LRESULT* pResult) 
+//=============================================================================
+{
+	NMTREEVIEW* pNMTreeView = (NMTREEVIEW*)pNMHDR;
+
+	if (m_bVirtualXml && pNMTreeView->action == TVE_EXPAND)
+		LoadXmlChildren(pNMTreeView->itemNew.hItem);
+
+	*pResult = 0;
+	return false;	// allow parent to handle
+}
+
+//=============================================================================
+LRESULT CTangramHtmlTreeWnd::OnLoadXmlPage(WPARAM wParam, LPARAM /*lParam*/)
+//=============================================================================
+{
+	HTREEITEM hItem = (HTREEITEM)wParam;
+
+	CTangramXHtmlTreeNode *pXTCD = GetItemDataStruct(hItem);
+
+	if (m_bVirtualXml && pXTCD && pXTCD->m_hXmlStub && 
+		(GetItemState(hItem, TVIS_EXPANDED) & TVIS_EXPANDED))
+	{
+		// every paint of the stub posts this, load only while it is shown
+		CRect rectClient, rectStub, rect;
+		GetClientRect(&rectClient);
+		if (GetItemRect(pXTCD->m_hXmlStub, &rectStub, false) && 
+			rect.IntersectRect(&rectStub, &rectClient))
+			LoadXmlChildren(hItem);
+	}
+
+	return 0;
+}
+
 //=============================================================================
 void CTangramHtmlTreeWnd::OnSize(UINT nType, int cx, int cy) 
 //=============================================================================
@@ -4594,8 +4806,14 @@ BOOL CTangramHtmlTreeWnd::LoadXmlFromFile(LPCTSTR lpszFile, ConvertAction eConve
 		CTangramXmlParse m_Parse;
 		if(m_Parse.LoadFile(lpszFile))
 		{
+			// counted once the whole document is in
+			BOOL bOldDefer = m_bDeferCounts;
+			m_bDeferCounts = true;
 			HTREEITEM hRoot = InsertXmlItem(&m_Parse, 0);
 			LoadXml(&m_Parse, hRoot, m_nXmlCount);
+			m_bDeferCounts = bOldDefer;
+			if (!m_bDeferCounts)
+				RebuildCheckCounts();
 		}
 	}
 	else
@@ -4624,6 +4842,9 @@ HTREEITEM CTangramHtmlTreeWnd::LoadXmlFromString(LPCTSTR lpszXML, ConvertAction
 			CString strURL = m_Parse.attr(_T("url"),_T(""));
 			if(strURL==_T(""))
 			{
+				// counted once the whole document is in
+				BOOL bOldDefer = m_bDeferCounts;
+				m_bDeferCounts = true;
 				int nCount = m_Parse.GetCount();
 				for(int i=0;i<nCount;i++)
 				{
@@ -4632,6 +4853,9 @@ HTREEITEM CTangramHtmlTreeWnd::LoadXmlFromString(LPCTSTR lpszXML, ConvertAction
 						hFirstRoot = hRoot;
 					LoadXml(m_Parse.GetChild(i), hRoot, m_nXmlCount);
 				}
+				m_bDeferCounts = bOldDefer;
+				if (!m_bDeferCounts)
+					RebuildCheckCounts();
 				return hFirstRoot;
 			}
 			else
@@ -4718,6 +4942,33 @@ HTREEITEM CTangramHtmlTreeWnd::LoadXmlFromXmlParse(CTangramXmlParse* pParse)
 			CString strURL = pParse->attr(_T("url"),_T(""));
 			if(strURL==_T(""))
 			{
+				// a large document the tree owns gets items only for the
+				// branches that are opened; the parse must outlive the items
+				m_XmlModel.Clear();
+				m_bVirtualXml = false;
+				if (pParse == m_pHostXmlParse && m_nXmlVirtualThreshold > 0)
+				{
+					IndexXml(pParse, CXmlTreeModel::NONE);
+					m_XmlModel.Aggregate(m_bSmartCheck ? true : false);
+					m_bVirtualXml = m_XmlModel.GetCount() > m_nXmlVirtualThreshold;
+					if (!m_bVirtualXml)
+						m_XmlModel.Clear();
+				}
+				if (m_bVirtualXml)
+				{
+					for (int n = m_XmlModel.GetFirstRoot(); n != CXmlTreeModel::NONE; n = m_XmlModel.GetNextSibling(n))
+					{
+						HTREEITEM hRoot = InsertXmlModelItem(n, 0);
+						if(hFirstRoot==NULL)
+							hFirstRoot = hRoot;
+					}
+					RebuildCheckCounts();
+					return hFirstRoot;
+				}
+
+				// counted once the whole document is in
+				BOOL bOldDefer = m_bDeferCounts;
+				m_bDeferCounts = true;
 				int nCount = pParse->GetCount();
 				for(int i=0;i<nCount;i++)
 				{
@@ -4731,6 +4982,9 @@ HTREEITEM CTangramHtmlTreeWnd::LoadXmlFromXmlParse(CTangramXmlParse* pParse)
 						LoadXml(pChild, hRoot, m_nXmlCount);
 					}
 				}
+				m_bDeferCounts = bOldDefer;
+				if (!m_bDeferCounts)
+					RebuildCheckCounts();
 				return hFirstRoot;
 			}
 		}
@@ -4904,11 +5158,8 @@ HTREEITEM	CTangramHtmlTreeWnd::InsertXmlItem(CTangramXmlParse *pElement, HTREEIT
 					SetItemState(hItem, INDEXTOSTATEIMAGEMASK(0), TVIS_STATEIMAGEMASK);
 
 					// increment separator count in parents
-					HTREEITEM hParentSep = hItem;
-					while ((hParentSep = GetParentItem(hParentSep)) != NULL)
-					{
-						IncrementSeparators(hParentSep, 1);
-					}
+					if (!m_bDeferCounts)
+						UpdateParents(hItem, 0, 0, 0, 1);
 				}
 				else
 				{
@@ -4963,6 +5214,261 @@ BOOL CTangramHtmlTreeWnd::LoadXml(CTangramXmlParse *pElement, HTREEITEM hParent,
 	return rc;
 }
 
+//=============================================================================
+BOOL CTangramHtmlTreeWnd::IndexXml(CTangramXmlParse *pElement, int nParent)
+//=============================================================================
+{
+	// mirrors what LoadXml and InsertXmlItem would insert
+	BOOL bHeaders = false;
+	int nCount = pElement->GetCount();
+	for (int i = 0; i < nCount; i++)
+	{
+		CTangramXmlParse* pChild = pElement->GetChild(i);
+		CString strName = pChild->name();
+		if (!strName.CompareNoCase(_T("TangramScript")) || !strName.CompareNoCase(_T("TangramMenuScript")) || !strName.CompareNoCase(_T("TangramProperty")))
+			continue;
+		if (nParent != CXmlTreeModel::NONE && !bHeaders && strName == _T("headers"))
+		{
+			// InsertXmlItem takes it out of its parent
+			bHeaders = true;
+			continue;
+		}
+
+		CString strItemText = pChild->attr(_T("treecaption"), _T(""));
+		if (strItemText == _T(""))
+			strItemText = pChild->attr(_T("name"), _T(""));
+		if (strItemText == _T(""))
+			strItemText = strName;
+		if (strItemText.Compare(_T("...")) == 0)
+		{
+			// found '...'
+			if (nParent == CXmlTreeModel::NONE)
+				continue;
+			return false;
+		}
+
+		BOOL bSeparator = _ttoi(pChild->attr(_T("separator"), _T("0")));
+		BOOL bChecked = !bSeparator && _ttoi(pChild->attr(_T("checked"), _T("0")));
+		BOOL bEnabled = bSeparator || _ttoi(pChild->attr(_T("enabled"), _T("1")));
+		int nIndex = m_XmlModel.AddNode(nParent, pChild, bChecked ? true : false, bEnabled ? true : false, bSeparator ? true : false);
+		if (!IndexXml(pChild, nIndex) && nParent != CXmlTreeModel::NONE)
+			return false;
+	}
+
+	return true;
+}
+
+//=============================================================================
+HTREEITEM CTangramHtmlTreeWnd::InsertXmlModelItem(int nIndex, HTREEITEM hParent)
+//=============================================================================
+{
+	const XMLTREENODE& node = m_XmlModel.GetNode(nIndex);
+
+	BOOL bOldDefer = m_bDeferCounts;
+	m_bDeferCounts = true;
+	HTREEITEM hItem = InsertXmlItem((CTangramXmlParse*)node.m_pSource, hParent);
+	m_bDeferCounts = bOldDefer;
+
+	CTangramXHtmlTreeNode *pXTCD = GetItemDataStruct(hItem);
+
+	if (pXTCD)
+	{
+		// the counts cover the whole subtree, loaded or not
+		pXTCD->m_nXmlIndex   = nIndex;
+		pXTCD->m_nChildren   = node.m_nDescendants;
+		pXTCD->m_nChecked    = node.m_nChecked;
+		pXTCD->m_nTristate   = node.m_nTristate;
+		pXTCD->m_nSeparators = node.m_nSeparators;
+		if (!pXTCD->m_bSeparator && m_bCheckBoxes)
+		{
+			pXTCD->m_bChecked = node.m_bChecked;
+			SetItemState(hItem, INDEXTOSTATEIMAGEMASK(GetStateImage(hItem)), TVIS_STATEIMAGEMASK);
+		}
+		m_XmlModel.SetItem(nIndex, hItem);
+
+		if (node.m_nFirstChild != CXmlTreeModel::NONE)
+			AddXmlStub(hItem);
+	}
+
+	return hItem;
+}
+
+//=============================================================================
+void CTangramHtmlTreeWnd::AddXmlStub(HTREEITEM hItem)
+//=============================================================================
+{
+	CTangramXHtmlTreeNode *pXTCD = GetItemDataStruct(hItem);
+
+	if (pXTCD == NULL || pXTCD->m_hXmlStub)
+		return;
+
+	BOOL bOldDefer = m_bDeferCounts;
+	m_bDeferCounts = true;
+	HTREEITEM hStub = InsertItem(_T("..."), hItem);
+	m_bDeferCounts = bOldDefer;
+
+	CTangramXHtmlTreeNode *pStub = GetItemDataStruct(hStub);
+
+	if (pStub)
+	{
+		// no checkbox, and left alone by SetCheckChildren
+		pStub->m_bEnabled = false;
+		SetItemState(hStub, INDEXTOSTATEIMAGEMASK(0), TVIS_STATEIMAGEMASK);
+		pXTCD->m_hXmlStub = hStub;
+	}
+}
+
+//=============================================================================
+BOOL CTangramHtmlTreeWnd::IsXmlStub(HTREEITEM hItem)
+//=============================================================================
+{
+	CTangramXHtmlTreeNode *pXTCD = GetItemDataStruct(GetParentItem(hItem));
+
+	return pXTCD && pXTCD->m_hXmlStub == hItem;
+}
+
+//=============================================================================
+void CTangramHtmlTreeWnd::LoadXmlChildren(HTREEITEM hItem, BOOL bAll /*= FALSE*/)
+//=============================================================================
+{
+	CTangramXHtmlTreeNode *pXTCD = GetItemDataStruct(hItem);
+
+	if (!m_bVirtualXml || pXTCD == NULL || pXTCD->m_nXmlIndex < 0)
+		return;
+
+	int nIndex = pXTCD->m_nXmlIndex;
+	m_XmlModel.Touch(nIndex);
+
+	int nChild = m_XmlModel.GetPending(nIndex);
+	if (nChild == CXmlTreeModel::NONE)
+		return;
+
+	TRACE(_T("in CTangramHtmlTreeWnd::LoadXmlChildren:  <%s>\n"), GetItemText(hItem));
+
+	if (pXTCD->m_hXmlStub)
+		DeleteItem(pXTCD->m_hXmlStub);
+
+	int nLoaded = 0;
+	while (nChild != CXmlTreeModel::NONE && 
+		   (bAll || m_nXmlPageSize <= 0 || nLoaded < m_nXmlPageSize))
+	{
+		InsertXmlModelItem(nChild, hItem);
+		nChild = m_XmlModel.GetNextSibling(nChild);
+		nLoaded++;
+	}
+	m_XmlModel.SetPending(nIndex, nChild);
+
+	// the rest is loaded when the stub scrolls into view
+	if (nChild != CXmlTreeModel::NONE)
+		AddXmlStub(hItem);
+
+	if (!bAll)
+		TrimXmlItems(hItem);
+}
+
+//=============================================================================
+void CTangramHtmlTreeWnd::LoadXmlBranch(HTREEITEM hItem)
+//=============================================================================
+{
+	LoadXmlChildren(hItem, true);
+
+	for (HTREEITEM hChild = GetChildItem(hItem); hChild; hChild = GetNextSiblingItem(hChild))
+		LoadXmlBranch(hChild);
+}
+
+//=============================================================================
+BOOL CTangramHtmlTreeWnd::CanReleaseXmlChildren(HTREEITEM hItem)
+//=============================================================================
+{
+	HTREEITEM hSelected = GetSelectedItem();
+
+	for (HTREEITEM hChild = GetChildItem(hItem); hChild; hChild = GetNextSiblingItem(hChild))
+	{
+		// items that did not come from the model, or wait for data of their
+		// own, could not be recreated; handles held elsewhere must stay valid
+		CTangramXHtmlTreeNode *pXTCD = GetItemDataStruct(hChild);
+		if (pXTCD == NULL || pXTCD->m_bWaitingFor || 
+			(pXTCD->m_nXmlIndex < 0 && !IsXmlStub(hChild)))
+			return false;
+		if (hChild == hSelected || hChild == m_hCurSelectedItem || hChild == m_LasthItem ||
+			hChild == m_hHotItem || hChild == m_hAnchorItem || hChild == m_hPreviousItem ||
+			hChild == m_hItemButtonDown || hChild == m_hPreviousDropItem)
+			return false;
+		if (!CanReleaseXmlChildren(hChild))
+			return false;
+	}
+
+	return true;
+}
+
+//=============================================================================
+void CTangramHtmlTreeWnd::FreeXmlItemData(HTREEITEM hItem)
+//=============================================================================
+{
+	for (HTREEITEM hChild = GetChildItem(hItem); hChild; hChild = GetNextSiblingItem(hChild))
+		FreeXmlItemData(hChild);
+
+	CTangramXHtmlTreeNode *pXTCD = GetItemDataStruct(hItem);
+	m_DataMap.RemoveKey(hItem);
+	if (pXTCD)
+		delete pXTCD;
+}
+
+//=============================================================================
+void CTangramHtmlTreeWnd::ReleaseXmlChildren(HTREEITEM hItem)
+//=============================================================================
+{
+	CTangramXHtmlTreeNode *pXTCD = GetItemDataStruct(hItem);
+
+	if (pXTCD == NULL || pXTCD->m_nXmlIndex < 0)
+		return;
+
+	TRACE(_T("in CTangramHtmlTreeWnd::ReleaseXmlChildren:  <%s>\n"), GetItemText(hItem));
+
+	// the counts of hItem already cover its subtree, none of them change
+	HTREEITEM hChild = GetChildItem(hItem);
+	while (hChild)
+	{
+		HTREEITEM hNext = GetNextSiblingItem(hChild);
+		FreeXmlItemData(hChild);
+		CTreeCtrl::DeleteItem(hChild);
+		hChild = hNext;
+	}
+
+	pXTCD->m_hXmlStub = NULL;
+	pXTCD->m_bHasBeenExpanded = false;
+	m_XmlModel.ReleaseChildren(pXTCD->m_nXmlIndex);
+	AddXmlStub(hItem);
+}
+
+//=============================================================================
+void CTangramHtmlTreeWnd::TrimXmlItems(HTREEITEM hKeep)
+//=============================================================================
+{
+	if (!m_bVirtualXml || m_nXmlItemBudget <= 0 || 
+		m_XmlModel.GetItemCount() <= m_nXmlItemBudget)
+		return;
+
+	// collapsed branches go back to stubs, least recently opened first
+	vector<int> vLoaded;
+	m_XmlModel.GetLoadedByAge(vLoaded);
+
+	for (int nIndex : vLoaded)
+	{
+		if (m_XmlModel.GetItemCount() <= m_nXmlItemBudget)
+			break;
+
+		// a branch released with its parent earlier in this loop is gone
+		HTREEITEM hItem = (HTREEITEM)m_XmlModel.GetNode(nIndex).m_hItem;
+		if (hItem == NULL || !m_XmlModel.IsLoaded(nIndex))
+			continue;
+		if (IsChildNodeOf(hKeep, hItem) || (GetItemState(hItem, TVIS_EXPANDED) & TVIS_EXPANDED))
+			continue;
+		if (CanReleaseXmlChildren(hItem))
+			ReleaseXmlChildren(hItem);
+	}
+}
+
 //=============================================================================
 CString CTangramHtmlTreeWnd::GetXmlText(HTREEITEM hItem, LPCTSTR lpszElem)
 //=============================================================================
@@ -5596,11 +6102,7 @@ HTREEITEM CTangramHtmlTreeWnd::MoveItem(HTREEITEM hItem,
 			SetItemState(hNewItem, INDEXTOSTATEIMAGEMASK(0), TVIS_STATEIMAGEMASK);
 
 			// increment separator count
-			HTREEITEM hParent = hNewItem;
-			while ((hParent = GetParentItem(hParent)) != NULL)
-			{
-				IncrementSeparators(hParent, 1);
-			}
+			UpdateParents(hNewItem, 0, 0, 0, 1);
 		}
 
 #if 0  // -----------------------------------------------------------
@@ -5669,6 +6171,10 @@ BOOL CTangramHtmlTreeWnd::StartMoveBranch(HTREEITEM hItem,
 
 		if (rc)
 		{
+			// stubs cannot be copied, the branch moves as a whole
+			if (m_bVirtualXml)
+				LoadXmlBranch(hItem);
+
 			MoveBranch(hItem, hNewParent, hAfter);
 
 			if (!bCopyDrag)
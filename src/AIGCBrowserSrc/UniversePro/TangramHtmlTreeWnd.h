@@ -26,6 +26,7 @@
 
 #include <afxtempl.h>
 #include "XHtmlDraw.h"
+#include "XmlTreeModel.h"
 
 extern UINT WM_XHTMLTREE_CHECKBOX_CLICKED;
 extern UINT WM_XHTMLTREE_ITEM_EXPANDED;
@@ -121,10 +122,13 @@ struct CTangramXHtmlTreeNode
 		m_nType		       = 0;
 		m_nChildren        = 0;
 		m_nChecked         = 0;
+		m_nTristate        = 0;
 		m_nSeparators      = 0;
 		m_pszNote          = 0;
 		m_nTipWidth        = 0;
 		m_hWaitItemMsg	   = 0;
+		m_hXmlStub		   = 0;
+		m_nXmlIndex		   = -1;
 		m_pWebRTTreeNode = NULL;
 		m_hItem = NULL;
 		m_nCount++;
@@ -167,12 +171,15 @@ struct CTangramXHtmlTreeNode
 									// checked - an item in a "mixed" 
 									// state is counted as being 
 									// unchecked
+	int		m_nTristate;				// count of children that are in a
+									// "mixed" state
 	int		m_nSeparators;			// count of children that are separators
 	int		m_nType;
 	XobjType	m_nNodeType;
 	TCHAR * m_pszNote;				// note for tooltip
 	int		m_nTipWidth;				// width of tooltip for note
 	CXHtmlDraw::XHTMLDRAWSTRUCT ds;	// HTML draw info
+	CXHtmlDraw::XHTMLDRAWCACHE dcache;	// parsed runs and extents of the item text
 	static int m_nCount;				// incremented in ctor, decremented in dtor
 	
 	CTangramXmlParse*	m_pXmlParse;
@@ -181,6 +188,8 @@ struct CTangramXHtmlTreeNode
 	map<CString, CXobj*> m_mapBindNode;
 	HTREEITEM m_hItem;
 	HTREEITEM m_hWaitItemMsg;
+	HTREEITEM m_hXmlStub;				// placeholder for children not loaded yet
+	int		m_nXmlIndex;				// record in the tree's CXmlTreeModel, or -1
 	CString	m_strName;
 	CString	m_strTangramXML;
 	CString	m_strTangramXML2;
@@ -308,7 +317,10 @@ public:
 	int			GetChildrenCheckedCount(HTREEITEM hItem);
 	int			GetChildrenCount(HTREEITEM hItem);
 	int			GetChildrenDisabledCount(HTREEITEM hItem);
+	int			GetChildrenTristateCount(HTREEITEM hItem);
+	int			GetChildrenUncheckedCount(HTREEITEM hItem);
 	int			GetDefaultTipWidth();
+	void		GetHtmlCacheStats(UINT& nParses, UINT& nHits) { nParses = m_nHtmlParses; nHits = m_nHtmlCacheHits; }
 	COLORREF	GetDisabledColor(COLORREF color);
 	BOOL		GetDisplayToolTips() { return m_bToolTip; }
 	DWORD		GetDragOps() { return m_dwDragOps; }
@@ -345,6 +357,7 @@ public:
 	int			GetStateImage(HTREEITEM hItem);
 	BOOL		GetStripHtml() { return m_bStripHtml; }
 	COLORREF	GetTextColor() { return m_crCustomWindowText; }
+	int			GetTristateCount() { return m_bCheckBoxes ? m_nTristateItems : 0; }
 #ifdef XHTMLTOOLTIPS
 	CPPToolTip * GetToolTips() { return m_pToolTip; }
 #else
@@ -352,11 +365,13 @@ public:
 #endif // XHTMLTOOLTIPS
 	BOOL		GetUseLogfont() { return m_bLogFont; }
 	int			GetXmlCount() { return m_nXmlCount; }
+	CXmlTreeModel& GetXmlModel() { return m_XmlModel; }
 
 	BOOL		IsChecked(HTREEITEM hItem) { return GetCheck(hItem); }
 	BOOL		IsChildNodeOf(HTREEITEM hitem, HTREEITEM hitemSuspectedParent);
 	BOOL		IsEnabled(HTREEITEM hItem);
 	BOOL		IsExpanded(HTREEITEM hItem);
+	BOOL		IsMixed(HTREEITEM hItem);
 	HTREEITEM	IsOverItem(LPPOINT lpPoint = NULL);
 	BOOL		IsSelected(HTREEITEM hItem);
 	BOOL		IsSeparator(HTREEITEM hItem);
@@ -417,6 +432,13 @@ public:
 #endif // XHTMLTOOLTIPS
 	CTangramHtmlTreeWnd&	SetUseLogfont(BOOL bFlag) 
 				{ m_bLogFont = bFlag; return *this; }
+	CTangramHtmlTreeWnd&	SetXmlLoadLimits(int nVirtualThreshold, int nItemBudget, int nPageSize)
+				{ 
+					m_nXmlVirtualThreshold = nVirtualThreshold; 
+					m_nXmlItemBudget = nItemBudget; 
+					m_nXmlPageSize = nPageSize; 
+					return *this; 
+				}
 
 //=============================================================================
 // Operations
@@ -458,6 +480,7 @@ public:
 					HTREEITEM hParent = TVI_ROOT, 
 					HTREEITEM hInsertAfter = TVI_LAST);
 	HTREEITEM	InsertSeparator(HTREEITEM hItem);
+	void		RebuildCheckCounts();
 	void		RedrawItem(HTREEITEM hItem);
 	BOOL		SelectItem(HTREEITEM hItem);
 	HCURSOR		SetCursor(HCURSOR hCursor);
@@ -487,8 +510,20 @@ public:
 	BOOL		LoadXml(CTangramXmlParse *pElement, 
 							 HTREEITEM hParent,
 							 int& nCount);
+	void		LoadXmlChildren(HTREEITEM hItem, BOOL bAll = FALSE);
+	void		LoadXmlBranch(HTREEITEM hItem);
 
 protected:
+	// virtual loading: an XML host parse larger than m_nXmlVirtualThreshold
+	// is indexed into m_XmlModel and only opened branches get tree items
+	BOOL		IndexXml(CTangramXmlParse *pElement, int nParent);
+	HTREEITEM	InsertXmlModelItem(int nIndex, HTREEITEM hParent);
+	void		AddXmlStub(HTREEITEM hItem);
+	BOOL		IsXmlStub(HTREEITEM hItem);
+	BOOL		CanReleaseXmlChildren(HTREEITEM hItem);
+	void		ReleaseXmlChildren(HTREEITEM hItem);
+	void		FreeXmlItemData(HTREEITEM hItem);
+	void		TrimXmlItems(HTREEITEM hKeep);
 
 #endif // XHTMLXML
 
@@ -551,6 +586,20 @@ protected:
 											// file
 	int				m_nDeleted;
 	int				m_nDeletedChecked;
+	int				m_nCheckedItems;		// checked items in the whole tree
+	int				m_nTristateItems;		// items in a "mixed" state
+	UINT			m_nHtmlParses;			// item texts parsed by DrawItemTextHtml
+	UINT			m_nHtmlCacheHits;		// item texts drawn from the item's cache
+	CXmlTreeModel	m_XmlModel;				// index of the host parse when
+											// m_bVirtualXml is TRUE
+	BOOL			m_bVirtualXml;			// TRUE = items are loaded on expand
+	BOOL			m_bDeferCounts;			// TRUE = InsertItem leaves the counts
+											// of the parents to the caller
+	int				m_nXmlVirtualThreshold;	// indexed nodes above which loading
+											// is virtual, 0 = never
+	int				m_nXmlItemBudget;		// loaded items kept before collapsed
+											// branches are released
+	int				m_nXmlPageSize;			// children loaded per expand or scroll
 	CImageList		m_StateImage;
 	LOGFONT			m_lf;
 	int				m_nHorzPos;				// initial horz scroll position - saved
@@ -610,9 +659,13 @@ protected:
 	BOOL		IsOverAnchor(HTREEITEM hItem, CPoint point, CRect *pRect = NULL);
 	BOOL		PreDisplayToolTip(BOOL bAlwaysRemoveHtml, CString& strToolTip);
 	LRESULT		SendRegisteredMessage(UINT nMessage, HTREEITEM hItem, LPARAM lParam = 0);
-	int			SetCheckParent(HTREEITEM hItem, int nCount);
+	void		RebuildCheckCounts(HTREEITEM hItem);
+	void		SetCheckBranch(HTREEITEM hItem, BOOL fCheck);
 	void		SetColors();
 	void		SetHotItem(HTREEITEM hItem, UINT nFlags);
+	void		UpdateParents(HTREEITEM hItem, int nChildren, int nChecked, 
+							  int nTristate, int nSeparators);
+	void		UpdateSelectedNode(CTangramXHtmlTreeNode *pXTCD);
 
 #ifdef XHTMLDRAGDROP
 	HCURSOR		GetDragCursor();
@@ -671,6 +724,8 @@ public:
 
 	afx_msg BOOL OnSelchanged(NMHDR * pNMHDR, LRESULT * pResult);
 	afx_msg BOOL OnSelchanging(NMHDR * pNMHDR, LRESULT * pResult);
+	afx_msg BOOL OnItemexpanding(NMHDR * pNMHDR, LRESULT * pResult);
+	afx_msg LRESULT OnLoadXmlPage(WPARAM wParam, LPARAM lParam);
 
 	DECLARE_MESSAGE_MAP()
 };
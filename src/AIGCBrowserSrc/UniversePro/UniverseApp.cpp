@@ -78,6 +78,7 @@
 #include "Xobj.h"
 #include "WinNucleus.h"
 #include "WPFView.h"
+#include "XTraceSink.h"
 #include <io.h>
 #include <stdio.h>
 
@@ -321,6 +322,7 @@ int CUniverse::ExitInstance()
 		g_pSpaceTelescope->ExitInstance();
 	}
 	AfxOleTerm(FALSE);
+	CXTraceSink::Instance().Shutdown();
 	ATLTRACE(_T("End Tangram ExitInstance :%p\n"), this);
 
 	return CWinApp::ExitInstance();
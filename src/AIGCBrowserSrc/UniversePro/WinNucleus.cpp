@@ -35,6 +35,7 @@
 #include "TangramHtmlTreeWnd.h"
 #include "EclipsePlus\EclipseAddin.h"
 #include "Wormhole.h"
+#include "LayoutDiff.h"
 
 /////////////////////////////////////////////////////////////////////////////
 // CWebRTTreeCtrl
@@ -2611,6 +2612,10 @@ CNucleus::CNucleus()
 	m_pWebRTFrameWndInfo = nullptr;
 	m_pParentMDIWinForm = nullptr;
 	m_pWebViewWnd = NULL;
+	m_pLayoutGeneration = make_shared<std::atomic<long>>(0);
+	m_pPrewarmGeneration = make_shared<std::atomic<long>>(0);
+	m_pCommitQueue = make_shared<CLayoutPlanQueue>();
+	m_pPrewarmQueue = make_shared<CLayoutPlanQueue>();
 #ifdef _DEBUG
 	g_pSpaceTelescope->m_nTangramFrame++;
 #endif
@@ -2621,6 +2626,12 @@ CNucleus::~CNucleus()
 #ifdef _DEBUG
 	g_pSpaceTelescope->m_nTangramFrame--;
 #endif	
+	// cancel any layout still being prepared for this nucleus
+	++(*m_pLayoutGeneration);
+	++(*m_pPrewarmGeneration);
+	if (m_LayoutPredictor.m_bDirty)
+		m_LayoutPredictor.Save(GetLayoutHistoryFile());
+	g_pSpaceTelescope->m_LayoutEviction.RemoveOwner(this);
 	//if (m_pNucleusInfo)
 	//	delete m_pNucleusInfo;
 	if (g_pSpaceTelescope->m_pNucleus == this)
@@ -2723,7 +2734,7 @@ CTangramXmlParse* CNucleus::UpdateXobj()
 		if (pWndXobj)
 		{
 			if (pWndXobj->m_pWindow) {
-				if (pWndXobj->m_nActivePage > 0) {
+				if (pWndXobj->m_nActivePage > 0 && pWndXobj->m_pHostParse->attrInt(_T("activepage"), 0) != pWndXobj->m_nActivePage) {
 					CString strVal = _T("");
 					strVal.Format(_T("%d"), pWndXobj->m_nActivePage);
 					pWndXobj->m_pHostParse->put_attr(_T("activepage"), strVal);
@@ -2740,7 +2751,7 @@ CTangramXmlParse* CNucleus::UpdateXobj()
 			}
 
 			if (pWndXobj == pWndXobj->m_pRootObj && pWndXobj->m_pXobjShareData->m_pOfficeObj) {
-				g_pSpaceTelescope->UpdateOfficeObj(pWndXobj->m_pXobjShareData->m_pOfficeObj, pWndXobj->m_pXobjShareData->m_pWebRTParse->GetChild(TGM_NUCLEUS)->xml(), pWndXobj->m_pXobjShareData->m_pWebRTParse->name());
+				g_pSpaceTelescope->UpdateOfficeObj(pWndXobj->m_pXobjShareData->m_pOfficeObj, pWndXobj->m_pXobjShareData->m_pWebRTParse->GetChild(TGM_NUCLEUS)->xmlCached(), pWndXobj->m_pXobjShareData->m_pWebRTParse->name());
 			}
 		}
 	}
@@ -3060,16 +3071,343 @@ STDMETHODIMP CNucleus::get_Nuclei(INuclei** pVal)
 	return S_OK;
 }
 
+// how many predicted layouts are prepared ahead after each navigation
+#define LAYOUT_PREWARM_COUNT	2
+// rough per-window cost (window, view object, hosted control) for layout budgets
+#define LAYOUT_BYTES_PER_WINDOW	4096
+
+static const TCHAR* g_lpszDefaultLayoutXml = _T("<default><nucleus><xobj  objid='nucleus' /></nucleus></default>");
+
+static CString LayoutJsonToXml(const CString& strJson)
+{
+	wstring _strJson = LPCTSTR(strJson);
+	return theApp.json_to_xml(_strJson).c_str();
+}
+
 STDMETHODIMP CNucleus::Observe(BSTR bstrKey, BSTR bstrXml, IXobj** ppRetXobj)
 {
-	CString _strXml = OLE2T(bstrXml);
-	_strXml.Trim();
-	if (_strXml.Find(_T("{")) == 0) {
-		wstring strJson = LPCTSTR(_strXml);
-		_strXml = theApp.json_to_xml(strJson).c_str();
-		if (_strXml == _T(""))
-			return S_FALSE;
+	return ObserveLayout(OLE2T(bstrKey), OLE2T(bstrXml), nullptr, ppRetXobj);
+}
+
+task<CLayoutPlanPtr> CNucleus::PrepareLayout(CString& strKey, CString& strXml)
+{
+	strKey.Trim();
+	if (strKey == _T(""))
+		strKey = _T("default");
+	strKey.MakeLower();
+	strXml.Trim();
+
+	// a new request is a navigation: older prepares stop and are never committed
+	long nGeneration = ++(*m_pLayoutGeneration);
+	if (m_mapXobj.find(strKey) != m_mapXobj.end())
+		return task_from_result(CLayoutPlanPtr());
+
+	// resolving the source may ask the host window, so it stays on this thread
+	CString strPlanKey = strKey;
+	CString strSourceXml = GetLayoutXml(strKey, strXml);
+	shared_ptr<std::atomic<long>> pGeneration = m_pLayoutGeneration;
+	return create_task([strPlanKey, strSourceXml, nGeneration, pGeneration]()
+		{
+			return CLayoutPlan::Prepare(strPlanKey, strSourceXml, nGeneration, *pGeneration, LayoutJsonToXml);
+		});
+}
+
+void CNucleus::ObserveAsync(CString strKey, CString strXml)
+{
+	task<CLayoutPlanPtr> tPrepare = PrepareLayout(strKey, strXml);
+	if (m_mapXobj.find(strKey) != m_mapXobj.end())
+	{
+		IXobj* pXobj = nullptr;
+		ObserveLayout(strKey, strXml, nullptr, &pXobj);
+		return;
 	}
+
+	shared_ptr<std::atomic<long>> pGeneration = m_pLayoutGeneration;
+	CLayoutPlanQueuePtr pQueue = m_pCommitQueue;
+	HWND hWnd = m_hWnd;
+	tPrepare.then([pGeneration, pQueue, hWnd](CLayoutPlanPtr pPlan)
+		{
+			if (pPlan && pGeneration->load() == pPlan->m_nGeneration)
+			{
+				pQueue->Push(pPlan);
+				::PostMessage(hWnd, WM_COSMOSMSG, 0, 20261019);
+			}
+		});
+}
+
+void CNucleus::PrewarmLayouts()
+{
+	vector<CString> vKeys;
+	m_LayoutPredictor.Predict(m_strCurrentKey, LAYOUT_PREWARM_COUNT * 4, vKeys);
+	long nGeneration = ++(*m_pPrewarmGeneration);
+
+	// Only sources already in memory are picked up here; layouts of the page
+	// file are read on the worker pool. The host window is not asked ahead of
+	// time (WM_HUBBLE_GETXML): if it answers differently once the key is
+	// observed, Take sees the other source and drops the plan.
+	vector<pair<CString, CString>> vSources;
+	vector<CString> vPageKeys;
+	CString strMapKey = _T("@") + m_strNucleusName + _T("@") + m_pNuclei->m_strConfigFileNodeName;
+	bool bPageFile = m_pNuclei->m_bDoc == false && m_pNuclei->m_strConfigFileNodeName != _T("") && m_pNuclei->m_strPageFilePath != _T("");
+	for (auto& strKey : vKeys)
+	{
+		if ((int)(vSources.size() + vPageKeys.size()) == LAYOUT_PREWARM_COUNT)
+			break;
+		if (strKey == _T("newdocument") || m_mapXobj.find(strKey) != m_mapXobj.end() || m_LayoutPredictor.IsParked(strKey))
+			continue;
+		auto itEvicted = m_mapEvictedXml.find(strKey);
+		auto itKey = m_pNuclei->m_strMapKey.find(strKey + strMapKey);
+		if (itEvicted != m_mapEvictedXml.end())
+			vSources.push_back(make_pair(strKey, itEvicted->second));
+		else if (itKey != m_pNuclei->m_strMapKey.end())
+			vSources.push_back(make_pair(strKey, itKey->second));
+		else if (bPageFile)
+			vPageKeys.push_back(strKey);
+	}
+	if (vSources.size() + vPageKeys.size() == 0)
+		return;
+
+	shared_ptr<std::atomic<long>> pGeneration = m_pPrewarmGeneration;
+	CLayoutPlanQueuePtr pQueue = m_pPrewarmQueue;
+	HWND hWnd = m_hWnd;
+	CString strPageFile = m_pNuclei->m_strPageFilePath;
+	CString strConfig = m_pNuclei->m_strConfigFileNodeName;
+	auto t = create_task([vSources, vPageKeys, strPageFile, strConfig, strMapKey, nGeneration, pGeneration, pQueue, hWnd]() mutable
+		{
+			if (vPageKeys.size())
+			{
+				map<CString, CString> mapXml;
+				CLayoutTree::ReadPageLayouts(strPageFile, strConfig, mapXml);
+				for (auto& strKey : vPageKeys)
+				{
+					auto it = mapXml.find(strKey + strMapKey);
+					if (it != mapXml.end())
+						vSources.push_back(make_pair(strKey, it->second));
+				}
+			}
+			for (auto& it : vSources)
+			{
+				CLayoutPlanPtr pPlan = CLayoutPlan::Prepare(it.first, it.second, nGeneration, *pGeneration, LayoutJsonToXml);
+				if (pGeneration->load() != nGeneration)
+					return;
+				if (pPlan && pPlan->m_bValid)
+				{
+					pQueue->Push(pPlan);
+					::PostMessage(hWnd, WM_COSMOSMSG, 0, 20261021);
+				}
+			}
+		});
+}
+
+CString CNucleus::GetLayoutHistoryFile()
+{
+	CString strName = m_strNucleusName == _T("") ? CString(_T("default")) : m_strNucleusName;
+	return g_pSpaceTelescope->m_strAppDataPath + strName + _T(".layouthistory");
+}
+
+static BOOL CALLBACK CountLayoutWindows(HWND hWnd, LPARAM lParam)
+{
+	(*(long*)lParam)++;
+	return TRUE;
+}
+
+static long CountLayoutNodes(CXobj* pXobj)
+{
+	long nCount = 1;
+	for (auto& it : pXobj->m_vChildNodes)
+		nCount += CountLayoutNodes(it);
+	return nCount;
+}
+
+LayoutUsage CNucleus::MeasureLayout(CXobj* pRootXobj)
+{
+	LayoutUsage usage = { 0, 0, 0 };
+	usage.m_nNodes = CountLayoutNodes(pRootXobj);
+	if (pRootXobj->m_pHostWnd && ::IsWindow(pRootXobj->m_pHostWnd->m_hWnd))
+	{
+		usage.m_nHandles = 1;
+		::EnumChildWindows(pRootXobj->m_pHostWnd->m_hWnd, CountLayoutWindows, (LPARAM)&usage.m_nHandles);
+	}
+	usage.m_nBytes = pRootXobj->m_strCosmosXml.GetLength() * sizeof(TCHAR) + usage.m_nNodes * sizeof(CXobj) + usage.m_nHandles * LAYOUT_BYTES_PER_WINDOW;
+	return usage;
+}
+
+bool CNucleus::IsLayoutPinned(CXobj* pRootXobj)
+{
+	if (m_mapPinnedLayout.find(pRootXobj->m_strKey) != m_mapPinnedLayout.end())
+		return true;
+	// the default layout's parse is published as the CosmosData window property
+	if (pRootXobj->m_strKey.CompareNoCase(_T("default")) == 0)
+		return true;
+	if (pRootXobj->m_pHostParse && pRootXobj->m_pHostParse->attrBool(_T("pinned"), false))
+		return true;
+	if (pRootXobj->m_pXobjShareData->m_pOfficeObj)
+		return true;
+	// nodes the nucleus still points at must survive
+	if ((m_pBindingXobj && m_pBindingXobj->m_pRootObj == pRootXobj) || (m_pHostWebBrowserNode && m_pHostWebBrowserNode->m_pRootObj == pRootXobj))
+		return true;
+	if (m_pHostWebBrowserWnd && ::IsWindow(m_pHostWebBrowserWnd->m_hWnd) && pRootXobj->m_pHostWnd && ::IsChild(pRootXobj->m_pHostWnd->m_hWnd, m_pHostWebBrowserWnd->m_hWnd))
+		return true;
+	return false;
+}
+
+void CNucleus::PinLayout(CString strKey, bool bPin)
+{
+	strKey.MakeLower();
+	if (bPin)
+		m_mapPinnedLayout[strKey] = true;
+	else
+		m_mapPinnedLayout.erase(strKey);
+	auto it = m_mapXobj.find(strKey);
+	bool bPinned = bPin;
+	if (bPin == false && it != m_mapXobj.end())
+		bPinned = IsLayoutPinned(it->second);
+	g_pSpaceTelescope->m_LayoutEviction.SetPinned(this, strKey, bPinned);
+}
+
+void CNucleus::TrackLayouts(CXobj* pOldXobj)
+{
+	CLayoutEvictionManager& manager = g_pSpaceTelescope->m_LayoutEviction;
+	if (pOldXobj && pOldXobj != m_pWorkXobj && pOldXobj->m_strKey != _T(""))
+	{
+		manager.Track(this, pOldXobj->m_strKey, MeasureLayout(pOldXobj), true);
+		manager.SetPinned(this, pOldXobj->m_strKey, IsLayoutPinned(pOldXobj));
+	}
+	manager.Track(this, m_strCurrentKey, MeasureLayout(m_pWorkXobj), false);
+
+	vector<LayoutEntry> vVictims;
+	if (manager.Collect(vVictims))
+	{
+		int nEvicted = 0;
+		for (auto& it : vVictims)
+		{
+			if (((CNucleus*)it.m_pOwner)->EvictLayout(it.m_strKey))
+			{
+				manager.Evicted(it.m_pOwner, it.m_strKey);
+				nEvicted++;
+			}
+		}
+		TRACE(_T("layout eviction: %d of %d evicted, %ld total, %ld restored\n"), nEvicted, (int)vVictims.size(), manager.m_nEvicted, manager.m_nRestored);
+	}
+}
+
+bool CNucleus::EvictLayout(CString strKey)
+{
+	// a layout that cannot go stays tracked, with what kept it corrected so
+	// the policy does not pick it again
+	CLayoutEvictionManager& manager = g_pSpaceTelescope->m_LayoutEviction;
+	auto it = m_mapXobj.find(strKey);
+	if (it == m_mapXobj.end())
+	{
+		manager.Remove(this, strKey);
+		return false;
+	}
+	CXobj* pRootXobj = it->second;
+	if (pRootXobj == m_pWorkXobj || pRootXobj->m_pHostWnd == nullptr)
+	{
+		manager.Track(this, strKey, MeasureLayout(pRootXobj), false);
+		return false;
+	}
+	if (IsLayoutPinned(pRootXobj))
+	{
+		manager.SetPinned(this, strKey, true);
+		return false;
+	}
+
+	// bring the live state (splitter sizes, active pages) into the parse first, as UpdateXobj does
+	if (pRootXobj->m_pWindow) {
+		if (pRootXobj->m_nActivePage > 0 && pRootXobj->m_pHostParse->attrInt(_T("activepage"), 0) != pRootXobj->m_nActivePage) {
+			CString strVal = _T("");
+			strVal.Format(_T("%d"), pRootXobj->m_nActivePage);
+			pRootXobj->m_pHostParse->put_attr(_T("activepage"), strVal);
+		}
+		pRootXobj->m_pWindow->Save();
+	}
+	if (pRootXobj->m_nViewType == Grid)
+		((CGridWnd*)pRootXobj->m_pHostWnd)->Save();
+	for (auto& it2 : pRootXobj->m_vChildNodes)
+		g_pSpaceTelescope->UpdateXobj(it2);
+	m_mapEvictedXml[strKey] = pRootXobj->m_pXobjShareData->m_pWebRTParse->xmlCached();
+
+	// PostNcDestroy deletes the xobj tree and ~CXobj drops the key from m_mapXobj
+	pRootXobj->m_pHostWnd->DestroyWindow();
+	return true;
+}
+
+CString CNucleus::GetLayoutXml(CString strKey, CString strXml)
+{
+	// an evicted layout comes back the way it was left
+	auto itEvicted = m_mapEvictedXml.find(strKey);
+	if (itEvicted != m_mapEvictedXml.end())
+		return itEvicted->second;
+
+	CString strRet = _T("");
+	LRESULT l = ::SendMessage(m_pNuclei->m_hWnd, WM_HUBBLE_GETXML, (WPARAM)LPCTSTR(m_strNucleusName), (WPARAM)LPCTSTR(strKey));
+	if (l)
+	{
+		if (m_strCurrentXml != _T(""))
+		{
+			strRet = m_strCurrentXml;
+			m_strCurrentXml = _T("");
+		}
+		else
+		{
+			auto it = g_pSpaceTelescope->m_mapValInfo.find(m_strNucleusName + L"_" + strKey);
+			if (it != g_pSpaceTelescope->m_mapValInfo.end())
+			{
+				strRet = OLE2T(it->second.bstrVal);
+			}
+			else
+			{
+				strRet = (LPCTSTR)l;
+			}
+		}
+	}
+	else
+	{
+		if (m_strCurrentXml != _T(""))
+		{
+			strRet = m_strCurrentXml;
+			m_strCurrentXml = _T("");
+		}
+		else if (strKey != _T("newdocument"))
+		{
+			CString _str = _T("@") + m_strNucleusName + _T("@") + m_pNuclei->m_strConfigFileNodeName;
+			CString _strKey = strKey + _str;
+			auto itKey = m_pNuclei->m_strMapKey.find(_strKey);
+			if (itKey != m_pNuclei->m_strMapKey.end()) {
+				strRet = itKey->second;
+			}
+			else
+			{
+				if (m_pNuclei->m_bDoc == false && ::PathFileExists(m_pNuclei->m_strPageFilePath))
+				{
+					// <app><hubblepage><config><nucleus name><key>layout</key>..., read
+					// the way PrewarmLayouts reads it ahead of time, so a prewarmed
+					// plan is taken for the same text
+					if (m_pNuclei->m_strConfigFileNodeName != _T(""))
+						CLayoutTree::ReadPageLayouts(m_pNuclei->m_strPageFilePath, m_pNuclei->m_strConfigFileNodeName, m_pNuclei->m_strMapKey);
+
+					auto itKey = m_pNuclei->m_strMapKey.find(_strKey);
+					if (strRet == _T("") && itKey != m_pNuclei->m_strMapKey.end()) {
+						strRet = itKey->second;
+					}
+				}
+			}
+			if (strRet == _T(""))
+				strRet = strXml;
+			if (strRet == _T(""))
+				strRet = g_lpszDefaultLayoutXml;
+		}
+		else
+			strRet = strXml;
+	}
+	return strRet;
+}
+
+HRESULT CNucleus::ObserveLayout(CString strKey, CString _strXml, CLayoutPlanPtr pPlan, IXobj** ppRetXobj)
+{
+	_strXml.Trim();
 	if (m_pNuclei->m_strPageFileName == _T(""))
 	{
 		m_pNuclei->m_strPageFileName = g_pSpaceTelescope->m_strExeName;
@@ -3080,11 +3418,18 @@ STDMETHODIMP CNucleus::Observe(BSTR bstrKey, BSTR bstrXml, IXobj** ppRetXobj)
 	CommonThreadInfo* pThreadInfo = g_pSpaceTelescope->GetThreadInfo(dwID);
 	theApp.SetHook(dwID);
 
-	CString strCurrentKey = OLE2T(bstrKey);
+	CString strCurrentKey = strKey;
 	if (strCurrentKey == _T(""))
 		strCurrentKey = _T("default");
+	strCurrentKey.MakeLower();
+	if (m_bLayoutHistoryLoaded == false)
+	{
+		m_bLayoutHistoryLoaded = true;
+		m_LayoutPredictor.Load(GetLayoutHistoryFile());
+	}
 	if (m_strCurrentKey != strCurrentKey)
 	{
+		m_LayoutPredictor.Record(m_strCurrentKey, strCurrentKey);
 		m_strLastKey = m_strCurrentKey;
 		m_strCurrentKey = strCurrentKey;
 	}
@@ -3095,6 +3440,8 @@ STDMETHODIMP CNucleus::Observe(BSTR bstrKey, BSTR bstrXml, IXobj** ppRetXobj)
 	g_pSpaceTelescope->m_strCurrentKey = m_strCurrentKey;
 	CString strXml = _T("");
 	CXobj* pOldNode = m_pWorkXobj;
+	// whatever ObserveAsync still prepares is for an older request now
+	++(*m_pLayoutGeneration);
 
 	bool bExists = false;
 	auto it = m_mapXobj.find(m_strCurrentKey);
@@ -3115,111 +3462,57 @@ STDMETHODIMP CNucleus::Observe(BSTR bstrKey, BSTR bstrXml, IXobj** ppRetXobj)
 	}
 	else
 	{
-		bool bAtTemplate = false;
-
-		LRESULT l = ::SendMessage(m_pNuclei->m_hWnd, WM_HUBBLE_GETXML, (WPARAM)LPCTSTR(m_strNucleusName), (WPARAM)LPCTSTR(m_strCurrentKey));
-		if (l)
+		// a plan handed in by ObserveAsync or prewarmed during idle time
+		// carries the document already parsed on the worker pool; without
+		// one ObserveEx parses the text here, as it always did
+		if (pPlan == nullptr || pPlan->m_strKey != m_strCurrentKey)
 		{
-			if (m_strCurrentXml != _T(""))
-			{
-				strXml = m_strCurrentXml;
-				m_strCurrentXml = _T("");
-			}
-			else
+			CString strSourceXml = GetLayoutXml(m_strCurrentKey, _strXml);
+			pPlan = m_LayoutPredictor.Take(m_strCurrentKey, strSourceXml);
+#ifdef _DEBUG
+			// how well the prewarming guesses, one line per layout that is not alive
+			TRACE(_T("%s\n"), (LPCTSTR)m_LayoutPredictor.GetStats());
+#endif
+			if (pPlan == nullptr)
 			{
-				auto it = g_pSpaceTelescope->m_mapValInfo.find(m_strNucleusName + L"_" + m_strCurrentKey);
-				if (it != g_pSpaceTelescope->m_mapValInfo.end())
-				{
-					strXml = OLE2T(it->second.bstrVal);
-				}
-				else
-				{
-					strXml = (LPCTSTR)l;
-				}
+				CString strError;
+				strXml = CLayoutTree::Normalize(strSourceXml, LayoutJsonToXml, strError);
 			}
 		}
-		else
+		if (pPlan)
+			strXml = pPlan->m_strXml;
+		if (strXml == _T(""))
+			return S_FALSE;
+		// the layout tools read layouts with CMarkup, the windows are built
+		// from MSXML; debug builds, and applications that set auditlayouts,
+		// compare the two on the worker pool
+		if (g_pSpaceTelescope->m_bAuditLayouts)
 		{
-			if (m_strCurrentXml != _T(""))
-			{
-				strXml = m_strCurrentXml;
-				m_strCurrentXml = _T("");
-			}
-			else
-			{
-				if (bAtTemplate == false)
+			CString strDiffKey = m_strCurrentKey;
+			auto tDiff = create_task([strDiffKey, strXml]()
 				{
-					if (m_strCurrentKey != _T("newdocument"))
-					{
-						CString _str = _T("@") + m_strNucleusName + _T("@") + m_pNuclei->m_strConfigFileNodeName;
-						CString strKey2 = OLE2T(bstrKey);
-						strKey2.MakeLower();
-						if (strKey2 == _T(""))
-							strKey2 = _T("default");
-						CString _strKey = strKey2 + _str;
-						auto itKey = m_pNuclei->m_strMapKey.find(_strKey);
-						if (itKey != m_pNuclei->m_strMapKey.end()) {
-							strXml = itKey->second;
-						}
-						else
-						{
-							CTangramXmlParse* m_pWebRTPageParse = nullptr;
-							CTangramXmlParse* m_pWebRTPageParse2 = nullptr;
-							if (m_pNuclei->m_bDoc == false && ::PathFileExists(m_pNuclei->m_strPageFilePath))
-							{
-								CTangramXmlParse m_Parse;
-								if (m_Parse.LoadFile(m_pNuclei->m_strPageFilePath))
-								{
-									m_pWebRTPageParse = m_Parse.GetChild(_T("hubblepage"));
-									if (m_pWebRTPageParse)
-									{
-										m_pWebRTPageParse2 = m_pWebRTPageParse->GetChild(m_pNuclei->m_strConfigFileNodeName);
-										if (m_pWebRTPageParse2)
-										{
-											int nCount = m_pWebRTPageParse2->GetCount();
-											for (int i = 0; i < nCount; i++)
-											{
-												CTangramXmlParse* _pParse = m_pWebRTPageParse2->GetChild(i);
-												CString _str = _T("@") + _pParse->name() + _T("@") + m_pNuclei->m_strConfigFileNodeName;
-												int nCount2 = _pParse->GetCount();
-												for (int i = 0; i < nCount2; i++)
-												{
-													CTangramXmlParse* _pParse2 = _pParse->GetChild(i);
-													m_pNuclei->m_strMapKey[_pParse2->name() + _str] = _pParse2->xml();
-												}
-											}
-										}
-									}
-								}
-
-								auto itKey = m_pNuclei->m_strMapKey.find(_strKey);
-								if (strXml == _T("") && itKey != m_pNuclei->m_strMapKey.end()) {
-									strXml = itKey->second;
-								}
-							}
-						}
-						if (strXml == _T(""))
-							strXml = _strXml;
-						if (strXml == _T(""))
-							strXml = _T("<default><nucleus><xobj  objid='nucleus' /></nucleus></default>");;
-					}
-					else
-						strXml = _strXml;
-				}
-			}
+					CLayoutDiff::Audit(strDiffKey, strXml);
+				});
 		}
 
+		// commit: only window creation and positioning from here on
 		Unlock();
 		m_pNuclei->Fire_BeforeOpenXml(CComBSTR(strXml), (long)m_hHostWnd);
 
 		m_bNoRedrawState = false;
-		m_pWorkXobj = g_pSpaceTelescope->ObserveEx((long)m_hHostWnd, _T(""), strXml);
+		m_pWorkXobj = g_pSpaceTelescope->ObserveEx((long)m_hHostWnd, _T(""), strXml, pPlan ? pPlan->m_pDoc.p : nullptr);
 		if (m_pWorkXobj == nullptr)
 		{
 			return S_FALSE;
 		}
 		if (::GetWindowLong(::GetParent(m_hWnd), GWL_EXSTYLE) & WS_EX_MDICHILD)
 			m_bMDIChild = true;
+		auto itEvicted = m_mapEvictedXml.find(m_strCurrentKey);
+		if (itEvicted != m_mapEvictedXml.end())
+		{
+			m_mapEvictedXml.erase(itEvicted);
+			g_pSpaceTelescope->m_LayoutEviction.m_nRestored++;
+		}
 	}
 
 	g_pSpaceTelescope->ModifyBindingXobj(this, m_pWorkXobj->m_pXobjShareData->m_pHostClientView ? m_pWorkXobj->m_pXobjShareData->m_pHostClientView->m_pXobj : nullptr);
@@ -3328,6 +3621,8 @@ STDMETHODIMP CNucleus::Observe(BSTR bstrKey, BSTR bstrXml, IXobj** ppRetXobj)
 	{
 		it.second->OnObserveComplete(m_hHostWnd, strXml, m_pWorkXobj);
 	}
+	TrackLayouts(pOldNode);
+	::PostMessage(m_hWnd, WM_COSMOSMSG, 0, 20261020);
 	if (g_pSpaceTelescope->m_pWebRTAppProxy)
 		g_pSpaceTelescope->m_pWebRTAppProxy->OnObserveComplete(m_hHostWnd, strXml, m_pWorkXobj);
 
@@ -3773,6 +4068,41 @@ LRESULT CNucleus::OnWebRTMsg(UINT uMsg, WPARAM wParam, LPARAM lParam, BOOL&)
 {
 	switch (lParam)
 	{
+	case 20261019:
+	{
+		// layout plans prepared by ObserveAsync; only one of the current
+		// request can be pending, older ones are dropped
+		CLayoutPlanPtr pCommit;
+		while (CLayoutPlanPtr pPlan = m_pCommitQueue->Pop())
+		{
+			if (pPlan->m_nGeneration == m_pLayoutGeneration->load())
+				pCommit = pPlan;
+		}
+		if (pCommit)
+		{
+			IXobj* pXobj = nullptr;
+			ObserveLayout(pCommit->m_strKey, pCommit->m_strSourceXml, pCommit, &pXobj);
+		}
+	}
+	break;
+	case 20261020:
+	{
+		// idle prewarm, let pending input and paint go first a few times
+		if (HIWORD(::GetQueueStatus(QS_INPUT | QS_PAINT)) && wParam < 8)
+			::PostMessage(m_hWnd, WM_COSMOSMSG, wParam + 1, 20261020);
+		else
+			PrewarmLayouts();
+	}
+	break;
+	case 20261021:
+	{
+		while (CLayoutPlanPtr pPrewarm = m_pPrewarmQueue->Pop())
+		{
+			if (pPrewarm->m_nGeneration == m_pPrewarmGeneration->load() && m_mapXobj.find(pPrewarm->m_strKey) == m_mapXobj.end())
+				m_LayoutPredictor.Park(pPrewarm, m_LayoutPredictor.Score(m_strCurrentKey, pPrewarm->m_strKey));
+		}
+	}
+	break;
 	case 20210411:
 	{
 		if (theApp.m_bAppStarting == false)
@@ -4334,7 +4664,7 @@ STDMETHODIMP CNucleus::GetXml(BSTR bstrRootName, BSTR* bstrRet)
 		if (str.CompareNoCase(_T("inDesigning")) == 0)
 		{
 			strName = strName.Left(nPos);
-			m_mapTemp[strName] = it.second->m_pXobjShareData->m_pWebRTParse->xml();
+			m_mapTemp[strName] = it.second->m_pXobjShareData->m_pWebRTParse->xmlCached();
 		}
 	}
 
@@ -4456,7 +4786,7 @@ STDMETHODIMP CNucleus::get_GalaxyXML(BSTR* pVal)
 		{
 			if (pWndXobj->m_pWindow)
 			{
-				if (pWndXobj->m_nActivePage > 0)
+				if (pWndXobj->m_nActivePage > 0 && pWndXobj->m_pHostParse->attrInt(_T("activepage"), 0) != pWndXobj->m_nActivePage)
 				{
 					CString strVal = _T("");
 					strVal.Format(_T("%d"), pWndXobj->m_nActivePage);
@@ -4476,10 +4806,10 @@ STDMETHODIMP CNucleus::get_GalaxyXML(BSTR* pVal)
 
 			if (pWndXobj == pWndXobj->m_pRootObj && pWndXobj->m_pXobjShareData->m_pOfficeObj)
 			{
-				g_pSpaceTelescope->UpdateOfficeObj(pWndXobj->m_pXobjShareData->m_pOfficeObj, pWndXobj->m_pXobjShareData->m_pWebRTParse->GetChild(TGM_NUCLEUS)->xml(), pWndXobj->m_pXobjShareData->m_pWebRTParse->name());
+				g_pSpaceTelescope->UpdateOfficeObj(pWndXobj->m_pXobjShareData->m_pOfficeObj, pWndXobj->m_pXobjShareData->m_pWebRTParse->GetChild(TGM_NUCLEUS)->xmlCached(), pWndXobj->m_pXobjShareData->m_pWebRTParse->name());
 			}
 		}
-		CString strXml = pWndXobj->m_pXobjShareData->m_pWebRTParse->GetChild(TGM_NUCLEUS)->xml();
+		CString strXml = pWndXobj->m_pXobjShareData->m_pWebRTParse->GetChild(TGM_NUCLEUS)->xmlCached();
 		CString s = _T("");
 		s.Format(_T("<%s>%s</%s>"), it.first, strXml, it.first);
 		CString strKey = it.second->m_strKey + _T("@") + this->m_strNucleusName + _T("@") + _T("tangramdefaultpage");
@@ -24,6 +24,8 @@
 
 #pragma once
 #include "chromium/WebPage.h"
+#include "LayoutPredictor.h"
+#include "LayoutEviction.h"
 
 using namespace Browser;
 class CBKWnd;
@@ -429,6 +431,14 @@ public:
 	map<HWND, CWPFView*>							m_mapWPFView;
 	map<HWND, CWPFView*>							m_mapVisibleWPFView;
 	map<IUniverseAppProxy*, CNucleusProxy*>			m_mapGalaxyProxy;
+	map<CString, CString>							m_mapEvictedXml;		// evicted layouts, recreated on demand
+	map<CString, bool>								m_mapPinnedLayout;
+	bool											m_bLayoutHistoryLoaded = false;
+	CLayoutPredictor								m_LayoutPredictor;
+	shared_ptr<std::atomic<long>>					m_pLayoutGeneration;	// shared with in-flight prepare tasks
+	shared_ptr<std::atomic<long>>					m_pPrewarmGeneration;
+	CLayoutPlanQueuePtr								m_pCommitQueue;			// plans from ObserveAsync, see message 20261019
+	CLayoutPlanQueuePtr								m_pPrewarmQueue;		// plans from PrewarmLayouts, see message 20261021
 	CComObject<CXobjCollection>* m_pRootNodes;
 
 	void Lock() {}
@@ -441,6 +451,19 @@ public:
 	CTangramXmlParse* UpdateXobj();
 	BOOL Create();
 	CXobj* ObserveInternal(CTangramXmlParse* pParse, CString strKey);
+	CString GetLayoutXml(CString strKey, CString strXml);
+	// normalizes strKey, starts a request and prepares the layout on the
+	// worker pool; the task yields nothing for a layout that is alive
+	task<CLayoutPlanPtr> PrepareLayout(CString& strKey, CString& strXml);
+	void ObserveAsync(CString strKey, CString strXml);
+	HRESULT ObserveLayout(CString strKey, CString strXml, CLayoutPlanPtr pPlan, IXobj** ppRetXobj);
+	void PrewarmLayouts();
+	CString GetLayoutHistoryFile();
+	void PinLayout(CString strKey, bool bPin);
+	bool IsLayoutPinned(CXobj* pRootXobj);
+	bool EvictLayout(CString strKey);
+	void TrackLayouts(CXobj* pOldXobj);
+	LayoutUsage MeasureLayout(CXobj* pRootXobj);
 
 	STDMETHOD(get_GalaxyXML)(BSTR* pVal);
 	STDMETHOD(ModifyHost)(LONGLONG hHostWnd);
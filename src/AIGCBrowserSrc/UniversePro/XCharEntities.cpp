@@ -0,0 +1,159 @@
+/********************************************************************************
+ *           Web Runtime for Application - Version 1.0.0.202203120001           *
+ ********************************************************************************
+ * Copyright (C) 2002-2021 by Tangram Team.   All Rights Reserved.
+ * There are Three Key Features of Webruntime:
+ * 1. Built-in Modern Web Browser: Independent Browser Window and Browser Window
+ *    as sub windows of other windows are supported in the application process;
+ * 2. DOM Plus: DOMPlus is a natural extension of the standard DOM system.
+ *    It allows the application system to support a kind of generalized web pages,
+ *    which are composed of standard DOM elements and binary components supported
+ *    by the application system;
+ * 3. JavaScript for Application: Similar to VBA in MS office, JavaScript will
+ *    become a built-in programmable language in the application system, so that
+ *    the application system can be expanded and developed for the Internet based
+ *    on modern javscript/Web technology.
+ * Use of this source code is governed by a BSD-style license that
+ * can be found in the LICENSE file.
+ *
+ * CONTACT INFORMATION:
+ * mailto:tangramteam@outlook.com or mailto:sunhuizlz@yeah.net
+ * https://www.webruntime.com
+ *******************************************************************************/
+
+// XCharEntities.cpp : the HTML character entities XHtmlDraw understands
+
+// NOTE ABOUT PRECOMPILED HEADERS:
+// This file does not need to be compiled with precompiled headers (.pch).
+//#include "stdafx.h"
+
+#include <windows.h>
+#include <tchar.h>
+#include <crtdbg.h>
+#include "XCharEntities.h"
+#include "XPerfectHash.h"
+
+#pragma warning(disable : 4127)	// for _ASSERTE: conditional expression is constant
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// HTML CHARACTER ENTITIES
+//
+// Some common character entities - note that these will be displayed correctly
+// ONLY if they are in the currently selected font
+//
+const CXCharEntities::CHAR_ENTITIES CXCharEntities::m_aCharEntities[] = 
+{
+	{ (_TCHAR*)_T("&amp;"),		_T('&') },		// ampersand
+	{ (_TCHAR*)_T("&bull;"),		_T('\x95') },	// bullet      NOT IN MS SANS SERIF
+	{ (_TCHAR*)_T("&cent;"),		_T('\xA2') },	// cent sign
+	{ (_TCHAR*)_T("&copy;"),		_T('\xA9') },	// copyright
+	{ (_TCHAR*)_T("&deg;"),		_T('\xB0') },	// degree sign
+	{ (_TCHAR*)_T("&euro;"),		_T('\x80') },	// euro sign
+	{ (_TCHAR*)_T("&frac12;"),	_T('\xBD') },	// fraction one half
+	{ (_TCHAR*)_T("&frac14;"),	_T('\xBC') },	// fraction one quarter
+	{ (_TCHAR*)_T("&gt;"),		_T('>') },		// greater than
+	{ (_TCHAR*)_T("&iquest;"),	_T('\xBF') },	// inverted question mark
+	{ (_TCHAR*)_T("&lt;"),		_T('<') },		// less than
+	{ (_TCHAR*)_T("&micro;"),	_T('\xB5') },	// micro sign
+	{ (_TCHAR*)_T("&middot;"),	_T('\xB7') },	// middle dot = Georgian comma
+	{ (_TCHAR*)_T("&nbsp;"),		_T(' ') },		// nonbreaking space
+	{ (_TCHAR*)_T("&para;"),		_T('\xB6') },	// pilcrow sign = paragraph sign
+	{ (_TCHAR*)_T("&plusmn;"),	_T('\xB1') },	// plus-minus sign
+	{ (_TCHAR*)_T("&pound;"),	_T('\xA3') },	// pound sign
+	{ (_TCHAR*)_T("&quot;"),		_T('"') },		// quotation mark
+	{ (_TCHAR*)_T("&reg;"),		_T('\xAE') },	// registered trademark
+	{ (_TCHAR*)_T("&sect;"),		_T('\xA7') },	// section sign
+	{ (_TCHAR*)_T("&sup1;"),		_T('\xB9') },	// superscript one
+	{ (_TCHAR*)_T("&sup2;"),		_T('\xB2') },	// superscript two
+	{ (_TCHAR*)_T("&times;"),	_T('\xD7') },	// multiplication sign
+	{ (_TCHAR*)_T("&trade;"),	_T('\x99') },	// trademark   NOT IN MS SANS SERIF
+	{ NULL,				0 }				// MUST BE LAST
+};
+
+
+///////////////////////////////////////////////////////////////////////////////
+// GetCount
+int CXCharEntities::GetCount()
+{
+	return (int) (sizeof(m_aCharEntities) / sizeof(m_aCharEntities[0])) - 1;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// GetName
+LPCTSTR CXCharEntities::GetName(int nIndex)
+{
+	return ((nIndex >= 0) && (nIndex < GetCount())) ? m_aCharEntities[nIndex].pszName : NULL;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// GetSymbol
+TCHAR CXCharEntities::GetSymbol(TCHAR cCode)
+{
+	TCHAR c = _T(' ');
+
+	int i = (int)cCode - 2;
+
+	if ((i >= 0) && (i < GetCount()))
+		c = m_aCharEntities[i].cSymbol;
+
+	return c;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// ReplaceNames
+void CXCharEntities::ReplaceNames(TCHAR * buf, BOOL bCodes)
+{
+	_ASSERTE(buf);
+
+	// built by the first caller, the others wait for it (thread-safe statics)
+	static const CXPerfectHash s_Entities = []
+	{
+		CXPerfectHash entities;
+		LPCTSTR aNames[sizeof(m_aCharEntities) / sizeof(m_aCharEntities[0])];
+		for (int i = 0; i < GetCount(); i++)
+			aNames[i] = m_aCharEntities[i].pszName;
+		entities.Build(aNames, GetCount());
+		return entities;
+	}();
+
+	if (!buf || !_tcschr(buf, _T('&')))
+		return;
+
+	TCHAR *cp1 = buf;
+	TCHAR *cp2 = buf;
+
+	while (*cp1)
+	{
+		if (*cp1 == _T('&'))
+		{
+			TCHAR *cp = cp1 + 1;
+			while (((*cp >= _T('a')) && (*cp <= _T('z'))) ||
+				   ((*cp >= _T('A')) && (*cp <= _T('Z'))) ||
+				   ((*cp >= _T('0')) && (*cp <= _T('9'))))
+				cp++;
+
+			if (*cp == _T(';'))
+			{
+				int i = s_Entities.Find(cp1, (int)(cp - cp1) + 1);
+				if (i >= 0)
+				{
+					if (bCodes)
+					{
+						*cp2++ = _T('\001');
+						*cp2++ = GetCode(i);
+					}
+					else
+					{
+						*cp2++ = m_aCharEntities[i].cSymbol;
+					}
+					cp1 = cp + 1;
+					continue;
+				}
+			}
+		}
+		*cp2++ = *cp1++;
+	}
+	*cp2 = _T('\0');
+}
@@ -0,0 +1,59 @@
+/********************************************************************************
+ *           Web Runtime for Application - Version 1.0.0.202203120001           *
+ ********************************************************************************
+ * Copyright (C) 2002-2021 by Tangram Team.   All Rights Reserved.
+ * There are Three Key Features of Webruntime:
+ * 1. Built-in Modern Web Browser: Independent Browser Window and Browser Window
+ *    as sub windows of other windows are supported in the application process;
+ * 2. DOM Plus: DOMPlus is a natural extension of the standard DOM system.
+ *    It allows the application system to support a kind of generalized web pages,
+ *    which are composed of standard DOM elements and binary components supported
+ *    by the application system;
+ * 3. JavaScript for Application: Similar to VBA in MS office, JavaScript will
+ *    become a built-in programmable language in the application system, so that
+ *    the application system can be expanded and developed for the Internet based
+ *    on modern javscript/Web technology.
+ * Use of this source code is governed by a BSD-style license that
+ * can be found in the LICENSE file.
+ *
+ * CONTACT INFORMATION:
+ * mailto:tangramteam@outlook.com or mailto:sunhuizlz@yeah.net
+ * https://www.webruntime.com
+ *******************************************************************************/
+
+// XCharEntities.h : the HTML character entities XHtmlDraw understands
+//
+// CXHtmlDraw replaced the entity names of a text by running one
+// _tcsistrrep pass per entity over it. ReplaceNames finds every "&name;"
+// in one pass instead, looking the names up in a perfect hash built once
+// over the table. The codes it writes are the index in the table + 2, so
+// GetSymbol maps one back without a search.
+
+#ifndef XCHARENTITIES_H
+#define XCHARENTITIES_H
+
+class CXCharEntities
+{
+public:
+	// replaces each "&name;" in buf, case-insensitively, with "\001" and
+	// its code (bCodes = true) or with its symbol; the result is never
+	// longer than buf
+	static void		ReplaceNames(TCHAR * buf, BOOL bCodes);
+	// the symbol of a code ReplaceNames wrote, a space for any other code
+	static TCHAR	GetSymbol(TCHAR cCode);
+
+	static int		GetCount();
+	static LPCTSTR	GetName(int nIndex);
+	static TCHAR	GetCode(int nIndex) { return (TCHAR) (nIndex + 2); }	// don't use 0 or 1
+
+private:
+	struct CHAR_ENTITIES
+	{
+		TCHAR *	pszName;		// string entered in HTML - e.g., "&nbsp;"
+		TCHAR	cSymbol;		// character symbol displayed
+	};
+
+	static const CHAR_ENTITIES m_aCharEntities[];
+};
+
+#endif //XCHARENTITIES_H
@@ -35,6 +35,7 @@
 #include "XNamedColors.h"
 #include "XString.h"
 #include "XHtmlDraw.h"
+#include "XCharEntities.h"
 
 #ifndef __noop
 #if _MSC_VER < 1300
@@ -53,50 +54,12 @@
 #pragma warning(disable : 4996)	// disable bogus deprecation warning
 
 
-///////////////////////////////////////////////////////////////////////////////
-//
-// HTML CHARACTER ENTITIES
-//
-// Some common character entities - note that these will be displayed correctly
-// ONLY if they are in the currently selected font
-//
-CXHtmlDraw::CHAR_ENTITIES CXHtmlDraw::m_aCharEntities[] = 
-{
-	{ (_TCHAR*)_T("&amp;"),		0,	_T('&') },		// ampersand
-	{ (_TCHAR*)_T("&bull;"),		0,	_T('\x95') },	// bullet      NOT IN MS SANS SERIF
-	{ (_TCHAR*)_T("&cent;"),		0,	_T('\xA2') },	// cent sign
-	{ (_TCHAR*)_T("&copy;"),		0,	_T('\xA9') },	// copyright
-	{ (_TCHAR*)_T("&deg;"),		0,	_T('\xB0') },	// degree sign
-	{ (_TCHAR*)_T("&euro;"),		0,	_T('\x80') },	// euro sign
-	{ (_TCHAR*)_T("&frac12;"),	0,	_T('\xBD') },	// fraction one half
-	{ (_TCHAR*)_T("&frac14;"),	0,	_T('\xBC') },	// fraction one quarter
-	{ (_TCHAR*)_T("&gt;"),		0,	_T('>') },		// greater than
-	{ (_TCHAR*)_T("&iquest;"),	0,	_T('\xBF') },	// inverted question mark
-	{ (_TCHAR*)_T("&lt;"),		0,	_T('<') },		// less than
-	{ (_TCHAR*)_T("&micro;"),	0,	_T('\xB5') },	// micro sign
-	{ (_TCHAR*)_T("&middot;"),	0,	_T('\xB7') },	// middle dot = Georgian comma
-	{ (_TCHAR*)_T("&nbsp;"),		0,	_T(' ') },		// nonbreaking space
-	{ (_TCHAR*)_T("&para;"),		0,	_T('\xB6') },	// pilcrow sign = paragraph sign
-	{ (_TCHAR*)_T("&plusmn;"),	0,	_T('\xB1') },	// plus-minus sign
-	{ (_TCHAR*)_T("&pound;"),	0,	_T('\xA3') },	// pound sign
-	{ (_TCHAR*)_T("&quot;"),		0,	_T('"') },		// quotation mark
-	{ (_TCHAR*)_T("&reg;"),		0,	_T('\xAE') },	// registered trademark
-	{ (_TCHAR*)_T("&sect;"),		0,	_T('\xA7') },	// section sign
-	{ (_TCHAR*)_T("&sup1;"),		0,	_T('\xB9') },	// superscript one
-	{ (_TCHAR*)_T("&sup2;"),		0,	_T('\xB2') },	// superscript two
-	{ (_TCHAR*)_T("&times;"),	0,	_T('\xD7') },	// multiplication sign
-	{ (_TCHAR*)_T("&trade;"),	0,	_T('\x99') },	// trademark   NOT IN MS SANS SERIF
-	{ NULL,				0,	0 }				// MUST BE LAST
-};
-
-
 ///////////////////////////////////////////////////////////////////////////////
 // ctor
 CXHtmlDraw::CXHtmlDraw(UINT nMaxText /*= XHTMLDRAW_MAX_TEXT*/)
   : m_nMaxText(nMaxText),
 	m_bOverAnchor(false)
 {
-	InitCharEntities();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -111,7 +74,8 @@ CXHtmlDraw::~CXHtmlDraw()
 int CXHtmlDraw::Draw(HDC hDC, 
 					 LPCTSTR lpszText, 
 					 XHTMLDRAWSTRUCT * pXHDS, 
-					 BOOL bUnderlineUrl)
+					 BOOL bUnderlineUrl,
+					 XHTMLDRAWCACHE * pCache /*= NULL*/)
 {
 	TRACE(_T("in CXHtmlDraw::Draw:  <%s>  bUnderlineUrl=%d\n"), lpszText, bUnderlineUrl);
 
@@ -214,7 +178,6 @@ int CXHtmlDraw::Draw(HDC hDC,
 	// create initial font ------------------------------------------
 
 	LOGFONT lf = { 0 };
-	LOGFONT prev_lf = { 0 };
 
 	if (pXHDS->bLogFont)
 	{
@@ -229,34 +192,19 @@ int CXHtmlDraw::Draw(HDC hDC,
 		else
 			GetObject(GetStockObject(SYSTEM_FONT), sizeof(LOGFONT), &lf);
 	}
-	memcpy(&prev_lf, &lf, sizeof(LOGFONT));
 
 	// variable initialization --------------------------------------
 
-	TCHAR *pszText = new TCHAR [m_nMaxText+1];
-	memset(pszText, 0, (m_nMaxText+1)*sizeof(TCHAR));
-	_tcsncpy(pszText, lpszText, m_nMaxText);
-	TCHAR *pTextBuffer = pszText;	// save buffer address for delete
-
-	TCHAR *pszText1 = new TCHAR [m_nMaxText+1];
-	memset(pszText1, 0, (m_nMaxText+1)*sizeof(TCHAR));
-
 	if (pXHDS->pszAnchor)
 		delete [] pXHDS->pszAnchor;
 	pXHDS->pszAnchor = NULL;
 
 	pXHDS->bHasAnchor = false;
 	pXHDS->bAnchorIsUnderlined = false;
-	BOOL bInAnchor = false;
-
-	int n = (int) _tcslen(pszText);		// n must be int
+	pXHDS->nRightX = 0;
 
-	int i = 0;
 	int nWidth = 0;
 
-	pXHDS->bHasAnchor = false;
-	pXHDS->nRightX = 0;
-	
 	COLORREF crText = pXHDS->crText;
 	if (crText == COLOR_NONE)
 		crText = GetSysColor(COLOR_WINDOWTEXT);
@@ -265,56 +213,271 @@ int CXHtmlDraw::Draw(HDC hDC,
 	if (crBackground == COLOR_NONE)
 		crBackground = GetSysColor(COLOR_WINDOW);
 
-	COLORREF crTextNew = crText;
-	COLORREF crBkgndNew = crBackground;
-
 	// if no transparency, fill entire rect with default bg color
 	if (!pXHDS->bTransparent)
 	{
-		HBRUSH hbrush = CreateSolidBrush(crBkgndNew); 
+		HBRUSH hbrush = CreateSolidBrush(crBackground); 
 		_ASSERTE(hbrush);
 		FillRect(hMemDC, &rectText, hbrush);
 		if (hbrush)
 			DeleteObject(hbrush);
 	}
 
-	BOOL bBold = pXHDS->bBold;
-	BOOL bItalic = pXHDS->bItalic;
-	BOOL bUnderline = pXHDS->bUnderline;
-	BOOL bStrikeThrough = pXHDS->bStrikeThrough;
-	BOOL bSubscript = false;
-	BOOL bSuperscript = false;
-	int nSizeChange = 0;
+	// get parsed runs ----------------------------------------------
 
-	// replace character entity names in text with codes ------------
+	// the runs depend on the text, the initial font and colors; their
+	// measured extents also depend on the resolution of the dc
+	int nDpi = GetDeviceCaps(hDC, LOGPIXELSY);
 
-	TCHAR ent[3] = { _T('\0') };
-	ent[0] = _T('\001');	// each entity name is replaced with a two-character
-							// code that begins with \001
+	std::vector<XHTMLDRAWRUN> vLocalRuns;
+	std::vector<XHTMLDRAWRUN> * pRuns = &vLocalRuns;
 
-	BOOL bCharacterEntities = false;	// assume no char entities
+	if (pCache)
+	{
+		if (pCache->bValid &&
+			(pCache->nDpi == nDpi) &&
+			(pCache->crText == crText) &&
+			(pCache->crBackground == crBackground) &&
+			(pCache->crAnchorText == pXHDS->crAnchorText) &&
+			(pCache->bIgnoreColorTag == pXHDS->bIgnoreColorTag) &&
+			(pCache->bBold == pXHDS->bBold) &&
+			(pCache->bItalic == pXHDS->bItalic) &&
+			(pCache->bUnderline == pXHDS->bUnderline) &&
+			(pCache->bStrikeThrough == pXHDS->bStrikeThrough) &&
+			(pCache->bUnderlineUrl == bUnderlineUrl) &&
+			(memcmp(&pCache->lf, &lf, sizeof(LOGFONT)) == 0) &&
+			(_tcsncmp(pCache->strText.c_str(), lpszText, m_nMaxText) == 0))
+		{
+			pCache->nHits++;
+		}
+		else
+		{
+			pCache->bValid = true;
+			pCache->nDpi = nDpi;
+			pCache->crText = crText;
+			pCache->crBackground = crBackground;
+			pCache->crAnchorText = pXHDS->crAnchorText;
+			pCache->bIgnoreColorTag = pXHDS->bIgnoreColorTag;
+			pCache->bBold = pXHDS->bBold;
+			pCache->bItalic = pXHDS->bItalic;
+			pCache->bUnderline = pXHDS->bUnderline;
+			pCache->bStrikeThrough = pXHDS->bStrikeThrough;
+			pCache->bUnderlineUrl = bUnderlineUrl;
+			memcpy(&pCache->lf, &lf, sizeof(LOGFONT));
+			size_t nText = _tcslen(lpszText);
+			pCache->strText.assign(lpszText, (nText > m_nMaxText) ? m_nMaxText : nText);
+			Parse(lpszText, lf, crText, crBackground, pXHDS, bUnderlineUrl, pCache->vRuns);
+			pCache->nParses++;
+		}
+		pRuns = &pCache->vRuns;
+	}
+	else
+	{
+		Parse(lpszText, lf, crText, crBackground, pXHDS, bUnderlineUrl, vLocalRuns);
+	}
 
-	// we are replacing character entites with a two-character sequence,
-	// so the resulting string will be shorter
-	size_t buflen = _tcslen(pszText) + 100;
-	TCHAR *buf = new TCHAR [buflen];
-	memset(buf, 0, buflen*sizeof(TCHAR));
+	// draw runs ----------------------------------------------------
 
-	for (i = 0; m_aCharEntities[i].pszName != NULL; i++)
+	for (size_t r = 0; r < pRuns->size(); r++)
 	{
-		ent[1] = m_aCharEntities[i].cCode;
-		int nRep = _tcsistrrep(pszText, m_aCharEntities[i].pszName, ent, buf);
-		if (nRep > 0)
+		XHTMLDRAWRUN& run = (*pRuns)[r];
+
+		if (run.nType == XHTMLDRAW_RUN_ANCHOR_BEGIN)
+		{
+			if (pXHDS->pszAnchor)
+				delete [] pXHDS->pszAnchor;
+			size_t len = run.strText.length();
+			pXHDS->pszAnchor = new TCHAR [len+4];
+			memset(pXHDS->pszAnchor, 0, (len+4)*sizeof(TCHAR));
+			_tcsncpy(pXHDS->pszAnchor, run.strText.c_str(), len);
+
+			// set start X of url
+			pXHDS->rectAnchor.left = rectText.left + nXOffset;
+			TRACE(_T("setting pXHDS->rectAnchor.left to %d\n"), pXHDS->rectAnchor.left);
+
+			if (bUnderlineUrl)
+				pXHDS->bAnchorIsUnderlined = true;
+			continue;
+		}
+		else if (run.nType == XHTMLDRAW_RUN_ANCHOR_END)
+		{
+			pXHDS->rectAnchor.right = rectText.left + nXOffset;
+			pXHDS->bHasAnchor = true;
+			TRACE(_T("setting pXHDS->rectAnchor.right to %d\n"), pXHDS->rectAnchor.right);
+			continue;
+		}
+
+		// create new font ------------------------------------------
+
+		HFONT hNewFont = CreateFontIndirect(&run.lf);
+		_ASSERTE(hNewFont);
+
+		HFONT hOldFont = (HFONT) SelectObject(hMemDC, hNewFont);
+
+		SetTextColor(hMemDC, run.crText);
+		if (pXHDS->crTextBackground != COLOR_NONE)
+			SetBkColor(hMemDC, pXHDS->crTextBackground);
+		else
+			SetBkMode(hMemDC, TRANSPARENT);		// need transparency for italic fonts
+
+		// measure text ---------------------------------------------
+
+		LPCTSTR buf = run.strText.c_str();
+		int len = (int)run.strText.length();
+
+		if (run.nWidth < 0)
+		{
+			SIZE size;
+			GetTextExtentPoint32(hMemDC, buf, len, &size);
+			TEXTMETRIC tm = { 0 };
+			GetTextMetrics(hMemDC, &tm);
+			run.nWidth = size.cx;
+			run.nAscent = tm.tmAscent;
+		}
+		LONG width = run.nWidth;
+
+		if ((run.crBackground != crBackground) &&
+			(pXHDS->crTextBackground == COLOR_NONE))
+		{
+			// changing backgrounds, so fill in with new color
+			HBRUSH hbrushnew = CreateSolidBrush(run.crBackground); 
+			if (hbrushnew)
+			{
+				RECT rect = rectText;
+				rect.right = rect.left + width + 1;
+				if (run.bItalic)
+				{
+					rect.right += 1;		// italic needs a little more
+					if (!IsTrueType(hMemDC))
+						rect.right += 2;	// non-TTF fonts need even more
+				}
+				if (rect.right > rectText.right)
+					rect.right = rectText.right;
+				FillRect(hMemDC, &rect, hbrushnew);
+				DeleteObject(hbrushnew);
+			}
+		}
+
+		UINT uFormat = pXHDS->uFormat;
+
+		if (pXHDS->bUseEllipsis)
+			uFormat |= DT_END_ELLIPSIS;
+
+		if (pXHDS->bHasAnchor)
+		{
+			// set rect for anchor
+			RECT rectCalc = rectText;
+			int nHeight = DrawText(hMemDC, buf, -1, &rectCalc, uFormat | DT_CALCRECT);
+			TRACE(_T("nHeight=%d -----\n"), nHeight);
+			pXHDS->rectAnchor.bottom = pXHDS->rectAnchor.top + nHeight;
+		}
+
+		RECT savedrect = rectText;
+
+		int nBaselineAdjust = run.nAscent / 2;
+
+		if (run.bSubscript)
 		{
-			bCharacterEntities = true;
-			_tcscpy(pszText, buf);
+			rectText.top += nBaselineAdjust;
+			rectText.bottom += nBaselineAdjust;
+		}
+		if (run.bSuperscript)
+		{
+			rectText.top -= nBaselineAdjust;
+			rectText.bottom -= nBaselineAdjust;
 		}
+
+		// draw text ------------------------------------------------
+
+		TRACE(_T("DrawText: <%s>\n"), buf);
+		DrawText(hMemDC, buf, -1, &rectText, uFormat);
+
+		rectText = savedrect;
+
+		if (hOldFont)
+			SelectObject(hMemDC, hOldFont);
+		if (hNewFont)
+			DeleteObject(hNewFont);
+		hNewFont = 0;
+		hOldFont = 0;
+
+		rectText.left += width;
 	}
 
-	delete [] buf;
-	buf = NULL;
+	// save the rightmost pixel position - note that rectText
+	// is remapped to 0,0 for the memory dc
+	pXHDS->nRightX = rectText.left + nXOffset;
+	TRACE(_T("nRightX = %d =====\n"), pXHDS->nRightX);
 
-	TEXTMETRIC tm = { 0 };
+	// end double buffering
+	BitBlt(hDC, rectDraw.left, rectDraw.top, nRectWidth, nRectHeight,
+		hMemDC, 0, 0, SRCCOPY);			
+	
+	// swap back the original bitmap
+	if (hOldBitmap)
+		SelectObject(hMemDC, hOldBitmap);
+	if (hBitmap)
+		DeleteObject(hBitmap);
+	hBitmap = 0;
+
+	DeleteDC(hMemDC);
+	hMemDC = 0;
+
+	bInDraw = false;
+
+	return nWidth;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Parse
+//
+// Splits the html text into runs of text with the font and colors to draw
+// them with, plus anchor begin/end markers. The runs don't depend on the dc
+// or the drawing rect, so CXHtmlDraw::Draw can keep them in a XHTMLDRAWCACHE.
+void CXHtmlDraw::Parse(LPCTSTR lpszText,
+					   const LOGFONT& lfBase,
+					   COLORREF crText,
+					   COLORREF crBackground,
+					   XHTMLDRAWSTRUCT * pXHDS,
+					   BOOL bUnderlineUrl,
+					   std::vector<XHTMLDRAWRUN>& vRuns)
+{
+	vRuns.clear();
+
+	LOGFONT lf = lfBase;
+	LOGFONT prev_lf = lfBase;
+
+	TCHAR *pszText = new TCHAR [m_nMaxText+1];
+	memset(pszText, 0, (m_nMaxText+1)*sizeof(TCHAR));
+	_tcsncpy(pszText, lpszText, m_nMaxText);
+	TCHAR *pTextBuffer = pszText;	// save buffer address for delete
+
+	TCHAR *pszText1 = new TCHAR [m_nMaxText+1];
+	memset(pszText1, 0, (m_nMaxText+1)*sizeof(TCHAR));
+
+	BOOL bInAnchor = false;
+
+	int n = (int) _tcslen(pszText);		// n must be int
+
+	COLORREF crTextNew = crText;
+	COLORREF crBkgndNew = crBackground;
+
+	BOOL bBold = pXHDS->bBold;
+	BOOL bItalic = pXHDS->bItalic;
+	BOOL bUnderline = pXHDS->bUnderline;
+	BOOL bStrikeThrough = pXHDS->bStrikeThrough;
+	BOOL bSubscript = false;
+	BOOL bSuperscript = false;
+	int nSizeChange = 0;
+
+	// replace character entity names in text with codes ------------
+
+	// each entity name is replaced with a two-character code that
+	// begins with \001, so the resulting string will be shorter
+	CXCharEntities::ReplaceNames(pszText, true);
+
+	size_t buflen = 0;
+	TCHAR *buf = NULL;
 
 	n = (int) _tcslen(pszText);	// get length again after char entity substitution
 	int textLen = n;
@@ -647,25 +810,17 @@ int CXHtmlDraw::Draw(HDC hDC,
 				if (cp2)
 				{
 					size_t len = cp2 - cp;
-					if (pXHDS->pszAnchor)
-						delete [] pXHDS->pszAnchor;
-					pXHDS->pszAnchor = new TCHAR [len+4];
-					memset(pXHDS->pszAnchor, 0, (len+4)*sizeof(TCHAR));
-					_tcsncpy(pXHDS->pszAnchor, cp, len);
-					size_t last = _tcslen(pXHDS->pszAnchor);
-					if (last > 0)
-						last--;
-					if (pXHDS->pszAnchor[last] == _T('"'))
-						pXHDS->pszAnchor[last] = _T('\0');
-					TRACE(_T("len=%d  pXHDS->szUrl=<%s>\n"), len, pXHDS->pszAnchor);
+					if ((len > 0) && (cp[len-1] == _T('"')))
+						len--;
+					XHTMLDRAWRUN run;
+					run.nType = XHTMLDRAW_RUN_ANCHOR_BEGIN;
+					run.strText.assign(cp, len);
+					vRuns.push_back(run);
+					TRACE(_T("len=%d  url=<%s>\n"), len, run.strText.c_str());
 					n -= (int) (cp2 + 1 - pszText);
 					pszText = cp2 + 1;
 					TRACE(_T("pszText=<%s>\n"), pszText);
 
-					// set start X of url
-					pXHDS->rectAnchor.left = rectText.left + nXOffset;
-					TRACE(_T("setting pXHDS->rectAnchor.left to %d\n"), pXHDS->rectAnchor.left);
-
 					crTextNew = pXHDS->crAnchorText; //RGB(0,0,255);	//pXHDS->crText;
 					crBkgndNew = crBackground;
 					memcpy(&lf, &prev_lf, sizeof(lf));
@@ -673,10 +828,13 @@ int CXHtmlDraw::Draw(HDC hDC,
 					bInAnchor = true;
 
 					if (bUnderlineUrl)
-					{
-						pXHDS->bAnchorIsUnderlined = true;
 						bUnderline++;
-					}
+				}
+				else
+				{
+					TRACE(_T("ERROR no closing >\n"));
+					pszText += 2;
+					n -= 2;
 				}
 			}
 			else
@@ -695,9 +853,9 @@ int CXHtmlDraw::Draw(HDC hDC,
 
 			if (bInAnchor)
 			{
-				pXHDS->rectAnchor.right = rectText.left + nXOffset;
-				pXHDS->bHasAnchor = true;
-				TRACE(_T("setting pXHDS->rectAnchor.right to %d\n"), pXHDS->rectAnchor.right);
+				XHTMLDRAWRUN run;
+				run.nType = XHTMLDRAW_RUN_ANCHOR_END;
+				vRuns.push_back(run);
 
 				if (bUnderlineUrl)
 					bUnderline--;
@@ -742,29 +900,26 @@ int CXHtmlDraw::Draw(HDC hDC,
 		TRACE(_T("pszText=<%s>\n"), pszText);
 		TRACE(_T("pszText1=<%s>\n"), pszText1);
 
-		// create new font ------------------------------------------
 
-		lf.lfWeight    = bBold ? FW_BOLD : FW_NORMAL;
-		lf.lfUnderline = (BYTE) bUnderline;
-		lf.lfItalic    = (BYTE) bItalic;
-		lf.lfStrikeOut = (BYTE) bStrikeThrough;
+		// save run -------------------------------------------------
 
-		HFONT hNewFont = CreateFontIndirect(&lf);
-		_ASSERTE(hNewFont);
-
-		HFONT hOldFont = (HFONT) SelectObject(hMemDC, hNewFont);
-
-		SetTextColor(hMemDC, crTextNew);
-		if (pXHDS->crTextBackground != COLOR_NONE)
-			SetBkColor(hMemDC, pXHDS->crTextBackground);
-		else
-			SetBkMode(hMemDC, TRANSPARENT);		// need transparency for italic fonts
+		XHTMLDRAWRUN run;
+		run.nType = XHTMLDRAW_RUN_TEXT;
+		run.lf = lf;
+		run.lf.lfWeight    = bBold ? FW_BOLD : FW_NORMAL;
+		run.lf.lfUnderline = (BYTE) bUnderline;
+		run.lf.lfItalic    = (BYTE) bItalic;
+		run.lf.lfStrikeOut = (BYTE) bStrikeThrough;
+		run.crText = crTextNew;
+		run.crBackground = crBkgndNew;
+		run.bItalic = bItalic;
+		run.bSubscript = bSubscript;
+		run.bSuperscript = bSuperscript;
 
 		// replace char entities ------------------------------------
 
 		size_t end = _tcslen(pszText1);
 		buflen = end + 100;
-		_ASSERTE(buf == NULL);
 		buf = new TCHAR [buflen];
 		memset(buf, 0, buflen*sizeof(TCHAR));
 
@@ -772,117 +927,24 @@ int CXHtmlDraw::Draw(HDC hDC,
 
 		ReplaceCharEntities(buf, end);
 
-		int len = (int)_tcslen(buf);
-		SIZE size;
-		GetTextExtentPoint32(hMemDC, buf, len, &size);
-		LONG width = size.cx;
-
-		if ((crBkgndNew != crBackground) &&
-			(pXHDS->crTextBackground == COLOR_NONE))
-		{
-			// changing backgrounds, so fill in with new color
-			HBRUSH hbrushnew = CreateSolidBrush(crBkgndNew); 
-			if (hbrushnew)
-			{
-				RECT rect = rectText;
-				rect.right = rect.left + width + 1;
-				if (bItalic)
-				{
-					rect.right += 1;		// italic needs a little more
-					if (!IsTrueType(hMemDC))
-						rect.right += 2;	// non-TTF fonts need even more
-				}
-				if (rect.right > rectText.right)
-					rect.right = rectText.right;
-				FillRect(hMemDC, &rect, hbrushnew);
-				DeleteObject(hbrushnew);
-			}
-		}
-
-		UINT uFormat = pXHDS->uFormat;
-
-		if (pXHDS->bUseEllipsis)
-			uFormat |= DT_END_ELLIPSIS;
-
-		if (pXHDS->bHasAnchor)
-		{
-			// set rect for anchor
-			RECT rectCalc = rectText;
-			int nHeight = DrawText(hMemDC, buf, -1, &rectCalc, uFormat | DT_CALCRECT);
-			TRACE(_T("nHeight=%d -----\n"), nHeight);
-			pXHDS->rectAnchor.bottom = pXHDS->rectAnchor.top + nHeight;
-		}
-
-		RECT savedrect = rectText;
-
-		GetTextMetrics(hMemDC, &tm);
-		int nBaselineAdjust = tm.tmAscent / 2;
-
-		if (bSubscript)
-		{
-			rectText.top += nBaselineAdjust;
-			rectText.bottom += nBaselineAdjust;
-		}
-		if (bSuperscript)
-		{
-			rectText.top -= nBaselineAdjust;
-			rectText.bottom -= nBaselineAdjust;
-		}
-
-		// draw text ------------------------------------------------
-
-		TRACE(_T("DrawText: <%s>\n"), buf);
-		DrawText(hMemDC, buf, -1, &rectText, uFormat);
-
-		rectText = savedrect;
-
-		nSizeChange = 0;
-
-		if (hOldFont)
-			SelectObject(hMemDC, hOldFont);
-		if (hNewFont)
-			DeleteObject(hNewFont);
-		hNewFont = 0;
-		hOldFont = 0;
+		run.strText = buf;
+		vRuns.push_back(run);
 
 		delete [] buf;
 		buf = NULL;
 
-		rectText.left += width;
+		nSizeChange = 0;
 
 		n -= (int)_tcslen(pszText1);
 
 	}	// while
 
-	// save the rightmost pixel position - note that rectText
-	// is remapped to 0,0 for the memory dc
-	pXHDS->nRightX = rectText.left + nXOffset;
-	TRACE(_T("nRightX = %d =====\n"), pXHDS->nRightX);
-
-	// end double buffering
-	BitBlt(hDC, rectDraw.left, rectDraw.top, nRectWidth, nRectHeight,
-		hMemDC, 0, 0, SRCCOPY);			
-	
-	// swap back the original bitmap
-	if (hOldBitmap)
-		SelectObject(hMemDC, hOldBitmap);
-	if (hBitmap)
-		DeleteObject(hBitmap);
-	hBitmap = 0;
-
-	DeleteDC(hMemDC);
-	hMemDC = 0;
-
 	if (pTextBuffer)
 		delete [] pTextBuffer;
 	pTextBuffer = 0;
 	if (pszText1)
 		delete [] pszText1;
 	pszText1 = 0;
-
-	bInDraw = false;
-
-	return nWidth;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -900,16 +962,6 @@ BOOL CXHtmlDraw::IsTrueType(HDC hDC)
 	return rc;
 }
 
-///////////////////////////////////////////////////////////////////////////////
-// InitCharEntities
-void CXHtmlDraw::InitCharEntities()
-{
-	for (int i = 0; m_aCharEntities[i].pszName != NULL; i++)
-	{
-		m_aCharEntities[i].cCode = (TCHAR) (i + 2);	// don't use 0 or 1
-	}
-}
-
 ///////////////////////////////////////////////////////////////////////////////
 // ReplaceCharEntities
 void CXHtmlDraw::ReplaceCharEntities(TCHAR * buf, size_t buflen)
@@ -938,7 +990,7 @@ void CXHtmlDraw::ReplaceCharEntities(TCHAR * buf, size_t buflen)
 					if (c == _T('\0'))
 						break;
 
-					c = GetCharEntity(c);
+					c = CXCharEntities::GetSymbol(c);
 				}
 
 				*cp2++ = c;
@@ -948,24 +1000,6 @@ void CXHtmlDraw::ReplaceCharEntities(TCHAR * buf, size_t buflen)
 	}
 }
 
-///////////////////////////////////////////////////////////////////////////////
-// GetCharEntity
-TCHAR CXHtmlDraw::GetCharEntity(TCHAR cCode)
-{
-	TCHAR c = _T(' ');
-
-	for (int i = 0; m_aCharEntities[i].pszName != NULL; i++)
-	{
-		if (cCode == m_aCharEntities[i].cCode)
-		{
-			c = m_aCharEntities[i].cSymbol;
-			break;
-		}
-	}
-
-	return c;
-}
-
 ///////////////////////////////////////////////////////////////////////////////
 // GetPlainText
 int CXHtmlDraw::GetPlainText(const TCHAR *html, 
@@ -997,16 +1031,8 @@ int CXHtmlDraw::GetPlainText(const TCHAR *html,
 
 			_tcsncpy(buf1, html, buflen-1);
 
-			TCHAR ent[2] = { _T('\0') };
-
-			// loop to remove character entities
-			for (int i = 0; m_aCharEntities[i].pszName != NULL; i++)
-			{
-				ent[0] = m_aCharEntities[i].cSymbol;
-				int nRep = _tcsistrrep(buf1, m_aCharEntities[i].pszName, ent, buf2);
-				if (nRep > 0)
-					_tcscpy(buf1, buf2);
-			}
+			// remove character entities
+			CXCharEntities::ReplaceNames(buf1, false);
 
 			TRACE(_T("after entities:  <%s>\n"), buf1);
 
@@ -27,9 +27,16 @@
 
 #pragma warning(disable : 4996)	// disable bogus deprecation warning
 
+#include <vector>
+#include <string>
+
 const int	XHTMLDRAW_MAX_TEXT = 1000;
 const DWORD	COLOR_NONE = ((DWORD)-1);
 
+const int	XHTMLDRAW_RUN_TEXT = 0;
+const int	XHTMLDRAW_RUN_ANCHOR_BEGIN = 1;
+const int	XHTMLDRAW_RUN_ANCHOR_END = 2;
+
 class CXHtmlDraw
 {
 // draw struct
@@ -195,6 +202,77 @@ public:
 										// CXHtmlDraw object
 	};
 
+	// one piece of parsed text, drawn with a single font
+	struct XHTMLDRAWRUN
+	{
+		XHTMLDRAWRUN()
+		{
+			nType        = XHTMLDRAW_RUN_TEXT;
+			crText       = COLOR_NONE;
+			crBackground = COLOR_NONE;
+			bItalic      = false;
+			bSubscript   = false;
+			bSuperscript = false;
+			nWidth       = -1;
+			nAscent      = -1;
+			memset(&lf, 0, sizeof(LOGFONT));
+		}
+
+		int		nType;					// XHTMLDRAW_RUN_TEXT or anchor begin/end
+		std::basic_string<TCHAR> strText;	// text, or url for anchor begin
+		LOGFONT	lf;						// font for the text
+		COLORREF crText;				// text color
+		COLORREF crBackground;			// background color from <font bgcolor>
+		BOOL	bItalic;				// true = text is italic
+		BOOL	bSubscript;				// true = text is subscript
+		BOOL	bSuperscript;			// true = text is superscript
+		int		nWidth;					// measured width, -1 = not measured yet
+		int		nAscent;				// measured ascent, -1 = not measured yet
+	};
+
+	// parsed runs and measured extents of one text - pass it to Draw()
+	// to skip parsing and measuring while the text, font and colors
+	// stay the same
+	struct XHTMLDRAWCACHE
+	{
+		XHTMLDRAWCACHE()
+		{
+			bValid          = false;
+			nDpi            = 0;
+			crText          = COLOR_NONE;
+			crBackground    = COLOR_NONE;
+			crAnchorText    = COLOR_NONE;
+			bIgnoreColorTag = false;
+			bBold           = false;
+			bItalic         = false;
+			bUnderline      = false;
+			bStrikeThrough  = false;
+			bUnderlineUrl   = false;
+			nParses         = 0;
+			nHits           = 0;
+			memset(&lf, 0, sizeof(LOGFONT));
+		}
+
+		void Invalidate() { bValid = false; vRuns.clear(); }
+
+		BOOL	bValid;					// true = vRuns matches the key below
+		std::basic_string<TCHAR> strText;	// text that was parsed
+		LOGFONT	lf;						// initial font
+		int		nDpi;					// LOGPIXELSY of the dc
+		COLORREF crText;
+		COLORREF crBackground;
+		COLORREF crAnchorText;
+		BOOL	bIgnoreColorTag;
+		BOOL	bBold;
+		BOOL	bItalic;
+		BOOL	bUnderline;
+		BOOL	bStrikeThrough;
+		BOOL	bUnderlineUrl;
+		std::vector<XHTMLDRAWRUN> vRuns;
+		UINT	nParses;				// number of times the text was parsed
+		UINT	nHits;					// number of draws that reused vRuns
+	};
+
 	struct XHTMLDRAW_APP_COMMAND
 	{
 		HWND	hWnd;			// HWND of window to receive message
@@ -213,7 +291,8 @@ public:
 	int Draw(HDC hdc,
 			 LPCTSTR lpszText, 
 			 XHTMLDRAWSTRUCT * pXHDS,
-			 BOOL bUnderlineUrl);
+			 BOOL bUnderlineUrl,
+			 XHTMLDRAWCACHE * pCache = NULL);
 
 	int GetPlainText(const TCHAR *html, TCHAR *plain, DWORD nPlainSize);
 	static BOOL IsOverAnchor(HWND hWnd, XHTMLDRAWSTRUCT * pXHDS);
@@ -221,20 +300,13 @@ public:
 
 // Implementation
 private:
-	struct CHAR_ENTITIES
-	{
-		TCHAR *	pszName;		// string entered in HTML - e.g., "&nbsp;"
-		TCHAR	cCode;			// code generated by XHtmlDraw
-		TCHAR	cSymbol;		// character symbol displayed
-	};
 	BOOL	m_bOverAnchor;		// true = cursor over url
 	UINT	m_nMaxText;			// max text length in TCHARs
 
-	static CHAR_ENTITIES m_aCharEntities[];
-
-	TCHAR	GetCharEntity(TCHAR cCode);
-	void	InitCharEntities();
 	BOOL	IsTrueType(HDC hDC);
+	void	Parse(LPCTSTR lpszText, const LOGFONT& lfBase, COLORREF crText,
+				  COLORREF crBackground, XHTMLDRAWSTRUCT * pXHDS,
+				  BOOL bUnderlineUrl, std::vector<XHTMLDRAWRUN>& vRuns);
 	void	ReplaceCharEntities(TCHAR * buf, size_t buflen);
 };
 
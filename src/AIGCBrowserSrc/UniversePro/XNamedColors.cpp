@@ -33,6 +33,7 @@
 #include <tchar.h>
 #include <crtdbg.h>
 #include "XNamedColors.h"
+#include "XPerfectHash.h"
 
 #pragma warning(disable : 4127)	// conditional expression is constant (_ASSERTE)
 #pragma warning(disable : 4996)	// disable bogus deprecation warning
@@ -230,6 +231,24 @@ const int CXNamedColors::m_nNamedColors =
 				sizeof(CXNamedColors::m_aColorNames) / 
 				sizeof(CXNamedColors::m_aColorNames[0]);
 
+///////////////////////////////////////////////////////////////////////////////
+// index into m_aColorNames for a case-insensitive color name, or -1
+int CXNamedColors::FindColorName(LPCTSTR lpszColorName)
+{
+	// built by the first caller, the others wait for it (thread-safe statics)
+	static const CXPerfectHash s_Names = []
+	{
+		CXPerfectHash names;
+		std::vector<LPCTSTR> vNames(m_nNamedColors);
+		for (int i = 0; i < m_nNamedColors; i++)
+			vNames[i] = m_aColorNames[i].pszName;
+		names.Build(&vNames[0], m_nNamedColors);
+		return names;
+	}();
+
+	return s_Names.Find(lpszColorName);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 CXNamedColors::CXNamedColors()
 {
@@ -414,14 +433,9 @@ void CXNamedColors::SetName(LPCTSTR lpszColorName)
 
 	COLORREF rgb = RGB(0,0,0);
 
-	for (int i = 0; i < m_nNamedColors; i++)
-	{
-		if (_tcsicmp(lpszColorName, m_aColorNames[i].pszName) == 0)
-		{
-			rgb = m_aColorNames[i].color;
-			break;
-		}
-	}
+	int i = FindColorName(lpszColorName);
+	if (i >= 0)
+		rgb = m_aColorNames[i].color;
 	m_Color = rgb;
 }
 
@@ -475,14 +489,9 @@ void CXNamedColors::SetColorFromString(LPCTSTR lpszColor)
 	else
 	{
 		// "red"
-		for (int i = 0; i < m_nNamedColors; i++)
-		{
-			if (_tcsicmp(lpszColor, m_aColorNames[i].pszName) == 0)
-			{
-				m_Color = m_aColorNames[i].color;
-				break;
-			}
-		}
+		int i = FindColorName(lpszColor);
+		if (i >= 0)
+			m_Color = m_aColorNames[i].color;
 	}
 }
 
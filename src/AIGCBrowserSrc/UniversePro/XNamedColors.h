@@ -86,6 +86,8 @@ private:
 	};
 	static const COLORNAMES m_aColorNames[];
 	static const int m_nNamedColors;
+
+	static int	FindColorName(LPCTSTR lpszColorName);
 };
 
 
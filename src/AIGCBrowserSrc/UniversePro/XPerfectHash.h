@@ -0,0 +1,242 @@
+/********************************************************************************
+ *           Web Runtime for Application - Version 1.0.1.202108220001
+ ********************************************************************************
+ * Copyright (C) 2002-2021 by Tangram Team.   All Rights Reserved.
+ * There are Three Key Features of Webruntime:
+ * 1. Built-in Modern Web Browser;
+ * 2. DOM Plus: DOMPlus is a natural extension of the standard DOM system.
+ *    It allows the application system to support a kind of generalized web pages,
+ *    which are composed of standard DOM elements and binary components supported
+ *    by the application system;
+ * 3. JavaScript for Application: Similar to VBA in MS office, JavaScript will
+ *    become a built-in programmable language in the application system, so that
+ *    the application system can be expanded and developed for the Internet based
+ *    on modern javscript/Web technology.
+// Use of this source code is governed by a BSD-style license that
+// can be found in the LICENSE file.
+ *
+ * CONTACT INFORMATION:
+ * mailto:tangramteam@outlook.com or mailto:sunhuizlz@yeah.net
+ * https://www.webruntime.com
+ *
+ *******************************************************************************/
+
+// XPerfectHash.h : minimal-probe perfect hash over a fixed set of names
+//
+// The name tables of XNamedColors, XHtmlDraw and PPHtmlDrawer are scanned
+// linearly with string compares. CXPerfectHash indexes such a table once
+// (hash and displace: every bucket gets its own seed so that no two names
+// share a slot), after which a lookup is two hashes and one compare.
+// The names are not copied - they must outlive the index.
+
+#ifndef XPERFECTHASH_H
+#define XPERFECTHASH_H
+
+#include <vector>
+#include <algorithm>
+
+class CXPerfectHash
+{
+public:
+	CXPerfectHash() : m_bIgnoreCase(TRUE), m_nMask(0) {}
+
+	// builds the index over nCount names; for duplicate names the first
+	// one wins, same as a linear scan
+	BOOL Build(LPCTSTR const * ppszNames, int nCount, BOOL bIgnoreCase = TRUE)
+	{
+		m_bIgnoreCase = bIgnoreCase;
+		m_vNames.assign(ppszNames, ppszNames + nCount);
+		m_vLengths.resize(nCount);
+		m_vSlots.clear();
+		m_vSeeds.clear();
+		m_nMask = 0;
+
+		int i;
+		for (i = 0; i < nCount; i++)
+			m_vLengths[i] = m_vNames[i] ? (int)_tcslen(m_vNames[i]) : 0;
+
+		// table size is a power of two with load <= 0.5
+		unsigned int nSlots = 2;
+		while (nSlots < (unsigned int)nCount * 2)
+			nSlots <<= 1;
+		m_nMask = nSlots - 1;
+		m_vSlots.assign(nSlots, -1);
+
+		int nBuckets = (nCount / 2) + 1;
+		m_vSeeds.assign(nBuckets, 0);
+
+		std::vector< std::vector<int> > vBuckets(nBuckets);
+		for (i = 0; i < nCount; i++)
+		{
+			if (!m_vNames[i])
+				continue;
+			// drop duplicates so every bucket can be placed
+			int nDup = Find(m_vNames[i], m_vLengths[i], vBuckets);
+			if (nDup >= 0)
+				continue;
+			vBuckets[Hash(m_vNames[i], m_vLengths[i], 0) % nBuckets].push_back(i);
+		}
+
+		// place the largest buckets first
+		std::vector<int> vOrder(nBuckets);
+		for (i = 0; i < nBuckets; i++)
+			vOrder[i] = i;
+		std::stable_sort(vOrder.begin(), vOrder.end(), CBySize(vBuckets));
+
+		std::vector<unsigned int> vTaken;
+		for (i = 0; i < nBuckets; i++)
+		{
+			const std::vector<int>& bucket = vBuckets[vOrder[i]];
+			if (bucket.empty())
+				break;
+
+			unsigned int nSeed = 1;
+			for (; nSeed < 0x100000; nSeed++)
+			{
+				vTaken.clear();
+				size_t k = 0;
+				for (; k < bucket.size(); k++)
+				{
+					unsigned int nSlot = Hash(m_vNames[bucket[k]], m_vLengths[bucket[k]], nSeed) & m_nMask;
+					if ((m_vSlots[nSlot] != -1) ||
+						(std::find(vTaken.begin(), vTaken.end(), nSlot) != vTaken.end()))
+						break;
+					vTaken.push_back(nSlot);
+				}
+				if (k == bucket.size())
+					break;
+			}
+			if (nSeed >= 0x100000)
+			{
+				m_vSlots.clear();
+				return FALSE;
+			}
+
+			m_vSeeds[vOrder[i]] = nSeed;
+			for (size_t k = 0; k < bucket.size(); k++)
+				m_vSlots[vTaken[k]] = bucket[k];
+		}
+
+		return TRUE;
+	}
+
+	// returns the index of the name passed to Build(), or -1
+	int Find(LPCTSTR lpszName) const
+	{
+		return lpszName ? Find(lpszName, (int)_tcslen(lpszName)) : -1;
+	}
+
+	// lpszName need not be terminated
+	int Find(LPCTSTR lpszName, int nLen) const
+	{
+		if (m_vSlots.empty() || !lpszName)
+			return -1;
+
+		unsigned int nBucket = Hash(lpszName, nLen, 0) % (unsigned int)m_vSeeds.size();
+		int nIndex = m_vSlots[Hash(lpszName, nLen, m_vSeeds[nBucket]) & m_nMask];
+		if ((nIndex < 0) || (m_vLengths[nIndex] != nLen) || !IsEqual(m_vNames[nIndex], lpszName, nLen))
+			return -1;
+
+		return nIndex;
+	}
+
+	BOOL IsEmpty() const { return m_vSlots.empty(); }
+
+private:
+	struct CBySize
+	{
+		CBySize(const std::vector< std::vector<int> >& vBuckets) : m_vBuckets(vBuckets) {}
+		bool operator()(int a, int b) const { return m_vBuckets[a].size() > m_vBuckets[b].size(); }
+		const std::vector< std::vector<int> >& m_vBuckets;
+	};
+
+	static TCHAR Fold(TCHAR c)
+	{
+		return ((c >= _T('A')) && (c <= _T('Z'))) ? (TCHAR)(c - _T('A') + _T('a')) : c;
+	}
+
+	unsigned int Hash(LPCTSTR p, int nLen, unsigned int nSeed) const
+	{
+		// FNV-1a over the (folded) chars, seeded per bucket
+		unsigned int h = 2166136261U ^ (nSeed * 0x9E3779B9U);
+		for (int i = 0; i < nLen; i++)
+		{
+			h ^= (unsigned int)(m_bIgnoreCase ? Fold(p[i]) : p[i]);
+			h *= 16777619U;
+		}
+		h ^= h >> 16;
+		h *= 0x85EBCA6BU;
+		h ^= h >> 13;
+		return h;
+	}
+
+	BOOL IsEqual(LPCTSTR a, LPCTSTR b, int nLen) const
+	{
+		for (int i = 0; i < nLen; i++)
+		{
+			if (m_bIgnoreCase ? (Fold(a[i]) != Fold(b[i])) : (a[i] != b[i]))
+				return FALSE;
+		}
+		return TRUE;
+	}
+
+	int Find(LPCTSTR lpszName, int nLen, const std::vector< std::vector<int> >& vBuckets) const
+	{
+		const std::vector<int>& bucket = vBuckets[Hash(lpszName, nLen, 0) % vBuckets.size()];
+		for (size_t k = 0; k < bucket.size(); k++)
+		{
+			if ((m_vLengths[bucket[k]] == nLen) && IsEqual(m_vNames[bucket[k]], lpszName, nLen))
+				return bucket[k];
+		}
+		return -1;
+	}
+
+	BOOL m_bIgnoreCase;
+	unsigned int m_nMask;
+	std::vector<LPCTSTR> m_vNames;
+	std::vector<int> m_vLengths;
+	std::vector<int> m_vSlots;				// slot -> index of the name, -1 = empty
+	std::vector<unsigned int> m_vSeeds;		// bucket -> seed of the slot hash
+};
+
+// CXPerfectHashMap - a case-sensitive CXPerfectHash over the keys of a
+// std::map, so a lookup finds what map::find would.  Invalidate() after the
+// map changes; the next Find() indexes it again.
+template <class MAP>
+class CXPerfectHashMap
+{
+public:
+	CXPerfectHashMap() : m_bIndexed(FALSE) {}
+
+	void Invalidate() { m_bIndexed = FALSE; }
+
+	// lpszName need not be terminated; returns map.end() if not found
+	typename MAP::iterator Find(MAP& map, LPCTSTR lpszName, int nLen)
+	{
+		if (!m_bIndexed)
+		{
+			std::vector<LPCTSTR> vNames;
+			m_vIndex.clear();
+			for (typename MAP::iterator iter = map.begin(); iter != map.end(); ++iter)
+			{
+				vNames.push_back((LPCTSTR)iter->first);
+				m_vIndex.push_back(iter);
+			}
+			if (!vNames.empty())
+				m_Hash.Build(&vNames[0], (int)vNames.size(), FALSE);
+			else
+				m_Hash = CXPerfectHash();
+			m_bIndexed = TRUE;
+		}
+
+		int nIndex = m_Hash.Find(lpszName, nLen);
+		return (nIndex >= 0) ? m_vIndex[nIndex] : map.end();
+	}
+
+private:
+	BOOL m_bIndexed;
+	CXPerfectHash m_Hash;
+	std::vector<typename MAP::iterator> m_vIndex;	// index of the name -> its entry
+};
+
+#endif //XPERFECTHASH_H
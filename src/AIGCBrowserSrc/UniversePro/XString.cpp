@@ -33,6 +33,7 @@
 #include <tchar.h>
 #include <crtdbg.h>
 #include "XString.h"
+#include "XStringAlgo.h"
 //#include "XTrace.h"
 
 #if 0  // -----------------------------------------------------------
@@ -188,16 +189,7 @@ TCHAR * _tcscrem(TCHAR * str, TCHAR ch)
 	if (!str)
 		return str;
 
-	TCHAR *cp1 = str;
-	TCHAR *cp2 = str;
-
-	while (*cp2)
-	{
-		if (*cp2 != ch)
-			*cp1++ = *cp2;
-		cp2++;
-	}
-	*cp1 = _T('\0');
+	str[XStrRemove(str, _tcslen(str), ch)] = _T('\0');
 
 	return str;
 }
@@ -224,14 +216,8 @@ TCHAR * _tcsistrrem(TCHAR * str, const TCHAR *substr)
 	if (!substr)
 		return str;
 
-	TCHAR *target = NULL;
-	size_t nSubstrLen = _tcslen(substr);
-	TCHAR *cp = str;
-	while ((target = _tcsistr(cp, substr)) != NULL)
-	{
-		_tcscpy(target, target + nSubstrLen);
-		cp = target;
-	}
+	// one pass, the kept text moves down once
+	str[XStrIRemove(str, _tcslen(str), substr, _tcslen(substr))] = _T('\0');
 
 	return str;
 }
@@ -290,18 +276,7 @@ TCHAR * _tcsistr(const TCHAR * str, const TCHAR * substr)
 	if (!str || !substr || (substr[0] == _T('\0')))
 		return (TCHAR *) str;
 
-	size_t nLen = _tcslen(substr);
-	while (*str)
-	{
-		if (_tcsnicmp(str, substr, nLen) == 0)
-			break;
-		str++;
-	}
-
-	if (*str == _T('\0'))
-		str = NULL;
-
-	return (TCHAR *) str;
+	return (TCHAR *) XStrIFind(str, _tcslen(str), substr, _tcslen(substr));
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -345,73 +320,35 @@ int _tcsistrrep(const TCHAR * lpszStr,
 
 	size_t nNewLen = _tcslen(lpszNew);
 
-	// loop once to figure out the size of the result string
-	int nCount = 0;
-	TCHAR *pszStart = (TCHAR *) lpszStr;
-	TCHAR *pszEnd = (TCHAR *) lpszStr + nStrLen;
-	TCHAR *pszTarget = NULL;
-	TCHAR * pszResultStr = NULL;
-
-	while (pszStart < pszEnd)
-	{
-		while ((pszTarget = _tcsistr(pszStart, lpszOld)) != NULL)
-		{
-			nCount++;
-			pszStart = pszTarget + nOldLen;
-		}
-		pszStart += _tcslen(pszStart);
-	}
+	// nothing is written to lpszResult when there is nothing to replace
+	const TCHAR *pszFirst = XStrIFind(lpszStr, nStrLen, lpszOld, nOldLen);
+	if (pszFirst == NULL)
+		return 0;
 
-	// if any changes, make them now
-	if (nCount > 0)
+	// the text before the first match needs no second look
+	size_t nSkip = (size_t)(pszFirst - lpszStr);
+	size_t nSize = nSkip + XStrIReplace(pszFirst, nStrLen - nSkip, lpszOld, nOldLen, lpszNew, nNewLen, 
+										NULL, NULL);
+	if (lpszResult)
 	{
-		// allocate buffer for result string
-		size_t nResultStrSize = nStrLen + (nNewLen - nOldLen) * nCount + 2;
-		pszResultStr = new TCHAR [nResultStrSize];
-		ZeroMemory(pszResultStr, nResultStrSize*sizeof(TCHAR));
-
-		pszStart = (TCHAR *) lpszStr;
-		pszEnd = (TCHAR *) lpszStr + nStrLen;
-		TCHAR *cp = pszResultStr;
-
-		// loop again to actually do the work
-		while (pszStart < pszEnd)
+		// a result buffer over the source string gets the text by way of a copy
+		TCHAR *pszResultStr = lpszResult;
+		if (lpszResult < lpszStr + nStrLen + 1 && lpszStr < lpszResult + nSize + 1)
+			pszResultStr = new TCHAR [nSize + 1];
+		memcpy(pszResultStr, lpszStr, nSkip*sizeof(TCHAR));
+		XStrIReplace(pszFirst, nStrLen - nSkip, lpszOld, nOldLen, lpszNew, nNewLen, 
+					 pszResultStr + nSkip, NULL);
+		pszResultStr[nSize] = _T('\0');
+		if (pszResultStr != lpszResult)
 		{
-			while ((pszTarget = _tcsistr(pszStart, lpszOld)) != NULL)
-			{
-				int nCopyLen = (int)(pszTarget - pszStart);
-				_tcsncpy(cp, &lpszStr[pszStart-lpszStr], nCopyLen);
-
-				cp += nCopyLen;
-
-				pszStart = pszTarget + nOldLen;
-
-				_tcscpy(cp, lpszNew);
-
-				cp += nNewLen;
-			}
-			_tcscpy(cp, pszStart);
-			pszStart += _tcslen(pszStart);
+			memcpy(lpszResult, pszResultStr, (nSize + 1)*sizeof(TCHAR));
+			delete [] pszResultStr;
 		}
-
-		//TRACE("pszResultStr=<%s>\n", pszResultStr);
-
-		_ASSERTE(pszResultStr[nResultStrSize-2] == _T('\0'));
-
-		if (lpszResult && pszResultStr)
-			_tcscpy(lpszResult, pszResultStr);
-	}
-
-	int nSize = 0;
-	if (pszResultStr)
-	{
-		nSize = (int)_tcslen(pszResultStr);
-		delete [] pszResultStr;
 	}
 
 	//TRACE("_tcsistrrep returning %d\n", nSize);
 
-	return nSize;
+	return (int)nSize;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -564,13 +501,5 @@ int _tcsccnt(const TCHAR *str, TCHAR ch)
 	if (!str)
 		return 0;
 
-	int count = 0;
-
-	while (*str)
-	{
-		if (*str++ == ch)
-			count++;
-	}
-
-	return count;
+	return (int) XStrCount(str, _tcslen(str), ch);
 }
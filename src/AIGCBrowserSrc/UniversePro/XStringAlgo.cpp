@@ -0,0 +1,385 @@
+/********************************************************************************
+ *           Web Runtime for Application - Version 1.0.0.202203120001           *
+ ********************************************************************************
+ * Copyright (C) 2002-2021 by Tangram Team.   All Rights Reserved.
+ * There are Three Key Features of Webruntime:
+ * 1. Built-in Modern Web Browser: Independent Browser Window and Browser Window
+ *    as sub windows of other windows are supported in the application process;
+ * 2. DOM Plus: DOMPlus is a natural extension of the standard DOM system.
+ *    It allows the application system to support a kind of generalized web pages,
+ *    which are composed of standard DOM elements and binary components supported
+ *    by the application system;
+ * 3. JavaScript for Application: Similar to VBA in MS office, JavaScript will
+ *    become a built-in programmable language in the application system, so that
+ *    the application system can be expanded and developed for the Internet based
+ *    on modern javscript/Web technology.
+ * Use of this source code is governed by a BSD-style license that
+ * can be found in the LICENSE file.
+ *
+ * CONTACT INFORMATION:
+ * mailto:tangramteam@outlook.com or mailto:sunhuizlz@yeah.net
+ * https://www.webruntime.com
+ *******************************************************************************/
+
+// XStringAlgo.cpp : substring search, replace and remove for XString.cpp
+//
+// Like XString.cpp, this file does not use the precompiled header.
+
+#include "XStringAlgo.h"
+
+#pragma warning(push, 3)
+#include <stdint.h>
+#include <string.h>
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#include <emmintrin.h>
+#define XSTR_SSE2
+#endif
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#pragma warning(pop)
+
+template <class T>
+static inline T XStrFold(T c)
+{
+	return (c >= 'A' && c <= 'Z') ? (T)(c + ('a' - 'A')) : c;
+}
+
+template <class T>
+static inline T XStrUnfold(T c)
+{
+	return (c >= 'a' && c <= 'z') ? (T)(c - ('a' - 'A')) : c;
+}
+
+template <class T>
+static inline bool XStrIEqual(const T* p1, const T* p2, size_t nLen)
+{
+	for (size_t i = 0; i < nLen; i++)
+	{
+		if (p1[i] != p2[i] && XStrFold(p1[i]) != XStrFold(p2[i]))
+			return false;
+	}
+	return true;
+}
+
+#ifdef XSTR_SSE2
+static inline int XStrLowBit(uint32_t nMask)
+{
+#ifdef _MSC_VER
+	unsigned long nBit;
+	_BitScanForward(&nBit, nMask);
+	return (int)nBit;
+#else
+	return __builtin_ctz(nMask);
+#endif
+}
+
+static inline int XStrBitCount(uint32_t n)
+{
+	n = n - ((n >> 1) & 0x55555555);
+	n = (n & 0x33333333) + ((n >> 2) & 0x33333333);
+	return (int)((((n + (n >> 4)) & 0x0F0F0F0F) * 0x01010101) >> 24);
+}
+
+// compares 16 bytes as lanes of one character each; movemask gives one bit
+// per byte, so only the lowest bit of every lane is kept
+template <size_t N> struct XStrLanes;
+
+template <> struct XStrLanes<1>
+{
+	enum { COUNT = 16 };
+	static const uint32_t MASK = 0xFFFF;
+	static __m128i Set(uint32_t c) {return _mm_set1_epi8((char)c);}
+	static __m128i Equal(__m128i a, __m128i b) {return _mm_cmpeq_epi8(a, b);}
+};
+
+template <> struct XStrLanes<2>
+{
+	enum { COUNT = 8 };
+	static const uint32_t MASK = 0x5555;
+	static __m128i Set(uint32_t c) {return _mm_set1_epi16((short)c);}
+	static __m128i Equal(__m128i a, __m128i b) {return _mm_cmpeq_epi16(a, b);}
+};
+
+template <> struct XStrLanes<4>
+{
+	enum { COUNT = 4 };
+	static const uint32_t MASK = 0x1111;
+	static __m128i Set(uint32_t c) {return _mm_set1_epi32((int)c);}
+	static __m128i Equal(__m128i a, __m128i b) {return _mm_cmpeq_epi32(a, b);}
+};
+#endif
+
+template <class T>
+static const T* XStrIFindT(const T* pStr, size_t nStrLen, const T* pSub, size_t nSubLen)
+{
+	if (nSubLen == 0)
+		return pStr;
+	if (pStr == NULL || nSubLen > nStrLen)
+		return NULL;
+
+	const T chFirst = XStrFold(pSub[0]);
+	const T chLast = XStrFold(pSub[nSubLen - 1]);
+	const size_t nLast = nStrLen - nSubLen;	// last position a match can start at
+	size_t i = 0;
+
+#ifdef XSTR_SSE2
+	typedef XStrLanes<sizeof(T)> Lanes;
+	const __m128i vFirst1 = Lanes::Set((uint32_t)chFirst);
+	const __m128i vFirst2 = Lanes::Set((uint32_t)XStrUnfold(chFirst));
+	const __m128i vLast1 = Lanes::Set((uint32_t)chLast);
+	const __m128i vLast2 = Lanes::Set((uint32_t)XStrUnfold(chLast));
+	for (; i + Lanes::COUNT <= nLast + 1; i += Lanes::COUNT)
+	{
+		__m128i vHead = _mm_loadu_si128((const __m128i*)(pStr + i));
+		__m128i vTail = _mm_loadu_si128((const __m128i*)(pStr + i + nSubLen - 1));
+		__m128i vHit = _mm_and_si128(
+			_mm_or_si128(Lanes::Equal(vHead, vFirst1), Lanes::Equal(vHead, vFirst2)),
+			_mm_or_si128(Lanes::Equal(vTail, vLast1), Lanes::Equal(vTail, vLast2)));
+		uint32_t nMask = (uint32_t)_mm_movemask_epi8(vHit) & Lanes::MASK;
+		while (nMask)
+		{
+			int nBit = XStrLowBit(nMask);
+			const T* pCandidate = pStr + i + nBit / sizeof(T);
+			if (nSubLen <= 2 || XStrIEqual(pCandidate + 1, pSub + 1, nSubLen - 2))
+				return pCandidate;
+			nMask &= nMask - 1;
+		}
+	}
+#endif
+
+	for (; i <= nLast; i++)
+	{
+		if (XStrFold(pStr[i]) == chFirst && XStrFold(pStr[i + nSubLen - 1]) == chLast &&
+			XStrIEqual(pStr + i + 1, pSub + 1, nSubLen > 2 ? nSubLen - 2 : 0))
+			return pStr + i;
+	}
+	return NULL;
+}
+
+template <class T>
+static const T* XStrFindCharT(const T* pStr, size_t nStrLen, T ch)
+{
+	size_t i = 0;
+#ifdef XSTR_SSE2
+	typedef XStrLanes<sizeof(T)> Lanes;
+	const __m128i vChar = Lanes::Set((uint32_t)ch);
+	for (; i + Lanes::COUNT <= nStrLen; i += Lanes::COUNT)
+	{
+		__m128i v = _mm_loadu_si128((const __m128i*)(pStr + i));
+		uint32_t nMask = (uint32_t)_mm_movemask_epi8(Lanes::Equal(v, vChar)) & Lanes::MASK;
+		if (nMask)
+			return pStr + i + XStrLowBit(nMask) / sizeof(T);
+	}
+#endif
+	for (; i < nStrLen; i++)
+	{
+		if (pStr[i] == ch)
+			return pStr + i;
+	}
+	return NULL;
+}
+
+template <class T>
+static size_t XStrICountT(const T* pStr, size_t nStrLen, const T* pSub, size_t nSubLen)
+{
+	if (pStr == NULL || nSubLen == 0)
+		return 0;
+	size_t nCount = 0;
+	const T* pEnd = pStr + nStrLen;
+	const T* p = pStr;
+	while ((p = XStrIFindT(p, (size_t)(pEnd - p), pSub, nSubLen)) != NULL)
+	{
+		nCount++;
+		p += nSubLen;
+	}
+	return nCount;
+}
+
+template <class T>
+static size_t XStrIReplaceT(const T* pStr, size_t nStrLen, const T* pOld, size_t nOldLen,
+						   const T* pNew, size_t nNewLen, T* pResult, size_t* pnCount)
+{
+	if (pnCount)
+		*pnCount = 0;
+	if (pStr == NULL)
+		return 0;
+	if (nOldLen == 0)
+	{
+		if (pResult)
+			memcpy(pResult, pStr, nStrLen * sizeof(T));
+		return nStrLen;
+	}
+
+	size_t nCount = 0;
+	size_t nResultLen = 0;
+	const T* pEnd = pStr + nStrLen;
+	const T* p = pStr;
+	for (;;)
+	{
+		const T* pMatch = XStrIFindT(p, (size_t)(pEnd - p), pOld, nOldLen);
+		size_t nKeep = (size_t)((pMatch ? pMatch : pEnd) - p);
+		if (pResult)
+			memcpy(pResult + nResultLen, p, nKeep * sizeof(T));
+		nResultLen += nKeep;
+		if (pMatch == NULL)
+			break;
+		if (pResult)
+			memcpy(pResult + nResultLen, pNew, nNewLen * sizeof(T));
+		nResultLen += nNewLen;
+		nCount++;
+		p = pMatch + nOldLen;
+	}
+	if (pnCount)
+		*pnCount = nCount;
+	return nResultLen;
+}
+
+template <class T>
+static size_t XStrIRemoveT(T* pStr, size_t nStrLen, const T* pSub, size_t nSubLen)
+{
+	if (pStr == NULL || nSubLen == 0)
+		return nStrLen;
+
+	// the kept runs move down once each
+	T* pEnd = pStr + nStrLen;
+	T* pWrite = pStr;
+	T* p = pStr;
+	for (;;)
+	{
+		T* pMatch = (T*)XStrIFindT((const T*)p, (size_t)(pEnd - p), pSub, nSubLen);
+		size_t nKeep = (size_t)((pMatch ? pMatch : pEnd) - p);
+		if (pWrite != p)
+			memmove(pWrite, p, nKeep * sizeof(T));
+		pWrite += nKeep;
+		if (pMatch == NULL)
+			break;
+		p = pMatch + nSubLen;
+	}
+	return (size_t)(pWrite - pStr);
+}
+
+template <class T>
+static size_t XStrCountT(const T* pStr, size_t nStrLen, T ch)
+{
+	if (pStr == NULL)
+		return 0;
+	size_t nCount = 0;
+	size_t i = 0;
+#ifdef XSTR_SSE2
+	typedef XStrLanes<sizeof(T)> Lanes;
+	const __m128i vChar = Lanes::Set((uint32_t)ch);
+	for (; i + Lanes::COUNT <= nStrLen; i += Lanes::COUNT)
+	{
+		__m128i v = _mm_loadu_si128((const __m128i*)(pStr + i));
+		nCount += XStrBitCount((uint32_t)_mm_movemask_epi8(Lanes::Equal(v, vChar)) & Lanes::MASK);
+	}
+#endif
+	for (; i < nStrLen; i++)
+	{
+		if (pStr[i] == ch)
+			nCount++;
+	}
+	return nCount;
+}
+
+template <class T>
+static size_t XStrRemoveT(T* pStr, size_t nStrLen, T ch)
+{
+	if (pStr == NULL)
+		return 0;
+	T* pWrite = pStr;
+	size_t i = 0;
+#ifdef XSTR_SSE2
+	typedef XStrLanes<sizeof(T)> Lanes;
+	const __m128i vChar = Lanes::Set((uint32_t)ch);
+	for (; i + Lanes::COUNT <= nStrLen; i += Lanes::COUNT)
+	{
+		__m128i v = _mm_loadu_si128((const __m128i*)(pStr + i));
+		uint32_t nMask = (uint32_t)_mm_movemask_epi8(Lanes::Equal(v, vChar)) & Lanes::MASK;
+		// a block without the character is kept as a whole, the others are
+		// stored character by character with the cursor passing the kept ones
+		if (nMask == 0)
+		{
+			_mm_storeu_si128((__m128i*)pWrite, v);
+			pWrite += Lanes::COUNT;
+			continue;
+		}
+		for (size_t k = 0; k < Lanes::COUNT; k++)
+		{
+			T c = pStr[i + k];
+			*pWrite = c;
+			pWrite += (c != ch);
+		}
+	}
+#endif
+	for (; i < nStrLen; i++)
+	{
+		T c = pStr[i];
+		*pWrite = c;
+		pWrite += (c != ch);
+	}
+	return (size_t)(pWrite - pStr);
+}
+
+const char* XStrIFind(const char* pStr, size_t nStrLen, const char* pSub, size_t nSubLen)
+{
+	return XStrIFindT(pStr, nStrLen, pSub, nSubLen);
+}
+
+const wchar_t* XStrIFind(const wchar_t* pStr, size_t nStrLen, const wchar_t* pSub, size_t nSubLen)
+{
+	return XStrIFindT(pStr, nStrLen, pSub, nSubLen);
+}
+
+size_t XStrICount(const char* pStr, size_t nStrLen, const char* pSub, size_t nSubLen)
+{
+	return XStrICountT(pStr, nStrLen, pSub, nSubLen);
+}
+
+size_t XStrICount(const wchar_t* pStr, size_t nStrLen, const wchar_t* pSub, size_t nSubLen)
+{
+	return XStrICountT(pStr, nStrLen, pSub, nSubLen);
+}
+
+size_t XStrIReplace(const char* pStr, size_t nStrLen, const char* pOld, size_t nOldLen,
+					const char* pNew, size_t nNewLen, char* pResult, size_t* pnCount)
+{
+	return XStrIReplaceT(pStr, nStrLen, pOld, nOldLen, pNew, nNewLen, pResult, pnCount);
+}
+
+size_t XStrIReplace(const wchar_t* pStr, size_t nStrLen, const wchar_t* pOld, size_t nOldLen,
+					const wchar_t* pNew, size_t nNewLen, wchar_t* pResult, size_t* pnCount)
+{
+	return XStrIReplaceT(pStr, nStrLen, pOld, nOldLen, pNew, nNewLen, pResult, pnCount);
+}
+
+size_t XStrIRemove(char* pStr, size_t nStrLen, const char* pSub, size_t nSubLen)
+{
+	return XStrIRemoveT(pStr, nStrLen, pSub, nSubLen);
+}
+
+size_t XStrIRemove(wchar_t* pStr, size_t nStrLen, const wchar_t* pSub, size_t nSubLen)
+{
+	return XStrIRemoveT(pStr, nStrLen, pSub, nSubLen);
+}
+
+size_t XStrCount(const char* pStr, size_t nStrLen, char ch)
+{
+	return XStrCountT(pStr, nStrLen, ch);
+}
+
+size_t XStrCount(const wchar_t* pStr, size_t nStrLen, wchar_t ch)
+{
+	return XStrCountT(pStr, nStrLen, ch);
+}
+
+size_t XStrRemove(char* pStr, size_t nStrLen, char ch)
+{
+	return XStrRemoveT(pStr, nStrLen, ch);
+}
+
+size_t XStrRemove(wchar_t* pStr, size_t nStrLen, wchar_t ch)
+{
+	return XStrRemoveT(pStr, nStrLen, ch);
+}
@@ -0,0 +1,69 @@
+/********************************************************************************
+ *           Web Runtime for Application - Version 1.0.0.202203120001           *
+ ********************************************************************************
+ * Copyright (C) 2002-2021 by Tangram Team.   All Rights Reserved.
+ * There are Three Key Features of Webruntime:
+ * 1. Built-in Modern Web Browser: Independent Browser Window and Browser Window
+ *    as sub windows of other windows are supported in the application process;
+ * 2. DOM Plus: DOMPlus is a natural extension of the standard DOM system.
+ *    It allows the application system to support a kind of generalized web pages,
+ *    which are composed of standard DOM elements and binary components supported
+ *    by the application system;
+ * 3. JavaScript for Application: Similar to VBA in MS office, JavaScript will
+ *    become a built-in programmable language in the application system, so that
+ *    the application system can be expanded and developed for the Internet based
+ *    on modern javscript/Web technology.
+ * Use of this source code is governed by a BSD-style license that
+ * can be found in the LICENSE file.
+ *
+ * CONTACT INFORMATION:
+ * mailto:tangramteam@outlook.com or mailto:sunhuizlz@yeah.net
+ * https://www.webruntime.com
+ *******************************************************************************/
+
+// XStringAlgo.h : substring search, replace and remove for XString.cpp
+//
+// The XString helpers looked for a substring by calling _tcsnicmp at every
+// position, counted replacements in one pass and built the result in a
+// second one, and removed each match by copying the rest of the string down
+// over it. These functions do the same work on char and wchar_t buffers of
+// known length: the search tests a block of positions at once with SSE2 for
+// the first and last character of the substring and compares the rest only
+// where both match, and replace and remove copy the text once instead of
+// once per match.
+//
+// Case folding is that of the "C" locale, A-Z only, which is what _tcsnicmp
+// did in this process.
+
+#pragma once
+
+#pragma warning(push, 3)
+#include <stddef.h>
+#include <wchar.h>
+#pragma warning(pop)
+
+// first occurrence of pSub in pStr ignoring case, pStr if nSubLen is 0
+const char* XStrIFind(const char* pStr, size_t nStrLen, const char* pSub, size_t nSubLen);
+const wchar_t* XStrIFind(const wchar_t* pStr, size_t nStrLen, const wchar_t* pSub, size_t nSubLen);
+
+// non overlapping occurrences, left to right
+size_t XStrICount(const char* pStr, size_t nStrLen, const char* pSub, size_t nSubLen);
+size_t XStrICount(const wchar_t* pStr, size_t nStrLen, const wchar_t* pSub, size_t nSubLen);
+
+// writes pStr with every occurrence of pOld replaced by pNew to pResult,
+// which may be NULL to get the length only; returns the length of the result
+// (no terminating nul is written) and the number of replacements in pnCount
+size_t XStrIReplace(const char* pStr, size_t nStrLen, const char* pOld, size_t nOldLen,
+					const char* pNew, size_t nNewLen, char* pResult, size_t* pnCount);
+size_t XStrIReplace(const wchar_t* pStr, size_t nStrLen, const wchar_t* pOld, size_t nOldLen,
+					const wchar_t* pNew, size_t nNewLen, wchar_t* pResult, size_t* pnCount);
+
+// removes every occurrence in place, returns the new length
+size_t XStrIRemove(char* pStr, size_t nStrLen, const char* pSub, size_t nSubLen);
+size_t XStrIRemove(wchar_t* pStr, size_t nStrLen, const wchar_t* pSub, size_t nSubLen);
+
+// single characters, case sensitive
+size_t XStrCount(const char* pStr, size_t nStrLen, char ch);
+size_t XStrCount(const wchar_t* pStr, size_t nStrLen, wchar_t ch);
+size_t XStrRemove(char* pStr, size_t nStrLen, char ch);
+size_t XStrRemove(wchar_t* pStr, size_t nStrLen, wchar_t ch);
@@ -17,7 +17,9 @@
 //     http://www.codeproject.com/useritems/location_trace.asp
 //
 // XTrace.h is a drop-in replacement for MFC's TRACE facility.  It has no
-// dependency on MFC.  It is thread-safe and uses no globals or statics.
+// dependency on MFC.  It is thread-safe; lines are formatted at any length,
+// and with XTRACE_FILE they are handed to the buffered CXTraceSink, which
+// writes _trace.log from a thread of its own.
 //
 // It optionally adds source module/line number and thread id to each line 
 // of TRACE output.  To control these features, use the following defines:
@@ -37,15 +39,13 @@
 #include <stdio.h>
 #include <windows.h>
 #include <tchar.h>
+#include <string>
+#include "XTraceSink.h"
 
 #pragma warning(push)
 #pragma warning(disable : 4127)		// conditional expression is constant
 #pragma warning(disable : 4996)		// disable bogus deprecation warning
 
-#ifndef INVALID_SET_FILE_POINTER
-#define INVALID_SET_FILE_POINTER ((DWORD)-1)
-#endif
-
 #define XTRACE_SHOW_FULLPATH	FALSE	// FALSE = only show base name of file
 #define XTRACE_SHOW_THREAD_ID	TRUE	// TRUE = include thread id in output
 #define XTRACE_FILE				FALSE	// TRUE = output to file
@@ -64,81 +64,54 @@ public:
 		va_list va;
 		va_start(va, lpszFormat);
 
-		TCHAR buf1[BUFFER_SIZE];
-		TCHAR buf2[BUFFER_SIZE];
+		std::basic_string<TCHAR> strMessage;
+		CXTraceSink::FormatV(strMessage, lpszFormat, va);
+
+		va_end(va);
+
+		Output(m_file, m_line, strMessage);
+	}
+
+	// with XTRACE_FILE the line goes to the buffered sink, which adds the
+	// fields and writes the file from its own thread
+	static void Output(LPCTSTR lpszFile, int nLine, const std::basic_string<TCHAR>& strMessage)
+	{
+		if (XTRACE_FILE)
+		{
+			CXTraceSink::Instance().Write(lpszFile, nLine,
+				(XTRACE_SHOW_FULLPATH ? XTRACE_FULLPATH : 0) | (XTRACE_SHOW_THREAD_ID ? XTRACE_THREADID : 0),
+				strMessage.c_str(), strMessage.size());
+			return;
+		}
 
 		// add the __FILE__ and __LINE__ to the front
-		TCHAR *cp = (LPTSTR) m_file;
-		
+		LPCTSTR cp = lpszFile;
+
 		if (!XTRACE_SHOW_FULLPATH)
 		{
-			cp = (TCHAR *)_tcsrchr(m_file, _T('\\'));
+			cp = _tcsrchr(lpszFile, _T('\\'));
 			if (cp)
 				cp++;
+			else
+				cp = lpszFile;
 		}
 
+		TCHAR buf1[MAX_PATH + 64];
 		if (XTRACE_SHOW_THREAD_ID)
-		{
-			if (_sntprintf(buf1, BUFFER_SIZE-1, _T("%s(%d) : [%X] %s"), 
-						cp, m_line, GetCurrentThreadId(), lpszFormat) < 0)
-				buf1[BUFFER_SIZE-1] = _T('\0');
-		}
+			_sntprintf(buf1, sizeof(buf1)/sizeof(TCHAR)-1, _T("%s(%d) : [%X] "), cp, nLine, GetCurrentThreadId());
 		else
-		{
-			if (_sntprintf(buf1, BUFFER_SIZE-1, _T("%s(%d) : %s"), 
-						cp, m_line, lpszFormat) < 0)
-				buf1[BUFFER_SIZE-1] = _T('\0');
-		}
-
-		// format the message as requested
-		if (_vsntprintf(buf2, BUFFER_SIZE-1, buf1, va) < 0)
-			buf2[BUFFER_SIZE-1] = _T('\0');
+			_sntprintf(buf1, sizeof(buf1)/sizeof(TCHAR)-1, _T("%s(%d) : "), cp, nLine);
+		buf1[sizeof(buf1)/sizeof(TCHAR)-1] = _T('\0');
 
-		va_end(va);
-
-		if (XTRACE_FILE)
-		{
-			TCHAR szPathName[MAX_PATH*2] = { 0 };
-
-			::GetModuleFileName(NULL, szPathName, sizeof(szPathName)/sizeof(TCHAR)-2);
-
-			TCHAR *cp = _tcsrchr(szPathName, _T('\\'));
-			if (cp != NULL)
-				*(cp+1) = _T('\0');
-			_tcscat(szPathName, _T("\\_trace.log"));
-			HANDLE hFile = ::CreateFile(szPathName, GENERIC_WRITE, FILE_SHARE_WRITE,
-								NULL, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
-			if (hFile != INVALID_HANDLE_VALUE)
-			{
-				DWORD dwRC = ::SetFilePointer(hFile,		// handle to file
-											  0,			// bytes to move pointer
-											  NULL,			// bytes to move pointer
-											  FILE_END);	// starting point
-
-				if (dwRC != INVALID_SET_FILE_POINTER)
-				{
-					DWORD dwWritten = 0;
-					::WriteFile(hFile,							// handle to file
-								buf2,							// data buffer
-								(DWORD)_tcslen(buf2)*sizeof(TCHAR),	// number of bytes to write
-								&dwWritten,						// number of bytes written
-								NULL);							// overlapped buffer
-				}
-
-				::CloseHandle(hFile);
-			}
-		}
-		else
-		{
-			// write it out
-			OutputDebugString(buf2);
-		}
+		// write it out
+		std::basic_string<TCHAR> strLine(buf1);
+		strLine += strMessage;
+		OutputDebugString(strLine.c_str());
 	}
 
 private:
 	LPCTSTR m_file;
 	int     m_line;
-	enum    { BUFFER_SIZE = 4096 };
 };
 
 class xtracing_entry_output_debug_string
@@ -152,9 +125,7 @@ public:
 
 	~xtracing_entry_output_debug_string()
 	{
-		TCHAR buf3[BUFFER_SIZE*3];
-		_stprintf(buf3, _T("======  exiting scope:  %s"), buf2);
-		OutputDebugString(buf3);
+		xtracing_output_debug_string::Output(m_file, m_line, _T("======  exiting scope:  ") + m_message);
 	}
 
 	void operator() (LPCTSTR lpszFormat, ...)
@@ -162,81 +133,18 @@ public:
 		va_list va;
 		va_start(va, lpszFormat);
 
-		TCHAR buf1[BUFFER_SIZE];
-
-		// add the __FILE__ and __LINE__ to the front
-		TCHAR *cp = (LPTSTR) m_file;
-		
-		if (!XTRACE_SHOW_FULLPATH)
-		{
-			cp = (TCHAR *)_tcsrchr(m_file, _T('\\'));
-			if (cp)
-				cp++;
-		}
-
-		if (XTRACE_SHOW_THREAD_ID)
-		{
-			if (_sntprintf(buf1, BUFFER_SIZE-1, _T("%s(%d) : [%X] ======  %s"), 
-						cp, m_line, GetCurrentThreadId(), lpszFormat) < 0)
-				buf1[BUFFER_SIZE-1] = _T('\0');
-		}
-		else
-		{
-			if (_sntprintf(buf1, BUFFER_SIZE-1, _T("%s(%d) : ======  %s"), 
-						cp, m_line, lpszFormat) < 0)
-				buf1[BUFFER_SIZE-1] = _T('\0');
-		}
-
-		// format the message as requested
-		if (_vsntprintf(buf2, BUFFER_SIZE-1, buf1, va) < 0)
-			buf2[BUFFER_SIZE-1] = _T('\0');
+		m_message.clear();
+		CXTraceSink::FormatV(m_message, lpszFormat, va);
 
 		va_end(va);
 
-		if (XTRACE_FILE)
-		{
-			TCHAR szPathName[MAX_PATH*2] = { 0 };
-
-			::GetModuleFileName(NULL, szPathName, sizeof(szPathName)/sizeof(TCHAR)-2);
-
-			TCHAR *cp = _tcsrchr(szPathName, _T('\\'));
-			if (cp != NULL)
-				*(cp+1) = _T('\0');
-			_tcscat(szPathName, _T("\\_trace.log"));
-			HANDLE hFile = ::CreateFile(szPathName, GENERIC_WRITE, FILE_SHARE_WRITE,
-								NULL, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
-			if (hFile != INVALID_HANDLE_VALUE)
-			{
-				DWORD dwRC = ::SetFilePointer(hFile,		// handle to file
-											  0,			// bytes to move pointer
-											  NULL,			// bytes to move pointer
-											  FILE_END);	// starting point
-
-				if (dwRC != INVALID_SET_FILE_POINTER)
-				{
-					DWORD dwWritten = 0;
-					::WriteFile(hFile,							// handle to file
-								buf2,							// data buffer
-								(DWORD)_tcslen(buf2)*sizeof(TCHAR),	// number of bytes to write
-								&dwWritten,						// number of bytes written
-								NULL);							// overlapped buffer
-				}
-
-				::CloseHandle(hFile);
-			}
-		}
-		else
-		{
-			// write it out
-			OutputDebugString(buf2);
-		}
+		xtracing_output_debug_string::Output(m_file, m_line, _T("======  ") + m_message);
 	}
 
 private:
 	LPCTSTR m_file;
 	int     m_line;
-	enum    { BUFFER_SIZE = 4096 };
-	TCHAR buf2[BUFFER_SIZE*2];
+	std::basic_string<TCHAR> m_message;
 };
 
 #undef TRACE
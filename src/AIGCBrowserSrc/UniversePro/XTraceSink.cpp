@@ -0,0 +1,657 @@
+/********************************************************************************
+ *           Web Runtime for Application - Version 1.0.0.202203120001           *
+ ********************************************************************************
+ * Copyright (C) 2002-2021 by Tangram Team.   All Rights Reserved.
+ * There are Three Key Features of Webruntime:
+ * 1. Built-in Modern Web Browser: Independent Browser Window and Browser Window
+ *    as sub windows of other windows are supported in the application process;
+ * 2. DOM Plus: DOMPlus is a natural extension of the standard DOM system.
+ *    It allows the application system to support a kind of generalized web pages,
+ *    which are composed of standard DOM elements and binary components supported
+ *    by the application system;
+ * 3. JavaScript for Application: Similar to VBA in MS office, JavaScript will
+ *    become a built-in programmable language in the application system, so that
+ *    the application system can be expanded and developed for the Internet based
+ *    on modern javscript/Web technology.
+ * Use of this source code is governed by a BSD-style license that
+ * can be found in the LICENSE file.
+ *
+ * CONTACT INFORMATION:
+ * mailto:tangramteam@outlook.com or mailto:sunhuizlz@yeah.net
+ * https://www.webruntime.com
+ *******************************************************************************/
+
+// XTraceSink.cpp : buffered file backend of the XTRACE macros
+
+#include "stdafx.h"
+#include "XTraceSink.h"
+
+#pragma warning(push, 3)
+#include <string.h>
+#include <wchar.h>
+#include <algorithm>
+#ifndef _WIN32
+#include <unistd.h>
+#include <sys/syscall.h>
+#endif
+#pragma warning(pop)
+
+#pragma warning(disable : 4996)		// _wfopen, snprintf
+
+static inline size_t XTraceAlign(size_t n)
+{
+	return (n + 7) & ~(size_t)7;
+} //End XTraceAlign
+
+static inline uint32_t XTraceThreadID()
+{
+#ifdef _WIN32
+	return (uint32_t)::GetCurrentThreadId();
+#else
+	return (uint32_t)::syscall(SYS_gettid);
+#endif
+} //End XTraceThreadID
+
+/////////////////////////////////////////////////////////////////////////////
+// CXTraceRing: the records of one thread, written by that thread only and
+// read by whoever holds the drain lock of the sink
+
+class CXTraceRing
+{
+public:
+	CXTraceRing(uint32_t nSize)
+	{
+		m_nSize = 4096;
+		while (m_nSize < nSize)
+			m_nSize <<= 1;
+		m_pBuffer = new char[m_nSize];
+		m_nHead.store(0, std::memory_order_relaxed);
+		m_nTail.store(0, std::memory_order_relaxed);
+		m_bOrphaned.store(false, std::memory_order_relaxed);
+		m_bPending = false;
+	};
+	~CXTraceRing() {delete[] m_pBuffer;};
+
+	//ENG: Largest message part one record carries
+	size_t GetMaxPart() const {return m_nSize / 4 - sizeof(XTRACERECORD);};
+	size_t GetFree() const
+	{
+		return m_nSize - (size_t)(m_nHead.load(std::memory_order_relaxed) - m_nTail.load(std::memory_order_acquire));
+	};
+	size_t GetSize() const {return m_nSize;};
+	size_t GetUsed() const
+	{
+		return (size_t)(m_nHead.load(std::memory_order_acquire) - m_nTail.load(std::memory_order_relaxed));
+	};
+
+	//ENG: Producer side, the caller made sure the record fits
+	void Put(const XTRACERECORD& rec, const void* pMessage)
+	{
+		uint64_t nHead = m_nHead.load(std::memory_order_relaxed);
+		CopyIn(nHead, &rec, sizeof(rec));
+		CopyIn(nHead + sizeof(rec), pMessage, rec.m_nLength);
+		m_nHead.store(nHead + XTraceAlign(sizeof(rec) + rec.m_nLength), std::memory_order_release);
+	};
+
+	//ENG: Consumer side, appends the message bytes to strMessage
+	bool Get(XTRACERECORD& rec, std::string& strMessage)
+	{
+		uint64_t nTail = m_nTail.load(std::memory_order_relaxed);
+		if (nTail == m_nHead.load(std::memory_order_acquire))
+			return false;
+		CopyOut(nTail, &rec, sizeof(rec));
+		size_t nOld = strMessage.size();
+		strMessage.resize(nOld + rec.m_nLength);
+		if (rec.m_nLength)
+			CopyOut(nTail + sizeof(rec), &strMessage[nOld], rec.m_nLength);
+		m_nTail.store(nTail + XTraceAlign(sizeof(rec) + rec.m_nLength), std::memory_order_release);
+		return true;
+	};
+
+	std::atomic<bool> m_bOrphaned;		// the thread has ended
+
+	// a message split over several records, consumer side only
+	bool m_bPending;
+	XTRACERECORD m_PendingRecord;
+	std::string m_strPending;
+
+private:
+	void CopyIn(uint64_t nPos, const void* pData, size_t nBytes)
+	{
+		size_t nOffset = (size_t)(nPos & (m_nSize - 1));
+		size_t nFirst = (std::min)(nBytes, m_nSize - nOffset);
+		memcpy(m_pBuffer + nOffset, pData, nFirst);
+		memcpy(m_pBuffer, (const char*)pData + nFirst, nBytes - nFirst);
+	};
+	void CopyOut(uint64_t nPos, void* pData, size_t nBytes)
+	{
+		size_t nOffset = (size_t)(nPos & (m_nSize - 1));
+		size_t nFirst = (std::min)(nBytes, m_nSize - nOffset);
+		memcpy(pData, m_pBuffer + nOffset, nFirst);
+		memcpy((char*)pData + nFirst, m_pBuffer, nBytes - nFirst);
+	};
+
+	char* m_pBuffer;
+	size_t m_nSize;
+	std::atomic<uint64_t> m_nHead;
+	std::atomic<uint64_t> m_nTail;
+};
+
+// hands the ring of an ending thread over to the flusher
+struct XTRACETHREADRING
+{
+	CXTraceRing* m_pRing;
+	XTRACETHREADRING() {m_pRing = NULL;};
+	~XTRACETHREADRING()
+	{
+		if (m_pRing)
+			m_pRing->m_bOrphaned.store(true, std::memory_order_release);
+	};
+};
+
+static thread_local XTRACETHREADRING g_XTraceThreadRing;
+
+/////////////////////////////////////////////////////////////////////////////
+// XTRACECONFIG
+
+XTRACECONFIG::XTRACECONFIG()
+{
+	m_nMaxFileSize = 16 * 1024 * 1024;
+	m_nMaxFileAge = 24 * 60 * 60;
+	m_nMaxFiles = 5;
+	m_nRingSize = 256 * 1024;
+	m_nFlushInterval = 100;
+} //End XTRACECONFIG::XTRACECONFIG
+
+/////////////////////////////////////////////////////////////////////////////
+// CXTraceSink
+
+CXTraceSink::CXTraceSink()
+{
+	m_tStart = std::chrono::steady_clock::now();
+	m_nSeq.store(0);
+	m_nWaits.store(0);
+	m_bWake.store(false);
+	m_bRunning.store(false);
+	m_bStop = false;
+	m_bStarted = false;
+	m_nNextSeq = 0;
+	m_nWritten = 0;
+	m_pFile = NULL;
+#ifdef XTRACE_TESTHOOKS
+	m_pfnClaimed = NULL;
+#endif
+	m_nFileSize = 0;
+} //End CXTraceSink::CXTraceSink
+
+CXTraceSink::~CXTraceSink()
+{
+} //End CXTraceSink::~CXTraceSink
+
+CXTraceSink& CXTraceSink::Instance()
+{
+	// never destroyed: threads may still trace while statics go away, and a
+	// module being unloaded must not wait for the flusher, call Shutdown()
+	static CXTraceSink* pSink = new CXTraceSink;
+	return *pSink;
+} //End CXTraceSink::Instance
+
+void CXTraceSink::Configure(const XTRACECONFIG& config)
+{
+	std::lock_guard<std::mutex> lockDrain(m_csDrain);
+	std::lock_guard<std::mutex> lockRings(m_csRings);
+	std::lock_guard<std::mutex> lockWake(m_csWake);
+	m_Config = config;
+	CloseFile();
+} //End CXTraceSink::Configure
+
+void CXTraceSink::Write(const char* lpszFile, int nLine, uint32_t nFlags, const char* lpszMessage, size_t nLength)
+{
+	Append(lpszFile, nLine, nFlags & ~XTRACE_WIDE, lpszMessage, nLength);
+} //End CXTraceSink::Write
+
+void CXTraceSink::Write(const wchar_t* lpszFile, int nLine, uint32_t nFlags, const wchar_t* lpszMessage, size_t nLength)
+{
+	Append(lpszFile, nLine, nFlags | XTRACE_WIDE, lpszMessage, nLength * sizeof(wchar_t));
+} //End CXTraceSink::Write
+
+void CXTraceSink::WriteV(const char* lpszFile, int nLine, uint32_t nFlags, const char* lpszFormat, va_list va)
+{
+	static thread_local std::string strMessage;
+	strMessage.clear();
+	FormatV(strMessage, lpszFormat, va);
+	Write(lpszFile, nLine, nFlags, strMessage.c_str(), strMessage.size());
+} //End CXTraceSink::WriteV
+
+void CXTraceSink::WriteV(const wchar_t* lpszFile, int nLine, uint32_t nFlags, const wchar_t* lpszFormat, va_list va)
+{
+	static thread_local std::wstring strMessage;
+	strMessage.clear();
+	FormatV(strMessage, lpszFormat, va);
+	Write(lpszFile, nLine, nFlags, strMessage.c_str(), strMessage.size());
+} //End CXTraceSink::WriteV
+
+void CXTraceSink::FormatV(std::string& str, const char* lpszFormat, va_list va)
+{
+	va_list vaCount;
+	va_copy(vaCount, va);
+	int nLength = vsnprintf(NULL, 0, lpszFormat, vaCount);
+	va_end(vaCount);
+	if (nLength <= 0)
+		return;
+	size_t nOld = str.size();
+	str.resize(nOld + nLength + 1);
+	vsnprintf(&str[nOld], nLength + 1, lpszFormat, va);
+	str.resize(nOld + nLength);
+} //End CXTraceSink::FormatV
+
+void CXTraceSink::FormatV(std::wstring& str, const wchar_t* lpszFormat, va_list va)
+{
+	size_t nOld = str.size();
+#ifdef _WIN32
+	va_list vaCount;
+	va_copy(vaCount, va);
+	int nLength = _vscwprintf(lpszFormat, vaCount);
+	va_end(vaCount);
+	if (nLength <= 0)
+		return;
+	str.resize(nOld + nLength + 1);
+	_vsnwprintf(&str[nOld], nLength + 1, lpszFormat, va);
+	str.resize(nOld + nLength);
+#else
+	// vswprintf does not tell the length it needs, grow until it fits
+	for (size_t nSize = 256; nSize <= 64 * 1024 * 1024; nSize *= 2)
+	{
+		str.resize(nOld + nSize);
+		va_list vaTry;
+		va_copy(vaTry, va);
+		int nLength = vswprintf(&str[nOld], nSize, lpszFormat, vaTry);
+		va_end(vaTry);
+		if (nLength >= 0 && (size_t)nLength < nSize)
+		{
+			str.resize(nOld + nLength);
+			return;
+		}
+	}
+	str.resize(nOld);
+#endif
+} //End CXTraceSink::FormatV
+
+CXTraceRing* CXTraceSink::GetThreadRing()
+{
+	CXTraceRing* pRing = g_XTraceThreadRing.m_pRing;
+	if (pRing)
+		return pRing;
+
+	std::lock_guard<std::mutex> lock(m_csRings);
+	pRing = new CXTraceRing(m_Config.m_nRingSize);
+	m_vRings.push_back(pRing);
+	g_XTraceThreadRing.m_pRing = pRing;
+
+	if (!m_bStarted)
+	{
+		m_bStarted = true;
+		m_bRunning.store(true);
+		m_Thread = std::thread(&CXTraceSink::Run, this);
+	}
+	return pRing;
+} //End CXTraceSink::GetThreadRing
+
+void CXTraceSink::Append(const void* pFile, int nLine, uint32_t nFlags, const void* pMessage, size_t nBytes)
+{
+	CXTraceRing* pRing = GetThreadRing();
+
+	XTRACERECORD rec;
+	rec.m_nSeq = m_nSeq.fetch_add(1, std::memory_order_relaxed);
+	rec.m_nTime = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now() - m_tStart).count();
+	rec.m_pFile = pFile;
+	rec.m_nLine = nLine;
+	rec.m_nThreadID = XTraceThreadID();
+#ifdef XTRACE_TESTHOOKS
+	if (m_pfnClaimed)
+		m_pfnClaimed(rec.m_nSeq);
+#endif
+
+	// a long message goes in parts, whole characters each
+	size_t nUnit = (nFlags & XTRACE_WIDE) ? sizeof(wchar_t) : 1;
+	size_t nMaxPart = pRing->GetMaxPart() / nUnit * nUnit;
+	const char* pData = (const char*)pMessage;
+	do
+	{
+		size_t nPart = (std::min)(nBytes, nMaxPart);
+		rec.m_nFlags = nFlags | (nPart < nBytes ? XTRACE_MORE : 0);
+		rec.m_nLength = (uint32_t)nPart;
+
+		size_t nNeed = XTraceAlign(sizeof(rec) + nPart);
+		for (int nSpin = 0; pRing->GetFree() < nNeed; nSpin++)
+		{
+			if (nSpin == 0)
+				m_nWaits.fetch_add(1, std::memory_order_relaxed);
+			if (!m_bRunning.load(std::memory_order_acquire))
+				Drain(true);
+			else
+				Wake();
+			if (nSpin < 16)
+				std::this_thread::yield();
+			else
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		pRing->Put(rec, pData);
+
+		pData += nPart;
+		nBytes -= nPart;
+	} while (nBytes);
+
+	if (!m_bRunning.load(std::memory_order_acquire))
+		Drain(true);
+	else if (pRing->GetUsed() * 2 >= pRing->GetSize())
+		Wake();
+} //End CXTraceSink::Append
+
+void CXTraceSink::Wake()
+{
+	if (!m_bWake.exchange(true))
+		m_cvWake.notify_one();
+} //End CXTraceSink::Wake
+
+void CXTraceSink::Run()
+{
+	for (;;)
+	{
+		{
+			std::unique_lock<std::mutex> lock(m_csWake);
+			m_cvWake.wait_for(lock, std::chrono::milliseconds(m_Config.m_nFlushInterval),
+				[this] {return m_bStop || m_bWake.load();});
+			m_bWake.store(false);
+			// Shutdown writes what is left
+			if (m_bStop)
+				return;
+		}
+		Drain();
+	}
+} //End CXTraceSink::Run
+
+void CXTraceSink::Flush()
+{
+	if (!m_bRunning.load(std::memory_order_acquire))
+	{
+		Drain(true);
+		return;
+	}
+	// every number taken so far, the lines of this thread among them; the
+	// ones still on their way to a ring are put soon after, so the wait ends
+	uint64_t nSeq = m_nSeq.load();
+	std::unique_lock<std::mutex> lock(m_csWake);
+	m_bWake.store(true);
+	m_cvWake.notify_one();
+	m_cvPass.wait(lock, [&] {return m_nWritten >= nSeq || !m_bRunning.load();});
+} //End CXTraceSink::Flush
+
+void CXTraceSink::Shutdown()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_csWake);
+		if (!m_bRunning.load())
+			return;
+		m_bStop = true;
+		m_bRunning.store(false, std::memory_order_release);
+	}
+	m_cvWake.notify_one();
+	m_cvPass.notify_all();
+	// joining would wait for the thread to end, which under the loader lock
+	// it cannot; it leaves Run at its next wake-up
+	if (m_Thread.joinable())
+		m_Thread.detach();
+	Drain(true);
+} //End CXTraceSink::Shutdown
+
+void CXTraceSink::Drain(bool bAll)
+{
+	std::unique_lock<std::mutex> lockDrain(m_csDrain, std::defer_lock);
+	if (bAll)
+	{
+		// a pass of the flusher ends well within this, a lock that is still
+		// held belongs to a thread that will not come back
+		for (int nWait = 0; !lockDrain.try_lock(); nWait++)
+		{
+			if (nWait == 2000)
+				return;
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+	}
+	else
+		lockDrain.lock();
+
+	std::vector<CXTraceRing*> vRings;
+	{
+		std::lock_guard<std::mutex> lock(m_csRings);
+		vRings = m_vRings;
+	}
+
+	// whole messages of every ring and the ones held back before, written in
+	// the order of the calls
+	std::vector<XTRACEENTRY> vEntries;
+	vEntries.swap(m_vHeld);
+	std::vector<CXTraceRing*> vEnded;
+	for (CXTraceRing* pRing : vRings)
+	{
+		bool bOrphaned = pRing->m_bOrphaned.load(std::memory_order_acquire);
+		XTRACERECORD rec;
+		for (;;)
+		{
+			if (!pRing->m_bPending)
+				pRing->m_strPending.clear();
+			if (!pRing->Get(rec, pRing->m_strPending))
+				break;
+			if (!pRing->m_bPending)
+				pRing->m_PendingRecord = rec;
+			pRing->m_bPending = (rec.m_nFlags & XTRACE_MORE) != 0;
+			if (pRing->m_bPending)
+				continue;
+			XTRACEENTRY entry;
+			entry.m_Record = pRing->m_PendingRecord;
+			entry.m_Record.m_nFlags &= ~XTRACE_MORE;
+			entry.m_strMessage.swap(pRing->m_strPending);
+			vEntries.push_back(std::move(entry));
+		}
+		if (bOrphaned && !pRing->m_bPending)
+			vEnded.push_back(pRing);
+	}
+	std::sort(vEntries.begin(), vEntries.end(),
+		[](const XTRACEENTRY& a, const XTRACEENTRY& b) {return a.m_Record.m_nSeq < b.m_Record.m_nSeq;});
+
+	// up to the first number not seen yet; one below m_nNextSeq arrived after
+	// a drain that wrote past its gap and goes out at once
+	size_t nWrite = 0;
+	for (; nWrite < vEntries.size(); nWrite++)
+	{
+		uint64_t nSeq = vEntries[nWrite].m_Record.m_nSeq;
+		if (!bAll && nSeq > m_nNextSeq)
+			break;
+		m_nNextSeq = (std::max)(m_nNextSeq, nSeq + 1);
+	}
+	if (nWrite && (m_pFile || OpenFile()))
+	{
+		std::string strLine;
+		for (size_t i = 0; i < nWrite; i++)
+			WriteRecord(vEntries[i].m_Record, vEntries[i].m_strMessage, strLine);
+		fflush(m_pFile);
+	}
+	m_vHeld.assign(std::make_move_iterator(vEntries.begin() + nWrite), std::make_move_iterator(vEntries.end()));
+
+	if (vEnded.size())
+	{
+		std::lock_guard<std::mutex> lock(m_csRings);
+		for (CXTraceRing* pRing : vEnded)
+		{
+			m_vRings.erase(std::find(m_vRings.begin(), m_vRings.end(), pRing));
+			delete pRing;
+		}
+	}
+
+	std::lock_guard<std::mutex> lock(m_csWake);
+	m_nWritten = m_nNextSeq;
+	m_cvPass.notify_all();
+} //End CXTraceSink::Drain
+
+static void XTraceAppendUtf8(std::string& str, const wchar_t* p, size_t nLength)
+{
+	for (size_t i = 0; i < nLength; i++)
+	{
+		uint32_t c = (uint32_t)p[i];
+		if (sizeof(wchar_t) == 2 && c >= 0xD800 && c < 0xDC00 && i + 1 < nLength &&
+			(uint32_t)p[i + 1] >= 0xDC00 && (uint32_t)p[i + 1] < 0xE000)
+		{
+			c = 0x10000 + ((c - 0xD800) << 10) + ((uint32_t)p[i + 1] - 0xDC00);
+			i++;
+		}
+		if (c < 0x80)
+			str += (char)c;
+		else if (c < 0x800)
+		{
+			str += (char)(0xC0 | (c >> 6));
+			str += (char)(0x80 | (c & 0x3F));
+		}
+		else if (c < 0x10000)
+		{
+			str += (char)(0xE0 | (c >> 12));
+			str += (char)(0x80 | ((c >> 6) & 0x3F));
+			str += (char)(0x80 | (c & 0x3F));
+		}
+		else
+		{
+			str += (char)(0xF0 | (c >> 18));
+			str += (char)(0x80 | ((c >> 12) & 0x3F));
+			str += (char)(0x80 | ((c >> 6) & 0x3F));
+			str += (char)(0x80 | (c & 0x3F));
+		}
+	}
+} //End XTraceAppendUtf8
+
+void CXTraceSink::WriteRecord(const XTRACERECORD& rec, const std::string& strMessage, std::string& strLine)
+{
+	// <seconds> #<seq> file(line) : [thread] message, UTF-8, one per line
+	char szField[64];
+	snprintf(szField, sizeof(szField), "%12.6f #%llu ",
+		rec.m_nTime / 1e9, (unsigned long long)rec.m_nSeq);
+	strLine = szField;
+
+	bool bWide = (rec.m_nFlags & XTRACE_WIDE) != 0;
+	if (rec.m_pFile)
+	{
+		if (bWide)
+		{
+			const wchar_t* lpszFile = (const wchar_t*)rec.m_pFile;
+			if (!(rec.m_nFlags & XTRACE_FULLPATH))
+			{
+				for (const wchar_t* p = lpszFile; *p; p++)
+					if (*p == L'\\' || *p == L'/')
+						lpszFile = p + 1;
+			}
+			XTraceAppendUtf8(strLine, lpszFile, wcslen(lpszFile));
+		}
+		else
+		{
+			const char* lpszFile = (const char*)rec.m_pFile;
+			if (!(rec.m_nFlags & XTRACE_FULLPATH))
+			{
+				for (const char* p = lpszFile; *p; p++)
+					if (*p == '\\' || *p == '/')
+						lpszFile = p + 1;
+			}
+			strLine += lpszFile;
+		}
+	}
+	snprintf(szField, sizeof(szField), "(%d) : ", rec.m_nLine);
+	strLine += szField;
+	if (rec.m_nFlags & XTRACE_THREADID)
+	{
+		snprintf(szField, sizeof(szField), "[%X] ", rec.m_nThreadID);
+		strLine += szField;
+	}
+	if (bWide)
+		XTraceAppendUtf8(strLine, (const wchar_t*)strMessage.data(), strMessage.size() / sizeof(wchar_t));
+	else
+		strLine += strMessage;
+	if (strLine.empty() || strLine.back() != '\n')
+		strLine += '\n';
+
+	if (m_Config.m_nMaxFileSize && m_nFileSize && m_nFileSize + strLine.size() > m_Config.m_nMaxFileSize)
+		RotateFile();
+	else if (m_Config.m_nMaxFileAge && std::chrono::steady_clock::now() - m_tFileOpened >= std::chrono::seconds(m_Config.m_nMaxFileAge))
+		RotateFile();
+	if (m_pFile == NULL)
+		return;
+	fwrite(strLine.data(), 1, strLine.size(), m_pFile);
+	m_nFileSize += strLine.size();
+} //End CXTraceSink::WriteRecord
+
+bool CXTraceSink::OpenFile()
+{
+	if (m_Config.m_strPath.empty())
+	{
+#ifdef _WIN32
+		wchar_t szPath[MAX_PATH * 2] = { 0 };
+		::GetModuleFileNameW(NULL, szPath, sizeof(szPath) / sizeof(wchar_t) - 2);
+		wchar_t* p = wcsrchr(szPath, L'\\');
+		if (p != NULL)
+			*(p + 1) = L'\0';
+		m_Config.m_strPath = szPath;
+		m_Config.m_strPath += L"_trace.log";
+#else
+		m_Config.m_strPath = "_trace.log";
+#endif
+	}
+#ifdef _WIN32
+	m_pFile = _wfopen(m_Config.m_strPath.c_str(), L"ab");
+#else
+	m_pFile = fopen(m_Config.m_strPath.c_str(), "ab");
+#endif
+	if (m_pFile == NULL)
+		return false;
+	fseek(m_pFile, 0, SEEK_END);
+	long nSize = ftell(m_pFile);
+	m_nFileSize = nSize > 0 ? (uint64_t)nSize : 0;
+	m_tFileOpened = std::chrono::steady_clock::now();
+	return true;
+} //End CXTraceSink::OpenFile
+
+void CXTraceSink::CloseFile()
+{
+	if (m_pFile)
+	{
+		fclose(m_pFile);
+		m_pFile = NULL;
+	}
+	m_nFileSize = 0;
+} //End CXTraceSink::CloseFile
+
+void CXTraceSink::RotateFile()
+{
+	CloseFile();
+	// <path>.n-1 -> <path>.n ... <path> -> <path>.1, the oldest goes
+	for (uint32_t i = m_Config.m_nMaxFiles; i > 0; i--)
+	{
+#ifdef _WIN32
+		std::wstring strTo = m_Config.m_strPath + L"." + std::to_wstring(i);
+		std::wstring strFrom = i > 1 ? m_Config.m_strPath + L"." + std::to_wstring(i - 1) : m_Config.m_strPath;
+		_wremove(strTo.c_str());
+		_wrename(strFrom.c_str(), strTo.c_str());
+#else
+		std::string strTo = m_Config.m_strPath + "." + std::to_string(i);
+		std::string strFrom = i > 1 ? m_Config.m_strPath + "." + std::to_string(i - 1) : m_Config.m_strPath;
+		remove(strTo.c_str());
+		rename(strFrom.c_str(), strTo.c_str());
+#endif
+	}
+	if (m_Config.m_nMaxFiles == 0)
+	{
+#ifdef _WIN32
+		_wremove(m_Config.m_strPath.c_str());
+#else
+		remove(m_Config.m_strPath.c_str());
+#endif
+	}
+	OpenFile();
+} //End CXTraceSink::RotateFile
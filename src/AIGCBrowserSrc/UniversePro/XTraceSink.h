@@ -0,0 +1,171 @@
+/********************************************************************************
+ *           Web Runtime for Application - Version 1.0.0.202203120001           *
+ ********************************************************************************
+ * Copyright (C) 2002-2021 by Tangram Team.   All Rights Reserved.
+ * There are Three Key Features of Webruntime:
+ * 1. Built-in Modern Web Browser: Independent Browser Window and Browser Window
+ *    as sub windows of other windows are supported in the application process;
+ * 2. DOM Plus: DOMPlus is a natural extension of the standard DOM system.
+ *    It allows the application system to support a kind of generalized web pages,
+ *    which are composed of standard DOM elements and binary components supported
+ *    by the application system;
+ * 3. JavaScript for Application: Similar to VBA in MS office, JavaScript will
+ *    become a built-in programmable language in the application system, so that
+ *    the application system can be expanded and developed for the Internet based
+ *    on modern javscript/Web technology.
+ * Use of this source code is governed by a BSD-style license that
+ * can be found in the LICENSE file.
+ *
+ * CONTACT INFORMATION:
+ * mailto:tangramteam@outlook.com or mailto:sunhuizlz@yeah.net
+ * https://www.webruntime.com
+ *******************************************************************************/
+
+// XTraceSink.h : buffered file backend of the XTRACE macros
+//
+// With XTRACE_FILE on, every TRACE line used to find the module path, open
+// _trace.log, seek to its end, write and close it again, all on the thread
+// that traced. CXTraceSink has each tracing thread copy its line and the
+// fields of the line (sequence, steady time, thread, source file and line)
+// into a ring buffer of its own, without locks, and leaves the file to one
+// flusher thread that writes whatever the rings hold in call order and
+// rotates the log by size and by age.
+//
+// A thread whose ring is full waits for the flusher, lines are never dropped.
+// A thread can be preempted between taking its sequence number and putting
+// the record, so the flusher holds back the lines after a missing number
+// until it turns up. After Shutdown the tracing threads drain themselves and
+// write past a gap, the lines are kept but may come out of order.
+
+#pragma once
+
+#pragma warning(push, 3)
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#pragma warning(pop)
+
+#define XTRACE_WIDE		0x0001	// message and file name are wchar_t
+#define XTRACE_MORE		0x0002	// the message goes on in the next record
+#define XTRACE_FULLPATH	0x0004	// keep the path of the source file
+#define XTRACE_THREADID	0x0008	// write the thread id
+
+//ENG: One trace line as it sits in a ring, the message bytes follow it
+struct XTRACERECORD
+{
+	uint64_t	m_nSeq;			// order of the calls over all threads
+	uint64_t	m_nTime;		// steady clock, ns since the sink started
+	const void*	m_pFile;		// the __FILE__ literal of the call
+	int32_t		m_nLine;
+	uint32_t	m_nThreadID;
+	uint32_t	m_nFlags;
+	uint32_t	m_nLength;		// bytes of message in this record
+};
+
+struct XTRACECONFIG
+{
+#ifdef _WIN32
+	std::wstring	m_strPath;	// empty: _trace.log next to the executable
+#else
+	std::string		m_strPath;	// empty: _trace.log in the current directory
+#endif
+	uint64_t		m_nMaxFileSize;		// bytes, 0: never rotate by size
+	uint32_t		m_nMaxFileAge;		// seconds, 0: never rotate by age
+	uint32_t		m_nMaxFiles;		// rotated logs kept as <path>.1 ... <path>.n
+	uint32_t		m_nRingSize;		// bytes per thread, rounded up to a power of two
+	uint32_t		m_nFlushInterval;	// milliseconds between flusher passes
+
+	XTRACECONFIG();
+};
+
+class CXTraceRing;
+
+class CXTraceSink
+{
+public:
+	static CXTraceSink& Instance();
+
+	//ENG: Applies to rings and log files created after the call
+	void Configure(const XTRACECONFIG& config);
+
+	void Write(const char* lpszFile, int nLine, uint32_t nFlags, const char* lpszMessage, size_t nLength);
+	void Write(const wchar_t* lpszFile, int nLine, uint32_t nFlags, const wchar_t* lpszMessage, size_t nLength);
+	void WriteV(const char* lpszFile, int nLine, uint32_t nFlags, const char* lpszFormat, va_list va);
+	void WriteV(const wchar_t* lpszFile, int nLine, uint32_t nFlags, const wchar_t* lpszFormat, va_list va);
+
+	//ENG: Returns once the lines traced before the call, by any thread, are
+	// in the file
+	void Flush();
+	//ENG: Stops the flusher and writes what is left, later lines are written
+	// by the thread that traces them. Safe under the loader lock (ExitInstance
+	// runs in DllMain): the flusher is told to stop and not waited for, it
+	// cannot end while the lock is held and at process exit it is gone already.
+	void Shutdown();
+
+	//ENG: Times a thread found its ring full and had to wait
+	uint64_t GetWaitCount() const {return m_nWaits.load(std::memory_order_relaxed);};
+
+	//ENG: Appends the formatted text to str, of whatever length it needs
+	static void FormatV(std::string& str, const char* lpszFormat, va_list va);
+	static void FormatV(std::wstring& str, const wchar_t* lpszFormat, va_list va);
+
+#ifdef XTRACE_TESTHOOKS
+	//ENG: Called between taking a sequence number and putting the record,
+	// the tests stall producers there
+	void (*m_pfnClaimed)(uint64_t nSeq);
+#endif
+
+private:
+	CXTraceSink();
+	~CXTraceSink();
+
+	void Append(const void* pFile, int nLine, uint32_t nFlags, const void* pMessage, size_t nBytes);
+	CXTraceRing* GetThreadRing();
+	void Wake();
+	void Run();
+	void Drain(bool bAll = false);
+	void WriteRecord(const XTRACERECORD& rec, const std::string& strMessage, std::string& strLine);
+	bool OpenFile();
+	void CloseFile();
+	void RotateFile();
+
+	XTRACECONFIG m_Config;
+	std::chrono::steady_clock::time_point m_tStart;
+	std::atomic<uint64_t> m_nSeq;
+	std::atomic<uint64_t> m_nWaits;
+
+	std::mutex m_csRings;				// the list of rings
+	std::vector<CXTraceRing*> m_vRings;
+
+	std::mutex m_csWake;
+	std::condition_variable m_cvWake;
+	std::condition_variable m_cvPass;
+	std::atomic<bool> m_bWake;
+	std::atomic<bool> m_bRunning;
+	bool m_bStop;
+	bool m_bStarted;
+	std::thread m_Thread;
+
+	// one consumer of the rings at a time; the last drains only try it for
+	// a while, a flusher killed by ExitProcess during a pass never gives it back
+	std::mutex m_csDrain;
+	uint64_t m_nNextSeq;				// the next line to write, under m_csDrain
+	uint64_t m_nWritten;				// m_nNextSeq after the last pass, under m_csWake
+	struct XTRACEENTRY
+	{
+		XTRACERECORD m_Record;
+		std::string m_strMessage;
+	};
+	std::vector<XTRACEENTRY> m_vHeld;	// lines after a gap, under m_csDrain
+	FILE* m_pFile;
+	uint64_t m_nFileSize;
+	std::chrono::steady_clock::time_point m_tFileOpened;
+};
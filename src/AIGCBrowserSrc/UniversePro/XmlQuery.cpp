@@ -0,0 +1,478 @@
+/********************************************************************************
+ *           Web Runtime for Application - Version 1.0.0.202203120001           *
+ ********************************************************************************
+ * Copyright (C) 2002-2021 by Tangram Team.   All Rights Reserved.
+ * There are Three Key Features of Webruntime:
+ * 1. Built-in Modern Web Browser: Independent Browser Window and Browser Window
+ *    as sub windows of other windows are supported in the application process;
+ * 2. DOM Plus: DOMPlus is a natural extension of the standard DOM system.
+ *    It allows the application system to support a kind of generalized web pages,
+ *    which are composed of standard DOM elements and binary components supported
+ *    by the application system;
+ * 3. JavaScript for Application: Similar to VBA in MS office, JavaScript will
+ *    become a built-in programmable language in the application system, so that
+ *    the application system can be expanded and developed for the Internet based
+ *    on modern javscript/Web technology.
+ * Use of this source code is governed by a BSD-style license that
+ * can be found in the LICENSE file.
+ *
+ * CONTACT INFORMATION:
+ * mailto:tangramteam@outlook.com or mailto:sunhuizlz@yeah.net
+ * https://www.webruntime.com
+ *******************************************************************************/
+
+// XmlQuery.cpp : implementation of CTangramXmlQuery
+
+#include "stdafx.h"
+#include "XmlQuery.h"
+
+#define QUERY_SKIPSPACE(p) while (*p == _T(' ') || *p == _T('\t') || *p == _T('\r') || *p == _T('\n')) p++
+
+CTangramXmlQuery::CTangramXmlQuery()
+{
+	m_bValid = false;
+	m_bAnchored = false;
+	m_nMaxDepth = INT_MAX;
+}
+
+CTangramXmlQuery::CTangramXmlQuery(LPCTSTR lpszQuery)
+{
+	Compile(lpszQuery);
+}
+
+CTangramXmlQuery::~CTangramXmlQuery()
+{
+}
+
+bool CTangramXmlQuery::Fail(LPCTSTR lpszError, int nPos)
+{
+	m_strError.Format(_T("%s at offset %d in \"%s\""), lpszError, nPos, (LPCTSTR)m_strQuery);
+	m_vSteps.clear();
+	m_vPredicates.clear();
+	return false;
+}
+
+bool CTangramXmlQuery::Compile(LPCTSTR lpszQuery)
+{
+	m_bValid = false;
+	m_bAnchored = false;
+	m_nMaxDepth = INT_MAX;
+	m_strQuery = lpszQuery ? lpszQuery : _T("");
+	m_strError = _T("");
+	m_vSteps.clear();
+	m_vPredicates.clear();
+
+	LPCTSTR pStart = m_strQuery;
+	LPCTSTR p = pStart;
+	QUERY_SKIPSPACE(p);
+	if (*p == 0)
+		return Fail(_T("empty query"), 0);
+
+	bool bDescendant = false;
+	if (*p == _T('/'))
+	{
+		if (p[1] == _T('/'))
+		{
+			bDescendant = true;
+			p += 2;
+		}
+		else
+		{
+			m_bAnchored = true;
+			p++;
+		}
+	}
+
+	bool bAllChild = true;
+	while (true)
+	{
+		QUERY_SKIPSPACE(p);
+		Step step;
+		step.bDescendant = bDescendant;
+		step.nFirstPredicate = (int)m_vPredicates.size();
+		step.nPredicateCount = 0;
+		if (bDescendant)
+			bAllChild = false;
+		if (*p == _T('*'))
+			p++;
+		else
+		{
+			LPCTSTR pName = p;
+			while (*p && !_tcschr(_T("/[]@=!'\"* \t\r\n"), *p))
+				p++;
+			if (p == pName)
+				return Fail(_T("expected a tag name or '*'"), (int)(p - pStart));
+			step.strTag.SetString(pName, (int)(p - pName));
+		}
+		QUERY_SKIPSPACE(p);
+		while (*p == _T('['))
+		{
+			Predicate pred;
+			if (!ParsePredicate(p, pred))
+				return false;
+			m_vPredicates.push_back(pred);
+			step.nPredicateCount++;
+			QUERY_SKIPSPACE(p);
+		}
+		m_vSteps.push_back(step);
+
+		if (*p == 0)
+			break;
+		if (*p != _T('/'))
+			return Fail(_T("expected '/' or '['"), (int)(p - pStart));
+		if (p[1] == _T('/'))
+		{
+			bDescendant = true;
+			p += 2;
+		}
+		else
+		{
+			bDescendant = false;
+			p++;
+		}
+	}
+
+	// pure child paths never need to look deeper than their own length
+	if (bAllChild)
+		m_nMaxDepth = (int)m_vSteps.size();
+	m_bValid = true;
+	return true;
+}
+
+bool CTangramXmlQuery::ParsePredicate(LPCTSTR& p, Predicate& pred)
+{
+	LPCTSTR pStart = m_strQuery;
+	p++;
+	QUERY_SKIPSPACE(p);
+	if (*p != _T('@'))
+		return Fail(_T("expected '@' in predicate"), (int)(p - pStart));
+	p++;
+	LPCTSTR pName = p;
+	while (*p && !_tcschr(_T("[]=!'\" \t\r\n"), *p))
+		p++;
+	if (p == pName)
+		return Fail(_T("expected an attribute name"), (int)(p - pStart));
+	pred.strAttr.SetString(pName, (int)(p - pName));
+	pred.bstrAttr = pred.strAttr;
+	QUERY_SKIPSPACE(p);
+
+	if (*p == _T(']'))
+	{
+		pred.nOp = QOP_EXISTS;
+		p++;
+		return true;
+	}
+	if (*p == _T('!') && p[1] == _T('='))
+	{
+		pred.nOp = QOP_NOTEQUAL;
+		p += 2;
+	}
+	else if (*p == _T('='))
+	{
+		pred.nOp = QOP_EQUAL;
+		p++;
+	}
+	else
+		return Fail(_T("expected '=', '!=' or ']'"), (int)(p - pStart));
+
+	QUERY_SKIPSPACE(p);
+	TCHAR cQuote = *p;
+	if (cQuote != _T('\'') && cQuote != _T('\"'))
+		return Fail(_T("expected a quoted value"), (int)(p - pStart));
+	LPCTSTR pValue = ++p;
+	while (*p && *p != cQuote)
+		p++;
+	if (*p == 0)
+		return Fail(_T("unterminated value"), (int)(pValue - pStart));
+	pred.strValue.SetString(pValue, (int)(p - pValue));
+	p++;
+	QUERY_SKIPSPACE(p);
+	if (*p != _T(']'))
+		return Fail(_T("expected ']'"), (int)(p - pStart));
+	p++;
+	return true;
+}
+
+bool CTangramXmlQuery::StepTest(CTangramXmlParse* pNode, const Step& step) const
+{
+	if (!step.strTag.IsEmpty() && step.strTag.CompareNoCase(pNode->tagName()) != 0)
+		return false;
+	if (step.nPredicateCount == 0)
+		return true;
+
+	CComPtr<IXMLDOMElement> pElem = pNode->GetElement();
+	if (pElem == nullptr)
+		return false;
+	for (int i = step.nFirstPredicate; i < step.nFirstPredicate + step.nPredicateCount; i++)
+	{
+		const Predicate& pred = m_vPredicates[i];
+		CComVariant var;
+		bool bHas = (pElem->getAttribute(pred.bstrAttr, &var) == S_OK && var.vt == VT_BSTR);
+		switch (pred.nOp)
+		{
+		case QOP_EXISTS:
+			if (!bHas)
+				return false;
+			break;
+		case QOP_EQUAL:
+			if (!bHas || pred.strValue.CompareNoCase(OLE2CT(var.bstrVal)) != 0)
+				return false;
+			break;
+		case QOP_NOTEQUAL:
+			if (bHas && pred.strValue.CompareNoCase(OLE2CT(var.bstrVal)) == 0)
+				return false;
+			break;
+		}
+	}
+	return true;
+}
+
+bool CTangramXmlQuery::StepTest(const CMarkup& xml, int iPos, const Step& step) const
+{
+	int nTagStart = xml.m_aPos[iPos].nStart + 1;
+	CMarkup::TokenPos token(xml.m_strDoc, xml.m_nFlags);
+	if (!step.strTag.IsEmpty())
+	{
+		token.nNext = nTagStart;
+		if (!CMarkup::x_FindName(token))
+			return false;
+		int nLen = token.Length();
+		if (nLen != step.strTag.GetLength() || _tcsnicmp(&token.szDoc[token.nL], step.strTag, nLen) != 0)
+			return false;
+	}
+
+	for (int i = step.nFirstPredicate; i < step.nFirstPredicate + step.nPredicateCount; i++)
+	{
+		const Predicate& pred = m_vPredicates[i];
+		token.nNext = nTagStart;
+		token.nTokenFlags = xml.m_nFlags;
+		bool bHas = CMarkup::x_FindAttrib(token, pred.strAttr);
+		if (pred.nOp == QOP_EXISTS)
+		{
+			if (!bHas)
+				return false;
+			continue;
+		}
+
+		bool bEqual = false;
+		if (bHas)
+		{
+			// compare in place unless the value carries entity references
+			MCD_PCSZ pValue = &token.szDoc[token.nL];
+			int nLen = token.Length();
+			bool bEscaped = false;
+			for (int n = 0; n < nLen && !bEscaped; n++)
+				bEscaped = (pValue[n] == _T('&'));
+			if (bEscaped)
+				bEqual = (pred.strValue.CompareNoCase(CMarkup::UnescapeText(pValue, nLen)) == 0);
+			else
+				bEqual = (nLen == pred.strValue.GetLength() && _tcsnicmp(pValue, pred.strValue, nLen) == 0);
+		}
+		if (bEqual != (pred.nOp == QOP_EQUAL))
+			return false;
+	}
+	return true;
+}
+
+bool CTangramXmlQuery::MatchAt(CTangramXmlParse* pNode, int nStep, CTangramXmlParse* pContext) const
+{
+	const Step& step = m_vSteps[nStep];
+	if (!StepTest(pNode, step))
+		return false;
+	if (nStep == 0)
+	{
+		if (m_bAnchored)
+			return pNode == pContext;
+		return step.bDescendant || pNode->m_pParentParse == pContext;
+	}
+	if (pNode == pContext)
+		return false;
+
+	for (CTangramXmlParse* pParent = pNode->m_pParentParse; pParent; pParent = pParent->m_pParentParse)
+	{
+		if (pParent == pContext && !m_bAnchored)
+			return false;
+		if (MatchAt(pParent, nStep - 1, pContext))
+			return true;
+		if (!step.bDescendant || pParent == pContext)
+			return false;
+	}
+	return false;
+}
+
+bool CTangramXmlQuery::MatchAt(const CMarkup& xml, int iPos, int nStep, int iContext) const
+{
+	// the document itself has no tag, so '/' at the document means its root element
+	bool bAnchored = m_bAnchored && iContext;
+	const Step& step = m_vSteps[nStep];
+	if (!StepTest(xml, iPos, step))
+		return false;
+	if (nStep == 0)
+	{
+		if (bAnchored)
+			return iPos == iContext;
+		return step.bDescendant || MarkupParent(xml, iPos) == iContext;
+	}
+	if (iPos == iContext)
+		return false;
+
+	for (int iParent = MarkupParent(xml, iPos); ; iParent = MarkupParent(xml, iParent))
+	{
+		if (iParent == iContext && !bAnchored)
+			return false;
+		if (iParent == 0)
+			return false;
+		if (MatchAt(xml, iParent, nStep - 1, iContext))
+			return true;
+		if (!step.bDescendant || iParent == iContext)
+			return false;
+	}
+	return false;
+}
+
+bool CTangramXmlQuery::IsMatch(CTangramXmlParse* pNode, CTangramXmlParse* pContext) const
+{
+	return MatchAt(pNode, (int)m_vSteps.size() - 1, pContext);
+}
+
+bool CTangramXmlQuery::IsMatch(const CMarkup& xml, int iPos, int iContext) const
+{
+	return MatchAt(xml, iPos, (int)m_vSteps.size() - 1, iContext);
+}
+
+CTangramXmlParse* CTangramXmlQuery::SelectFirst(CTangramXmlParse* pContext) const
+{
+	CDomCursor cursor(*this, pContext);
+	return cursor.Next();
+}
+
+int CTangramXmlQuery::SelectAll(CTangramXmlParse* pContext, vector<CTangramXmlParse*>& vResult) const
+{
+	int nCount = 0;
+	CDomCursor cursor(*this, pContext);
+	while (CTangramXmlParse* pNode = cursor.Next())
+	{
+		vResult.push_back(pNode);
+		nCount++;
+	}
+	return nCount;
+}
+
+bool CTangramXmlQuery::SelectFirst(CMarkup& xml, int iContext) const
+{
+	CMarkupCursor cursor(*this, xml, iContext);
+	int iPos = cursor.Next();
+	if (iPos == 0)
+		return false;
+	xml.x_SetPos(MarkupParent(xml, iPos), iPos, 0);
+	return true;
+}
+
+CTangramXmlQuery::CDomCursor::CDomCursor(const CTangramXmlQuery& query, CTangramXmlParse* pContext)
+{
+	m_pQuery = &query;
+	m_vStack.reserve(32);
+	Reset(pContext);
+}
+
+void CTangramXmlQuery::CDomCursor::Reset(CTangramXmlParse* pContext)
+{
+	m_pContext = pContext;
+	m_bStarted = false;
+	m_vStack.clear();
+}
+
+CTangramXmlParse* CTangramXmlQuery::CDomCursor::Next()
+{
+	if (m_pContext == nullptr || !m_pQuery->m_bValid)
+		return nullptr;
+	int nMaxDepth = m_pQuery->m_nMaxDepth;
+	if (m_pQuery->m_bAnchored && nMaxDepth != INT_MAX)
+		nMaxDepth--;
+
+	if (!m_bStarted)
+	{
+		m_bStarted = true;
+		m_vStack.push_back(make_pair(m_pContext, 0));
+		if (m_pQuery->m_bAnchored && m_pQuery->IsMatch(m_pContext, m_pContext))
+			return m_pContext;
+	}
+
+	while (!m_vStack.empty())
+	{
+		pair<CTangramXmlParse*, int>& top = m_vStack.back();
+		if ((int)m_vStack.size() > nMaxDepth || top.second >= top.first->GetCount())
+		{
+			m_vStack.pop_back();
+			continue;
+		}
+		CTangramXmlParse* pChild = top.first->GetChild(top.second++);
+		m_vStack.push_back(make_pair(pChild, 0));
+		if (m_pQuery->IsMatch(pChild, m_pContext))
+			return pChild;
+	}
+	return nullptr;
+}
+
+CTangramXmlQuery::CMarkupCursor::CMarkupCursor(const CTangramXmlQuery& query, const CMarkup& xml, int iContext)
+{
+	m_pQuery = &query;
+	m_pXml = &xml;
+	Reset(iContext);
+}
+
+void CTangramXmlQuery::CMarkupCursor::Reset(int iContext)
+{
+	m_iContext = iContext;
+	m_iPos = iContext;
+	m_nDepth = 0;
+	m_bStarted = false;
+}
+
+int CTangramXmlQuery::CMarkupCursor::Next()
+{
+	if (!m_pQuery->m_bValid || m_nDepth < 0)
+		return 0;
+	const CMarkup& xml = *m_pXml;
+	bool bAnchored = m_pQuery->m_bAnchored && m_iContext;
+	int nMaxDepth = m_pQuery->m_nMaxDepth;
+	if (bAnchored && nMaxDepth != INT_MAX)
+		nMaxDepth--;
+
+	if (!m_bStarted)
+	{
+		m_bStarted = true;
+		if (bAnchored && m_pQuery->IsMatch(xml, m_iContext, m_iContext))
+			return m_iContext;
+	}
+
+	while (true)
+	{
+		int iNext = (m_nDepth < nMaxDepth) ? MarkupFirstChild(xml, m_iPos) : 0;
+		if (iNext)
+		{
+			m_iPos = iNext;
+			m_nDepth++;
+		}
+		else
+		{
+			while (m_iPos != m_iContext)
+			{
+				iNext = MarkupNextSibling(xml, m_iPos);
+				if (iNext)
+					break;
+				m_iPos = MarkupParent(xml, m_iPos);
+				m_nDepth--;
+			}
+			if (m_iPos == m_iContext)
+			{
+				m_nDepth = -1;
+				return 0;
+			}
+			m_iPos = iNext;
+		}
+		if (m_pQuery->IsMatch(xml, m_iPos, m_iContext))
+			return m_iPos;
+	}
+	return 0;
+}
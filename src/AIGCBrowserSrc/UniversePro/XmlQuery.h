@@ -0,0 +1,140 @@
+/********************************************************************************
+ *           Web Runtime for Application - Version 1.0.0.202203120001           *
+ ********************************************************************************
+ * Copyright (C) 2002-2021 by Tangram Team.   All Rights Reserved.
+ * There are Three Key Features of Webruntime:
+ * 1. Built-in Modern Web Browser: Independent Browser Window and Browser Window
+ *    as sub windows of other windows are supported in the application process;
+ * 2. DOM Plus: DOMPlus is a natural extension of the standard DOM system.
+ *    It allows the application system to support a kind of generalized web pages,
+ *    which are composed of standard DOM elements and binary components supported
+ *    by the application system;
+ * 3. JavaScript for Application: Similar to VBA in MS office, JavaScript will
+ *    become a built-in programmable language in the application system, so that
+ *    the application system can be expanded and developed for the Internet based
+ *    on modern javscript/Web technology.
+ * Use of this source code is governed by a BSD-style license that
+ * can be found in the LICENSE file.
+ *
+ * CONTACT INFORMATION:
+ * mailto:tangramteam@outlook.com or mailto:sunhuizlz@yeah.net
+ * https://www.webruntime.com
+ *******************************************************************************/
+
+// XmlQuery.h : compiled path/selector queries over layout trees
+//
+// Grammar (a small XPath subset):
+//   query     := ['/' | '//'] step (('/' | '//') step)*
+//   step      := (tag | '*') predicate*
+//   predicate := '[' '@' attr [('=' | '!=') ('value' | "value")] ']'
+//
+// A leading '/' anchors the first step at the context node itself, a leading
+// '//' (or none) starts below it. Tag names and attribute values compare
+// case-insensitively, like CTangramXmlParse::FindItem/FindItemByName.
+//
+// A query is compiled once and can then run any number of times over a
+// CTangramXmlParse tree or directly over the element index of a CMarkup
+// document. Matching works right-to-left from each candidate towards the
+// context node, so no node sets are built while iterating.
+
+#pragma once
+
+#include "Markup.h"
+
+class CTangramXmlQuery
+{
+public:
+	CTangramXmlQuery();
+	CTangramXmlQuery(LPCTSTR lpszQuery);
+	~CTangramXmlQuery();
+
+	bool Compile(LPCTSTR lpszQuery);
+	bool IsValid() const { return m_bValid; }
+	const CString& GetQuery() const { return m_strQuery; }
+	const CString& GetError() const { return m_strError; }
+
+	CTangramXmlParse* SelectFirst(CTangramXmlParse* pContext) const;
+	int SelectAll(CTangramXmlParse* pContext, vector<CTangramXmlParse*>& vResult) const;
+	// positions xml on the first match below iContext (0 = document), returns false if none
+	bool SelectFirst(CMarkup& xml, int iContext = 0) const;
+
+	// Iterates the matches below one CTangramXmlParse node in document order.
+	// The traversal stack is owned by the cursor and reused across Reset calls.
+	class CDomCursor
+	{
+	public:
+		CDomCursor(const CTangramXmlQuery& query, CTangramXmlParse* pContext);
+		void Reset(CTangramXmlParse* pContext);
+		CTangramXmlParse* Next();
+
+	private:
+		const CTangramXmlQuery*						m_pQuery;
+		CTangramXmlParse*							m_pContext;
+		bool										m_bStarted;
+		vector<pair<CTangramXmlParse*, int>>		m_vStack;
+	};
+
+	// Iterates the matching element positions of a CMarkup document without
+	// extracting any substring, returns 0 at the end.
+	class CMarkupCursor
+	{
+	public:
+		CMarkupCursor(const CTangramXmlQuery& query, const CMarkup& xml, int iContext = 0);
+		void Reset(int iContext = 0);
+		int Next();
+
+	private:
+		const CTangramXmlQuery*						m_pQuery;
+		const CMarkup*								m_pXml;
+		int											m_iContext;
+		int											m_iPos;
+		int											m_nDepth;
+		bool										m_bStarted;
+	};
+
+private:
+	enum PredicateOp
+	{
+		QOP_EXISTS = 0,
+		QOP_EQUAL,
+		QOP_NOTEQUAL,
+	};
+
+	struct Predicate
+	{
+		PredicateOp nOp;
+		CString strAttr;
+		CString strValue;
+		CComBSTR bstrAttr;
+	};
+
+	struct Step
+	{
+		bool bDescendant;
+		CString strTag;		// empty for '*'
+		int nFirstPredicate;
+		int nPredicateCount;
+	};
+
+	bool									m_bValid;
+	bool									m_bAnchored;
+	int										m_nMaxDepth;
+	CString									m_strQuery;
+	CString									m_strError;
+	vector<Step>							m_vSteps;
+	vector<Predicate>						m_vPredicates;
+
+	bool Fail(LPCTSTR lpszError, int nPos);
+	bool ParsePredicate(LPCTSTR& p, Predicate& pred);
+
+	bool StepTest(CTangramXmlParse* pNode, const Step& step) const;
+	bool StepTest(const CMarkup& xml, int iPos, const Step& step) const;
+	bool MatchAt(CTangramXmlParse* pNode, int nStep, CTangramXmlParse* pContext) const;
+	bool MatchAt(const CMarkup& xml, int iPos, int nStep, int iContext) const;
+	bool IsMatch(CTangramXmlParse* pNode, CTangramXmlParse* pContext) const;
+	bool IsMatch(const CMarkup& xml, int iPos, int iContext) const;
+
+	static int MarkupParent(const CMarkup& xml, int iPos) { return xml.m_aPos[iPos].iElemParent; }
+	static int MarkupFirstChild(const CMarkup& xml, int iPos) { return xml.m_aPos[iPos].iElemChild; }
+	static int MarkupNextSibling(const CMarkup& xml, int iPos) { return xml.m_aPos[iPos].iElemNext; }
+};
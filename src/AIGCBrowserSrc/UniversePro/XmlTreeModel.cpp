@@ -0,0 +1,340 @@
+/********************************************************************************
+ *           Web Runtime for Application - Version 1.0.0.202203120001           *
+ ********************************************************************************
+ * Copyright (C) 2002-2021 by Tangram Team.   All Rights Reserved.
+ * There are Three Key Features of Webruntime:
+ * 1. Built-in Modern Web Browser: Independent Browser Window and Browser Window
+ *    as sub windows of other windows are supported in the application process;
+ * 2. DOM Plus: DOMPlus is a natural extension of the standard DOM system.
+ *    It allows the application system to support a kind of generalized web pages,
+ *    which are composed of standard DOM elements and binary components supported
+ *    by the application system;
+ * 3. JavaScript for Application: Similar to VBA in MS office, JavaScript will
+ *    become a built-in programmable language in the application system, so that
+ *    the application system can be expanded and developed for the Internet based
+ *    on modern javscript/Web technology.
+ * Use of this source code is governed by a BSD-style license that
+ * can be found in the LICENSE file.
+ *
+ * CONTACT INFORMATION:
+ * mailto:tangramteam@outlook.com or mailto:sunhuizlz@yeah.net
+ * https://www.webruntime.com
+ *******************************************************************************/
+
+#include "stdafx.h"
+#include "XmlTreeModel.h"
+
+CXmlTreeModel::CXmlTreeModel()
+{
+	m_nClock = 0;
+	m_bSmartCheck = false;
+	Clear();
+}
+
+void CXmlTreeModel::Clear()
+{
+	vector<XMLTREENODE>().swap(m_vNodes);
+	vector<int>().swap(m_vLastChild);
+	m_nFirstRoot = NONE;
+	m_nLastRoot = NONE;
+	m_nCount = 0;
+	m_nItems = 0;
+}
+
+int CXmlTreeModel::AddNode(int nParent, void* pSource, bool bChecked, bool bEnabled, bool bSeparator)
+{
+	int n = (int)m_vNodes.size();
+	XMLTREENODE node;
+	node.m_pSource = pSource;
+	node.m_hItem = NULL;
+	node.m_nParent = nParent;
+	node.m_nFirstChild = NONE;
+	node.m_nNextSibling = NONE;
+	node.m_nPending = NONE;
+	node.m_nLast = n;
+	node.m_nDescendants = 0;
+	node.m_nChecked = 0;
+	node.m_nTristate = 0;
+	node.m_nSeparators = 0;
+	node.m_nLastUse = 0;
+	node.m_bChecked = bChecked && !bSeparator;
+	node.m_bEnabled = bEnabled;
+	node.m_bSeparator = bSeparator;
+	node.m_bRemoved = false;
+	m_vNodes.push_back(node);
+	m_vLastChild.push_back(NONE);
+
+	if (nParent == NONE)
+	{
+		if (m_nLastRoot != NONE)
+			m_vNodes[m_nLastRoot].m_nNextSibling = n;
+		else
+			m_nFirstRoot = n;
+		m_nLastRoot = n;
+	}
+	else
+	{
+		int nLast = m_vLastChild[nParent];
+		if (nLast != NONE)
+			m_vNodes[nLast].m_nNextSibling = n;
+		else
+			m_vNodes[nParent].m_nFirstChild = m_vNodes[nParent].m_nPending = n;
+		m_vLastChild[nParent] = n;
+	}
+	m_nCount++;
+	return n;
+}
+
+bool CXmlTreeModel::IsAllChecked(const XMLTREENODE& node) const
+{
+	// same rule as CTangramHtmlTreeWnd::UpdateParents
+	if (node.m_bSeparator || node.m_nDescendants - node.m_nSeparators == 0)
+		return node.m_bChecked;
+	return node.m_nChecked == node.m_nDescendants - node.m_nSeparators;
+}
+
+bool CXmlTreeModel::IsMixed(const XMLTREENODE& node) const
+{
+	// same rule as CTangramHtmlTreeWnd::IsMixed
+	if (!m_bSmartCheck || node.m_bSeparator || node.m_nChecked == 0)
+		return false;
+	return node.m_nChecked != node.m_nDescendants - node.m_nSeparators;
+}
+
+void CXmlTreeModel::AddToParent(int n)
+{
+	const XMLTREENODE& node = m_vNodes[n];
+	if (node.m_nParent == NONE)
+		return;
+	XMLTREENODE& parent = m_vNodes[node.m_nParent];
+	parent.m_nDescendants += 1 + node.m_nDescendants;
+	parent.m_nChecked += node.m_nChecked + (node.m_bChecked ? 1 : 0);
+	parent.m_nTristate += node.m_nTristate + (IsMixed(node) ? 1 : 0);
+	parent.m_nSeparators += node.m_nSeparators + (node.m_bSeparator ? 1 : 0);
+	if (parent.m_nLast < node.m_nLast)
+		parent.m_nLast = node.m_nLast;
+}
+
+void CXmlTreeModel::Aggregate(bool bSmartCheck)
+{
+	m_bSmartCheck = bSmartCheck;
+	int nSize = (int)m_vNodes.size();
+	for (int i = 0; i < nSize; i++)
+	{
+		XMLTREENODE& node = m_vNodes[i];
+		node.m_nLast = i;
+		node.m_nDescendants = 0;
+		node.m_nChecked = 0;
+		node.m_nTristate = 0;
+		node.m_nSeparators = 0;
+	}
+	// children come after their parents, so one backward pass sees every
+	// subtree complete before its root is folded into the parent
+	for (int i = nSize - 1; i >= 0; i--)
+	{
+		XMLTREENODE& node = m_vNodes[i];
+		if (node.m_bRemoved)
+			continue;
+		if (m_bSmartCheck)
+			node.m_bChecked = IsAllChecked(node);
+		AddToParent(i);
+	}
+	vector<int>().swap(m_vLastChild);
+}
+
+void CXmlTreeModel::SetItem(int n, void* hItem)
+{
+	XMLTREENODE& node = m_vNodes[n];
+	if (node.m_hItem && hItem == NULL)
+		m_nItems--;
+	else if (node.m_hItem == NULL && hItem)
+		m_nItems++;
+	node.m_hItem = hItem;
+}
+
+void CXmlTreeModel::SetPending(int n, int nChild)
+{
+	m_vNodes[n].m_nPending = nChild;
+}
+
+void CXmlTreeModel::ReleaseChildren(int n)
+{
+	XMLTREENODE& node = m_vNodes[n];
+	for (int i = n + 1; i <= node.m_nLast; i++)
+	{
+		XMLTREENODE& child = m_vNodes[i];
+		if (child.m_bRemoved)
+			continue;
+		if (child.m_hItem)
+		{
+			child.m_hItem = NULL;
+			m_nItems--;
+		}
+		child.m_nPending = child.m_nFirstChild;
+	}
+	node.m_nPending = node.m_nFirstChild;
+}
+
+void CXmlTreeModel::GetLoadedByAge(vector<int>& vNodes) const
+{
+	vNodes.clear();
+	for (int i = 0; i < (int)m_vNodes.size(); i++)
+	{
+		const XMLTREENODE& node = m_vNodes[i];
+		if (node.m_bRemoved == false && node.m_hItem && node.m_nFirstChild != NONE && IsLoaded(i))
+			vNodes.push_back(i);
+	}
+	const vector<XMLTREENODE>& vAll = m_vNodes;
+	stable_sort(vNodes.begin(), vNodes.end(), [&vAll](int a, int b) { return vAll[a].m_nLastUse < vAll[b].m_nLastUse; });
+}
+
+void CXmlTreeModel::GetPendingCounts(int n, int& nDescendants, int& nChecked, int& nTristate, int& nSeparators) const
+{
+	nDescendants = nChecked = nTristate = nSeparators = 0;
+	for (int c = m_vNodes[n].m_nPending; c != NONE; c = m_vNodes[c].m_nNextSibling)
+	{
+		const XMLTREENODE& child = m_vNodes[c];
+		nDescendants += 1 + child.m_nDescendants;
+		nChecked += child.m_nChecked + (child.m_bChecked ? 1 : 0);
+		nTristate += child.m_nTristate + (IsMixed(child) ? 1 : 0);
+		nSeparators += child.m_nSeparators + (child.m_bSeparator ? 1 : 0);
+	}
+}
+
+void CXmlTreeModel::UpdateParents(int n, int nDescendants, int nChecked, int nTristate, int nSeparators)
+{
+	for (int p = m_vNodes[n].m_nParent; p != NONE; p = m_vNodes[p].m_nParent)
+	{
+		XMLTREENODE& parent = m_vNodes[p];
+		bool bOldMixed = IsMixed(parent);
+		parent.m_nDescendants += nDescendants;
+		parent.m_nChecked += nChecked;
+		parent.m_nTristate += nTristate;
+		parent.m_nSeparators += nSeparators;
+		if (m_bSmartCheck)
+		{
+			bool bOldChecked = parent.m_bChecked;
+			parent.m_bChecked = IsAllChecked(parent);
+			if (parent.m_bChecked != bOldChecked)
+				nChecked += parent.m_bChecked ? 1 : -1;
+		}
+		// the parent's own change is seen by the levels above
+		if (IsMixed(parent) != bOldMixed)
+			nTristate += bOldMixed ? -1 : 1;
+	}
+}
+
+void CXmlTreeModel::SetCheck(int n, bool bCheck)
+{
+	XMLTREENODE& node = m_vNodes[n];
+	if (node.m_bRemoved || node.m_bSeparator)
+		return;
+	int nOld = node.m_nChecked + (node.m_bChecked ? 1 : 0);
+	int nOldMixed = node.m_nTristate + (IsMixed(node) ? 1 : 0);
+	node.m_bChecked = bCheck;
+	if (m_bSmartCheck)
+	{
+		// the subtree follows, disabled records keep their own state
+		for (int i = n + 1; i <= node.m_nLast; i++)
+		{
+			XMLTREENODE& child = m_vNodes[i];
+			if (child.m_bRemoved)
+				continue;
+			if (child.m_bEnabled && !child.m_bSeparator)
+				child.m_bChecked = bCheck;
+			child.m_nChecked = 0;
+			child.m_nTristate = 0;
+		}
+		node.m_nChecked = 0;
+		node.m_nTristate = 0;
+		for (int i = node.m_nLast; i > n; i--)
+		{
+			XMLTREENODE& child = m_vNodes[i];
+			if (child.m_bRemoved)
+				continue;
+			if (child.m_nDescendants)
+				child.m_bChecked = IsAllChecked(child);
+			XMLTREENODE& parent = m_vNodes[child.m_nParent];
+			parent.m_nChecked += child.m_nChecked + (child.m_bChecked ? 1 : 0);
+			parent.m_nTristate += child.m_nTristate + (IsMixed(child) ? 1 : 0);
+		}
+		if (node.m_nDescendants)
+			node.m_bChecked = IsAllChecked(node);
+	}
+	int nNew = node.m_nChecked + (node.m_bChecked ? 1 : 0);
+	int nNewMixed = node.m_nTristate + (IsMixed(node) ? 1 : 0);
+	if (nNew != nOld || nNewMixed != nOldMixed)
+		UpdateParents(n, 0, nNew - nOld, nNewMixed - nOldMixed, 0);
+}
+
+void CXmlTreeModel::SetCheckAll(bool bCheck)
+{
+	for (size_t i = 0; i < m_vNodes.size(); i++)
+	{
+		XMLTREENODE& node = m_vNodes[i];
+		if (node.m_bRemoved == false && node.m_bEnabled && !node.m_bSeparator)
+			node.m_bChecked = bCheck;
+	}
+	Aggregate(m_bSmartCheck);
+}
+
+int CXmlTreeModel::GetCheckedCount() const
+{
+	int nChecked = 0;
+	for (int n = m_nFirstRoot; n != NONE; n = m_vNodes[n].m_nNextSibling)
+		nChecked += m_vNodes[n].m_nChecked + (m_vNodes[n].m_bChecked ? 1 : 0);
+	return nChecked;
+}
+
+void CXmlTreeModel::Unlink(int n)
+{
+	XMLTREENODE& node = m_vNodes[n];
+	int* pFirst = node.m_nParent == NONE ? &m_nFirstRoot : &m_vNodes[node.m_nParent].m_nFirstChild;
+	int nPrev = NONE;
+	for (int c = *pFirst; c != NONE && c != n; c = m_vNodes[c].m_nNextSibling)
+		nPrev = c;
+	if (nPrev == NONE)
+		*pFirst = node.m_nNextSibling;
+	else
+		m_vNodes[nPrev].m_nNextSibling = node.m_nNextSibling;
+	if (node.m_nParent == NONE)
+	{
+		if (m_nLastRoot == n)
+			m_nLastRoot = nPrev;
+	}
+	else
+	{
+		XMLTREENODE& parent = m_vNodes[node.m_nParent];
+		if (parent.m_nPending == n)
+			parent.m_nPending = node.m_nNextSibling;
+		if ((int)m_vLastChild.size() > node.m_nParent && m_vLastChild[node.m_nParent] == n)
+			m_vLastChild[node.m_nParent] = nPrev;
+	}
+}
+
+void CXmlTreeModel::Remove(int n)
+{
+	XMLTREENODE& node = m_vNodes[n];
+	if (node.m_bRemoved)
+		return;
+	int nDescendants = 1 + node.m_nDescendants;
+	int nChecked = node.m_nChecked + (node.m_bChecked ? 1 : 0);
+	int nTristate = node.m_nTristate + (IsMixed(node) ? 1 : 0);
+	int nSeparators = node.m_nSeparators + (node.m_bSeparator ? 1 : 0);
+	Unlink(n);
+	UpdateParents(n, -nDescendants, -nChecked, -nTristate, -nSeparators);
+	for (int i = n; i <= node.m_nLast; i++)
+	{
+		XMLTREENODE& child = m_vNodes[i];
+		if (child.m_bRemoved)
+			continue;
+		if (child.m_hItem)
+		{
+			child.m_hItem = NULL;
+			m_nItems--;
+		}
+		child.m_pSource = NULL;
+		child.m_bRemoved = true;
+		m_nCount--;
+	}
+}
@@ -0,0 +1,121 @@
+/********************************************************************************
+ *           Web Runtime for Application - Version 1.0.0.202203120001           *
+ ********************************************************************************
+ * Copyright (C) 2002-2021 by Tangram Team.   All Rights Reserved.
+ * There are Three Key Features of Webruntime:
+ * 1. Built-in Modern Web Browser: Independent Browser Window and Browser Window
+ *    as sub windows of other windows are supported in the application process;
+ * 2. DOM Plus: DOMPlus is a natural extension of the standard DOM system.
+ *    It allows the application system to support a kind of generalized web pages,
+ *    which are composed of standard DOM elements and binary components supported
+ *    by the application system;
+ * 3. JavaScript for Application: Similar to VBA in MS office, JavaScript will
+ *    become a built-in programmable language in the application system, so that
+ *    the application system can be expanded and developed for the Internet based
+ *    on modern javscript/Web technology.
+ * Use of this source code is governed by a BSD-style license that
+ * can be found in the LICENSE file.
+ *
+ * CONTACT INFORMATION:
+ * mailto:tangramteam@outlook.com or mailto:sunhuizlz@yeah.net
+ * https://www.webruntime.com
+ *******************************************************************************/
+
+// XmlTreeModel.h : index over the XML shown by a CTangramHtmlTreeWnd
+//
+// A large XML document is indexed once into flat node records; the tree
+// control then holds items only for the branches the user has opened. Each
+// record keeps the check state of its element and, like the m_nChildren,
+// m_nChecked, m_nTristate and m_nSeparators counts of a CTangramXHtmlTreeNode,
+// totals for its whole subtree, so checking a branch whose children were never
+// loaded still gives the right tri-state up and down the tree.
+//
+// Records are added in document order, so the subtree of a record is the
+// range of records that follows it up to m_nLast. Nothing in here touches a
+// window, elements and tree items are opaque pointers.
+
+#pragma once
+
+struct XMLTREENODE
+{
+	void*		m_pSource;			// element the record was indexed from
+	void*		m_hItem;			// tree item, NULL while not loaded
+	int			m_nParent;
+	int			m_nFirstChild;
+	int			m_nNextSibling;
+	int			m_nPending;			// first child without a tree item
+	int			m_nLast;			// last record of the subtree
+	int			m_nDescendants;		// as CTangramXHtmlTreeNode::m_nChildren
+	int			m_nChecked;			// checked descendants
+	int			m_nTristate;		// descendants shown tri-state
+	int			m_nSeparators;		// separator descendants
+	__int64		m_nLastUse;
+	bool		m_bChecked;
+	bool		m_bEnabled;
+	bool		m_bSeparator;
+	bool		m_bRemoved;
+};
+
+class CXmlTreeModel
+{
+public:
+	enum { NONE = -1 };
+
+	CXmlTreeModel();
+
+	void Clear();
+	// appends a record under nParent (NONE for a root); parents must be
+	// added before their children, in document order
+	int AddNode(int nParent, void* pSource, bool bChecked, bool bEnabled, bool bSeparator);
+	// computes the subtree totals in one pass once all records are added;
+	// with bSmartCheck a parent is checked when all its descendants are
+	void Aggregate(bool bSmartCheck);
+
+	int GetCount() const { return m_nCount; }
+	int GetItemCount() const { return m_nItems; }
+	const XMLTREENODE& GetNode(int n) const { return m_vNodes[n]; }
+	int GetFirstRoot() const { return m_nFirstRoot; }
+	int GetNextSibling(int n) const { return m_vNodes[n].m_nNextSibling; }
+
+	void SetItem(int n, void* hItem);
+	int GetPending(int n) const { return m_vNodes[n].m_nPending; }
+	void SetPending(int n, int nChild);
+	// TRUE once some children of n have tree items, or n has none
+	bool IsLoaded(int n) const { return m_vNodes[n].m_nPending != m_vNodes[n].m_nFirstChild || m_vNodes[n].m_nFirstChild == NONE; }
+	void Touch(int n) { m_vNodes[n].m_nLastUse = ++m_nClock; }
+	// forgets the tree items below n, which become pending again
+	void ReleaseChildren(int n);
+	// nodes with children in the tree, least recently opened first
+	void GetLoadedByAge(vector<int>& vNodes) const;
+	// totals of the descendants of n that have no tree item yet
+	void GetPendingCounts(int n, int& nDescendants, int& nChecked, int& nTristate, int& nSeparators) const;
+
+	bool GetCheck(int n) const { return m_vNodes[n].m_bChecked; }
+	// TRUE when n shows the tri-state image, i.e. with smart checks some
+	// but not all of its descendants are checked
+	bool IsMixed(int n) const { return IsMixed(m_vNodes[n]); }
+	// checks n; with smart checks its subtree follows and its ancestors
+	// are recomputed
+	void SetCheck(int n, bool bCheck);
+	void SetCheckAll(bool bCheck);
+	int GetCheckedCount() const;
+
+	// drops n and its subtree, e.g. after the element was deleted
+	void Remove(int n);
+
+private:
+	vector<XMLTREENODE>		m_vNodes;
+	vector<int>				m_vLastChild;	// only used while adding
+	int						m_nFirstRoot;
+	int						m_nLastRoot;
+	int						m_nCount;
+	int						m_nItems;
+	__int64					m_nClock;
+	bool					m_bSmartCheck;
+
+	void AddToParent(int n);
+	bool IsAllChecked(const XMLTREENODE& node) const;
+	bool IsMixed(const XMLTREENODE& node) const;
+	void UpdateParents(int n, int nDescendants, int nChecked, int nTristate, int nSeparators);
+	void Unlink(int n);
+};
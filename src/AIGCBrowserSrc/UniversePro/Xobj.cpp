@@ -290,6 +290,7 @@ CXobj::~CXobj()
 		{
 			//BOOL bDeleteFrame = FALSE;
 			pGalaxy->m_mapXobj.erase(it);
+			g_pSpaceTelescope->m_LayoutEviction.Remove(pGalaxy, m_strKey);
 			if (pGalaxy->m_mapXobj.size() == 0)
 			{
 				if (::IsWindow(pGalaxy->m_hWnd))
@@ -834,7 +835,7 @@ STDMETHODIMP CXobj::get_Key(BSTR* pVal)
 
 STDMETHODIMP CXobj::get_XML(BSTR* pVal)
 {
-	*pVal = m_pHostParse->xml().AllocSysString();
+	*pVal = m_pHostParse->xmlCached().AllocSysString();
 	return S_OK;
 }
 
@@ -2138,7 +2139,7 @@ STDMETHODIMP CXobjCollection::get__NewEnum(IUnknown** ppVal)
 STDMETHODIMP CXobj::get_DocXml(BSTR* pVal)
 {
 	g_pSpaceTelescope->UpdateXobj(m_pRootObj);
-	CString strXml = m_pXobjShareData->m_pWebRTParse->xml();
+	CString strXml = m_pXobjShareData->m_pWebRTParse->xmlCached();
 	strXml.Replace(_T("/><"), _T("/>\r\n<"));
 	strXml.Replace(_T("/>"), _T("></xobj>"));
 	*pVal = strXml.AllocSysString();
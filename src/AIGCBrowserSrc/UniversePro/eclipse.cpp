@@ -104,6 +104,11 @@
   * 							   an executable jar)
   * -library					   the location of the eclipse launcher shared library (this library) to use
   * 							   By default, the launcher exe (see eclipseMain.c) finds
+  * --launcher.jniProfile <file>   count and time the JNI calls of the bridge natives and write
+  *                             the profile to <file> as JSON when the VM is cleaned up.
+  * --launcher.explainConfig <file> write to <file> where every launcher, VM and .ee setting
+  *                             comes from, which one wins, the conflicts between them and
+  *                             what changed since the last launch that did this.
   *  <userArgs>                 arguments that are passed along to the Java application
   *                             (i.e, -data <path>, -debug, -console, -consoleLog, etc)
   *  -vmargs <userVMargs> ...   a list of arguments for the VM itself
@@ -165,6 +170,9 @@
 #include "eclipseShm.h"
 #include "eclipseJNI.h"
 #include "eclipseConfig.h"
+#include "eclipsePlan.h"
+#include "eclipseProfile.h"
+#include "eclipseCds.h"
 #include "eclipseCommon.h"
 #include "UniverseApp.h"
 #include "Cosmos.h"
@@ -216,6 +224,14 @@ _TCHAR* cpValue = NULL;
 int		 initialArgc;
 _TCHAR** initialArgv = NULL;
 
+/* Launch plan of an earlier launch with the same inputs, see eclipsePlan.h */
+static LaunchPlan* launchPlan = NULL;
+static _TCHAR* launchPlanFile = NULL;
+static unsigned long long launchPlanKey = 0;
+static _TCHAR* vmPathPrefix = NULL;		/* what determineVM put in front of PATH */
+static int vmPathPrefixSet = 0;			/* the plan put vmPathPrefix there itself */
+static int vmSearchVersion = 0;			/* m_nJVMVersion the VM search starts from */
+
 /* Define the special exit codes returned from Eclipse. */
 #define RESTART_LAST_EC    23
 #define RESTART_NEW_EC     24
@@ -280,6 +296,8 @@ extern _TCHAR* checkVMRegistryKey(HKEY jrekey, _TCHAR* subKeyName);
 #define ADDMODULES	  _T("--add-modules") 
 #define ACTION_OPENFILE _T("openFile")
 #define GTK_VERSION   _T("--launcher.GTK_version")
+#define JNI_PROFILE   _T("--launcher.jniProfile")
+#define EXPLAIN_CONFIG _T("--launcher.explainConfig")
 
 /* constants for ee options file */
 #define EE_EXECUTABLE 			_T("-Dee.executable=")
@@ -309,6 +327,8 @@ static _TCHAR* defaultAction = NULL;			/* default action for non '-' command lin
 static _TCHAR* iniFile = NULL;			/* the launcher.ini file set if  --launcher.ini was specified */
 static _TCHAR* gtkVersionString = NULL;        /* GTK+ version specified by --launcher.GTK_version */
 static _TCHAR* protectMode = NULL;			/* Process protectMode specified via -protect, to trigger the reading of eclipse.ini in the configuration (Mac specific currently) */
+static _TCHAR* jniProfileFile = NULL;		/* where --launcher.jniProfile writes the JNI profile */
+static _TCHAR* explainConfigFile = NULL;	/* where --launcher.explainConfig writes the settings report */
 
 /* variables for ee options */
 static _TCHAR* eeExecutable = NULL;
@@ -359,7 +379,9 @@ static Option options[] = {
 	{ (_TCHAR*)DEFAULTACTION,&defaultAction, 0,			2 },
 	{ (_TCHAR*)WS,			&wsArg,			0,			2 },
 	{ (_TCHAR*)GTK_VERSION,  &gtkVersionString, 0,       2 },
-	{ (_TCHAR*)PROTECT,		&protectMode,	0,			2 } };
+	{ (_TCHAR*)PROTECT,		&protectMode,	0,			2 },
+	{ (_TCHAR*)JNI_PROFILE,	&jniProfileFile, 0,			2 },
+	{ (_TCHAR*)EXPLAIN_CONFIG, &explainConfigFile, 0,		2 } };
 
 static int optionsSize = (sizeof(options) / sizeof(options[0]));
 
@@ -376,6 +398,7 @@ static int eeOptionsSize = (sizeof(eeOptions) / sizeof(eeOptions[0]));
 static _TCHAR * *reqVMarg[] = { &cp, &cpValue, NULL };	/* required VM args */
 _TCHAR * *userVMarg = NULL;	     				/* user specific args for the Java VM  */
 static _TCHAR * *eeVMarg = NULL;							/* vm args specified in ee file */
+static _TCHAR* eeVMargFile = NULL;							/* the ee file eeVMarg was read from */
 static int nEEargs = 0;
 
 /* Local methods */
@@ -385,6 +408,7 @@ static void 	mergeUserVMArgs(_TCHAR * *vmArgs[], _TCHAR * *launchersIniVMArgs);
 static void     getVMCommand(int launchMode, int argc, _TCHAR * argv[], _TCHAR * *vmArgv[], _TCHAR * *progArgv[]);
 static int 		determineVM(_TCHAR * *msg);
 static int 		vmEEProps(_TCHAR * eeFile, _TCHAR * *msg);
+static int 		readEEArgs(_TCHAR * eeFile, int* argc, _TCHAR * **argv, _TCHAR * *eeDir);
 static int 		processEEProps(_TCHAR * eeFile);
 static _TCHAR * *buildLaunchCommand(_TCHAR * program, _TCHAR * *vmArgs, _TCHAR * *progArgs);
 static _TCHAR * *parseArgList(_TCHAR * data);
@@ -397,6 +421,10 @@ static const _TCHAR * getVMArch();
 static int      _run(int argc, _TCHAR * argv[], _TCHAR * vmArgs[]);
 static _TCHAR * *mergeConfigurationFilesVMArgs();
 static _TCHAR * *extractVMArgs(_TCHAR * *launcherIniValues);
+static void		openLaunchPlan();
+static void		storeLaunchPlan();
+static _TCHAR * *getLauncherIniFileFromConfiguration();
+static void		explainConfig();
 
 #ifdef _WIN32
 static void     createConsole();
@@ -507,6 +535,291 @@ static void handleVMArgs(_TCHAR * *vmArgs[]) {
 	processVMArgs(vmArgs);
 }
 
+/* PATH as SetEnvironmentVariable left it, which _tgetenv does not see */
+static CString getPathVariable()
+{
+	CString strPath = _T("");
+	DWORD nLength = GetEnvironmentVariable(_T("PATH"), NULL, 0);
+	if (nLength > 0) {
+		GetEnvironmentVariable(_T("PATH"), strPath.GetBuffer(nLength), nLength);
+		strPath.ReleaseBuffer();
+	}
+	return strPath;
+}
+
+/*
+ * Load the plan an earlier launch stored for the same inputs, if any.
+ *
+ * The key covers what the resolution in GetLaunchMode, findStartupJar and
+ * _run reads: the command line, PATH, the launcher ini, the configured JVM
+ * version and the time stamps of the plugins and shipped VM directories.
+ * The name the startup jar is looked up with is only known later and is
+ * checked by findStartupJar.
+ */
+static void openLaunchPlan()
+{
+	_TCHAR** values;
+	_TCHAR* files[2] = { NULL, NULL };
+	_TCHAR* stamps[3] = { NULL, NULL, NULL };
+	_TCHAR* configFile = NULL;
+	_TCHAR version[16];
+	int		nArgs = 0;
+	int		nValues = 0;
+	int		i;
+
+	if (g_pSpaceTelescope->m_strAppDataPath == _T("") || programDir == NULL)
+		return;
+	launchPlanFile = _tcsdup(g_pSpaceTelescope->m_strAppDataPath + _T("eclipse.plan"));
+
+	LPWSTR* szArglist = CommandLineToArgvW(GetCommandLineW(), &nArgs);
+	CString strPath = getPathVariable();
+	_stprintf(version, _T("%x"), g_pSpaceTelescope->m_nJVMVersion);
+
+	values = (_TCHAR**)malloc((nArgs + 5) * sizeof(_TCHAR*));
+	values[nValues++] = program;
+	values[nValues++] = (_TCHAR*)(LPCTSTR)strPath;
+	values[nValues++] = version;
+	values[nValues++] = isConsoleLauncher() ? (_TCHAR*)_T("console") : (_TCHAR*)_T("window");
+	for (i = 1; i < nArgs; i++) {
+		values[nValues++] = szArglist[i];
+		if (configFile == NULL && i + 1 < nArgs && _tcsicmp(szArglist[i], INI) == 0)
+			configFile = _tcsdup(szArglist[i + 1]);
+	}
+	values[nValues] = NULL;
+
+	if (configFile == NULL)
+		configFile = getIniFile(program, isConsoleLauncher());
+	files[0] = configFile;
+
+	CString strPlugins = CString(programDir) + _T("plugins");
+	CString strShippedVM = CString(programDir) + shippedVMDir;
+	/* _tstat does not take a directory with a separator at the end */
+	strShippedVM.TrimRight(_T("\\/"));
+	stamps[0] = (_TCHAR*)(LPCTSTR)strPlugins;
+	stamps[1] = (_TCHAR*)(LPCTSTR)strShippedVM;
+
+	launchPlanKey = getLaunchPlanKey(values, files, stamps);
+	launchPlan = loadLaunchPlan(launchPlanFile, launchPlanKey);
+	if (launchPlan != NULL && (launchPlan->launchMode != LAUNCH_JNI || launchPlan->jniLib == NULL)) {
+		freeLaunchPlan(launchPlan);
+		launchPlan = NULL;
+	}
+
+	free(configFile);
+	free(values);
+	LocalFree(szArglist);
+}
+
+/*
+ * Store what this launch resolved for the next one with the same inputs.
+ *
+ * Only JNI launches are stored: an exec launch passes the id of shared
+ * memory created for this process, and javaVM is not kept after the VM
+ * library was found.
+ */
+static void storeLaunchPlan()
+{
+	LaunchPlan plan;
+
+	if (launchPlanFile == NULL || g_pSpaceTelescope->launchMode != LAUNCH_JNI || jniLib == NULL)
+		return;
+
+	CString strStartupPrefix = g_pSpaceTelescope->m_strStartJarPath;
+	memset(&plan, 0, sizeof(plan));
+	plan.launchMode = LAUNCH_JNI;
+	plan.jvmVersion = g_pSpaceTelescope->m_nJVMVersion;
+	plan.jniLib = jniLib;
+	plan.eeLibPath = eeLibPath;
+	plan.pathPrefix = vmPathPrefix;
+	plan.startupPrefix = startupArg == NULL ? (_TCHAR*)(LPCTSTR)strStartupPrefix : NULL;
+	plan.jarFile = jarFile;
+	plan.splashBitmap = splashBitmap;
+	plan.vmArgs = vmCommandArgs;
+	plan.progArgs = progCommandArgs;
+	saveLaunchPlan(launchPlanFile, launchPlanKey, &plan);
+}
+
+/*
+ * Set up the class data sharing archive for a JNI launch.
+ *
+ * The archive is made for the VM library, the launcher ini, the startup
+ * jar and the bundle set (the plugins directory and the bundles.info of
+ * the simple configurator), a change to any of them makes a new one.
+ */
+static void openCds()
+{
+	_TCHAR* values[3] = { NULL, NULL, NULL };
+	_TCHAR* files[3] = { NULL, NULL, NULL };
+	_TCHAR* stamps[4] = { NULL, NULL, NULL, NULL };
+	_TCHAR* configFile;
+	_TCHAR version[16];
+
+	if (g_pSpaceTelescope->m_strAppDataPath == _T("") || programDir == NULL || jniLib == NULL)
+		return;
+
+	_stprintf(version, _T("%x"), g_pSpaceTelescope->m_nJVMVersion);
+	values[0] = jniLib;
+	values[1] = version;
+
+	configFile = (iniFile != NULL) ? _tcsdup(iniFile) : getIniFile(program, isConsoleLauncher());
+	CString strBundles = CString(programDir) + _T("configuration\\org.eclipse.equinox.simpleconfigurator\\bundles.info");
+	files[0] = configFile;
+	files[1] = (_TCHAR*)(LPCTSTR)strBundles;
+
+	CString strPlugins = CString(programDir) + _T("plugins");
+	stamps[0] = jniLib;
+	stamps[1] = jarFile;
+	stamps[2] = (_TCHAR*)(LPCTSTR)strPlugins;
+
+	CString strArchive = g_pSpaceTelescope->m_strAppDataPath + _T("eclipse.jsa");
+	openCdsArchive(strArchive, getLaunchPlanKey(values, files, stamps), vmCommandArgs);
+	free(configFile);
+}
+
+/*
+ * Write the --launcher.explainConfig report: every setting of the
+ * launcher ini files, the command line and the .ee file with where it
+ * comes from, the problems found in them and the changes since the
+ * configuration stored by the last launch that wrote a report.
+ */
+static void explainConfig()
+{
+	LaunchConfig* config = newLaunchConfig(appendVmargs);
+	LaunchConfig* previous = NULL;
+	ConfigProblem* problems = NULL;
+	_TCHAR** configArgv = NULL;
+	_TCHAR** eeArgv = NULL;
+	_TCHAR* configFile;
+	_TCHAR* eeFile;
+	_TCHAR* eeDir;
+	_TCHAR* text;
+	FILE* report;
+	int configArgc = 0;
+	int eeArgc = 0;
+	int nArgs = 0;
+	int count, i;
+
+	configFile = (iniFile != NULL) ? _tcsdup(iniFile) : getIniFile(program, consoleLauncher);
+	if (readConfigFile(configFile, &configArgc, &configArgv) == 0) {
+		addConfigArgs(config, CONFIG_LAUNCHER_INI, configFile, configArgv);
+		freeConfig(configArgv);
+	}
+	free(configFile);
+
+	configArgv = getLauncherIniFileFromConfiguration();
+	if (configArgv != NULL) {
+		addConfigArgs(config, CONFIG_CONFIG_INI, NULL, configArgv);
+		freeConfig(configArgv);
+	}
+
+	LPWSTR* szArglist = CommandLineToArgvW(GetCommandLineW(), &nArgs);
+	if (szArglist != NULL) {
+		_TCHAR** args = (_TCHAR**)malloc((nArgs + 1) * sizeof(_TCHAR*));
+		for (i = 1; i < nArgs; i++)
+			args[i - 1] = szArglist[i];
+		args[nArgs > 0 ? nArgs - 1 : 0] = NULL;
+		addConfigArgs(config, CONFIG_COMMAND_LINE, NULL, args);
+		free(args);
+		LocalFree(szArglist);
+	}
+
+	if (eeVMarg != NULL)
+		addConfigArgs(config, CONFIG_EE_FILE, eeVMargFile, eeVMarg);
+	else if (launchPlan != NULL) {
+		/* the VM search that reads the .ee file was skipped, the plan has its name */
+		for (i = 0; vmCommandArgs != NULL && vmCommandArgs[i] != NULL; i++) {
+			if (_tcsncmp(vmCommandArgs[i], EE_FILENAME, _tcslen(EE_FILENAME)) != 0)
+				continue;
+			eeFile = vmCommandArgs[i] + _tcslen(EE_FILENAME);
+			if (readEEArgs(eeFile, &eeArgc, &eeArgv, &eeDir) == 0) {
+				addConfigArgs(config, CONFIG_EE_FILE, eeFile, eeArgv);
+				freeConfig(eeArgv);
+				free(eeDir);
+			}
+			break;
+		}
+	}
+
+	report = _tfopen(explainConfigFile, _T_ECLIPSE("wt"));
+	if (report == NULL) {
+		freeLaunchConfig(config);
+		return;
+	}
+
+	text = explainLaunchConfig(config, NULL);
+	_fputts(text, report);
+	free(text);
+
+	count = validateLaunchConfig(config, &problems);
+	if (count > 0) {
+		_fputts(_T_ECLIPSE("\nProblems\n"), report);
+		for (i = 0; i < count; i++)
+			_ftprintf(report, _T_ECLIPSE("  %s: %s\n"), problems[i].error ? _T_ECLIPSE("error") : _T_ECLIPSE("warning"), problems[i].message);
+	}
+	freeConfigProblems(problems, count);
+
+	if (g_pSpaceTelescope->m_strAppDataPath != _T("")) {
+		CString strPrevious = g_pSpaceTelescope->m_strAppDataPath + _T("eclipse.config");
+		previous = loadLaunchConfig(strPrevious);
+		if (previous != NULL) {
+			text = diffLaunchConfigs(previous, config);
+			_fputts(_T_ECLIPSE("\nChanged since the last launch\n"), report);
+			_fputts(text[0] != 0 ? text : _T_ECLIPSE("  nothing\n"), report);
+			free(text);
+			freeLaunchConfig(previous);
+		}
+		saveLaunchConfig(config, strPrevious);
+	}
+	fclose(report);
+	freeLaunchConfig(config);
+}
+
+/*
+ * The VM search of a launch without a plan. vmPathPrefix keeps what it put
+ * in front of PATH, for the plan this launch stores.
+ */
+static int searchVM(_TCHAR** msg)
+{
+	CString strPath = getPathVariable();
+	int mode = determineVM(msg);
+
+	/* the registry search may have put the VM's bin directory in front */
+	CString strNewPath = getPathVariable();
+	if (strNewPath.GetLength() > strPath.GetLength() && strNewPath.Right(strPath.GetLength()) == strPath)
+		vmPathPrefix = _tcsdup(strNewPath.Left(strNewPath.GetLength() - strPath.GetLength()));
+	return mode;
+}
+
+/*
+ * Drops a plan GetLaunchMode already took the VM from, and undoes what it
+ * took: the VM search runs again as in a launch without a plan, so that
+ * processEEProps reads the .ee arguments getVMCommand adds and the plan this
+ * launch stores has them.
+ */
+static void dropLaunchPlan()
+{
+	_TCHAR* msg = NULL;
+
+	freeLaunchPlan(launchPlan);
+	launchPlan = NULL;
+	free(jniLib);
+	jniLib = NULL;
+	free(eeLibPath);
+	eeLibPath = NULL;
+	if (vmPathPrefix != NULL) {
+		CString strPath = getPathVariable();
+		if (vmPathPrefixSet && strPath.Find(vmPathPrefix) == 0)
+			SetEnvironmentVariable(_T("PATH"), strPath.Mid((int)_tcslen(vmPathPrefix)));
+		free(vmPathPrefix);
+		vmPathPrefix = NULL;
+	}
+	vmPathPrefixSet = 0;
+
+	g_pSpaceTelescope->m_nJVMVersion = vmSearchVersion;
+	g_pSpaceTelescope->launchMode = searchVM(&msg);
+	free(msg);
+}
+
 int GetLaunchMode()
 {
 	_TCHAR* errorMsg = NULL, * msg = nullptr;
@@ -527,7 +840,26 @@ int GetLaunchMode()
 		if (programDir == nullptr)
 			programDir = getProgramDir();
 
-		g_pSpaceTelescope->launchMode = determineVM(&msg);
+		vmSearchVersion = g_pSpaceTelescope->m_nJVMVersion;
+		openLaunchPlan();
+		if (launchPlan != NULL) {
+			/* the VM search of the launch that stored the plan, with its side effects */
+			g_pSpaceTelescope->launchMode = launchPlan->launchMode;
+			g_pSpaceTelescope->m_nJVMVersion = launchPlan->jvmVersion;
+			jniLib = _tcsdup(launchPlan->jniLib);
+			if (launchPlan->eeLibPath != NULL)
+				eeLibPath = _tcsdup(launchPlan->eeLibPath);
+			if (launchPlan->pathPrefix != NULL) {
+				CString strPath = getPathVariable();
+				vmPathPrefix = _tcsdup(launchPlan->pathPrefix);
+				if (strPath.Find(launchPlan->pathPrefix) != 0) {
+					SetEnvironmentVariable(_T("PATH"), launchPlan->pathPrefix + strPath);
+					vmPathPrefixSet = 1;
+				}
+			}
+		}
+		else
+			g_pSpaceTelescope->launchMode = searchVM(&msg);
 		if (g_pSpaceTelescope->launchMode == -1) {
 			/* problem */
 			errorMsg = (_TCHAR*)malloc((_tcslen(noVMMsg) + _tcslen(officialName) + _tcslen(msg) + 1) * sizeof(_TCHAR));
@@ -613,7 +945,12 @@ static int _run(int argc, _TCHAR * argv[], _TCHAR * vmArgs[])
 		exit(1);
 	}
 
-	handleVMArgs(&vmArgs);
+	if (launchPlan != NULL) {
+		/* the launcher ini is part of the plan key, its VM args are in the plan */
+		vmArgs = NULL;
+	}
+	else
+		handleVMArgs(&vmArgs);
 
 	/* Find the startup.jar */
 	if (jarFile == NULL) {
@@ -636,7 +973,10 @@ static int _run(int argc, _TCHAR * argv[], _TCHAR * vmArgs[])
 	/* If the showsplash option was given and we are using JNI */
 	if (!noSplash && showSplashArg)
 	{
-		splashBitmap = findSplash(showSplashArg);
+		if (launchPlan != NULL)
+			splashBitmap = launchPlan->splashBitmap != NULL ? _tcsdup(launchPlan->splashBitmap) : NULL;
+		else
+			splashBitmap = findSplash(showSplashArg);
 		if (splashBitmap != NULL && g_pSpaceTelescope->launchMode == LAUNCH_JNI) {
 			showSplash(splashBitmap);
 		}
@@ -672,12 +1012,22 @@ static int _run(int argc, _TCHAR * argv[], _TCHAR * vmArgs[])
 
 	/* Get the command to start the Java VM. */
 	userVMarg = vmArgs;
-	getVMCommand(g_pSpaceTelescope->launchMode, argc, argv, &vmCommandArgs, &progCommandArgs);
+	if (launchPlan != NULL) {
+		vmCommandArgs = launchPlan->vmArgs;
+		progCommandArgs = launchPlan->progArgs;
+	}
+	else {
+		getVMCommand(g_pSpaceTelescope->launchMode, argc, argv, &vmCommandArgs, &progCommandArgs);
+		storeLaunchPlan();
+	}
 
 	if (g_pSpaceTelescope->launchMode == LAUNCH_EXE) {
 		vmCommand = buildLaunchCommand(javaVM, vmCommandArgs, progCommandArgs);
 	}
 
+	if (explainConfigFile != NULL)
+		explainConfig();
+
 	int launchMode = g_pSpaceTelescope->launchMode;
 	/* While the Java VM should be restarted */
 	while (running)
@@ -692,7 +1042,14 @@ static int _run(int argc, _TCHAR * argv[], _TCHAR * vmArgs[])
 				g_pSpaceTelescope->m_pCLRProxy->CosmosAction((_TCHAR*)_T("<begin_create_jvm_for_eclipse/>"), nullptr);
 
 			TRACE(_T("\n***************%s***************\n\n"),CString(jarFile));
+			if (jniProfileFile != NULL)
+				startJNIProfile(jniProfileFile);
+			openCds();
 			javaResults = startJavaVM(jniLib, vmCommandArgs, progCommandArgs, jarFile);
+
+			/* a plan the VM does not start with is not kept for the next launch */
+			if (javaResults != NULL && javaResults->launchResult != 0)
+				removeLaunchPlan(launchPlanFile);
 		}
 		else {
 			javaResults = launchJavaVM(vmCommand);
@@ -815,8 +1172,33 @@ static int _run(int argc, _TCHAR * argv[], _TCHAR * vmArgs[])
 		restartLauncher(NULL, relaunchCommand);
 
 	/* Cleanup time. */
-	free(vmCommandArgs);
-	free(progCommandArgs);
+	if (launchPlan != NULL) {
+		/* the args are the plan's, strings included */
+		freeLaunchPlan(launchPlan);
+		launchPlan = NULL;
+	}
+	else {
+		free(vmCommandArgs);
+		free(progCommandArgs);
+	}
+	if (eeVMarg != NULL) {
+		/* the VM args were pointing into it */
+		freeConfig(eeVMarg);
+		eeVMarg = NULL;
+		nEEargs = 0;
+	}
+	if (eeVMargFile != NULL) {
+		free(eeVMargFile);
+		eeVMargFile = NULL;
+	}
+	if (launchPlanFile != NULL) {
+		free(launchPlanFile);
+		launchPlanFile = NULL;
+	}
+	if (vmPathPrefix != NULL) {
+		free(vmPathPrefix);
+		vmPathPrefix = NULL;
+	}
 	free(jarFile);
 	free(programDir);
 	free(program);
@@ -1023,7 +1405,10 @@ static _TCHAR * *getLauncherIniFileFromConfiguration() {
 		int configArgc = 0;
 		int ret = 0;
 
-		ret = readConfigFile(getLauncherFileNameFromConfiguration(program), &configArgc, &configArgv);
+		_TCHAR* configFile = getLauncherFileNameFromConfiguration(program);
+
+		ret = readConfigFile(configFile, &configArgc, &configArgv);
+		free(configFile);
 		if (ret == 0)
 			return configArgv;
 		return NULL;
@@ -1043,7 +1428,8 @@ static _TCHAR** getConfigArgs() {
 
 	configFile = (iniFile != NULL) ? iniFile : getIniFile(program, consoleLauncher);
 	ret = readConfigFile(configFile, &configArgc, &configArgv);
-	//free(configFile);
+	if (configFile != iniFile)
+		free(configFile);
 	if (ret == 0)
 		return configArgv;
 	return NULL;
@@ -1501,6 +1887,17 @@ _TCHAR* findStartupJar() {
 	struct _stat stats;
 	size_t pathLength, progLength;
 
+	/* the plan has the jar as long as it is looked up under the same name;
+	 * m_strStartJarPath is only known now, after GetLaunchMode used the plan */
+	if (launchPlan != NULL) {
+		if (startupArg == NULL && launchPlan->startupPrefix != NULL &&
+			g_pSpaceTelescope->m_strStartJarPath == launchPlan->startupPrefix)
+			return _tcsdup(launchPlan->jarFile);
+		dropLaunchPlan();
+		if (g_pSpaceTelescope->launchMode == -1)
+			return NULL;
+	}
+
 	if (startupArg != NULL) {
 		/* startup jar was specified on the command line */
 		ch = _tcsdup(startupArg);
@@ -2042,24 +2439,23 @@ static int determineVM(_TCHAR * *msg) {
 	return LAUNCH_EXE;
 }
 
-static int processEEProps(_TCHAR * eeFile)
+/* Reads the arguments of an .ee file with ${ee.home} replaced and -Dee.home,
+ * -Dee.filename added after them. argc counts those of the file; argv is to
+ * be freed with freeConfig() and eeDir, the directory of the file, with free().
+ */
+static int readEEArgs(_TCHAR * eeFile, int* argc, _TCHAR * **argv, _TCHAR * *eeDir)
 {
-	_TCHAR** argv;
+	_TCHAR** args;
+	_TCHAR* dir;
 	_TCHAR* c1, * c2;
-	_TCHAR* eeDir;
-	int argc;
-	int index, i;
-	int matches = 0;
-	Option* option;
+	int count;
+	int index;
 
-	if (readConfigFile(eeFile, &argc, &argv) != 0)
+	if (readConfigFile(eeFile, &count, &args) != 0)
 		return -1;
 
-	nEEargs = argc;
-	eeVMarg = argv;
-
-	eeDir = _tcsdup(eeFile);
-	c1 = lastDirSeparator(eeDir);
+	dir = _tcsdup(eeFile);
+	c1 = lastDirSeparator(dir);
 	while (c1 != NULL)
 	{
 		*c1 = _T_ECLIPSE('\0');
@@ -2068,18 +2464,56 @@ static int processEEProps(_TCHAR * eeFile)
 			c1 = NULL;
 	}
 
-	for (index = 0; index < argc; index++) {
+	for (index = 0; index < count; index++) {
 		/* replace ${ee.home} with eeDir, loop in case there is more than one per argument */
-		while ((c1 = _tcsstr(argv[index], EE_HOME_VAR)) != NULL)
+		while ((c1 = _tcsstr(args[index], EE_HOME_VAR)) != NULL)
 		{
-			/* the space needed for c1 is included in _tcslen(argv[index]) */
-			c2 = (_TCHAR*)malloc((_tcslen(argv[index]) + _tcslen(eeDir) + 1) * sizeof(_TCHAR));
+			/* the space needed for c1 is included in _tcslen(args[index]) */
+			c2 = (_TCHAR*)malloc((_tcslen(args[index]) + _tcslen(dir) + 1) * sizeof(_TCHAR));
 			*c1 = _T_ECLIPSE('\0');
-			_stprintf(c2, _T_ECLIPSE("%s%s%s"), argv[index], eeDir, c1 + 10); /* ${ee.home} is 10 characters */
-			free(argv[index]);
-			argv[index] = c2;
+			_stprintf(c2, _T_ECLIPSE("%s%s%s"), args[index], dir, c1 + 10); /* ${ee.home} is 10 characters */
+			free(args[index]);
+			args[index] = c2;
 		}
+	}
+
+	/* set ee.home, ee.filename variables, and NULL */
+	args = (_TCHAR * *)realloc(args, (count + 3) * sizeof(_TCHAR*));
+
+	c1 = (_TCHAR*)malloc((_tcslen(EE_HOME) + _tcslen(dir) + 1) * sizeof(_TCHAR));
+	_stprintf(c1, _T_ECLIPSE("%s%s"), EE_HOME, dir);
+	args[count] = c1;
+
+	c1 = (_TCHAR*)malloc((_tcslen(EE_FILENAME) + _tcslen(eeFile) + 1) * sizeof(_TCHAR));
+	_stprintf(c1, _T_ECLIPSE("%s%s"), EE_FILENAME, eeFile);
+	args[count + 1] = c1;
+
+	args[count + 2] = NULL;
+
+	*argc = count;
+	*argv = args;
+	*eeDir = dir;
+	return 0;
+}
 
+static int processEEProps(_TCHAR * eeFile)
+{
+	_TCHAR** argv;
+	_TCHAR* c1, * c2;
+	_TCHAR* eeDir;
+	int argc;
+	int index, i;
+	int matches = 0;
+	Option* option;
+
+	if (readEEArgs(eeFile, &argc, &argv, &eeDir) != 0)
+		return -1;
+
+	nEEargs = argc + 2;
+	eeVMarg = argv;
+	eeVMargFile = _tcsdup(eeFile);
+
+	for (index = 0; index < argc; index++) {
 		/* Find the corresponding argument is a option supported by the launcher */
 		option = NULL;
 		for (i = 0; option == NULL && i < eeOptionsSize; i++)
@@ -2114,18 +2548,6 @@ static int processEEProps(_TCHAR * eeFile)
 				break;
 		}
 	}
-	/* set ee.home, ee.filename variables, and NULL */
-	argv = (_TCHAR * *)realloc(argv, (nEEargs + 3) * sizeof(_TCHAR*));
-
-	c1 = (_TCHAR*)malloc((_tcslen(EE_HOME) + _tcslen(eeDir) + 1) * sizeof(_TCHAR));
-	_stprintf(c1, _T_ECLIPSE("%s%s"), EE_HOME, eeDir);
-	argv[nEEargs++] = c1;
-
-	c1 = (_TCHAR*)malloc((_tcslen(EE_FILENAME) + _tcslen(eeFile) + 1) * sizeof(_TCHAR));
-	_stprintf(c1, _T_ECLIPSE("%s%s"), EE_FILENAME, eeFile);
-	argv[nEEargs++] = c1;
-
-	argv[nEEargs] = NULL;
 
 	free(eeDir);
 	return 0;
@@ -0,0 +1,226 @@
+/********************************************************************************
+ *           Web Runtime for Application - Version 1.0.0.202203120001           *
+ ********************************************************************************
+ * Copyright (C) 2002-2021 by Tangram Team.   All Rights Reserved.
+ * There are Three Key Features of Webruntime:
+ * 1. Built-in Modern Web Browser: Independent Browser Window and Browser Window
+ *    as sub windows of other windows are supported in the application process;
+ * 2. DOM Plus: DOMPlus is a natural extension of the standard DOM system.
+ *    It allows the application system to support a kind of generalized web pages,
+ *    which are composed of standard DOM elements and binary components supported
+ *    by the application system;
+ * 3. JavaScript for Application: Similar to VBA in MS office, JavaScript will
+ *    become a built-in programmable language in the application system, so that
+ *    the application system can be expanded and developed for the Internet based
+ *    on modern javscript/Web technology.
+ * Use of this source code is governed by a BSD-style license that
+ * can be found in the LICENSE file.
+ *
+ * CONTACT INFORMATION:
+ * mailto:tangramteam@outlook.com or mailto:sunhuizlz@yeah.net
+ * https://www.webruntime.com
+ *******************************************************************************/
+
+#include "stdafx.h"
+
+#include "eclipseOS.h"
+#include "eclipseCommon.h"
+#include "eclipseCds.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#define CDS_MAX_VERSION		128
+
+/* VM arguments that mean the user set up sharing */
+static const _TCHAR* sharingArgs[] = {
+	_T_ECLIPSE("-Xshare"),
+	_T_ECLIPSE("-XX:SharedArchiveFile"),
+	_T_ECLIPSE("-XX:ArchiveClassesAtExit"),
+	_T_ECLIPSE("-XX:SharedClassListFile"),
+	_T_ECLIPSE("-XX:+AutoCreateSharedArchive"),
+	NULL
+};
+
+/* what the state file next to the archive holds */
+typedef struct {
+	unsigned long long	key;
+	int					valid;			/* the VM of a successful launch wrote the archive */
+	char				vmVersion[CDS_MAX_VERSION];
+	long long			startups[2];	/* launches without and with the archive */
+	long long			lastMs[2];
+	long long			totalMs[2];
+} CdsState;
+
+int cdsMode = CDS_OFF;
+
+static _TCHAR* archiveFile = NULL;
+static _TCHAR* stateFile = NULL;
+static unsigned long long archiveKey = 0;
+static CdsState state;
+static int dumpPending = 0;			/* the archive is kept once the VM exited */
+static char runningVersion[CDS_MAX_VERSION];
+
+static int readState(CdsState* cds) {
+	FILE* file = _tfopen(stateFile, _T_ECLIPSE("r"));
+	int read;
+
+	memset(cds, 0, sizeof(CdsState));
+	if (file == NULL)
+		return -1;
+	read = fscanf(file, "key %llx\nvalid %d\nvm %127s\nwithout %lld %lld %lld\nwith %lld %lld %lld\n",
+		&cds->key, &cds->valid, cds->vmVersion,
+		&cds->startups[0], &cds->lastMs[0], &cds->totalMs[0],
+		&cds->startups[1], &cds->lastMs[1], &cds->totalMs[1]);
+	fclose(file);
+	if (read != 9) {
+		memset(cds, 0, sizeof(CdsState));
+		return -1;
+	}
+	if (strcmp(cds->vmVersion, "-") == 0)
+		cds->vmVersion[0] = 0;
+	return 0;
+}
+
+static void writeState(CdsState* cds) {
+	FILE* file = _tfopen(stateFile, _T_ECLIPSE("w"));
+
+	if (file == NULL)
+		return;
+	fprintf(file, "key %llx\nvalid %d\nvm %s\nwithout %lld %lld %lld\nwith %lld %lld %lld\n",
+		cds->key, cds->valid, cds->vmVersion[0] != 0 ? cds->vmVersion : "-",
+		cds->startups[0], cds->lastMs[0], cds->totalMs[0],
+		cds->startups[1], cds->lastMs[1], cds->totalMs[1]);
+	fclose(file);
+}
+
+static int isFile(const _TCHAR* path) {
+	struct _stat stats;
+	return _tstat(path, &stats) == 0 && (stats.st_mode & S_IFREG) != 0 && stats.st_size > 0;
+}
+
+void openCdsArchive(const _TCHAR* archive, unsigned long long key, _TCHAR* vmArgs[]) {
+	int i, j;
+
+	cdsMode = CDS_OFF;
+	if (archive == NULL || vmArgs == NULL)
+		return;
+	for (i = 0; vmArgs[i] != NULL; i++) {
+		for (j = 0; sharingArgs[j] != NULL; j++) {
+			if (_tcsncmp(vmArgs[i], sharingArgs[j], _tcslen(sharingArgs[j])) == 0)
+				return;
+		}
+	}
+
+	free(archiveFile);
+	free(stateFile);
+	archiveFile = _tcsdup(archive);
+	stateFile = (_TCHAR*)malloc((_tcslen(archive) + 7) * sizeof(_TCHAR));
+	_stprintf(stateFile, _T_ECLIPSE("%s.state"), archive);
+	archiveKey = key;
+	runningVersion[0] = 0;
+	dumpPending = 0;
+
+	/* timings are kept across archives, the rest belongs to the one made for the key */
+	readState(&state);
+	if (state.key == key && state.valid && isFile(archiveFile)) {
+		cdsMode = CDS_USE;
+		return;
+	}
+	state.key = key;
+	state.valid = 0;
+	state.vmVersion[0] = 0;
+	writeState(&state);
+	_tremove(archiveFile);
+	cdsMode = CDS_DUMP;
+}
+
+char* getCdsOption() {
+	const _TCHAR* format;
+	_TCHAR* option;
+	char* result;
+
+	if (cdsMode == CDS_USE)
+		format = _T_ECLIPSE("-XX:SharedArchiveFile=%s");
+	else if (cdsMode == CDS_DUMP)
+		format = _T_ECLIPSE("-XX:ArchiveClassesAtExit=%s");
+	else
+		return NULL;
+
+	option = (_TCHAR*)malloc((_tcslen(format) + _tcslen(archiveFile) + 1) * sizeof(_TCHAR));
+	_stprintf(option, format, archiveFile);
+	result = toNarrow(option);
+	free(option);
+	return result;
+}
+
+void dropCdsArchive() {
+	if (cdsMode == CDS_OFF)
+		return;
+	state.valid = 0;
+	writeState(&state);
+	_tremove(archiveFile);
+	dumpPending = 0;
+	cdsMode = CDS_OFF;
+}
+
+void checkCdsArchive(const char* vmVersion, int sharing) {
+	if (cdsMode == CDS_OFF)
+		return;
+	if (vmVersion != NULL) {
+		strncpy(runningVersion, vmVersion, CDS_MAX_VERSION - 1);
+		runningVersion[CDS_MAX_VERSION - 1] = 0;
+		/* the state file keeps one word */
+		for (char* ch = runningVersion; *ch != 0; ch++) {
+			if (*ch == ' ' || *ch == '\t' || *ch == '\n')
+				*ch = '_';
+		}
+	}
+	if (cdsMode != CDS_USE)
+		return;
+
+	/* the VM quietly goes on without an archive it can not map */
+	if (!sharing || (state.vmVersion[0] != 0 && strcmp(state.vmVersion, runningVersion) != 0)) {
+		state.valid = 0;
+		state.vmVersion[0] = 0;
+		writeState(&state);
+		/* the VM has the archive mapped, the next launch replaces it */
+		cdsMode = CDS_OFF;
+	}
+}
+
+void finishCdsArchive(int success, long long startupMs) {
+	int with;
+
+	if (archiveFile == NULL || stateFile == NULL)
+		return;
+
+	/* timings are kept for dropped archives too, they were launches without one */
+	with = cdsMode == CDS_USE ? 1 : 0;
+	state.startups[with]++;
+	state.lastMs[with] = startupMs;
+	state.totalMs[with] += startupMs;
+
+	/* the VM writes the archive when it exits, after this */
+	dumpPending = cdsMode == CDS_DUMP && success;
+	writeState(&state);
+}
+
+int isCdsDumpPending() {
+	return dumpPending;
+}
+
+void closeCdsArchive() {
+	if (!dumpPending)
+		return;
+	dumpPending = 0;
+	/* a VM that failed to dump leaves no file, the next launch tries again */
+	if (!isFile(archiveFile))
+		return;
+	state.valid = 1;
+	strcpy(state.vmVersion, runningVersion);
+	writeState(&state);
+}
@@ -0,0 +1,94 @@
+/********************************************************************************
+ *           Web Runtime for Application - Version 1.0.0.202203120001           *
+ ********************************************************************************
+ * Copyright (C) 2002-2021 by Tangram Team.   All Rights Reserved.
+ * There are Three Key Features of Webruntime:
+ * 1. Built-in Modern Web Browser: Independent Browser Window and Browser Window
+ *    as sub windows of other windows are supported in the application process;
+ * 2. DOM Plus: DOMPlus is a natural extension of the standard DOM system.
+ *    It allows the application system to support a kind of generalized web pages,
+ *    which are composed of standard DOM elements and binary components supported
+ *    by the application system;
+ * 3. JavaScript for Application: Similar to VBA in MS office, JavaScript will
+ *    become a built-in programmable language in the application system, so that
+ *    the application system can be expanded and developed for the Internet based
+ *    on modern javscript/Web technology.
+ * Use of this source code is governed by a BSD-style license that
+ * can be found in the LICENSE file.
+ *
+ * CONTACT INFORMATION:
+ * mailto:tangramteam@outlook.com or mailto:sunhuizlz@yeah.net
+ * https://www.webruntime.com
+ *******************************************************************************/
+
+#ifndef ECLIPSE_CDS_H
+#define ECLIPSE_CDS_H
+
+/* Class data sharing archive management
+ *
+ * The launcher keeps a dynamic CDS archive of the classes the workbench
+ * loads. A launch without a usable archive asks the VM to write one at exit
+ * (-XX:ArchiveClassesAtExit); the VM does so only in DestroyJavaVM or
+ * System.exit(), so that launch ends its VM. Once it ran successfully and
+ * the file is there the archive is passed to the following launches
+ * (-XX:SharedArchiveFile).
+ *
+ * Next to the archive a small text file holds the key the archive was made
+ * for, the version of the VM that made it and the startup times with and
+ * without it. The key covers the VM library, the launcher ini and the bundle
+ * set, and an archive the VM does not map is dropped, so the next launch
+ * makes a new one.
+ */
+
+#define CDS_OFF		0		/* not managed, the VM arguments set up sharing themselves */
+#define CDS_DUMP	1		/* the VM writes the archive at exit */
+#define CDS_USE		2		/* the VM maps the archive */
+
+/* how the archive is used by this launch */
+extern int cdsMode;
+
+/**
+ * Decides how to use the archive for this launch. vmArgs are the
+ * arguments the VM will be started with; when they already mention
+ * sharing the archive is not managed.
+ */
+extern void openCdsArchive(const _TCHAR* archive, unsigned long long key, _TCHAR* vmArgs[]);
+
+/**
+ * Returns the VM option for the archive as a narrow string to be freed
+ * with free(), or NULL when cdsMode is CDS_OFF.
+ */
+extern char* getCdsOption();
+
+/**
+ * Drops the archive because the VM could not be created with it,
+ * the launch goes on without one.
+ */
+extern void dropCdsArchive();
+
+/**
+ * Checks the archive against the VM that was started: vmVersion is its
+ * java.vm.version and sharing tells whether java.vm.info says classes
+ * are shared. An archive in use that another VM made or that the VM
+ * did not map is dropped.
+ */
+extern void checkCdsArchive(const char* vmVersion, int sharing);
+
+/**
+ * Records the startup time of this launch and whether it succeeded.
+ */
+extern void finishCdsArchive(int success, long long startupMs);
+
+/**
+ * Tells whether the VM has to exit for the archive to be written:
+ * this launch makes it and its run succeeded.
+ */
+extern int isCdsDumpPending();
+
+/**
+ * Keeps the archive the VM wrote as it exited for the next launches,
+ * if the file is there.
+ */
+extern void closeCdsArchive();
+
+#endif /* ECLIPSE_CDS_H */
@@ -42,11 +42,9 @@
 #ifdef _WIN32
 
 #include <stdio.h>
-#include <sys/stat.h>
-
-#ifdef __MINGW32__
 #include <stdlib.h>
-#endif
+#include <string.h>
+#include <sys/stat.h>
 
 #else /* Unix like platforms */
 
@@ -72,7 +70,7 @@ int readIniFile(_TCHAR* program, int *argc, _TCHAR ***argv)
 #endif
 	
 	result = readConfigFile(config_file, argc, argv);
-	//free(config_file);
+	free(config_file);
 	return result;
 }
 
@@ -140,10 +138,7 @@ int readConfigFile( _TCHAR * config_file, int *argc, _TCHAR ***argv )
 	 */	
 	file = _tfopen(config_file, _T_ECLIPSE("rt"));	
 	if (file == NULL)
-	{
-		free(config_file);
 		return -3;
-	}
 
 	/* allocate buffers */
 	buffer =  (_TCHAR*)malloc(bufferSize * sizeof(_TCHAR));
@@ -197,7 +192,6 @@ int readConfigFile( _TCHAR * config_file, int *argc, _TCHAR ***argv )
 			
 			(*argv)[index] = arg;
 			index++;
-			free(arg);//find Eclipse bug by tangram team
 			/* Grow the array of TCHAR*. Ensure one more entry is
 			 * available for the final NULL entry
 			 */
@@ -214,7 +208,6 @@ int readConfigFile( _TCHAR * config_file, int *argc, _TCHAR ***argv )
 	fclose(file);
 	free(buffer);
 	free(argument);
-	free(config_file);
 	return 0;
 }
 
@@ -229,3 +222,645 @@ void freeConfig(_TCHAR **argv)
 	}
 	free(argv);
 }
+
+/* Launch configuration model */
+
+#define CONFIG_VMARGS		_T_ECLIPSE("-vmargs")
+#define CONFIG_EE_PREFIX	_T_ECLIPSE("-Dee.")
+#define CONFIG_FORMAT		_T_ECLIPSE("launchconfig")
+#define CONFIG_VERSION		1
+#define CONFIG_FIELDS		9
+
+static const _TCHAR* sourceNames[] = {
+	_T_ECLIPSE("launcher ini"),
+	_T_ECLIPSE("configuration ini"),
+	_T_ECLIPSE("command line"),
+	_T_ECLIPSE(".ee file")
+};
+
+static const _TCHAR* kindNames[] = {
+	_T_ECLIPSE("program option"),
+	_T_ECLIPSE("VM option"),
+	_T_ECLIPSE("EE property")
+};
+
+/* VM options that add up instead of overriding each other */
+static const _TCHAR* repeatableVMOptions[] = {
+	_T_ECLIPSE("--add-modules"),
+	_T_ECLIPSE("--add-opens"),
+	_T_ECLIPSE("--add-exports"),
+	_T_ECLIPSE("--add-reads"),
+	_T_ECLIPSE("--patch-module"),
+	_T_ECLIPSE("-javaagent"),
+	_T_ECLIPSE("-agentlib"),
+	_T_ECLIPSE("-agentpath"),
+	_T_ECLIPSE("-Xlog"),
+	_T_ECLIPSE("-ea"),
+	_T_ECLIPSE("-da"),
+	_T_ECLIPSE("-enableassertions"),
+	_T_ECLIPSE("-disableassertions"),
+	NULL
+};
+
+/* VM options whose value may be the next argument */
+static const _TCHAR* separateValueVMOptions[] = {
+	_T_ECLIPSE("--add-modules"),
+	_T_ECLIPSE("--add-opens"),
+	_T_ECLIPSE("--add-exports"),
+	_T_ECLIPSE("--add-reads"),
+	_T_ECLIPSE("--patch-module"),
+	_T_ECLIPSE("--module-path"),
+	_T_ECLIPSE("--upgrade-module-path"),
+	_T_ECLIPSE("-classpath"),
+	_T_ECLIPSE("-cp"),
+	NULL
+};
+
+/* VM options with the value right after the name */
+static const _TCHAR* sizeVMOptions[] = {
+	_T_ECLIPSE("-Xmx"),
+	_T_ECLIPSE("-Xms"),
+	_T_ECLIPSE("-Xss"),
+	_T_ECLIPSE("-Xmn"),
+	NULL
+};
+
+/* only one of these can be selected */
+static const _TCHAR* collectors[] = {
+	_T_ECLIPSE("-XX:UseSerialGC"),
+	_T_ECLIPSE("-XX:UseParallelGC"),
+	_T_ECLIPSE("-XX:UseConcMarkSweepGC"),
+	_T_ECLIPSE("-XX:UseG1GC"),
+	_T_ECLIPSE("-XX:UseZGC"),
+	_T_ECLIPSE("-XX:UseShenandoahGC"),
+	_T_ECLIPSE("-XX:UseEpsilonGC"),
+	NULL
+};
+
+/* Text that grows as it is appended to */
+typedef struct {
+	_TCHAR*	text;
+	size_t	length;
+	size_t	capacity;
+} ConfigText;
+
+static void appendText(ConfigText* text, const _TCHAR* str) {
+	size_t length = _tcslen(str);
+	if (text->length + length + 1 > text->capacity) {
+		while (text->length + length + 1 > text->capacity)
+			text->capacity = text->capacity == 0 ? 256 : text->capacity * 2;
+		text->text = (_TCHAR*)realloc(text->text, text->capacity * sizeof(_TCHAR));
+	}
+	_tcscpy(text->text + text->length, str);
+	text->length += length;
+}
+
+static void appendNumber(ConfigText* text, int number) {
+	_TCHAR buffer[16];
+	_stprintf(buffer, _T_ECLIPSE("%d"), number);
+	appendText(text, buffer);
+}
+
+static _TCHAR* takeText(ConfigText* text) {
+	if (text->text == NULL)
+		appendText(text, _T_ECLIPSE(""));
+	return text->text;
+}
+
+static int startsWith(const _TCHAR* str, const _TCHAR* prefix) {
+	return _tcsncmp(str, prefix, _tcslen(prefix)) == 0;
+}
+
+static int isListed(const _TCHAR* name, const _TCHAR* list[]) {
+	int i;
+	for (i = 0; list[i] != NULL; i++) {
+		if (_tcscmp(name, list[i]) == 0)
+			return 1;
+	}
+	return 0;
+}
+
+static _TCHAR* copyString(const _TCHAR* str, size_t length) {
+	_TCHAR* copy = (_TCHAR*)malloc((length + 1) * sizeof(_TCHAR));
+	memcpy(copy, str, length * sizeof(_TCHAR));
+	copy[length] = 0;
+	return copy;
+}
+
+static int sameString(const _TCHAR* str1, const _TCHAR* str2) {
+	if (str1 == NULL || str2 == NULL)
+		return str1 == str2;
+	return _tcscmp(str1, str2) == 0;
+}
+
+/* Splits a VM option into the name that identifies it and its value */
+static void splitVMOption(const _TCHAR* arg, _TCHAR** name, _TCHAR** value) {
+	const _TCHAR* separator = NULL;
+	int i;
+
+	*value = NULL;
+	if (startsWith(arg, _T_ECLIPSE("-D"))) {
+		separator = _tcschr(arg, _T_ECLIPSE('='));
+	}
+	else if (startsWith(arg, _T_ECLIPSE("-XX:"))) {
+		/* -XX:+Flag and -XX:-Flag set the same flag */
+		if (arg[4] == _T_ECLIPSE('+') || arg[4] == _T_ECLIPSE('-')) {
+			*name = (_TCHAR*)malloc((_tcslen(arg) + 1) * sizeof(_TCHAR));
+			_tcscpy(*name, _T_ECLIPSE("-XX:"));
+			_tcscpy(*name + 4, arg + 5);
+			*value = copyString(arg + 4, 1);
+			return;
+		}
+		separator = _tcschr(arg, _T_ECLIPSE('='));
+	}
+	else {
+		for (i = 0; sizeVMOptions[i] != NULL; i++) {
+			if (startsWith(arg, sizeVMOptions[i]) && _tcslen(arg) > _tcslen(sizeVMOptions[i])) {
+				*name = _tcsdup(sizeVMOptions[i]);
+				*value = _tcsdup(arg + _tcslen(sizeVMOptions[i]));
+				return;
+			}
+		}
+		/* -Xshare:off, -javaagent:<jar>, --add-modules=<modules> */
+		separator = _tcschr(arg, _T_ECLIPSE(':'));
+		if (separator == NULL || (_tcschr(arg, _T_ECLIPSE('=')) != NULL && _tcschr(arg, _T_ECLIPSE('=')) < separator))
+			separator = _tcschr(arg, _T_ECLIPSE('='));
+	}
+
+	if (separator != NULL) {
+		*name = copyString(arg, separator - arg);
+		*value = _tcsdup(separator + 1);
+	}
+	else {
+		*name = _tcsdup(arg);
+	}
+}
+
+static void addSetting(LaunchConfig* config, int kind, int source, const _TCHAR* file, int position,
+	_TCHAR* name, _TCHAR* value, _TCHAR* arg, int repeatable) {
+	ConfigSetting* setting;
+
+	if (config->count == config->capacity) {
+		config->capacity = config->capacity == 0 ? 32 : config->capacity * 2;
+		config->settings = (ConfigSetting*)realloc(config->settings, config->capacity * sizeof(ConfigSetting));
+	}
+	setting = &config->settings[config->count++];
+	setting->kind = kind;
+	setting->source = source;
+	setting->file = file != NULL ? _tcsdup(file) : NULL;
+	setting->position = position;
+	setting->name = name;
+	setting->value = value;
+	setting->arg = arg;
+	setting->repeatable = repeatable;
+	setting->overriddenBy = CONFIG_EFFECTIVE;
+}
+
+static _TCHAR* joinArgs(const _TCHAR* arg1, const _TCHAR* arg2) {
+	_TCHAR* arg = (_TCHAR*)malloc((_tcslen(arg1) + _tcslen(arg2) + 2) * sizeof(_TCHAR));
+	_stprintf(arg, _T_ECLIPSE("%s %s"), arg1, arg2);
+	return arg;
+}
+
+static void resolveLaunchConfig(LaunchConfig* config) {
+	int commandLineVM = 0;
+	int i, j;
+
+	for (i = 0; i < config->count; i++) {
+		if (config->settings[i].kind == CONFIG_VM_OPTION && config->settings[i].source == CONFIG_COMMAND_LINE)
+			commandLineVM = 1;
+	}
+	for (i = 0; i < config->count; i++) {
+		ConfigSetting* setting = &config->settings[i];
+		setting->overriddenBy = CONFIG_EFFECTIVE;
+		if (commandLineVM && !config->appendVmargs && setting->kind == CONFIG_VM_OPTION && setting->source < CONFIG_COMMAND_LINE)
+			setting->overriddenBy = CONFIG_REPLACED;
+	}
+	/* the last setting of a name is the one used */
+	for (i = 0; i < config->count; i++) {
+		ConfigSetting* setting = &config->settings[i];
+		if (setting->overriddenBy != CONFIG_EFFECTIVE || setting->repeatable)
+			continue;
+		for (j = config->count - 1; j > i; j--) {
+			ConfigSetting* later = &config->settings[j];
+			if (later->overriddenBy != CONFIG_REPLACED && later->kind == setting->kind && _tcscmp(later->name, setting->name) == 0) {
+				setting->overriddenBy = j;
+				break;
+			}
+		}
+	}
+}
+
+LaunchConfig* newLaunchConfig(int appendVmargs) {
+	LaunchConfig* config = (LaunchConfig*)malloc(sizeof(LaunchConfig));
+	memset(config, 0, sizeof(LaunchConfig));
+	config->appendVmargs = appendVmargs;
+	return config;
+}
+
+void freeLaunchConfig(LaunchConfig* config) {
+	int i;
+	if (config == NULL)
+		return;
+	for (i = 0; i < config->count; i++) {
+		free(config->settings[i].file);
+		free(config->settings[i].name);
+		free(config->settings[i].value);
+		free(config->settings[i].arg);
+	}
+	free(config->settings);
+	free(config);
+}
+
+void addConfigArgs(LaunchConfig* config, int source, const _TCHAR* file, _TCHAR* args[]) {
+	int vm = source == CONFIG_EE_FILE;
+	_TCHAR* name;
+	_TCHAR* value;
+	_TCHAR* arg;
+	int i, position;
+
+	if (args == NULL)
+		return;
+
+	for (i = 0; args[i] != NULL; i++) {
+		position = i;
+		if (!vm && _tcsicmp(args[i], CONFIG_VMARGS) == 0) {
+			vm = 1;
+			continue;
+		}
+
+		if (vm) {
+			int kind = (source == CONFIG_EE_FILE && startsWith(args[i], CONFIG_EE_PREFIX)) ? CONFIG_EE_PROPERTY : CONFIG_VM_OPTION;
+			splitVMOption(args[i], &name, &value);
+			if (value == NULL && isListed(name, separateValueVMOptions) && args[i + 1] != NULL && args[i + 1][0] != _T_ECLIPSE('-')) {
+				value = _tcsdup(args[i + 1]);
+				arg = joinArgs(args[i], args[i + 1]);
+				i++;
+			}
+			else {
+				arg = _tcsdup(args[i]);
+			}
+			addSetting(config, kind, source, file, position, name, value, arg, isListed(name, repeatableVMOptions));
+		}
+		else if (args[i][0] != _T_ECLIPSE('-')) {
+			/* an argument without an option, like a file to open */
+			addSetting(config, CONFIG_PROGRAM_OPTION, source, file, position, _tcsdup(args[i]), NULL, _tcsdup(args[i]), 1);
+		}
+		else {
+			value = NULL;
+			if (args[i + 1] != NULL && args[i + 1][0] != _T_ECLIPSE('-') && _tcsicmp(args[i + 1], CONFIG_VMARGS) != 0) {
+				value = _tcsdup(args[i + 1]);
+				arg = joinArgs(args[i], args[i + 1]);
+				i++;
+			}
+			else {
+				arg = _tcsdup(args[i]);
+			}
+			addSetting(config, CONFIG_PROGRAM_OPTION, source, file, position, _tcsdup(args[position]), value, arg, 0);
+		}
+	}
+	resolveLaunchConfig(config);
+}
+
+int findConfigSetting(LaunchConfig* config, int kind, const _TCHAR* name) {
+	int i;
+	for (i = config->count - 1; i >= 0; i--) {
+		ConfigSetting* setting = &config->settings[i];
+		if (setting->overriddenBy == CONFIG_EFFECTIVE && setting->kind == kind && _tcscmp(setting->name, name) == 0)
+			return i;
+	}
+	return -1;
+}
+
+static void appendSource(ConfigText* text, ConfigSetting* setting) {
+	appendText(text, sourceNames[setting->source]);
+	if (setting->file != NULL) {
+		appendText(text, _T_ECLIPSE(" "));
+		appendText(text, setting->file);
+	}
+	appendText(text, _T_ECLIPSE(", argument "));
+	appendNumber(text, setting->position + 1);
+}
+
+static void addProblem(ConfigProblem** problems, int* count, int error, int setting, int other, ConfigText* message) {
+	ConfigProblem* problem;
+
+	*problems = (ConfigProblem*)realloc(*problems, (*count + 1) * sizeof(ConfigProblem));
+	problem = &(*problems)[(*count)++];
+	problem->error = error;
+	problem->setting = setting;
+	problem->other = other;
+	problem->message = takeText(message);
+}
+
+/* a -Xmx like size in bytes, -1 if it can not be read */
+static double parseSize(const _TCHAR* value) {
+	double size = 0;
+	const _TCHAR* ch = value;
+
+	if (value == NULL || *ch < _T_ECLIPSE('0') || *ch > _T_ECLIPSE('9'))
+		return -1;
+	while (*ch >= _T_ECLIPSE('0') && *ch <= _T_ECLIPSE('9'))
+		size = size * 10 + (*ch++ - _T_ECLIPSE('0'));
+	switch (*ch) {
+	case _T_ECLIPSE('t'): case _T_ECLIPSE('T'): size *= 1024;
+	case _T_ECLIPSE('g'): case _T_ECLIPSE('G'): size *= 1024;
+	case _T_ECLIPSE('m'): case _T_ECLIPSE('M'): size *= 1024;
+	case _T_ECLIPSE('k'): case _T_ECLIPSE('K'): size *= 1024; ch++;
+	}
+	return *ch == 0 ? size : -1;
+}
+
+int validateLaunchConfig(LaunchConfig* config, ConfigProblem** problems) {
+	int count = 0;
+	int i, j, xms, xmx, share, archive, collector = -1;
+
+	*problems = NULL;
+	for (i = 0; i < config->count; i++) {
+		ConfigSetting* setting = &config->settings[i];
+		ConfigSetting* other;
+		ConfigText message = { NULL, 0, 0 };
+
+		/* layers overriding each other is what they are for, one file setting something twice is not */
+		j = setting->overriddenBy;
+		if (j < 0 && setting->repeatable) {
+			for (j = i + 1; j < config->count; j++) {
+				if (config->settings[j].kind == setting->kind && _tcscmp(config->settings[j].arg, setting->arg) == 0)
+					break;
+			}
+			if (j == config->count)
+				j = -1;
+		}
+		if (j < 0)
+			continue;
+		other = &config->settings[j];
+		if (other->source != setting->source || !sameString(other->file, setting->file))
+			continue;
+
+		appendText(&message, setting->name);
+		if (sameString(setting->value, other->value)) {
+			appendText(&message, _T_ECLIPSE(" is set twice in the "));
+			appendText(&message, sourceNames[setting->source]);
+			addProblem(problems, &count, 0, i, j, &message);
+		}
+		else {
+			appendText(&message, _T_ECLIPSE(" is set to "));
+			appendText(&message, setting->arg);
+			appendText(&message, _T_ECLIPSE(" and "));
+			appendText(&message, other->arg);
+			appendText(&message, _T_ECLIPSE(" in the "));
+			appendText(&message, sourceNames[setting->source]);
+			appendText(&message, _T_ECLIPSE(", the second one is used"));
+			addProblem(problems, &count, 1, i, j, &message);
+		}
+	}
+
+	xms = findConfigSetting(config, CONFIG_VM_OPTION, _T_ECLIPSE("-Xms"));
+	xmx = findConfigSetting(config, CONFIG_VM_OPTION, _T_ECLIPSE("-Xmx"));
+	if (xms >= 0 && xmx >= 0 && parseSize(config->settings[xms].value) > parseSize(config->settings[xmx].value)
+		&& parseSize(config->settings[xmx].value) >= 0) {
+		ConfigText message = { NULL, 0, 0 };
+		appendText(&message, config->settings[xms].arg);
+		appendText(&message, _T_ECLIPSE(" is more than "));
+		appendText(&message, config->settings[xmx].arg);
+		appendText(&message, _T_ECLIPSE(", the VM will not start"));
+		addProblem(problems, &count, 1, xms, xmx, &message);
+	}
+
+	for (i = 0; collectors[i] != NULL; i++) {
+		j = findConfigSetting(config, CONFIG_VM_OPTION, collectors[i]);
+		if (j < 0 || !sameString(config->settings[j].value, _T_ECLIPSE("+")))
+			continue;
+		if (collector >= 0) {
+			ConfigText message = { NULL, 0, 0 };
+			appendText(&message, config->settings[collector].arg);
+			appendText(&message, _T_ECLIPSE(" and "));
+			appendText(&message, config->settings[j].arg);
+			appendText(&message, _T_ECLIPSE(" select two garbage collectors"));
+			addProblem(problems, &count, 1, collector, j, &message);
+		}
+		else {
+			collector = j;
+		}
+	}
+
+	share = findConfigSetting(config, CONFIG_VM_OPTION, _T_ECLIPSE("-Xshare"));
+	archive = findConfigSetting(config, CONFIG_VM_OPTION, _T_ECLIPSE("-XX:SharedArchiveFile"));
+	if (share >= 0 && archive >= 0 && sameString(config->settings[share].value, _T_ECLIPSE("off"))) {
+		ConfigText message = { NULL, 0, 0 };
+		appendText(&message, config->settings[archive].arg);
+		appendText(&message, _T_ECLIPSE(" is not used with -Xshare:off"));
+		addProblem(problems, &count, 1, archive, share, &message);
+	}
+	return count;
+}
+
+void freeConfigProblems(ConfigProblem* problems, int count) {
+	int i;
+	if (problems == NULL)
+		return;
+	for (i = 0; i < count; i++)
+		free(problems[i].message);
+	free(problems);
+}
+
+static void explainSetting(ConfigText* text, LaunchConfig* config, int kind, const _TCHAR* name) {
+	int i;
+
+	appendText(text, name);
+	appendText(text, _T_ECLIPSE(" ("));
+	appendText(text, kindNames[kind]);
+	appendText(text, _T_ECLIPSE(")\n"));
+	for (i = 0; i < config->count; i++) {
+		ConfigSetting* setting = &config->settings[i];
+		if (setting->kind != kind || _tcscmp(setting->name, name) != 0)
+			continue;
+
+		if (setting->overriddenBy == CONFIG_REPLACED)
+			appendText(text, _T_ECLIPSE("  replaced    "));
+		else if (setting->overriddenBy >= 0)
+			appendText(text, _T_ECLIPSE("  overridden  "));
+		else if (setting->repeatable)
+			appendText(text, _T_ECLIPSE("  added       "));
+		else
+			appendText(text, _T_ECLIPSE("  used        "));
+		appendText(text, setting->arg);
+		appendText(text, _T_ECLIPSE("  ("));
+		appendSource(text, setting);
+		if (setting->overriddenBy == CONFIG_REPLACED)
+			appendText(text, _T_ECLIPSE(", replaced by the command line -vmargs"));
+		appendText(text, _T_ECLIPSE(")\n"));
+	}
+}
+
+_TCHAR* explainLaunchConfig(LaunchConfig* config, const _TCHAR* name) {
+	ConfigText text = { NULL, 0, 0 };
+	_TCHAR* vmName = NULL;
+	_TCHAR* vmValue = NULL;
+	int i, j, found = 0;
+
+	if (name != NULL)
+		splitVMOption(name, &vmName, &vmValue);
+
+	for (i = 0; i < config->count; i++) {
+		ConfigSetting* setting = &config->settings[i];
+
+		if (name != NULL && _tcscmp(setting->name, name) != 0 && _tcscmp(setting->name, vmName) != 0)
+			continue;
+		/* once per setting, where it first shows up */
+		for (j = 0; j < i; j++) {
+			if (config->settings[j].kind == setting->kind && _tcscmp(config->settings[j].name, setting->name) == 0)
+				break;
+		}
+		if (j < i)
+			continue;
+		explainSetting(&text, config, setting->kind, setting->name);
+		found = 1;
+	}
+	if (name != NULL && !found) {
+		appendText(&text, name);
+		appendText(&text, _T_ECLIPSE(" is not set\n"));
+	}
+	free(vmName);
+	free(vmValue);
+	return takeText(&text);
+}
+
+/* Index of the setting in config that is used like setting is in the other configuration, or -1 */
+static int findCounterpart(LaunchConfig* config, ConfigSetting* setting) {
+	int i;
+	if (!setting->repeatable)
+		return findConfigSetting(config, setting->kind, setting->name);
+	for (i = 0; i < config->count; i++) {
+		ConfigSetting* other = &config->settings[i];
+		if (other->overriddenBy == CONFIG_EFFECTIVE && other->kind == setting->kind && _tcscmp(other->arg, setting->arg) == 0)
+			return i;
+	}
+	return -1;
+}
+
+static void appendChange(ConfigText* text, const _TCHAR* mark, ConfigSetting* setting) {
+	appendText(text, mark);
+	appendText(text, setting->arg);
+	appendText(text, _T_ECLIPSE("  ("));
+	appendSource(text, setting);
+	appendText(text, _T_ECLIPSE(")\n"));
+}
+
+_TCHAR* diffLaunchConfigs(LaunchConfig* before, LaunchConfig* after) {
+	ConfigText text = { NULL, 0, 0 };
+	int i, j;
+
+	for (i = 0; i < after->count; i++) {
+		ConfigSetting* setting = &after->settings[i];
+		if (setting->overriddenBy != CONFIG_EFFECTIVE)
+			continue;
+		j = findCounterpart(before, setting);
+		if (j < 0) {
+			appendChange(&text, _T_ECLIPSE("+ "), setting);
+		}
+		else if (!sameString(before->settings[j].value, setting->value)) {
+			appendChange(&text, _T_ECLIPSE("- "), &before->settings[j]);
+			appendChange(&text, _T_ECLIPSE("+ "), setting);
+		}
+	}
+	for (i = 0; i < before->count; i++) {
+		ConfigSetting* setting = &before->settings[i];
+		if (setting->overriddenBy == CONFIG_EFFECTIVE && findCounterpart(after, setting) < 0)
+			appendChange(&text, _T_ECLIPSE("- "), setting);
+	}
+	return takeText(&text);
+}
+
+/* fields are separated by tabs and settings by new lines, which are not kept in them */
+static void writeField(FILE* file, const _TCHAR* str) {
+	const _TCHAR* ch;
+	_fputtc(_T_ECLIPSE('\t'), file);
+	if (str == NULL)
+		return;
+	for (ch = str; *ch != 0; ch++)
+		_fputtc((*ch == _T_ECLIPSE('\t') || *ch == _T_ECLIPSE('\n') || *ch == _T_ECLIPSE('\r')) ? _T_ECLIPSE(' ') : *ch, file);
+}
+
+int saveLaunchConfig(LaunchConfig* config, const _TCHAR* file) {
+	FILE* out = _tfopen(file, _T_ECLIPSE("wt"));
+	int i, failed;
+
+	if (out == NULL)
+		return -1;
+	_ftprintf(out, _T_ECLIPSE("%s\t%d\t%d\n"), CONFIG_FORMAT, CONFIG_VERSION, config->appendVmargs);
+	for (i = 0; i < config->count; i++) {
+		ConfigSetting* setting = &config->settings[i];
+		_ftprintf(out, _T_ECLIPSE("%d\t%d\t%d\t%d\t%d"), setting->kind, setting->source, setting->position,
+			setting->repeatable, setting->value != NULL);
+		writeField(out, setting->file);
+		writeField(out, setting->name);
+		writeField(out, setting->value);
+		writeField(out, setting->arg);
+		_fputtc(_T_ECLIPSE('\n'), out);
+	}
+	failed = ferror(out);
+	if (fclose(out) != 0)
+		failed = 1;
+	return failed ? -1 : 0;
+}
+
+LaunchConfig* loadLaunchConfig(const _TCHAR* file) {
+	FILE* in = _tfopen(file, _T_ECLIPSE("rt"));
+	LaunchConfig* config = NULL;
+	_TCHAR* line;
+	_TCHAR* fields[CONFIG_FIELDS];
+	size_t lineSize = 1024;
+	size_t length;
+	int count;
+
+	if (in == NULL)
+		return NULL;
+	line = (_TCHAR*)malloc(lineSize * sizeof(_TCHAR));
+
+	while (_fgetts(line, (int)lineSize, in) != NULL) {
+		/* read the rest of a line longer than the buffer */
+		length = _tcslen(line);
+		while (length == lineSize - 1 && line[length - 1] != _T_ECLIPSE('\n')) {
+			lineSize *= 2;
+			line = (_TCHAR*)realloc(line, lineSize * sizeof(_TCHAR));
+			if (_fgetts(line + length, (int)(lineSize - length), in) == NULL)
+				break;
+			length += _tcslen(line + length);
+		}
+		if (length > 0 && line[length - 1] == _T_ECLIPSE('\n'))
+			line[--length] = 0;
+
+		fields[0] = line;
+		for (count = 1; count < CONFIG_FIELDS; count++) {
+			_TCHAR* tab = _tcschr(fields[count - 1], _T_ECLIPSE('\t'));
+			if (tab == NULL)
+				break;
+			*tab = 0;
+			fields[count] = tab + 1;
+		}
+
+		if (config == NULL) {
+			if (count < 3 || _tcscmp(fields[0], CONFIG_FORMAT) != 0 || _tcstol(fields[1], NULL, 10) != CONFIG_VERSION)
+				break;
+			config = newLaunchConfig((int)_tcstol(fields[2], NULL, 10));
+			continue;
+		}
+		if (count != CONFIG_FIELDS)
+			continue;
+		{
+			int kind = (int)_tcstol(fields[0], NULL, 10);
+			int source = (int)_tcstol(fields[1], NULL, 10);
+			if (kind < CONFIG_PROGRAM_OPTION || kind > CONFIG_EE_PROPERTY || source < CONFIG_LAUNCHER_INI || source > CONFIG_EE_FILE)
+				continue;
+			addSetting(config, kind, source, fields[5][0] != 0 ? fields[5] : NULL, (int)_tcstol(fields[2], NULL, 10),
+				_tcsdup(fields[6]), _tcstol(fields[4], NULL, 10) ? _tcsdup(fields[7]) : NULL, _tcsdup(fields[8]),
+				(int)_tcstol(fields[3], NULL, 10));
+		}
+	}
+	fclose(in);
+	free(line);
+	if (config != NULL)
+		resolveLaunchConfig(config);
+	return config;
+}
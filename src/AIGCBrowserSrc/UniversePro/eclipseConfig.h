@@ -83,4 +83,117 @@ extern int readConfigFile( _TCHAR * config_file, int *argc, _TCHAR ***argv );
  */
 extern void freeConfig(_TCHAR **args);
 
+/* Launch configuration model
+ *
+ * The arguments of the launcher ini files, the command line and the .ee
+ * file as settings that know where they come from. Settings are added in
+ * the order the launcher applies them; a later setting with the same name
+ * overrides an earlier one, except for repeatable ones (--add-opens,
+ * -javaagent, ...) that add up. VM options on the command line replace
+ * those of the ini files unless --launcher.appendVmargs is given.
+ */
+
+/* sources, in the order the launcher applies them */
+#define CONFIG_LAUNCHER_INI		0	/* the ini next to the launcher, or --launcher.ini */
+#define CONFIG_CONFIG_INI		1	/* the launcher ini in the configuration area */
+#define CONFIG_COMMAND_LINE		2
+#define CONFIG_EE_FILE			3	/* the .ee file given with -vm */
+
+/* kinds of settings */
+#define CONFIG_PROGRAM_OPTION	0
+#define CONFIG_VM_OPTION		1
+#define CONFIG_EE_PROPERTY		2	/* -Dee.* of the .ee file */
+
+/* overriddenBy of a setting that is not overridden by another one */
+#define CONFIG_EFFECTIVE		-1
+#define CONFIG_REPLACED			-2	/* ini VM options replaced by the command line -vmargs */
+
+typedef struct {
+	int			kind;
+	int			source;
+	_TCHAR*		file;			/* the file it was read from, NULL for the command line */
+	int			position;		/* index of its first argument in the file or command line */
+	_TCHAR*		name;			/* what identifies it: -Xmx, -Dosgi.instance.area, -XX:UseG1GC, -data */
+	_TCHAR*		value;			/* NULL if it has none */
+	_TCHAR*		arg;			/* the argument as given, the value is separate for "-data <path>" */
+	int			repeatable;
+	int			overriddenBy;	/* index of the setting used instead, or CONFIG_EFFECTIVE, CONFIG_REPLACED */
+} ConfigSetting;
+
+typedef struct {
+	int				count;
+	int				capacity;
+	ConfigSetting*	settings;
+	int				appendVmargs;
+} LaunchConfig;
+
+typedef struct {
+	int			error;		/* 1 for settings that conflict, 0 for redundant ones */
+	int			setting;
+	int			other;		/* the setting it conflicts with, or -1 */
+	_TCHAR*		message;
+} ConfigProblem;
+
+/**
+ * Creates an empty configuration. appendVmargs tells whether the command
+ * line VM options are appended to those of the ini files.
+ * Free it with freeLaunchConfig().
+ */
+extern LaunchConfig* newLaunchConfig(int appendVmargs);
+
+extern void freeLaunchConfig(LaunchConfig* config);
+
+/**
+ * Adds the NULL terminated args of a source, read from file (NULL for
+ * the command line). Arguments after -vmargs are VM options; in the .ee
+ * file every argument is, the -Dee.* ones are EE properties. The args
+ * are copied and the overrides resolved again.
+ */
+extern void addConfigArgs(LaunchConfig* config, int source, const _TCHAR* file, _TCHAR* args[]);
+
+/**
+ * Returns the index of the setting of the given kind and name that is
+ * used, or -1. For a repeatable setting that is the last one.
+ */
+extern int findConfigSetting(LaunchConfig* config, int kind, const _TCHAR* name);
+
+/**
+ * Looks for settings that conflict or repeat each other: the same
+ * setting twice in one file, -Xms above -Xmx, two garbage collectors,
+ * class data sharing turned off for an archive. The problems are stored
+ * in problems, to be freed with freeConfigProblems().
+ *
+ * Returns the number of problems.
+ */
+extern int validateLaunchConfig(LaunchConfig* config, ConfigProblem** problems);
+
+extern void freeConfigProblems(ConfigProblem* problems, int count);
+
+/**
+ * Explains why a setting has the value it has: every place it is set,
+ * in order, and which one is used. With a NULL name all settings are
+ * explained. The text is to be freed with free().
+ */
+extern _TCHAR* explainLaunchConfig(LaunchConfig* config, const _TCHAR* name);
+
+/**
+ * Lists the settings used by after that before did not use, or used with
+ * another value, and those it no longer uses, with where they come from.
+ * The text is empty if both are the same and is to be freed with free().
+ */
+extern _TCHAR* diffLaunchConfigs(LaunchConfig* before, LaunchConfig* after);
+
+/**
+ * Stores config in file, to compare a later launch with.
+ *
+ * Returns 0 if success.
+ */
+extern int saveLaunchConfig(LaunchConfig* config, const _TCHAR* file);
+
+/**
+ * Loads a configuration stored with saveLaunchConfig(), NULL if there
+ * is none. Free it with freeLaunchConfig().
+ */
+extern LaunchConfig* loadLaunchConfig(const _TCHAR* file);
+
 #endif /* ECLIPSE_CONFIG_H */
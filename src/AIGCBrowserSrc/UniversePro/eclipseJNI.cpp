@@ -39,11 +39,15 @@
 #include "eclipseCommon.h"
 #include "eclipseOS.h"
 #include "eclipseShm.h"
+#include "eclipseProfile.h"
+#include "eclipseRing.h"
+#include "eclipseCds.h"
 #include "WinNucleus.h"
 
 #include <shlobj.h>
 #include <stdlib.h>
 #include <string.h>
+#include <mutex>
 
 
 static _TCHAR* failedToLoadLibrary = (_TCHAR *)_T_ECLIPSE("Failed to load the JNI shared library \"%s\".\n");
@@ -73,8 +77,20 @@ static jmethodID string_getBytesMethod = NULL;
 static jmethodID string_ctor = NULL;
 #endif
 
+/* ring transport, see eclipseRing.h */
+static EclipseRing* ring = NULL;
+static jobject ringBuffer = NULL;			/* global ref to the direct ByteBuffer over the ring */
+static jclass ringClass = NULL;				/* global ref to the class with ringReady() */
+static jmethodID ringReadyMethod = NULL;
+static std::mutex ringLock;					/* Java threads open and drain the ring one at a time */
+static unsigned char* pendingReply = NULL;	/* the rest of a reply that did not fit in the ring yet */
+static unsigned int pendingReplyLength = 0;
+static unsigned int pendingReplySent = 0;
+static unsigned long long pendingReplyId = 0;
+
 /* JNI Callback methods */
 void set_exit_data(JNIEnv * env, jobject obj, jstring id, jstring s) {
+	JNIProfileScope profile(JNI_PROFILE_SET_EXIT_DATA);
 	const _TCHAR* data = NULL;
 	const _TCHAR* sharedId = NULL;
 	size_t length;
@@ -107,6 +123,7 @@ void set_exit_data(JNIEnv * env, jobject obj, jstring id, jstring s) {
 }
 
 jstring tangram_extend(JNIEnv * env, jobject obj, jstring key, jstring data, jstring features) {
+	JNIProfileScope profile(JNI_PROFILE_TANGRAM_EXTEND);
 	const _TCHAR* _key = NULL;
 	const _TCHAR* _data = NULL;
 	const _TCHAR* _features = NULL;
@@ -143,6 +160,7 @@ jstring tangram_extend(JNIEnv * env, jobject obj, jstring key, jstring data, jst
 }
 
 void set_launcher_info(JNIEnv * env, jobject obj, jstring launcher, jstring name) {
+	JNIProfileScope profile(JNI_PROFILE_SET_LAUNCHER_INFO);
 	const _TCHAR* launcherPath = NULL;
 	const _TCHAR* launcherName = NULL;
 
@@ -164,14 +182,17 @@ void set_launcher_info(JNIEnv * env, jobject obj, jstring launcher, jstring name
 }
 
 void update_splash(JNIEnv * env, jobject obj) {
+	JNIProfileScope profile(JNI_PROFILE_UPDATE_SPLASH);
 	dispatchMessages();
 }
 
 jlong get_splash_handle(JNIEnv * env, jobject obj) {
+	JNIProfileScope profile(JNI_PROFILE_GET_SPLASH_HANDLE);
 	return getSplashHandle();
 }
 
 void show_splash(JNIEnv * env, jobject obj, jstring s) {
+	JNIProfileScope profile(JNI_PROFILE_SHOW_SPLASH);
 	const _TCHAR* data = NULL;
 
 	//setLibraryLocation(env, obj);
@@ -190,10 +211,12 @@ void show_splash(JNIEnv * env, jobject obj, jstring s) {
 }
 
 void  takedown_splash(JNIEnv * env, jobject obj) {
+	JNIProfileScope profile(JNI_PROFILE_TAKEDOWN_SPLASH);
 	takeDownSplash();
 }
 
 jstring get_os_recommended_folder(JNIEnv * env, jobject obj) {
+	JNIProfileScope profile(JNI_PROFILE_GET_OS_RECOMMENDED_FOLDER);
 #ifdef MACOSX
 	return newJavaString(env, getFolderForApplicationData());
 #else
@@ -201,6 +224,185 @@ jstring get_os_recommended_folder(JNIEnv * env, jobject obj) {
 #endif
 }
 
+jstring get_jni_profile(JNIEnv * env, jclass clazz) {
+	jstring result = NULL;
+	_TCHAR* snapshot = getJNIProfileSnapshot();
+
+	if (snapshot != NULL) {
+		result = newJavaString(env, snapshot);
+		free(snapshot);
+	}
+	return result;
+}
+
+/* Wake up Java when a send found its ring empty */
+static void ringJava(JNIEnv * env) {
+	if (ringReadyMethod == NULL)
+		return;
+	env->CallStaticVoidMethod(ringClass, ringReadyMethod);
+	if (env->ExceptionOccurred() != 0) {
+		env->ExceptionDescribe();
+		env->ExceptionClear();
+	}
+	countRing(ring, RING_STAT_JAVA_DOORBELLS, 1);
+}
+
+/* Sends a reply from *sent on, in pieces when it is longer than a frame can be.
+ * Returns -1 if the ring filled up before the last piece, *sent tells how far it got. */
+static int sendReply(JNIEnv * env, unsigned long long id, const unsigned char* reply, unsigned int length, unsigned int* sent) {
+	unsigned int maxPiece = getRingMaxPayload(ring);
+	unsigned int piece, type;
+	int result, wake = 0;
+
+	do {
+		piece = length - *sent;
+		type = RING_MESSAGE_EXTEND_REPLY;
+		if (piece > maxPiece) {
+			piece = maxPiece;
+			type = RING_MESSAGE_EXTEND_REPLY_PART;
+		}
+		result = sendRing(ring, type, id, reply + *sent, piece);
+		if (result < 0)
+			break;
+		wake |= result;
+		*sent += piece;
+	} while (*sent < length);
+	if (wake)
+		ringJava(env);
+	return result < 0 ? -1 : 0;
+}
+
+/* Sends the reply left over by an earlier drain, returns 0 once there is none */
+static int flushPendingReply(JNIEnv * env) {
+	if (pendingReply == NULL)
+		return 0;
+	if (sendReply(env, pendingReplyId, pendingReply, pendingReplyLength, &pendingReplySent) != 0)
+		return -1;
+	free(pendingReply);
+	pendingReply = NULL;
+	return 0;
+}
+
+/* Next null terminated string of an extend message, NULL past the payload */
+static const _TCHAR* nextRingString(const _TCHAR** next, const _TCHAR* end) {
+	const _TCHAR* string = *next;
+	const _TCHAR* chars;
+
+	for (chars = string; chars < end; chars++) {
+		if (*chars == _T_ECLIPSE('\0')) {
+			*next = chars + 1;
+			return string;
+		}
+	}
+	return NULL;
+}
+
+static void handleRingFrame(void* context, unsigned int type, unsigned long long id, const void* payload, unsigned int length) {
+	JNIEnv * env = (JNIEnv *)context;
+	const _TCHAR* next = (const _TCHAR*)payload;
+	const _TCHAR* end = next + length / sizeof(_TCHAR);
+	const _TCHAR* key;
+	const _TCHAR* data;
+	const _TCHAR* features;
+	CString strRet = _T("");
+	unsigned int replyLength, sent = 0;
+
+	/* replies go out in order, a message waits until the one before it is answered */
+	if (flushPendingReply(env) != 0) {
+		stopRing(ring);
+		return;
+	}
+	countJNIProfileBytes(JNI_PROFILE_RING_DOORBELL, length);
+	if (type != RING_MESSAGE_EXTEND)
+		return;
+
+	key = nextRingString(&next, end);
+	data = key != NULL ? nextRingString(&next, end) : NULL;
+	features = data != NULL ? nextRingString(&next, end) : NULL;
+	if (features != NULL && g_pSpaceTelescope)
+		strRet = g_pSpaceTelescope->tangram_for_eclipse(CString(key), CString(data), CString(features));
+
+	/* every piece fits once Java emptied its ring, so what is left always goes out later */
+	replyLength = strRet.GetLength() * sizeof(_TCHAR);
+	if (sendReply(env, id, (const unsigned char*)(LPCTSTR)strRet, replyLength, &sent) != 0) {
+		pendingReply = (unsigned char*)malloc(replyLength - sent > 0 ? replyLength - sent : 1);
+		if (pendingReply != NULL) {
+			memcpy(pendingReply, (const unsigned char*)(LPCTSTR)strRet + sent, replyLength - sent);
+			pendingReplyLength = replyLength - sent;
+			pendingReplySent = 0;
+			pendingReplyId = id;
+		}
+	}
+}
+
+jobject ring_open(JNIEnv * env, jclass clazz, jint capacity) {
+	std::lock_guard<std::mutex> lock(ringLock);
+	size_t size;
+	void* memory;
+	jobject buffer;
+
+	if (ring == NULL) {
+		if (capacity < 0)
+			return NULL;
+		ring = createRing((size_t)capacity);
+		if (ring == NULL)
+			return NULL;
+
+		memory = getRingMemory(ring, &size);
+		buffer = env->NewDirectByteBuffer(memory, (jlong)size);
+		if (buffer == NULL) {
+			env->ExceptionClear();
+			destroyRing(ring);
+			ring = NULL;
+			return NULL;
+		}
+		ringBuffer = env->NewGlobalRef(buffer);
+		env->DeleteLocalRef(buffer);
+
+		/* without ringReady() Java polls its ring */
+		ringClass = (jclass)env->NewGlobalRef(clazz);
+		ringReadyMethod = env->GetStaticMethodID(clazz, "ringReady", "()V");
+		if (ringReadyMethod == NULL)
+			env->ExceptionClear();
+	}
+	return env->NewLocalRef(ringBuffer);
+}
+
+/* Returns the frames handled, -1 if replies wait for room in Java's ring.
+ * A thread that rings while another drains waits for it and then drains what came after. */
+jint ring_doorbell(JNIEnv * env, jclass clazz) {
+	JNIProfileScope profile(JNI_PROFILE_RING_DOORBELL);
+	std::lock_guard<std::mutex> lock(ringLock);
+	int count;
+
+	if (ring == NULL)
+		return 0;
+	count = drainRing(ring, handleRingFrame, env);
+	if (flushPendingReply(env) != 0)
+		return -1;
+	return count;
+}
+
+int postToJava(unsigned int type, unsigned long long id, const void* payload, unsigned int length) {
+	JNIEnv * localEnv = NULL;
+	int sent, attached = 0;
+
+	if (ring == NULL || jvm == 0)
+		return -1;
+	sent = sendRing(ring, type, id, payload, length);
+	if (sent > 0) {
+		if (jvm->GetEnv((void**)&localEnv, JNI_VERSION_1_2) == JNI_EDETACHED) {
+			if (jvm->AttachCurrentThreadAsDaemon((void**)&localEnv, NULL) != JNI_OK)
+				return 0;
+			attached = 1;
+		}
+		ringJava(localEnv);
+		if (attached)
+			jvm->DetachCurrentThread();
+	}
+	return sent < 0 ? -1 : 0;
+}
+
 //static JNINativeMethod natives[] = 
 //{
 //	{ "_update_splash", "()V", (void *)&update_splash },
@@ -219,6 +421,8 @@ jstring get_os_recommended_folder(JNIEnv * env, jobject obj) {
  */
 
 void registerNatives(JNIEnv *env) {
+	JNIProfileScope profile(JNI_PROFILE_REGISTER_NATIVES);
+
 	/*begin Add by Tangram Team*/
 	if (g_pSpaceTelescope)
 	{
@@ -281,12 +485,36 @@ void registerNatives(JNIEnv *env) {
 		env->ExceptionClear();
 	}
 
+	/* separate, so that a TangramJava without _profile still gets _extend */
+	if (tangramClass != NULL) {
+		JNINativeMethod natives[] =
+		{
+			{ (char*)"_profile", (char*)"()Ljava/lang/String;", (void *)&get_jni_profile }
+		};
+
+		env->RegisterNatives(tangramClass, natives, sizeof(natives) / sizeof(natives[0]));
+		if (env->ExceptionOccurred() != 0)
+			env->ExceptionClear();
+	}
+	if (tangramClass != NULL) {
+		JNINativeMethod natives[] =
+		{
+			{ (char*)"_ring_open", (char*)"(I)Ljava/nio/ByteBuffer;", (void *)&ring_open },
+			{ (char*)"_ring_doorbell", (char*)"()I", (void *)&ring_doorbell }
+		};
+
+		env->RegisterNatives(tangramClass, natives, sizeof(natives) / sizeof(natives[0]));
+		if (env->ExceptionOccurred() != 0)
+			env->ExceptionClear();
+	}
+
 	g_pSpaceTelescope->InitJNIForTangram();
 }
 
 
 /* Get a _TCHAR* from a jstring, string should be released later with JNI_ReleaseStringChars */
 static const _TCHAR * JNI_GetStringChars(JNIEnv *env, jstring str) {
+	JNIProfileScope profile(JNI_PROFILE_GET_STRING_CHARS);
 	const _TCHAR * result = NULL;
 #ifdef UNICODE
 	/* GetStringChars is not null terminated, make a copy */
@@ -325,6 +553,8 @@ static const _TCHAR * JNI_GetStringChars(JNIEnv *env, jstring str) {
 	}
 	result = buffer;
 #endif
+	if (jniProfiling && result != NULL)
+		countJNIProfileBytes(JNI_PROFILE_GET_STRING_CHARS, _tcslen(result) * sizeof(_TCHAR));
 	return result;
 }
 
@@ -341,7 +571,11 @@ static void JNI_ReleaseStringChars(JNIEnv *env, jstring s, const _TCHAR* data) {
 
 static jstring newJavaString(JNIEnv *env, _TCHAR * str)
 {
+	JNIProfileScope profile(JNI_PROFILE_NEW_JAVA_STRING);
 	jstring newString = NULL;
+
+	if (jniProfiling && str != NULL)
+		countJNIProfileBytes(JNI_PROFILE_NEW_JAVA_STRING, _tcslen(str) * sizeof(_TCHAR));
 #ifdef UNICODE
 	size_t length = _tcslen(str);
 	newString = env->NewString((const jchar*)str, length);
@@ -408,6 +642,35 @@ static jobjectArray createRunArgs(JNIEnv *env, _TCHAR * args[]) {
 	return stringArray;
 }
 
+/* Get a system property of the VM as a narrow string to be freed with free(), or NULL */
+static char* getSystemProperty(JNIEnv *env, const char* name) {
+	char* result = NULL;
+	jclass systemClass = env->FindClass("java/lang/System");
+	if (systemClass != NULL) {
+		jmethodID getProperty = env->GetStaticMethodID(systemClass, "getProperty", "(Ljava/lang/String;)Ljava/lang/String;");
+		jstring key = env->NewStringUTF(name);
+		if (getProperty != NULL && key != NULL) {
+			jstring value = (jstring)env->CallStaticObjectMethod(systemClass, getProperty, key);
+			if (value != NULL) {
+				const char* chars = env->GetStringUTFChars(value, NULL);
+				if (chars != NULL) {
+					result = _strdup(chars);
+					env->ReleaseStringUTFChars(value, chars);
+				}
+				env->DeleteLocalRef(value);
+			}
+		}
+		if (key != NULL)
+			env->DeleteLocalRef(key);
+		env->DeleteLocalRef(systemClass);
+	}
+	if (env->ExceptionOccurred()) {
+		env->ExceptionDescribe();
+		env->ExceptionClear();
+	}
+	return result;
+}
+
 JavaResults * startJavaJNI(_TCHAR* libPath, _TCHAR* vmArgs[], _TCHAR* progArgs[], _TCHAR* jarFile)
 {
 	int i;
@@ -416,6 +679,10 @@ JavaResults * startJavaJNI(_TCHAR* libPath, _TCHAR* vmArgs[], _TCHAR* progArgs[]
 	JNI_createJavaVM createJavaVM;
 	JavaVMInitArgs init_args;
 	JavaVMOption * options;
+	char * cdsOption = NULL;			/* the CDS archive option, see eclipseCds.h */
+	int created;
+	ULONGLONG startTime;
+	long long startupMs = 0;
 
 	/* JNI reflection */
 	jclass mainClass = NULL;			/* The Main class to load */
@@ -455,7 +722,7 @@ JavaResults * startJavaJNI(_TCHAR* libPath, _TCHAR* vmArgs[], _TCHAR* progArgs[]
 		return results;
 	}
 
-	options = (JavaVMOption *)malloc(numVMArgs * sizeof(JavaVMOption));
+	options = (JavaVMOption *)malloc((numVMArgs + 1) * sizeof(JavaVMOption));
 	for (i = 0; i < numVMArgs; i++) {
 		OutputDebugString(vmArgs[i]);
 		OutputDebugString(_T("\n"));
@@ -480,12 +747,30 @@ JavaResults * startJavaJNI(_TCHAR* libPath, _TCHAR* vmArgs[], _TCHAR* progArgs[]
 
 	init_args.version = g_pSpaceTelescope->m_nJVMVersion;
 #endif
+	/* the archive option goes last, so that it can be left out again */
+	cdsOption = getCdsOption();
+	if (cdsOption != NULL) {
+		options[numVMArgs].optionString = cdsOption;
+		options[numVMArgs].extraInfo = 0;
+	}
+
 	init_args.options = options;
-	init_args.nOptions = numVMArgs;
+	init_args.nOptions = numVMArgs + (cdsOption != NULL ? 1 : 0);
 	init_args.ignoreUnrecognized = JNI_TRUE;
 
 	OutputDebugString(_T("begin createJavaVM\n"));
-	if (createJavaVM(&jvm, &env, &init_args) == 0)
+	startTime = GetTickCount64();
+	created = createJavaVM(&jvm, &env, &init_args) == 0;
+	/* HotSpot can be created again only after it failed parsing its arguments, where a VM
+	 * that does not know the archive option fails; a later failure makes the retry fail too */
+	if (!created && cdsOption != NULL) {
+		OutputDebugString(_T("createJavaVM failed with the CDS archive, trying without it\n"));
+		dropCdsArchive();
+		init_args.nOptions = numVMArgs;
+		created = createJavaVM(&jvm, &env, &init_args) == 0;
+	}
+	free(cdsOption);
+	if (created)
 	{
 		for (i = 0; i < numVMArgs; i++) {
 			free(options[i].optionString);
@@ -518,6 +803,13 @@ JavaResults * startJavaJNI(_TCHAR* libPath, _TCHAR* vmArgs[], _TCHAR* progArgs[]
 			}
 		}
 		/*end Add by Tangram Team*/
+		if (cdsMode != CDS_OFF) {
+			char* vmVersion = getSystemProperty(env, "java.vm.version");
+			char* vmInfo = getSystemProperty(env, "java.vm.info");
+			checkCdsArchive(vmVersion, vmInfo != NULL && strstr(vmInfo, "sharing") != NULL);
+			free(vmVersion);
+			free(vmInfo);
+		}
 		registerNatives(env);
 		USES_CONVERSION;
 		char * mainClassName = W2A(g_pSpaceTelescope->InitEclipse(jarFile));
@@ -543,8 +835,10 @@ JavaResults * startJavaJNI(_TCHAR* libPath, _TCHAR* vmArgs[], _TCHAR* progArgs[]
 						methodArgs = createRunArgs(env, progArgs);
 						if (methodArgs != NULL) {
 							results->launchResult = 0;
+							startupMs = (long long)(GetTickCount64() - startTime);
 							results->runResult = env->CallIntMethod(mainObject, runMethod, methodArgs);
 							env->DeleteLocalRef(methodArgs);
+							finishCdsArchive(results->runResult == 0, startupMs);
 						}
 					}
 					env->DeleteLocalRef(mainObject);
@@ -582,6 +876,10 @@ JavaResults * startJavaJNI(_TCHAR* libPath, _TCHAR* vmArgs[], _TCHAR* progArgs[]
 
 void cleanupVM(int exitCode) {
 	JNIEnv * localEnv = env;
+	int shutdown;
+
+	/* the VM may not return from here, write the profile first */
+	dumpJNIProfile();
 	if (jvm == 0)
 		return;
 
@@ -594,7 +892,18 @@ void cleanupVM(int exitCode) {
 
 	/* we call System.exit() unless osgi.noShutdown is set */
 	ATLTRACE(_T("before quit eclipse\n"));
-	if (shouldShutdown(env)) {
+	shutdown = shouldShutdown(env);
+
+	/* the VM writes the CDS archive only on its way out */
+	if (isCdsDumpPending()) {
+		ATLTRACE(_T("destroy the VM to write the CDS archive\n"));
+		jvm->DestroyJavaVM();
+		jvm = 0;
+		env = 0;
+		closeCdsArchive();
+	}
+
+	if (shutdown) {
 		if (g_pSpaceTelescope)
 		{
 			ATLTRACE(_T("begin quit eclipse\n"));
@@ -54,6 +54,9 @@ typedef jint (JNICALL *JNI_createJavaVM)(JavaVM **pvm, JNIEnv **env, void *args)
 #define takedown_splash 			Java_org_eclipse_equinox_launcher_JNIBridge__1takedown_1splash
 #define get_os_recommended_folder 	Java_org_eclipse_equinox_launcher_JNIBridge__1get_1os_1recommended_1folder
 #define tangram_extend 				Java_org_eclipse_equinox_launcher_JNIBridge__1tangram_1extend
+#define get_jni_profile 			Java_dev_tangram_TangramJava__1profile
+#define ring_open 					Java_dev_tangram_TangramJava__1ring_1open
+#define ring_doorbell 				Java_dev_tangram_TangramJava__1ring_1doorbell
 
 /* Start the Java VM and Wait For It to Terminate
  *
@@ -65,4 +68,13 @@ typedef jint (JNICALL *JNI_createJavaVM)(JavaVM **pvm, JNIEnv **env, void *args)
 extern JavaResults* startJavaJNI( _TCHAR* libPath, _TCHAR* vmArgs[], _TCHAR* progArgs[], _TCHAR* jarFile );
 
 extern void cleanupVM( int );
+
+/* Send a frame to Java over the ring transport, see eclipseRing.h
+ *
+ * Any launcher thread may call it once Java opened the ring with
+ * TangramJava._ring_open(). Returns 0 if the frame was sent, -1 if the
+ * ring is not open or full. A payload longer than getRingMaxPayload() may
+ * not fit even in an empty ring.
+ */
+extern int postToJava( unsigned int type, unsigned long long id, const void* payload, unsigned int length );
 #endif
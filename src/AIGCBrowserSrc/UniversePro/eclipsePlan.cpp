@@ -0,0 +1,365 @@
+/********************************************************************************
+ *           Web Runtime for Application - Version 1.0.0.202203120001           *
+ ********************************************************************************
+ * Copyright (C) 2002-2021 by Tangram Team.   All Rights Reserved.
+ * There are Three Key Features of Webruntime:
+ * 1. Built-in Modern Web Browser: Independent Browser Window and Browser Window
+ *    as sub windows of other windows are supported in the application process;
+ * 2. DOM Plus: DOMPlus is a natural extension of the standard DOM system.
+ *    It allows the application system to support a kind of generalized web pages,
+ *    which are composed of standard DOM elements and binary components supported
+ *    by the application system;
+ * 3. JavaScript for Application: Similar to VBA in MS office, JavaScript will
+ *    become a built-in programmable language in the application system, so that
+ *    the application system can be expanded and developed for the Internet based
+ *    on modern javscript/Web technology.
+ * Use of this source code is governed by a BSD-style license that
+ * can be found in the LICENSE file.
+ *
+ * CONTACT INFORMATION:
+ * mailto:tangramteam@outlook.com or mailto:sunhuizlz@yeah.net
+ * https://www.webruntime.com
+ *******************************************************************************/
+
+#include "stdafx.h"
+
+#include "eclipseOS.h"
+#include "eclipsePlan.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+/* "ELPN", bumped with the version whenever the layout below changes */
+#define PLAN_MAGIC		0x4E504C45
+#define PLAN_VERSION	2
+
+/* longest string a plan holds, in characters; VM arguments can be long */
+#define PLAN_MAX_STRING	(1 << 20)
+
+/* the VM argument naming the .ee file whose arguments are in vmArgs */
+#define PLAN_EE_FILENAME	_T_ECLIPSE("-Dee.filename=")
+
+#define FNV_OFFSET		0xcbf29ce484222325ULL
+#define FNV_PRIME		0x100000001b3ULL
+
+/* a file the plan resolved to, as it was when the plan was stored */
+typedef struct {
+	_TCHAR*		path;
+	long long	size;
+	long long	time;
+} PlanStamp;
+
+static unsigned long long hashBytes(unsigned long long hash, const void* data, size_t length) {
+	const unsigned char* bytes = (const unsigned char*)data;
+	size_t i;
+	for (i = 0; i < length; i++) {
+		hash ^= bytes[i];
+		hash *= FNV_PRIME;
+	}
+	return hash;
+}
+
+static unsigned long long hashString(unsigned long long hash, const _TCHAR* str) {
+	/* the terminating character keeps "ab","c" apart from "a","bc" */
+	return hashBytes(hash, str, (_tcslen(str) + 1) * sizeof(_TCHAR));
+}
+
+static int getStamp(_TCHAR* path, long long* size, long long* time) {
+	struct _stat stats;
+	if (_tstat(path, &stats) != 0)
+		return -1;
+	*size = (long long)stats.st_size;
+	*time = (long long)stats.st_mtime;
+	return 0;
+}
+
+static unsigned long long hashStamp(unsigned long long hash, _TCHAR* path) {
+	long long stamp[2] = { -1, -1 };
+	hash = hashString(hash, path);
+	getStamp(path, &stamp[0], &stamp[1]);
+	return hashBytes(hash, stamp, sizeof(stamp));
+}
+
+static unsigned long long hashFile(unsigned long long hash, _TCHAR* path) {
+	unsigned char buffer[4096];
+	size_t count;
+	FILE* file;
+
+	hash = hashStamp(hash, path);
+	file = _tfopen(path, _T_ECLIPSE("rb"));
+	if (file == NULL)
+		return hash;
+	while ((count = fread(buffer, 1, sizeof(buffer), file)) > 0)
+		hash = hashBytes(hash, buffer, count);
+	fclose(file);
+	return hash;
+}
+
+unsigned long long getLaunchPlanKey(_TCHAR* values[], _TCHAR* files[], _TCHAR* stamps[]) {
+	unsigned long long hash = FNV_OFFSET;
+	int version = PLAN_VERSION;
+	int i;
+
+	hash = hashBytes(hash, &version, sizeof(version));
+	/* a missing list and an empty one both end the section */
+	for (i = 0; values != NULL && values[i] != NULL; i++)
+		hash = hashString(hash, values[i]);
+	hash = hashBytes(hash, "\1", 1);
+	for (i = 0; files != NULL && files[i] != NULL; i++)
+		hash = hashFile(hash, files[i]);
+	hash = hashBytes(hash, "\2", 1);
+	for (i = 0; stamps != NULL && stamps[i] != NULL; i++)
+		hash = hashStamp(hash, stamps[i]);
+	return hash;
+}
+
+/* Writing: every field is written as is, strings with their length first
+ * and -1 for NULL, lists with their count first.
+ */
+static void writeInt(FILE* file, int value) {
+	fwrite(&value, sizeof(value), 1, file);
+}
+
+static void writeString(FILE* file, const _TCHAR* str) {
+	int length = (str != NULL) ? (int)_tcslen(str) : -1;
+	writeInt(file, length);
+	if (length > 0)
+		fwrite(str, sizeof(_TCHAR), length, file);
+}
+
+static void writeList(FILE* file, _TCHAR** list) {
+	int count = 0;
+	int i;
+	while (list != NULL && list[count] != NULL)
+		count++;
+	writeInt(file, list != NULL ? count : -1);
+	for (i = 0; i < count; i++)
+		writeString(file, list[i]);
+}
+
+static void writeStamp(FILE* file, _TCHAR* path, int* count) {
+	long long stamp[2];
+	if (path == NULL || getStamp(path, &stamp[0], &stamp[1]) != 0)
+		return;
+	writeString(file, path);
+	fwrite(stamp, sizeof(stamp), 1, file);
+	(*count)++;
+}
+
+/* the .ee file getVMCommand read its arguments from, NULL if none */
+static _TCHAR* findEEFile(_TCHAR** vmArgs) {
+	size_t length = _tcslen(PLAN_EE_FILENAME);
+	int i;
+	for (i = 0; vmArgs != NULL && vmArgs[i] != NULL; i++) {
+		if (_tcsncmp(vmArgs[i], PLAN_EE_FILENAME, length) == 0)
+			return vmArgs[i] + length;
+	}
+	return NULL;
+}
+
+/* Reading: each reader returns 0 if success, the strings it returns
+ * are allocated with malloc.
+ */
+static int readInt(FILE* file, int* value) {
+	return fread(value, sizeof(*value), 1, file) == 1 ? 0 : -1;
+}
+
+static int readString(FILE* file, _TCHAR** str) {
+	int length;
+	*str = NULL;
+	if (readInt(file, &length) != 0 || length < -1 || length > PLAN_MAX_STRING)
+		return -1;
+	if (length == -1)
+		return 0;
+	*str = (_TCHAR*)malloc((length + 1) * sizeof(_TCHAR));
+	if (length > 0 && fread(*str, sizeof(_TCHAR), length, file) != (size_t)length) {
+		free(*str);
+		*str = NULL;
+		return -1;
+	}
+	(*str)[length] = 0;
+	return 0;
+}
+
+static void freeList(_TCHAR** list) {
+	int i;
+	if (list == NULL)
+		return;
+	for (i = 0; list[i] != NULL; i++)
+		free(list[i]);
+	free(list);
+}
+
+static int readList(FILE* file, _TCHAR*** list) {
+	int count, i;
+	*list = NULL;
+	if (readInt(file, &count) != 0 || count < -1 || count > 0xFFFF)
+		return -1;
+	if (count == -1)
+		return 0;
+	*list = (_TCHAR**)malloc((count + 1) * sizeof(_TCHAR*));
+	memset(*list, 0, (count + 1) * sizeof(_TCHAR*));
+	for (i = 0; i < count; i++) {
+		if (readString(file, &(*list)[i]) != 0 || (*list)[i] == NULL) {
+			freeList(*list);
+			*list = NULL;
+			return -1;
+		}
+	}
+	return 0;
+}
+
+/* the resolved files must still be what they were when the plan was stored */
+static int checkStamps(FILE* file) {
+	int count, i;
+	if (readInt(file, &count) != 0 || count < 0 || count > 16)
+		return -1;
+	for (i = 0; i < count; i++) {
+		_TCHAR* path;
+		long long stamp[2], current[2];
+		if (readString(file, &path) != 0 || path == NULL)
+			return -1;
+		if (fread(stamp, sizeof(stamp), 1, file) != 1 ||
+			getStamp(path, &current[0], &current[1]) != 0 ||
+			stamp[0] != current[0] || stamp[1] != current[1]) {
+			free(path);
+			return -1;
+		}
+		free(path);
+	}
+	return 0;
+}
+
+LaunchPlan* loadLaunchPlan(_TCHAR* planFile, unsigned long long key) {
+	LaunchPlan* plan;
+	unsigned long long storedKey;
+	int magic, version, charSize;
+	int ok;
+	FILE* file;
+
+	if (planFile == NULL)
+		return NULL;
+	file = _tfopen(planFile, _T_ECLIPSE("rb"));
+	if (file == NULL)
+		return NULL;
+
+	if (readInt(file, &magic) != 0 || magic != PLAN_MAGIC ||
+		readInt(file, &version) != 0 || version != PLAN_VERSION ||
+		readInt(file, &charSize) != 0 || charSize != (int)sizeof(_TCHAR) ||
+		fread(&storedKey, sizeof(storedKey), 1, file) != 1 || storedKey != key) {
+		fclose(file);
+		return NULL;
+	}
+
+	plan = (LaunchPlan*)malloc(sizeof(LaunchPlan));
+	memset(plan, 0, sizeof(LaunchPlan));
+	ok = readInt(file, &plan->launchMode) == 0 &&
+		readInt(file, &plan->jvmVersion) == 0 &&
+		readString(file, &plan->jniLib) == 0 &&
+		readString(file, &plan->eeLibPath) == 0 &&
+		readString(file, &plan->pathPrefix) == 0 &&
+		readString(file, &plan->startupPrefix) == 0 &&
+		readString(file, &plan->jarFile) == 0 &&
+		readString(file, &plan->splashBitmap) == 0 &&
+		readList(file, &plan->vmArgs) == 0 &&
+		readList(file, &plan->progArgs) == 0 &&
+		checkStamps(file) == 0 &&
+		readInt(file, &magic) == 0 && magic == PLAN_MAGIC;
+	fclose(file);
+
+	if (!ok || plan->vmArgs == NULL || plan->progArgs == NULL) {
+		freeLaunchPlan(plan);
+		return NULL;
+	}
+	return plan;
+}
+
+int saveLaunchPlan(_TCHAR* planFile, unsigned long long key, LaunchPlan* plan) {
+	_TCHAR* tempFile;
+	long stampsAt;
+	int stamps = 0;
+	int failed;
+	FILE* file;
+
+	if (planFile == NULL || plan == NULL)
+		return -1;
+
+	tempFile = (_TCHAR*)malloc((_tcslen(planFile) + 24) * sizeof(_TCHAR));
+#ifdef _WIN32
+	_stprintf(tempFile, _T_ECLIPSE("%s.%lx"), planFile, (unsigned long)GetCurrentProcessId());
+#else
+	_stprintf(tempFile, _T_ECLIPSE("%s.%lx"), planFile, (unsigned long)getpid());
+#endif
+	file = _tfopen(tempFile, _T_ECLIPSE("wb"));
+	if (file == NULL) {
+		free(tempFile);
+		return -1;
+	}
+
+	writeInt(file, PLAN_MAGIC);
+	writeInt(file, PLAN_VERSION);
+	writeInt(file, (int)sizeof(_TCHAR));
+	fwrite(&key, sizeof(key), 1, file);
+	writeInt(file, plan->launchMode);
+	writeInt(file, plan->jvmVersion);
+	writeString(file, plan->jniLib);
+	writeString(file, plan->eeLibPath);
+	writeString(file, plan->pathPrefix);
+	writeString(file, plan->startupPrefix);
+	writeString(file, plan->jarFile);
+	writeString(file, plan->splashBitmap);
+	writeList(file, plan->vmArgs);
+	writeList(file, plan->progArgs);
+
+	/* the count goes in front of the stamps once it is known */
+	stampsAt = ftell(file);
+	writeInt(file, 0);
+	writeStamp(file, plan->jniLib, &stamps);
+	writeStamp(file, plan->jarFile, &stamps);
+	writeStamp(file, plan->splashBitmap, &stamps);
+	writeStamp(file, findEEFile(plan->vmArgs), &stamps);
+	writeInt(file, PLAN_MAGIC);
+	fseek(file, stampsAt, SEEK_SET);
+	writeInt(file, stamps);
+
+	failed = ferror(file);
+	if (fclose(file) != 0)
+		failed = 1;
+	if (!failed) {
+#ifdef _WIN32
+		failed = !MoveFileEx(tempFile, planFile, MOVEFILE_REPLACE_EXISTING);
+#else
+		failed = rename(tempFile, planFile) != 0;
+#endif
+	}
+	if (failed)
+		_tremove(tempFile);
+	free(tempFile);
+	return failed ? -1 : 0;
+}
+
+void removeLaunchPlan(_TCHAR* planFile) {
+	if (planFile != NULL)
+		_tremove(planFile);
+}
+
+void freeLaunchPlan(LaunchPlan* plan) {
+	if (plan == NULL)
+		return;
+	free(plan->jniLib);
+	free(plan->eeLibPath);
+	free(plan->pathPrefix);
+	free(plan->startupPrefix);
+	free(plan->jarFile);
+	free(plan->splashBitmap);
+	freeList(plan->vmArgs);
+	freeList(plan->progArgs);
+	free(plan);
+}
@@ -0,0 +1,91 @@
+/********************************************************************************
+ *           Web Runtime for Application - Version 1.0.0.202203120001           *
+ ********************************************************************************
+ * Copyright (C) 2002-2021 by Tangram Team.   All Rights Reserved.
+ * There are Three Key Features of Webruntime:
+ * 1. Built-in Modern Web Browser: Independent Browser Window and Browser Window
+ *    as sub windows of other windows are supported in the application process;
+ * 2. DOM Plus: DOMPlus is a natural extension of the standard DOM system.
+ *    It allows the application system to support a kind of generalized web pages,
+ *    which are composed of standard DOM elements and binary components supported
+ *    by the application system;
+ * 3. JavaScript for Application: Similar to VBA in MS office, JavaScript will
+ *    become a built-in programmable language in the application system, so that
+ *    the application system can be expanded and developed for the Internet based
+ *    on modern javscript/Web technology.
+ * Use of this source code is governed by a BSD-style license that
+ * can be found in the LICENSE file.
+ *
+ * CONTACT INFORMATION:
+ * mailto:tangramteam@outlook.com or mailto:sunhuizlz@yeah.net
+ * https://www.webruntime.com
+ *******************************************************************************/
+
+#ifndef ECLIPSE_PLAN_H
+#define ECLIPSE_PLAN_H
+
+/* Launch plan utilities
+ *
+ * A launch plan keeps what the launcher resolved when it last started: the
+ * launch mode, the VM, the startup jar, the splash bitmap and the final VM
+ * and program arguments. It is stored under a key computed from everything
+ * the resolution reads, and the files it resolved to are checked again when
+ * it is loaded, so a plan is only used while none of its inputs changed.
+ */
+
+typedef struct {
+	int			launchMode;
+	int			jvmVersion;		/* JNI version the VM search settled on */
+	_TCHAR*		jniLib;
+	_TCHAR*		eeLibPath;		/* ee.library.path of the .ee file, if any */
+	_TCHAR*		pathPrefix;		/* directories the VM search put in front of PATH */
+	_TCHAR*		startupPrefix;	/* name the startup jar was looked up with */
+	_TCHAR*		jarFile;
+	_TCHAR*		splashBitmap;
+	_TCHAR**	vmArgs;			/* NULL terminated */
+	_TCHAR**	progArgs;		/* NULL terminated */
+} LaunchPlan;
+
+/**
+ * Computes the key of a launch from three NULL terminated lists:
+ * values are hashed as they are (arguments, environment, settings),
+ * files are hashed with their contents, size and modification time,
+ * and stamps with their size and modification time only (directories,
+ * whose time changes when an entry is added or removed).
+ * A file or stamp that does not exist is hashed as missing.
+ */
+extern unsigned long long getLaunchPlanKey(_TCHAR* values[], _TCHAR* files[], _TCHAR* stamps[]);
+
+/**
+ * Loads the plan stored in planFile for the given key. Returns NULL
+ * if there is none, if it was stored for another key, or if one of the
+ * files it resolved to was changed or removed since: the VM library,
+ * the startup jar, the splash bitmap and the .ee file that vmArgs names
+ * with -Dee.filename. The plan must be
+ * freed with freeLaunchPlan().
+ */
+extern LaunchPlan* loadLaunchPlan(_TCHAR* planFile, unsigned long long key);
+
+/**
+ * Stores the plan in planFile under the given key, replacing the
+ * plan stored there before. The file is written next to planFile and
+ * then moved over it, so a concurrent launch sees the old or the new
+ * plan, never a part of one.
+ *
+ * Returns 0 if success.
+ */
+extern int saveLaunchPlan(_TCHAR* planFile, unsigned long long key, LaunchPlan* plan);
+
+/**
+ * Removes the plan stored in planFile, for example after it failed
+ * to start the VM.
+ */
+extern void removeLaunchPlan(_TCHAR* planFile);
+
+/**
+ * Frees a plan returned by loadLaunchPlan() and the strings and
+ * lists it still holds.
+ */
+extern void freeLaunchPlan(LaunchPlan* plan);
+
+#endif /* ECLIPSE_PLAN_H */
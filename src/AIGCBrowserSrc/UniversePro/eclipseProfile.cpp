@@ -0,0 +1,225 @@
+/********************************************************************************
+ *           Web Runtime for Application - Version 1.0.0.202203120001           *
+ ********************************************************************************
+ * Copyright (C) 2002-2021 by Tangram Team.   All Rights Reserved.
+ * There are Three Key Features of Webruntime:
+ * 1. Built-in Modern Web Browser: Independent Browser Window and Browser Window
+ *    as sub windows of other windows are supported in the application process;
+ * 2. DOM Plus: DOMPlus is a natural extension of the standard DOM system.
+ *    It allows the application system to support a kind of generalized web pages,
+ *    which are composed of standard DOM elements and binary components supported
+ *    by the application system;
+ * 3. JavaScript for Application: Similar to VBA in MS office, JavaScript will
+ *    become a built-in programmable language in the application system, so that
+ *    the application system can be expanded and developed for the Internet based
+ *    on modern javscript/Web technology.
+ * Use of this source code is governed by a BSD-style license that
+ * can be found in the LICENSE file.
+ *
+ * CONTACT INFORMATION:
+ * mailto:tangramteam@outlook.com or mailto:sunhuizlz@yeah.net
+ * https://www.webruntime.com
+ *******************************************************************************/
+
+#include "stdafx.h"
+
+#include "eclipseOS.h"
+#include "eclipseProfile.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+
+#ifndef _WIN32
+#include <time.h>
+#endif
+
+/* room for one entry of the snapshot, names and 38 numbers of at most 20 digits */
+#define PROFILE_ENTRY_TEXT	1024
+
+typedef struct {
+	std::atomic<long long>	calls;
+	std::atomic<long long>	totalNs;
+	std::atomic<long long>	minNs;
+	std::atomic<long long>	maxNs;
+	std::atomic<long long>	bytes;
+	std::atomic<long long>	histogram[JNI_PROFILE_BUCKETS];
+} ProfileEntry;
+
+static const _TCHAR* entryNames[JNI_PROFILE_ENTRIES] = {
+	_T_ECLIPSE("update_splash"),
+	_T_ECLIPSE("get_splash_handle"),
+	_T_ECLIPSE("set_exit_data"),
+	_T_ECLIPSE("set_launcher_info"),
+	_T_ECLIPSE("show_splash"),
+	_T_ECLIPSE("takedown_splash"),
+	_T_ECLIPSE("get_os_recommended_folder"),
+	_T_ECLIPSE("tangram_extend"),
+	_T_ECLIPSE("ring_doorbell"),
+	_T_ECLIPSE("registerNatives"),
+	_T_ECLIPSE("JNI_GetStringChars"),
+	_T_ECLIPSE("newJavaString")
+};
+
+int jniProfiling = 0;
+
+static ProfileEntry entries[JNI_PROFILE_ENTRIES];
+static _TCHAR* profileFile = NULL;
+static long long profileStart = 0;
+
+/* the native method running on this thread, conversions are counted under it too */
+static thread_local int currentNative = -1;
+
+#ifdef _WIN32
+static long long ticksPerSecond = 0;
+#endif
+
+/* monotonic clock ticks, never 0 so that 0 can mean "not timed" */
+static long long readClock() {
+	long long ticks;
+#ifdef _WIN32
+	LARGE_INTEGER counter;
+	QueryPerformanceCounter(&counter);
+	ticks = counter.QuadPart;
+#else
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	ticks = (long long)now.tv_sec * 1000000000LL + now.tv_nsec;
+#endif
+	return ticks != 0 ? ticks : 1;
+}
+
+static long long ticksToNs(long long ticks) {
+#ifdef _WIN32
+	/* split up so that ticks * 10^9 can not overflow */
+	return (ticks / ticksPerSecond) * 1000000000LL + (ticks % ticksPerSecond) * 1000000000LL / ticksPerSecond;
+#else
+	return ticks;
+#endif
+}
+
+static int bucketOf(long long ns) {
+	int bucket = 0;
+	while (ns > 1 && bucket < JNI_PROFILE_BUCKETS - 1) {
+		ns >>= 1;
+		bucket++;
+	}
+	return bucket;
+}
+
+void startJNIProfile(const _TCHAR* dumpFile) {
+	int i, j;
+
+	if (dumpFile == NULL || jniProfiling)
+		return;
+
+	for (i = 0; i < JNI_PROFILE_ENTRIES; i++) {
+		entries[i].calls = 0;
+		entries[i].totalNs = 0;
+		entries[i].minNs = -1;
+		entries[i].maxNs = 0;
+		entries[i].bytes = 0;
+		for (j = 0; j < JNI_PROFILE_BUCKETS; j++)
+			entries[i].histogram[j] = 0;
+	}
+#ifdef _WIN32
+	LARGE_INTEGER frequency;
+	QueryPerformanceFrequency(&frequency);
+	ticksPerSecond = frequency.QuadPart;
+#endif
+	profileFile = _tcsdup(dumpFile);
+	profileStart = readClock();
+	jniProfiling = 1;
+}
+
+long long enterJNIProfile(int entry, int* outerNative) {
+	if (entry < JNI_PROFILE_NATIVES) {
+		*outerNative = currentNative;
+		currentNative = entry;
+	}
+	return readClock();
+}
+
+void leaveJNIProfile(int entry, long long start, int outerNative) {
+	ProfileEntry* profile = &entries[entry];
+	long long ns = ticksToNs(readClock() - start);
+	long long seen;
+
+	if (entry < JNI_PROFILE_NATIVES)
+		currentNative = outerNative;
+
+	profile->calls.fetch_add(1, std::memory_order_relaxed);
+	profile->totalNs.fetch_add(ns, std::memory_order_relaxed);
+	profile->histogram[bucketOf(ns)].fetch_add(1, std::memory_order_relaxed);
+
+	seen = profile->minNs.load(std::memory_order_relaxed);
+	while ((seen < 0 || ns < seen) && !profile->minNs.compare_exchange_weak(seen, ns, std::memory_order_relaxed))
+		;
+	seen = profile->maxNs.load(std::memory_order_relaxed);
+	while (ns > seen && !profile->maxNs.compare_exchange_weak(seen, ns, std::memory_order_relaxed))
+		;
+}
+
+void countJNIProfileBytes(int entry, size_t bytes) {
+	int native = currentNative;
+
+	if (!jniProfiling)
+		return;
+	entries[entry].bytes.fetch_add((long long)bytes, std::memory_order_relaxed);
+	if (native >= 0 && native != entry)
+		entries[native].bytes.fetch_add((long long)bytes, std::memory_order_relaxed);
+}
+
+_TCHAR* getJNIProfileSnapshot() {
+	_TCHAR* result = (_TCHAR*)malloc((JNI_PROFILE_ENTRIES * PROFILE_ENTRY_TEXT + 128) * sizeof(_TCHAR));
+	_TCHAR* next = result;
+	int i, j;
+
+	if (result == NULL)
+		return NULL;
+
+	next += _stprintf(next, _T_ECLIPSE("{\"enabled\":%s,\"elapsedNs\":%lld,\"entries\":["),
+		jniProfiling ? _T_ECLIPSE("true") : _T_ECLIPSE("false"),
+		jniProfiling ? ticksToNs(readClock() - profileStart) : 0LL);
+	for (i = 0; jniProfiling && i < JNI_PROFILE_ENTRIES; i++) {
+		ProfileEntry* profile = &entries[i];
+		long long minNs = profile->minNs.load(std::memory_order_relaxed);
+
+		next += _stprintf(next, _T_ECLIPSE("%s{\"name\":\"%s\",\"calls\":%lld,\"totalNs\":%lld,\"minNs\":%lld,\"maxNs\":%lld,\"bytes\":%lld,\"histogram\":["),
+			i > 0 ? _T_ECLIPSE(",") : _T_ECLIPSE(""), entryNames[i],
+			profile->calls.load(std::memory_order_relaxed),
+			profile->totalNs.load(std::memory_order_relaxed),
+			minNs < 0 ? 0LL : minNs,
+			profile->maxNs.load(std::memory_order_relaxed),
+			profile->bytes.load(std::memory_order_relaxed));
+		for (j = 0; j < JNI_PROFILE_BUCKETS; j++)
+			next += _stprintf(next, _T_ECLIPSE("%s%lld"), j > 0 ? _T_ECLIPSE(",") : _T_ECLIPSE(""),
+				profile->histogram[j].load(std::memory_order_relaxed));
+		next += _stprintf(next, _T_ECLIPSE("]}"));
+	}
+	_stprintf(next, _T_ECLIPSE("]}"));
+	return result;
+}
+
+int dumpJNIProfile() {
+	_TCHAR* snapshot;
+	FILE* file;
+	int result = -1;
+
+	if (!jniProfiling || profileFile == NULL)
+		return -1;
+
+	snapshot = getJNIProfileSnapshot();
+	if (snapshot != NULL) {
+		file = _tfopen(profileFile, _T_ECLIPSE("w"));
+		if (file != NULL) {
+			if (_fputts(snapshot, file) >= 0)
+				result = 0;
+			if (fclose(file) != 0)
+				result = -1;
+		}
+		free(snapshot);
+	}
+	return result;
+}
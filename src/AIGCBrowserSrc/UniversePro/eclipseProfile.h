@@ -0,0 +1,105 @@
+/********************************************************************************
+ *           Web Runtime for Application - Version 1.0.0.202203120001           *
+ ********************************************************************************
+ * Copyright (C) 2002-2021 by Tangram Team.   All Rights Reserved.
+ * There are Three Key Features of Webruntime:
+ * 1. Built-in Modern Web Browser: Independent Browser Window and Browser Window
+ *    as sub windows of other windows are supported in the application process;
+ * 2. DOM Plus: DOMPlus is a natural extension of the standard DOM system.
+ *    It allows the application system to support a kind of generalized web pages,
+ *    which are composed of standard DOM elements and binary components supported
+ *    by the application system;
+ * 3. JavaScript for Application: Similar to VBA in MS office, JavaScript will
+ *    become a built-in programmable language in the application system, so that
+ *    the application system can be expanded and developed for the Internet based
+ *    on modern javscript/Web technology.
+ * Use of this source code is governed by a BSD-style license that
+ * can be found in the LICENSE file.
+ *
+ * CONTACT INFORMATION:
+ * mailto:tangramteam@outlook.com or mailto:sunhuizlz@yeah.net
+ * https://www.webruntime.com
+ *******************************************************************************/
+
+#ifndef ECLIPSE_PROFILE_H
+#define ECLIPSE_PROFILE_H
+
+/* JNI bridge profiling
+ *
+ * Off unless the launcher was started with --launcher.jniProfile <file>.
+ * Every profiled entry counts its calls, a histogram of their latency in
+ * power of two nanosecond buckets and the bytes of string data converted.
+ * Conversions are counted under their own entries and also under the native
+ * method they ran in, so the natives that move the most text stand out.
+ */
+
+/* profiled entries, the natives first */
+enum {
+	JNI_PROFILE_UPDATE_SPLASH,
+	JNI_PROFILE_GET_SPLASH_HANDLE,
+	JNI_PROFILE_SET_EXIT_DATA,
+	JNI_PROFILE_SET_LAUNCHER_INFO,
+	JNI_PROFILE_SHOW_SPLASH,
+	JNI_PROFILE_TAKEDOWN_SPLASH,
+	JNI_PROFILE_GET_OS_RECOMMENDED_FOLDER,
+	JNI_PROFILE_TANGRAM_EXTEND,
+	JNI_PROFILE_RING_DOORBELL,
+	JNI_PROFILE_NATIVES,				/* end of the natives */
+	JNI_PROFILE_REGISTER_NATIVES = JNI_PROFILE_NATIVES,
+	JNI_PROFILE_GET_STRING_CHARS,
+	JNI_PROFILE_NEW_JAVA_STRING,
+	JNI_PROFILE_ENTRIES
+};
+
+#define JNI_PROFILE_BUCKETS	32		/* bucket i holds [2^i, 2^(i+1)) ns, the last one the rest */
+
+/* nonzero once startJNIProfile() was called */
+extern int jniProfiling;
+
+/**
+ * Starts profiling. The profile is written to dumpFile by
+ * dumpJNIProfile(), dumpFile is copied.
+ */
+extern void startJNIProfile(const _TCHAR* dumpFile);
+
+/* Called around a profiled entry, see JNIProfileScope */
+extern long long enterJNIProfile(int entry, int* outerNative);
+extern void leaveJNIProfile(int entry, long long start, int outerNative);
+
+/**
+ * Counts bytes of string data converted by the given entry, and
+ * by the native method running on this thread.
+ */
+extern void countJNIProfileBytes(int entry, size_t bytes);
+
+/**
+ * Returns the profile as JSON, to be freed with free(). The text is
+ * {"enabled":..,"elapsedNs":..,"entries":[{"name":..,"calls":..,
+ * "totalNs":..,"minNs":..,"maxNs":..,"bytes":..,"histogram":[..]},..]}
+ */
+extern _TCHAR* getJNIProfileSnapshot();
+
+/**
+ * Writes the snapshot to the file given to startJNIProfile().
+ *
+ * Returns 0 if success.
+ */
+extern int dumpJNIProfile();
+
+/* Profiles the enclosing block as the given entry */
+struct JNIProfileScope {
+	int entry;
+	int outerNative;
+	long long start;
+
+	JNIProfileScope(int profileEntry) : entry(profileEntry), outerNative(-1), start(0) {
+		if (jniProfiling)
+			start = enterJNIProfile(entry, &outerNative);
+	}
+	~JNIProfileScope() {
+		if (start != 0)
+			leaveJNIProfile(entry, start, outerNative);
+	}
+};
+
+#endif /* ECLIPSE_PROFILE_H */
@@ -0,0 +1,226 @@
+/********************************************************************************
+ *           Web Runtime for Application - Version 1.0.0.202203120001           *
+ ********************************************************************************
+ * Copyright (C) 2002-2021 by Tangram Team.   All Rights Reserved.
+ * There are Three Key Features of Webruntime:
+ * 1. Built-in Modern Web Browser: Independent Browser Window and Browser Window
+ *    as sub windows of other windows are supported in the application process;
+ * 2. DOM Plus: DOMPlus is a natural extension of the standard DOM system.
+ *    It allows the application system to support a kind of generalized web pages,
+ *    which are composed of standard DOM elements and binary components supported
+ *    by the application system;
+ * 3. JavaScript for Application: Similar to VBA in MS office, JavaScript will
+ *    become a built-in programmable language in the application system, so that
+ *    the application system can be expanded and developed for the Internet based
+ *    on modern javscript/Web technology.
+ * Use of this source code is governed by a BSD-style license that
+ * can be found in the LICENSE file.
+ *
+ * CONTACT INFORMATION:
+ * mailto:tangramteam@outlook.com or mailto:sunhuizlz@yeah.net
+ * https://www.webruntime.com
+ *******************************************************************************/
+
+#include "stdafx.h"
+
+#include "eclipseOS.h"
+#include "eclipseRing.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <new>
+
+#define RING_ALIGN			64
+
+/* offsets of the indices in the header */
+#define TO_JAVA_WRITE		0
+#define TO_NATIVE_READ		8
+#define TO_JAVA_READ		64
+#define TO_NATIVE_WRITE		72
+#define RING_HEADER_INFO	192
+
+typedef std::atomic<unsigned long long> RingIndex;
+
+struct EclipseRing {
+	void*			allocation;		/* what calloc returned, memory is aligned within it */
+	unsigned char*	memory;
+	size_t			capacity;
+	std::mutex		sendLock;		/* senders are any launcher thread, the ring has one producer */
+	int				stopped;
+};
+
+static RingIndex* ringIndex(EclipseRing* ring, size_t offset) {
+	return (RingIndex*)(ring->memory + offset);
+}
+
+static RingIndex* ringStat(EclipseRing* ring, int stat) {
+	return ringIndex(ring, RING_HEADER_STATS + stat * sizeof(unsigned long long));
+}
+
+static unsigned int readUInt(const unsigned char* data) {
+	unsigned int value;
+	memcpy(&value, data, sizeof(value));
+	return value;
+}
+
+static void writeUInt(unsigned char* data, unsigned int value) {
+	memcpy(data, &value, sizeof(value));
+}
+
+static size_t frameSize(unsigned int length) {
+	return (RING_FRAME_HEADER + (size_t)length + 7) & ~(size_t)7;
+}
+
+EclipseRing* createRing(size_t capacity) {
+	EclipseRing* ring;
+	size_t size = RING_MIN_CAPACITY;
+	unsigned long long value;
+	int offset;
+
+	while (size < capacity && size < RING_MAX_CAPACITY)
+		size <<= 1;
+
+	ring = new(std::nothrow) EclipseRing;
+	if (ring == NULL)
+		return NULL;
+	ring->allocation = calloc(RING_HEADER_SIZE + 2 * size + RING_ALIGN, 1);
+	if (ring->allocation == NULL) {
+		delete ring;
+		return NULL;
+	}
+	ring->memory = (unsigned char*)(((size_t)ring->allocation + RING_ALIGN - 1) & ~(size_t)(RING_ALIGN - 1));
+	ring->capacity = size;
+	ring->stopped = 0;
+
+	for (offset = 0; offset < RING_HEADER_INFO; offset += sizeof(unsigned long long))
+		new(ring->memory + offset) RingIndex(0);
+	writeUInt(ring->memory + RING_HEADER_INFO, RING_MAGIC);
+	writeUInt(ring->memory + RING_HEADER_INFO + 4, RING_VERSION);
+	value = size;
+	memcpy(ring->memory + RING_HEADER_INFO + 8, &value, sizeof(value));
+	return ring;
+}
+
+void destroyRing(EclipseRing* ring) {
+	if (ring == NULL)
+		return;
+	free(ring->allocation);
+	delete ring;
+}
+
+void* getRingMemory(EclipseRing* ring, size_t* size) {
+	*size = RING_HEADER_SIZE + 2 * ring->capacity;
+	return ring->memory;
+}
+
+unsigned int getRingMaxPayload(EclipseRing* ring) {
+	/* a frame of half the data fits before the end or, after a wrap, at 0 */
+	return (unsigned int)(ring->capacity / 2 - RING_FRAME_HEADER);
+}
+
+int sendRing(EclipseRing* ring, unsigned int type, unsigned long long id, const void* payload, unsigned int length) {
+	unsigned char* data = ring->memory + RING_HEADER_SIZE;
+	size_t size = frameSize(length);
+	size_t offset, tail;
+	unsigned long long published, write, read;
+
+	if (length > ring->capacity)
+		return -1;
+
+	std::lock_guard<std::mutex> lock(ring->sendLock);
+
+	published = write = ringIndex(ring, TO_JAVA_WRITE)->load(std::memory_order_relaxed);
+	read = ringIndex(ring, TO_JAVA_READ)->load(std::memory_order_acquire);
+	offset = (size_t)(write & (ring->capacity - 1));
+	tail = ring->capacity - offset;
+
+	/* a frame that does not fit before the end starts over at 0 */
+	if (size > tail) {
+		if (ring->capacity - (size_t)(write - read) < tail + size) {
+			ringStat(ring, RING_STAT_FULL)->fetch_add(1, std::memory_order_relaxed);
+			return -1;
+		}
+		writeUInt(data + offset, RING_WRAP);
+		write += tail;
+		offset = 0;
+	}
+	else if (ring->capacity - (size_t)(write - read) < size) {
+		ringStat(ring, RING_STAT_FULL)->fetch_add(1, std::memory_order_relaxed);
+		return -1;
+	}
+
+	writeUInt(data + offset, length);
+	writeUInt(data + offset + 4, type);
+	memcpy(data + offset + 8, &id, sizeof(id));
+	if (length > 0)
+		memcpy(data + offset + RING_FRAME_HEADER, payload, length);
+
+	/* publish, then see whether Java had caught up with what was there before */
+	ringIndex(ring, TO_JAVA_WRITE)->store(write + size, std::memory_order_seq_cst);
+	read = ringIndex(ring, TO_JAVA_READ)->load(std::memory_order_seq_cst);
+
+	ringStat(ring, RING_STAT_SENT)->fetch_add(1, std::memory_order_relaxed);
+	ringStat(ring, RING_STAT_SENT_BYTES)->fetch_add(length, std::memory_order_relaxed);
+	return read == published ? 1 : 0;
+}
+
+int drainRing(EclipseRing* ring, RingHandler handler, void* context) {
+	unsigned char* data = ring->memory + RING_HEADER_SIZE + ring->capacity;
+	RingIndex* readIndex = ringIndex(ring, TO_NATIVE_READ);
+	RingIndex* writeIndex = ringIndex(ring, TO_NATIVE_WRITE);
+	unsigned long long read = readIndex->load(std::memory_order_relaxed);
+	unsigned long long write;
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	long long bytes = 0;
+	int count = 0;
+
+	ring->stopped = 0;
+	while ((write = writeIndex->load(std::memory_order_seq_cst)) != read) {
+		size_t offset = (size_t)(read & (ring->capacity - 1));
+		unsigned int length = readUInt(data + offset);
+		unsigned long long id;
+
+		if (length == RING_WRAP) {
+			read += ring->capacity - offset;
+			readIndex->store(read, std::memory_order_seq_cst);
+			continue;
+		}
+		/* a frame Java wrote past its ring, nothing after it can be trusted */
+		if (ring->capacity - offset < RING_FRAME_HEADER || length > ring->capacity - offset - RING_FRAME_HEADER || frameSize(length) > write - read) {
+			readIndex->store(write, std::memory_order_seq_cst);
+			break;
+		}
+
+		memcpy(&id, data + offset + 8, sizeof(id));
+		handler(context, readUInt(data + offset + 4), id, data + offset + RING_FRAME_HEADER, length);
+		if (ring->stopped)
+			break;
+
+		read += frameSize(length);
+		readIndex->store(read, std::memory_order_seq_cst);
+		bytes += length;
+		count++;
+	}
+
+	ringStat(ring, RING_STAT_RECEIVED)->fetch_add(count, std::memory_order_relaxed);
+	ringStat(ring, RING_STAT_RECEIVED_BYTES)->fetch_add(bytes, std::memory_order_relaxed);
+	ringStat(ring, RING_STAT_DOORBELLS)->fetch_add(1, std::memory_order_relaxed);
+	ringStat(ring, RING_STAT_DRAIN_NS)->fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now() - start).count(), std::memory_order_relaxed);
+	return count;
+}
+
+void stopRing(EclipseRing* ring) {
+	ring->stopped = 1;
+}
+
+void countRing(EclipseRing* ring, int stat, long long value) {
+	ringStat(ring, stat)->fetch_add(value, std::memory_order_relaxed);
+}
+
+long long getRingStat(EclipseRing* ring, int stat) {
+	return (long long)ringStat(ring, stat)->load(std::memory_order_relaxed);
+}
@@ -0,0 +1,153 @@
+/********************************************************************************
+ *           Web Runtime for Application - Version 1.0.0.202203120001           *
+ ********************************************************************************
+ * Copyright (C) 2002-2021 by Tangram Team.   All Rights Reserved.
+ * There are Three Key Features of Webruntime:
+ * 1. Built-in Modern Web Browser: Independent Browser Window and Browser Window
+ *    as sub windows of other windows are supported in the application process;
+ * 2. DOM Plus: DOMPlus is a natural extension of the standard DOM system.
+ *    It allows the application system to support a kind of generalized web pages,
+ *    which are composed of standard DOM elements and binary components supported
+ *    by the application system;
+ * 3. JavaScript for Application: Similar to VBA in MS office, JavaScript will
+ *    become a built-in programmable language in the application system, so that
+ *    the application system can be expanded and developed for the Internet based
+ *    on modern javscript/Web technology.
+ * Use of this source code is governed by a BSD-style license that
+ * can be found in the LICENSE file.
+ *
+ * CONTACT INFORMATION:
+ * mailto:tangramteam@outlook.com or mailto:sunhuizlz@yeah.net
+ * https://www.webruntime.com
+ *******************************************************************************/
+
+#ifndef ECLIPSE_RING_H
+#define ECLIPSE_RING_H
+
+/* Ring transport between the launcher and the Java workbench
+ *
+ * One block of memory, handed to Java once as a direct ByteBuffer, holds
+ * a ring towards Java and a ring towards the launcher. Each ring has one
+ * producer and one consumer that only exchange 64 bit indices, so messages
+ * cross without a JNI call and without converting them to strings.
+ *
+ * Layout, all values in native byte order:
+ *
+ *   0    toJava write index		written by the launcher
+ *   8    toNative read index		written by the launcher
+ *   64   toJava read index			written by Java
+ *   72   toNative write index		written by Java
+ *   128  launcher counters, RING_STAT_* below
+ *   192  RING_MAGIC (4 bytes), RING_VERSION (4 bytes), capacity (8 bytes)
+ *   256  toJava data, capacity bytes
+ *   256 + capacity  toNative data, capacity bytes
+ *
+ * Indices only grow, the offset in the data is index & (capacity - 1).
+ * A frame is a 16 byte header, its payload and padding up to 8 bytes:
+ *
+ *   0    payload length in bytes, RING_WRAP for the rest of the data
+ *   4    message type, RING_MESSAGE_*
+ *   8    id, echoed by replies
+ *
+ * A frame does not wrap around, when it does not fit before the end of the
+ * data the producer writes RING_WRAP and starts over at offset 0.
+ *
+ * The producer stores its write index, then reads the consumer's read index.
+ * If that equals the write index it published over, the ring was empty and
+ * the consumer may be idle, so the producer rings the doorbell: Java calls
+ * TangramJava._ring_doorbell(), the launcher calls TangramJava.ringReady().
+ * Both sides must store and load the indices with sequentially consistent
+ * ordering (VarHandle setVolatile/getVolatile on the Java side).
+ */
+
+#define RING_HEADER_SIZE	256
+#define RING_FRAME_HEADER	16
+#define RING_WRAP			0xFFFFFFFF
+#define RING_MAGIC			0x474E5245		/* "ERNG" */
+#define RING_VERSION		1
+
+#define RING_MIN_CAPACITY	(1 << 12)
+#define RING_MAX_CAPACITY	(1 << 26)
+
+/* message types */
+#define RING_MESSAGE_EXTEND			1	/* key, data and features, each null terminated _TCHARs */
+#define RING_MESSAGE_EXTEND_REPLY	2	/* the result, _TCHARs without terminator */
+#define RING_MESSAGE_EXTEND_REPLY_PART	3	/* a piece of a result longer than getRingMaxPayload(),
+										   the RING_MESSAGE_EXTEND_REPLY with the same id ends it */
+
+/* directions */
+#define RING_TO_JAVA		0
+#define RING_TO_NATIVE		1
+
+/* launcher counters, at RING_HEADER_STATS in the block */
+#define RING_HEADER_STATS	128
+enum {
+	RING_STAT_SENT,			/* frames sent to Java */
+	RING_STAT_SENT_BYTES,	/* payload bytes sent to Java */
+	RING_STAT_JAVA_DOORBELLS,	/* ringReady() calls */
+	RING_STAT_FULL,			/* sends that did not fit */
+	RING_STAT_RECEIVED,		/* frames received from Java */
+	RING_STAT_RECEIVED_BYTES,	/* payload bytes received from Java */
+	RING_STAT_DOORBELLS,	/* drains, i.e. _ring_doorbell() calls */
+	RING_STAT_DRAIN_NS,		/* time spent in drains */
+	RING_STATS
+};
+
+typedef struct EclipseRing EclipseRing;
+
+/* Called for each frame received, payload points into the ring and is valid until it returns */
+typedef void (*RingHandler)(void* context, unsigned int type, unsigned long long id, const void* payload, unsigned int length);
+
+/**
+ * Creates a ring pair with capacity bytes of data each way. The capacity
+ * is rounded up to a power of two within RING_MIN_CAPACITY and
+ * RING_MAX_CAPACITY. Free it with destroyRing().
+ *
+ * Returns NULL if out of memory.
+ */
+extern EclipseRing* createRing(size_t capacity);
+
+extern void destroyRing(EclipseRing* ring);
+
+/**
+ * Gets the block to hand to Java and its size in bytes.
+ */
+extern void* getRingMemory(EclipseRing* ring, size_t* size);
+
+/**
+ * Gets the largest payload that fits in the ring once it is empty,
+ * wherever its indices are; longer messages have to be sent in pieces.
+ */
+extern unsigned int getRingMaxPayload(EclipseRing* ring);
+
+/**
+ * Sends a frame towards Java, from any thread.
+ *
+ * Returns 1 if Java has to be woken up, 0 if not, -1 if the frame does not
+ * fit in the free space.
+ */
+extern int sendRing(EclipseRing* ring, unsigned int type, unsigned long long id, const void* payload, unsigned int length);
+
+/**
+ * Passes the frames Java sent to handler, in order, until the ring is
+ * empty or the handler asks to stop with stopRing(). Only one thread may
+ * drain at a time.
+ *
+ * Returns the number of frames handled.
+ */
+extern int drainRing(EclipseRing* ring, RingHandler handler, void* context);
+
+/**
+ * Makes drainRing() return before the frame being handled, which is
+ * passed to the handler again by the next drain.
+ */
+extern void stopRing(EclipseRing* ring);
+
+/**
+ * Adds to one of the RING_STAT_* counters.
+ */
+extern void countRing(EclipseRing* ring, int stat, long long value);
+
+extern long long getRingStat(EclipseRing* ring, int stat);
+
+#endif /* ECLIPSE_RING_H */
@@ -37,9 +37,11 @@ SOFTWARE.
 #define ERT_JSONSAXCONSUMER_H_
 
 // Standard
+#include <cctype>
 #include <iomanip>
 #include <sstream>
-#include <stack>
+#include <string>
+#include <vector>
 #include<locale>
 #include<codecvt>
 
@@ -47,23 +49,193 @@ SOFTWARE.
 #include "json.hpp"
 
 namespace ert {
+	/**
+	* Builds xml from nlohmann sax events:
+	*
+	* - an object under a key becomes an element named after the key, the outer object is not an element
+	* - a key starting with the attribute prefix becomes an attribute of the enclosing element
+	* - an array repeats the element of its key once per item
+	* - a scalar under a plain key becomes an element with the scalar as its text
+	*
+	* An xml document has one root element, so input whose outer object (or the objects of an outer array) hold
+	* more than one element between them is rejected: the sax callback returns false and so does sax_parse.
+	*
+	* Layout JSON comes from remote pages, so the output is kept well formed for any input:
+	* names are sanitized, values escaped, repeated attributes, attributes that arrive after the first child and
+	* objects or arrays under an attribute key are dropped.
+	*/
 	class JsonSaxConsumer : public nlohmann::json::json_sax_t
 	{
+		enum frame_kind { ROOT, ROOT_ARRAY, ELEMENT, ARRAY, SKIP };
+
+		struct frame {
+			frame_kind kind;
+			std::string name; // element name, or the name of the items of an array
+			std::string attributes; // pending until the start tag is written
+			bool has_children;
+		};
+
 		// private members
 		int tab_spaces_;
 		char attr_prefix_;
-		bool has_attributes_;
-		int indent_;
 		std::stringstream result_;
-		std::stringstream current_object_;
-		std::stack<std::string> nodes_stack_;
+		std::vector<frame> frames_;
+		int depth_; // element frames in frames_
+		int roots_; // elements written at depth 0
 		std::string key_;
+		bool key_is_attribute_;
 
 		// private functions
-		const std::string& get_top() {
-			return nodes_stack_.top();
+		static std::string sanitize_name(const std::string& name) {
+			std::string result = name;
+			for (std::size_t i = 0; i < result.size(); i++) {
+				unsigned char ch = (unsigned char)result[i];
+				bool valid = ch >= 0x80 || isalnum(ch) || ch == '_' || ch == '-' || ch == '.';
+				if (!valid) result[i] = '_';
+			}
+			if (result.empty() || isdigit((unsigned char)result[0]) || result[0] == '-' || result[0] == '.')
+				result.insert(result.begin(), '_');
+			return result;
+		}
+
+		static std::string escape(const std::string& val, bool attribute) {
+			std::string result;
+			result.reserve(val.size());
+			for (std::size_t i = 0; i < val.size(); i++) {
+				unsigned char ch = (unsigned char)val[i];
+				switch (ch) {
+				case '&': result += "&amp;"; break;
+				case '<': result += "&lt;"; break;
+				case '>': result += "&gt;"; break;
+				case '"':
+					if (attribute) result += "&quot;";
+					else result += '"';
+					break;
+				case '\t':
+				case '\n':
+					// msxml normalizes these to spaces in attribute values, cmarkup keeps them
+					if (attribute) result += ch == '\t' ? "&#9;" : "&#10;";
+					else result += (char)ch;
+					break;
+				case '\r':
+					// and a line break to a plain \n in text as well
+					result += "&#13;";
+					break;
+				default:
+					// not even a character reference may carry these in xml 1.0
+					if (ch >= 0x20) result += (char)ch;
+					break;
+				}
+			}
+			return result;
+		}
+
+		std::string indent() const {
+			// the outer object is not an element, so it adds no indentation
+			return std::string(depth_ * tab_spaces_, ' ');
+		}
+
+		// writes the start tag of the enclosing element before its first child
+		void open_parent() {
+			for (std::size_t i = frames_.size(); i-- > 0;) {
+				if (frames_[i].kind == ARRAY) continue;
+				if (frames_[i].kind == ELEMENT && !frames_[i].has_children) {
+					result_ << frames_[i].attributes << ">";
+					frames_[i].attributes.clear();
+					frames_[i].has_children = true;
+				}
+				return;
+			}
+		}
+
+		void new_line() {
+			if (result_.tellp() > 0) result_ << "\n";
+			result_ << indent();
+		}
+
+		bool skipping() const {
+			return !frames_.empty() && frames_.back().kind == SKIP;
+		}
+
+		// name of the element the next value makes, false when it makes none
+		bool value_name(std::string& name) {
+			if (frames_.empty()) return false;
+			const frame& top = frames_.back();
+			if (top.kind == ARRAY) {
+				name = top.name;
+				return true;
+			}
+			if (top.kind == ELEMENT || top.kind == ROOT) {
+				name = key_;
+				return true;
+			}
+			return false;
+		}
+
+		// false for a second root element
+		bool add_element() {
+			return depth_ > 0 || roots_++ == 0;
+		}
+
+		bool scalar(const std::string& val, bool is_null) {
+			if (skipping()) return true;
+			if (!frames_.empty() && frames_.back().kind != ARRAY && key_is_attribute_) {
+				key_is_attribute_ = false;
+				frame& top = frames_.back();
+				// a repeated attribute keeps its first value
+				if (top.kind == ELEMENT && !top.has_children && top.attributes.find(" " + key_ + "=\"") == std::string::npos)
+					top.attributes += " " + key_ + "=\"" + escape(val, true) + "\"";
+				return true;
+			}
+			std::string name;
+			if (!value_name(name)) return true;
+			if (!add_element()) return false;
+			open_parent();
+			new_line();
+			if (is_null) result_ << "<" << name << "/>";
+			else result_ << "<" << name << ">" << escape(val, false) << "</" << name << ">";
+			return true;
+		}
+
+		bool start(frame_kind kind) {
+			frame f;
+			f.has_children = false;
+			if (skipping() || (!frames_.empty() && frames_.back().kind != ARRAY && key_is_attribute_)) {
+				f.kind = SKIP;
+			}
+			else if (frames_.empty() || frames_.back().kind == ROOT_ARRAY) {
+				// the outer value, or an item of an outer array
+				f.kind = kind == ELEMENT ? ROOT : ROOT_ARRAY;
+			}
+			else {
+				value_name(f.name);
+				f.kind = kind;
+				if (kind == ELEMENT) {
+					if (!add_element()) return false;
+					open_parent();
+					new_line();
+					result_ << "<" << f.name;
+				}
+			}
+			key_is_attribute_ = false;
+			if (f.kind == ELEMENT) depth_++;
+			frames_.push_back(f);
+			return true;
 		}
 
+		void end() {
+			if (frames_.empty()) return;
+			frame f = frames_.back();
+			frames_.pop_back();
+			if (f.kind != ELEMENT) return;
+			depth_--;
+			if (!f.has_children) {
+				result_ << f.attributes << "/>";
+			}
+			else {
+				result_ << "\n" << indent() << "</" << f.name << ">";
+			}
+		}
 
 	public:
 
@@ -76,8 +248,9 @@ namespace ert {
 		JsonSaxConsumer(int tabSpaces = 4, char attrPrefix = '@') :
 			tab_spaces_(tabSpaces >= 1 ? tabSpaces : 4),
 			attr_prefix_(attrPrefix),
-			has_attributes_(false),
-			indent_(-tab_spaces_) {};
+			depth_(0),
+			roots_(0),
+			key_is_attribute_(false) {};
 
 		/**
 		* Returns the resulting xml stringstream representation
@@ -96,44 +269,32 @@ namespace ert {
 		// nlohmann sax virtual methods
 		bool null() override
 		{
-			current_object_ << "<null>";
-			has_attributes_ = true;
-			return true;
+			return scalar("", true);
 		}
 
 		bool boolean(bool val) override
 		{
-			current_object_ << std::quoted(val ? "true" : "false");
-			has_attributes_ = true;
-			return true;
+			return scalar(val ? "true" : "false", false);
 		}
 
 		bool number_integer(number_integer_t val) override
 		{
-			current_object_ << std::quoted(std::to_string(val));
-			has_attributes_ = true;
-			return true;
+			return scalar(std::to_string(val), false);
 		}
 
 		bool number_unsigned(number_unsigned_t val) override
 		{
-			current_object_ << std::quoted(std::to_string(val));
-			has_attributes_ = true;
-			return true;
+			return scalar(std::to_string(val), false);
 		}
 
 		bool number_float(number_float_t val, const string_t& s) override
 		{
-			current_object_ << std::quoted(s);
-			has_attributes_ = true;
-			return true;
+			return scalar(s, false);
 		}
 
 		bool string(string_t& val) override
 		{
-			current_object_ << std::quoted(val);
-			has_attributes_ = true;
-			return true;
+			return scalar(val, false);
 		}
 		//bool binary(binary_t& val) override
 		//{
@@ -144,63 +305,30 @@ namespace ert {
 
 		bool start_object(std::size_t elements) override
 		{
-			if (key_ == "") return true; // global object condition (first start object)
-			nodes_stack_.push(key_); // push on starts
-			indent_ += tab_spaces_; // increase indentation on object start
-
-			if (indent_ != 0) {
-				// New object when previous hadn't attributes:
-				if (current_object_.str().empty() && !has_attributes_) result_ << ">";
-				result_ << "\n";
-			}
-			result_ << std::string(indent_, ' ') << "<" << get_top();
-
-			has_attributes_ = false;
-			return true;
+			return start(ELEMENT);
 		}
 
 		bool end_object() override
 		{
-			if (indent_ < 0) return true;
-			if (current_object_.str().empty()) {
-				result_ << "\n" << std::string(indent_, ' ') << "</" << get_top() << ">";
-			}
-			else {
-				result_ << current_object_.str() << "/>";
-				current_object_.str("");
-			}
-
-			nodes_stack_.pop(); // pop on ends
-			indent_ -= tab_spaces_; // decrease indentation on object end
+			end();
 			return true;
 		}
 
 		bool start_array(std::size_t elements) override
 		{
-			nodes_stack_.push(key_); // push on starts
-
-			result_ << current_object_.str();
-
-			current_object_.str("");
-			has_attributes_ = false;
-
-			return true;
+			return start(ARRAY);
 		}
 
 		bool end_array() override
 		{
-			nodes_stack_.pop(); // pop on ends
+			end();
 			return true;
 		}
 
 		bool key(string_t& val) override
 		{
-			if (val[0] != attr_prefix_) {
-				key_ = val;
-			}
-			else {
-				current_object_ << " " << val.substr(1) << "=";
-			}
+			key_is_attribute_ = !val.empty() && val[0] == attr_prefix_;
+			key_ = sanitize_name(key_is_attribute_ ? val.substr(1) : val);
 			return true;
 		}
 
@@ -214,4 +342,3 @@ namespace ert {
 }
 
 #endif
-
@@ -0,0 +1,188 @@
+// EclipseCdsTest.cpp : the CDS archive across launches on the stub JVM
+//
+// Each launch goes the way eclipse.cpp takes it: openCdsArchive(),
+// startJavaJNI() and cleanupVM(). The stub writes the archive named by
+// -XX:ArchiveClassesAtExit when its VM exits, as HotSpot does, so a dumping
+// launch has to end its VM before the archive counts, and an archive counts
+// only once it is on disk.
+
+#include "stdafx.h"
+#include "StubJvm.h"
+#include "eclipseOS.h"
+#include "eclipseCds.h"
+#include "TestCheck.h"
+
+static const char* const s_pszArchive = "out/EclipseCdsTest.jsa";
+static const char* const s_pszState = "out/EclipseCdsTest.jsa.state";
+static const string s_strDumpOption = string("-XX:ArchiveClassesAtExit=") + s_pszArchive;
+static const string s_strUseOption = string("-XX:SharedArchiveFile=") + s_pszArchive;
+
+struct CdsTestState
+{
+	unsigned long long m_nKey = 0;
+	int m_nValid = -1;
+	string m_strVm;
+	long long m_nStartups[2] = { 0, 0 };
+};
+
+static CdsTestState ReadState()
+{
+	CdsTestState state;
+	FILE* pFile = fopen(s_pszState, "r");
+	if (pFile == NULL)
+		return state;
+	char szVm[128] = "";
+	long long nLast, nTotal;
+	fscanf(pFile, "key %llx\nvalid %d\nvm %127s\nwithout %lld %lld %lld\nwith %lld %lld %lld\n",
+		&state.m_nKey, &state.m_nValid, szVm, &state.m_nStartups[0], &nLast, &nTotal, &state.m_nStartups[1], &nLast, &nTotal);
+	fclose(pFile);
+	state.m_strVm = szVm;
+	return state;
+}
+
+static bool ArchiveExists()
+{
+	FILE* pFile = fopen(s_pszArchive, "rb");
+	if (pFile == NULL)
+		return false;
+	fclose(pFile);
+	return true;
+}
+
+static bool HasOption(const string& strOption)
+{
+	for (auto& it : CStubJvm::Instance().GetOptions())
+	{
+		if (it == strOption)
+			return true;
+	}
+	return false;
+}
+
+struct CdsLaunch
+{
+	jint m_nRun = 0;				// what the workbench returns
+	bool m_bDump = true;			// the VM writes the archive when asked to
+	bool m_bMapFails = false;		// the VM is not created with the archive
+	const char* m_pszVmInfo = "mixed mode, sharing";
+};
+
+// what the archive state said while the VM exited
+static int s_nValidAtExit;
+
+static int Launch(unsigned long long nKey, const CdsLaunch& launch)
+{
+	CStubJvm& jvm = CStubJvm::Instance();
+	jvm.Reset();
+	jvm.DefineWorkbench([launch](jobjectArray) { return launch.m_nRun; });
+	jvm.m_mapProperties["java.vm.info"] = launch.m_pszVmInfo;
+	jvm.m_pfnCreate = [launch](const vector<string>& vOptions) {
+		return launch.m_bMapFails && HasOption(s_strUseOption) ? JNI_ERR : JNI_OK;
+	};
+	jvm.m_pfnExit = [launch]() {
+		s_nValidAtExit = ReadState().m_nValid;
+		if (!launch.m_bDump || !HasOption(s_strDumpOption))
+			return;
+		FILE* pFile = fopen(s_pszArchive, "wb");
+		if (pFile)
+		{
+			fputs("classes", pFile);
+			fclose(pFile);
+		}
+	};
+	s_nValidAtExit = -1;
+
+	_TCHAR* vmArgs[] = { (_TCHAR*)"-Xmx512m", NULL };
+	_TCHAR* progArgs[] = { NULL };
+	openCdsArchive(s_pszArchive, nKey, vmArgs);
+	int nMode = cdsMode;
+	JavaResults* results = startJavaJNI((_TCHAR*)"jvm.so", vmArgs, progArgs, (_TCHAR*)"launcher.jar");
+	CHECK_EQ(results->launchResult, 0);
+	CHECK_EQ(results->runResult, launch.m_nRun);
+	cleanupVM(results->launchResult ? results->launchResult : results->runResult);
+	free(results->errorMessage);
+	free(results);
+	return nMode;
+}
+
+int main()
+{
+	CStubJvm& jvm = CStubJvm::Instance();
+	remove(s_pszArchive);
+	remove(s_pszState);
+
+	// the first launch dumps, its VM is ended for it and the archive counts
+	// once it is there, not before
+	CdsLaunch normal;
+	CHECK_EQ(Launch(1, normal), CDS_DUMP);
+	CHECK(HasOption(s_strDumpOption));
+	CHECK_EQ(jvm.GetExits(), 1);
+	CHECK_EQ(s_nValidAtExit, 0);
+	CHECK(ArchiveExists());
+	CdsTestState state = ReadState();
+	CHECK_EQ(state.m_nKey, 1);
+	CHECK_EQ(state.m_nValid, 1);
+	CHECK(state.m_strVm == "17.0.8+7");
+	CHECK_EQ(state.m_nStartups[0], 1);
+
+	// the next one maps it and leaves its VM alone
+	CHECK_EQ(Launch(1, normal), CDS_USE);
+	CHECK(HasOption(s_strUseOption));
+	CHECK_EQ(jvm.GetExits(), 0);
+	state = ReadState();
+	CHECK_EQ(state.m_nValid, 1);
+	CHECK_EQ(state.m_nStartups[1], 1);
+
+	// another key dumps again; a VM that writes nothing leaves no valid
+	// archive, and the launch after it tries again
+	CdsLaunch noDump;
+	noDump.m_bDump = false;
+	CHECK_EQ(Launch(2, noDump), CDS_DUMP);
+	CHECK_EQ(jvm.GetExits(), 1);
+	CHECK(!ArchiveExists());
+	CHECK_EQ(ReadState().m_nValid, 0);
+	CHECK_EQ(Launch(2, normal), CDS_DUMP);
+	CHECK_EQ(ReadState().m_nValid, 1);
+	CHECK_EQ(Launch(2, normal), CDS_USE);
+
+	// a failed run keeps no archive and does not end its VM for one
+	CdsLaunch failed;
+	failed.m_nRun = 13;
+	CHECK_EQ(Launch(3, failed), CDS_DUMP);
+	CHECK_EQ(jvm.GetExits(), 0);
+	CHECK_EQ(ReadState().m_nValid, 0);
+	CHECK_EQ(Launch(3, normal), CDS_DUMP);
+	CHECK_EQ(ReadState().m_nValid, 1);
+
+	// a VM not created with the archive is created without it, and the
+	// archive is dropped
+	CdsLaunch mapFails;
+	mapFails.m_bMapFails = true;
+	CHECK_EQ(Launch(3, mapFails), CDS_USE);
+	CHECK(!HasOption(s_strUseOption));
+	CHECK_EQ(cdsMode, CDS_OFF);
+	CHECK(!ArchiveExists());
+	CHECK_EQ(ReadState().m_nValid, 0);
+	CHECK_EQ(Launch(3, normal), CDS_DUMP);
+	CHECK_EQ(ReadState().m_nValid, 1);
+
+	// a VM that runs without sharing drops the archive
+	CdsLaunch noSharing;
+	noSharing.m_pszVmInfo = "mixed mode";
+	CHECK_EQ(Launch(3, noSharing), CDS_USE);
+	CHECK_EQ(cdsMode, CDS_OFF);
+	CHECK_EQ(jvm.GetExits(), 0);
+	CHECK_EQ(ReadState().m_nValid, 0);
+	CHECK_EQ(Launch(3, normal), CDS_DUMP);
+
+	// arguments that set up sharing themselves leave it to them
+	jvm.Reset();
+	_TCHAR* sharedArgs[] = { (_TCHAR*)"-Xshare:off", NULL };
+	openCdsArchive(s_pszArchive, 3, sharedArgs);
+	CHECK_EQ(cdsMode, CDS_OFF);
+	CHECK(getCdsOption() == NULL);
+
+	remove(s_pszArchive);
+	remove(s_pszState);
+	return TestResult("EclipseCdsTest");
+}
@@ -0,0 +1,312 @@
+// EclipseConfigTest.cpp : the launch configuration model of eclipseConfig.cpp
+//
+// Layers of launcher ini, configuration ini, command line and .ee file as
+// the launcher adds them: which setting wins, when the command line -vmargs
+// replace the ini ones, the problems validateLaunchConfig() finds in them
+// and a configuration that comes back from saveLaunchConfig() unchanged.
+
+#include "stdafx.h"
+#include "eclipseOS.h"
+#include "eclipseConfig.h"
+#include "TestCheck.h"
+
+static const char* const s_pszSaved = "out/EclipseConfigTest.cfg";
+
+// the setting at index, NULL for -1
+static ConfigSetting* At(LaunchConfig* config, int nIndex)
+{
+	return nIndex >= 0 && nIndex < config->count ? &config->settings[nIndex] : NULL;
+}
+
+static ConfigSetting* Used(LaunchConfig* config, int nKind, const char* pszName)
+{
+	return At(config, findConfigSetting(config, nKind, pszName));
+}
+
+// the index of the n-th setting with the name, whether used or not
+static int IndexOf(LaunchConfig* config, int nKind, const char* pszName, int n = 0)
+{
+	for (int i = 0; i < config->count; i++)
+	{
+		if (config->settings[i].kind == nKind && strcmp(config->settings[i].name, pszName) == 0 && n-- == 0)
+			return i;
+	}
+	return -1;
+}
+
+static bool Same(const char* psz1, const char* psz2)
+{
+	return psz1 == NULL || psz2 == NULL ? psz1 == psz2 : strcmp(psz1, psz2) == 0;
+}
+
+static string Explain(LaunchConfig* config, const char* pszName)
+{
+	_TCHAR* pszText = explainLaunchConfig(config, pszName);
+	string strText = pszText;
+	free(pszText);
+	return strText;
+}
+
+static string Diff(LaunchConfig* before, LaunchConfig* after)
+{
+	_TCHAR* pszText = diffLaunchConfigs(before, after);
+	string strText = pszText;
+	free(pszText);
+	return strText;
+}
+
+// the launcher ini, the configuration ini and the .ee file of every case
+static LaunchConfig* Layers(int nAppendVmargs)
+{
+	_TCHAR* ini[] = { (_TCHAR*)"-data", (_TCHAR*)"/ws", (_TCHAR*)"-showsplash", (_TCHAR*)"-vmargs",
+		(_TCHAR*)"-Xmx1g", (_TCHAR*)"-Xms512m", (_TCHAR*)"-Dfoo=1", (_TCHAR*)"--add-opens", (_TCHAR*)"java.base/a=ALL",
+		(_TCHAR*)"-XX:+UseG1GC", NULL };
+	_TCHAR* configIni[] = { (_TCHAR*)"-vmargs", (_TCHAR*)"-Xmx2g", (_TCHAR*)"--add-opens", (_TCHAR*)"java.base/b=ALL", NULL };
+	_TCHAR* ee[] = { (_TCHAR*)"-Dee.executable=bin/java", (_TCHAR*)"-Xss4m", NULL };
+	LaunchConfig* config = newLaunchConfig(nAppendVmargs);
+	addConfigArgs(config, CONFIG_LAUNCHER_INI, "eclipse.ini", ini);
+	addConfigArgs(config, CONFIG_CONFIG_INI, NULL, configIni);
+	addConfigArgs(config, CONFIG_EE_FILE, "jdk.ee", ee);
+	return config;
+}
+
+static void TestOverrides()
+{
+	LaunchConfig* config = Layers(0);
+	_TCHAR* commandLine[] = { (_TCHAR*)"-data", (_TCHAR*)"/other", (_TCHAR*)"file.txt", NULL };
+	addConfigArgs(config, CONFIG_COMMAND_LINE, NULL, commandLine);
+
+	// program options: the last layer wins, values are the next argument
+	ConfigSetting* data = Used(config, CONFIG_PROGRAM_OPTION, "-data");
+	CHECK(data != NULL && data->source == CONFIG_COMMAND_LINE && Same(data->value, "/other") && Same(data->arg, "-data /other"));
+	ConfigSetting* iniData = At(config, IndexOf(config, CONFIG_PROGRAM_OPTION, "-data"));
+	CHECK(iniData != NULL && iniData->source == CONFIG_LAUNCHER_INI && Same(iniData->file, "eclipse.ini") && iniData->position == 0);
+	CHECK(iniData != NULL && iniData->overriddenBy == findConfigSetting(config, CONFIG_PROGRAM_OPTION, "-data"));
+	ConfigSetting* splash = Used(config, CONFIG_PROGRAM_OPTION, "-showsplash");
+	CHECK(splash != NULL && splash->value == NULL && splash->position == 2);
+	ConfigSetting* file = Used(config, CONFIG_PROGRAM_OPTION, "file.txt");
+	CHECK(file != NULL && file->repeatable && file->position == 2);
+
+	// VM options: the configuration ini overrides the launcher ini, the
+	// command line has none, so none are replaced
+	ConfigSetting* xmx = Used(config, CONFIG_VM_OPTION, "-Xmx");
+	CHECK(xmx != NULL && xmx->source == CONFIG_CONFIG_INI && xmx->file == NULL && Same(xmx->value, "2g") && xmx->position == 1);
+	CHECK_EQ(config->settings[IndexOf(config, CONFIG_VM_OPTION, "-Xmx")].overriddenBy, findConfigSetting(config, CONFIG_VM_OPTION, "-Xmx"));
+	ConfigSetting* xms = Used(config, CONFIG_VM_OPTION, "-Xms");
+	CHECK(xms != NULL && Same(xms->value, "512m") && xms->position == 5);
+	ConfigSetting* foo = Used(config, CONFIG_VM_OPTION, "-Dfoo");
+	CHECK(foo != NULL && Same(foo->value, "1"));
+	ConfigSetting* g1 = Used(config, CONFIG_VM_OPTION, "-XX:UseG1GC");
+	CHECK(g1 != NULL && Same(g1->value, "+") && Same(g1->arg, "-XX:+UseG1GC"));
+
+	// repeatable options add up, each of them is used
+	int nFirst = IndexOf(config, CONFIG_VM_OPTION, "--add-opens");
+	int nSecond = IndexOf(config, CONFIG_VM_OPTION, "--add-opens", 1);
+	CHECK(nFirst >= 0 && nSecond > nFirst);
+	if (nFirst >= 0 && nSecond >= 0)
+	{
+		CHECK(config->settings[nFirst].repeatable && config->settings[nFirst].overriddenBy == CONFIG_EFFECTIVE);
+		CHECK(Same(config->settings[nFirst].value, "java.base/a=ALL") && Same(config->settings[nFirst].arg, "--add-opens java.base/a=ALL"));
+		CHECK(config->settings[nSecond].overriddenBy == CONFIG_EFFECTIVE && Same(config->settings[nSecond].value, "java.base/b=ALL"));
+	}
+	CHECK_EQ(findConfigSetting(config, CONFIG_VM_OPTION, "--add-opens"), nSecond);
+
+	// everything in the .ee file is a VM option, -Dee.* are EE properties
+	ConfigSetting* executable = Used(config, CONFIG_EE_PROPERTY, "-Dee.executable");
+	CHECK(executable != NULL && executable->source == CONFIG_EE_FILE && Same(executable->value, "bin/java") && Same(executable->file, "jdk.ee"));
+	CHECK_EQ(findConfigSetting(config, CONFIG_VM_OPTION, "-Dee.executable"), -1);
+	ConfigSetting* xss = Used(config, CONFIG_VM_OPTION, "-Xss");
+	CHECK(xss != NULL && xss->source == CONFIG_EE_FILE && xss->position == 1);
+
+	CHECK(Explain(config, "-data") ==
+		"-data (program option)\n"
+		"  overridden  -data /ws  (launcher ini eclipse.ini, argument 1)\n"
+		"  used        -data /other  (command line, argument 1)\n");
+	CHECK(Explain(config, "-Xmx4g") ==
+		"-Xmx (VM option)\n"
+		"  overridden  -Xmx1g  (launcher ini eclipse.ini, argument 5)\n"
+		"  used        -Xmx2g  (configuration ini, argument 2)\n");
+	CHECK(Explain(config, "--add-opens") ==
+		"--add-opens (VM option)\n"
+		"  added       --add-opens java.base/a=ALL  (launcher ini eclipse.ini, argument 8)\n"
+		"  added       --add-opens java.base/b=ALL  (configuration ini, argument 3)\n");
+	CHECK(Explain(config, "-nope") == "-nope is not set\n");
+	freeLaunchConfig(config);
+}
+
+static void TestReplace()
+{
+	// command line -vmargs replace the VM options of both ini files, not
+	// those of the .ee file, and not the program options
+	LaunchConfig* config = Layers(0);
+	_TCHAR* commandLine[] = { (_TCHAR*)"-vmargs", (_TCHAR*)"-Xmx4g", NULL };
+	addConfigArgs(config, CONFIG_COMMAND_LINE, NULL, commandLine);
+	ConfigSetting* xmx = Used(config, CONFIG_VM_OPTION, "-Xmx");
+	CHECK(xmx != NULL && xmx->source == CONFIG_COMMAND_LINE && Same(xmx->value, "4g"));
+	CHECK_EQ(findConfigSetting(config, CONFIG_VM_OPTION, "-Xms"), -1);
+	CHECK_EQ(findConfigSetting(config, CONFIG_VM_OPTION, "-Dfoo"), -1);
+	CHECK_EQ(findConfigSetting(config, CONFIG_VM_OPTION, "--add-opens"), -1);
+	CHECK_EQ(config->settings[IndexOf(config, CONFIG_VM_OPTION, "-Xmx")].overriddenBy, CONFIG_REPLACED);
+	CHECK_EQ(config->settings[IndexOf(config, CONFIG_VM_OPTION, "-Xmx", 1)].overriddenBy, CONFIG_REPLACED);
+	CHECK(Used(config, CONFIG_VM_OPTION, "-Xss") != NULL);
+	CHECK(Used(config, CONFIG_EE_PROPERTY, "-Dee.executable") != NULL);
+	CHECK(Used(config, CONFIG_PROGRAM_OPTION, "-data") != NULL);
+	CHECK(Explain(config, "-Xmx") ==
+		"-Xmx (VM option)\n"
+		"  replaced    -Xmx1g  (launcher ini eclipse.ini, argument 5, replaced by the command line -vmargs)\n"
+		"  replaced    -Xmx2g  (configuration ini, argument 2, replaced by the command line -vmargs)\n"
+		"  used        -Xmx4g  (command line, argument 2)\n");
+	freeLaunchConfig(config);
+
+	// with --launcher.appendVmargs they are added, a command line option
+	// only overrides its own name
+	config = Layers(1);
+	addConfigArgs(config, CONFIG_COMMAND_LINE, NULL, commandLine);
+	xmx = Used(config, CONFIG_VM_OPTION, "-Xmx");
+	CHECK(xmx != NULL && xmx->source == CONFIG_COMMAND_LINE);
+	CHECK_EQ(config->settings[IndexOf(config, CONFIG_VM_OPTION, "-Xmx")].overriddenBy, findConfigSetting(config, CONFIG_VM_OPTION, "-Xmx"));
+	CHECK(Used(config, CONFIG_VM_OPTION, "-Xms") != NULL);
+	CHECK(Used(config, CONFIG_VM_OPTION, "-Dfoo") != NULL);
+	CHECK(IndexOf(config, CONFIG_VM_OPTION, "--add-opens", 1) == findConfigSetting(config, CONFIG_VM_OPTION, "--add-opens"));
+	freeLaunchConfig(config);
+}
+
+static void TestValidate()
+{
+	ConfigProblem* problems = NULL;
+
+	// layers overriding each other are no problem
+	LaunchConfig* config = Layers(0);
+	CHECK_EQ(validateLaunchConfig(config, &problems), 0);
+	freeConfigProblems(problems, 0);
+	freeLaunchConfig(config);
+
+	_TCHAR* ini[] = { (_TCHAR*)"-vmargs", (_TCHAR*)"-Xmx1g", (_TCHAR*)"-Xms2g", (_TCHAR*)"-Dfoo=1", (_TCHAR*)"-Dfoo=2",
+		(_TCHAR*)"--add-opens", (_TCHAR*)"java.base/a=ALL", (_TCHAR*)"--add-opens", (_TCHAR*)"java.base/a=ALL",
+		(_TCHAR*)"-XX:+UseG1GC", (_TCHAR*)"-XX:+UseZGC", (_TCHAR*)"-Xmx1g", NULL };
+	_TCHAR* ee[] = { (_TCHAR*)"-Xshare:off", (_TCHAR*)"-XX:SharedArchiveFile=app.jsa", NULL };
+	config = newLaunchConfig(0);
+	addConfigArgs(config, CONFIG_LAUNCHER_INI, "eclipse.ini", ini);
+	addConfigArgs(config, CONFIG_EE_FILE, "jdk.ee", ee);
+	int nCount = validateLaunchConfig(config, &problems);
+	CHECK_EQ(nCount, 6);
+	if (nCount == 6)
+	{
+		int nXmx = IndexOf(config, CONFIG_VM_OPTION, "-Xmx");
+		CHECK_EQ(problems[0].error, 0);
+		CHECK(problems[0].setting == nXmx && problems[0].other == IndexOf(config, CONFIG_VM_OPTION, "-Xmx", 1));
+		CHECK(string(problems[0].message) == "-Xmx is set twice in the launcher ini");
+		CHECK_EQ(problems[1].error, 1);
+		CHECK(string(problems[1].message) == "-Dfoo is set to -Dfoo=1 and -Dfoo=2 in the launcher ini, the second one is used");
+		CHECK_EQ(problems[2].error, 0);
+		CHECK(string(problems[2].message) == "--add-opens is set twice in the launcher ini");
+		CHECK_EQ(problems[3].error, 1);
+		CHECK(problems[3].setting == IndexOf(config, CONFIG_VM_OPTION, "-Xms") && problems[3].other == findConfigSetting(config, CONFIG_VM_OPTION, "-Xmx"));
+		CHECK(string(problems[3].message) == "-Xms2g is more than -Xmx1g, the VM will not start");
+		CHECK(string(problems[4].message) == "-XX:+UseG1GC and -XX:+UseZGC select two garbage collectors");
+		CHECK(string(problems[5].message) == "-XX:SharedArchiveFile=app.jsa is not used with -Xshare:off");
+	}
+	freeConfigProblems(problems, nCount);
+	freeLaunchConfig(config);
+
+	// a collector turned off and sizes that can not be read are fine
+	_TCHAR* fine[] = { (_TCHAR*)"-vmargs", (_TCHAR*)"-XX:+UseG1GC", (_TCHAR*)"-XX:-UseZGC", (_TCHAR*)"-Xms2g", (_TCHAR*)"-Xmxlots", NULL };
+	config = newLaunchConfig(0);
+	addConfigArgs(config, CONFIG_LAUNCHER_INI, "eclipse.ini", fine);
+	CHECK_EQ(validateLaunchConfig(config, &problems), 0);
+	freeConfigProblems(problems, 0);
+	freeLaunchConfig(config);
+}
+
+static void TestSaveLoad()
+{
+	LaunchConfig* config = Layers(0);
+	string strLong(3000, 'p');
+	string strLongArg = "-Dlong=" + strLong;
+	_TCHAR* commandLine[] = { (_TCHAR*)"-data", (_TCHAR*)"/other", (_TCHAR*)"-vmargs", (_TCHAR*)"-Dempty=",
+		(_TCHAR*)"-Dtab=a\tb", (_TCHAR*)strLongArg.c_str(), (_TCHAR*)"-Xmx4g", NULL };
+	addConfigArgs(config, CONFIG_COMMAND_LINE, NULL, commandLine);
+
+	remove(s_pszSaved);
+	CHECK_EQ(saveLaunchConfig(config, s_pszSaved), 0);
+	LaunchConfig* loaded = loadLaunchConfig(s_pszSaved);
+	CHECK(loaded != NULL);
+	if (loaded == NULL)
+	{
+		freeLaunchConfig(config);
+		return;
+	}
+
+	// every field comes back, tabs in values as spaces
+	CHECK_EQ(loaded->count, config->count);
+	CHECK_EQ(loaded->appendVmargs, config->appendVmargs);
+	for (int i = 0; i < config->count && i < loaded->count; i++)
+	{
+		ConfigSetting* setting = &config->settings[i];
+		ConfigSetting* other = &loaded->settings[i];
+		CHECK(setting->kind == other->kind && setting->source == other->source && setting->position == other->position);
+		CHECK(setting->repeatable == other->repeatable && setting->overriddenBy == other->overriddenBy);
+		CHECK(Same(setting->file, other->file) && Same(setting->name, other->name));
+		if (strcmp(setting->name, "-Dtab") == 0)
+		{
+			CHECK(Same(other->value, "a b") && Same(other->arg, "-Dtab=a b"));
+			continue;
+		}
+		CHECK(Same(setting->value, other->value) && Same(setting->arg, other->arg));
+	}
+	ConfigSetting* empty = Used(loaded, CONFIG_VM_OPTION, "-Dempty");
+	CHECK(empty != NULL && Same(empty->value, ""));
+	CHECK(Used(loaded, CONFIG_PROGRAM_OPTION, "-showsplash") != NULL && Used(loaded, CONFIG_PROGRAM_OPTION, "-showsplash")->value == NULL);
+	ConfigSetting* loadedLong = Used(loaded, CONFIG_VM_OPTION, "-Dlong");
+	CHECK(loadedLong != NULL && Same(loadedLong->value, strLong.c_str()));
+	CHECK(Diff(config, loaded) == "- -Dtab=a\tb  (command line, argument 5)\n+ -Dtab=a b  (command line, argument 5)\n");
+
+	// what changed since
+	_TCHAR* next[] = { (_TCHAR*)"-vmargs", (_TCHAR*)"-Xmx8g", (_TCHAR*)"-Dadded=1", NULL };
+	LaunchConfig* later = Layers(0);
+	addConfigArgs(later, CONFIG_COMMAND_LINE, NULL, next);
+	CHECK(Diff(loaded, later) ==
+		"- -data /other  (command line, argument 1)\n"
+		"+ -data /ws  (launcher ini eclipse.ini, argument 1)\n"
+		"- -Xmx4g  (command line, argument 7)\n"
+		"+ -Xmx8g  (command line, argument 2)\n"
+		"+ -Dadded=1  (command line, argument 3)\n"
+		"- -Dempty=  (command line, argument 4)\n"
+		"- -Dtab=a b  (command line, argument 5)\n"
+		"- " + strLongArg + "  (command line, argument 6)\n");
+	freeLaunchConfig(later);
+	freeLaunchConfig(loaded);
+	freeLaunchConfig(config);
+
+	// no file, another format or version
+	remove(s_pszSaved);
+	CHECK(loadLaunchConfig(s_pszSaved) == NULL);
+	FILE* pFile = fopen(s_pszSaved, "w");
+	fputs("launchconfig\t2\t0\n0\t2\t0\t0\t1\t\t-data\t/ws\t-data /ws\n", pFile);
+	fclose(pFile);
+	CHECK(loadLaunchConfig(s_pszSaved) == NULL);
+	pFile = fopen(s_pszSaved, "w");
+	fputs("-data\n", pFile);
+	fclose(pFile);
+	CHECK(loadLaunchConfig(s_pszSaved) == NULL);
+
+	// lines that do not make a setting are skipped
+	pFile = fopen(s_pszSaved, "w");
+	fputs("launchconfig\t1\t1\n9\t2\t0\t0\t1\t\t-data\t/ws\t-data /ws\nshort\n1\t2\t1\t0\t1\t\t-Xmx\t1g\t-Xmx1g\n", pFile);
+	fclose(pFile);
+	loaded = loadLaunchConfig(s_pszSaved);
+	CHECK(loaded != NULL && loaded->count == 1 && loaded->appendVmargs == 1);
+	if (loaded != NULL && loaded->count == 1)
+		CHECK(Same(loaded->settings[0].arg, "-Xmx1g") && loaded->settings[0].overriddenBy == CONFIG_EFFECTIVE);
+	freeLaunchConfig(loaded);
+	remove(s_pszSaved);
+}
+
+int main()
+{
+	TestOverrides();
+	TestReplace();
+	TestValidate();
+	TestSaveLoad();
+	return TestResult("EclipseConfigTest");
+}
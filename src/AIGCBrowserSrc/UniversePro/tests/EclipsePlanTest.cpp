@@ -0,0 +1,336 @@
+// EclipsePlanTest.cpp : the launch plans of eclipsePlan.cpp
+//
+// A fake VM directory under out/ stands in for the one the VM search found:
+// its library, the startup jar, the splash bitmap and the .ee file. A plan
+// comes back only for the key it was stored under and only while those files
+// are as they were; a plan file that is cut short or damaged anywhere is
+// refused, never half read.
+
+#include "stdafx.h"
+#include "eclipseOS.h"
+#include "eclipsePlan.h"
+#include "TestCheck.h"
+
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utime.h>
+
+static const char* const s_pszDir = "out/EclipsePlanTest.vm";
+static const char* const s_pszLib = "out/EclipsePlanTest.vm/jvm.so";
+static const char* const s_pszJar = "out/EclipsePlanTest.vm/launcher.jar";
+static const char* const s_pszSplash = "out/EclipsePlanTest.vm/splash.bmp";
+static const char* const s_pszEE = "out/EclipsePlanTest.vm/vm.ee";
+static const char* const s_pszIni = "out/EclipsePlanTest.vm/eclipse.ini";
+static const char* const s_pszPlan = "out/EclipsePlanTest.vm/launch.plan";
+static const char* const s_pszCopy = "out/EclipsePlanTest.vm/copy.plan";
+
+static void WriteFile(const char* pszPath, const string& strData)
+{
+	FILE* pFile = fopen(pszPath, "wb");
+	if (pFile)
+	{
+		fwrite(strData.data(), 1, strData.size(), pFile);
+		fclose(pFile);
+	}
+}
+
+static string ReadFile(const char* pszPath)
+{
+	string strData;
+	FILE* pFile = fopen(pszPath, "rb");
+	if (pFile == NULL)
+		return strData;
+	char szBuffer[4096];
+	size_t nCount;
+	while ((nCount = fread(szBuffer, 1, sizeof(szBuffer), pFile)) > 0)
+		strData.append(szBuffer, nCount);
+	fclose(pFile);
+	return strData;
+}
+
+// moves the modification time, as a later write in the same second would not
+static void Touch(const char* pszPath, long nSeconds)
+{
+	struct stat st;
+	if (stat(pszPath, &st) != 0)
+		return;
+	struct utimbuf times;
+	times.actime = st.st_atime;
+	times.modtime = st.st_mtime + nSeconds;
+	utime(pszPath, &times);
+}
+
+static bool Same(const char* psz1, const char* psz2)
+{
+	return psz1 == NULL || psz2 == NULL ? psz1 == psz2 : strcmp(psz1, psz2) == 0;
+}
+
+static bool SameList(_TCHAR** pList1, _TCHAR** pList2)
+{
+	if (pList1 == NULL || pList2 == NULL)
+		return pList1 == pList2;
+	int i = 0;
+	for (; pList1[i] != NULL && pList2[i] != NULL; i++)
+	{
+		if (strcmp(pList1[i], pList2[i]) != 0)
+			return false;
+	}
+	return pList1[i] == pList2[i];
+}
+
+static unsigned long long Key(const char* pszValue)
+{
+	_TCHAR* values[] = { (_TCHAR*)"-vm", (_TCHAR*)pszValue, NULL };
+	_TCHAR* files[] = { (_TCHAR*)s_pszIni, NULL };
+	_TCHAR* stamps[] = { (_TCHAR*)s_pszDir, NULL };
+	return getLaunchPlanKey(values, files, stamps);
+}
+
+static string s_strEEArg = string("-Dee.filename=") + s_pszEE;
+
+static _TCHAR* s_vmArgs[] = { (_TCHAR*)"-Xmx512m", (_TCHAR*)"-Dee.home=out", (_TCHAR*)s_strEEArg.c_str(), (_TCHAR*)"", NULL };
+static _TCHAR* s_progArgs[] = { (_TCHAR*)"-os", (_TCHAR*)"linux", NULL };
+
+static LaunchPlan MakePlan()
+{
+	LaunchPlan plan;
+	memset(&plan, 0, sizeof(plan));
+	plan.launchMode = 1;
+	plan.jvmVersion = 0x00150000;
+	plan.jniLib = (_TCHAR*)s_pszLib;
+	plan.eeLibPath = NULL;
+	plan.pathPrefix = (_TCHAR*)"/opt/jdk/bin:";
+	plan.startupPrefix = (_TCHAR*)"org.eclipse.equinox.launcher";
+	plan.jarFile = (_TCHAR*)s_pszJar;
+	plan.splashBitmap = (_TCHAR*)s_pszSplash;
+	plan.vmArgs = s_vmArgs;
+	plan.progArgs = s_progArgs;
+	return plan;
+}
+
+static bool Loads(unsigned long long nKey)
+{
+	LaunchPlan* pPlan = loadLaunchPlan((_TCHAR*)s_pszPlan, nKey);
+	freeLaunchPlan(pPlan);
+	return pPlan != NULL;
+}
+
+static void MakeVmDir()
+{
+	mkdir(s_pszDir, 0755);
+	WriteFile(s_pszLib, "libjvm");
+	WriteFile(s_pszJar, "PK launcher");
+	WriteFile(s_pszSplash, "BM splash");
+	WriteFile(s_pszEE, "-Dee.executable=java\n-Dee.bootclasspath=rt.jar\n");
+	WriteFile(s_pszIni, "-vmargs\n-Xmx512m\n");
+}
+
+static void TestKey()
+{
+	unsigned long long nKey = Key("/opt/jdk");
+	CHECK(nKey == Key("/opt/jdk"));
+	CHECK(nKey != Key("/opt/jre"));
+
+	// the values are kept apart from each other and from the files
+	_TCHAR* joined[] = { (_TCHAR*)"-vm/opt/jdk", NULL };
+	_TCHAR* split[] = { (_TCHAR*)"-vm", (_TCHAR*)"/opt/jdk", NULL };
+	CHECK(getLaunchPlanKey(joined, NULL, NULL) != getLaunchPlanKey(split, NULL, NULL));
+	_TCHAR* ini[] = { (_TCHAR*)s_pszIni, NULL };
+	CHECK(getLaunchPlanKey(ini, NULL, NULL) != getLaunchPlanKey(NULL, ini, NULL));
+	CHECK(getLaunchPlanKey(NULL, ini, NULL) != getLaunchPlanKey(NULL, NULL, ini));
+	_TCHAR* empty[] = { NULL };
+	CHECK(getLaunchPlanKey(NULL, NULL, NULL) == getLaunchPlanKey(empty, empty, empty));
+
+	// a file counts with its contents, even rewritten in the same second at
+	// the same size, and a missing one differs from an empty one
+	WriteFile(s_pszIni, "-vmargs\n-Xmx256m\n");
+	CHECK(nKey != Key("/opt/jdk"));
+	WriteFile(s_pszIni, "-vmargs\n-Xmx512m\n");
+	CHECK(nKey == Key("/opt/jdk"));
+	remove(s_pszIni);
+	unsigned long long nMissing = Key("/opt/jdk");
+	CHECK(nKey != nMissing);
+	WriteFile(s_pszIni, "");
+	CHECK(nMissing != Key("/opt/jdk"));
+	WriteFile(s_pszIni, "-vmargs\n-Xmx512m\n");
+
+	// a stamp counts with its time, not its contents
+	Touch(s_pszDir, 10);
+	CHECK(nKey != Key("/opt/jdk"));
+	Touch(s_pszDir, -10);
+	CHECK(nKey == Key("/opt/jdk"));
+}
+
+static void TestRoundTrip()
+{
+	unsigned long long nKey = Key("/opt/jdk");
+	LaunchPlan plan = MakePlan();
+	CHECK_EQ(saveLaunchPlan((_TCHAR*)s_pszPlan, nKey, &plan), 0);
+
+	LaunchPlan* pPlan = loadLaunchPlan((_TCHAR*)s_pszPlan, nKey);
+	CHECK(pPlan != NULL);
+	if (pPlan != NULL)
+	{
+		CHECK_EQ(pPlan->launchMode, plan.launchMode);
+		CHECK_EQ(pPlan->jvmVersion, plan.jvmVersion);
+		CHECK(Same(pPlan->jniLib, plan.jniLib));
+		CHECK(pPlan->eeLibPath == NULL);
+		CHECK(Same(pPlan->pathPrefix, plan.pathPrefix));
+		CHECK(Same(pPlan->startupPrefix, plan.startupPrefix));
+		CHECK(Same(pPlan->jarFile, plan.jarFile));
+		CHECK(Same(pPlan->splashBitmap, plan.splashBitmap));
+		CHECK(SameList(pPlan->vmArgs, plan.vmArgs));
+		CHECK(SameList(pPlan->progArgs, plan.progArgs));
+	}
+	freeLaunchPlan(pPlan);
+
+	// only for its own key
+	CHECK(!Loads(nKey + 1));
+	CHECK(!Loads(Key("/opt/jre")));
+	CHECK(Loads(nKey));
+	CHECK(loadLaunchPlan(NULL, nKey) == NULL);
+
+	// the temporary file it was written to is gone
+	char szTemp[256];
+	snprintf(szTemp, sizeof(szTemp), "%s.%lx", s_pszPlan, (unsigned long)getpid());
+	struct stat st;
+	CHECK(stat(szTemp, &st) != 0);
+
+	// a second plan replaces the first
+	plan.jvmVersion = 0x00110000;
+	CHECK_EQ(saveLaunchPlan((_TCHAR*)s_pszPlan, nKey, &plan), 0);
+	pPlan = loadLaunchPlan((_TCHAR*)s_pszPlan, nKey);
+	CHECK(pPlan != NULL && pPlan->jvmVersion == 0x00110000);
+	freeLaunchPlan(pPlan);
+
+	removeLaunchPlan((_TCHAR*)s_pszPlan);
+	CHECK(!Loads(nKey));
+	removeLaunchPlan(NULL);
+}
+
+// every file the plan resolved to makes it stale once it changes
+static void TestStamps()
+{
+	unsigned long long nKey = Key("/opt/jdk");
+	LaunchPlan plan = MakePlan();
+	const char* pszStamped[] = { s_pszLib, s_pszJar, s_pszSplash, s_pszEE };
+	for (const char* pszPath : pszStamped)
+	{
+		CHECK_EQ(saveLaunchPlan((_TCHAR*)s_pszPlan, nKey, &plan), 0);
+		CHECK(Loads(nKey));
+		Touch(pszPath, 5);
+		CHECK(!Loads(nKey));
+		Touch(pszPath, -5);
+		CHECK(Loads(nKey));
+
+		string strData = ReadFile(pszPath);
+		WriteFile(pszPath, strData + "+");
+		CHECK(!Loads(nKey));
+		WriteFile(pszPath, strData);
+
+		CHECK_EQ(saveLaunchPlan((_TCHAR*)s_pszPlan, nKey, &plan), 0);
+		remove(pszPath);
+		CHECK(!Loads(nKey));
+		WriteFile(pszPath, strData);
+	}
+
+	// a plan without a .ee file or splash stamps what it has
+	plan.splashBitmap = NULL;
+	_TCHAR* vmArgs[] = { (_TCHAR*)"-Xmx512m", NULL };
+	plan.vmArgs = vmArgs;
+	CHECK_EQ(saveLaunchPlan((_TCHAR*)s_pszPlan, nKey, &plan), 0);
+	Touch(s_pszEE, 5);
+	Touch(s_pszSplash, 5);
+	CHECK(Loads(nKey));
+	Touch(s_pszLib, 5);
+	CHECK(!Loads(nKey));
+	removeLaunchPlan((_TCHAR*)s_pszPlan);
+}
+
+// what loadLaunchPlan makes of plan file contents it did not write
+static bool LoadsFrom(const string& strData, unsigned long long nKey)
+{
+	WriteFile(s_pszCopy, strData);
+	LaunchPlan* pPlan = loadLaunchPlan((_TCHAR*)s_pszCopy, nKey);
+	bool bLoaded = pPlan != NULL;
+	freeLaunchPlan(pPlan);
+	return bLoaded;
+}
+
+static void PutInt(string& strData, size_t nAt, int nValue)
+{
+	memcpy(&strData[nAt], &nValue, sizeof(nValue));
+}
+
+static void TestCorrupt()
+{
+	unsigned long long nKey = Key("/opt/jdk");
+	LaunchPlan plan = MakePlan();
+	CHECK_EQ(saveLaunchPlan((_TCHAR*)s_pszPlan, nKey, &plan), 0);
+	string strData = ReadFile(s_pszPlan);
+	CHECK(strData.size() > 64);
+	CHECK(LoadsFrom(strData, nKey));
+
+	// cut short anywhere, including in front of the closing magic
+	int nTruncated = 0;
+	for (size_t n = 0; n < strData.size(); n++)
+		nTruncated += LoadsFrom(strData.substr(0, n), nKey);
+	CHECK_EQ(nTruncated, 0);
+	CHECK(!LoadsFrom("", nKey));
+
+	// another magic, version or character size
+	for (size_t nAt : { 0, 4, 8 })
+	{
+		string strBad = strData;
+		PutInt(strBad, nAt, 0x7F7F7F7F);
+		CHECK(!LoadsFrom(strBad, nKey));
+	}
+	string strBad = strData;
+	PutInt(strBad, strBad.size() - 4, 0);
+	CHECK(!LoadsFrom(strBad, nKey));
+
+	// a length past what a plan holds, or below -1, where jniLib starts
+	size_t nJniLib = 4 + 4 + 4 + 8 + 4 + 4;
+	for (int nLength : { 0x7FFFFFFF, (1 << 20) + 1, -2, (int)0x80000000 })
+	{
+		strBad = strData;
+		PutInt(strBad, nJniLib, nLength);
+		CHECK(!LoadsFrom(strBad, nKey));
+	}
+
+	// any single byte changed: refused or read whole, never out of bounds,
+	// and always refused in the header and the key
+	int nHeaderLoaded = 0;
+	for (size_t n = 0; n < strData.size(); n++)
+	{
+		for (unsigned char cXor : { 0x01, 0x80, 0xFF })
+		{
+			strBad = strData;
+			strBad[n] = (char)(strBad[n] ^ cXor);
+			if (LoadsFrom(strBad, nKey) && n < 4 + 4 + 4 + 8)
+				nHeaderLoaded++;
+		}
+	}
+	CHECK_EQ(nHeaderLoaded, 0);
+
+	// trailing bytes after the closing magic are not read
+	CHECK(LoadsFrom(strData + "tail", nKey));
+
+	remove(s_pszCopy);
+	removeLaunchPlan((_TCHAR*)s_pszPlan);
+}
+
+int main()
+{
+	MakeVmDir();
+	TestKey();
+	TestRoundTrip();
+	TestStamps();
+	TestCorrupt();
+
+	const char* pszFiles[] = { s_pszLib, s_pszJar, s_pszSplash, s_pszEE, s_pszIni };
+	for (const char* pszPath : pszFiles)
+		remove(pszPath);
+	rmdir(s_pszDir);
+	return TestResult("EclipsePlanTest");
+}
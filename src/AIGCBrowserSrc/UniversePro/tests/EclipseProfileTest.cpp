@@ -0,0 +1,175 @@
+// EclipseProfileTest.cpp : the JNI bridge profile, read through TangramJava._profile()
+//
+// startJavaJNI() launches on the stub JVM, whose workbench calls the natives
+// the bridge registered from several threads. The counts, bytes and
+// histograms in the snapshot must add up to exactly those calls, and the
+// dump cleanupVM() writes must hold the same entries.
+
+#include "stdafx.h"
+#include "StubJvm.h"
+#include "eclipseOS.h"
+#include "eclipseCommon.h"
+#include "eclipseProfile.h"
+#include "json/json.hpp"
+#include "TestCheck.h"
+#include <atomic>
+#include <thread>
+
+static const char* const s_pszDump = "out/EclipseProfileTest.json";
+static const int TEST_THREADS = 4;
+static const int TEST_CALLS = 1000;
+
+typedef jstring (JNICALL *ExtendNative)(JNIEnv*, jobject, jstring, jstring, jstring);
+typedef jstring (JNICALL *ProfileNative)(JNIEnv*, jclass);
+typedef void (JNICALL *LauncherInfoNative)(JNIEnv*, jobject, jstring, jstring);
+
+static const char* const s_pszNames[JNI_PROFILE_ENTRIES] = {
+	"update_splash", "get_splash_handle", "set_exit_data", "set_launcher_info", "show_splash", "takedown_splash",
+	"get_os_recommended_folder", "tangram_extend", "ring_doorbell", "registerNatives", "JNI_GetStringChars", "newJavaString"
+};
+
+// what the workbench sent and got back
+static std::atomic<long long> s_nArgBytes(0);
+static std::atomic<long long> s_nReplyBytes(0);
+static std::atomic<int> s_nBadReplies(0);
+static string s_strRunSnapshot;
+
+static jint Workbench(jobjectArray args)
+{
+	CStubJvm& jvm = CStubJvm::Instance();
+	string strSig;
+	ExtendNative pfnExtend = (ExtendNative)jvm.GetNative("dev/tangram/TangramJava", "_extend", &strSig);
+	CHECK(pfnExtend != NULL);
+	CHECK(strSig == "(Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;)Ljava/lang/String;");
+	ProfileNative pfnProfile = (ProfileNative)jvm.GetNative("dev/tangram/TangramJava", "_profile", &strSig);
+	CHECK(pfnProfile != NULL);
+	CHECK(strSig == "()Ljava/lang/String;");
+	if (pfnExtend == NULL || pfnProfile == NULL)
+		return 1;
+
+	vector<std::thread> vThreads;
+	for (int t = 0; t < TEST_THREADS; t++)
+	{
+		vThreads.push_back(std::thread([t, pfnExtend]() {
+			JNIEnv* env = NULL;
+			CStubJvm& jvm = CStubJvm::Instance();
+			jvm.GetVm()->AttachCurrentThread((void**)&env, NULL);
+			for (int i = 0; i < TEST_CALLS; i++)
+			{
+				string strKey = "key" + to_string(t);
+				string strData = string(i % 37, 'd');
+				string strFeatures = "f";
+				jstring reply = pfnExtend(env, NULL, jvm.NewString(strKey.c_str()), jvm.NewString(strData.c_str()), jvm.NewString(strFeatures.c_str()));
+				string strReply = jvm.GetString(reply);
+				if (strReply != strKey + "=" + strData)
+					s_nBadReplies++;
+				s_nArgBytes += strKey.size() + strData.size() + strFeatures.size();
+				s_nReplyBytes += strReply.size();
+			}
+			jvm.GetVm()->DetachCurrentThread();
+		}));
+	}
+	for (auto& it : vThreads)
+		it.join();
+
+	// conversions count under the native they ran in as well
+	LauncherInfoNative pfnLauncherInfo = (LauncherInfoNative)jvm.GetNative(g_SpaceTelescope.m_strBridgeJavaClass, "_set_launcher_info");
+	CHECK(pfnLauncherInfo != NULL);
+	if (pfnLauncherInfo)
+		pfnLauncherInfo(jvm.GetEnv(), NULL, jvm.NewString("/opt/app/launcher"), jvm.NewString("App"));
+
+	s_strRunSnapshot = jvm.GetString(pfnProfile(jvm.GetEnv(), NULL));
+	return 0;
+}
+
+static long long Total(const nlohmann::json& entry, const char* pszField)
+{
+	return entry[pszField].get<long long>();
+}
+
+static void CheckEntries(const nlohmann::json& entries)
+{
+	CHECK_EQ(entries.size(), JNI_PROFILE_ENTRIES);
+	for (size_t i = 0; i < entries.size() && i < JNI_PROFILE_ENTRIES; i++)
+	{
+		const nlohmann::json& entry = entries[i];
+		CHECK(entry["name"].get<string>() == s_pszNames[i]);
+		CHECK_EQ(entry["histogram"].size(), JNI_PROFILE_BUCKETS);
+		long long nCalls = 0;
+		for (auto& it : entry["histogram"])
+			nCalls += it.get<long long>();
+		CHECK_EQ(nCalls, Total(entry, "calls"));
+		CHECK(Total(entry, "minNs") <= Total(entry, "maxNs"));
+		CHECK(Total(entry, "maxNs") <= Total(entry, "totalNs"));
+	}
+}
+
+int main()
+{
+	CStubJvm& jvm = CStubJvm::Instance();
+	g_SpaceTelescope.m_pfnExtend = [](CString strKey, CString strData, CString strFeatures) {
+		return strKey + "=" + strData;
+	};
+	jvm.DefineWorkbench(Workbench);
+
+	// off until started
+	char* pszSnapshot = getJNIProfileSnapshot();
+	CHECK(string(pszSnapshot) == "{\"enabled\":false,\"elapsedNs\":0,\"entries\":[]}");
+	free(pszSnapshot);
+	CHECK_EQ(dumpJNIProfile(), -1);
+
+	remove(s_pszDump);
+	startJNIProfile(s_pszDump);
+	_TCHAR* vmArgs[] = { (_TCHAR*)"-Xmx512m", NULL };
+	_TCHAR* progArgs[] = { (_TCHAR*)"-os", (_TCHAR*)"linux", NULL };
+	JavaResults* results = startJavaJNI((_TCHAR*)"jvm.so", vmArgs, progArgs, (_TCHAR*)"launcher.jar");
+	CHECK_EQ(results->launchResult, 0);
+	CHECK_EQ(results->runResult, 0);
+	CHECK_EQ(s_nBadReplies.load(), 0);
+
+	nlohmann::json snapshot = nlohmann::json::parse(s_strRunSnapshot);
+	CHECK(snapshot["enabled"].get<bool>());
+	CHECK(snapshot["elapsedNs"].get<long long>() > 0);
+	const nlohmann::json& entries = snapshot["entries"];
+	CheckEntries(entries);
+	if (entries.size() == JNI_PROFILE_ENTRIES)
+	{
+		int nExtends = TEST_THREADS * TEST_CALLS;
+		long long nLauncherInfoBytes = strlen("/opt/app/launcher") + strlen("App");
+		CHECK_EQ(Total(entries[JNI_PROFILE_TANGRAM_EXTEND], "calls"), nExtends);
+		CHECK_EQ(Total(entries[JNI_PROFILE_TANGRAM_EXTEND], "bytes"), s_nArgBytes + s_nReplyBytes);
+		CHECK_EQ(Total(entries[JNI_PROFILE_SET_LAUNCHER_INFO], "calls"), 1);
+		CHECK_EQ(Total(entries[JNI_PROFILE_SET_LAUNCHER_INFO], "bytes"), nLauncherInfoBytes);
+		CHECK_EQ(Total(entries[JNI_PROFILE_REGISTER_NATIVES], "calls"), 1);
+		CHECK_EQ(Total(entries[JNI_PROFILE_GET_STRING_CHARS], "calls"), 3 * nExtends + 2);
+		CHECK_EQ(Total(entries[JNI_PROFILE_GET_STRING_CHARS], "bytes"), s_nArgBytes + nLauncherInfoBytes);
+		// System.load() of the library and the two program arguments before the run
+		long long nLaunchBytes = strlen(eclipseLibrary) + strlen("-os") + strlen("linux");
+		CHECK_EQ(Total(entries[JNI_PROFILE_NEW_JAVA_STRING], "calls"), nExtends + 3);
+		CHECK_EQ(Total(entries[JNI_PROFILE_NEW_JAVA_STRING], "bytes"), s_nReplyBytes + nLaunchBytes);
+		CHECK_EQ(Total(entries[JNI_PROFILE_UPDATE_SPLASH], "calls"), 0);
+		CHECK_EQ(Total(entries[JNI_PROFILE_RING_DOORBELL], "calls"), 0);
+	}
+
+	// the dump at exit holds what a snapshot taken just before it does
+	pszSnapshot = getJNIProfileSnapshot();
+	nlohmann::json last = nlohmann::json::parse(pszSnapshot);
+	free(pszSnapshot);
+	cleanupVM(0);
+	FILE* pFile = fopen(s_pszDump, "rb");
+	CHECK(pFile != NULL);
+	if (pFile)
+	{
+		string strDump;
+		char buf[4096];
+		size_t n;
+		while ((n = fread(buf, 1, sizeof(buf), pFile)) > 0)
+			strDump.append(buf, n);
+		fclose(pFile);
+		nlohmann::json dump = nlohmann::json::parse(strDump);
+		CheckEntries(dump["entries"]);
+		CHECK(dump["entries"] == last["entries"]);
+	}
+	remove(s_pszDump);
+	return TestResult("EclipseProfileTest");
+}
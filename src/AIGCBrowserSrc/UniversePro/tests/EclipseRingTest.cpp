@@ -0,0 +1,306 @@
+// EclipseRingTest.cpp : the ring transport of the JNI bridge, Java's side played by the test
+//
+// The workbench on the stub JVM opens the ring with TangramJava._ring_open()
+// and sends extend messages whose replies run from empty to several times
+// the ring: long ones must arrive in pieces, complete and in order, and
+// never wedge the transport. Then two threads ring _ring_doorbell() at once
+// while a third sends, and every message must be answered exactly once.
+
+#include "stdafx.h"
+#include "StubJvm.h"
+#include "eclipseOS.h"
+#include "eclipseRing.h"
+#include "TestCheck.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+static const int TEST_CAPACITY = RING_MIN_CAPACITY;
+static const size_t TEST_MAX_PIECE = TEST_CAPACITY / 2 - RING_FRAME_HEADER;
+static const int TEST_MESSAGES = 3000;
+static const int TEST_TIMEOUT = 30;			// seconds before the transport counts as wedged
+
+typedef jobject (JNICALL *RingOpenNative)(JNIEnv*, jclass, jint);
+typedef jint (JNICALL *RingDoorbellNative)(JNIEnv*, jclass);
+
+typedef std::atomic<unsigned long long> RingIndex;
+
+// TangramJava's end of the ring: it writes towards the launcher and reads
+// what the launcher sent, see the layout in eclipseRing.h
+class CJavaRing
+{
+public:
+	CJavaRing(unsigned char* pMemory, size_t nCapacity) : m_pMemory(pMemory), m_nCapacity(nCapacity) {}
+
+	// false if the frame does not fit yet; bEmpty tells whether the
+	// launcher had caught up, i.e. whether to ring the doorbell
+	bool Send(unsigned int nType, unsigned long long nId, const string& strPayload, bool& bEmpty)
+	{
+		unsigned char* pData = m_pMemory + RING_HEADER_SIZE + m_nCapacity;
+		size_t nSize = FrameSize(strPayload.size());
+		unsigned long long nWrite = Index(72)->load();
+		unsigned long long nPublished = nWrite;
+		unsigned long long nRead = Index(8)->load();
+		size_t nOffset = nWrite & (m_nCapacity - 1);
+		size_t nTail = m_nCapacity - nOffset;
+		if (nSize > nTail)
+		{
+			if (m_nCapacity - (nWrite - nRead) < nTail + nSize)
+				return false;
+			unsigned int nWrap = RING_WRAP;
+			memcpy(pData + nOffset, &nWrap, 4);
+			nWrite += nTail;
+			nOffset = 0;
+		}
+		else if (m_nCapacity - (nWrite - nRead) < nSize)
+			return false;
+		unsigned int nLength = (unsigned int)strPayload.size();
+		memcpy(pData + nOffset, &nLength, 4);
+		memcpy(pData + nOffset + 4, &nType, 4);
+		memcpy(pData + nOffset + 8, &nId, 8);
+		memcpy(pData + nOffset + RING_FRAME_HEADER, strPayload.data(), nLength);
+		Index(72)->store(nWrite + nSize);
+		bEmpty = Index(8)->load() == nPublished;
+		return true;
+	}
+
+	// the next frame from the launcher, false if there is none
+	bool Receive(unsigned int& nType, unsigned long long& nId, string& strPayload)
+	{
+		unsigned char* pData = m_pMemory + RING_HEADER_SIZE;
+		for (;;)
+		{
+			unsigned long long nRead = Index(64)->load();
+			if (Index(0)->load() == nRead)
+				return false;
+			size_t nOffset = nRead & (m_nCapacity - 1);
+			unsigned int nLength;
+			memcpy(&nLength, pData + nOffset, 4);
+			if (nLength == RING_WRAP)
+			{
+				Index(64)->store(nRead + m_nCapacity - nOffset);
+				continue;
+			}
+			memcpy(&nType, pData + nOffset + 4, 4);
+			memcpy(&nId, pData + nOffset + 8, 8);
+			strPayload.assign((const char*)pData + nOffset + RING_FRAME_HEADER, nLength);
+			Index(64)->store(nRead + FrameSize(nLength));
+			return true;
+		}
+	}
+
+	long long GetStat(int nStat)
+	{
+		return (long long)Index(RING_HEADER_STATS + nStat * 8)->load();
+	}
+
+private:
+	RingIndex* Index(size_t nOffset) { return (RingIndex*)(m_pMemory + nOffset); }
+	static size_t FrameSize(size_t nLength) { return (RING_FRAME_HEADER + nLength + 7) & ~(size_t)7; }
+
+	unsigned char* m_pMemory;
+	size_t m_nCapacity;
+};
+
+// the length of the reply to message n: around a piece, a ring and
+// three rings, and short ones in between
+static size_t ReplyLength(int n)
+{
+	static const size_t s_nLengths[] = { 0, 1, TEST_MAX_PIECE - 1, TEST_MAX_PIECE, TEST_MAX_PIECE + 1,
+		TEST_CAPACITY - RING_FRAME_HEADER, TEST_CAPACITY, 3 * TEST_CAPACITY + 5 };
+	return n % 10 < 8 ? s_nLengths[n % 10] : (size_t)(n * 7919 % 600);
+}
+
+static string Reply(const string& strKey, size_t nLength)
+{
+	string strReply;
+	while (strReply.size() < nLength)
+		strReply += strKey + ";";
+	strReply.resize(nLength);
+	return strReply;
+}
+
+static string Message(int n)
+{
+	return to_string(n) + '\0' + to_string(ReplyLength(n)) + '\0' + "features" + '\0';
+}
+
+// puts the replies back together and checks them, in the order of the messages
+struct CReplies
+{
+	int m_nNext;
+	int m_nAnswered = 0;
+	int m_nErrors = 0;
+	string m_strParts;
+
+	CReplies(int nFirst) : m_nNext(nFirst) {}
+
+	// takes what the launcher sent, true if there was anything
+	bool Receive(CJavaRing& ring)
+	{
+		unsigned int nType;
+		unsigned long long nId;
+		string strPayload;
+		bool bReceived = false;
+		while (ring.Receive(nType, nId, strPayload))
+		{
+			bReceived = true;
+			if (nId != (unsigned long long)m_nNext || (nType != RING_MESSAGE_EXTEND_REPLY && nType != RING_MESSAGE_EXTEND_REPLY_PART))
+			{
+				m_nErrors++;
+				continue;
+			}
+			m_strParts += strPayload;
+			if (nType == RING_MESSAGE_EXTEND_REPLY_PART)
+			{
+				if (strPayload.size() != TEST_MAX_PIECE)
+					m_nErrors++;
+				continue;
+			}
+			if (m_strParts == Reply(to_string(m_nNext), ReplyLength(m_nNext)))
+				m_nAnswered++;
+			else
+				m_nErrors++;
+			m_strParts.clear();
+			m_nNext++;
+		}
+		return bReceived;
+	}
+};
+
+static bool TimedOut(std::chrono::steady_clock::time_point tStart)
+{
+	return std::chrono::steady_clock::now() - tStart > std::chrono::seconds(TEST_TIMEOUT);
+}
+
+// one Java thread, by the protocol: the doorbell when the ring was empty,
+// and again after a drain that left replies waiting once there is room
+static void ExchangeInline(CJavaRing& ring, JNIEnv* env, jclass clazz, RingDoorbellNative pfnDoorbell, int nFirst, int nLast, CReplies& replies)
+{
+	auto tStart = std::chrono::steady_clock::now();
+	int n = nFirst;
+	int nResult = 0;
+	while (replies.m_nNext < nLast && !TimedOut(tStart))
+	{
+		bool bEmpty = false;
+		if (n < nLast && ring.Send(RING_MESSAGE_EXTEND, n, Message(n), bEmpty))
+		{
+			n++;
+			if (bEmpty)
+				nResult = pfnDoorbell(env, clazz);
+		}
+		if (replies.Receive(ring) && nResult < 0)
+			nResult = pfnDoorbell(env, clazz);
+	}
+}
+
+// a sending thread, two threads ringing all the time and this one reading
+static void ExchangeConcurrent(CJavaRing& ring, RingDoorbellNative pfnDoorbell, int nFirst, int nLast, CReplies& replies)
+{
+	CStubJvm& jvm = CStubJvm::Instance();
+	std::atomic<bool> bDone(false);
+	vector<std::thread> vThreads;
+	for (int d = 0; d < 2; d++)
+	{
+		vThreads.push_back(std::thread([&]() {
+			JNIEnv* env = NULL;
+			jvm.GetVm()->AttachCurrentThread((void**)&env, NULL);
+			while (!bDone)
+			{
+				pfnDoorbell(env, NULL);
+				std::this_thread::yield();
+			}
+			jvm.GetVm()->DetachCurrentThread();
+		}));
+	}
+	vThreads.push_back(std::thread([&]() {
+		for (int n = nFirst; n < nLast && !bDone; )
+		{
+			bool bEmpty = false;
+			if (ring.Send(RING_MESSAGE_EXTEND, n, Message(n), bEmpty))
+				n++;
+			else
+				std::this_thread::yield();
+		}
+	}));
+
+	auto tStart = std::chrono::steady_clock::now();
+	while (replies.m_nNext < nLast && !TimedOut(tStart))
+	{
+		if (!replies.Receive(ring))
+			std::this_thread::yield();
+	}
+	bDone = true;
+	for (auto& it : vThreads)
+		it.join();
+}
+
+static std::atomic<int> s_nRingReady(0);
+
+static jint Workbench(jobjectArray args)
+{
+	CStubJvm& jvm = CStubJvm::Instance();
+	JNIEnv* env = jvm.GetEnv();
+	jclass tangram = env->FindClass("dev/tangram/TangramJava");
+	RingOpenNative pfnOpen = (RingOpenNative)jvm.GetNative("dev/tangram/TangramJava", "_ring_open");
+	RingDoorbellNative pfnDoorbell = (RingDoorbellNative)jvm.GetNative("dev/tangram/TangramJava", "_ring_doorbell");
+	CHECK(pfnOpen != NULL && pfnDoorbell != NULL);
+	if (pfnOpen == NULL || pfnDoorbell == NULL)
+		return 1;
+
+	jobject buffer = pfnOpen(env, tangram, TEST_CAPACITY);
+	CHECK(buffer != NULL);
+	if (buffer == NULL)
+		return 1;
+	unsigned char* pMemory = (unsigned char*)env->GetDirectBufferAddress(buffer);
+	CHECK_EQ(env->GetDirectBufferCapacity(buffer), RING_HEADER_SIZE + 2 * TEST_CAPACITY);
+	unsigned int nMagic, nVersion;
+	unsigned long long nCapacity;
+	memcpy(&nMagic, pMemory + 192, 4);
+	memcpy(&nVersion, pMemory + 196, 4);
+	memcpy(&nCapacity, pMemory + 200, 8);
+	CHECK_EQ(nMagic, RING_MAGIC);
+	CHECK_EQ(nVersion, RING_VERSION);
+	CHECK_EQ(nCapacity, TEST_CAPACITY);
+	// there is one ring, opening it again hands out the same one
+	CHECK(env->GetDirectBufferAddress(pfnOpen(env, tangram, 2 * TEST_CAPACITY)) == pMemory);
+
+	CJavaRing ring(pMemory, TEST_CAPACITY);
+	CReplies inlineReplies(0);
+	ExchangeInline(ring, env, tangram, pfnDoorbell, 0, TEST_MESSAGES, inlineReplies);
+	CHECK_EQ(inlineReplies.m_nAnswered, TEST_MESSAGES);
+	CHECK_EQ(inlineReplies.m_nErrors, 0);
+	CHECK(s_nRingReady.load() > 0);
+
+	CReplies concurrentReplies(TEST_MESSAGES);
+	ExchangeConcurrent(ring, pfnDoorbell, TEST_MESSAGES, 2 * TEST_MESSAGES, concurrentReplies);
+	CHECK_EQ(concurrentReplies.m_nAnswered, TEST_MESSAGES);
+	CHECK_EQ(concurrentReplies.m_nErrors, 0);
+
+	// each message handled once, nothing left waiting
+	CHECK_EQ(ring.GetStat(RING_STAT_RECEIVED), 2 * TEST_MESSAGES);
+	CHECK_EQ(pfnDoorbell(env, tangram), 0);
+	return 0;
+}
+
+int main()
+{
+	CStubJvm& jvm = CStubJvm::Instance();
+	g_SpaceTelescope.m_pfnExtend = [](CString strKey, CString strData, CString strFeatures) {
+		return CString(Reply((LPCTSTR)strKey, atoi(strData)).c_str());
+	};
+	jvm.DefineStaticMethod("dev/tangram/TangramJava", "ringReady", "()V", [](jobject, const jvalue*) {
+		jvalue none;
+		memset(&none, 0, sizeof(none));
+		s_nRingReady++;
+		return none;
+	});
+	jvm.DefineWorkbench(Workbench);
+
+	_TCHAR* vmArgs[] = { (_TCHAR*)"-Xmx512m", NULL };
+	_TCHAR* progArgs[] = { NULL };
+	JavaResults* results = startJavaJNI((_TCHAR*)"jvm.so", vmArgs, progArgs, (_TCHAR*)"launcher.jar");
+	CHECK_EQ(results->launchResult, 0);
+	CHECK_EQ(results->runResult, 0);
+	return TestResult("EclipseRingTest");
+}
@@ -0,0 +1,214 @@
+// FuzzDriver.cpp : runs a fuzz target without libFuzzer, see FuzzDriver.h
+//
+//   Json2XmlFuzz              seeds, their truncations and mutations
+//   Json2XmlFuzz FILE...      the given inputs, e.g. a libFuzzer crash file
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include "FuzzDriver.h"
+
+using namespace std;
+
+static const int FUZZ_MUTANTS = 2000;		// per seed
+static const int FUZZ_MINIMIZE_TESTS = 20000;
+
+// the characters that change the structure of json and xml, picked more
+// often than arbitrary bytes
+static const char s_szStructure[] = "{}[]\",:@<>/=&;#!?-' \t\r\n0\\";
+
+static bool Fails(const string& strInput, string& strReason)
+{
+	try
+	{
+		LLVMFuzzerTestOneInput((const uint8_t*)strInput.data(), strInput.size());
+	}
+	catch (const FuzzFailure& failure)
+	{
+		strReason = failure.m_strReason;
+		return true;
+	}
+	return false;
+}
+
+static bool FailsWith(const string& strInput, const string& strReason)
+{
+	string strOther;
+	return Fails(strInput, strOther) && strOther == strReason;
+}
+
+// delta debugging: drop one of nParts chunks at a time, keep any drop that
+// still fails the same check, and cut finer when none does
+static string Minimize(const string& strInput, const string& strReason, int& nTests)
+{
+	string strDoc = strInput;
+	size_t nParts = 2;
+	nTests = 0;
+	while (strDoc.size() >= 1 && nTests < FUZZ_MINIMIZE_TESTS)
+	{
+		size_t nLength = strDoc.size();
+		if (nParts > nLength)
+			nParts = nLength;
+		bool bReduced = false;
+		for (size_t i = 0; i < nParts && nTests < FUZZ_MINIMIZE_TESTS; i++)
+		{
+			size_t nBegin = nLength * i / nParts;
+			size_t nEnd = nLength * (i + 1) / nParts;
+			string strTry = strDoc.substr(0, nBegin) + strDoc.substr(nEnd);
+			nTests++;
+			if (FailsWith(strTry, strReason))
+			{
+				strDoc = strTry;
+				nParts = nParts > 3 ? nParts - 1 : 2;
+				bReduced = true;
+				break;
+			}
+		}
+		if (bReduced)
+			continue;
+		if (nParts >= nLength)
+			break;
+		nParts = nParts * 2 < nLength ? nParts * 2 : nLength;
+	}
+	return strDoc;
+}
+
+static string Printable(const string& str)
+{
+	string strOut;
+	char szHex[8];
+	for (unsigned char ch : str)
+	{
+		if (ch == '\\')
+			strOut += "\\\\";
+		else if (ch >= 0x20 && ch < 0x7f)
+			strOut += (char)ch;
+		else
+		{
+			snprintf(szHex, sizeof(szHex), "\\x%02x", ch);
+			strOut += szHex;
+		}
+	}
+	return strOut;
+}
+
+struct FuzzRun
+{
+	string m_strName;
+	int m_nInputs = 0;
+	int m_nFailures = 0;
+	vector<string> m_vReasons;
+
+	void Run(const string& strInput)
+	{
+		m_nInputs++;
+		string strReason;
+		if (Fails(strInput, strReason) == false)
+			return;
+		// one repro per failing check is enough
+		for (auto& it : m_vReasons)
+		{
+			if (it == strReason)
+				return;
+		}
+		m_vReasons.push_back(strReason);
+		m_nFailures++;
+		int nTests = 0;
+		string strRepro = Minimize(strInput, strReason, nTests);
+		string strFile = m_strName + ".repro" + to_string(m_nFailures);
+		if (FILE* pFile = fopen(strFile.c_str(), "wb"))
+		{
+			fwrite(strRepro.data(), 1, strRepro.size(), pFile);
+			fclose(pFile);
+		}
+		fprintf(stderr, "%s\n  input (%zu bytes): %s\n  repro (%zu bytes, %d tests, %s): %s\n", strReason.c_str(),
+			strInput.size(), Printable(strInput.substr(0, 200)).c_str(), strRepro.size(), nTests, strFile.c_str(), Printable(strRepro).c_str());
+	}
+};
+
+static bool ReadFile(const char* pszFile, string& strInput)
+{
+	FILE* pFile = fopen(pszFile, "rb");
+	if (pFile == nullptr)
+		return false;
+	char buf[4096];
+	size_t n;
+	while ((n = fread(buf, 1, sizeof(buf), pFile)) > 0)
+		strInput.append(buf, n);
+	fclose(pFile);
+	return true;
+}
+
+int main(int argc, char** argv)
+{
+	FuzzRun run;
+	run.m_strName = argv[0];
+	if (argc > 1)
+	{
+		for (int i = 1; i < argc; i++)
+		{
+			string strInput;
+			if (ReadFile(argv[i], strInput) == false)
+			{
+				fprintf(stderr, "cannot read %s\n", argv[i]);
+				return 1;
+			}
+			run.Run(strInput);
+		}
+	}
+	else
+	{
+		// a fixed generator, so a failure shows up on every run
+		uint32_t nState = 2463534242u;
+		auto random = [&nState](uint32_t nBound) {
+			nState ^= nState << 13;
+			nState ^= nState >> 17;
+			nState ^= nState << 5;
+			return nBound ? nState % nBound : 0;
+		};
+		const FuzzSeeds& seeds = g_FuzzSeeds;
+		for (size_t i = 0; i < seeds.m_nSeeds; i++)
+		{
+			string strSeed = seeds.m_ppszSeeds[i];
+			run.Run(strSeed);
+			for (size_t n = 0; n < strSeed.size(); n++)
+				run.Run(strSeed.substr(0, n));
+			for (int m = 0; m < FUZZ_MUTANTS; m++)
+			{
+				string strMutant = strSeed;
+				for (int nEdits = 1 + random(4); nEdits > 0; nEdits--)
+				{
+					size_t nPos = random((uint32_t)strMutant.size() + 1);
+					char ch = random(4) ? s_szStructure[random(sizeof(s_szStructure) - 1)] : (char)random(256);
+					switch (random(5))
+					{
+					case 0:
+						strMutant.insert(nPos, 1, ch);
+						break;
+					case 1:
+						if (nPos < strMutant.size())
+							strMutant[nPos] = ch;
+						break;
+					case 2:
+						strMutant.erase(nPos, 1 + random(8));
+						break;
+					case 3:
+						// a chunk of this seed repeated, or of another one spliced in
+						{
+							string strFrom = random(2) ? strSeed : string(seeds.m_ppszSeeds[random((uint32_t)seeds.m_nSeeds)]);
+							size_t nFrom = random((uint32_t)strFrom.size());
+							strMutant.insert(nPos, strFrom.substr(nFrom, 1 + random(32)));
+						}
+						break;
+					default:
+						strMutant = strMutant.substr(0, nPos);
+						break;
+					}
+				}
+				run.Run(strMutant);
+			}
+		}
+	}
+	printf("%s: %d inputs, %d failed checks\n", run.m_strName.c_str(), run.m_nInputs, run.m_nFailures);
+	return run.m_nFailures ? 1 : 0;
+}
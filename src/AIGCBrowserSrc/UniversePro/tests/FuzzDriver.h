@@ -0,0 +1,36 @@
+// FuzzDriver.h : libFuzzer entry points that also run as plain tests
+//
+// A fuzz target defines LLVMFuzzerTestOneInput, fails with FUZZ_CHECK and
+// lists a few seed inputs in g_FuzzSeeds. Linked with -fsanitize=fuzzer it
+// is a libFuzzer binary: a failed check is an uncaught exception, which
+// libFuzzer reports as a crash and shrinks with -minimize_crash=1. Linked
+// with FuzzDriver.cpp it replays the seeds, every truncation of them and a
+// fixed set of mutations (or the files named on its command line), and
+// shrinks each failing input to a minimized repro written next to it.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+
+struct FuzzFailure
+{
+	std::string m_strReason;
+};
+
+#define FUZZ_CHECK(expr) \
+	do { \
+		if (!(expr)) \
+			throw FuzzFailure{ std::string(__FILE__ ":") + std::to_string(__LINE__) + ": " #expr }; \
+	} while (0)
+
+struct FuzzSeeds
+{
+	const char* const* m_ppszSeeds;
+	size_t m_nSeeds;
+};
+
+extern const FuzzSeeds g_FuzzSeeds;
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* pData, size_t nSize);
@@ -0,0 +1,241 @@
+// Json2XmlFuzz.cpp : JsonSaxConsumer against a reference model of its rules
+//
+// The json is recorded from the same sax events, turned into the element
+// tree the consumer documents (json2xml.hpp) and compared with what CMarkup
+// reads back from the consumer's xml. Input that would make more than one
+// root element must be rejected.
+
+#include "stdafx.h"
+#include "Markup.h"
+#include "json/json2xml.hpp"
+#include "FuzzDriver.h"
+
+static const char* const s_pszSeeds[] = {
+	"{\"layout\":{\"@name\":\"main\",\"nucleus\":{\"@id\":\"n1\",\"xobj\":[{\"@id\":\"a\",\"@objid\":\"xobj\"},{\"@id\":\"b\",\"@width\":200}]}}}",
+	"{\"window\":{\"@style\":11,\"@activepage\":0,\"xobj\":[{\"@id\":\"left\",\"@caption\":\"A &amp; <B>\"},{\"@id\":\"right\",\"text\":\"line\\r\\nnext\\ttab\\u0001\"}]}}",
+	"[{\"layout\":{\"@a\":true,\"@b\":null,\"@c\":1.5e3,\"list\":[1,-2,3.25,null,\"x\"]}}]",
+	"{\"a\":{},\"b\":{}}",
+	"[{\"a\":{}},{\"b\":{}}]",
+	"{\"a\":[[{\"@k\":\"v\"},{\"b\":1}],[]],\"@late\":\"x\"}",
+	"{\"1st\":{\"@x y\":\"\\\"q\\\"\",\"\":\"empty\",\"@x y\":\"again\",\"@obj\":{\"no\":1},\"-\":[]}}",
+};
+
+const FuzzSeeds g_FuzzSeeds = { s_pszSeeds, sizeof(s_pszSeeds) / sizeof(s_pszSeeds[0]) };
+
+// deeper input is still converted, only not modelled: the model recurses
+static const int FUZZ_MAX_DEPTH = 200;
+
+// the json as the sax events deliver it, duplicate keys and number text kept
+struct JsonNode
+{
+	enum Kind { SCALAR, NUL, OBJECT, ARRAY } m_kind = NUL;
+	string m_strText;
+	vector<string> m_vKeys;			// OBJECT, one per item
+	vector<JsonNode> m_vItems;		// OBJECT and ARRAY
+};
+
+class JsonRecorder : public nlohmann::json::json_sax_t
+{
+public:
+	JsonNode m_root;
+	int m_nMaxDepth = 0;
+
+	bool null() override { return Value(JsonNode::NUL, ""); }
+	bool boolean(bool val) override { return Value(JsonNode::SCALAR, val ? "true" : "false"); }
+	bool number_integer(number_integer_t val) override { return Value(JsonNode::SCALAR, to_string(val)); }
+	bool number_unsigned(number_unsigned_t val) override { return Value(JsonNode::SCALAR, to_string(val)); }
+	bool number_float(number_float_t, const string_t& s) override { return Value(JsonNode::SCALAR, s); }
+	bool string(string_t& val) override { return Value(JsonNode::SCALAR, val); }
+	bool start_object(std::size_t) override { return Start(JsonNode::OBJECT); }
+	bool end_object() override { m_vStack.pop_back(); return true; }
+	bool start_array(std::size_t) override { return Start(JsonNode::ARRAY); }
+	bool end_array() override { m_vStack.pop_back(); return true; }
+	bool key(string_t& val) override { m_strKey = val; return true; }
+	bool parse_error(std::size_t, const std::string&, const nlohmann::json::exception&) override { return false; }
+
+private:
+	vector<JsonNode*> m_vStack;
+	std::string m_strKey;
+
+	JsonNode* Add()
+	{
+		if (m_vStack.empty())
+			return &m_root;
+		JsonNode* pParent = m_vStack.back();
+		if (pParent->m_kind == JsonNode::OBJECT)
+			pParent->m_vKeys.push_back(m_strKey);
+		pParent->m_vItems.push_back(JsonNode());
+		return &pParent->m_vItems.back();
+	}
+
+	bool Value(JsonNode::Kind kind, const std::string& strText)
+	{
+		JsonNode* pNode = Add();
+		pNode->m_kind = kind;
+		pNode->m_strText = strText;
+		return true;
+	}
+
+	bool Start(JsonNode::Kind kind)
+	{
+		Add()->m_kind = kind;
+		// only the open node's items grow, so the pointers above it stay valid
+		m_vStack.push_back(m_vStack.empty() ? &m_root : &m_vStack.back()->m_vItems.back());
+		m_nMaxDepth = max(m_nMaxDepth, (int)m_vStack.size());
+		return true;
+	}
+};
+
+struct XmlNode
+{
+	string m_strName;
+	vector<pair<string, string>> m_vAttribs;
+	string m_strText;
+	vector<XmlNode> m_vChildren;
+};
+
+static string Sanitize(const string& strName)
+{
+	string strResult = strName;
+	for (auto& ch : strResult)
+	{
+		unsigned char c = (unsigned char)ch;
+		if (!(c >= 0x80 || isalnum(c) || c == '_' || c == '-' || c == '.'))
+			ch = '_';
+	}
+	if (strResult.empty() || isdigit((unsigned char)strResult[0]) || strResult[0] == '-' || strResult[0] == '.')
+		strResult.insert(strResult.begin(), '_');
+	return strResult;
+}
+
+// xml 1.0 has no form for the other control characters
+static string XmlChars(const string& strText)
+{
+	string strResult;
+	for (unsigned char c : strText)
+	{
+		if (c >= 0x20 || c == '\t' || c == '\n' || c == '\r')
+			strResult += (char)c;
+	}
+	return strResult;
+}
+
+static void ModelMembers(const JsonNode& obj, XmlNode* pElement, vector<XmlNode>& vOut);
+
+// the elements a value under strName makes
+static void ModelValue(const JsonNode& value, const string& strName, vector<XmlNode>& vOut)
+{
+	switch (value.m_kind)
+	{
+	case JsonNode::SCALAR:
+	case JsonNode::NUL:
+		vOut.push_back(XmlNode());
+		vOut.back().m_strName = strName;
+		vOut.back().m_strText = XmlChars(value.m_strText);
+		break;
+	case JsonNode::OBJECT:
+		{
+			XmlNode element;
+			element.m_strName = strName;
+			ModelMembers(value, &element, element.m_vChildren);
+			vOut.push_back(element);
+		}
+		break;
+	case JsonNode::ARRAY:
+		for (auto& item : value.m_vItems)
+			ModelValue(item, strName, vOut);
+		break;
+	}
+}
+
+// the members of an object: attributes of pElement until its first child,
+// elements in vOut; the outer object has no element to take attributes
+static void ModelMembers(const JsonNode& obj, XmlNode* pElement, vector<XmlNode>& vOut)
+{
+	for (size_t i = 0; i < obj.m_vItems.size(); i++)
+	{
+		const string& strKey = obj.m_vKeys[i];
+		const JsonNode& value = obj.m_vItems[i];
+		if (!strKey.empty() && strKey[0] == '@')
+		{
+			if (pElement == nullptr || !vOut.empty() || value.m_kind == JsonNode::OBJECT || value.m_kind == JsonNode::ARRAY)
+				continue;
+			string strName = Sanitize(strKey.substr(1));
+			bool bRepeated = false;
+			for (auto& it : pElement->m_vAttribs)
+				bRepeated = bRepeated || it.first == strName;
+			if (bRepeated == false)
+				pElement->m_vAttribs.push_back(make_pair(strName, XmlChars(value.m_strText)));
+		}
+		else
+			ModelValue(value, Sanitize(strKey), vOut);
+	}
+}
+
+// the outer value: an object, or an array of them at any depth
+static void ModelRoot(const JsonNode& value, vector<XmlNode>& vOut)
+{
+	if (value.m_kind == JsonNode::OBJECT)
+		ModelMembers(value, nullptr, vOut);
+	else if (value.m_kind == JsonNode::ARRAY)
+	{
+		for (auto& item : value.m_vItems)
+			ModelRoot(item, vOut);
+	}
+}
+
+// xml is on the element expected describes
+static void CompareElem(CMarkup& xml, const XmlNode& expected)
+{
+	FUZZ_CHECK(xml.GetTagName() == expected.m_strName);
+	for (size_t i = 0; i < expected.m_vAttribs.size(); i++)
+	{
+		FUZZ_CHECK(xml.GetAttribName((int)i) == expected.m_vAttribs[i].first);
+		FUZZ_CHECK(xml.GetAttrib(expected.m_vAttribs[i].first) == expected.m_vAttribs[i].second);
+	}
+	FUZZ_CHECK(xml.GetAttribName((int)expected.m_vAttribs.size()) == "");
+	if (expected.m_vChildren.empty())
+		FUZZ_CHECK(xml.GetData() == expected.m_strText);
+	xml.IntoElem();
+	for (auto& child : expected.m_vChildren)
+	{
+		FUZZ_CHECK(xml.FindElem());
+		CompareElem(xml, child);
+	}
+	FUZZ_CHECK(xml.FindElem() == false);
+	xml.OutOfElem();
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* pData, size_t nSize)
+{
+	std::string strJson((const char*)pData, nSize);
+	ert::JsonSaxConsumer consumer(2);
+	bool bConverted = nlohmann::json::sax_parse(strJson, &consumer);
+
+	JsonRecorder recorder;
+	if (nlohmann::json::sax_parse(strJson, &recorder) == false)
+	{
+		FUZZ_CHECK(bConverted == false);
+		return 0;
+	}
+	if (recorder.m_nMaxDepth > FUZZ_MAX_DEPTH)
+		return 0;
+	vector<XmlNode> vRoots;
+	ModelRoot(recorder.m_root, vRoots);
+	FUZZ_CHECK(bConverted == (vRoots.size() <= 1));
+	if (bConverted == false)
+		return 0;
+
+	std::string strXml = consumer.getXmlString();
+	if (vRoots.empty())
+	{
+		FUZZ_CHECK(strXml.find('<') == std::string::npos);
+		return 0;
+	}
+	CMarkup xml;
+	FUZZ_CHECK(xml.SetDoc(strXml));
+	FUZZ_CHECK(xml.FindElem());
+	CompareElem(xml, vRoots[0]);
+	FUZZ_CHECK(xml.FindElem() == false);
+	return 0;
+}
@@ -0,0 +1,487 @@
+// LayoutEvictionTest.cpp : budgets and eviction of hidden nucleus layouts
+//
+// CLruLayoutEvictionPolicy is checked against a reference that recounts the
+// usage of every owner and of the process from scratch before each pick,
+// on random layouts under per-nucleus and global budgets. The manager is
+// driven the way CNucleus::TrackLayouts drives it, by fake nuclei that may
+// refuse an eviction: a refused layout stays tracked with what kept it
+// corrected, and only the layouts really evicted are untracked and counted.
+
+#include "stdafx.h"
+#include "LayoutEviction.h"
+#include "TestCheck.h"
+
+#include <random>
+#include <set>
+
+static LayoutUsage Usage(long nNodes, long nHandles, size_t nBytes)
+{
+	LayoutUsage usage = { nNodes, nHandles, nBytes };
+	return usage;
+}
+
+static LayoutBudget Budget(long nNodes, long nHandles, size_t nBytes)
+{
+	LayoutBudget budget = { nNodes, nHandles, nBytes };
+	return budget;
+}
+
+static bool Tracked(const CLayoutEvictionManager& manager, void* pOwner, const CString& strKey)
+{
+	for (auto& entry : manager.GetEntries())
+	{
+		if (entry.m_pOwner == pOwner && entry.m_strKey == strKey)
+			return true;
+	}
+	return false;
+}
+
+// the usage of the entries not in setGone, of pOwner or of all when NULL
+static LayoutUsage Total(const vector<LayoutEntry>& vEntries, const set<int>& setGone, void* pOwner)
+{
+	LayoutUsage total = { 0, 0, 0 };
+	for (int i = 0; i < (int)vEntries.size(); i++)
+	{
+		if (setGone.count(i) || (pOwner && vEntries[i].m_pOwner != pOwner))
+			continue;
+		total.m_nNodes += vEntries[i].m_Usage.m_nNodes;
+		total.m_nHandles += vEntries[i].m_Usage.m_nHandles;
+		total.m_nBytes += vEntries[i].m_Usage.m_nBytes;
+	}
+	return total;
+}
+
+// least recently shown first, each one taken while its owner or the
+// process is still over budget without the ones taken before
+static vector<int> ReferenceVictims(const vector<LayoutEntry>& vEntries, const LayoutBudget& budgetOwner, const LayoutBudget& budgetGlobal)
+{
+	vector<int> vCandidates;
+	for (int i = 0; i < (int)vEntries.size(); i++)
+	{
+		if (vEntries[i].m_bHidden && !vEntries[i].m_bPinned)
+			vCandidates.push_back(i);
+	}
+	stable_sort(vCandidates.begin(), vCandidates.end(), [&vEntries](int a, int b) { return vEntries[a].m_nLastUse < vEntries[b].m_nLastUse; });
+
+	set<int> setGone;
+	vector<int> vVictims;
+	for (int i : vCandidates)
+	{
+		if (CLayoutEvictionManager::IsOver(Total(vEntries, setGone, vEntries[i].m_pOwner), budgetOwner)
+			|| CLayoutEvictionManager::IsOver(Total(vEntries, setGone, NULL), budgetGlobal))
+		{
+			vVictims.push_back(i);
+			setGone.insert(i);
+		}
+	}
+	return vVictims;
+}
+
+// a nucleus as EvictLayout sees it: a layout may be gone already, be the
+// visible one or windowless, or be pinned by its content
+struct FakeNucleus
+{
+	struct Layout
+	{
+		LayoutUsage	m_Usage;
+		bool		m_bShown;
+		bool		m_bPinned;
+	};
+	map<CString, Layout> m_mapLayouts;
+	set<CString> m_setEvicted;
+
+	bool EvictLayout(CLayoutEvictionManager& manager, const CString& strKey)
+	{
+		auto it = m_mapLayouts.find(strKey);
+		if (it == m_mapLayouts.end())
+		{
+			manager.Remove(this, strKey);
+			return false;
+		}
+		if (it->second.m_bShown)
+		{
+			manager.Track(this, strKey, it->second.m_Usage, false);
+			return false;
+		}
+		if (it->second.m_bPinned)
+		{
+			manager.SetPinned(this, strKey, true);
+			return false;
+		}
+		m_mapLayouts.erase(it);
+		m_setEvicted.insert(strKey);
+		return true;
+	}
+};
+
+// the eviction half of CNucleus::TrackLayouts
+static int Collect(CLayoutEvictionManager& manager, vector<LayoutEntry>& vVictims)
+{
+	int nEvicted = 0;
+	if (manager.Collect(vVictims))
+	{
+		for (auto& it : vVictims)
+		{
+			if (((FakeNucleus*)it.m_pOwner)->EvictLayout(manager, it.m_strKey))
+			{
+				manager.Evicted(it.m_pOwner, it.m_strKey);
+				nEvicted++;
+			}
+		}
+	}
+	return nEvicted;
+}
+
+static void TestIsOver()
+{
+	LayoutBudget none = Budget(0, 0, 0);
+	CHECK(!CLayoutEvictionManager::IsOver(Usage(1000000, 1000000, 1 << 30), none));
+
+	LayoutBudget budget = Budget(10, 20, 30);
+	CHECK(!CLayoutEvictionManager::IsOver(Usage(10, 20, 30), budget));
+	CHECK(CLayoutEvictionManager::IsOver(Usage(11, 0, 0), budget));
+	CHECK(CLayoutEvictionManager::IsOver(Usage(0, 21, 0), budget));
+	CHECK(CLayoutEvictionManager::IsOver(Usage(0, 0, 31), budget));
+	CHECK(!CLayoutEvictionManager::IsOver(Usage(1000, 20, 30), Budget(0, 20, 30)));
+}
+
+static void TestTrack()
+{
+	CLayoutEvictionManager manager;
+	FakeNucleus a;
+	manager.Track(&a, _T("one"), Usage(1, 1, 1), false);
+	manager.Track(&a, _T("two"), Usage(1, 1, 1), false);
+	CHECK_EQ(manager.GetEntries().size(), 2);
+	__int64 nOne = manager.GetEntries()[0].m_nLastUse;
+	__int64 nTwo = manager.GetEntries()[1].m_nLastUse;
+	CHECK(nOne < nTwo);
+
+	// hiding is not a use, showing is, and the usage is the last one given
+	manager.Track(&a, _T("one"), Usage(5, 6, 7), true);
+	CHECK_EQ(manager.GetEntries()[0].m_nLastUse, nOne);
+	CHECK(manager.GetEntries()[0].m_bHidden);
+	CHECK_EQ(manager.GetEntries()[0].m_Usage.m_nHandles, 6);
+	manager.Track(&a, _T("one"), Usage(5, 6, 7), false);
+	CHECK(manager.GetEntries()[0].m_nLastUse > nTwo);
+	CHECK_EQ(manager.GetEntries().size(), 2);
+
+	// a layout first seen hidden still gets its place in the order
+	manager.Track(&a, _T("three"), Usage(1, 1, 1), true);
+	CHECK(manager.GetEntries()[2].m_nLastUse > manager.GetEntries()[0].m_nLastUse);
+
+	// keys are per owner
+	FakeNucleus b;
+	manager.Track(&b, _T("one"), Usage(1, 1, 1), true);
+	CHECK_EQ(manager.GetEntries().size(), 4);
+	manager.Remove(&b, _T("one"));
+	CHECK(Tracked(manager, &a, _T("one")));
+	CHECK(!Tracked(manager, &b, _T("one")));
+	manager.Remove(&b, _T("nothing"));
+	CHECK_EQ(manager.GetEntries().size(), 3);
+
+	manager.Track(&b, _T("one"), Usage(1, 1, 1), true);
+	manager.RemoveOwner(&a);
+	CHECK_EQ(manager.GetEntries().size(), 1);
+	CHECK(Tracked(manager, &b, _T("one")));
+}
+
+static void TestOwnerBudget()
+{
+	CLayoutEvictionManager manager;
+	manager.m_budgetNucleus = Budget(0, 10, 0);
+	manager.m_budgetGlobal = Budget(0, 0, 0);
+	FakeNucleus a, b;
+	const TCHAR* pszKeys[] = { _T("k0"), _T("k1"), _T("k2"), _T("k3"), _T("k4") };
+	for (auto psz : pszKeys)
+	{
+		a.m_mapLayouts[psz] = { Usage(1, 4, 100), false, false };
+		manager.Track(&a, psz, Usage(1, 4, 100), true);
+		b.m_mapLayouts[psz] = { Usage(1, 2, 100), false, false };
+		manager.Track(&b, psz, Usage(1, 2, 100), true);
+	}
+	// a uses 20 handles, b 10: only a is over, by its three oldest
+	vector<LayoutEntry> vVictims;
+	CHECK_EQ(manager.Collect(vVictims), 3);
+	for (int i = 0; i < 3; i++)
+	{
+		CHECK(vVictims[i].m_pOwner == &a);
+		CHECK(vVictims[i].m_strKey == pszKeys[i]);
+	}
+
+	// Collect only reports, nothing is untracked or counted yet
+	CHECK_EQ(manager.GetEntries().size(), 10);
+	CHECK_EQ(manager.m_nEvicted, 0);
+	CHECK_EQ(manager.Collect(vVictims), 3);
+
+	CHECK_EQ(Collect(manager, vVictims), 3);
+	CHECK_EQ(manager.m_nEvicted, 3);
+	CHECK_EQ(manager.GetEntries().size(), 7);
+	CHECK(a.m_setEvicted.count(_T("k0")) && a.m_setEvicted.count(_T("k2")));
+	CHECK(!Tracked(manager, &a, _T("k1")));
+	CHECK(Tracked(manager, &a, _T("k3")));
+	CHECK_EQ(manager.Collect(vVictims), 0);
+	CHECK_EQ(vVictims.size(), 0);
+
+	// the visible one is never taken, its usage still counts
+	manager.Track(&b, _T("big"), Usage(1, 9, 100), false);
+	CHECK_EQ(manager.Collect(vVictims), 5);
+	for (auto& it : vVictims)
+		CHECK(it.m_pOwner == &b && it.m_strKey != _T("big"));
+}
+
+static void TestGlobalBudget()
+{
+	CLayoutEvictionManager manager;
+	manager.m_budgetNucleus = Budget(0, 0, 0);
+	manager.m_budgetGlobal = Budget(0, 0, 1000);
+	FakeNucleus a, b;
+	// a0 b0 a1 b1 ... in the order shown, 200 bytes each
+	for (int i = 0; i < 4; i++)
+	{
+		CString strKey = i == 0 ? _T("x0") : i == 1 ? _T("x1") : i == 2 ? _T("x2") : _T("x3");
+		for (FakeNucleus* p : { &a, &b })
+		{
+			p->m_mapLayouts[strKey] = { Usage(1, 1, 200), false, false };
+			manager.Track(p, strKey, Usage(1, 1, 200), false);
+			manager.Track(p, strKey, Usage(1, 1, 200), true);
+		}
+	}
+	// 1600 bytes, the three oldest across both owners go
+	vector<LayoutEntry> vVictims;
+	CHECK_EQ(manager.Collect(vVictims), 3);
+	CHECK(vVictims[0].m_pOwner == &a && vVictims[0].m_strKey == _T("x0"));
+	CHECK(vVictims[1].m_pOwner == &b && vVictims[1].m_strKey == _T("x0"));
+	CHECK(vVictims[2].m_pOwner == &a && vVictims[2].m_strKey == _T("x1"));
+
+	// showing a0 again makes it the newest
+	manager.Track(&a, _T("x0"), Usage(1, 1, 200), false);
+	manager.Track(&a, _T("x0"), Usage(1, 1, 200), true);
+	CHECK_EQ(manager.Collect(vVictims), 3);
+	CHECK(vVictims[0].m_pOwner == &b && vVictims[0].m_strKey == _T("x0"));
+	CHECK(vVictims[2].m_pOwner == &b && vVictims[2].m_strKey == _T("x1"));
+}
+
+static void TestPinning()
+{
+	CLayoutEvictionManager manager;
+	manager.m_budgetNucleus = Budget(1, 0, 0);
+	manager.m_budgetGlobal = Budget(0, 0, 0);
+	FakeNucleus a;
+
+	// pinned before its first Track it counts as visible
+	manager.SetPinned(&a, _T("early"), true);
+	CHECK(manager.IsPinned(&a, _T("early")));
+	CHECK(!manager.GetEntries()[0].m_bHidden);
+	CHECK(!manager.IsPinned(&a, _T("unknown")));
+
+	manager.Track(&a, _T("early"), Usage(1, 1, 1), true);
+	CHECK(manager.IsPinned(&a, _T("early")));
+	a.m_mapLayouts[_T("plain")] = { Usage(1, 1, 1), false, false };
+	manager.Track(&a, _T("plain"), Usage(1, 1, 1), true);
+
+	vector<LayoutEntry> vVictims;
+	CHECK_EQ(manager.Collect(vVictims), 1);
+	CHECK(vVictims[0].m_strKey == _T("plain"));
+
+	// unpinned, it may go, and goes first as the older one
+	a.m_mapLayouts[_T("early")] = { Usage(1, 1, 1), false, false };
+	manager.SetPinned(&a, _T("early"), false);
+	CHECK(!manager.IsPinned(&a, _T("early")));
+	CHECK_EQ(manager.Collect(vVictims), 1);
+	CHECK(vVictims[0].m_strKey == _T("early"));
+	CHECK_EQ(Collect(manager, vVictims), 1);
+	CHECK_EQ(manager.GetEntries().size(), 1);
+	CHECK_EQ(manager.m_nEvicted, 1);
+}
+
+static void TestRefused()
+{
+	CLayoutEvictionManager manager;
+	manager.m_budgetNucleus = Budget(2, 0, 0);
+	manager.m_budgetGlobal = Budget(0, 0, 0);
+	FakeNucleus a;
+	const TCHAR* pszKeys[] = { _T("gone"), _T("shown"), _T("pinned"), _T("ok1"), _T("ok2"), _T("keep1"), _T("keep2") };
+	for (auto psz : pszKeys)
+	{
+		a.m_mapLayouts[psz] = { Usage(1, 1, 1), false, false };
+		manager.Track(&a, psz, Usage(1, 1, 1), true);
+	}
+	// what the manager was told no longer holds: the first is gone, the
+	// second shown again and the third pinned by its content
+	a.m_mapLayouts.erase(_T("gone"));
+	a.m_mapLayouts[_T("shown")].m_bShown = true;
+	a.m_mapLayouts[_T("pinned")].m_bPinned = true;
+
+	vector<LayoutEntry> vVictims;
+	CHECK_EQ(manager.Collect(vVictims), 5);
+	CHECK_EQ(Collect(manager, vVictims), 2);
+	CHECK_EQ(manager.m_nEvicted, 2);
+	CHECK(a.m_setEvicted.count(_T("ok1")) && a.m_setEvicted.count(_T("ok2")));
+
+	// the refused ones are corrected instead of counted
+	CHECK(!Tracked(manager, &a, _T("gone")));
+	CHECK(Tracked(manager, &a, _T("shown")));
+	CHECK(Tracked(manager, &a, _T("pinned")));
+	CHECK(manager.IsPinned(&a, _T("pinned")));
+	for (auto& entry : manager.GetEntries())
+	{
+		if (entry.m_strKey == _T("shown"))
+			CHECK(!entry.m_bHidden);
+	}
+	CHECK_EQ(manager.GetEntries().size(), 4);
+
+	// and are not picked again: only the two kept are left to take, with
+	// the shown and the pinned one over the budget already
+	CHECK_EQ(manager.Collect(vVictims), 2);
+	for (auto& it : vVictims)
+		CHECK(it.m_strKey == _T("keep1") || it.m_strKey == _T("keep2"));
+	CHECK_EQ(Collect(manager, vVictims), 2);
+	CHECK_EQ(manager.m_nEvicted, 4);
+	CHECK_EQ(manager.Collect(vVictims), 0);
+}
+
+// a policy that wants everything, twice and out of range
+class CGreedyPolicy : public ILayoutEvictionPolicy
+{
+public:
+	virtual void SelectVictims(const vector<LayoutEntry>& vEntries, const LayoutBudget&, const LayoutBudget&, vector<int>& vVictims)
+	{
+		for (int i = (int)vEntries.size(); i >= -1; i--)
+		{
+			vVictims.push_back(i);
+			vVictims.push_back(i);
+		}
+	}
+};
+
+static void TestPolicy()
+{
+	CLayoutEvictionManager manager;
+	manager.SetPolicy(shared_ptr<ILayoutEvictionPolicy>());		// ignored
+	manager.SetPolicy(make_shared<CGreedyPolicy>());
+	FakeNucleus a;
+	manager.Track(&a, _T("hidden1"), Usage(1, 1, 1), true);
+	manager.Track(&a, _T("visible"), Usage(1, 1, 1), false);
+	manager.Track(&a, _T("hidden2"), Usage(1, 1, 1), true);
+	manager.Track(&a, _T("pinned"), Usage(1, 1, 1), true);
+	manager.SetPinned(&a, _T("pinned"), true);
+
+	vector<LayoutEntry> vVictims;
+	CHECK_EQ(manager.Collect(vVictims), 2);
+	CHECK(vVictims[0].m_strKey == _T("hidden1"));
+	CHECK(vVictims[1].m_strKey == _T("hidden2"));
+}
+
+// random layouts over random budgets, the policy against the reference and
+// what is left after TrackLayouts against the budgets
+static void TestRandom(unsigned nSeed, int nRounds)
+{
+	std::mt19937 rng(nSeed);
+	auto Pick = [&rng](int n) { return (int)(rng() % n); };
+
+	for (int nRound = 0; nRound < nRounds; nRound++)
+	{
+		CLayoutEvictionManager manager;
+		manager.m_budgetNucleus = Budget(Pick(2) ? 0 : 5 + Pick(40), Pick(2) ? 0 : 5 + Pick(40), Pick(2) ? 0 : 500 + Pick(4000));
+		manager.m_budgetGlobal = Budget(Pick(2) ? 0 : 20 + Pick(100), Pick(2) ? 0 : 20 + Pick(100), Pick(2) ? 0 : 2000 + Pick(10000));
+
+		vector<FakeNucleus> vNuclei(1 + Pick(4));
+		int nOps = 20 + Pick(60);
+		for (int n = 0; n < nOps; n++)
+		{
+			FakeNucleus& nucleus = vNuclei[Pick((int)vNuclei.size())];
+			CString strKey = CString(_T("key")) + to_string(Pick(12)).c_str();
+			LayoutUsage usage = Usage(1 + Pick(10), Pick(10), Pick(1000));
+			bool bHidden = Pick(3) != 0;
+			manager.Track(&nucleus, strKey, usage, bHidden);
+			nucleus.m_mapLayouts[strKey] = { usage, !bHidden, false };
+			if (Pick(8) == 0)
+			{
+				manager.SetPinned(&nucleus, strKey, true);
+				nucleus.m_mapLayouts[strKey].m_bPinned = true;
+			}
+		}
+		// now and then the nucleus knows better than the manager
+		for (auto& nucleus : vNuclei)
+		{
+			for (auto it = nucleus.m_mapLayouts.begin(); it != nucleus.m_mapLayouts.end();)
+			{
+				int nCase = Pick(12);
+				if (nCase == 0)
+				{
+					it = nucleus.m_mapLayouts.erase(it);
+					continue;
+				}
+				if (nCase == 1)
+					it->second.m_bShown = true;
+				else if (nCase == 2)
+					it->second.m_bPinned = true;
+				++it;
+			}
+		}
+
+		vector<LayoutEntry> vEntries = manager.GetEntries();
+		vector<int> vExpected = ReferenceVictims(vEntries, manager.m_budgetNucleus, manager.m_budgetGlobal);
+		vector<int> vIndex;
+		CLruLayoutEvictionPolicy policy;
+		policy.SelectVictims(vEntries, manager.m_budgetNucleus, manager.m_budgetGlobal, vIndex);
+		CHECK(vIndex == vExpected);
+
+		// Collect reports them in entry order
+		vector<LayoutEntry> vVictims;
+		CHECK_EQ(manager.Collect(vVictims), vExpected.size());
+		sort(vExpected.begin(), vExpected.end());
+		for (int i = 0; i < (int)vVictims.size() && i < (int)vExpected.size(); i++)
+		{
+			CHECK(vVictims[i].m_pOwner == vEntries[vExpected[i]].m_pOwner);
+			CHECK(vVictims[i].m_strKey == vEntries[vExpected[i]].m_strKey);
+		}
+
+		// a few rounds settle it: every victim is evicted, untracked or
+		// corrected, so each round leaves fewer candidates
+		long nEvicted = 0;
+		for (int nPass = 0; nPass < 100 && manager.Collect(vVictims); nPass++)
+			nEvicted += Collect(manager, vVictims);
+		CHECK_EQ(manager.Collect(vVictims), 0);
+		CHECK_EQ(manager.m_nEvicted, nEvicted);
+
+		size_t nGone = 0;
+		for (auto& nucleus : vNuclei)
+		{
+			nGone += nucleus.m_setEvicted.size();
+			for (auto& strKey : nucleus.m_setEvicted)
+				CHECK(!Tracked(manager, &nucleus, strKey));
+		}
+		CHECK_EQ(nGone, nEvicted);
+
+		// what is left fits, or has nothing more that could go
+		set<int> setNone;
+		const vector<LayoutEntry>& vLeft = manager.GetEntries();
+		bool bCandidates = false;
+		map<void*, bool> mapCandidates;
+		for (auto& entry : vLeft)
+		{
+			if (entry.m_bHidden && !entry.m_bPinned)
+			{
+				bCandidates = true;
+				mapCandidates[entry.m_pOwner] = true;
+			}
+		}
+		CHECK(!CLayoutEvictionManager::IsOver(Total(vLeft, setNone, NULL), manager.m_budgetGlobal) || !bCandidates);
+		for (auto& nucleus : vNuclei)
+			CHECK(!CLayoutEvictionManager::IsOver(Total(vLeft, setNone, &nucleus), manager.m_budgetNucleus) || !mapCandidates[&nucleus]);
+	}
+}
+
+int main()
+{
+	TestIsOver();
+	TestTrack();
+	TestOwnerBudget();
+	TestGlobalBudget();
+	TestPinning();
+	TestRefused();
+	TestPolicy();
+	TestRandom(1, 3000);
+	return TestResult("LayoutEvictionTest");
+}
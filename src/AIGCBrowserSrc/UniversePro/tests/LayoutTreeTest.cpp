@@ -0,0 +1,277 @@
+// LayoutTreeTest.cpp : the COM-free prepare step of CLayoutPlan
+//
+// CLayoutTree reads the xobj tree and the splitter sizes of a layout the way
+// the prepare phase does on the worker pool: from layout text, from a layout
+// file and after the JSON conversion, and it gives up on a request that is
+// no longer current. The layouts of a hubble page file are read by their
+// lowercased keys, below the application's document element.
+
+#include "stdafx.h"
+#include "LayoutTree.h"
+#include "TestCheck.h"
+
+static const char* const s_pszFile = "out/LayoutTreeTest.xml";
+static const char* const s_pszPageFile = "out/LayoutTreeTest.page.xml";
+
+static const char* const s_pszPage =
+	"<?xml version='1.0' encoding='utf-8'?>\n"
+	"<MyApp>\n"
+	"  <defaultworkbench><Home/></defaultworkbench>\n"
+	"  <HubblePage>\n"
+	"    <other><Main><Home><nucleus><xobj name='other'/></nucleus></Home></Main></other>\n"
+	"    <Config1>\n"
+	"      <Main>\n"
+	"        <Home caption='h'><nucleus><xobj name='home'/></nucleus></Home>\n"
+	"        <settings><nucleus><xobj name='settings'/></nucleus></settings>\n"
+	"      </Main>\n"
+	"      <side>\n"
+	"        <Home><nucleus><xobj name='side'/></nucleus></Home>\n"
+	"      </side>\n"
+	"    </Config1>\n"
+	"  </HubblePage>\n"
+	"</MyApp>\n";
+
+static const char* const s_pszLayout =
+	"<default caption='Main' sizable='True'>"
+	"<nucleus>"
+	"<xobj name='root' objid='nucleus' rows='1' cols='2' width='200,' height='300' galaxy='main'>"
+	"<xobj name='left' objid='tree'/>"
+	"<property name='skipped'><xobj name='notalayout'/></property>"
+	"<XOBJ name='right' rows='2' cols='1' height='100,50'>"
+	"<xobj name='top'/>"
+	"<xobj name='bottom'><xobj name='deep'/></xobj>"
+	"</XOBJ>"
+	"</xobj>"
+	"<xobj name='second'/>"
+	"</nucleus>"
+	"</default>";
+
+struct ExpectedNode
+{
+	const char* m_pszName;
+	int m_nParent;
+	int m_nDepth;
+};
+
+static const ExpectedNode s_expected[] = {
+	{ "root", -1, 0 },
+	{ "left", 0, 1 },
+	{ "right", 0, 1 },
+	{ "top", 2, 2 },
+	{ "bottom", 2, 2 },
+	{ "deep", 4, 3 },
+};
+
+static void CheckLayout(const CLayoutTree& tree)
+{
+	CHECK(tree.IsValid());
+	CHECK_EQ(tree.m_vNodes.size(), sizeof(s_expected) / sizeof(s_expected[0]));
+	for (size_t i = 0; i < tree.m_vNodes.size() && i < sizeof(s_expected) / sizeof(s_expected[0]); i++)
+	{
+		CHECK(tree.m_vNodes[i].m_strName == s_expected[i].m_pszName);
+		CHECK_EQ(tree.m_vNodes[i].m_nParent, s_expected[i].m_nParent);
+		CHECK_EQ(tree.m_vNodes[i].m_nDepth, s_expected[i].m_nDepth);
+	}
+	CHECK(tree.m_strCaption == "Main");
+	CHECK(tree.m_bSizable);
+	CHECK(tree.m_strGalaxy == "main");
+	CHECK_EQ(tree.m_nSplitterCount, 2);
+	if (tree.m_vNodes.size() < 3)
+		return;
+
+	const LayoutTreeNode& root = tree.m_vNodes[0];
+	CHECK(root.m_strObjID == "nucleus");
+	CHECK_EQ(root.m_vWidth.size(), 2);
+	CHECK_EQ(root.m_vWidth[0], 200);
+	CHECK_EQ(root.m_vWidth[1], 0);
+	CHECK_EQ(root.m_vHeight.size(), 1);
+	CHECK_EQ(root.m_vHeight[0], 300);
+	CHECK_EQ(tree.m_vNodes[1].m_vWidth.size(), 0);
+	const LayoutTreeNode& right = tree.m_vNodes[2];
+	CHECK(right.m_strTag == "XOBJ");
+	CHECK_EQ(right.m_vWidth.size(), 1);
+	CHECK_EQ(right.m_vWidth[0], 0);
+	CHECK_EQ(right.m_vHeight.size(), 2);
+	CHECK_EQ(right.m_vHeight[0], 100);
+	CHECK_EQ(right.m_vHeight[1], 50);
+}
+
+static CString JsonToLayout(const CString& strJson)
+{
+	return strJson == "{\"layout\":1}" ? CString(s_pszLayout) : CString("");
+}
+
+static void TestNormalize()
+{
+	CString strError;
+	CHECK(CLayoutTree::Normalize(CString(" \r\n<a/>\t"), JsonToLayout, strError) == "<a/>");
+	CHECK(strError == "");
+	CHECK(CLayoutTree::Normalize(CString("{\"layout\":1}"), JsonToLayout, strError) == s_pszLayout);
+	CHECK(strError == "");
+	CHECK(CLayoutTree::Normalize(CString("{\"layout\":2}"), JsonToLayout, strError) == "");
+	CHECK(strError == "json conversion failed");
+	strError = "";
+	CHECK(CLayoutTree::Normalize(CString("{}"), NULL, strError) == "");
+	CHECK(strError == "json conversion failed");
+}
+
+static void TestSizeList()
+{
+	vector<int> vSize;
+	CLayoutTree::ParseSizeList(CString("10,20"), 3, vSize);
+	CHECK_EQ(vSize.size(), 3);
+	CHECK_EQ(vSize[0], 10);
+	CHECK_EQ(vSize[1], 20);
+	CHECK_EQ(vSize[2], 0);
+	CLayoutTree::ParseSizeList(CString("5,,7,9"), 3, vSize);
+	CHECK_EQ(vSize[0], 5);
+	CHECK_EQ(vSize[1], 0);
+	CHECK_EQ(vSize[2], 7);
+	CLayoutTree::ParseSizeList(CString(""), 2, vSize);
+	CHECK_EQ(vSize.size(), 2);
+	CHECK_EQ(vSize[0] + vSize[1], 0);
+}
+
+static void TestSources(std::atomic<long>& nGeneration)
+{
+	CLayoutTree text;
+	CHECK(text.Build(CString(s_pszLayout), nGeneration.load(), nGeneration));
+	CheckLayout(text);
+	CHECK(text.GetSize() > 0);
+
+	FILE* pFile = fopen(s_pszFile, "w");
+	CHECK(pFile != NULL);
+	if (pFile)
+	{
+		fputs(s_pszLayout, pFile);
+		fclose(pFile);
+	}
+	CLayoutTree file;
+	CHECK(file.Build(CString(s_pszFile), nGeneration.load(), nGeneration));
+	CheckLayout(file);
+	remove(s_pszFile);
+
+	CString strError;
+	CLayoutTree json;
+	CHECK(json.Build(CLayoutTree::Normalize(CString("{\"layout\":1}"), JsonToLayout, strError), nGeneration.load(), nGeneration));
+	CheckLayout(json);
+}
+
+static void TestInvalid(std::atomic<long>& nGeneration)
+{
+	// nothing to build windows from: no error from the parser, but no tree
+	CLayoutTree noNucleus;
+	CHECK(noNucleus.Build(CString("<default><xobj name='a'/></default>"), nGeneration.load(), nGeneration));
+	CHECK(noNucleus.IsValid() == false);
+	CHECK(noNucleus.m_strError == "layout has no nucleus/xobj element");
+
+	CLayoutTree noXobj;
+	CHECK(noXobj.Build(CString("<default><nucleus><grid/></nucleus></default>"), nGeneration.load(), nGeneration));
+	CHECK(noXobj.IsValid() == false);
+
+	CLayoutTree broken;
+	CHECK(broken.Build(CString("<default><nucleus><xobj></nucleus>"), nGeneration.load(), nGeneration));
+	CHECK(broken.IsValid() == false);
+	CHECK(broken.m_strError != "");
+
+	CLayoutTree missing;
+	CHECK(missing.Build(CString("out/LayoutTreeTest.missing.xml"), nGeneration.load(), nGeneration));
+	CHECK(missing.IsValid() == false);
+	CHECK(missing.m_strError != "");
+}
+
+static CString DeepLayout(int nDepth, int nSiblings)
+{
+	// a chain nDepth xobjs deep, each level with nSiblings leaves after the chain
+	string strXml = "<deep><nucleus>";
+	for (int i = 0; i < nDepth; i++)
+		strXml += "<xobj name='c" + to_string(i) + "'>";
+	for (int i = nDepth - 1; i >= 0; i--)
+	{
+		strXml += "</xobj>";
+		for (int j = 0; j < nSiblings && i > 0; j++)
+			strXml += "<xobj name='s" + to_string(i) + "_" + to_string(j) + "'/>";
+	}
+	strXml += "</nucleus></deep>";
+	return CString(strXml);
+}
+
+static void TestDeepTree(std::atomic<long>& nGeneration)
+{
+	const int nDepth = 400;
+	const int nSiblings = 2;
+	CString strXml = DeepLayout(nDepth, nSiblings);
+	CLayoutTree tree;
+	CHECK(tree.Build(strXml, nGeneration.load(), nGeneration));
+	CHECK_EQ(tree.m_vNodes.size(), nDepth + (nDepth - 1) * nSiblings);
+	// the chain comes first in document order, every link one level deeper
+	bool bChain = true;
+	for (int i = 0; i < nDepth && i < (int)tree.m_vNodes.size(); i++)
+		bChain = bChain && tree.m_vNodes[i].m_nDepth == i && tree.m_vNodes[i].m_nParent == i - 1;
+	CHECK(bChain);
+	// the leaves after c<i> are its siblings, children of c<i-1>
+	bool bLeaves = true;
+	for (size_t i = nDepth; i < tree.m_vNodes.size(); i++)
+	{
+		const LayoutTreeNode& node = tree.m_vNodes[i];
+		int nLevel = atoi((LPCTSTR)node.m_strName + 1);
+		bLeaves = bLeaves && node.m_nDepth == nLevel && node.m_nParent == nLevel - 1;
+	}
+	CHECK(bLeaves);
+
+	// a request that is no longer current stops instead of building
+	CLayoutTree stale;
+	long nStale = nGeneration.load();
+	nGeneration++;
+	CHECK(stale.Build(strXml, nStale, nGeneration) == false);
+	CHECK_EQ(stale.m_vNodes.size(), 0);
+}
+
+static void TestPageFile(std::atomic<long>& nGeneration)
+{
+	FILE* pFile = fopen(s_pszPageFile, "w");
+	CHECK(pFile != NULL);
+	if (pFile)
+	{
+		fputs(s_pszPage, pFile);
+		fclose(pFile);
+	}
+
+	// keys as Observe looks them up: lowercased key, nucleus and config as named
+	map<CString, CString> mapXml;
+	CHECK(CLayoutTree::ReadPageLayouts(CString(s_pszPageFile), CString("config1"), mapXml));
+	CHECK_EQ(mapXml.size(), 3);
+	CHECK(mapXml[CString("home@Main@config1")] == "<Home caption='h'><nucleus><xobj name='home'/></nucleus></Home>");
+	CHECK(mapXml[CString("settings@Main@config1")] == "<settings><nucleus><xobj name='settings'/></nucleus></settings>");
+	CHECK(mapXml.find(CString("home@side@config1")) != mapXml.end());
+	CHECK(mapXml.find(CString("Home@Main@config1")) == mapXml.end());
+
+	// what was read is a layout the prepare step builds
+	CLayoutTree tree;
+	CHECK(tree.Build(mapXml[CString("home@side@config1")], nGeneration.load(), nGeneration));
+	CHECK_EQ(tree.m_vNodes.size(), 1);
+	CHECK(tree.m_vNodes.size() && tree.m_vNodes[0].m_strName == "side");
+
+	// other configs, a missing config and a missing file give nothing
+	map<CString, CString> mapOther;
+	CHECK(CLayoutTree::ReadPageLayouts(CString(s_pszPageFile), CString("other"), mapOther));
+	CHECK_EQ(mapOther.size(), 1);
+	CHECK(mapOther.find(CString("home@Main@other")) != mapOther.end());
+	map<CString, CString> mapNone;
+	CHECK(CLayoutTree::ReadPageLayouts(CString(s_pszPageFile), CString("config2"), mapNone) == false);
+	CHECK(CLayoutTree::ReadPageLayouts(CString("out/LayoutTreeTest.missing.xml"), CString("config1"), mapNone) == false);
+	CHECK_EQ(mapNone.size(), 0);
+	remove(s_pszPageFile);
+}
+
+int main()
+{
+	std::atomic<long> nGeneration(1);
+	TestNormalize();
+	TestSizeList();
+	TestSources(nGeneration);
+	TestInvalid(nGeneration);
+	TestDeepTree(nGeneration);
+	TestPageFile(nGeneration);
+	return TestResult("LayoutTreeTest");
+}
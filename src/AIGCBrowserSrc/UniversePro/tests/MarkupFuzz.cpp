@@ -0,0 +1,125 @@
+// MarkupFuzz.cpp : CMarkup on arbitrary layout text
+//
+// Every document is walked the way the layout code reads it. One CMarkup
+// calls well formed is rebuilt through the CMarkup writer, and the rebuilt
+// document must read back to the same elements, attributes and data.
+// CMarkup also calls documents with malformed names well formed (an
+// attribute "&#;" without a value, say), MSXML rejects those and the
+// writer cannot reproduce them, so they are only walked.
+
+#include "stdafx.h"
+#include "Markup.h"
+#include "FuzzDriver.h"
+
+static const char* const s_pszSeeds[] = {
+	"<layout name=\"main\"><nucleus id=\"n1\"><xobj id=\"a\" objid=\"xobj\"/><xobj id=\"b\" width=\"200\">text</xobj></nucleus></layout>",
+	"<?xml version=\"1.0\" encoding=\"utf-8\"?>\n<!-- page --><window style='11' caption=\"A &amp; &lt;B&gt; &#65;&#x42;\">\n  <xobj id=\"left\"><![CDATA[<raw> & data]]></xobj>\n</window>",
+	"<a><b c=\"1\" c=\"2\"/><b>&unknown; &#0; &#xFFFFFFFF;</b></a>",
+	"<a x=unquoted><b></a></b>",
+	"<hubblepage><main><layout1><window/></layout1></main></hubblepage><second/>",
+	"<!DOCTYPE a [<!ENTITY e \"x\">]><a>&e;<?pi data?></a>",
+};
+
+const FuzzSeeds g_FuzzSeeds = { s_pszSeeds, sizeof(s_pszSeeds) / sizeof(s_pszSeeds[0]) };
+
+// deeper documents are still parsed and walked, only not rebuilt
+static const int FUZZ_MAX_DEPTH = 200;
+
+static bool IsName(const string& strName)
+{
+	if (strName.empty())
+		return false;
+	for (size_t i = 0; i < strName.size(); i++)
+	{
+		unsigned char c = (unsigned char)strName[i];
+		bool bStart = c >= 0x80 || isalpha(c) || c == '_' || c == ':';
+		if (!(bStart || (i > 0 && (isdigit(c) || c == '-' || c == '.'))))
+			return false;
+	}
+	return true;
+}
+
+// a repeated attribute reads as its first value, so it is listed once
+static void AttribNames(CMarkup& xml, vector<string>& vNames)
+{
+	for (int n = 0; ; n++)
+	{
+		string strName = xml.GetAttribName(n);
+		if (strName == "")
+			break;
+		if (find(vNames.begin(), vNames.end(), strName) == vNames.end())
+			vNames.push_back(strName);
+	}
+}
+
+// the elements below the current position, as a line per element
+static void Walk(CMarkup& xml, int nDepth, string& strOut, int& nMaxDepth, bool& bNames)
+{
+	nMaxDepth = max(nMaxDepth, nDepth);
+	while (xml.FindElem())
+	{
+		strOut += string(nDepth, ' ') + "<" + xml.GetTagName();
+		bNames = bNames && IsName(xml.GetTagName());
+		vector<string> vNames;
+		AttribNames(xml, vNames);
+		for (auto& strName : vNames)
+		{
+			strOut += " " + strName + "=" + xml.GetAttrib(strName);
+			bNames = bNames && IsName(strName);
+		}
+		strOut += ">";
+		string strChildren;
+		xml.IntoElem();
+		Walk(xml, nDepth + 1, strChildren, nMaxDepth, bNames);
+		xml.OutOfElem();
+		// the layout code reads data from leaves only
+		if (strChildren == "")
+			strOut += xml.GetData();
+		strOut += "\n" + strChildren;
+	}
+}
+
+static void Rebuild(CMarkup& xml, CMarkup& out)
+{
+	while (xml.FindElem())
+	{
+		FUZZ_CHECK(out.AddElem(xml.GetTagName()));
+		vector<string> vNames;
+		AttribNames(xml, vNames);
+		for (auto& strName : vNames)
+			FUZZ_CHECK(out.SetAttrib(strName, xml.GetAttrib(strName)));
+		xml.IntoElem();
+		out.IntoElem();
+		bool bChildren = xml.FindElem();
+		xml.ResetMainPos();
+		Rebuild(xml, out);
+		out.OutOfElem();
+		xml.OutOfElem();
+		if (bChildren == false && xml.GetData() != "")
+			FUZZ_CHECK(out.SetData(xml.GetData()));
+	}
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* pData, size_t nSize)
+{
+	std::string strDoc((const char*)pData, nSize);
+	CMarkup xml;
+	bool bWellFormed = xml.SetDoc(strDoc);
+	string strElems;
+	int nMaxDepth = 0;
+	bool bNames = true;
+	Walk(xml, 0, strElems, nMaxDepth, bNames);
+	if (bWellFormed == false || bNames == false || nMaxDepth > FUZZ_MAX_DEPTH)
+		return 0;
+
+	xml.ResetPos();
+	CMarkup out;
+	Rebuild(xml, out);
+	CMarkup reread;
+	FUZZ_CHECK(reread.SetDoc(out.GetDoc()));
+	string strRereadElems;
+	nMaxDepth = 0;
+	Walk(reread, 0, strRereadElems, nMaxDepth, bNames);
+	FUZZ_CHECK(strRereadElems == strElems);
+	return 0;
+}
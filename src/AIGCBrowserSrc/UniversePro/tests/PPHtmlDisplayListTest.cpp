@@ -0,0 +1,195 @@
+// PPHtmlDisplayListTest.cpp : CPPHtmlDisplayList, the segments CPPHtmlDrawer
+// replays
+//
+// Parse is checked against a golden table: for every segment the items the
+// drawer's old SearchNextTag/SplitTag loop stepped through, written out by
+// hand. The list itself is checked for its hits and misses, for dropping the
+// least recently used segment, and against a plain list of the segments kept
+// in use order under random finds and inserts.
+
+#include "stdafx.h"
+#include "PPHtmlDisplayList.h"
+#include "TestCheck.h"
+
+#include <algorithm>
+#include <random>
+#include <string>
+
+// The items one per line as "text|tag|properties"
+static std::string Dump(const CPPHtmlDisplayList::vecItems& items)
+{
+	std::string s;
+	for (size_t i = 0; i < items.size(); i++)
+	{
+		s += (LPCTSTR)items[i].sText;
+		s += "|";
+		s += (LPCTSTR)items[i].sTag;
+		s += "|";
+		s += (LPCTSTR)items[i].sProperties;
+		s += "\n";
+	}
+	return s;
+}
+
+static void TestParse()
+{
+	static const struct
+	{
+		const char* pszHtml;
+		const char* pszItems;
+	} s_aCases[] = {
+		{ "", "" },
+		{ "hello", "hello||\n" },
+		{ "a<b>c</b>", "a|b|\nc|/b|\n" },
+		{ "<b>  <i>", "|b|\n  |i|\n" },
+		// "<<" is the char '<', it ends the item
+		{ "x<<y", "x<||\ny||\n" },
+		{ "a<", "a<||\n" },
+		{ "<<b>", "<||\nb>||\n" },
+		// the properties follow the first ' ' or '=', without the leading spaces
+		{ "<font color=red size=2>t", "|font|color=red size=2\nt||\n" },
+		{ "<font  face='Arial'>", "|font|face='Arial'\n" },
+		{ "<a=1>", "|a|=1\n" },
+		{ "<br >", "|br|\n" },
+		{ "<span class=\"x y\">z</span>", "|span|class=\"x y\"\nz|/span|\n" },
+		// an empty or unterminated tag is skipped by its '<' only
+		{ "<>x", "||\n>x||\n" },
+		{ "ab<cd", "ab||\ncd||\n" },
+		{ "ab<c>d<e", "ab|c|\nd||\ne||\n" },
+	};
+
+	for (size_t i = 0; i < sizeof(s_aCases) / sizeof(s_aCases[0]); i++)
+	{
+		CPPHtmlDisplayList::vecItems items;
+		CPPHtmlDisplayList::Parse(s_aCases[i].pszHtml, items);
+		std::string sItems = Dump(items);
+		if (sItems != s_aCases[i].pszItems)
+			fprintf(stderr, "Parse(\"%s\"):\n%s", s_aCases[i].pszHtml, sItems.c_str());
+		CHECK(sItems == s_aCases[i].pszItems);
+		for (size_t n = 0; n < items.size(); n++)
+		{
+			// resolved by the drawer
+			CHECK_EQ(items[n].dwTag, 0);
+			CHECK(!items[n].bCloseTag);
+			CHECK(items[n].strFullName.IsEmpty());
+		}
+	}
+}
+
+static CPPHtmlDisplayList::ITEMSPTR Insert(CPPHtmlDisplayList& list, const char* pszHtml)
+{
+	CPPHtmlDisplayList::vecItems items;
+	CPPHtmlDisplayList::Parse(pszHtml, items);
+	return list.Insert(pszHtml, items);
+}
+
+static void TestList()
+{
+	CPPHtmlDisplayList list(3);
+	CHECK(list.Find("a<b>") == NULL);
+	CHECK_EQ(list.GetMisses(), 1);
+
+	// the items are taken over
+	CPPHtmlDisplayList::vecItems items;
+	CPPHtmlDisplayList::Parse("a<b>", items);
+	CPPHtmlDisplayList::ITEMSPTR pItems = list.Insert("a<b>", items);
+	CHECK(items.empty());
+	CHECK(pItems != NULL);
+	CHECK(Dump(*pItems) == "a|b|\n");
+	CHECK(list.Find("a<b>") == pItems);
+	CHECK_EQ(list.GetHits(), 1);
+
+	Insert(list, "b");
+	Insert(list, "c");
+	CHECK_EQ(list.GetCount(), 3);
+
+	// "a<b>" was used last, so "b" is the one dropped
+	CHECK(list.Find("a<b>") == pItems);
+	Insert(list, "d");
+	CHECK_EQ(list.GetCount(), 3);
+	CHECK(list.Find("b") == NULL);
+	CHECK(list.Find("a<b>") == pItems);
+	CHECK(list.Find("c") != NULL);
+	CHECK(list.Find("d") != NULL);
+	CHECK_EQ(list.GetHits(), 5);
+	CHECK_EQ(list.GetMisses(), 2);
+
+	// a segment inserted again replaces its items
+	CPPHtmlDisplayList::ITEMSPTR pAgain = Insert(list, "a<b>");
+	CHECK_EQ(list.GetCount(), 3);
+	CHECK(pAgain != pItems);
+	CHECK(list.Find("a<b>") == pAgain);
+
+	// the items stay valid for whoever holds them
+	list.SetMaxSegments(1);
+	CHECK_EQ(list.GetMaxSegments(), 1);
+	CHECK_EQ(list.GetCount(), 1);
+	CHECK(list.Find("a<b>") == pAgain);
+	CHECK(list.Find("d") == NULL);
+	list.Clear();
+	CHECK_EQ(list.GetCount(), 0);
+	CHECK(list.Find("a<b>") == NULL);
+	CHECK(Dump(*pItems) == "a|b|\n");
+	CHECK(Dump(*pAgain) == "a|b|\n");
+
+	// nothing is kept, the items are still returned
+	CPPHtmlDisplayList none(0);
+	CPPHtmlDisplayList::ITEMSPTR pNone = Insert(none, "x<y>");
+	CHECK(pNone != NULL);
+	CHECK(Dump(*pNone) == "x|y|\n");
+	CHECK_EQ(none.GetCount(), 0);
+	CHECK(none.Find("x<y>") == NULL);
+}
+
+// the list against the segments kept in use order, most recently used first
+static void TestRandom(unsigned nSeed, int nSteps)
+{
+	std::mt19937 rng(nSeed);
+	const size_t nMax = 8;
+	CPPHtmlDisplayList list(nMax);
+	std::vector<std::string> vUsed;
+	size_t nHits = 0, nMisses = 0;
+
+	for (int nStep = 0; nStep < nSteps; nStep++)
+	{
+		std::string sHtml = "<b>" + std::to_string(rng() % 20) + "</b>";
+		std::vector<std::string>::iterator iter = std::find(vUsed.begin(), vUsed.end(), sHtml);
+		bool bKept = iter != vUsed.end();
+		if (bKept)
+			vUsed.erase(iter);
+
+		CPPHtmlDisplayList::ITEMSPTR pItems = list.Find(sHtml.c_str());
+		CHECK_EQ(pItems != NULL, bKept);
+		if (pItems)
+		{
+			nHits++;
+			CHECK(Dump(*pItems) == "|b|\n" + sHtml.substr(3, sHtml.size() - 7) + "|/b|\n");
+		}
+		else
+		{
+			nMisses++;
+			Insert(list, sHtml.c_str());
+		}
+		vUsed.insert(vUsed.begin(), sHtml);
+		if (vUsed.size() > nMax)
+			vUsed.pop_back();
+
+		if (rng() % 500 == 0)
+		{
+			list.Clear();
+			vUsed.clear();
+		}
+		CHECK_EQ(list.GetCount(), vUsed.size());
+	}
+	CHECK_EQ(list.GetHits(), nHits);
+	CHECK_EQ(list.GetMisses(), nMisses);
+}
+
+int main()
+{
+	TestParse();
+	TestList();
+	TestRandom(1, 5000);
+	TestRandom(2, 5000);
+	return TestResult("PPHtmlDisplayListTest");
+}
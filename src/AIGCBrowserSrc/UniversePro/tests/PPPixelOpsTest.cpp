@@ -0,0 +1,121 @@
+// PPPixelOpsTest.cpp : every SIMD kernel against the scalar reference,
+// byte for byte, on the instruction sets this CPU has
+
+#include "stdafx.h"
+#include "PPPixelOps.h"
+#include "TestCheck.h"
+
+#include <random>
+
+static mt19937 g_rng(20261019);
+
+static vector<uint32_t> RandomPixels(size_t nCount, bool bPremultiplied)
+{
+	vector<uint32_t> v(nCount);
+	for (auto& c : v)
+	{
+		c = (uint32_t)g_rng();
+		// runs of the extremes, where saturation and the /255 rounding bite
+		switch (g_rng() % 8)
+		{
+		case 0: c |= 0xFF000000; break;
+		case 1: c &= 0x00FFFFFF; break;
+		case 2: c = 0xFFFFFFFF; break;
+		case 3: c = 0; break;
+		}
+		if (bPremultiplied)
+		{
+			uint32_t a = c >> 24, r = c & 0xFF000000;
+			for (int nShift = 0; nShift < 24; nShift += 8)
+				r |= (((c >> nShift) & 0xFF) * a / 255) << nShift;
+			c = r;
+		}
+	}
+	return v;
+}
+
+// runs one operation at the reference level and at nLevel on the same input
+template <class Op>
+static bool SameBytes(int nLevel, size_t nCount, size_t nOffset, bool bPremultiplied, Op op)
+{
+	// an offset into the buffer leaves the kernels' loads unaligned
+	vector<uint32_t> vSrc = RandomPixels(nCount + nOffset, bPremultiplied);
+	vector<uint32_t> vDest = RandomPixels(nCount + nOffset, false);
+	vector<uint32_t> vRef = vDest;
+	CPPPixelOps::SetLevel(CPPPixelOps::PIXELOPS_SCALAR);
+	op(vRef.data() + nOffset, vSrc.data() + nOffset, nCount);
+	CPPPixelOps::SetLevel(nLevel);
+	op(vDest.data() + nOffset, vSrc.data() + nOffset, nCount);
+	return vRef == vDest;
+}
+
+static void TestLevel(int nLevel)
+{
+	CHECK_EQ(CPPPixelOps::SetLevel(nLevel), nLevel);
+	for (size_t nCount = 0; nCount < 80; nCount++)
+	{
+		for (size_t nOffset = 0; nOffset < 3; nOffset++)
+		{
+			for (int a : { 0, 1, 127, 128, 254, 255, (int)(g_rng() & 0xFF) })
+			{
+				CHECK(SameBytes(nLevel, nCount, nOffset, false, [a](uint32_t* d, const uint32_t* s, size_t n) { CPPPixelOps::Blend(d, s, n, (uint8_t)a); }));
+				uint32_t dwColor = (uint32_t)g_rng();
+				CHECK(SameBytes(nLevel, nCount, nOffset, false, [a, dwColor](uint32_t* d, const uint32_t*, size_t n) { CPPPixelOps::Tint(d, n, dwColor, (uint8_t)a); }));
+			}
+			CHECK(SameBytes(nLevel, nCount, nOffset, true, [](uint32_t* d, const uint32_t* s, size_t n) { CPPPixelOps::BlendOver(d, s, n); }));
+			CHECK(SameBytes(nLevel, nCount, nOffset, false, [](uint32_t* d, const uint32_t*, size_t n) { CPPPixelOps::Premultiply(d, n); }));
+			CHECK(SameBytes(nLevel, nCount, nOffset, false, [](uint32_t* d, const uint32_t*, size_t n) { CPPPixelOps::Grayscale(d, n); }));
+			CHECK(SameBytes(nLevel, nCount, nOffset, false, [](uint32_t* d, const uint32_t*, size_t n) { CPPPixelOps::Invert(d, n); }));
+			CHECK(SameBytes(nLevel, nCount, nOffset, false, [](uint32_t* d, const uint32_t* s, size_t n) { CPPPixelOps::DarkenByMask(d, s, n); }));
+			for (unsigned int nScale : { 0u, 1u, 192u, 255u, 256u, 257u, 320u, 1023u, 1024u, (unsigned int)(g_rng() % 1025) })
+				CHECK(SameBytes(nLevel, nCount, nOffset, false, [nScale](uint32_t* d, const uint32_t*, size_t n) { CPPPixelOps::Scale(d, n, nScale); }));
+		}
+
+		// the key at every position, and missing
+		vector<uint32_t> vBits = RandomPixels(nCount, false);
+		for (size_t nAt = 0; nAt <= nCount; nAt++)
+		{
+			uint32_t dwKey = nAt < nCount ? vBits[nAt] : 0x12345678;
+			CPPPixelOps::SetLevel(CPPPixelOps::PIXELOPS_SCALAR);
+			size_t nRef = CPPPixelOps::FindColorKey(vBits.data(), nCount, dwKey);
+			bool bRef = CPPPixelOps::HasAlpha(vBits.data(), nCount);
+			CPPPixelOps::SetLevel(nLevel);
+			CHECK_EQ(CPPPixelOps::FindColorKey(vBits.data(), nCount, dwKey), nRef);
+			CHECK_EQ(CPPPixelOps::HasAlpha(vBits.data(), nCount), bRef);
+		}
+	}
+}
+
+static void TestReference()
+{
+	// the scalar kernels themselves, on values worked out by hand
+	CPPPixelOps::SetLevel(CPPPixelOps::PIXELOPS_SCALAR);
+	uint32_t c = 0x80FF4000;
+	CPPPixelOps::Premultiply(&c, 1);
+	CHECK_EQ(c, 0x80802000);
+	c = 0xFF102030;
+	CPPPixelOps::Grayscale(&c, 1);
+	uint32_t g = (0x10 * 77 + 0x20 * 150 + 0x30 * 29) >> 8;
+	CHECK_EQ(c, 0xFF000000 | g * 0x010101);
+	uint32_t d = 0x00000000, s = 0xFFFFFFFF;
+	CPPPixelOps::Blend(&d, &s, 1, 255);
+	CHECK_EQ(d, 0xFFFFFFFF);
+	c = 0x40808080;
+	CPPPixelOps::Scale(&c, 1, 1024);
+	CHECK_EQ(c, 0x40FFFFFF);
+}
+
+int main()
+{
+	TestReference();
+	int nBest = CPPPixelOps::GetBestLevel();
+	printf("best level %d\n", nBest);
+	if (nBest == CPPPixelOps::PIXELOPS_NEON)
+		TestLevel(CPPPixelOps::PIXELOPS_NEON);
+	else
+	{
+		for (int nLevel = CPPPixelOps::PIXELOPS_SSE2; nLevel <= nBest; nLevel++)
+			TestLevel(nLevel);
+	}
+	return TestResult("PPPixelOpsTest");
+}
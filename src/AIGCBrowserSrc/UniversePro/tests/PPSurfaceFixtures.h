@@ -0,0 +1,919 @@
+// PPSurfaceFixtures.h : generated by make_surface_fixtures.py, do not edit
+
+#pragma once
+
+struct SurfaceFixture
+{
+	const char* pszName;
+	const uint8_t* pData;
+	size_t nSize;
+	int nWidth;
+	int nHeight;
+	const uint32_t* pExpected;	// straight alpha, top row first
+};
+
+static const uint8_t s_png_gray1[] = {
+	0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a, 0x00, 0x00, 0x00, 0x0d, 0x49, 0x48, 0x44, 0x52,
+	0x00, 0x00, 0x00, 0x0d, 0x00, 0x00, 0x00, 0x05, 0x01, 0x00, 0x00, 0x00, 0x00, 0xb6, 0xc3, 0x5b,
+	0xbc, 0x00, 0x00, 0x00, 0x0b, 0x49, 0x44, 0x41, 0x54, 0x78, 0xda, 0x63, 0x9a, 0x6b, 0xc1, 0xec,
+	0xf3, 0x9f, 0x61, 0xea, 0x5b, 0xd1, 0x6f, 0xf8, 0x00, 0x00, 0x00, 0x0c, 0x49, 0x44, 0x41, 0x54,
+	0x0f, 0x26, 0xe6, 0x1d, 0x8c, 0xa6, 0xd2, 0x00, 0x27, 0xec, 0x04, 0xc1, 0x5b, 0x79, 0xa6, 0x7e,
+	0x00, 0x00, 0x00, 0x00, 0x49, 0x45, 0x4e, 0x44, 0xae, 0x42, 0x60, 0x82,
+};
+static const uint32_t s_png_gray1_pixels[] = {
+	0xffffffff, 0xff000000, 0xff000000, 0xffffffff, 0xffffffff, 0xffffffff, 0xff000000, 0xffffffff,
+	0xff000000, 0xff000000, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xff000000, 0xff000000,
+	0xffffffff, 0xffffffff, 0xff000000, 0xffffffff, 0xff000000, 0xff000000, 0xffffffff, 0xffffffff,
+	0xff000000, 0xffffffff, 0xffffffff, 0xff000000, 0xff000000, 0xffffffff, 0xff000000, 0xffffffff,
+	0xff000000, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff,
+	0xff000000, 0xff000000, 0xffffffff, 0xffffffff, 0xff000000, 0xff000000, 0xff000000, 0xffffffff,
+	0xff000000, 0xffffffff, 0xffffffff, 0xff000000, 0xff000000, 0xff000000, 0xffffffff, 0xffffffff,
+	0xff000000, 0xffffffff, 0xff000000, 0xffffffff, 0xff000000, 0xffffffff, 0xff000000, 0xffffffff,
+	0xff000000,
+};
+
+static const uint8_t s_png_gray2[] = {
+	0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a, 0x00, 0x00, 0x00, 0x0d, 0x49, 0x48, 0x44, 0x52,
+	0x00, 0x00, 0x00, 0x0d, 0x00, 0x00, 0x00, 0x05, 0x02, 0x00, 0x00, 0x00, 0x00, 0xf1, 0x63, 0x21,
+	0x6c, 0x00, 0x00, 0x00, 0x11, 0x49, 0x44, 0x41, 0x54, 0x78, 0xda, 0x63, 0x5c, 0x66, 0xe3, 0x7d,
+	0x99, 0x79, 0x45, 0xc5, 0x4f, 0x79, 0x46, 0x2d, 0x1d, 0xc6, 0xfe, 0xba, 0x37, 0x03, 0x00, 0x00,
+	0x00, 0x11, 0x49, 0x44, 0x41, 0x54, 0x95, 0x4c, 0x73, 0x74, 0x56, 0x32, 0xb0, 0xe8, 0x99, 0x4a,
+	0x3f, 0x06, 0x00, 0x6e, 0x7d, 0x08, 0x16, 0x82, 0x7e, 0xe2, 0xce, 0x00, 0x00, 0x00, 0x00, 0x49,
+	0x45, 0x4e, 0x44, 0xae, 0x42, 0x60, 0x82,
+};
+static const uint32_t s_png_gray2_pixels[] = {
+	0xffaaaaaa, 0xffaaaaaa, 0xff555555, 0xffaaaaaa, 0xffffffff, 0xffaaaaaa, 0xff000000, 0xffaaaaaa,
+	0xff000000, 0xffaaaaaa, 0xffffffff, 0xff555555, 0xff000000, 0xffffffff, 0xffffffff, 0xffaaaaaa,
+	0xffffffff, 0xff555555, 0xffaaaaaa, 0xff555555, 0xffaaaaaa, 0xff555555, 0xff000000, 0xff000000,
+	0xffaaaaaa, 0xff555555, 0xff000000, 0xffaaaaaa, 0xffaaaaaa, 0xffaaaaaa, 0xff555555, 0xff555555,
+	0xff555555, 0xffaaaaaa, 0xff555555, 0xff555555, 0xff555555, 0xffffffff, 0xff000000, 0xffffffff,
+	0xff000000, 0xff555555, 0xffaaaaaa, 0xffaaaaaa, 0xff000000, 0xff000000, 0xffaaaaaa, 0xff000000,
+	0xff000000, 0xff000000, 0xff000000, 0xff000000, 0xffffffff, 0xffffffff, 0xff555555, 0xff000000,
+	0xffffffff, 0xffffffff, 0xffaaaaaa, 0xffffffff, 0xffaaaaaa, 0xff555555, 0xffffffff, 0xff555555,
+	0xffaaaaaa,
+};
+
+static const uint8_t s_png_gray4[] = {
+	0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a, 0x00, 0x00, 0x00, 0x0d, 0x49, 0x48, 0x44, 0x52,
+	0x00, 0x00, 0x00, 0x0d, 0x00, 0x00, 0x00, 0x05, 0x04, 0x00, 0x00, 0x00, 0x00, 0x7e, 0x23, 0xd4,
+	0xcc, 0x00, 0x00, 0x00, 0x19, 0x49, 0x44, 0x41, 0x54, 0x78, 0xda, 0x01, 0x28, 0x00, 0xd7, 0xff,
+	0x03, 0xb3, 0xdc, 0xed, 0x67, 0x72, 0xf4, 0x4d, 0x02, 0x69, 0xbe, 0x22, 0xa7, 0x97, 0x17, 0x20,
+	0x02, 0xc3, 0x3a, 0xd6, 0x40, 0xd4, 0x00, 0x00, 0x00, 0x1a, 0x49, 0x44, 0x41, 0x54, 0x25, 0xad,
+	0x88, 0x1a, 0x61, 0x00, 0x00, 0xb9, 0xe5, 0x61, 0xa5, 0x3a, 0x0b, 0xe0, 0x01, 0xad, 0x99, 0x94,
+	0xb6, 0xd1, 0xca, 0x85, 0x6d, 0xe7, 0x12, 0x6e, 0xfc, 0xf6, 0x87, 0x5e, 0x00, 0x00, 0x00, 0x00,
+	0x49, 0x45, 0x4e, 0x44, 0xae, 0x42, 0x60, 0x82,
+};
+static const uint32_t s_png_gray4_pixels[] = {
+	0xffbbbbbb, 0xff333333, 0xff333333, 0xff555555, 0xff000000, 0xff777777, 0xff666666, 0xffaaaaaa,
+	0xffaaaaaa, 0xff777777, 0xff444444, 0xff777777, 0xff777777, 0xff111111, 0xffcccccc, 0xffffffff,
+	0xff333333, 0xff222222, 0xff999999, 0xff111111, 0xff111111, 0xff333333, 0xffeeeeee, 0xff555555,
+	0xffeeeeee, 0xff999999, 0xffdddddd, 0xffffffff, 0xff111111, 0xff888888, 0xffdddddd, 0xff666666,
+	0xff999999, 0xff999999, 0xff555555, 0xff888888, 0xffbbbbbb, 0xffffffff, 0xff999999, 0xffbbbbbb,
+	0xff999999, 0xffeeeeee, 0xff555555, 0xff666666, 0xff111111, 0xffaaaaaa, 0xff555555, 0xff333333,
+	0xffaaaaaa, 0xff000000, 0xffbbbbbb, 0xffeeeeee, 0xffaaaaaa, 0xffdddddd, 0xff444444, 0xff666666,
+	0xffdddddd, 0xffaaaaaa, 0xff999999, 0xff000000, 0xff666666, 0xff111111, 0xff222222, 0xffbbbbbb,
+	0xffbbbbbb,
+};
+
+static const uint8_t s_png_gray8[] = {
+	0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a, 0x00, 0x00, 0x00, 0x0d, 0x49, 0x48, 0x44, 0x52,
+	0x00, 0x00, 0x00, 0x0d, 0x00, 0x00, 0x00, 0x05, 0x08, 0x00, 0x00, 0x00, 0x00, 0xbb, 0xd3, 0x39,
+	0xcd, 0x00, 0x00, 0x00, 0x28, 0x49, 0x44, 0x41, 0x54, 0x78, 0xda, 0x01, 0x46, 0x00, 0xb9, 0xff,
+	0x00, 0x99, 0xdf, 0x32, 0x6c, 0x67, 0xe2, 0x0a, 0xc8, 0x95, 0x10, 0x80, 0x52, 0x26, 0x00, 0x8f,
+	0xf1, 0xd8, 0x07, 0x03, 0xac, 0x8e, 0xb5, 0xd2, 0x3d, 0x0f, 0x6e, 0xc8, 0x04, 0xf7, 0xcc, 0x86,
+	0xc1, 0x80, 0x40, 0x12, 0xb3, 0x00, 0x00, 0x00, 0x29, 0x49, 0x44, 0x41, 0x54, 0x77, 0x61, 0x81,
+	0x65, 0x3d, 0x41, 0xa1, 0xf5, 0xff, 0x03, 0xdf, 0xef, 0x96, 0xd4, 0x7e, 0xdb, 0x01, 0x98, 0x06,
+	0xda, 0x45, 0xbd, 0xd0, 0x03, 0x29, 0x1d, 0x83, 0x99, 0x98, 0xef, 0xf9, 0x4d, 0x54, 0xa3, 0x86,
+	0xed, 0x21, 0xa4, 0x83, 0x22, 0xef, 0xd0, 0x9b, 0xe5, 0xdc, 0x00, 0x00, 0x00, 0x00, 0x49, 0x45,
+	0x4e, 0x44, 0xae, 0x42, 0x60, 0x82,
+};
+static const uint32_t s_png_gray8_pixels[] = {
+	0xff999999, 0xffdfdfdf, 0xff323232, 0xff6c6c6c, 0xff676767, 0xffe2e2e2, 0xff0a0a0a, 0xffc8c8c8,
+	0xff959595, 0xff101010, 0xff808080, 0xff525252, 0xff262626, 0xff8f8f8f, 0xfff1f1f1, 0xffd8d8d8,
+	0xff070707, 0xff030303, 0xffacacac, 0xff8e8e8e, 0xffb5b5b5, 0xffd2d2d2, 0xff3d3d3d, 0xff0f0f0f,
+	0xff6e6e6e, 0xffc8c8c8, 0xff868686, 0xffbdbdbd, 0xff434343, 0xffc8c8c8, 0xff3f3f3f, 0xff0d0d0d,
+	0xff8e8e8e, 0xff1a1a1a, 0xff575757, 0xff7e7e7e, 0xffdedede, 0xffd3d3d3, 0xffd2d2d2, 0xff222222,
+	0xff5e5e5e, 0xffe6e6e6, 0xffababab, 0xfff3f3f3, 0xff5b5b5b, 0xff757575, 0xffdfdfdf, 0xffa1a1a1,
+	0xff696969, 0xffe8e8e8, 0xff9a9a9a, 0xff868686, 0xff3a3a3a, 0xff696969, 0xff2a2a2a, 0xff030303,
+	0xff131313, 0xff262626, 0xff464646, 0xffdfdfdf, 0xff141414, 0xffe1e1e1, 0xff6a6a6a, 0xff6f6f6f,
+	0xff9b9b9b,
+};
+
+static const uint8_t s_png_gray16[] = {
+	0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a, 0x00, 0x00, 0x00, 0x0d, 0x49, 0x48, 0x44, 0x52,
+	0x00, 0x00, 0x00, 0x0d, 0x00, 0x00, 0x00, 0x05, 0x10, 0x00, 0x00, 0x00, 0x00, 0xeb, 0x43, 0xe5,
+	0x8e, 0x00, 0x00, 0x00, 0x49, 0x49, 0x44, 0x41, 0x54, 0x78, 0xda, 0x01, 0x87, 0x00, 0x78, 0xff,
+	0x03, 0x0e, 0x57, 0x82, 0xa1, 0x1f, 0xd0, 0x34, 0x34, 0xb8, 0xc2, 0x17, 0xaa, 0x2f, 0x44, 0x09,
+	0x2c, 0xd6, 0x92, 0x1f, 0x57, 0xfe, 0xe1, 0x3e, 0x09, 0x82, 0x30, 0x01, 0x11, 0x23, 0x63, 0x48,
+	0x7d, 0x72, 0x2c, 0xac, 0x71, 0x8c, 0x95, 0xff, 0x48, 0xe5, 0x5a, 0xc9, 0x13, 0xa0, 0xe0, 0x7d,
+	0x01, 0x87, 0xc4, 0xcc, 0x68, 0x89, 0x00, 0x5d, 0x85, 0xd4, 0xf2, 0xc8, 0xef, 0xd0, 0xb2, 0xea,
+	0xce, 0x1d, 0xf3, 0x18, 0xd7, 0xf6, 0x00, 0x00, 0x00, 0x49, 0x49, 0x44, 0x41, 0x54, 0xb4, 0x1e,
+	0x04, 0x1a, 0x17, 0x23, 0xad, 0x6a, 0x20, 0x9c, 0xde, 0x55, 0x47, 0x3c, 0x05, 0x02, 0xaa, 0xd8,
+	0x20, 0x9f, 0x62, 0x33, 0xe5, 0xa3, 0x52, 0xca, 0xb2, 0xa6, 0x78, 0x85, 0x12, 0xa1, 0x81, 0x46,
+	0xe4, 0x87, 0xba, 0x48, 0x6b, 0xbd, 0xeb, 0xcd, 0x00, 0xd9, 0x9c, 0x11, 0x72, 0xd0, 0x73, 0x61,
+	0xd9, 0x7d, 0x63, 0xc8, 0x34, 0xd2, 0xf0, 0x4e, 0xc8, 0x8c, 0x4f, 0xcf, 0x9d, 0xec, 0x42, 0x5f,
+	0x8a, 0x9c, 0xa6, 0x05, 0x91, 0x40, 0xec, 0x89, 0x88, 0x35, 0x2d, 0x00, 0x00, 0x00, 0x00, 0x49,
+	0x45, 0x4e, 0x44, 0xae, 0x42, 0x60, 0x82,
+};
+static const uint32_t s_png_gray16_pixels[] = {
+	0xff0e0e0e, 0xff898989, 0xff636363, 0xff656565, 0xffeaeaea, 0xff8c8c8c, 0xff757575, 0xff434343,
+	0xfff7f7f7, 0xff9a9a9a, 0xff4b4b4b, 0xff636363, 0xffb3b3b3, 0xff111111, 0xff747474, 0xfff1f1f1,
+	0xff1d1d1d, 0xff8e8e8e, 0xff232323, 0xff6b6b6b, 0xffc5c5c5, 0xffd8d8d8, 0xffb8b8b8, 0xffb9b9b9,
+	0xff7d7d7d, 0xffe5e5e5, 0xff5d5d5d, 0xffd4d4d4, 0xffc8c8c8, 0xffd0d0d0, 0xffeaeaea, 0xff1d1d1d,
+	0xff1e1e1e, 0xff1a1a1a, 0xff232323, 0xff6a6a6a, 0xff9c9c9c, 0xff555555, 0xff3c3c3c, 0xff070707,
+	0xfff4f4f4, 0xff2a2a2a, 0xffb5b5b5, 0xff3c3c3c, 0xffcfcfcf, 0xff969696, 0xff2c2c2c, 0xffa4a4a4,
+	0xff4e4e4e, 0xff565656, 0xffc0c0c0, 0xff272727, 0xffd9d9d9, 0xff111111, 0xffd0d0d0, 0xff616161,
+	0xff7d7d7d, 0xffc8c8c8, 0xffd2d2d2, 0xff4e4e4e, 0xff8c8c8c, 0xffcfcfcf, 0xffececec, 0xff5f5f5f,
+	0xff9c9c9c,
+};
+
+static const uint8_t s_png_gray8_trns[] = {
+	0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a, 0x00, 0x00, 0x00, 0x0d, 0x49, 0x48, 0x44, 0x52,
+	0x00, 0x00, 0x00, 0x06, 0x00, 0x00, 0x00, 0x04, 0x08, 0x00, 0x00, 0x00, 0x00, 0x88, 0x6f, 0x11,
+	0x9f, 0x00, 0x00, 0x00, 0x02, 0x74, 0x52, 0x4e, 0x53, 0x00, 0x4d, 0x7e, 0xfe, 0xf0, 0x15, 0x00,
+	0x00, 0x00, 0x12, 0x49, 0x44, 0x41, 0x54, 0x78, 0xda, 0x63, 0xf4, 0xed, 0xda, 0xba, 0x6a, 0xe6,
+	0x5e, 0xa6, 0x43, 0xb2, 0xac, 0xfb, 0xeb, 0x22, 0x19, 0x48, 0x31, 0x81, 0x7a, 0x00, 0x00, 0x00,
+	0x13, 0x49, 0x44, 0x41, 0x54, 0xde, 0x6d, 0xb1, 0xac, 0xe5, 0x8d, 0x60, 0x49, 0xe6, 0x2d, 0x98,
+	0x7d, 0xe6, 0x00, 0x00, 0xa9, 0x36, 0x0b, 0xd2, 0x46, 0xb0, 0x8a, 0x73, 0x00, 0x00, 0x00, 0x00,
+	0x49, 0x45, 0x4e, 0x44, 0xae, 0x42, 0x60, 0x82,
+};
+static const uint32_t s_png_gray8_trns_pixels[] = {
+	0x004d4d4d, 0xffd7d7d7, 0xff8c8c8c, 0xff363636, 0xffcfcfcf, 0xff8c8c8c, 0xff0f0f0f, 0xfff4f4f4,
+	0xff919191, 0xfff5f5f5, 0x004d4d4d, 0xffe5e5e5, 0xffeeeeee, 0xffb4b4b4, 0xff393939, 0xff7d7d7d,
+	0xff0d0d0d, 0xff585858, 0xff515151, 0xff5e5e5e, 0xffa9a9a9, 0xff444444, 0xffd9d9d9, 0xff999999,
+};
+
+static const uint8_t s_png_gray16_adam7[] = {
+	0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a, 0x00, 0x00, 0x00, 0x0d, 0x49, 0x48, 0x44, 0x52,
+	0x00, 0x00, 0x00, 0x11, 0x00, 0x00, 0x00, 0x0b, 0x10, 0x00, 0x00, 0x00, 0x01, 0x9b, 0xdc, 0xd5,
+	0x0e, 0x00, 0x00, 0x00, 0xcb, 0x49, 0x44, 0x41, 0x54, 0x78, 0xda, 0x01, 0x8c, 0x01, 0x73, 0xfe,
+	0x00, 0x0e, 0x7f, 0x79, 0x5d, 0x6c, 0x48, 0x00, 0xe9, 0xe1, 0x81, 0x67, 0x7c, 0x2b, 0x00, 0x28,
+	0xf2, 0x6e, 0xa2, 0x02, 0x5b, 0x29, 0x1c, 0x33, 0x03, 0x6e, 0xe8, 0xf2, 0x61, 0x82, 0xab, 0xf8,
+	0xf8, 0xb2, 0xd9, 0x04, 0x61, 0xc3, 0xa2, 0x0c, 0x6a, 0x54, 0x93, 0x61, 0x03, 0xdd, 0x6b, 0x97,
+	0x85, 0xad, 0x5b, 0x60, 0xc4, 0x00, 0xe1, 0xbe, 0x05, 0xb3, 0xc8, 0xab, 0xef, 0xa2, 0x00, 0x8f,
+	0xcd, 0x4a, 0x30, 0xc9, 0x74, 0xd7, 0xc3, 0x4d, 0xba, 0x6a, 0xdc, 0xd0, 0xb4, 0x92, 0x76, 0x16,
+	0x1e, 0x03, 0xdf, 0x44, 0xa0, 0x84, 0xd9, 0x1a, 0xf0, 0x1c, 0x7f, 0xa9, 0xd6, 0xfc, 0xb7, 0x63,
+	0x37, 0xee, 0xfa, 0xd6, 0x01, 0x86, 0x78, 0x2b, 0x8c, 0x75, 0xd1, 0xff, 0xaf, 0x16, 0xcf, 0x5d,
+	0x6b, 0x1d, 0x20, 0x47, 0xca, 0xf7, 0x9c, 0x03, 0x36, 0x93, 0xe6, 0xa7, 0x1d, 0x18, 0xd9, 0x85,
+	0x27, 0xb9, 0xca, 0xfa, 0x75, 0xc2, 0x5b, 0x54, 0x00, 0x65, 0x61, 0xb0, 0x17, 0x48, 0xf0, 0x34,
+	0x92, 0x22, 0xd6, 0xd5, 0x7b, 0x6c, 0x4e, 0x71, 0x1b, 0x02, 0xee, 0x9e, 0xfe, 0xb8, 0xf2, 0x24,
+	0xc9, 0x42, 0x4f, 0x39, 0xae, 0xef, 0x15, 0xc0, 0xde, 0x40, 0x00, 0x50, 0xc9, 0x4d, 0x43, 0x59,
+	0x97, 0x8a, 0x33, 0xd7, 0x07, 0x91, 0xc4, 0xcf, 0xed, 0xf2, 0x82, 0x02, 0xff, 0x99, 0x1b, 0xa9,
+	0x5b, 0x15, 0x93, 0xa9, 0xb7, 0x4d, 0x1e, 0x6e, 0x00, 0x00, 0x00, 0xcc, 0x49, 0x44, 0x41, 0x54,
+	0x66, 0x2a, 0xeb, 0x1b, 0x79, 0xb5, 0xf2, 0xbd, 0x00, 0x0d, 0xf5, 0x8b, 0x4d, 0x38, 0xa3, 0x70,
+	0x95, 0x14, 0x07, 0xdd, 0x93, 0xe6, 0x06, 0x2b, 0x47, 0x00, 0x6e, 0x44, 0x20, 0x5d, 0x6f, 0x1c,
+	0x2f, 0xab, 0xc6, 0xe1, 0xbc, 0x3b, 0x31, 0x99, 0x56, 0xd6, 0x4d, 0x92, 0xd0, 0xd8, 0xe7, 0x1c,
+	0x49, 0x08, 0x3f, 0x01, 0x38, 0x6f, 0x83, 0x2e, 0xdd, 0xb2, 0xd6, 0x9e, 0x01, 0xd4, 0x7f, 0xc2,
+	0xd8, 0x0f, 0xba, 0xd1, 0xb0, 0x44, 0x18, 0xcf, 0x30, 0x1d, 0xfe, 0x19, 0x2b, 0x0f, 0xd2, 0x00,
+	0x68, 0x58, 0x92, 0xcf, 0xbd, 0xdf, 0xd4, 0x90, 0x0b, 0x94, 0xec, 0xb3, 0xbe, 0x2c, 0x37, 0x02,
+	0xe9, 0xbe, 0xa6, 0x98, 0xf8, 0xc5, 0x09, 0x69, 0xd6, 0x6b, 0x86, 0xad, 0xaf, 0x53, 0x39, 0x94,
+	0x97, 0xde, 0xdf, 0x11, 0x74, 0x55, 0x8e, 0x7c, 0x70, 0x7f, 0x97, 0x79, 0x31, 0x4b, 0xd4, 0xd2,
+	0xfc, 0xff, 0x02, 0x5d, 0xc0, 0xa1, 0xf4, 0x96, 0x6a, 0x47, 0x41, 0x52, 0x49, 0x29, 0xd8, 0x73,
+	0x66, 0x25, 0x31, 0xe0, 0x29, 0xb6, 0x9b, 0x32, 0x7a, 0x48, 0x1f, 0x81, 0xc4, 0x4f, 0x44, 0x54,
+	0x20, 0x60, 0x2a, 0x70, 0xff, 0x03, 0xff, 0xa0, 0xf8, 0x88, 0x08, 0x6c, 0xf3, 0x28, 0x95, 0x2a,
+	0xfa, 0xf8, 0x4a, 0x5d, 0xba, 0x59, 0xff, 0xac, 0x2a, 0x48, 0xbf, 0x32, 0x85, 0x70, 0x37, 0x28,
+	0x92, 0xe1, 0xba, 0x5a, 0xfe, 0xc1, 0x42, 0x26, 0xdd, 0x80, 0xc1, 0xe6, 0x9d, 0x37, 0xbe, 0x9c,
+	0x00, 0x00, 0x00, 0x00, 0x49, 0x45, 0x4e, 0x44, 0xae, 0x42, 0x60, 0x82,
+};
+static const uint32_t s_png_gray16_adam7_pixels[] = {
+	0xff0e0e0e, 0xff363636, 0xff616161, 0xff010101, 0xff282828, 0xff1d1d1d, 0xff030303, 0xffe7e7e7,
+	0xff797979, 0xff9a9a9a, 0xff6d6d6d, 0xff171717, 0xff6e6e6e, 0xff808080, 0xff000000, 0xff9b9b9b,
+	0xff6c6c6c, 0xff6e6e6e, 0xff202020, 0xff6f6f6f, 0xff2f2f2f, 0xffc6c6c6, 0xffbcbcbc, 0xff313131,
+	0xff565656, 0xff4d4d4d, 0xffd0d0d0, 0xffe7e7e7, 0xff494949, 0xff3f3f3f, 0xff383838, 0xff838383,
+	0xffdddddd, 0xffd6d6d6, 0xff8f8f8f, 0xff656565, 0xff4a4a4a, 0xffb0b0b0, 0xffc9c9c9, 0xff484848,
+	0xffd7d7d7, 0xff343434, 0xff4d4d4d, 0xff222222, 0xff6a6a6a, 0xffd5d5d5, 0xffd0d0d0, 0xff6c6c6c,
+	0xff929292, 0xff717171, 0xff161616, 0xffd4d4d4, 0xff969696, 0xffa5a5a5, 0xff767676, 0xffbababa,
+	0xff898989, 0xffa6a6a6, 0xffbfbfbf, 0xffcecece, 0xffcecece, 0xff262626, 0xfff5f5f5, 0xffd4d4d4,
+	0xff646464, 0xfff8f8f8, 0xffababab, 0xffd7d7d7, 0xff6e6e6e, 0xff535353, 0xff0d0d0d, 0xffaeaeae,
+	0xff292929, 0xff3a3a3a, 0xff9f9f9f, 0xfffdfdfd, 0xff969696, 0xff717171, 0xff333333, 0xff838383,
+	0xff434343, 0xff818181, 0xff797979, 0xff4f4f4f, 0xffd3d3d3, 0xffbdbdbd, 0xff3c3c3c, 0xff9d9d9d,
+	0xff7f7f7f, 0xff909090, 0xff0f0f0f, 0xff555555, 0xfff8f8f8, 0xff656565, 0xffadadad, 0xff9a9a9a,
+	0xff838383, 0xff444444, 0xfffbfbfb, 0xff292929, 0xff7f7f7f, 0xffd3d3d3, 0xff262626, 0xff505050,
+	0xffd8d8d8, 0xff4d4d4d, 0xffa9a9a9, 0xff595959, 0xffb0b0b0, 0xff8a8a8a, 0xfffdfdfd, 0xffd7d7d7,
+	0xff898989, 0xff919191, 0xff636363, 0xffcfcfcf, 0xffb1b1b1, 0xfff2f2f2, 0xff5d5d5d, 0xff1a1a1a,
+	0xffdddddd, 0xff333333, 0xffc6c6c6, 0xffe2e2e2, 0xff383838, 0xffc8c8c8, 0xff1d1d1d, 0xff454545,
+	0xff636363, 0xffcccccc, 0xffcbcbcb, 0xffc5c5c5, 0xff4a4a4a, 0xff7d7d7d, 0xffdfdfdf, 0xff434343,
+	0xffe9e9e9, 0xff4f4f4f, 0xffe1e1e1, 0xff686868, 0xff838383, 0xffb4b4b4, 0xff050505, 0xff1d1d1d,
+	0xff818181, 0xff3d3d3d, 0xffc8c8c8, 0xff7c7c7c, 0xff8a8a8a, 0xff484848, 0xffefefef, 0xffe4e4e4,
+	0xff7c7c7c, 0xff0c0c0c, 0xff6c6c6c, 0xff575757, 0xff818181, 0xff464646, 0xff393939, 0xffcacaca,
+	0xff2d2d2d, 0xff383838, 0xff777777, 0xff606060, 0xff1a1a1a, 0xffa6a6a6, 0xff0a0a0a, 0xfffdfdfd,
+	0xffececec, 0xffd9d9d9, 0xff868686, 0xff0d0d0d, 0xffb1b1b1, 0xff8b8b8b, 0xff262626, 0xff383838,
+	0xff252525, 0xff707070, 0xff3b3b3b, 0xff141414, 0xff989898, 0xffdddddd, 0xffb5b5b5, 0xffe6e6e6,
+	0xfffcfcfc, 0xff2b2b2b, 0xfff3f3f3,
+};
+
+static const uint8_t s_png_rgb8[] = {
+	0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a, 0x00, 0x00, 0x00, 0x0d, 0x49, 0x48, 0x44, 0x52,
+	0x00, 0x00, 0x00, 0x07, 0x00, 0x00, 0x00, 0x06, 0x08, 0x02, 0x00, 0x00, 0x00, 0x80, 0x6c, 0x13,
+	0x21, 0x00, 0x00, 0x00, 0x47, 0x49, 0x44, 0x41, 0x54, 0x78, 0xda, 0x01, 0x84, 0x00, 0x7b, 0xff,
+	0x03, 0x73, 0x90, 0x62, 0xc2, 0xc3, 0xd6, 0x59, 0x5e, 0xe0, 0xe9, 0xad, 0x05, 0x82, 0x0b, 0xcf,
+	0x1d, 0xaa, 0xa4, 0x04, 0xfc, 0xab, 0x03, 0x22, 0x9b, 0xa4, 0x3a, 0xfb, 0x8d, 0x7f, 0x69, 0x61,
+	0xbe, 0x5a, 0x30, 0x4e, 0x31, 0xf8, 0x80, 0x0e, 0x4a, 0x10, 0x5f, 0xa3, 0x04, 0x1c, 0xe1, 0x98,
+	0x92, 0xad, 0x0e, 0x07, 0x1c, 0x8b, 0xe3, 0x44, 0xdb, 0x13, 0xbf, 0x09, 0x63, 0x41, 0x02, 0xc1,
+	0xf1, 0xfb, 0xa0, 0x04, 0x00, 0x00, 0x00, 0x48, 0x49, 0x44, 0x41, 0x54, 0xa6, 0xbd, 0x02, 0xc0,
+	0x21, 0xdc, 0x6f, 0x0d, 0x4f, 0xb7, 0x4f, 0xe7, 0x24, 0x18, 0xa1, 0x9a, 0x6c, 0x33, 0x46, 0xe2,
+	0x2b, 0x09, 0x38, 0x3b, 0x03, 0x4b, 0xef, 0x5f, 0x5c, 0xd4, 0x92, 0x6c, 0x9b, 0xbd, 0x39, 0xfb,
+	0x19, 0x2b, 0xe0, 0xfa, 0xb8, 0x2e, 0xf6, 0x7f, 0x16, 0x06, 0x00, 0x62, 0x4d, 0x39, 0xc9, 0xf3,
+	0x35, 0xdf, 0x44, 0x28, 0xb5, 0x46, 0xf0, 0x14, 0xc7, 0x41, 0xb7, 0x0e, 0x96, 0xf3, 0x90, 0xfd,
+	0x6c, 0xe3, 0x3c, 0x08, 0x30, 0x63, 0xe3, 0x1c, 0x00, 0x00, 0x00, 0x00, 0x49, 0x45, 0x4e, 0x44,
+	0xae, 0x42, 0x60, 0x82,
+};
+static const uint32_t s_png_rgb8_pixels[] = {
+	0xff739062, 0xfffb0b07, 0xffd663e3, 0xff54de76, 0xffac7a0a, 0xff73e7a9, 0xff3d6fff, 0xff5be3d5,
+	0xffe572fb, 0xff5cd350, 0xff163293, 0xffaf8746, 0xff11c5c1, 0xff37f983, 0xff77c46d, 0xff771f7b,
+	0xff638edb, 0xfff976b6, 0xff0c464f, 0xff6fc8c3, 0xff309f40, 0xff37e549, 0xffe62cca, 0xff1addc2,
+	0xff1d8e57, 0xffa6b282, 0xffb5aaee, 0xff39d77b, 0xff666183, 0xff021a38, 0xff7a163a, 0xff844d61,
+	0xffc05f6b, 0xff72b2a2, 0xffd4da94, 0xff624d39, 0xffc9f335, 0xffdf4428, 0xffb546f0, 0xff14c741,
+	0xffb70e96, 0xfff390fd,
+};
+
+static const uint8_t s_png_graya8[] = {
+	0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a, 0x00, 0x00, 0x00, 0x0d, 0x49, 0x48, 0x44, 0x52,
+	0x00, 0x00, 0x00, 0x05, 0x00, 0x00, 0x00, 0x07, 0x08, 0x04, 0x00, 0x00, 0x00, 0x6a, 0xae, 0x4f,
+	0x65, 0x00, 0x00, 0x00, 0x2c, 0x49, 0x44, 0x41, 0x54, 0x78, 0xda, 0x01, 0x4d, 0x00, 0xb2, 0xff,
+	0x00, 0x54, 0xf9, 0x91, 0xad, 0x3f, 0xc5, 0x6d, 0x1e, 0x12, 0x5a, 0x02, 0xe6, 0x95, 0xe2, 0x73,
+	0x2a, 0x6a, 0x8f, 0x20, 0x36, 0x08, 0x04, 0x5b, 0xbc, 0x1c, 0x09, 0x82, 0xbd, 0x00, 0xbd, 0xac,
+	0x45, 0x03, 0xd4, 0x67, 0x7e, 0x17, 0x11, 0x93, 0x95, 0x00, 0x00, 0x00, 0x2c, 0x49, 0x44, 0x41,
+	0x54, 0x14, 0xd5, 0x51, 0x5d, 0x96, 0x2d, 0xb2, 0x02, 0xf2, 0xf3, 0xd6, 0xee, 0xbf, 0x85, 0xef,
+	0xd3, 0x04, 0xc6, 0x04, 0x4d, 0x72, 0x72, 0x61, 0x0d, 0x7a, 0xe3, 0x4f, 0xb6, 0x4a, 0x01, 0x27,
+	0x1f, 0xf8, 0x45, 0x11, 0xea, 0xc6, 0x26, 0x35, 0x0a, 0x08, 0x84, 0x21, 0x43, 0x1c, 0x18, 0x95,
+	0x13, 0x00, 0x00, 0x00, 0x00, 0x49, 0x45, 0x4e, 0x44, 0xae, 0x42, 0x60, 0x82,
+};
+static const uint32_t s_png_graya8_pixels[] = {
+	0xf9545454, 0xad919191, 0xc53f3f3f, 0x1e6d6d6d, 0x5a121212, 0x8e3a3a3a, 0x20737373, 0x2f696969,
+	0x3efcfcfc, 0x62484848, 0x4a959595, 0x29b1b1b1, 0xec333333, 0xa9fcfcfc, 0xeef4f4f4, 0x8c1e1e1e,
+	0x6ee5e5e5, 0xfe616161, 0x690b0b0b, 0x5dacacac, 0x7f101010, 0x5cbbbbbb, 0x83202020, 0x3cfafafa,
+	0x23b0b0b0, 0xf15d5d5d, 0x522d2d2d, 0xfd2d2d2d, 0xd2dddddd, 0x1c666666, 0x1f272727, 0x641f1f1f,
+	0x4e303030, 0x74f6f6f6, 0x7e2b2b2b,
+};
+
+static const uint8_t s_png_rgba8[] = {
+	0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a, 0x00, 0x00, 0x00, 0x0d, 0x49, 0x48, 0x44, 0x52,
+	0x00, 0x00, 0x00, 0x09, 0x00, 0x00, 0x00, 0x03, 0x08, 0x06, 0x00, 0x00, 0x00, 0x41, 0x0a, 0x25,
+	0x76, 0x00, 0x00, 0x00, 0x3d, 0x49, 0x44, 0x41, 0x54, 0x78, 0xda, 0x01, 0x6f, 0x00, 0x90, 0xff,
+	0x03, 0x54, 0xef, 0xff, 0x78, 0xbd, 0xa7, 0x8c, 0x31, 0xda, 0xe1, 0x3b, 0xa9, 0x87, 0x6b, 0xff,
+	0x4e, 0xe7, 0x95, 0xe8, 0xa8, 0x9c, 0xd0, 0x8d, 0xa5, 0xac, 0xee, 0x93, 0x07, 0x67, 0x65, 0xa7,
+	0x3e, 0x2f, 0x47, 0x3a, 0x61, 0x02, 0xc8, 0xfa, 0x2e, 0x6c, 0x5d, 0x97, 0xb7, 0x78, 0x3d, 0x1c,
+	0x1e, 0x20, 0x80, 0xc2, 0x39, 0x8d, 0x24, 0xe5, 0xef, 0x06, 0x00, 0x00, 0x00, 0x3d, 0x49, 0x44,
+	0x41, 0x54, 0xbc, 0xb5, 0x24, 0x39, 0xab, 0x32, 0x85, 0xe0, 0xc3, 0x56, 0xe7, 0x83, 0x8e, 0x51,
+	0x98, 0xdb, 0xed, 0x2e, 0x6e, 0x91, 0x02, 0x6a, 0x16, 0x1e, 0x09, 0xca, 0xea, 0xaf, 0x40, 0x93,
+	0xf9, 0x46, 0xfe, 0x70, 0x18, 0xc7, 0x1c, 0x7c, 0x4d, 0x16, 0x46, 0xb1, 0x32, 0x24, 0x10, 0x4d,
+	0xb8, 0x52, 0x90, 0xbf, 0xe0, 0x5c, 0x1c, 0x69, 0x4b, 0xaa, 0x55, 0x82, 0x08, 0x35, 0xf0, 0xea,
+	0x02, 0x6d, 0x15, 0x00, 0x00, 0x00, 0x00, 0x49, 0x45, 0x4e, 0x44, 0xae, 0x42, 0x60, 0x82,
+};
+static const uint32_t s_png_rgba8_pixels[] = {
+	0x7854efff, 0x6de71e0b, 0xdf4df040, 0xbdade31f, 0x063d06f7, 0xa8bad308, 0x5b095797, 0x6b6b90f2,
+	0x96648fb3, 0xe41ce92d, 0xe544b5c2, 0xff8a0c5e, 0x4a2da558, 0x3ff9bb1b, 0x8865058d, 0xdeccad7e,
+	0x46f9e18a, 0x2751bd21, 0xed86ff4b, 0x250e9f71, 0xfd1d05a4, 0x669dbd1f, 0x85750831, 0x981637b1,
+	0x6e1965d0, 0x62b8c1e6, 0x7cba08cb,
+};
+
+static const uint8_t s_png_rgb16[] = {
+	0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a, 0x00, 0x00, 0x00, 0x0d, 0x49, 0x48, 0x44, 0x52,
+	0x00, 0x00, 0x00, 0x07, 0x00, 0x00, 0x00, 0x06, 0x10, 0x02, 0x00, 0x00, 0x00, 0xd0, 0xfc, 0xcf,
+	0x62, 0x00, 0x00, 0x00, 0x86, 0x49, 0x44, 0x41, 0x54, 0x78, 0xda, 0x01, 0x02, 0x01, 0xfd, 0xfe,
+	0x00, 0xf5, 0x77, 0x0d, 0xcb, 0xc1, 0x96, 0x3a, 0x7a, 0x85, 0x1b, 0x55, 0x13, 0xe8, 0x8e, 0x9a,
+	0x46, 0x93, 0xa3, 0x2c, 0x17, 0x5b, 0xd5, 0xc8, 0x15, 0xa8, 0x71, 0xce, 0x6e, 0x99, 0xbf, 0x52,
+	0x5c, 0x17, 0xd1, 0x1f, 0x1a, 0x2d, 0x09, 0x68, 0x3e, 0x43, 0xb5, 0x04, 0x06, 0x02, 0xd2, 0x56,
+	0x8e, 0xeb, 0x99, 0xd0, 0x9b, 0x61, 0x7a, 0xed, 0xcd, 0xcd, 0xac, 0xf7, 0x05, 0x5b, 0x24, 0x84,
+	0x95, 0x0d, 0x01, 0x74, 0xf3, 0xb7, 0x3b, 0xbb, 0xc5, 0x4c, 0xbf, 0x41, 0x1c, 0x75, 0xc0, 0xd5,
+	0xce, 0xeb, 0xfe, 0xc7, 0x35, 0x70, 0x01, 0x99, 0x8b, 0x42, 0x8e, 0xc3, 0xd0, 0x1d, 0xb4, 0x9b,
+	0x1d, 0x4c, 0x21, 0x3a, 0xd4, 0xd2, 0x9d, 0x9b, 0x1b, 0x7d, 0x60, 0x4f, 0xb1, 0x4e, 0x34, 0x68,
+	0xc1, 0xed, 0x11, 0x2b, 0x84, 0xd4, 0xba, 0x49, 0xf8, 0xeb, 0x42, 0x69, 0x9e, 0xe8, 0x9a, 0x3e,
+	0xca, 0x93, 0xed, 0x00, 0x00, 0x00, 0x87, 0x49, 0x44, 0x41, 0x54, 0x49, 0xd9, 0x04, 0x39, 0x1d,
+	0xb8, 0x89, 0x7d, 0x54, 0x4c, 0x2d, 0xc5, 0x52, 0x90, 0xb8, 0x12, 0x84, 0xb0, 0x32, 0x5e, 0xfd,
+	0x3d, 0x3d, 0x64, 0x98, 0x09, 0xf8, 0xd9, 0x42, 0xfc, 0x5e, 0xb7, 0xed, 0x48, 0xe3, 0x43, 0x8c,
+	0x4e, 0x70, 0x86, 0xd7, 0x87, 0xef, 0x8d, 0x13, 0x00, 0x3d, 0xaa, 0x9b, 0x9e, 0xcd, 0x38, 0x58,
+	0x4a, 0x4b, 0xfd, 0x81, 0x92, 0x18, 0x33, 0x7d, 0x19, 0x2c, 0xae, 0x73, 0x44, 0x78, 0x8a, 0x80,
+	0x21, 0x99, 0xa2, 0x95, 0x22, 0xee, 0x71, 0x28, 0xf0, 0x96, 0x4b, 0x7e, 0xf6, 0x76, 0xb5, 0xb9,
+	0xe3, 0xfc, 0x1f, 0x00, 0x4e, 0xca, 0xbe, 0xf7, 0x7c, 0xfd, 0x96, 0x71, 0x89, 0xb8, 0xc3, 0x24,
+	0x53, 0x86, 0x08, 0x10, 0xae, 0x9b, 0xb1, 0xbe, 0x45, 0x37, 0x02, 0x77, 0x6f, 0x47, 0x14, 0x42,
+	0xb0, 0x18, 0x7f, 0xdd, 0xce, 0x6c, 0x2b, 0x27, 0xa9, 0xa2, 0xc6, 0xe2, 0xfd, 0x74, 0x8d, 0xc4,
+	0x7d, 0xbc, 0xb8, 0x0a, 0xbb, 0x95, 0x00, 0x00, 0x00, 0x00, 0x49, 0x45, 0x4e, 0x44, 0xae, 0x42,
+	0x60, 0x82,
+};
+static const uint32_t s_png_rgb16_pixels[] = {
+	0xfff50dc1, 0xff3a8555, 0xffe89a93, 0xff2c5bc8, 0xffa8ce99, 0xff52171f, 0xff2d6843, 0xfffbdf4f,
+	0xffd37ac9, 0xffb531ce, 0xff50c6cf, 0xff9b095e, 0xff1125df, 0xffdf6614, 0xff9942c3, 0xffb6dd0f,
+	0xfff0afaa, 0xff6dfef8, 0xffd5eb23, 0xffa9340e, 0xff121c57, 0xffd2fa40, 0xff1ebf9f, 0xff305f08,
+	0xff6d1311, 0xffae0fc8, 0xfff15216, 0xff98bbe4, 0xff3d9bcd, 0xff584b81, 0xff187d2c, 0xff737880,
+	0xff9995ee, 0xff28967e, 0xff76b9fc, 0xff4ebe7c, 0xff9689c3, 0xff5308ae, 0xffb14502, 0xff6f14b0,
+	0xff7fce2b, 0xffa9c6fd,
+};
+
+static const uint8_t s_png_graya16[] = {
+	0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a, 0x00, 0x00, 0x00, 0x0d, 0x49, 0x48, 0x44, 0x52,
+	0x00, 0x00, 0x00, 0x05, 0x00, 0x00, 0x00, 0x07, 0x10, 0x04, 0x00, 0x00, 0x00, 0x3a, 0x3e, 0x93,
+	0x26, 0x00, 0x00, 0x00, 0x4f, 0x49, 0x44, 0x41, 0x54, 0x78, 0xda, 0x01, 0x93, 0x00, 0x6c, 0xff,
+	0x04, 0x9f, 0x0b, 0x10, 0x13, 0x84, 0x60, 0x95, 0x6c, 0xed, 0x61, 0x0b, 0xe4, 0xb2, 0xcf, 0x12,
+	0xd7, 0x22, 0xef, 0xe4, 0x0d, 0x00, 0x37, 0x08, 0x6a, 0x42, 0xe7, 0xb2, 0x2d, 0xa0, 0x8b, 0x10,
+	0x34, 0x87, 0x5b, 0xd9, 0x26, 0x2c, 0x29, 0xf0, 0x33, 0xb6, 0x01, 0xd1, 0x55, 0x79, 0x37, 0x2f,
+	0xa4, 0x0b, 0xea, 0x74, 0xc5, 0xfa, 0x22, 0x23, 0x86, 0xc1, 0xe4, 0x52, 0x8a, 0xa4, 0x46, 0x04,
+	0xb9, 0x6a, 0xf6, 0xb1, 0x01, 0xa1, 0x35, 0x1b, 0x16, 0x88, 0xf5, 0x94, 0x00, 0x00, 0x00, 0x4f,
+	0x49, 0x44, 0x41, 0x54, 0xc6, 0x33, 0xea, 0x06, 0xe6, 0x97, 0xc2, 0x56, 0x43, 0xc3, 0xad, 0x15,
+	0x04, 0x5d, 0x1a, 0x82, 0x16, 0x93, 0x9b, 0x3e, 0x06, 0xf9, 0x02, 0x4b, 0x32, 0x73, 0x3f, 0x06,
+	0x2e, 0x94, 0x95, 0xee, 0x1e, 0x03, 0x74, 0xf6, 0xbc, 0x65, 0x4e, 0xa6, 0x0b, 0x4f, 0x8f, 0xf7,
+	0x46, 0x52, 0xcc, 0x45, 0xb4, 0xaa, 0x52, 0xa8, 0x55, 0xf2, 0x03, 0x5e, 0xfa, 0x3b, 0x8f, 0x69,
+	0xac, 0x2b, 0x10, 0x93, 0x72, 0xd2, 0x29, 0x9f, 0x1f, 0x0f, 0xa5, 0xa9, 0x79, 0x90, 0x4d, 0x57,
+	0xc7, 0x40, 0x45, 0xa6, 0x6b, 0xec, 0x43, 0x00, 0x00, 0x00, 0x00, 0x49, 0x45, 0x4e, 0x44, 0xae,
+	0x42, 0x60, 0x82,
+};
+static const uint32_t s_png_graya16_pixels[] = {
+	0x109f9f9f, 0xa5232323, 0xb0101010, 0xc2c2c2c2, 0xa6e4e4e4, 0x6a373737, 0x2de7e7e7, 0x348b8b8b,
+	0x265b5b5b, 0x33292929, 0x79d1d1d1, 0x84000000, 0x7e747474, 0x3f979797, 0xe3e9e9e9, 0x6f8a8a8a,
+	0xae010101, 0x983a3a3a, 0x015a5a5a, 0x90dadada, 0xf1e7e7e7, 0x2f1d1d1d, 0x7a333333, 0x07cdcdcd,
+	0x7e6e6e6e, 0x34e7e7e7, 0x3cd0d0d0, 0xa1101010, 0x083a3a3a, 0x98a6a6a6, 0x55d1d1d1, 0x73393939,
+	0x5cb7b7b7, 0x41171717, 0xfc070707,
+};
+
+static const uint8_t s_png_rgba16[] = {
+	0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a, 0x00, 0x00, 0x00, 0x0d, 0x49, 0x48, 0x44, 0x52,
+	0x00, 0x00, 0x00, 0x09, 0x00, 0x00, 0x00, 0x03, 0x10, 0x06, 0x00, 0x00, 0x00, 0x11, 0x9a, 0xf9,
+	0x35, 0x00, 0x00, 0x00, 0x73, 0x49, 0x44, 0x41, 0x54, 0x78, 0xda, 0x01, 0xdb, 0x00, 0x24, 0xff,
+	0x03, 0x40, 0x77, 0xbb, 0xdf, 0x0f, 0xfa, 0x0e, 0x9b, 0xdb, 0xb1, 0xe6, 0x5e, 0x36, 0x5b, 0x03,
+	0xb4, 0x45, 0x12, 0x6d, 0xdd, 0x4e, 0xd8, 0xd6, 0x29, 0xcd, 0x7e, 0x74, 0x8e, 0xbc, 0x74, 0xca,
+	0x4b, 0x91, 0x47, 0xe4, 0x23, 0x96, 0x81, 0x4f, 0x1d, 0x2c, 0x15, 0x01, 0xa0, 0x60, 0x01, 0xa1,
+	0x97, 0x5b, 0xef, 0x6f, 0xa0, 0x65, 0xdb, 0xe2, 0x83, 0x2b, 0x19, 0x7c, 0x24, 0x61, 0xd1, 0xe8,
+	0x9f, 0xe8, 0x9c, 0xdd, 0x41, 0xcf, 0x34, 0x95, 0x3f, 0x00, 0xd1, 0x44, 0x8f, 0x09, 0xff, 0x25,
+	0x16, 0x55, 0xb9, 0xc7, 0xc7, 0xee, 0xec, 0xe1, 0xbe, 0x1c, 0xc1, 0x32, 0xe3, 0xf6, 0xe0, 0xd5,
+	0xfc, 0xd6, 0x20, 0x50, 0xb2, 0x3a, 0x6c, 0x5b, 0x32, 0xac, 0x37, 0x39, 0xd3, 0x12, 0xa3, 0xa5,
+	0x00, 0x00, 0x00, 0x73, 0x49, 0x44, 0x41, 0x54, 0x8c, 0x9b, 0xaa, 0x48, 0x2a, 0x4c, 0xd9, 0x57,
+	0x3f, 0xd8, 0xfd, 0x22, 0xfb, 0xab, 0xae, 0x02, 0x29, 0xd5, 0x8f, 0xc6, 0x48, 0x80, 0xe8, 0x76,
+	0xcc, 0xcc, 0xb8, 0x2d, 0x4a, 0x50, 0x7e, 0x6c, 0xb4, 0x43, 0x02, 0x16, 0x3b, 0x79, 0x01, 0x1a,
+	0xf7, 0x6f, 0x2c, 0x0d, 0xf0, 0x7f, 0x39, 0xf4, 0x6b, 0x3b, 0xd4, 0x2f, 0x29, 0xf3, 0xcd, 0x6b,
+	0xe4, 0x78, 0x5e, 0xfe, 0x2d, 0x0c, 0x1e, 0x9b, 0x64, 0xea, 0x54, 0x42, 0x62, 0xba, 0x34, 0x0f,
+	0x59, 0xb5, 0x57, 0x95, 0x03, 0x62, 0x4b, 0xb3, 0xc6, 0x8c, 0x65, 0x5e, 0xc7, 0xae, 0x72, 0xba,
+	0x65, 0xa9, 0x1a, 0x92, 0xff, 0x76, 0xb3, 0x10, 0x91, 0x65, 0xa2, 0xb9, 0x3e, 0xc6, 0x13, 0x0c,
+	0xb6, 0x5b, 0x58, 0x7d, 0x0c, 0x94, 0x68, 0x65, 0x90, 0x6a, 0x73, 0x8b, 0x18, 0x53, 0xfc, 0x00,
+	0x00, 0x00, 0x00, 0x49, 0x45, 0x4e, 0x44, 0xae, 0x42, 0x60, 0x82,
+};
+static const uint32_t s_png_rgba16_pixels[] = {
+	0x0e40bb0f, 0x0afb433d, 0xdbc28e6c, 0x372ebbf2, 0x6aa8410f, 0xd6802167, 0x4d9b7f98, 0x0e78bbad,
+	0x9c243a25, 0x16d18fff, 0xbeb9c7ec, 0xfcc1e3e0, 0x3220b26c, 0x2a378caa, 0xfbd93ffd, 0x48ae298f,
+	0x4ae8ccb8, 0x3b7eb402, 0x7f1a6f0d, 0x720eaa3c, 0x7e79223a, 0x38140c7c, 0x9a23c111, 0x48d64d6f,
+	0xbe90f601, 0x84a05bba, 0x18acb637,
+};
+
+static const uint8_t s_png_rgb8_trns[] = {
+	0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a, 0x00, 0x00, 0x00, 0x0d, 0x49, 0x48, 0x44, 0x52,
+	0x00, 0x00, 0x00, 0x05, 0x00, 0x00, 0x00, 0x05, 0x08, 0x02, 0x00, 0x00, 0x00, 0x02, 0x0d, 0xb1,
+	0xb2, 0x00, 0x00, 0x00, 0x06, 0x74, 0x52, 0x4e, 0x53, 0x00, 0x0a, 0x00, 0x14, 0x00, 0x1e, 0xc5,
+	0x36, 0x29, 0xff, 0x00, 0x00, 0x00, 0x2d, 0x49, 0x44, 0x41, 0x54, 0x78, 0xda, 0x01, 0x50, 0x00,
+	0xaf, 0xff, 0x00, 0x0a, 0x14, 0x1e, 0xf6, 0xfd, 0x84, 0x59, 0xd3, 0x88, 0xea, 0xda, 0xb2, 0xec,
+	0x5e, 0xae, 0x04, 0x43, 0xf7, 0x71, 0x8c, 0x42, 0x47, 0x88, 0xa3, 0x73, 0x6c, 0x42, 0x35, 0xef,
+	0xa7, 0xc5, 0x02, 0x1b, 0x04, 0x5f, 0x58, 0x02, 0xee, 0x73, 0x34, 0xef, 0x00, 0x00, 0x00, 0x2e,
+	0x49, 0x44, 0x41, 0x54, 0xce, 0xf1, 0x48, 0xcd, 0xad, 0x07, 0xfd, 0x6f, 0x6c, 0x4d, 0x03, 0xa9,
+	0x3a, 0x08, 0x22, 0x38, 0xbe, 0xcc, 0xfa, 0x90, 0x1f, 0x95, 0x28, 0xfa, 0x66, 0xb9, 0x01, 0x1f,
+	0x69, 0x7d, 0x64, 0xf6, 0x97, 0xb3, 0x30, 0xa5, 0xbe, 0x22, 0xd0, 0xc6, 0x40, 0xa2, 0xfe, 0xbc,
+	0x26, 0x25, 0x7e, 0x8e, 0x58, 0x00, 0x00, 0x00, 0x00, 0x00, 0x49, 0x45, 0x4e, 0x44, 0xae, 0x42,
+	0x60, 0x82,
+};
+static const uint32_t s_png_rgb8_trns_pixels[] = {
+	0x000a141e, 0xfff6fd84, 0xff59d388, 0xffeadab2, 0xffec5eae, 0xff4d0b8f, 0xff823fd6, 0xffe1e249,
+	0xff5624bd, 0xff45cb82, 0xff680fee, 0xffda41a4, 0xffd22a16, 0xff032bba, 0xffb437cf, 0xffdd417f,
+	0xfffd794f, 0xffb34bc2, 0xff7ad0e6, 0xff91e993, 0xff1f697d, 0xff835f14, 0xff368fb9, 0xfff4b189,
+	0xffbaf12b,
+};
+
+static const uint8_t s_png_rgb16_trns[] = {
+	0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a, 0x00, 0x00, 0x00, 0x0d, 0x49, 0x48, 0x44, 0x52,
+	0x00, 0x00, 0x00, 0x05, 0x00, 0x00, 0x00, 0x05, 0x10, 0x02, 0x00, 0x00, 0x00, 0x52, 0x9d, 0x6d,
+	0xf1, 0x00, 0x00, 0x00, 0x06, 0x74, 0x52, 0x4e, 0x53, 0x03, 0xe8, 0x07, 0xd0, 0x0b, 0xb8, 0xc6,
+	0x86, 0x16, 0xdd, 0x00, 0x00, 0x00, 0x53, 0x49, 0x44, 0x41, 0x54, 0x78, 0xda, 0x01, 0x9b, 0x00,
+	0x64, 0xff, 0x02, 0x03, 0xe8, 0x07, 0xd0, 0x0b, 0xb8, 0x0d, 0xbb, 0xb1, 0x3e, 0x27, 0xe3, 0x97,
+	0xd0, 0x33, 0x05, 0x6e, 0x9f, 0xf6, 0x45, 0xa3, 0x43, 0xa1, 0xd4, 0x77, 0x41, 0x5c, 0xdb, 0xf6,
+	0x36, 0x02, 0xb8, 0x59, 0xd3, 0x2d, 0x50, 0xb8, 0xe0, 0x95, 0x63, 0x5a, 0x92, 0x38, 0x12, 0x90,
+	0x99, 0x67, 0x3b, 0x4b, 0xdf, 0x5e, 0x08, 0x51, 0xd9, 0x4b, 0x7e, 0x8a, 0xfe, 0xb3, 0x77, 0x36,
+	0x02, 0x1f, 0x80, 0x32, 0x4d, 0x1d, 0x15, 0x85, 0x6e, 0x9d, 0x5d, 0x73, 0xac, 0x12, 0xfc, 0x50,
+	0x5f, 0xcc, 0x00, 0x00, 0x00, 0x53, 0x49, 0x44, 0x41, 0x54, 0x95, 0xa0, 0x15, 0xee, 0xab, 0xcf,
+	0x16, 0x15, 0x02, 0x02, 0xf0, 0x00, 0xf2, 0x22, 0x80, 0x1d, 0xc0, 0x03, 0x2e, 0x28, 0x2f, 0x5d,
+	0x8a, 0x22, 0x8f, 0x2d, 0x26, 0xc7, 0x57, 0x7e, 0xf9, 0xd3, 0x29, 0xdf, 0x10, 0xab, 0x18, 0xb9,
+	0x19, 0xbc, 0x35, 0xb0, 0x3e, 0x8e, 0x76, 0x72, 0x15, 0xff, 0x02, 0xc2, 0xd2, 0xb0, 0x7f, 0x2b,
+	0x30, 0x79, 0x78, 0x8d, 0x8b, 0x58, 0x53, 0x02, 0x3b, 0x76, 0xa4, 0xdd, 0xeb, 0x0a, 0xd2, 0x57,
+	0x04, 0x61, 0x2c, 0xc4, 0x1c, 0x5a, 0xb1, 0x36, 0xb3, 0xad, 0x9d, 0x43, 0x33, 0x76, 0xa5, 0x3d,
+	0x52, 0x00, 0x00, 0x00, 0x00, 0x49, 0x45, 0x4e, 0x44, 0xae, 0x42, 0x60, 0x82,
+};
+static const uint32_t s_png_rgb16_trns_pixels[] = {
+	0x0003070b, 0xff0db127, 0xff97336e, 0xfff6a3a1, 0xff775cf6, 0xffbbda5b, 0xffed14b9, 0xffa9cca9,
+	0xffd5ab7a, 0xfff55a6d, 0xffda0c78, 0xff72b12c, 0xffbb6c97, 0xffa4c07c, 0xfff57c8a, 0xff9b35c6,
+	0xff1599d0, 0xff61abc3, 0xff9aced4, 0xff051bc4, 0xff5de5f1, 0xff8e2628, 0xff6321a0, 0xffa42535,
+	0xffc975fa,
+};
+
+static const uint8_t s_png_rgba8_adam7[] = {
+	0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a, 0x00, 0x00, 0x00, 0x0d, 0x49, 0x48, 0x44, 0x52,
+	0x00, 0x00, 0x00, 0x13, 0x00, 0x00, 0x00, 0x0d, 0x08, 0x06, 0x00, 0x00, 0x01, 0x3c, 0x8b, 0x65,
+	0xb1, 0x00, 0x00, 0x02, 0x00, 0x49, 0x44, 0x41, 0x54, 0x78, 0xda, 0x01, 0xf6, 0x03, 0x09, 0xfc,
+	0x03, 0xe4, 0x13, 0x49, 0x9b, 0x33, 0x61, 0x3c, 0x53, 0xa5, 0xb9, 0xf0, 0x2a, 0x03, 0x76, 0xb3,
+	0x4a, 0x6c, 0x7b, 0x71, 0xb9, 0x30, 0x88, 0x9b, 0xb9, 0x78, 0x04, 0x60, 0x51, 0x05, 0xf7, 0x81,
+	0xd0, 0xe4, 0xc3, 0x00, 0xb8, 0xb6, 0xb9, 0x1b, 0x74, 0xf7, 0xfe, 0x2f, 0x04, 0x15, 0x1e, 0xeb,
+	0x2a, 0xd9, 0xda, 0x8a, 0x46, 0xc6, 0xc7, 0xf4, 0x68, 0x19, 0x49, 0x6a, 0xe9, 0x5e, 0x4a, 0x52,
+	0xbf, 0x01, 0xb0, 0x93, 0x76, 0x16, 0xf3, 0xaa, 0x94, 0x3a, 0x15, 0x59, 0x7c, 0x39, 0xe6, 0x45,
+	0x40, 0xc8, 0x97, 0x22, 0x08, 0x68, 0x01, 0xcd, 0x19, 0x73, 0x4a, 0x3d, 0x5f, 0x0d, 0x59, 0x27,
+	0x49, 0xa1, 0x66, 0xfe, 0x65, 0x64, 0xd5, 0x1f, 0xb7, 0xd1, 0x73, 0x03, 0x2d, 0x58, 0xaf, 0x26,
+	0x36, 0x55, 0xff, 0x1e, 0xae, 0xdf, 0x73, 0xbc, 0xa1, 0x73, 0x25, 0x3f, 0xd8, 0x66, 0xd1, 0xbb,
+	0x01, 0x3b, 0x8b, 0x7f, 0x7c, 0xd3, 0xd5, 0xf9, 0x09, 0x79, 0xad, 0xb7, 0x1c, 0x70, 0xeb, 0xe3,
+	0x03, 0x15, 0xf1, 0x2b, 0x87, 0x01, 0xb6, 0x39, 0xf3, 0xd0, 0x58, 0x87, 0x11, 0x15, 0xe8, 0x88,
+	0x4e, 0x24, 0xf2, 0x6d, 0x45, 0x24, 0x3b, 0x7d, 0xf4, 0xa8, 0x00, 0x9c, 0xfd, 0xa7, 0xff, 0xdd,
+	0x6a, 0xc0, 0x77, 0x14, 0xa9, 0x4a, 0x40, 0x2d, 0xf0, 0xbf, 0xd3, 0x48, 0x91, 0x1b, 0x05, 0x0d,
+	0x20, 0x1e, 0xf2, 0xe7, 0x4c, 0xf8, 0x29, 0x35, 0xb0, 0x0b, 0x2c, 0x21, 0xe5, 0xf0, 0xe7, 0x98,
+	0x66, 0x7d, 0xdc, 0x00, 0xac, 0x6d, 0xd8, 0x07, 0x3e, 0x8b, 0x54, 0xe0, 0x08, 0x46, 0xe1, 0x4b,
+	0x97, 0x5e, 0xb7, 0xe7, 0x88, 0x12, 0xdf, 0x83, 0x7a, 0x0d, 0x21, 0x5b, 0x4b, 0xe8, 0x1c, 0x5c,
+	0x7a, 0xee, 0xa9, 0xc5, 0x8f, 0x1d, 0xaf, 0x64, 0xec, 0xe8, 0xcb, 0x7d, 0x00, 0xec, 0xda, 0xb0,
+	0x7e, 0x01, 0x77, 0x2b, 0xa8, 0x1d, 0x58, 0x63, 0xb1, 0x2b, 0x99, 0xb5, 0xcc, 0xc5, 0xcb, 0xd9,
+	0x96, 0xa8, 0xeb, 0x51, 0x7a, 0x97, 0x6e, 0x46, 0x33, 0xaf, 0x6d, 0x64, 0x58, 0xd6, 0xf3, 0x13,
+	0x42, 0x2c, 0x61, 0x7e, 0xd7, 0x01, 0x8c, 0x60, 0x4a, 0x16, 0xbf, 0x8b, 0xdc, 0x5c, 0xef, 0xe9,
+	0xc8, 0x65, 0xce, 0xcc, 0x23, 0xad, 0x73, 0x0b, 0x69, 0x3a, 0x36, 0x5c, 0x37, 0x35, 0xaa, 0x29,
+	0x05, 0xd7, 0x19, 0xf1, 0x32, 0xd4, 0xd2, 0x28, 0x9f, 0x25, 0x04, 0x7e, 0xfb, 0x4d, 0x0e, 0xb2,
+	0x11, 0xdd, 0xc2, 0xee, 0x1c, 0x5b, 0x0e, 0xba, 0x02, 0xc6, 0x38, 0x19, 0xd8, 0x9d, 0x23, 0x91,
+	0xa1, 0x25, 0x3b, 0xd9, 0x71, 0xf1, 0x8d, 0x22, 0x54, 0x90, 0xdc, 0x08, 0xdd, 0xed, 0x49, 0x00,
+	0xef, 0x9f, 0xbb, 0x8e, 0xa7, 0x71, 0x22, 0xaa, 0xac, 0x34, 0x34, 0x43, 0xca, 0x9f, 0x0b, 0x70,
+	0xec, 0xdf, 0x8a, 0x29, 0x87, 0x45, 0x13, 0xb8, 0x62, 0xb3, 0xfc, 0x28, 0x22, 0xcb, 0x05, 0x1e,
+	0x9c, 0xeb, 0x38, 0x1e, 0x03, 0x01, 0x9b, 0xbf, 0xe5, 0xb3, 0xab, 0xbd, 0x7c, 0xf9, 0xca, 0x88,
+	0x53, 0x0b, 0x8b, 0xb3, 0xe4, 0xdb, 0xa5, 0xb2, 0xb8, 0x0e, 0xa5, 0x9f, 0xf4, 0xee, 0xc3, 0xa5,
+	0xfb, 0x80, 0x10, 0xbb, 0x11, 0x84, 0x74, 0xb7, 0xc0, 0x00, 0x41, 0x5f, 0xb1, 0xa5, 0xa6, 0xd6,
+	0x94, 0xd4, 0x6c, 0x24, 0x52, 0xbb, 0xdb, 0xa8, 0x36, 0x53, 0xc5, 0xc9, 0x9f, 0x73, 0xa0, 0x05,
+	0x20, 0x32, 0x2c, 0x23, 0xca, 0xa2, 0x11, 0xed, 0x27, 0x48, 0x30, 0xbb, 0xd1, 0x3f, 0x02, 0xa9,
+	0x53, 0xcc, 0x36, 0xe1, 0xea, 0xe9, 0x77, 0xd9, 0x56, 0x9f, 0x87, 0xbb, 0x51, 0x99, 0x71, 0xd7,
+	0xca, 0x40, 0x64, 0xac, 0x30, 0x58, 0xb7, 0x14, 0x1c, 0x44, 0x1e, 0x83, 0x89, 0x00, 0x00, 0x02,
+	0x01, 0x49, 0x44, 0x41, 0x54, 0x9e, 0xf8, 0x92, 0x10, 0xca, 0x73, 0x68, 0xec, 0x06, 0x5a, 0x04,
+	0xf1, 0x18, 0xbd, 0x55, 0xba, 0x84, 0x11, 0x10, 0xb9, 0x39, 0x34, 0x91, 0x8e, 0x75, 0x18, 0x4f,
+	0x3d, 0x58, 0x1c, 0x43, 0x7a, 0x8e, 0xd1, 0xb2, 0x0d, 0x37, 0xf6, 0x66, 0xff, 0x2b, 0xf4, 0x80,
+	0x01, 0x7c, 0xdc, 0xc7, 0x03, 0x59, 0xd3, 0x10, 0x37, 0x66, 0x38, 0xf5, 0xd1, 0xc3, 0x6d, 0xbd,
+	0x68, 0xd1, 0x6b, 0xda, 0x69, 0xd1, 0xfd, 0x0a, 0x1e, 0x1e, 0x35, 0x8e, 0x0a, 0x44, 0x30, 0xa2,
+	0xe9, 0x89, 0x4e, 0x5a, 0xfc, 0xa8, 0xee, 0x16, 0xad, 0x5e, 0x14, 0x48, 0x7f, 0xa6, 0x44, 0x25,
+	0x69, 0xf8, 0xdb, 0x94, 0x35, 0x8d, 0xf7, 0xa3, 0xe9, 0x68, 0x7e, 0x69, 0xcf, 0x47, 0x5c, 0x31,
+	0xc9, 0xf9, 0x72, 0xa5, 0x5d, 0x5e, 0x83, 0x96, 0x5d, 0x0c, 0xda, 0x52, 0x1b, 0xdc, 0x30, 0xef,
+	0xac, 0x03, 0xb0, 0x3a, 0x57, 0xb1, 0x31, 0x67, 0xfa, 0x7b, 0x43, 0x76, 0xa2, 0x19, 0xaf, 0x40,
+	0x88, 0x0f, 0x7d, 0xa9, 0x70, 0xfd, 0x28, 0xba, 0xd1, 0xf9, 0xdc, 0xfd, 0x39, 0x04, 0x42, 0xd9,
+	0xe2, 0x38, 0x7d, 0xd8, 0xbe, 0x2a, 0xb9, 0x10, 0x6f, 0xd7, 0x3c, 0xc8, 0x96, 0xa9, 0xe1, 0x39,
+	0xc0, 0x8b, 0x44, 0x33, 0x7b, 0xa3, 0x65, 0xec, 0x44, 0x1a, 0x90, 0x5a, 0xa6, 0xe5, 0xb9, 0x82,
+	0xaa, 0xc0, 0xd7, 0xf0, 0xe0, 0x4c, 0x4a, 0x5a, 0x50, 0xc0, 0x24, 0xa2, 0x9d, 0xfe, 0x04, 0x1d,
+	0xd6, 0x9d, 0xe7, 0xe4, 0x35, 0xcb, 0x16, 0xfb, 0x0a, 0x3d, 0xd5, 0x7e, 0x80, 0x4f, 0xa4, 0x98,
+	0x92, 0xd6, 0x2f, 0xbb, 0xf5, 0xf4, 0x60, 0x1f, 0x5d, 0xf5, 0x85, 0x3d, 0xef, 0xf2, 0x84, 0x09,
+	0x96, 0x03, 0x02, 0x6c, 0x2e, 0xae, 0x81, 0xe6, 0x69, 0x4a, 0xc2, 0x10, 0xcc, 0x7b, 0xf9, 0xdc,
+	0x2b, 0xa2, 0x0c, 0xb2, 0x52, 0xd2, 0xb1, 0xe6, 0xab, 0x1e, 0x10, 0xdc, 0x80, 0xaf, 0xc8, 0x64,
+	0x35, 0x47, 0xdc, 0x3d, 0xfc, 0x79, 0x8b, 0x90, 0x7d, 0xd6, 0x5d, 0x02, 0xcf, 0xf4, 0x71, 0x32,
+	0x75, 0x2f, 0x87, 0xa9, 0x85, 0xb4, 0x3f, 0xf6, 0xd3, 0x56, 0xf0, 0x80, 0x35, 0xec, 0xa6, 0xed,
+	0x50, 0xea, 0x1e, 0x60, 0x19, 0x6b, 0x46, 0x64, 0x90, 0x6a, 0xf9, 0x1c, 0x1f, 0x97, 0x60, 0x8a,
+	0x1b, 0x57, 0x3e, 0x92, 0xbe, 0xb3, 0x33, 0xba, 0xc9, 0xe7, 0xa8, 0x41, 0xa9, 0x0c, 0xd5, 0xcf,
+	0x73, 0x2a, 0x4d, 0xea, 0x49, 0x28, 0x89, 0x63, 0x42, 0x7c, 0x79, 0xd1, 0x40, 0x56, 0xcf, 0x96,
+	0x9e, 0xce, 0x26, 0xd0, 0xd9, 0x64, 0x70, 0x69, 0x04, 0x34, 0x59, 0x2b, 0xa1, 0x84, 0x9d, 0x6e,
+	0x6c, 0x14, 0x91, 0xb8, 0x69, 0x75, 0x62, 0x02, 0x8b, 0x85, 0xf6, 0xa6, 0x1b, 0x94, 0x32, 0x2b,
+	0xd8, 0xc7, 0x0a, 0x44, 0x08, 0x51, 0x5d, 0x9e, 0x75, 0x4e, 0x3c, 0x48, 0xbb, 0xaa, 0x51, 0xb0,
+	0x41, 0x42, 0xd1, 0xb2, 0x5d, 0x5b, 0xf3, 0x52, 0xb7, 0x1a, 0xde, 0xb3, 0xdd, 0x54, 0x42, 0x71,
+	0x84, 0x12, 0x35, 0x31, 0x90, 0x1c, 0x9b, 0xe1, 0xe4, 0x1e, 0xf0, 0x97, 0xa1, 0x54, 0x0f, 0xa1,
+	0xeb, 0xf2, 0x44, 0x02, 0x45, 0x01, 0x25, 0xbb, 0xc8, 0xfc, 0x7b, 0x47, 0x80, 0xa0, 0xf6, 0xcc,
+	0x7f, 0x48, 0x4a, 0x6d, 0x68, 0xb1, 0xe7, 0xf4, 0xd5, 0xd3, 0x53, 0xb0, 0x26, 0x9f, 0x40, 0xac,
+	0xa9, 0xb0, 0xca, 0x1b, 0xa4, 0x46, 0x0a, 0x76, 0xc4, 0xf9, 0x92, 0xaf, 0xd7, 0xe3, 0x50, 0x57,
+	0xae, 0x45, 0x98, 0xf0, 0xb2, 0x4a, 0x68, 0x13, 0x0a, 0xa3, 0x86, 0x65, 0xe8, 0xef, 0xfe, 0xaa,
+	0xe2, 0xc8, 0xfc, 0x64, 0x6f, 0xd1, 0x0a, 0x51, 0x35, 0xf2, 0xa8, 0xbe, 0xef, 0xb9, 0x7d, 0x3d,
+	0x43, 0x80, 0xaa, 0x1b, 0xf7, 0x64, 0xc6, 0xeb, 0xb7, 0xf4, 0x00, 0x00, 0x00, 0x00, 0x49, 0x45,
+	0x4e, 0x44, 0xae, 0x42, 0x60, 0x82,
+};
+static const uint32_t s_png_rgba8_adam7_pixels[] = {
+	0x9be41349, 0x168c604a, 0x4acd1973, 0x724beb26, 0xf7605105, 0xd73ad4ee, 0xa30a7880, 0x8408a011,
+	0xa0a56a60, 0xbe7bab7a, 0x0931c121, 0xf3b107b1, 0xbae121e9, 0xca5b30b6, 0xde2f2685, 0x9e7421e8,
+	0x7af7ee20, 0xc3464987, 0x514edd56, 0x3759d310, 0xec92a1fd, 0xde0cbd3b, 0xd8d7c9f7, 0x8a3c6185,
+	0x4f3c65d0, 0x1062620a, 0x04ba7f5f, 0xaf052d45, 0xd6602a6a, 0xd4d6595a, 0x9f6307c1, 0x38befa03,
+	0xebc7fb6a, 0x3eaad966, 0x7c4eded8, 0x9b85f202, 0x684e5353, 0xe0035918, 0xff9cfda7, 0x240a5b97,
+	0x77dd6ac0, 0x34bcfc74, 0x4014a94a, 0x80aa0749, 0xd32df0bf, 0xb86409d7, 0x0548911b, 0xe194e174,
+	0xf20d201e, 0x2e42a8d6, 0x29e74cf8, 0xbb1b19c7, 0x2c35b00b, 0x7a3d6d78, 0xe721e5f0, 0xe7454a65,
+	0xdc98667d, 0xccdca35f, 0x57e809a8, 0xb3bdd913, 0xd479110d, 0xacd7e2b9, 0x76b15d95, 0x47655c88,
+	0x5dd14655, 0xb0e8110b, 0x9a5d2da9, 0x60d50b17, 0x0a7d422c, 0xc4e1d192, 0xf139d2c2, 0x7c012f3a,
+	0x3ce00833, 0xb7896dfa, 0x4fb5baf6, 0x95802b24, 0x2a151eeb, 0x8eef9fbb, 0x4b9364e8, 0xaaa77122,
+	0x70eef875, 0x43ac3434, 0x9584c3b3, 0x70ca9f0b, 0xd8b4bf69, 0x29ecdf8a, 0x0b08a1dd, 0xb8874513,
+	0xc1cd08d3, 0x2862b3fc, 0xb3bcd6d6, 0x1e22cb05, 0x802b5225, 0x1e9ceb38, 0x3d5d3f67, 0xb3f979fc,
+	0x6ddd3ec7, 0x88b8e350, 0x57f7919f, 0x868f748f, 0xd64a5283, 0x5b69af78, 0xe10e9e47, 0xe317dc0e,
+	0x64830a57, 0x22bb7361, 0x038d3fdc, 0xd0bdfc7e, 0xa2eb4e94, 0x8cd1da58, 0x04bc5a07, 0x93eda241,
+	0xda2ab6ba, 0x37baa8fa, 0x07ac6dd8, 0x2c78ea1c, 0xe03e8b54, 0xe74258dc, 0x4b0846e1, 0xe8701010,
+	0xe7975eb7, 0x90a8e2c0, 0x838812df, 0x14a58557, 0x5b7a0d21, 0x5aa40ad4, 0x5c4be81c, 0x3c71218d,
+	0xc57aeea9, 0x3ec98604, 0x648f1daf, 0xee362cd5, 0x7dece8cb, 0xe5c86d6d, 0x16526d4e, 0x7e3d978f,
+	0xd7cae78f, 0x73c46035, 0x369a3ca1, 0xbf821abe, 0xfd9e0840, 0x6d36736e, 0xf69e6195, 0xdc792694,
+	0x44562684, 0x9f660853, 0x8c5e78e1, 0xef1a02e1, 0xd5fed680, 0x292df810, 0xaac884e0, 0xa0930c6a,
+	0xb9e8bc6e, 0xa5415fb1, 0x7c3b8b7f, 0xd4a6d694, 0x1bb8b6b9, 0xbb6c2452, 0x850e6078, 0x53dba836,
+	0xdc410420, 0x73c5c99f, 0xa1870d2f, 0x32a00520, 0x2f74f7fe, 0xa22c23ca, 0xa4f7f812, 0x4811ed27,
+	0x232414d9, 0x3f30bbd1, 0x2b0ce93d, 0x86fcc698, 0x82d663db, 0xebea2893, 0x765ff995, 0x8ee456db,
+	0x0e586e06, 0xc71f464a, 0x7270a3de, 0x2884df26, 0xae48301e, 0x0b8af7d0, 0xc2b1ea22, 0x9fcbc8d5,
+	0x101f0a52, 0x1c2c3783, 0x001a7161, 0xa13861a7, 0x951c7081, 0xda0e506c, 0x7eecdab0, 0xdbeab27d,
+	0xa801772b, 0x4b87c07d, 0xb11d5863, 0x42457af1, 0xcc2b99b5, 0xc496f9cf, 0x96c5cbd9, 0xd79c93df,
+	0x7aa8eb51, 0xe94c3578, 0x33976e46, 0x9a403f68, 0x58af6d64, 0xbba3fdf1, 0x42d6f313, 0x9998a7d7,
+	0xd72c617e, 0xfc25bbc8, 0x9ca00248, 0xe496cec7, 0x95e03b2f, 0x68c72f04, 0x071adf2a, 0xb75a8bd3,
+	0xfd24a677, 0xf62e1c3b, 0xd9c0cb12, 0x1e1022c0, 0x68a81272, 0x0b10257c, 0xfa968a64, 0xc2943446,
+	0x939098b5, 0x859ae9ea, 0x3e42a7d9, 0xbebfe41c, 0x16b09376, 0x30dbca3a, 0xd0b639f3, 0x40414e4b,
+	0x50a33d0a, 0xd1fa8725, 0xe50ec004, 0x20886e3d, 0x89b89686, 0x63c5c659, 0x09f64852, 0x1516212a,
+	0x519edbc6, 0x7b235820, 0x2de8b597, 0x1aa2285c, 0xb935fdce, 0xe199a438, 0xd523328b,
+};
+
+static const uint8_t s_png_rgba8_adam7_tiny[] = {
+	0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a, 0x00, 0x00, 0x00, 0x0d, 0x49, 0x48, 0x44, 0x52,
+	0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00, 0x02, 0x08, 0x06, 0x00, 0x00, 0x01, 0xea, 0x73, 0x56,
+	0x8c, 0x00, 0x00, 0x00, 0x12, 0x49, 0x44, 0x41, 0x54, 0x78, 0xda, 0x63, 0x3e, 0x1c, 0x36, 0x8f,
+	0x8d, 0x99, 0xf7, 0xa0, 0xf0, 0x14, 0x96, 0xd2, 0xfa, 0xca, 0xaf, 0x21, 0xee, 0xd9, 0x9b, 0x00,
+	0x00, 0x00, 0x13, 0x49, 0x44, 0x41, 0x54, 0x8c, 0xb3, 0x6e, 0xec, 0xf4, 0xe2, 0x39, 0xb7, 0xe1,
+	0xc9, 0xd7, 0x7a, 0xf7, 0xc5, 0x00, 0x9f, 0x5e, 0x0c, 0xe1, 0xac, 0x77, 0xa1, 0x7b, 0x00, 0x00,
+	0x00, 0x00, 0x49, 0x45, 0x4e, 0x44, 0xae, 0x42, 0x60, 0x82,
+};
+static const uint32_t s_png_rgba8_adam7_tiny_pixels[] = {
+	0x06c3569e, 0xf5757f79, 0x940dc113, 0x4a9ad8b9, 0x2ea6a669, 0xd19b25b0,
+};
+
+static const uint8_t s_png_palette1[] = {
+	0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a, 0x00, 0x00, 0x00, 0x0d, 0x49, 0x48, 0x44, 0x52,
+	0x00, 0x00, 0x00, 0x0b, 0x00, 0x00, 0x00, 0x04, 0x01, 0x03, 0x00, 0x00, 0x00, 0x62, 0x34, 0x57,
+	0xb0, 0x00, 0x00, 0x00, 0x06, 0x50, 0x4c, 0x54, 0x45, 0xce, 0x7d, 0x04, 0xa6, 0xc0, 0x46, 0x89,
+	0x15, 0x67, 0x1b, 0x00, 0x00, 0x00, 0x0a, 0x49, 0x44, 0x41, 0x54, 0x78, 0xda, 0x63, 0x31, 0x5c,
+	0xcf, 0x50, 0xe1, 0xc0, 0x7c, 0xf5, 0x6b, 0x30, 0xed, 0x00, 0x00, 0x00, 0x0a, 0x49, 0x44, 0x41,
+	0x54, 0x34, 0x81, 0xf1, 0xc4, 0x0e, 0x00, 0x16, 0x63, 0x04, 0x46, 0xc5, 0x5e, 0x7b, 0x9b, 0x00,
+	0x00, 0x00, 0x00, 0x49, 0x45, 0x4e, 0x44, 0xae, 0x42, 0x60, 0x82,
+};
+static const uint32_t s_png_palette1_pixels[] = {
+	0xffce7d04, 0xffce7d04, 0xffa6c046, 0xffa6c046, 0xffce7d04, 0xffce7d04, 0xffce7d04, 0xffa6c046,
+	0xffa6c046, 0xffa6c046, 0xffa6c046, 0xffce7d04, 0xffa6c046, 0xffa6c046, 0xffa6c046, 0xffa6c046,
+	0xffce7d04, 0xffce7d04, 0xffce7d04, 0xffce7d04, 0xffa6c046, 0xffce7d04, 0xffce7d04, 0xffce7d04,
+	0xffce7d04, 0xffce7d04, 0xffce7d04, 0xffce7d04, 0xffce7d04, 0xffa6c046, 0xffa6c046, 0xffce7d04,
+	0xffce7d04, 0xffa6c046, 0xffa6c046, 0xffce7d04, 0xffce7d04, 0xffa6c046, 0xffce7d04, 0xffce7d04,
+	0xffce7d04, 0xffa6c046, 0xffce7d04, 0xffce7d04,
+};
+
+static const uint8_t s_png_palette2[] = {
+	0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a, 0x00, 0x00, 0x00, 0x0d, 0x49, 0x48, 0x44, 0x52,
+	0x00, 0x00, 0x00, 0x0b, 0x00, 0x00, 0x00, 0x04, 0x02, 0x03, 0x00, 0x00, 0x00, 0x25, 0x94, 0x2d,
+	0x60, 0x00, 0x00, 0x00, 0x0c, 0x50, 0x4c, 0x54, 0x45, 0xa3, 0x03, 0x4c, 0xd1, 0x85, 0xb3, 0x51,
+	0xe5, 0x18, 0x2e, 0xf5, 0xa4, 0x16, 0x37, 0xae, 0xc6, 0x00, 0x00, 0x00, 0x0c, 0x49, 0x44, 0x41,
+	0x54, 0x78, 0xda, 0x63, 0x0c, 0x8c, 0xbe, 0xc2, 0xb4, 0xe9, 0xf6, 0x11, 0x96, 0xc4, 0xdc, 0x4c,
+	0xef, 0x00, 0x00, 0x00, 0x0d, 0x49, 0x44, 0x41, 0x54, 0xdc, 0x1c, 0x59, 0xa6, 0xbb, 0x9f, 0x16,
+	0x00, 0x00, 0x37, 0x24, 0x07, 0x40, 0x8c, 0xb0, 0x74, 0xb7, 0x00, 0x00, 0x00, 0x00, 0x49, 0x45,
+	0x4e, 0x44, 0xae, 0x42, 0x60, 0x82,
+};
+static const uint32_t s_png_palette2_pixels[] = {
+	0xffd185b3, 0xffd185b3, 0xffa3034c, 0xffd185b3, 0xff51e518, 0xff51e518, 0xff2ef5a4, 0xffa3034c,
+	0xff51e518, 0xffa3034c, 0xffa3034c, 0xffa3034c, 0xffa3034c, 0xffa3034c, 0xff2ef5a4, 0xff51e518,
+	0xffa3034c, 0xffd185b3, 0xff2ef5a4, 0xffd185b3, 0xffa3034c, 0xffd185b3, 0xffd185b3, 0xff2ef5a4,
+	0xffa3034c, 0xffa3034c, 0xff2ef5a4, 0xff2ef5a4, 0xffa3034c, 0xff2ef5a4, 0xff51e518, 0xff51e518,
+	0xffd185b3, 0xffd185b3, 0xffa3034c, 0xff2ef5a4, 0xffd185b3, 0xff2ef5a4, 0xff51e518, 0xffd185b3,
+	0xffd185b3, 0xffd185b3, 0xffa3034c, 0xffd185b3,
+};
+
+static const uint8_t s_png_palette4[] = {
+	0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a, 0x00, 0x00, 0x00, 0x0d, 0x49, 0x48, 0x44, 0x52,
+	0x00, 0x00, 0x00, 0x0b, 0x00, 0x00, 0x00, 0x04, 0x04, 0x03, 0x00, 0x00, 0x00, 0xaa, 0xd4, 0xd8,
+	0xc0, 0x00, 0x00, 0x00, 0x30, 0x50, 0x4c, 0x54, 0x45, 0xbc, 0xb9, 0xc5, 0xd7, 0xa4, 0x5d, 0x95,
+	0xf2, 0x13, 0x4b, 0x81, 0x28, 0x37, 0x31, 0xbc, 0xed, 0x07, 0x44, 0xf9, 0x84, 0xae, 0x15, 0x99,
+	0x7c, 0xad, 0x43, 0x6e, 0x73, 0x1e, 0x9a, 0xb1, 0xc3, 0x11, 0x49, 0x76, 0xfb, 0x44, 0x88, 0xac,
+	0xca, 0x5d, 0x9a, 0xf4, 0x4c, 0xf1, 0x14, 0x1f, 0xf4, 0x59, 0x19, 0x8a, 0x86, 0x00, 0x00, 0x00,
+	0x12, 0x49, 0x44, 0x41, 0x54, 0x78, 0xda, 0x63, 0x5c, 0x98, 0xa2, 0xd8, 0x64, 0x75, 0x8f, 0xc1,
+	0x6f, 0x02, 0xf7, 0xd9, 0xf4, 0x0f, 0x4c, 0xd1, 0x6e, 0x25, 0x91, 0x00, 0x00, 0x00, 0x13, 0x49,
+	0x44, 0x41, 0x54, 0xae, 0xf6, 0x62, 0x8a, 0xaa, 0x0f, 0x98, 0xcd, 0x1b, 0xbe, 0xc8, 0x3a, 0xf9,
+	0x00, 0x00, 0x90, 0xa9, 0x09, 0xea, 0xb2, 0xf3, 0x3c, 0xde, 0x00, 0x00, 0x00, 0x00, 0x49, 0x45,
+	0x4e, 0x44, 0xae, 0x42, 0x60, 0x82,
+};
+static const uint32_t s_png_palette4_pixels[] = {
+	0xffb1c311, 0xffd7a45d, 0xffbcb9c5, 0xffed0744, 0xff95f213, 0xfff984ae, 0xffb1c311, 0xffad436e,
+	0xfff44cf1, 0xff95f213, 0xff4488ac, 0xff3731bc, 0xfff44cf1, 0xff731e9a, 0xffbcb9c5, 0xffbcb9c5,
+	0xff4976fb, 0xff4488ac, 0xffca5d9a, 0xfff984ae, 0xff15997c, 0xff141ff4, 0xff731e9a, 0xff4b8128,
+	0xff4488ac, 0xff141ff4, 0xff95f213, 0xffd7a45d, 0xfff44cf1, 0xfff44cf1, 0xffad436e, 0xff4488ac,
+	0xffca5d9a, 0xffad436e, 0xffbcb9c5, 0xff95f213, 0xff15997c, 0xffd7a45d, 0xffad436e, 0xffb1c311,
+	0xffbcb9c5, 0xffca5d9a, 0xffad436e, 0xff95f213,
+};
+
+static const uint8_t s_png_palette8[] = {
+	0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a, 0x00, 0x00, 0x00, 0x0d, 0x49, 0x48, 0x44, 0x52,
+	0x00, 0x00, 0x00, 0x0b, 0x00, 0x00, 0x00, 0x04, 0x08, 0x03, 0x00, 0x00, 0x00, 0x6f, 0x24, 0x35,
+	0xc1, 0x00, 0x00, 0x03, 0x00, 0x50, 0x4c, 0x54, 0x45, 0x23, 0x01, 0x39, 0x08, 0x02, 0xeb, 0x67,
+	0x77, 0x70, 0x06, 0x03, 0x61, 0x09, 0xc9, 0x3e, 0xae, 0x27, 0xf5, 0xfc, 0x4e, 0x56, 0x25, 0x41,
+	0xe1, 0xed, 0xf1, 0x3b, 0x45, 0x12, 0x61, 0xba, 0xec, 0xd9, 0x3f, 0x39, 0x74, 0x43, 0x43, 0x85,
+	0x9d, 0xc9, 0x73, 0xc3, 0xc1, 0x08, 0xd1, 0xfd, 0xdd, 0x13, 0x72, 0xa4, 0x18, 0x32, 0x74, 0xbb,
+	0x4a, 0xd1, 0x91, 0x26, 0x45, 0xa3, 0x96, 0x81, 0xe1, 0x28, 0x80, 0x5a, 0x89, 0xa9, 0x81, 0xe9,
+	0x73, 0xb2, 0xa2, 0xfb, 0x88, 0x7a, 0xaf, 0x8c, 0x09, 0x35, 0xd3, 0x1b, 0xc3, 0x6a, 0x7c, 0x36,
+	0x50, 0x64, 0xc5, 0x93, 0xeb, 0x48, 0x84, 0xcc, 0xc1, 0x3e, 0x38, 0xe2, 0xe9, 0x07, 0x50, 0x40,
+	0x52, 0xc0, 0x83, 0x12, 0xfb, 0xa2, 0x22, 0x38, 0x10, 0x5c, 0x1b, 0xc8, 0xac, 0x7d, 0x06, 0x7e,
+	0x34, 0x18, 0x49, 0x3b, 0xb8, 0x4f, 0x58, 0xea, 0xfe, 0x27, 0xe1, 0xe0, 0x20, 0x5c, 0x02, 0xa4,
+	0xa1, 0x53, 0xa2, 0xef, 0x1d, 0xd7, 0x6f, 0x8d, 0xd4, 0xd0, 0x90, 0xbd, 0x4a, 0x64, 0x06, 0xdf,
+	0x06, 0x4f, 0x95, 0xf4, 0x38, 0xdd, 0xce, 0xf4, 0x54, 0x02, 0xa9, 0xaf, 0x3b, 0x4d, 0x04, 0x58,
+	0x28, 0x7b, 0xb5, 0xcc, 0x78, 0x21, 0x23, 0xa3, 0x7a, 0x16, 0x7e, 0xae, 0x98, 0xaa, 0xac, 0x39,
+	0xd5, 0xbf, 0x28, 0x5a, 0x9d, 0x4b, 0xc2, 0xcb, 0xa1, 0x68, 0x32, 0x3f, 0x1f, 0xe7, 0x7e, 0x11,
+	0xbb, 0x56, 0x2c, 0x05, 0x77, 0xdf, 0xf3, 0xd9, 0x6d, 0x1c, 0x01, 0x76, 0xb9, 0xf5, 0xc4, 0xd9,
+	0x5e, 0x2b, 0xc8, 0x2b, 0xfd, 0x92, 0x61, 0x77, 0x4c, 0xc1, 0x12, 0xe1, 0x1b, 0x32, 0xb9, 0x40,
+	0x9e, 0xb1, 0xc5, 0x12, 0x2c, 0xc1, 0x1e, 0x39, 0xc3, 0xb1, 0x4b, 0x73, 0xd9, 0x77, 0xf7, 0xa4,
+	0x32, 0x28, 0x71, 0x18, 0x9a, 0x7d, 0x6a, 0x19, 0x79, 0xe2, 0xaf, 0x66, 0x1a, 0xf6, 0x37, 0xad,
+	0x94, 0xfc, 0xa0, 0x71, 0x9e, 0x91, 0x5e, 0xe8, 0xf8, 0xb3, 0x52, 0xbc, 0x96, 0xe7, 0x92, 0xb4,
+	0x81, 0xc8, 0x87, 0xc3, 0x46, 0xcb, 0xff, 0x67, 0xf6, 0xf1, 0x29, 0x31, 0xc6, 0x4b, 0x00, 0xe1,
+	0x8c, 0x99, 0xcd, 0xd9, 0x0f, 0x7a, 0x0f, 0xa4, 0x2a, 0x43, 0xd7, 0xf8, 0x85, 0x28, 0xf2, 0x63,
+	0x82, 0x5f, 0x7d, 0x6b, 0x8d, 0x2b, 0x80, 0x8f, 0x30, 0xfa, 0x43, 0x63, 0x40, 0xc0, 0x00, 0x97,
+	0x0c, 0x72, 0x2b, 0x40, 0x6c, 0xef, 0xd5, 0xf1, 0x54, 0xe1, 0x7b, 0xf7, 0x13, 0x08, 0x86, 0xc5,
+	0xcd, 0x9a, 0x79, 0xf4, 0x8e, 0x7e, 0xbf, 0x62, 0x87, 0x47, 0x70, 0x42, 0x2f, 0x18, 0xc8, 0x32,
+	0xb7, 0x26, 0x50, 0xfa, 0xd0, 0xa7, 0xac, 0x5c, 0xb1, 0xcb, 0x1e, 0x9d, 0x14, 0xb8, 0xae, 0xe2,
+	0x77, 0xfc, 0x49, 0x10, 0xa9, 0x20, 0x38, 0xbd, 0xb7, 0xdd, 0x4e, 0x4f, 0x50, 0x91, 0x46, 0x2d,
+	0x0d, 0xad, 0x31, 0x2a, 0x19, 0x60, 0x09, 0xd2, 0xbe, 0x86, 0x7b, 0xdf, 0xa8, 0x85, 0x84, 0x1c,
+	0x79, 0x47, 0xf6, 0xbf, 0x11, 0xab, 0x2f, 0x0b, 0xd3, 0x7e, 0xb3, 0xb1, 0x01, 0xed, 0xd7, 0x55,
+	0x1d, 0x1a, 0xac, 0x2b, 0x6e, 0x6d, 0x42, 0xbf, 0xa4, 0x8b, 0x4f, 0x43, 0x66, 0xed, 0x27, 0xe4,
+	0x32, 0x71, 0xd0, 0x6a, 0xf3, 0xce, 0x5d, 0x7d, 0x46, 0xfa, 0xe9, 0xb0, 0x8a, 0x00, 0x46, 0x9a,
+	0xd7, 0xca, 0xb4, 0xb9, 0x5b, 0x7c, 0x18, 0xfd, 0x2d, 0x9e, 0x9b, 0x85, 0xcb, 0x65, 0x24, 0x1b,
+	0xce, 0xeb, 0x6b, 0x4e, 0xbb, 0x33, 0x63, 0x6e, 0x35, 0xac, 0xfe, 0xb5, 0x4c, 0x2a, 0x08, 0x4b,
+	0xba, 0xb2, 0x11, 0x02, 0x18, 0x70, 0xb1, 0x7f, 0xf7, 0x58, 0x8e, 0x50, 0x00, 0x84, 0x8f, 0xfd,
+	0xb4, 0x4d, 0x5b, 0xd1, 0x40, 0xb6, 0xb2, 0xd2, 0x23, 0x99, 0x35, 0x84, 0x71, 0x33, 0x14, 0xaa,
+	0x6d, 0xf9, 0x23, 0xff, 0xb3, 0x36, 0xee, 0xd6, 0xa8, 0x4f, 0x2e, 0xe1, 0x45, 0x9a, 0x76, 0x30,
+	0x31, 0x5a, 0xf1, 0x76, 0xa7, 0x60, 0x28, 0xb1, 0x79, 0x90, 0xfe, 0x22, 0x62, 0xe8, 0x1c, 0xae,
+	0x57, 0x9f, 0x6b, 0x19, 0x3e, 0x20, 0x48, 0xad, 0x59, 0xe0, 0x71, 0xad, 0x0b, 0x48, 0x20, 0xa4,
+	0x3a, 0xba, 0x9b, 0xe9, 0x98, 0xd1, 0x5d, 0x8b, 0x10, 0xbf, 0xc4, 0x6d, 0x37, 0xbd, 0x2c, 0x52,
+	0x8c, 0x38, 0x2e, 0x3e, 0x3c, 0x5c, 0x44, 0x1d, 0x1d, 0x2f, 0x86, 0xbd, 0xd4, 0x29, 0xf3, 0xb6,
+	0x2f, 0xb6, 0x2a, 0x35, 0x3c, 0xf6, 0x45, 0xf2, 0x28, 0x5c, 0xea, 0xfa, 0x93, 0xc9, 0xaf, 0x2a,
+	0x75, 0xff, 0x9b, 0x9d, 0xb6, 0xf3, 0xcb, 0x00, 0xa6, 0x49, 0x1e, 0xa6, 0xbd, 0xce, 0x17, 0x2e,
+	0x68, 0x18, 0x6b, 0x2f, 0x25, 0x52, 0x62, 0x7a, 0x32, 0x6c, 0x9b, 0x38, 0x73, 0x88, 0xb0, 0x57,
+	0x34, 0x11, 0x46, 0x3f, 0x4b, 0xcf, 0x2b, 0x4d, 0x55, 0x3b, 0x3f, 0x68, 0x89, 0xd5, 0x59, 0x98,
+	0x73, 0xdd, 0x08, 0x10, 0xde, 0x2b, 0x8c, 0xb9, 0x3b, 0x91, 0xb3, 0xbc, 0xaf, 0xf8, 0x78, 0xff,
+	0x73, 0xd8, 0x49, 0x4d, 0xd8, 0xff, 0x3f, 0x36, 0x35, 0xdf, 0x00, 0x9b, 0x50, 0x51, 0xe4, 0x27,
+	0xa1, 0x99, 0xbc, 0x20, 0xc7, 0x7f, 0xdb, 0xa6, 0xc3, 0x5f, 0xbf, 0xae, 0xf9, 0x52, 0x2c, 0x61,
+	0x36, 0xf6, 0x32, 0xa1, 0x5c, 0x96, 0xe0, 0xd1, 0x98, 0x8f, 0xe6, 0xb1, 0xeb, 0xa3, 0xa1, 0x04,
+	0x66, 0xde, 0x3d, 0x6a, 0x14, 0x37, 0x9c, 0x24, 0xca, 0x02, 0x1e, 0xd3, 0xd2, 0x43, 0x10, 0xe7,
+	0x89, 0xc5, 0xf6, 0x0e, 0x53, 0x65, 0x01, 0x1a, 0xaa, 0x04, 0x1c, 0x50, 0xe1, 0x2c, 0xc0, 0x29,
+	0x78, 0x5b, 0xea, 0x44, 0x1b, 0x8d, 0x3f, 0x3f, 0x8d, 0x71, 0x63, 0x11, 0xc1, 0x00, 0x00, 0x00,
+	0x1d, 0x49, 0x44, 0x41, 0x54, 0x78, 0xda, 0x01, 0x30, 0x00, 0xcf, 0xff, 0x04, 0x61, 0x26, 0x7a,
+	0xc3, 0xde, 0x20, 0x94, 0xe5, 0x36, 0x32, 0xc2, 0x01, 0x02, 0xd9, 0x88, 0x1e, 0x22, 0x8c, 0xc9,
+	0xc7, 0x6d, 0x5e, 0x94, 0x66, 0x0e, 0x00, 0x00, 0x00, 0x1e, 0x49, 0x44, 0x41, 0x54, 0x12, 0x24,
+	0x03, 0x3d, 0x9a, 0xcf, 0xd4, 0xce, 0x0f, 0xed, 0xe6, 0x75, 0x10, 0x5f, 0x01, 0xdf, 0x87, 0xef,
+	0x40, 0xc0, 0xf0, 0x51, 0xa0, 0x29, 0xf3, 0xae, 0x01, 0xa6, 0x16, 0xdf, 0x5d, 0x9f, 0x56, 0x0d,
+	0x00, 0x00, 0x00, 0x00, 0x49, 0x45, 0x4e, 0x44, 0xae, 0x42, 0x60, 0x82,
+};
+static const uint32_t s_png_palette8_pixels[] = {
+	0xffc64b00, 0xff841c79, 0xff0802eb, 0xff5c441d, 0xff4bbab2, 0xff528c38, 0xff661af6, 0xff7eae98,
+	0xff130886, 0xff110218, 0xff2a43d7, 0xff677770, 0xff3f6889, 0xffcdd90f, 0xff509146, 0xff110218,
+	0xff6f8dd4, 0xffc5f60e, 0xff5d8b10, 0xff5c02a4, 0xff5a9d4b, 0xffe18c99, 0xff5a9d4b, 0xffc8ac7d,
+	0xff912645, 0xff93eb48, 0xffef1dd7, 0xffd5bf28, 0xff841c79, 0xff11ab2f, 0xffcb00a6, 0xffb08a00,
+	0xff3f6889, 0xff8cb93b, 0xfff88528, 0xff79e2af, 0xff46fae9, 0xff79e2af, 0xff6d1c01, 0xffb08a00,
+	0xffaf3b4d, 0xffff67f6, 0xffa43228, 0xff230139,
+};
+
+static const uint8_t s_png_palette4_trns[] = {
+	0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a, 0x00, 0x00, 0x00, 0x0d, 0x49, 0x48, 0x44, 0x52,
+	0x00, 0x00, 0x00, 0x0a, 0x00, 0x00, 0x00, 0x06, 0x04, 0x03, 0x00, 0x00, 0x00, 0x08, 0xde, 0x12,
+	0xf5, 0x00, 0x00, 0x00, 0x30, 0x50, 0x4c, 0x54, 0x45, 0x97, 0x73, 0x70, 0x7c, 0x04, 0xb4, 0xb1,
+	0x35, 0x46, 0x1a, 0xe4, 0xbe, 0xfc, 0xb5, 0xcb, 0x28, 0xfe, 0x6f, 0xd6, 0xba, 0xa0, 0xf9, 0x1a,
+	0x84, 0x15, 0x14, 0x70, 0x29, 0xd0, 0x4a, 0xc7, 0x62, 0xfa, 0x92, 0xcd, 0x77, 0x46, 0x71, 0x4d,
+	0xea, 0x50, 0x7e, 0xd0, 0xae, 0xe2, 0xa4, 0xac, 0xec, 0x02, 0xe4, 0xd4, 0xc6, 0x00, 0x00, 0x00,
+	0x09, 0x74, 0x52, 0x4e, 0x53, 0xc3, 0xb5, 0xc6, 0x6c, 0x2c, 0x90, 0xd2, 0x66, 0xe6, 0xf1, 0x71,
+	0x50, 0xec, 0x00, 0x00, 0x00, 0x16, 0x49, 0x44, 0x41, 0x54, 0x78, 0xda, 0x63, 0xcc, 0xb6, 0xee,
+	0xaa, 0x98, 0xc4, 0xfc, 0xc0, 0xec, 0xfb, 0x3c, 0x03, 0x46, 0xd6, 0xfc, 0x1b, 0x57, 0x52, 0x59,
+	0x20, 0xf3, 0x18, 0xac, 0x00, 0x00, 0x00, 0x17, 0x49, 0x44, 0x41, 0x54, 0xce, 0x5c, 0xd5, 0xdb,
+	0xe9, 0xce, 0x2c, 0xf6, 0x49, 0xb6, 0xc5, 0x96, 0x85, 0x59, 0xaf, 0xa1, 0xa8, 0x1c, 0x00, 0x0c,
+	0x30, 0x0d, 0xfa, 0x03, 0xd6, 0xe2, 0xe2, 0x00, 0x00, 0x00, 0x00, 0x49, 0x45, 0x4e, 0x44, 0xae,
+	0x42, 0x60, 0x82,
+};
+static const uint32_t s_png_palette4_trns_pixels[] = {
+	0xd2d6baa0, 0xff92cd77, 0xffc762fa, 0xd2d6baa0, 0x6c1ae4be, 0xc3977370, 0xffc762fa, 0xe6151470,
+	0x6c1ae4be, 0xffc762fa, 0xb57c04b4, 0x9028fe6f, 0xff29d04a, 0x6c1ae4be, 0x9028fe6f, 0xe6151470,
+	0xb57c04b4, 0xffd0aee2, 0x9028fe6f, 0xff46714d, 0xc3977370, 0x9028fe6f, 0x66f91a84, 0x2cfcb5cb,
+	0x2cfcb5cb, 0xff46714d, 0xc6b13546, 0xc3977370, 0xe6151470, 0x9028fe6f, 0xffea507e, 0xb57c04b4,
+	0xffc762fa, 0xd2d6baa0, 0xffc762fa, 0xc6b13546, 0xc3977370, 0x9028fe6f, 0xff46714d, 0xff46714d,
+	0x66f91a84, 0xffd0aee2, 0xe6151470, 0x2cfcb5cb, 0xff92cd77, 0xc3977370, 0xffea507e, 0xffd0aee2,
+	0xb57c04b4, 0xc6b13546, 0xe6151470, 0xb57c04b4, 0xff92cd77, 0xc6b13546, 0x6c1ae4be, 0xc6b13546,
+	0xffc762fa, 0x2cfcb5cb, 0xe6151470, 0xff29d04a,
+};
+
+static const uint8_t s_bmp_1[] = {
+	0x42, 0x4d, 0x4e, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x3e, 0x00, 0x00, 0x00, 0x28, 0x00,
+	0x00, 0x00, 0x13, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x01, 0x00, 0x01, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x60, 0xac, 0x39, 0x00, 0x7b, 0xfa, 0x81, 0x00, 0x63, 0xe6,
+	0x80, 0x00, 0xd3, 0x6e, 0xe0, 0x00, 0x7a, 0xc5, 0x60, 0x00, 0x25, 0x1e, 0xc0, 0x00,
+};
+static const uint32_t s_bmp_1_pixels[] = {
+	0xff39ac60, 0xff39ac60, 0xff81fa7b, 0xff39ac60, 0xff39ac60, 0xff81fa7b, 0xff39ac60, 0xff81fa7b,
+	0xff39ac60, 0xff39ac60, 0xff39ac60, 0xff81fa7b, 0xff81fa7b, 0xff81fa7b, 0xff81fa7b, 0xff39ac60,
+	0xff81fa7b, 0xff81fa7b, 0xff39ac60, 0xff39ac60, 0xff81fa7b, 0xff81fa7b, 0xff81fa7b, 0xff81fa7b,
+	0xff39ac60, 0xff81fa7b, 0xff39ac60, 0xff81fa7b, 0xff81fa7b, 0xff39ac60, 0xff39ac60, 0xff39ac60,
+	0xff81fa7b, 0xff39ac60, 0xff81fa7b, 0xff39ac60, 0xff81fa7b, 0xff81fa7b, 0xff81fa7b, 0xff81fa7b,
+	0xff39ac60, 0xff81fa7b, 0xff39ac60, 0xff39ac60, 0xff81fa7b, 0xff81fa7b, 0xff39ac60, 0xff81fa7b,
+	0xff81fa7b, 0xff39ac60, 0xff81fa7b, 0xff81fa7b, 0xff81fa7b, 0xff39ac60, 0xff81fa7b, 0xff81fa7b,
+	0xff81fa7b, 0xff39ac60, 0xff81fa7b, 0xff81fa7b, 0xff39ac60, 0xff39ac60, 0xff39ac60, 0xff81fa7b,
+	0xff81fa7b, 0xff81fa7b, 0xff81fa7b, 0xff81fa7b, 0xff39ac60, 0xff39ac60, 0xff81fa7b, 0xff81fa7b,
+	0xff39ac60, 0xff81fa7b, 0xff39ac60, 0xff39ac60,
+};
+
+static const uint8_t s_bmp_4[] = {
+	0x42, 0x4d, 0x8a, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x62, 0x00, 0x00, 0x00, 0x28, 0x00,
+	0x00, 0x00, 0x09, 0x00, 0x00, 0x00, 0x05, 0x00, 0x00, 0x00, 0x01, 0x00, 0x04, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x28, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0b, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1f, 0x65, 0xa1, 0x00, 0x73, 0x81, 0xb2, 0x00, 0x1b, 0xa7,
+	0xf4, 0x00, 0x30, 0x6e, 0x51, 0x00, 0x51, 0x01, 0xcb, 0x00, 0x25, 0xe4, 0x67, 0x00, 0x91, 0xd0,
+	0x7b, 0x00, 0x34, 0x10, 0xe7, 0x00, 0x13, 0x5e, 0xfe, 0x00, 0xda, 0xcd, 0x68, 0x00, 0xb5, 0x97,
+	0xb6, 0x00, 0x86, 0xa0, 0x8a, 0x83, 0x60, 0x00, 0x00, 0x00, 0x86, 0x62, 0x52, 0xa0, 0xa0, 0x00,
+	0x00, 0x00, 0x26, 0x73, 0x05, 0x08, 0x00, 0x00, 0x00, 0x00, 0x87, 0x25, 0x08, 0x01, 0x50, 0x00,
+	0x00, 0x00, 0x89, 0x03, 0x19, 0x67, 0x10, 0x00, 0x00, 0x00,
+};
+static const uint32_t s_bmp_4_pixels[] = {
+	0xfffe5e13, 0xff68cdda, 0xffa1651f, 0xff516e30, 0xffb28173, 0xff68cdda, 0xff7bd091, 0xffe71034,
+	0xffb28173, 0xfffe5e13, 0xffe71034, 0xfff4a71b, 0xff67e425, 0xffa1651f, 0xfffe5e13, 0xffa1651f,
+	0xffb28173, 0xff67e425, 0xfff4a71b, 0xff7bd091, 0xffe71034, 0xff516e30, 0xffa1651f, 0xff67e425,
+	0xffa1651f, 0xfffe5e13, 0xffa1651f, 0xfffe5e13, 0xff7bd091, 0xff7bd091, 0xfff4a71b, 0xff67e425,
+	0xfff4a71b, 0xffb697b5, 0xffa1651f, 0xffb697b5, 0xfffe5e13, 0xff7bd091, 0xffb697b5, 0xffa1651f,
+	0xfffe5e13, 0xffb697b5, 0xfffe5e13, 0xff516e30, 0xff7bd091,
+};
+
+static const uint8_t s_bmp_8[] = {
+	0x42, 0x4d, 0x4e, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x36, 0x04, 0x00, 0x00, 0x28, 0x00,
+	0x00, 0x00, 0x07, 0x00, 0x00, 0x00, 0xfd, 0xff, 0xff, 0xff, 0x01, 0x00, 0x08, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x18, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x71, 0xb0, 0xfe, 0x00, 0x77, 0xbc, 0xbb, 0x00, 0x88, 0xd5,
+	0xc0, 0x00, 0xab, 0x39, 0x42, 0x00, 0xbc, 0xa5, 0xba, 0x00, 0x16, 0x5a, 0xa7, 0x00, 0x3f, 0x31,
+	0xf9, 0x00, 0xe2, 0xba, 0x82, 0x00, 0x2e, 0x99, 0x19, 0x00, 0x41, 0xaa, 0xa9, 0x00, 0x85, 0x82,
+	0xf6, 0x00, 0xdc, 0x6b, 0xe1, 0x00, 0x19, 0xc7, 0x10, 0x00, 0xda, 0x41, 0x52, 0x00, 0x90, 0xc5,
+	0x7f, 0x00, 0x26, 0xe9, 0x50, 0x00, 0x19, 0xf9, 0x41, 0x00, 0xc0, 0xc8, 0x6d, 0x00, 0x91, 0xbf,
+	0xfa, 0x00, 0x90, 0xe5, 0x7b, 0x00, 0x21, 0x7f, 0x47, 0x00, 0xfe, 0x01, 0x14, 0x00, 0x3d, 0x9e,
+	0x2e, 0x00, 0xdf, 0xce, 0x6c, 0x00, 0x3f, 0xe9, 0x68, 0x00, 0x3c, 0x8d, 0x24, 0x00, 0x08, 0xf7,
+	0x27, 0x00, 0x8d, 0xa3, 0xa2, 0x00, 0x1e, 0xf6, 0xf8, 0x00, 0x95, 0xc0, 0x1e, 0x00, 0x24, 0x7b,
+	0xab, 0x00, 0x8a, 0xb3, 0x92, 0x00, 0xf2, 0xb1, 0x68, 0x00, 0xd6, 0xbb, 0xb6, 0x00, 0x43, 0x7b,
+	0xd9, 0x00, 0xeb, 0x61, 0x4b, 0x00, 0xd2, 0x5f, 0xbb, 0x00, 0x72, 0x88, 0x75, 0x00, 0x56, 0xb3,
+	0xef, 0x00, 0xdd, 0xf2, 0x1f, 0x00, 0x68, 0x28, 0x70, 0x00, 0x87, 0x08, 0xa3, 0x00, 0xcf, 0x30,
+	0x9b, 0x00, 0xcb, 0x5f, 0xb3, 0x00, 0xef, 0x59, 0x6b, 0x00, 0xc7, 0x6f, 0x1c, 0x00, 0xa1, 0x30,
+	0x1b, 0x00, 0x1d, 0x40, 0x99, 0x00, 0xdd, 0xe0, 0x00, 0x00, 0x50, 0xfb, 0xca, 0x00, 0x74, 0x3f,
+	0x18, 0x00, 0x4c, 0x06, 0x36, 0x00, 0xe1, 0xf3, 0x6d, 0x00, 0x76, 0x0e, 0x52, 0x00, 0xa9, 0xa4,
+	0x2d, 0x00, 0x14, 0x63, 0xc9, 0x00, 0x78, 0xd8, 0xeb, 0x00, 0xcc, 0x86, 0xb5, 0x00, 0xcd, 0xed,
+	0xdd, 0x00, 0x51, 0x9c, 0x54, 0x00, 0x9d, 0x93, 0xdf, 0x00, 0x1b, 0x2a, 0x89, 0x00, 0x0f, 0xb2,
+	0x09, 0x00, 0xf2, 0xeb, 0x97, 0x00, 0x4b, 0x13, 0x0b, 0x00, 0x38, 0x48, 0xac, 0x00, 0x18, 0x4d,
+	0xa6, 0x00, 0x91, 0x5b, 0xbc, 0x00, 0x83, 0x3f, 0xec, 0x00, 0x65, 0xaa, 0x71, 0x00, 0xfd, 0x25,
+	0x57, 0x00, 0x13, 0x65, 0x72, 0x00, 0x71, 0x75, 0xfd, 0x00, 0xe8, 0x8b, 0xc4, 0x00, 0x7a, 0x75,
+	0xdd, 0x00, 0xdc, 0xd9, 0xe0, 0x00, 0xfb, 0xfa, 0x3c, 0x00, 0x1a, 0x35, 0xba, 0x00, 0x00, 0xbe,
+	0x39, 0x00, 0x45, 0x9d, 0x7a, 0x00, 0xd0, 0x54, 0x77, 0x00, 0x87, 0x5a, 0xd9, 0x00, 0xc5, 0x1e,
+	0xdc, 0x00, 0x92, 0xa4, 0x40, 0x00, 0xc0, 0x71, 0x61, 0x00, 0x53, 0x4d, 0x3f, 0x00, 0x56, 0x85,
+	0xb1, 0x00, 0x03, 0xf6, 0x12, 0x00, 0x4b, 0x61, 0xa4, 0x00, 0x67, 0x6e, 0x7e, 0x00, 0xe4, 0x23,
+	0xdb, 0x00, 0x4f, 0xe5, 0x74, 0x00, 0x5a, 0x7a, 0xc1, 0x00, 0x96, 0xdb, 0x6d, 0x00, 0x65, 0xf2,
+	0x3f, 0x00, 0x74, 0x79, 0xf5, 0x00, 0x68, 0xd2, 0x11, 0x00, 0x17, 0x44, 0xee, 0x00, 0x1d, 0x6f,
+	0x05, 0x00, 0x7d, 0x48, 0x50, 0x00, 0xfa, 0xbe, 0x25, 0x00, 0xdb, 0x48, 0x1a, 0x00, 0x3c, 0xea,
+	0x3e, 0x00, 0x77, 0x63, 0x39, 0x00, 0xf6, 0xd2, 0x8b, 0x00, 0x9d, 0x23, 0x92, 0x00, 0x11, 0xf4,
+	0x3e, 0x00, 0x5c, 0x9d, 0x69, 0x00, 0x59, 0x9c, 0xcb, 0x00, 0xf6, 0x98, 0x20, 0x00, 0x4f, 0xfa,
+	0xf6, 0x00, 0x5d, 0x2e, 0x42, 0x00, 0xbf, 0xb6, 0x15, 0x00, 0x79, 0x23, 0xaf, 0x00, 0xe8, 0xca,
+	0x97, 0x00, 0x7c, 0x56, 0x37, 0x00, 0xbb, 0x33, 0xce, 0x00, 0xf2, 0x7d, 0x4d, 0x00, 0x8b, 0x85,
+	0x76, 0x00, 0xe2, 0xe6, 0xe4, 0x00, 0xca, 0xee, 0xb8, 0x00, 0x42, 0x99, 0x91, 0x00, 0x0a, 0xb0,
+	0xa6, 0x00, 0xad, 0x71, 0x76, 0x00, 0x8f, 0x09, 0x27, 0x00, 0x56, 0xf7, 0x4f, 0x00, 0xbc, 0x3c,
+	0x7a, 0x00, 0x25, 0xba, 0x96, 0x00, 0xd8, 0x06, 0xaa, 0x00, 0xda, 0x96, 0x16, 0x00, 0x7f, 0x4b,
+	0xec, 0x00, 0x02, 0xd8, 0x6f, 0x00, 0x33, 0x37, 0x5c, 0x00, 0xd0, 0x52, 0xea, 0x00, 0x0e, 0xfb,
+	0x79, 0x00, 0xf7, 0x29, 0x12, 0x00, 0x3f, 0xd8, 0x96, 0x00, 0x24, 0xcc, 0x89, 0x00, 0x7d, 0x65,
+	0x72, 0x00, 0x5f, 0xa6, 0xb6, 0x00, 0x69, 0x17, 0xb4, 0x00, 0x3b, 0x84, 0xa2, 0x00, 0x51, 0x4e,
+	0x4d, 0x00, 0xba, 0xcc, 0x61, 0x00, 0x92, 0xb6, 0x40, 0x00, 0x3f, 0x37, 0x81, 0x00, 0x55, 0x64,
+	0xba, 0x00, 0xff, 0x7a, 0xed, 0x00, 0x14, 0x16, 0xbc, 0x00, 0x07, 0x8a, 0xef, 0x00, 0xc6, 0x75,
+	0x32, 0x00, 0x80, 0x3c, 0xac, 0x00, 0x63, 0xe3, 0x6f, 0x00, 0x20, 0x2e, 0xd7, 0x00, 0x41, 0xde,
+	0xa6, 0x00, 0x80, 0x63, 0xd0, 0x00, 0xf0, 0xe7, 0x93, 0x00, 0x4f, 0x8d, 0x3f, 0x00, 0xe6, 0xee,
+	0x5b, 0x00, 0x2a, 0xf6, 0xf3, 0x00, 0xd7, 0x42, 0x89, 0x00, 0x85, 0xa4, 0x71, 0x00, 0xbd, 0x99,
+	0x4f, 0x00, 0xb4, 0x4b, 0xbe, 0x00, 0xaa, 0x9b, 0x36, 0x00, 0xde, 0xce, 0xc6, 0x00, 0x3e, 0x0f,
+	0x5f, 0x00, 0x6a, 0xea, 0x64, 0x00, 0x0c, 0x92, 0x47, 0x00, 0x48, 0x4d, 0x90, 0x00, 0x6f, 0x58,
+	0x88, 0x00, 0x6d, 0xbe, 0x24, 0x00, 0x22, 0x98, 0x37, 0x00, 0x24, 0x55, 0x45, 0x00, 0x90, 0xe0,
+	0xf9, 0x00, 0x80, 0x96, 0xba, 0x00, 0x98, 0x91, 0xd1, 0x00, 0x54, 0x49, 0x9c, 0x00, 0x72, 0x7b,
+	0xac, 0x00, 0xb3, 0x72, 0xb7, 0x00, 0x3c, 0x6f, 0x2d, 0x00, 0xca, 0xe6, 0xca, 0x00, 0x50, 0x8e,
+	0xa7, 0x00, 0x27, 0xb1, 0x9a, 0x00, 0xe5, 0x47, 0xe3, 0x00, 0xf6, 0xd6, 0x3b, 0x00, 0x90, 0xfc,
+	0x46, 0x00, 0x48, 0xfe, 0x4a, 0x00, 0x96, 0x72, 0xc5, 0x00, 0x5b, 0xec, 0xda, 0x00, 0x08, 0x89,
+	0xc4, 0x00, 0xa5, 0x56, 0x3d, 0x00, 0xb2, 0x12, 0x30, 0x00, 0x5d, 0xac, 0x20, 0x00, 0x88, 0x25,
+	0xea, 0x00, 0xe5, 0x2a, 0x0b, 0x00, 0x42, 0x15, 0x3c, 0x00, 0xd8, 0x42, 0x39, 0x00, 0x4e, 0x50,
+	0xd7, 0x00, 0xfb, 0x2d, 0xaa, 0x00, 0x70, 0x69, 0xc1, 0x00, 0x71, 0xd4, 0x03, 0x00, 0xa0, 0x2a,
+	0x4e, 0x00, 0x67, 0x71, 0x24, 0x00, 0x85, 0xf8, 0x67, 0x00, 0x96, 0x8f, 0x45, 0x00, 0xc9, 0x16,
+	0xd8, 0x00, 0x36, 0x31, 0x8d, 0x00, 0xeb, 0xdf, 0x29, 0x00, 0xa4, 0x8e, 0x21, 0x00, 0x4b, 0x72,
+	0x1d, 0x00, 0xca, 0x9f, 0x34, 0x00, 0x3c, 0x13, 0x41, 0x00, 0x66, 0xd6, 0xd3, 0x00, 0x79, 0x59,
+	0x56, 0x00, 0x91, 0x52, 0xca, 0x00, 0x86, 0xe2, 0xce, 0x00, 0x5c, 0x13, 0xcc, 0x00, 0xb6, 0x87,
+	0xdc, 0x00, 0xb2, 0x49, 0x3a, 0x00, 0xc1, 0x02, 0xd8, 0x00, 0x45, 0x83, 0x53, 0x00, 0x39, 0x0c,
+	0x71, 0x00, 0x97, 0x8c, 0x7f, 0x00, 0xec, 0xaa, 0xda, 0x00, 0x86, 0xa2, 0x7a, 0x00, 0x8e, 0x24,
+	0x7f, 0x00, 0xf9, 0x41, 0xaf, 0x00, 0x74, 0x36, 0x22, 0x00, 0x9a, 0x36, 0x8c, 0x00, 0xca, 0x8f,
+	0xfa, 0x00, 0x95, 0xb6, 0x58, 0x00, 0xb0, 0x7d, 0x75, 0x00, 0x81, 0x2c, 0xcc, 0x00, 0xb7, 0xeb,
+	0x9b, 0x00, 0xba, 0xeb, 0x4c, 0x00, 0x1c, 0x95, 0x73, 0x00, 0x95, 0xf5, 0xb3, 0x00, 0x3c, 0x0d,
+	0xee, 0x00, 0xed, 0x73, 0xa0, 0x00, 0xdd, 0x0e, 0x80, 0x00, 0x1b, 0xba, 0xa4, 0x00, 0xd8, 0xf8,
+	0x28, 0x00, 0x44, 0xed, 0x5a, 0x00, 0x27, 0xaa, 0x79, 0x00, 0xff, 0x8d, 0x49, 0x00, 0x90, 0x39,
+	0x21, 0x00, 0xeb, 0xdf, 0x6c, 0x00, 0xa1, 0xf5, 0xac, 0x00, 0xe7, 0x2a, 0xb6, 0x00, 0xf4, 0x8d,
+	0xae, 0x00, 0xae, 0x99, 0x0a, 0x00, 0xa0, 0x30, 0xa3, 0x00, 0x3d, 0xd0, 0x0c, 0x00, 0x05, 0xeb,
+	0xe0, 0x00, 0x52, 0x79, 0x15, 0x00, 0x51, 0xf5, 0xf1, 0xc7, 0xe5, 0x00, 0xeb, 0x00, 0xd9, 0x28,
+	0x54, 0x59, 0xef, 0x97, 0x44, 0x00, 0x57, 0x84, 0x02, 0x25, 0x8b, 0xd0, 0xe2, 0x00,
+};
+static const uint32_t s_bmp_8_pixels[] = {
+	0xffd95a87, 0xff498dff, 0xffa4ba1b, 0xffaa2dfb, 0xff8c369a, 0xfffeb071, 0xff4cebba, 0xffcc135c,
+	0xff702868, 0xff6171c0, 0xff7e6e67, 0xffa073ed, 0xffac3c80, 0xffec3f83, 0xff12f603, 0xff5c3733,
+	0xffc0d588, 0xff758872, 0xffb6a65f, 0xff29dfeb, 0xff7f248e,
+};
+
+static const uint8_t s_bmp_24[] = {
+	0x42, 0x4d, 0x96, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x36, 0x00, 0x00, 0x00, 0x28, 0x00,
+	0x00, 0x00, 0x05, 0x00, 0x00, 0x00, 0x06, 0x00, 0x00, 0x00, 0x01, 0x00, 0x18, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x60, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x7f, 0xd7, 0x56, 0xa1, 0xc5, 0x1d, 0x1b, 0xbb, 0x47, 0x1b,
+	0x84, 0xe6, 0x0f, 0x97, 0xbc, 0x00, 0x17, 0xd5, 0xc7, 0x8b, 0x12, 0x2d, 0x27, 0xdf, 0x53, 0x7d,
+	0xa5, 0x09, 0xf2, 0x89, 0x1c, 0x00, 0x47, 0x97, 0x1c, 0x82, 0xc3, 0xf0, 0xe4, 0x52, 0x1f, 0xcb,
+	0x73, 0xf1, 0x86, 0xd6, 0xba, 0x00, 0x81, 0x44, 0x3d, 0xcb, 0x3b, 0xaa, 0x58, 0x6e, 0xb2, 0xf3,
+	0xf8, 0x18, 0x3e, 0x0c, 0x4b, 0x00, 0xb1, 0xae, 0xff, 0x08, 0xc0, 0x6c, 0xeb, 0x6e, 0x54, 0xb3,
+	0x7b, 0x81, 0x23, 0x96, 0x73, 0x00, 0x9d, 0x63, 0xe5, 0x47, 0x9a, 0x71, 0x03, 0x4f, 0xaf, 0xe0,
+	0x29, 0x48, 0xfa, 0xf7, 0x9b, 0x00,
+};
+static const uint32_t s_bmp_24_pixels[] = {
+	0xffe5639d, 0xff719a47, 0xffaf4f03, 0xff4829e0, 0xff9bf7fa, 0xffffaeb1, 0xff6cc008, 0xff546eeb,
+	0xff817bb3, 0xff739623, 0xff3d4481, 0xffaa3bcb, 0xffb26e58, 0xff18f8f3, 0xff4b0c3e, 0xff1c9747,
+	0xfff0c382, 0xff1f52e4, 0xfff173cb, 0xffbad686, 0xffc7d517, 0xff2d128b, 0xff53df27, 0xff09a57d,
+	0xff1c89f2, 0xff56d77f, 0xff1dc5a1, 0xff47bb1b, 0xffe6841b, 0xffbc970f,
+};
+
+static const uint8_t s_bmp_16[] = {
+	0x42, 0x4d, 0x66, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x36, 0x00, 0x00, 0x00, 0x28, 0x00,
+	0x00, 0x00, 0x06, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x01, 0x00, 0x10, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x30, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xa2, 0xdc, 0x25, 0x78, 0xb0, 0x5f, 0x48, 0xda, 0x52, 0xf7,
+	0x26, 0x8e, 0xc3, 0x58, 0xff, 0xca, 0x7c, 0x80, 0xcc, 0xda, 0xca, 0x7a, 0x82, 0x54, 0x9e, 0xd6,
+	0x8f, 0x02, 0x07, 0xd6, 0xda, 0x88, 0x73, 0x98, 0x83, 0x45, 0x31, 0x00, 0xf4, 0x0a, 0x88, 0x82,
+	0xe6, 0x7a, 0x63, 0x9e, 0xb7, 0xe8,
+};
+static const uint32_t s_bmp_16_pixels[] = {
+	0xff00088c, 0xff10bda5, 0xff00a542, 0xfff7bd31, 0xff3a9c19, 0xffd629bd, 0xffada5f7, 0xff00a57b,
+	0xffad843a, 0xff1031d6, 0xff31199c, 0xff8c6319, 0xffb53119, 0xff94bdff, 0xff0019e6, 0xffb5b563,
+	0xfff7b552, 0xffad2110, 0xffbd2910, 0xfff70829, 0xffbdef84, 0xffb59442, 0xffefd694, 0xff198c31,
+};
+
+static const uint8_t s_bmp_16_565[] = {
+	0x42, 0x4d, 0x72, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x42, 0x00, 0x00, 0x00, 0x28, 0x00,
+	0x00, 0x00, 0x06, 0x00, 0x00, 0x00, 0xfc, 0xff, 0xff, 0xff, 0x01, 0x00, 0x10, 0x00, 0x03, 0x00,
+	0x00, 0x00, 0x30, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xf8, 0x00, 0x00, 0xe0, 0x07, 0x00, 0x00, 0x1f, 0x00,
+	0x00, 0x00, 0x37, 0x23, 0x99, 0x4d, 0x6e, 0xd4, 0xb0, 0x82, 0xe9, 0x5d, 0x7e, 0xe8, 0x84, 0x15,
+	0x18, 0x19, 0x86, 0x2d, 0x90, 0xcc, 0x88, 0xd4, 0xe8, 0x16, 0xc1, 0xb0, 0x67, 0x6a, 0x9a, 0x72,
+	0x64, 0x85, 0x94, 0x1c, 0x3a, 0xbc, 0x74, 0xda, 0xd5, 0x51, 0x75, 0x2c, 0xb1, 0xfb, 0xa5, 0xfc,
+	0xcb, 0x20,
+};
+static const uint32_t s_bmp_16_565_pixels[] = {
+	0xff2165bd, 0xff4ab2ce, 0xffd68e73, 0xff845584, 0xff5abe4a, 0xffef0cf7, 0xff10b221, 0xff1920c5,
+	0xff29b231, 0xffce9284, 0xffd69242, 0xff10df42, 0xffb51808, 0xff6b4d3a, 0xff7351d6, 0xff84ae21,
+	0xff1992a5, 0xffbd86d6, 0xffde4da5, 0xff5239ad, 0xff298ead, 0xffff758c, 0xffff9629, 0xff21185a,
+};
+
+static const uint8_t s_bmp_32[] = {
+	0x42, 0x4d, 0x72, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x36, 0x00, 0x00, 0x00, 0x28, 0x00,
+	0x00, 0x00, 0x05, 0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00, 0x01, 0x00, 0x20, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x3c, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x3c, 0xcb, 0xf3, 0x88, 0x1f, 0x08, 0x47, 0x07, 0x85, 0x08,
+	0x69, 0x10, 0x6f, 0x4c, 0xf3, 0xa9, 0xdb, 0x7c, 0x08, 0xfd, 0x66, 0x6e, 0xca, 0xa7, 0x7e, 0x36,
+	0x06, 0xdd, 0xb7, 0x13, 0xf2, 0xfe, 0xea, 0x42, 0xaa, 0xfe, 0x08, 0xc7, 0x1a, 0xb5, 0xdb, 0x3c,
+	0x25, 0x4d, 0x0d, 0xfb, 0xe9, 0x4a, 0x86, 0xf3, 0xfe, 0x97, 0x8e, 0x55, 0x34, 0xb3, 0x05, 0x03,
+	0x9a, 0x5d,
+};
+static const uint32_t s_bmp_32_pixels[] = {
+	0x4d253cdb, 0x4ae9fb0d, 0x97fef386, 0xb334558e, 0x5d9a0305, 0xa7ca6e66, 0xdd06367e, 0xfef213b7,
+	0xfeaa42ea, 0xb51ac708, 0x88f3cb3c, 0x0747081f, 0x10690885, 0xa9f34c6f, 0xfd087cdb,
+};
+
+static const uint8_t s_bmp_32_noalpha[] = {
+	0x42, 0x4d, 0x72, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x36, 0x00, 0x00, 0x00, 0x28, 0x00,
+	0x00, 0x00, 0x05, 0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00, 0x01, 0x00, 0x20, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x3c, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xdd, 0x50, 0x41, 0x00, 0x79, 0x79, 0x9b, 0x00, 0x75, 0x7a,
+	0xb8, 0x00, 0x73, 0xf1, 0x91, 0x00, 0x47, 0x31, 0x94, 0x00, 0x51, 0x15, 0x66, 0x00, 0xee, 0x4b,
+	0x7e, 0x00, 0x4c, 0x11, 0xbc, 0x00, 0x4f, 0xe9, 0x4b, 0x00, 0x2a, 0x81, 0x6d, 0x00, 0x5c, 0x8e,
+	0x52, 0x00, 0x5c, 0xf9, 0xc0, 0x00, 0xfa, 0x26, 0x3e, 0x00, 0x38, 0x00, 0xde, 0x00, 0x26, 0xe7,
+	0xd9, 0x00,
+};
+static const uint32_t s_bmp_32_noalpha_pixels[] = {
+	0xff528e5c, 0xffc0f95c, 0xff3e26fa, 0xffde0038, 0xffd9e726, 0xff661551, 0xff7e4bee, 0xffbc114c,
+	0xff4be94f, 0xff6d812a, 0xff4150dd, 0xff9b7979, 0xffb87a75, 0xff91f173, 0xff943147,
+};
+
+static const uint8_t s_bmp_32_bitfields[] = {
+	0x42, 0x4d, 0x82, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x42, 0x00, 0x00, 0x00, 0x28, 0x00,
+	0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x01, 0x00, 0x20, 0x00, 0x03, 0x00,
+	0x00, 0x00, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0x00, 0x00, 0x00, 0x00, 0xff, 0x00, 0x00, 0x00,
+	0x00, 0xff, 0x2a, 0x89, 0xe4, 0x92, 0x00, 0x22, 0x93, 0x04, 0x38, 0xb1, 0xe4, 0x13, 0xcb, 0x3d,
+	0x97, 0x6f, 0x56, 0xdd, 0x7a, 0xee, 0x9c, 0x52, 0x83, 0xe0, 0xa2, 0x1e, 0xe6, 0xa1, 0x5f, 0x3b,
+	0xb5, 0x93, 0xb1, 0x24, 0x58, 0xc9, 0x7f, 0x56, 0xbc, 0x64, 0x14, 0x81, 0xbb, 0xa3, 0x2a, 0x2c,
+	0x96, 0x6c, 0xba, 0xe9, 0x6f, 0xa6, 0xbd, 0x4e, 0x63, 0x54, 0x54, 0x18, 0xd9, 0x53, 0xe3, 0x22,
+	0xf6, 0x29,
+};
+static const uint32_t s_bmp_32_bitfields_pixels[] = {
+	0xffe96fa6, 0xff4e6354, 0xff18d953, 0xff22f629, 0xff2458c9, 0xff56bc64, 0xff81bba3, 0xff2c966c,
+	0xffdd7aee, 0xff5283e0, 0xff1ee6a1, 0xff3bb593, 0xff89e492, 0xff229304, 0xffb1e413, 0xff3d976f,
+};
+
+static const SurfaceFixture s_SurfaceFixtures[] = {
+	{ "png_gray1", s_png_gray1, sizeof(s_png_gray1), 13, 5, s_png_gray1_pixels },
+	{ "png_gray2", s_png_gray2, sizeof(s_png_gray2), 13, 5, s_png_gray2_pixels },
+	{ "png_gray4", s_png_gray4, sizeof(s_png_gray4), 13, 5, s_png_gray4_pixels },
+	{ "png_gray8", s_png_gray8, sizeof(s_png_gray8), 13, 5, s_png_gray8_pixels },
+	{ "png_gray16", s_png_gray16, sizeof(s_png_gray16), 13, 5, s_png_gray16_pixels },
+	{ "png_gray8_trns", s_png_gray8_trns, sizeof(s_png_gray8_trns), 6, 4, s_png_gray8_trns_pixels },
+	{ "png_gray16_adam7", s_png_gray16_adam7, sizeof(s_png_gray16_adam7), 17, 11, s_png_gray16_adam7_pixels },
+	{ "png_rgb8", s_png_rgb8, sizeof(s_png_rgb8), 7, 6, s_png_rgb8_pixels },
+	{ "png_graya8", s_png_graya8, sizeof(s_png_graya8), 5, 7, s_png_graya8_pixels },
+	{ "png_rgba8", s_png_rgba8, sizeof(s_png_rgba8), 9, 3, s_png_rgba8_pixels },
+	{ "png_rgb16", s_png_rgb16, sizeof(s_png_rgb16), 7, 6, s_png_rgb16_pixels },
+	{ "png_graya16", s_png_graya16, sizeof(s_png_graya16), 5, 7, s_png_graya16_pixels },
+	{ "png_rgba16", s_png_rgba16, sizeof(s_png_rgba16), 9, 3, s_png_rgba16_pixels },
+	{ "png_rgb8_trns", s_png_rgb8_trns, sizeof(s_png_rgb8_trns), 5, 5, s_png_rgb8_trns_pixels },
+	{ "png_rgb16_trns", s_png_rgb16_trns, sizeof(s_png_rgb16_trns), 5, 5, s_png_rgb16_trns_pixels },
+	{ "png_rgba8_adam7", s_png_rgba8_adam7, sizeof(s_png_rgba8_adam7), 19, 13, s_png_rgba8_adam7_pixels },
+	{ "png_rgba8_adam7_tiny", s_png_rgba8_adam7_tiny, sizeof(s_png_rgba8_adam7_tiny), 3, 2, s_png_rgba8_adam7_tiny_pixels },
+	{ "png_palette1", s_png_palette1, sizeof(s_png_palette1), 11, 4, s_png_palette1_pixels },
+	{ "png_palette2", s_png_palette2, sizeof(s_png_palette2), 11, 4, s_png_palette2_pixels },
+	{ "png_palette4", s_png_palette4, sizeof(s_png_palette4), 11, 4, s_png_palette4_pixels },
+	{ "png_palette8", s_png_palette8, sizeof(s_png_palette8), 11, 4, s_png_palette8_pixels },
+	{ "png_palette4_trns", s_png_palette4_trns, sizeof(s_png_palette4_trns), 10, 6, s_png_palette4_trns_pixels },
+	{ "bmp_1", s_bmp_1, sizeof(s_bmp_1), 19, 4, s_bmp_1_pixels },
+	{ "bmp_4", s_bmp_4, sizeof(s_bmp_4), 9, 5, s_bmp_4_pixels },
+	{ "bmp_8", s_bmp_8, sizeof(s_bmp_8), 7, 3, s_bmp_8_pixels },
+	{ "bmp_24", s_bmp_24, sizeof(s_bmp_24), 5, 6, s_bmp_24_pixels },
+	{ "bmp_16", s_bmp_16, sizeof(s_bmp_16), 6, 4, s_bmp_16_pixels },
+	{ "bmp_16_565", s_bmp_16_565, sizeof(s_bmp_16_565), 6, 4, s_bmp_16_565_pixels },
+	{ "bmp_32", s_bmp_32, sizeof(s_bmp_32), 5, 3, s_bmp_32_pixels },
+	{ "bmp_32_noalpha", s_bmp_32_noalpha, sizeof(s_bmp_32_noalpha), 5, 3, s_bmp_32_noalpha_pixels },
+	{ "bmp_32_bitfields", s_bmp_32_bitfields, sizeof(s_bmp_32_bitfields), 4, 4, s_bmp_32_bitfields_pixels },
+};
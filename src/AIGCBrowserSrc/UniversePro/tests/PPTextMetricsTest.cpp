@@ -0,0 +1,378 @@
+// PPTextMetricsTest.cpp : CPPTextMetrics and the word wrap it measures for
+//
+// The runs are measured with CPPFixedTextMeasurer, so every width is known
+// up front: GetWidth and GetFit are checked against it, and the cache for
+// its hits, misses and least recently used eviction.
+//
+// CPPHtmlDrawer::GetWordWrap measured every prefix it tried with its own
+// GetTextExtentPoint32 call before it took the widths from one run. That
+// code is kept below as it was, measuring each prefix with a measurer of its
+// own, and random texts are wrapped line by line through it and through
+// PPGetWordWrap, which GetWordWrap forwards to now: the lines, the text left
+// over and the widths must be the same.
+
+#include "stdafx.h"
+#include "PPTextMetrics.h"
+#include "TestCheck.h"
+
+#include <random>
+#include <string>
+
+// PPHTMLDRAWER_BREAK_CHARS
+static const TCHAR* const s_pszBreakChars = _T(" -.,!:;)}]?");
+
+// a proportional font: the advance depends on the char
+class CVariableTextMeasurer : public CPPTextMeasurer
+{
+public:
+	CVariableTextMeasurer() : m_nCalls(0) {}
+
+	uint64_t GetFontKey() { return 0x5EED; }
+	bool Measure(const TCHAR* lpszText, int nLength, int* pExtents, int& nHeight)
+	{
+		m_nCalls++;
+		int nWidth = 0;
+		for (int i = 0; i < nLength; i++)
+		{
+			nWidth += Advance(lpszText[i]);
+			pExtents[i] = nWidth;
+		}
+		nHeight = 14;
+		return true;
+	}
+	static int Advance(TCHAR ch) { return 3 + (unsigned char)ch % 7; }
+
+	size_t m_nCalls;
+};
+
+// GetTextExtentPoint32 of the first nLength chars, with a run of its own
+static int PrefixWidth(CPPTextMeasurer& measurer, const CString& str, int nLength)
+{
+	// the old code measured one char past an empty string, the NUL
+	if (nLength > str.GetLength())
+		nLength = str.GetLength();
+	std::vector<int> vExtents(nLength + 1);
+	int nHeight = 0;
+	measurer.Measure(str, nLength, &vExtents[0], nHeight);
+	return nLength ? vExtents[nLength - 1] : 0;
+}
+
+static TCHAR OldIndexNextChars(const CString& str, int& nIndex, const TCHAR* pszChars)
+{
+	for (; nIndex < str.GetLength(); nIndex++)
+	{
+		for (int i = 0; pszChars[i]; i++)
+		{
+			if (str.GetAt(nIndex) == pszChars[i])
+				return str.GetAt(nIndex);
+		}
+	}
+	return 0;
+}
+
+// CPPHtmlDrawer::GetWordWrap as it was, one measure per prefix
+static CString OldWordWrap(CPPTextMeasurer& measurer, CString& str, int nMaxSize, int& nRealSize)
+{
+	int nCurIndex = 0;
+	int nLastIndex = 0;
+	int nWidth = 0;
+	TCHAR tch = _T(' ');
+	CString sResult = _T("");
+
+	while ((nWidth <= nRealSize) && (0 != tch))
+	{
+		nLastIndex = nCurIndex;
+		nCurIndex++;
+		tch = OldIndexNextChars(str, nCurIndex, s_pszBreakChars);
+		nWidth = PrefixWidth(measurer, str, nCurIndex);
+		sResult = str.Left(nCurIndex + 1);
+		sResult.TrimRight();
+		nWidth = PrefixWidth(measurer, sResult, sResult.GetLength());
+	}
+
+	if (0 == nLastIndex)
+	{
+		if (nMaxSize == nRealSize)
+		{
+			nWidth = 0;
+			int i = 0;
+			for (i = 1; i < str.GetLength(); i++)
+			{
+				nWidth = PrefixWidth(measurer, str, i + 1);
+				if (nWidth > nRealSize)
+				{
+					sResult = str.Left(i);
+					str = str.Mid(i);
+					nRealSize = PrefixWidth(measurer, sResult, i);
+					return sResult;
+				}
+			}
+			nWidth = PrefixWidth(measurer, str, i);
+			sResult = str;
+			str.Empty();
+		}
+		else
+		{
+			nWidth = 0;
+		}
+	}
+	else
+	{
+		sResult = str.Left(nLastIndex + 1);
+		str = str.Mid(nLastIndex + 1);
+		sResult.TrimRight();
+		nWidth = PrefixWidth(measurer, sResult, sResult.GetLength());
+		str.TrimLeft();
+	}
+	nRealSize = nWidth;
+	return sResult;
+}
+
+static CString MakeText(std::mt19937& rng, int nLength)
+{
+	static const char* const s_pszAlphabet = "abcdefghijklmnopqrstuvwxyz     -.,!:;)}]?\t";
+	std::uniform_int_distribution<int> pick(0, (int)strlen(s_pszAlphabet) - 1);
+	std::uniform_int_distribution<int> word(0, 9);
+	std::string str;
+	for (int i = 0; i < nLength; i++)
+	{
+		// long words now and then, so that some must be broken
+		if (word(rng) == 0)
+			str.append(word(rng) + 5, 'w');
+		str += s_pszAlphabet[pick(rng)];
+	}
+	return CString(str);
+}
+
+static void TestWidths()
+{
+	CPPFixedTextMeasurer measurer(8, 16);
+	CPPTextMetrics metrics;
+
+	CPPTextMetrics::TEXTRUNPTR pRun = metrics.GetRun(measurer, _T("hello world"), 11);
+	CHECK(pRun != NULL);
+	CHECK_EQ(pRun->nHeight, 16);
+	CHECK_EQ(pRun->vExtents.size(), 11);
+	for (int i = 0; i <= 11; i++)
+		CHECK_EQ(pRun->GetWidth(i), i * 8);
+	CHECK_EQ(pRun->GetWidth(-1), 0);
+	CHECK_EQ(pRun->GetWidth(100), 88);
+
+	for (int w = -1; w <= 100; w++)
+	{
+		int n = w < 0 ? 0 : w / 8;
+		CHECK_EQ(pRun->GetFit(w), n > 11 ? 11 : n);
+	}
+
+	// only the length asked for is measured
+	pRun = metrics.GetRun(measurer, _T("hello world"), 5);
+	CHECK_EQ(pRun->sText.size(), 5);
+	CHECK_EQ(pRun->GetWidth(100), 40);
+
+	CPPTextMetrics::TEXTRUNPTR pEmpty = metrics.GetRun(measurer, _T(""), 0);
+	CHECK(pEmpty != NULL);
+	CHECK_EQ(pEmpty->GetWidth(0), 0);
+	CHECK_EQ(pEmpty->GetWidth(1), 0);
+	CHECK_EQ(pEmpty->GetFit(1000), 0);
+	CHECK_EQ(metrics.GetRun(measurer, _T("abc"), -5)->sText.size(), 0);
+}
+
+static void TestCache()
+{
+	CPPFixedTextMeasurer measurer;
+	CPPTextMetrics metrics(3);
+
+	metrics.GetRun(measurer, _T("one"), 3);
+	metrics.GetRun(measurer, _T("two"), 3);
+	metrics.GetRun(measurer, _T("three"), 5);
+	CHECK_EQ(metrics.GetCount(), 3);
+	CHECK_EQ(metrics.GetMisses(), 3);
+	CHECK_EQ(metrics.GetHits(), 0);
+	CHECK_EQ(measurer.GetCalls(), 3);
+
+	// a hit measures nothing and makes "one" the most recently used
+	CPPTextMetrics::TEXTRUNPTR pOne = metrics.GetRun(measurer, _T("one"), 3);
+	CHECK_EQ(metrics.GetHits(), 1);
+	CHECK_EQ(measurer.GetCalls(), 3);
+
+	// "four" evicts "two", the least recently used
+	metrics.GetRun(measurer, _T("four"), 4);
+	CHECK_EQ(metrics.GetCount(), 3);
+	metrics.GetRun(measurer, _T("one"), 3);
+	metrics.GetRun(measurer, _T("three"), 5);
+	metrics.GetRun(measurer, _T("four"), 4);
+	CHECK_EQ(metrics.GetHits(), 4);
+	CHECK_EQ(measurer.GetCalls(), 4);
+	metrics.GetRun(measurer, _T("two"), 3);
+	CHECK_EQ(metrics.GetMisses(), 5);
+	CHECK_EQ(measurer.GetCalls(), 5);
+
+	// that evicted "one", a run still held stays valid
+	metrics.GetRun(measurer, _T("one"), 3);
+	CHECK_EQ(metrics.GetMisses(), 6);
+	CHECK(pOne->sText == "one");
+	CHECK_EQ(pOne->GetWidth(3), 24);
+
+	// another font is another run
+	size_t nMisses = metrics.GetMisses();
+	measurer.SetFont(10, 20);
+	CPPTextMetrics::TEXTRUNPTR pBig = metrics.GetRun(measurer, _T("one"), 3);
+	CHECK_EQ(metrics.GetMisses(), nMisses + 1);
+	CHECK_EQ(pBig->GetWidth(3), 30);
+	CHECK_EQ(pBig->nHeight, 20);
+	measurer.SetFont(8, 16);
+	CHECK_EQ(metrics.GetRun(measurer, _T("one"), 3)->GetWidth(3), 24);
+	CHECK_EQ(metrics.GetMisses(), nMisses + 1);
+
+	// shrinking evicts the least recently used first
+	metrics.SetMaxRuns(1);
+	CHECK_EQ(metrics.GetCount(), 1);
+	nMisses = metrics.GetMisses();
+	metrics.GetRun(measurer, _T("one"), 3);
+	CHECK_EQ(metrics.GetMisses(), nMisses);
+	metrics.GetRun(measurer, _T("two"), 3);
+	CHECK_EQ(metrics.GetMisses(), nMisses + 1);
+
+	metrics.Clear();
+	CHECK_EQ(metrics.GetCount(), 0);
+	metrics.GetRun(measurer, _T("two"), 3);
+	CHECK_EQ(metrics.GetMisses(), nMisses + 2);
+
+	// texts past 4096 chars are measured but not kept
+	std::string strLong(5000, 'x');
+	metrics.SetMaxRuns(10);
+	metrics.Clear();
+	size_t nCalls = measurer.GetCalls();
+	CPPTextMetrics::TEXTRUNPTR pLong = metrics.GetRun(measurer, strLong.c_str(), 5000);
+	CHECK_EQ(pLong->GetWidth(5000), 40000);
+	CHECK_EQ(metrics.GetCount(), 0);
+	metrics.GetRun(measurer, strLong.c_str(), 4096);
+	CHECK_EQ(metrics.GetCount(), 1);
+	metrics.GetRun(measurer, strLong.c_str(), 5000);
+	CHECK_EQ(measurer.GetCalls(), nCalls + 3);
+
+	// and nothing is kept without room
+	CPPTextMetrics none(0);
+	none.GetRun(measurer, _T("one"), 3);
+	none.GetRun(measurer, _T("one"), 3);
+	CHECK_EQ(none.GetCount(), 0);
+	CHECK_EQ(none.GetHits(), 0);
+	CHECK_EQ(none.GetMisses(), 2);
+
+	// many runs through a small cache: the count stays bounded and every
+	// run kept is found again
+	CPPTextMetrics small(16);
+	std::mt19937 rng(7);
+	std::uniform_int_distribution<int> pick(0, 40);
+	for (int i = 0; i < 5000; i++)
+	{
+		std::string str = "run" + std::to_string(pick(rng));
+		CPPTextMetrics::TEXTRUNPTR pRun = small.GetRun(measurer, str.c_str(), (int)str.size());
+		CHECK(pRun->sText == str);
+		CHECK(small.GetCount() <= 16);
+	}
+	CHECK_EQ(small.GetHits() + small.GetMisses(), 5000);
+}
+
+// one wrap by both, from the same state
+static void CompareWrap(CPPTextMeasurer& measurer, CPPTextMetrics& metrics, CString& str, int nMaxSize, int& nRealSize)
+{
+	CString strOld = str;
+	int nOldSize = nRealSize;
+	CString sOld = OldWordWrap(measurer, strOld, nMaxSize, nOldSize);
+
+	CPPTextMetrics::TEXTRUNPTR pRun = metrics.GetRun(measurer, str, str.GetLength());
+	CString sNew = PPGetWordWrap(*pRun, str, nMaxSize, nRealSize, s_pszBreakChars);
+
+	CHECK(sNew == sOld);
+	CHECK(str == strOld);
+	CHECK_EQ(nRealSize, nOldSize);
+}
+
+// the texts wrapped line by line as CPPHtmlDrawer does: the first line
+// starts at nStart, the wrap width is nMaxSize
+static void TestWrap(CPPTextMeasurer& measurer, unsigned nSeed, int nCount)
+{
+	CPPTextMetrics metrics;
+	std::mt19937 rng(nSeed);
+	std::uniform_int_distribution<int> length(0, 80);
+	std::uniform_int_distribution<int> width(1, 200);
+
+	for (int n = 0; n < nCount; n++)
+	{
+		CString str = MakeText(rng, length(rng));
+		int nMaxSize = width(rng);
+		int nStart = std::uniform_int_distribution<int>(0, nMaxSize)(rng);
+		for (int nLine = 0; !str.IsEmpty() && (nLine < 1000); nLine++)
+		{
+			int nRealSize = nMaxSize - nStart;
+			int nLength = str.GetLength();
+			CompareWrap(measurer, metrics, str, nMaxSize, nRealSize);
+			CHECK(nRealSize >= 0);
+			if ((nStart == 0) && (str.GetLength() == nLength))
+			{
+				CHECK(false);		// a whole line must take something
+				break;
+			}
+			nStart = 0;
+		}
+	}
+}
+
+static void TestWrapCases()
+{
+	CPPFixedTextMeasurer measurer(8, 16);
+	CPPTextMetrics metrics;
+	struct { const char* pszText; int nMaxSize, nRealSize; const char* pszLine; const char* pszRest; int nWidth; } cases[] =
+	{
+		{"hello world", 80, 80, "hello", "world", 40},
+		{"hello world", 48, 48, "hello", "world", 40},
+		{"hello world", 80, 30, "hello", "hello world", 0},		// nothing fits after the start
+		{"helloworld", 32, 32, "hell", "oworld", 32},			// a word broken
+		{"helloworld", 4, 4, "h", "elloworld", 8},				// at least one char
+		{"a-b-c-d", 40, 40, "a-b-", "c-d", 32},
+		{"x", 4, 4, "x", "", 8},
+		{"a   b", 16, 16, "a", "b", 8},
+	};
+	for (auto& c : cases)
+	{
+		CString str(c.pszText);
+		int nRealSize = c.nRealSize;
+		CString sLine = PPGetWordWrap(*metrics.GetRun(measurer, str, str.GetLength()), str, c.nMaxSize, nRealSize, s_pszBreakChars);
+		CHECK(sLine == c.pszLine);
+		CHECK(str == c.pszRest);
+		CHECK_EQ(nRealSize, c.nWidth);
+
+		str = c.pszText;
+		nRealSize = c.nRealSize;
+		CompareWrap(measurer, metrics, str, c.nMaxSize, nRealSize);
+	}
+
+	// a wrap measures the text once, the old one per prefix tried
+	CPPFixedTextMeasurer counted;
+	CPPTextMetrics fresh;
+	CString str("the quick brown fox jumps over the lazy dog");
+	int nRealSize = 100;
+	PPGetWordWrap(*fresh.GetRun(counted, str, str.GetLength()), str, 100, nRealSize, s_pszBreakChars);
+	CHECK_EQ(counted.GetCalls(), 1);
+	str = "the quick brown fox jumps over the lazy dog";
+	nRealSize = 100;
+	CVariableTextMeasurer old;
+	OldWordWrap(old, str, 100, nRealSize);
+	CHECK(old.m_nCalls > 4);
+}
+
+int main()
+{
+	TestWidths();
+	TestCache();
+	TestWrapCases();
+
+	CPPFixedTextMeasurer fixed(8, 16);
+	TestWrap(fixed, 1, 3000);
+	CPPFixedTextMeasurer narrow(1, 1);
+	TestWrap(narrow, 2, 1000);
+	CVariableTextMeasurer variable;
+	TestWrap(variable, 3, 3000);
+	return TestResult("PPTextMetricsTest");
+}
@@ -0,0 +1,482 @@
+// StubJvm.cpp : a JVM for the headless tests of the JNI bridge, see StubJvm.h
+
+#include "StubJvm.h"
+#include "UniverseApp.h"
+#include "eclipseOS.h"
+#include "eclipseCommon.h"
+#include "eclipseShm.h"
+
+// an instance, a class (m_pClass == NULL), a string, an array or a buffer
+struct CStubJvm::StubObject
+{
+	string m_strClass;
+	StubObject* m_pClass = NULL;
+	string m_strText;
+	vector<jobject> m_vItems;
+	void* m_pAddress = NULL;
+	jlong m_nCapacity = 0;
+};
+
+struct CStubJvm::StubMethod
+{
+	StubObject* m_pClass;
+	string m_strName;
+	string m_strSig;
+	bool m_bStatic;
+	Method m_method;
+};
+
+// the exception pending on this thread
+static thread_local jthrowable s_pException = NULL;
+static thread_local bool s_bAttached = false;
+
+#define STUB(obj)			((CStubJvm::StubObject*)(obj))
+
+// the JNI functions, members for the private types
+struct CStubJvmCalls
+{
+	typedef CStubJvm::StubObject StubObject;
+	typedef CStubJvm::StubMethod StubMethod;
+
+	static CStubJvm& Jvm() { return CStubJvm::Instance(); }
+
+	// the arguments the signature lists, taken from the va_list
+	static vector<jvalue> Args(StubMethod* pMethod, va_list args)
+	{
+		vector<jvalue> vArgs;
+		const char* pszSig = pMethod->m_strSig.c_str() + 1;
+		while (*pszSig && *pszSig != ')')
+		{
+			jvalue value;
+			memset(&value, 0, sizeof(value));
+			bool bArray = false;
+			while (*pszSig == '[')
+			{
+				bArray = true;
+				pszSig++;
+			}
+			if (*pszSig == 'L')
+				pszSig = strchr(pszSig, ';');
+			if (bArray || *pszSig == ';')
+				value.l = va_arg(args, jobject);
+			else if (*pszSig == 'J')
+				value.j = va_arg(args, jlong);
+			else if (*pszSig == 'F' || *pszSig == 'D')
+				value.d = va_arg(args, double);
+			else
+				value.i = va_arg(args, jint);
+			vArgs.push_back(value);
+			pszSig++;
+		}
+		return vArgs;
+	}
+
+	static jvalue Call(jobject thiz, jmethodID methodID, va_list args)
+	{
+		StubMethod* pMethod = (StubMethod*)methodID;
+		vector<jvalue> vArgs = Args(pMethod, args);
+		return pMethod->m_method(thiz, vArgs.data());
+	}
+
+	static jclass JNICALL FindClass(JNIEnv*, const char* name)
+	{
+		StubObject* pClass = Jvm().FindClass(name);
+		if (pClass == NULL)
+			Jvm().Throw("java/lang/NoClassDefFoundError");
+		return (jclass)pClass;
+	}
+
+	static jmethodID JNICALL GetMethodID(JNIEnv*, jclass clazz, const char* name, const char* sig)
+	{
+		return (jmethodID)Jvm().FindMethod(clazz, name, sig, false);
+	}
+
+	static jmethodID JNICALL GetStaticMethodID(JNIEnv*, jclass clazz, const char* name, const char* sig)
+	{
+		return (jmethodID)Jvm().FindMethod(clazz, name, sig, true);
+	}
+
+	static jobject JNICALL NewObjectV(JNIEnv*, jclass clazz, jmethodID methodID, va_list args)
+	{
+		jobject obj = (jobject)Jvm().New(STUB(clazz)->m_strClass);
+		STUB(obj)->m_pClass = STUB(clazz);
+		Call(obj, methodID, args);
+		return obj;
+	}
+
+	static jobject JNICALL CallObjectMethodV(JNIEnv*, jobject obj, jmethodID methodID, va_list args) { return Call(obj, methodID, args).l; }
+	static jint JNICALL CallIntMethodV(JNIEnv*, jobject obj, jmethodID methodID, va_list args) { return Call(obj, methodID, args).i; }
+	static jobject JNICALL CallStaticObjectMethodV(JNIEnv*, jclass, jmethodID methodID, va_list args) { return Call(NULL, methodID, args).l; }
+	static jboolean JNICALL CallStaticBooleanMethodV(JNIEnv*, jclass, jmethodID methodID, va_list args) { return Call(NULL, methodID, args).z; }
+	static void JNICALL CallStaticVoidMethodV(JNIEnv*, jclass, jmethodID methodID, va_list args) { Call(NULL, methodID, args); }
+
+	static jint JNICALL RegisterNatives(JNIEnv*, jclass clazz, const JNINativeMethod* methods, jint nMethods)
+	{
+		std::lock_guard<std::recursive_mutex> lock(Jvm().m_csObjects);
+		for (int i = 0; i < nMethods; i++)
+			Jvm().m_mapNatives[STUB(clazz)->m_strClass + "." + methods[i].name] = make_pair(string(methods[i].signature), methods[i].fnPtr);
+		return JNI_OK;
+	}
+
+	static jthrowable JNICALL ExceptionOccurred(JNIEnv*) { return s_pException; }
+	static jboolean JNICALL ExceptionCheck(JNIEnv*) { return s_pException != NULL; }
+	static void JNICALL ExceptionDescribe(JNIEnv*) {}
+	static void JNICALL ExceptionClear(JNIEnv*) { s_pException = NULL; }
+
+	// references are the objects themselves, which live until Reset()
+	static jobject JNICALL NewRef(JNIEnv*, jobject obj) { return obj; }
+	static void JNICALL DeleteRef(JNIEnv*, jobject) {}
+
+	static jstring JNICALL NewString(JNIEnv*, const jchar* unicode, jsize len)
+	{
+		StubObject* pString = Jvm().New("java/lang/String");
+		pString->m_strText.assign((const _TCHAR*)unicode, len);
+		return (jstring)pString;
+	}
+
+	static jsize JNICALL GetStringLength(JNIEnv*, jstring str) { return (jsize)STUB(str)->m_strText.size(); }
+	static const jchar* JNICALL GetStringChars(JNIEnv*, jstring str, jboolean*) { return (const jchar*)STUB(str)->m_strText.c_str(); }
+	static void JNICALL ReleaseStringChars(JNIEnv*, jstring, const jchar*) {}
+
+	static jstring JNICALL NewStringUTF(JNIEnv*, const char* utf) { return Jvm().NewString(utf); }
+	static const char* JNICALL GetStringUTFChars(JNIEnv*, jstring str, jboolean*) { return STUB(str)->m_strText.c_str(); }
+	static void JNICALL ReleaseStringUTFChars(JNIEnv*, jstring, const char*) {}
+
+	static jobjectArray JNICALL NewObjectArray(JNIEnv*, jsize len, jclass clazz, jobject init)
+	{
+		StubObject* pArray = Jvm().New("[L" + STUB(clazz)->m_strClass + ";");
+		pArray->m_vItems.assign(len, init);
+		return (jobjectArray)pArray;
+	}
+
+	static void JNICALL SetObjectArrayElement(JNIEnv*, jobjectArray array, jsize index, jobject val) { STUB(array)->m_vItems.at(index) = val; }
+	static jobject JNICALL GetObjectArrayElement(JNIEnv*, jobjectArray array, jsize index) { return STUB(array)->m_vItems.at(index); }
+	static jsize JNICALL GetArrayLength(JNIEnv*, jarray array) { return (jsize)STUB(array)->m_vItems.size(); }
+
+	static jobject JNICALL NewDirectByteBuffer(JNIEnv*, void* address, jlong capacity)
+	{
+		StubObject* pBuffer = Jvm().New("java/nio/DirectByteBuffer");
+		pBuffer->m_pAddress = address;
+		pBuffer->m_nCapacity = capacity;
+		return (jobject)pBuffer;
+	}
+
+	static void* JNICALL GetDirectBufferAddress(JNIEnv*, jobject buf) { return STUB(buf)->m_pAddress; }
+	static jlong JNICALL GetDirectBufferCapacity(JNIEnv*, jobject buf) { return STUB(buf)->m_nCapacity; }
+
+	static jint JNICALL DestroyJavaVM(JavaVM*)
+	{
+		Jvm().Exit();
+		return JNI_OK;
+	}
+
+	static jint JNICALL AttachCurrentThread(JavaVM*, void** penv, void*)
+	{
+		s_bAttached = true;
+		*penv = Jvm().GetEnv();
+		return JNI_OK;
+	}
+
+	static jint JNICALL DetachCurrentThread(JavaVM*)
+	{
+		s_bAttached = false;
+		return JNI_OK;
+	}
+
+	static jint JNICALL GetEnv(JavaVM*, void** penv, jint)
+	{
+		*penv = s_bAttached ? Jvm().GetEnv() : NULL;
+		return s_bAttached ? JNI_OK : JNI_EDETACHED;
+	}
+};
+
+CStubJvm& CStubJvm::Instance()
+{
+	static CStubJvm s_Jvm;
+	return s_Jvm;
+}
+
+CStubJvm::CStubJvm() : m_bCreated(false), m_nExits(0)
+{
+	// a function the bridge should not call is a null pointer, and a crash
+	memset(&m_Functions, 0, sizeof(m_Functions));
+	m_Functions.FindClass = CStubJvmCalls::FindClass;
+	m_Functions.GetMethodID = CStubJvmCalls::GetMethodID;
+	m_Functions.GetStaticMethodID = CStubJvmCalls::GetStaticMethodID;
+	m_Functions.NewObjectV = CStubJvmCalls::NewObjectV;
+	m_Functions.CallObjectMethodV = CStubJvmCalls::CallObjectMethodV;
+	m_Functions.CallIntMethodV = CStubJvmCalls::CallIntMethodV;
+	m_Functions.CallStaticObjectMethodV = CStubJvmCalls::CallStaticObjectMethodV;
+	m_Functions.CallStaticBooleanMethodV = CStubJvmCalls::CallStaticBooleanMethodV;
+	m_Functions.CallStaticVoidMethodV = CStubJvmCalls::CallStaticVoidMethodV;
+	m_Functions.RegisterNatives = CStubJvmCalls::RegisterNatives;
+	m_Functions.ExceptionOccurred = CStubJvmCalls::ExceptionOccurred;
+	m_Functions.ExceptionCheck = CStubJvmCalls::ExceptionCheck;
+	m_Functions.ExceptionDescribe = CStubJvmCalls::ExceptionDescribe;
+	m_Functions.ExceptionClear = CStubJvmCalls::ExceptionClear;
+	m_Functions.NewGlobalRef = CStubJvmCalls::NewRef;
+	m_Functions.NewLocalRef = CStubJvmCalls::NewRef;
+	m_Functions.DeleteGlobalRef = CStubJvmCalls::DeleteRef;
+	m_Functions.DeleteLocalRef = CStubJvmCalls::DeleteRef;
+	m_Functions.NewString = CStubJvmCalls::NewString;
+	m_Functions.GetStringLength = CStubJvmCalls::GetStringLength;
+	m_Functions.GetStringChars = CStubJvmCalls::GetStringChars;
+	m_Functions.ReleaseStringChars = CStubJvmCalls::ReleaseStringChars;
+	m_Functions.NewStringUTF = CStubJvmCalls::NewStringUTF;
+	m_Functions.GetStringUTFChars = CStubJvmCalls::GetStringUTFChars;
+	m_Functions.ReleaseStringUTFChars = CStubJvmCalls::ReleaseStringUTFChars;
+	m_Functions.NewObjectArray = CStubJvmCalls::NewObjectArray;
+	m_Functions.SetObjectArrayElement = CStubJvmCalls::SetObjectArrayElement;
+	m_Functions.GetObjectArrayElement = CStubJvmCalls::GetObjectArrayElement;
+	m_Functions.GetArrayLength = CStubJvmCalls::GetArrayLength;
+	m_Functions.NewDirectByteBuffer = CStubJvmCalls::NewDirectByteBuffer;
+	m_Functions.GetDirectBufferAddress = CStubJvmCalls::GetDirectBufferAddress;
+	m_Functions.GetDirectBufferCapacity = CStubJvmCalls::GetDirectBufferCapacity;
+	m_Env.functions = &m_Functions;
+
+	memset(&m_Invoke, 0, sizeof(m_Invoke));
+	m_Invoke.DestroyJavaVM = CStubJvmCalls::DestroyJavaVM;
+	m_Invoke.AttachCurrentThread = CStubJvmCalls::AttachCurrentThread;
+	m_Invoke.AttachCurrentThreadAsDaemon = CStubJvmCalls::AttachCurrentThread;
+	m_Invoke.DetachCurrentThread = CStubJvmCalls::DetachCurrentThread;
+	m_Invoke.GetEnv = CStubJvmCalls::GetEnv;
+	m_Vm.functions = &m_Invoke;
+	Reset();
+}
+
+CStubJvm::~CStubJvm()
+{
+	Clear();
+}
+
+void CStubJvm::Clear()
+{
+	std::lock_guard<std::recursive_mutex> lock(m_csObjects);
+	for (auto it : m_vObjects)
+		delete it;
+	for (auto it : m_vMethods)
+		delete it;
+	for (auto it : m_vRetiredObjects)
+		delete it;
+	for (auto it : m_vRetiredMethods)
+		delete it;
+	m_vObjects.clear();
+	m_vMethods.clear();
+	m_vRetiredObjects.clear();
+	m_vRetiredMethods.clear();
+	m_mapClasses.clear();
+	m_mapNatives.clear();
+}
+
+void CStubJvm::Reset()
+{
+	std::lock_guard<std::recursive_mutex> lock(m_csObjects);
+	// the launcher keeps what it cached from the last VM, string_class in
+	// eclipseJNI.cpp, so those objects stay valid until the end
+	m_vRetiredObjects.insert(m_vRetiredObjects.end(), m_vObjects.begin(), m_vObjects.end());
+	m_vRetiredMethods.insert(m_vRetiredMethods.end(), m_vMethods.begin(), m_vMethods.end());
+	m_vObjects.clear();
+	m_vMethods.clear();
+	m_mapClasses.clear();
+	m_mapNatives.clear();
+	m_pfnCreate = nullptr;
+	m_pfnExit = nullptr;
+	m_bCreated = false;
+	m_vOptions.clear();
+	m_nExits = 0;
+	s_pException = NULL;
+	DefineClass("java/lang/String");
+	m_mapProperties.clear();
+	m_mapProperties["java.vm.version"] = "17.0.8+7";
+	m_mapProperties["java.vm.info"] = "mixed mode, sharing";
+}
+
+CStubJvm::StubObject* CStubJvm::New(const string& strClass)
+{
+	std::lock_guard<std::recursive_mutex> lock(m_csObjects);
+	StubObject* pObject = new StubObject;
+	pObject->m_strClass = strClass;
+	m_vObjects.push_back(pObject);
+	return pObject;
+}
+
+CStubJvm::StubObject* CStubJvm::FindClass(const string& strClass)
+{
+	std::lock_guard<std::recursive_mutex> lock(m_csObjects);
+	auto it = m_mapClasses.find(strClass);
+	return it != m_mapClasses.end() ? it->second : NULL;
+}
+
+CStubJvm::StubMethod* CStubJvm::FindMethod(jclass clazz, const char* pszName, const char* pszSig, bool bStatic)
+{
+	std::lock_guard<std::recursive_mutex> lock(m_csObjects);
+	for (auto it : m_vMethods)
+	{
+		if (it->m_pClass == STUB(clazz) && it->m_strName == pszName && it->m_strSig == pszSig && it->m_bStatic == bStatic)
+			return it;
+	}
+	Throw("java/lang/NoSuchMethodError");
+	return NULL;
+}
+
+void CStubJvm::DefineClass(const char* pszClass)
+{
+	std::lock_guard<std::recursive_mutex> lock(m_csObjects);
+	if (FindClass(pszClass) == NULL)
+		m_mapClasses[pszClass] = New(pszClass);
+}
+
+void CStubJvm::DefineMethod(const char* pszClass, const char* pszName, const char* pszSig, Method method, bool bStatic)
+{
+	std::lock_guard<std::recursive_mutex> lock(m_csObjects);
+	DefineClass(pszClass);
+	StubMethod* pMethod = new StubMethod;
+	pMethod->m_pClass = FindClass(pszClass);
+	pMethod->m_strName = pszName;
+	pMethod->m_strSig = pszSig;
+	pMethod->m_bStatic = bStatic;
+	pMethod->m_method = method;
+	m_vMethods.push_back(pMethod);
+}
+
+void CStubJvm::DefineStaticMethod(const char* pszClass, const char* pszName, const char* pszSig, Method method)
+{
+	DefineMethod(pszClass, pszName, pszSig, method, true);
+}
+
+void CStubJvm::DefineWorkbench(std::function<jint(jobjectArray args)> pfnRun)
+{
+	jvalue none;
+	memset(&none, 0, sizeof(none));
+	DefineStaticMethod("java/lang/System", "load", "(Ljava/lang/String;)V", [none](jobject, const jvalue*) { return none; });
+	DefineStaticMethod("java/lang/System", "exit", "(I)V", [this, none](jobject, const jvalue*) { Exit(); return none; });
+	DefineStaticMethod("java/lang/System", "getProperty", "(Ljava/lang/String;)Ljava/lang/String;", [this](jobject, const jvalue* args) {
+		jvalue value;
+		auto it = m_mapProperties.find(GetString((jstring)args[0].l));
+		value.l = it != m_mapProperties.end() ? NewString(it->second.c_str()) : NULL;
+		return value;
+	});
+	DefineStaticMethod("java/lang/Boolean", "getBoolean", "(Ljava/lang/String;)Z", [this](jobject, const jvalue* args) {
+		jvalue value;
+		auto it = m_mapProperties.find(GetString((jstring)args[0].l));
+		value.z = it != m_mapProperties.end() && it->second == "true";
+		return value;
+	});
+	DefineClass(g_SpaceTelescope.m_strBridgeJavaClass);
+	DefineClass("dev/tangram/TangramJava");
+	DefineMethod(g_SpaceTelescope.m_strMainClass, "<init>", "()V", [none](jobject, const jvalue*) { return none; });
+	DefineMethod(g_SpaceTelescope.m_strMainClass, "run", "([Ljava/lang/String;)I", [pfnRun](jobject, const jvalue* args) {
+		jvalue value;
+		value.i = pfnRun((jobjectArray)args[0].l);
+		return value;
+	});
+}
+
+void* CStubJvm::GetNative(const char* pszClass, const char* pszName, string* pstrSig)
+{
+	std::lock_guard<std::recursive_mutex> lock(m_csObjects);
+	auto it = m_mapNatives.find(string(pszClass) + "." + pszName);
+	if (it == m_mapNatives.end())
+		return NULL;
+	if (pstrSig)
+		*pstrSig = it->second.first;
+	return it->second.second;
+}
+
+void CStubJvm::Exit()
+{
+	m_nExits++;
+	if (m_pfnExit)
+		m_pfnExit();
+}
+
+jstring CStubJvm::NewString(LPCTSTR psz)
+{
+	StubObject* pString = New("java/lang/String");
+	pString->m_strText = psz;
+	return (jstring)pString;
+}
+
+string CStubJvm::GetString(jstring str)
+{
+	return str != NULL ? STUB(str)->m_strText : string();
+}
+
+jobject CStubJvm::GetArrayItem(jobject array, int nIndex)
+{
+	return STUB(array)->m_vItems.at(nIndex);
+}
+
+int CStubJvm::GetArrayLength(jobject array)
+{
+	return (int)STUB(array)->m_vItems.size();
+}
+
+void CStubJvm::Throw(const char* pszClass)
+{
+	s_pException = (jthrowable)New(pszClass);
+}
+
+jint JNICALL CStubJvm::CreateJavaVM(JavaVM** ppVm, JNIEnv** ppEnv, void* pArgs)
+{
+	CStubJvm& jvm = Instance();
+	JavaVMInitArgs* pInitArgs = (JavaVMInitArgs*)pArgs;
+	jvm.m_vOptions.clear();
+	for (int i = 0; i < pInitArgs->nOptions; i++)
+		jvm.m_vOptions.push_back(pInitArgs->options[i].optionString);
+	jint nResult = jvm.m_pfnCreate ? jvm.m_pfnCreate(jvm.m_vOptions) : JNI_OK;
+	if (nResult != JNI_OK)
+		return nResult;
+	jvm.m_bCreated = true;
+	s_bAttached = true;
+	*ppVm = &jvm.m_Vm;
+	*ppEnv = &jvm.m_Env;
+	return JNI_OK;
+}
+
+// the host and the launcher around eclipseJNI.cpp
+
+CSpaceTelescope g_SpaceTelescope;
+CSpaceTelescope* g_pSpaceTelescope = &g_SpaceTelescope;
+CUniverse theApp;
+
+_TCHAR* exitData = NULL;
+int secondThread = 0;
+_TCHAR* eclipseLibrary = (_TCHAR*)_T_ECLIPSE("eclipse_1000.dll");
+
+static _TCHAR* s_pszProgramPath = NULL;
+static _TCHAR* s_pszOfficialName = NULL;
+
+void setProgramPath(_TCHAR* name)
+{
+	free(s_pszProgramPath);
+	s_pszProgramPath = name;
+}
+
+void setOfficialName(_TCHAR* name)
+{
+	free(s_pszOfficialName);
+	s_pszOfficialName = name;
+}
+
+void dispatchMessages() {}
+jlong getSplashHandle() { return 0; }
+int showSplash(const _TCHAR*) { return 0; }
+void takeDownSplash() {}
+int setSharedData(const _TCHAR*, const _TCHAR*) { return 0; }
+
+char* toNarrow(const _TCHAR* src)
+{
+	return _strdup(src);
+}
+
+// every library is the stub JVM
+void* loadLibrary(_TCHAR* library)
+{
+	return &CStubJvm::Instance();
+}
+
+void* findSymbol(void* handle, _TCHAR* symbol)
+{
+	return _tcscmp(symbol, _T_ECLIPSE("JNI_CreateJavaVM")) == 0 ? (void*)&CStubJvm::CreateJavaVM : NULL;
+}
@@ -0,0 +1,96 @@
+// StubJvm.h : a JVM for the headless tests of the JNI bridge
+//
+// Just enough of JNI for eclipseJNI.cpp: the classes and methods a test
+// defines, strings, object arrays, direct byte buffers, pending exceptions
+// and RegisterNatives, which the test then calls the way Java would. The
+// launcher's loadLibrary()/findSymbol() hand startJavaJNI() the stub's
+// JNI_CreateJavaVM.
+//
+// Strings are kept as _TCHAR units: eclipseJNI.cpp is built with UNICODE,
+// as on Windows, and in the narrow test build its jchars are _TCHARs.
+
+#pragma once
+
+#include "stdafx.h"
+#include "Cosmos.h"
+#include <functional>
+#include <mutex>
+
+class CStubJvm
+{
+public:
+	// a Java method, args as the signature lists them
+	typedef std::function<jvalue(jobject thiz, const jvalue* args)> Method;
+
+	static CStubJvm& Instance();
+
+	// forgets classes, natives and the VM, for the next launch; what the
+	// last one handed out stays readable until the stub goes away
+	void Reset();
+
+	void DefineClass(const char* pszClass);
+	// constructors are instance methods named <init>
+	void DefineMethod(const char* pszClass, const char* pszName, const char* pszSig, Method method, bool bStatic = false);
+	void DefineStaticMethod(const char* pszClass, const char* pszName, const char* pszSig, Method method);
+
+	// the classes a launch looks up: System, Boolean, the bridge and
+	// TangramJava, and the Main class g_SpaceTelescope names, whose run()
+	// is pfnRun; system properties come from m_mapProperties
+	void DefineWorkbench(std::function<jint(jobjectArray args)> pfnRun);
+	map<string, string> m_mapProperties;
+
+	// a native the bridge registered, NULL if none
+	void* GetNative(const char* pszClass, const char* pszName, string* pstrSig = NULL);
+
+	// decides whether JNI_CreateJavaVM succeeds, JNI_OK when not set
+	std::function<jint(const vector<string>& vOptions)> m_pfnCreate;
+	// runs when the VM exits, by DestroyJavaVM or a method calling Exit()
+	std::function<void()> m_pfnExit;
+
+	JavaVM* GetVm() { return &m_Vm; }
+	JNIEnv* GetEnv() { return &m_Env; }
+	bool IsCreated() const { return m_bCreated; }
+	const vector<string>& GetOptions() const { return m_vOptions; }
+	int GetExits() const { return m_nExits; }
+	void Exit();
+
+	jstring NewString(LPCTSTR psz);
+	string GetString(jstring str);
+	jobject GetArrayItem(jobject array, int nIndex);
+	int GetArrayLength(jobject array);
+	void Throw(const char* pszClass);
+
+	static jint JNICALL CreateJavaVM(JavaVM** ppVm, JNIEnv** ppEnv, void* pArgs);
+
+private:
+	CStubJvm();
+	~CStubJvm();
+	void Clear();
+
+	struct StubObject;
+	struct StubMethod;
+	friend struct CStubJvmCalls;
+
+	StubObject* New(const string& strClass);
+	StubObject* FindClass(const string& strClass);
+	StubMethod* FindMethod(jclass clazz, const char* pszName, const char* pszSig, bool bStatic);
+
+	std::recursive_mutex m_csObjects;
+	vector<StubObject*> m_vObjects;
+	vector<StubMethod*> m_vMethods;
+	vector<StubObject*> m_vRetiredObjects;		// of the launches before the last Reset()
+	vector<StubMethod*> m_vRetiredMethods;
+	map<string, StubObject*> m_mapClasses;
+	map<string, pair<string, void*>> m_mapNatives;
+
+	JNINativeInterface_ m_Functions;
+	JNIInvokeInterface_ m_Invoke;
+	JNIEnv m_Env;
+	JavaVM m_Vm;
+	bool m_bCreated;
+	vector<string> m_vOptions;
+	int m_nExits;
+};
+
+// the host g_pSpaceTelescope points to
+extern CSpaceTelescope g_SpaceTelescope;
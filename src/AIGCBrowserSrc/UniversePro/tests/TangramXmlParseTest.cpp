@@ -0,0 +1,364 @@
+// TangramXmlParseTest.cpp : the cached serializer of CTangramXmlParse
+//
+// CTangramXmlParse runs on the DOM of win32/msxml2.h. xmlCached() must give
+// what xml() gives after every change a random walk makes through the class
+// (put_attr, put_text, AddNode, RemoveNode, Reflash, LoadXml), and a change
+// must leave dirty the changed node and its ancestors, nothing else.
+//
+// "TangramXmlParseTest bench" times both on grid layouts of a few sizes, the
+// way a splitter drag saves one: a changed width, then the layout's xml. The
+// stand-in DOM writes its xml faster than MSXML does, so the full path's
+// times are lower than they would be on Windows.
+
+#include "TangramXmlParse.h"
+#include "TestCheck.h"
+
+#include <chrono>
+#include <random>
+
+static CString RandomValue(std::mt19937& rng)
+{
+	static const char* const s_apszValues[] = {
+		"0", "120,", "200,300,", "a&b", "<tag>", "say \"hi\"", "it's", "x > y", "", "Main",
+	};
+	return s_apszValues[rng() % (sizeof(s_apszValues) / sizeof(s_apszValues[0]))];
+}
+
+static CString Escape(const CString& str)
+{
+	CString strOut;
+	for (int i = 0; i < str.GetLength(); i++)
+	{
+		switch (str[i])
+		{
+		case '&': strOut += "&amp;"; break;
+		case '<': strOut += "&lt;"; break;
+		case '>': strOut += "&gt;"; break;
+		case '"': strOut += "&quot;"; break;
+		default:
+			{
+				char sz[2] = { str[i], 0 };
+				strOut += sz;
+			}
+			break;
+		}
+	}
+	return strOut;
+}
+
+// a layout of about nNodes elements, with text and comments between them
+static void MakeNode(std::mt19937& rng, int& nNodes, int nDepth, CString& strXml)
+{
+	static const char* const s_apszNames[] = { "xobj", "nucleus", "property", "XOBJ" };
+	CString strName = s_apszNames[rng() % 4];
+	CString strNode;
+	strNode.Format("<%s id=\"n%d\"", (LPCTSTR)strName, nNodes--);
+	strXml += strNode;
+	int nAttrs = rng() % 4;
+	static const char* const s_apszAttrs[] = { "width", "height", "caption", "objid" };
+	for (int i = 0; i < nAttrs; i++)
+		strXml += CString(" ") + s_apszAttrs[i] + "=\"" + Escape(RandomValue(rng)) + "\"";
+	int nChildren = nDepth < 6 && nNodes > 0 ? rng() % 5 : 0;
+	if (nChildren == 0 && rng() % 3)
+	{
+		strXml += "/>";
+		return;
+	}
+	strXml += ">";
+	for (int i = 0; i < nChildren && nNodes > 0; i++)
+	{
+		switch (rng() % 6)
+		{
+		case 0: strXml += Escape(RandomValue(rng)); break;
+		case 1: strXml += "<!-- note -->"; break;
+		}
+		MakeNode(rng, nNodes, nDepth + 1, strXml);
+	}
+	if (nChildren == 0)
+		strXml += Escape(RandomValue(rng));
+	strXml += "</" + strName + ">";
+}
+
+static CString MakeLayout(std::mt19937& rng, int nNodes)
+{
+	CString strXml = "<layout caption=\"root\">";
+	while (nNodes > 0)
+		MakeNode(rng, nNodes, 1, strXml);
+	return strXml + "</layout>";
+}
+
+static void Collect(CTangramXmlParse* pParse, vector<CTangramXmlParse*>& vNodes)
+{
+	vNodes.push_back(pParse);
+	for (int i = 0; i < pParse->GetCount(); i++)
+		Collect(pParse->GetChild(i), vNodes);
+}
+
+static bool IsAncestor(CTangramXmlParse* pAncestor, CTangramXmlParse* pParse)
+{
+	for (; pParse; pParse = pParse->m_pParentParse)
+	{
+		if (pParse == pAncestor)
+			return true;
+	}
+	return false;
+}
+
+// after xmlCached() of the root nothing is dirty; after a change of pChanged
+// exactly pChanged and its ancestors are
+static void CheckDirty(CTangramXmlParse& root, CTangramXmlParse* pChanged)
+{
+	vector<CTangramXmlParse*> vNodes;
+	Collect(&root, vNodes);
+	for (CTangramXmlParse* pParse : vNodes)
+		CHECK_EQ(pParse->IsDirty(), pChanged && IsAncestor(pParse, pChanged));
+}
+
+static void TestCases()
+{
+	// its elements move into root's document, which must not outlive it
+	CTangramXmlParse other;
+	CTangramXmlParse root;
+	CHECK(root.xmlCached() == "");
+	CHECK(root.LoadXml(
+		"<default caption=\"a &amp; b\">"
+		"<nucleus><!-- grid --><xobj id=\"grid\" width=\"200,\" height=\"1 &lt; 2\">"
+		"<xobj id=\"left\"/>text &amp; more<xobj id=\"right\">r</xobj>"
+		"</xobj></nucleus>"
+		"</default>"));
+	CString strXml = root.xml();
+	CHECK(strXml == "<default caption=\"a &amp; b\"><nucleus><!-- grid --><xobj id=\"grid\" width=\"200,\" height=\"1 &lt; 2\">"
+		"<xobj id=\"left\"/>text &amp; more<xobj id=\"right\">r</xobj></xobj></nucleus></default>");
+	CHECK(root.xmlCached() == strXml);
+	CheckDirty(root, NULL);
+	CHECK(root.xmlCached() == strXml);
+
+	CTangramXmlParse* pGrid = root.FindItemByName("grid");
+	CHECK(pGrid != NULL);
+	CTangramXmlParse* pLeft = pGrid->FindItemByName("left");
+	CHECK(pLeft != NULL);
+	CHECK(pLeft->put_attr("width", CString("\"q\" <&>")));
+	CheckDirty(root, pLeft);
+	CHECK(root.xmlCached() == root.xml());
+	CHECK(root.xml().Find("width=\"&quot;q&quot; &lt;&amp;&gt;\"") > 0);
+	CheckDirty(root, NULL);
+
+	// a subtree's own output is cached as well
+	CHECK(pGrid->put_attr("height", 300));
+	CHECK(pGrid->xmlCached() == pGrid->xml());
+	CHECK(!pGrid->IsDirty());
+	CHECK(root.IsDirty());
+	CHECK(root.xmlCached() == root.xml());
+
+	CTangramXmlParse* pNew = pGrid->AddNode("xobj");
+	CHECK(pNew != NULL);
+	CHECK(pNew->IsDirty());
+	CHECK(pGrid->IsDirty());
+	CHECK(root.IsDirty());
+	CHECK(!pLeft->IsDirty());
+	CHECK(pNew->put_attr("id", CString("new")));
+	CHECK(pNew->put_attr("sizable", true));
+	CHECK(root.xmlCached() == root.xml());
+	CHECK(root.xml().Find("<xobj id=\"new\" sizable=\"true\"/></xobj>") > 0);
+
+	// ids renamed on the way in, from Name where there is no id
+	CHECK(other.LoadXml("<xobj id=\"moved\"><xobj Name=\"inner\"/></xobj>"));
+	CHECK(pGrid->AddNode(&other, "fix_") != NULL);
+	CHECK(pGrid->IsDirty());
+	CHECK(!pLeft->IsDirty());
+	CHECK(root.xmlCached() == root.xml());
+	CHECK(root.xml().Find("<xobj id=\"fix_moved\"><xobj Name=\"inner\" id=\"fix_inner\"/></xobj>") > 0);
+
+	CHECK(pLeft->put_text("left & text"));
+	CheckDirty(root, pLeft);
+	CHECK(root.xmlCached() == root.xml());
+
+	CHECK_EQ(pGrid->RemoveNode(pLeft), S_OK);
+	CheckDirty(root, pGrid);
+	CHECK(root.xmlCached() == root.xml());
+	CHECK(root.xml().Find("left") < 0);
+
+	CHECK(root.LoadXml("<other a=\"1\"><b/></other>"));
+	CHECK(root.IsDirty());
+	CHECK(root.xmlCached() == "<other a=\"1\"><b/></other>");
+}
+
+static void TestRandom(unsigned nSeed, int nSteps)
+{
+	std::mt19937 rng(nSeed);
+	CTangramXmlParse root;
+	CHECK(root.LoadXml(MakeLayout(rng, 60)));
+	CHECK(root.xmlCached() == root.xml());
+	for (int nStep = 0; nStep < nSteps; nStep++)
+	{
+		vector<CTangramXmlParse*> vNodes;
+		Collect(&root, vNodes);
+		CTangramXmlParse* pParse = vNodes[rng() % vNodes.size()];
+		// the change, and whether it made new nodes, which are dirty too
+		CTangramXmlParse* pChanged = NULL;
+		bool bNewNodes = false;
+		switch (rng() % 10)
+		{
+		case 0:
+		case 1:
+		case 2:
+			pParse->put_attr(rng() % 2 ? "width" : "extra", RandomValue(rng));
+			pChanged = pParse;
+			break;
+		case 3:
+			pParse->put_attr("height", (int)(rng() % 500));
+			pChanged = pParse;
+			break;
+		case 4:
+			if (pParse->GetCount() == 0)
+			{
+				pParse->put_text(RandomValue(rng));
+				pChanged = pParse;
+			}
+			break;
+		case 5:
+			if (vNodes.size() < 200)
+			{
+				pParse->AddNode(rng() % 2 ? "xobj" : "property")->put_attr("id", (int)nStep);
+				pChanged = pParse;
+				bNewNodes = true;
+			}
+			break;
+		case 6:
+			if (pParse->GetCount() > 0)
+			{
+				pParse->RemoveNode((int)(rng() % pParse->GetCount()));
+				pChanged = pParse;
+			}
+			break;
+		case 7:
+			// rebuilds the subtree's parse objects from the DOM
+			pParse->Reflash();
+			pChanged = pParse;
+			bNewNodes = true;
+			break;
+		case 8:
+			// only part of the tree gets its output cached before the root's
+			pParse->put_attr("width", RandomValue(rng));
+			if (pParse->m_pParentParse)
+			{
+				CHECK(pParse->m_pParentParse->xmlCached() == pParse->m_pParentParse->xml());
+				CHECK(!pParse->IsDirty());
+			}
+			break;
+		case 9:
+			if (rng() % 20 == 0)
+			{
+				CHECK(root.LoadXml(MakeLayout(rng, 60)));
+				pChanged = &root;
+				bNewNodes = true;
+			}
+			break;
+		}
+		// everything was clean before the change
+		if (pChanged && !bNewNodes)
+			CheckDirty(root, pChanged);
+		else if (pChanged)
+		{
+			vector<CTangramXmlParse*> vAfter;
+			Collect(&root, vAfter);
+			for (CTangramXmlParse* pNode : vAfter)
+			{
+				if (IsAncestor(pNode, pChanged))
+					CHECK(pNode->IsDirty());
+			}
+		}
+		CHECK(root.xmlCached() == root.xml());
+		CheckDirty(root, NULL);
+	}
+}
+template <class F>
+static double Time(F f)
+{
+	double dBest = 1e30;
+	for (int nRound = 0; nRound < 7; nRound++)
+	{
+		auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < 200; i++)
+			f();
+		double dMicros = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / 200;
+		dBest = min(dBest, dMicros);
+	}
+	return dBest;
+}
+
+static volatile size_t s_nSink;
+
+// nRows x nCols grids nested nDepth deep, each cell with the attributes a
+// saved layout carries
+static void MakeGrid(int nDepth, int nRows, int nCols, int& nId, CString& strXml)
+{
+	CString strNode;
+	strNode.Format("<xobj id=\"grid%d\" objid=\"nucleus\" rows=\"%d\" cols=\"%d\" width=\"200,200,\" height=\"150,150,\" caption=\"Grid %d\" galaxy=\"main\">",
+		nId, nRows, nCols, nId);
+	nId++;
+	strXml += strNode;
+	for (int i = 0; i < nRows * nCols; i++)
+	{
+		if (nDepth > 1)
+			MakeGrid(nDepth - 1, nRows, nCols, nId, strXml);
+		else
+		{
+			strNode.Format("<xobj id=\"view%d\" objid=\"tree\" caption=\"View %d\" style=\"19\" url=\"host/page%d.html\"/>", nId, nId, nId);
+			nId++;
+			strXml += strNode;
+		}
+	}
+	strXml += "</xobj>";
+}
+
+static void Bench()
+{
+	printf("grid layouts, microseconds per save, xml() -> xmlCached()\n");
+	for (int nDepth : { 2, 3, 4 })
+	{
+		int nId = 0;
+		CString strXml = "<default><nucleus>";
+		MakeGrid(nDepth, 2, 3, nId, strXml);
+		strXml += "</nucleus></default>";
+		CTangramXmlParse root;
+		root.LoadXml(strXml);
+		vector<CTangramXmlParse*> vNodes;
+		Collect(&root, vNodes);
+		// the first grid below the root, as a splitter drag resizes it
+		CTangramXmlParse* pGrid = root.GetChild(0)->GetChild(0)->GetChild(0);
+		int nWidth = 0;
+
+		double dFull = Time([&]() { pGrid->put_attr("width", nWidth++ % 400); s_nSink += root.xml().GetLength(); });
+		double dCached = Time([&]() { pGrid->put_attr("width", nWidth++ % 400); s_nSink += root.xmlCached().GetLength(); });
+		printf("  %5zu elements, %6d bytes\n", vNodes.size(), root.xml().GetLength());
+		printf("    one width changed    %10.2f -> %8.2f\n", dFull, dCached);
+		dFull = Time([&]() { s_nSink += root.xml().GetLength(); });
+		dCached = Time([&]() { s_nSink += root.xmlCached().GetLength(); });
+		printf("    nothing changed      %10.2f -> %8.2f\n", dFull, dCached);
+		// every leaf changed: the cache only adds its own work
+		dCached = Time([&]() {
+			for (CTangramXmlParse* pParse : vNodes)
+			{
+				if (pParse->GetCount() == 0)
+					pParse->SetDirty();
+			}
+			s_nSink += root.xmlCached().GetLength();
+		});
+		printf("    everything changed   %10.2f -> %8.2f\n", dFull, dCached);
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc > 1 && strcmp(argv[1], "bench") == 0)
+	{
+		Bench();
+		return 0;
+	}
+
+	TestCases();
+	TestRandom(1, 3000);
+	TestRandom(2, 3000);
+	return TestResult("TangramXmlParseTest");
+}
@@ -0,0 +1,36 @@
+// TestCheck.h : the few checks the headless tests need, no framework
+//
+// Every test is one executable; main() runs the cases and returns
+// TestResult(), so make stops at the first failing test program.
+
+#pragma once
+
+#include <stdio.h>
+
+static int g_nTestChecks = 0;
+static int g_nTestFailures = 0;
+
+#define CHECK(expr) \
+	do { \
+		g_nTestChecks++; \
+		if (!(expr)) { \
+			g_nTestFailures++; \
+			fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #expr); \
+		} \
+	} while (0)
+
+#define CHECK_EQ(a, b) \
+	do { \
+		g_nTestChecks++; \
+		long long _a = (long long)(a), _b = (long long)(b); \
+		if (_a != _b) { \
+			g_nTestFailures++; \
+			fprintf(stderr, "%s:%d: CHECK_EQ(%s, %s) failed: %lld != %lld\n", __FILE__, __LINE__, #a, #b, _a, _b); \
+		} \
+	} while (0)
+
+static inline int TestResult(const char* pszName)
+{
+	printf("%s: %d checks, %d failed\n", pszName, g_nTestChecks, g_nTestFailures);
+	return g_nTestFailures ? 1 : 0;
+}
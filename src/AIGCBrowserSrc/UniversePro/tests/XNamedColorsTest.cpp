@@ -0,0 +1,418 @@
+// XNamedColorsTest.cpp : the perfect hash lookups against the linear scans
+// they replaced
+//
+// The color names of CXNamedColors, the tag names CPPHtmlDrawer looks up
+// through a CXPerfectHashMap over its std::map, and the entity names of
+// CXCharEntities, which replaced one _tcsistrrep pass per entity.
+//
+// "XNamedColorsTest bench" times each lookup against the one it replaced
+// instead; make bench builds it optimized and without the sanitizers.
+
+#include "stdafx.h"
+#include "XNamedColors.h"
+#include "XPerfectHash.h"
+#include "XCharEntities.h"
+#include "XString.h"
+#include "TestCheck.h"
+
+#include <chrono>
+#include <random>
+#include <thread>
+
+static vector<string> GetColorNames()
+{
+	vector<string> vNames;
+	CXNamedColors color;
+	TCHAR szName[100];
+	for (int i = 0; ; i++)
+	{
+		szName[0] = 0;
+		color.GetColorNameByIndex(i, szName, 100);
+		if (szName[0] == 0)
+			break;
+		vNames.push_back(szName);
+	}
+	return vNames;
+}
+
+// CXNamedColors::SetName before the index: the first case-insensitive match
+static COLORREF LinearColor(const vector<string>& vNames, LPCTSTR lpszName)
+{
+	CXNamedColors color;
+	for (size_t i = 0; i < vNames.size(); i++)
+	{
+		if (_tcsicmp(vNames[i].c_str(), lpszName) == 0)
+			return color.GetColorByIndex((int)i);
+	}
+	return RGB(0, 0, 0);
+}
+
+static int LinearFind(const vector<LPCTSTR>& vNames, LPCTSTR lpszName, int nLen, bool bIgnoreCase)
+{
+	for (size_t i = 0; i < vNames.size(); i++)
+	{
+		if ((int)_tcslen(vNames[i]) == nLen && (bIgnoreCase ? _tcsnicmp(vNames[i], lpszName, nLen) : _tcsncmp(vNames[i], lpszName, nLen)) == 0)
+			return (int)i;
+	}
+	return -1;
+}
+
+static void TestConcurrentFirstUse(const vector<string>& vNames)
+{
+	// the index is built on first use; every thread must see it complete
+	vector<thread> vThreads;
+	vector<int> vWrong(8, 0);
+	for (int t = 0; t < 8; t++)
+	{
+		vThreads.push_back(thread([&vNames, &vWrong, t]()
+			{
+				for (size_t i = t; i < vNames.size(); i += 3)
+				{
+					CXNamedColors color(vNames[i].c_str());
+					if (color.GetRGB() != LinearColor(vNames, vNames[i].c_str()))
+						vWrong[t]++;
+				}
+			}));
+	}
+	for (auto& it : vThreads)
+		it.join();
+	for (int t = 0; t < 8; t++)
+		CHECK_EQ(vWrong[t], 0);
+}
+
+static void TestColorNames(const vector<string>& vNames)
+{
+	CHECK(vNames.size() > 140);
+	for (auto& strName : vNames)
+	{
+		string strUpper = strName, strLower = strName;
+		for (auto& c : strUpper)
+			c = (char)toupper((unsigned char)c);
+		for (auto& c : strLower)
+			c = (char)tolower((unsigned char)c);
+		for (const string& str : { strName, strUpper, strLower })
+		{
+			CXNamedColors color;
+			color.SetName(str.c_str());
+			CHECK_EQ(color.GetRGB(), LinearColor(vNames, str.c_str()));
+			color.SetColorFromString(str.c_str());
+			CHECK_EQ(color.GetRGB(), LinearColor(vNames, str.c_str()));
+		}
+		// near misses resolve to nothing, as in the scan
+		for (const string& str : { strName + "x", strName.substr(0, strName.size() - 1), string(" ") + strName })
+		{
+			CXNamedColors color;
+			color.SetName(str.c_str());
+			CHECK_EQ(color.GetRGB(), LinearColor(vNames, str.c_str()));
+		}
+	}
+	CXNamedColors color;
+	color.SetName("");
+	CHECK_EQ(color.GetRGB(), RGB(0, 0, 0));
+	color.SetColorFromString("#0000FF");
+	CHECK_EQ(color.GetRGB(), RGB(0, 0, 255));
+	color.SetColorFromString("255,0,0");
+	CHECK_EQ(color.GetRGB(), RGB(255, 0, 0));
+}
+
+static void TestRandomSets()
+{
+	// random tables with duplicates, both case modes, probes in and out of the set
+	mt19937 rng(20261019);
+	uniform_int_distribution<int> length(1, 12), letter(0, 51), pick(0, 3);
+	const char* pszLetters = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ";
+	for (int nRound = 0; nRound < 200; nRound++)
+	{
+		int nCount = 1 + nRound * 3;
+		vector<string> vStore;
+		for (int i = 0; i < nCount; i++)
+		{
+			if (i && pick(rng) == 0)
+				vStore.push_back(vStore[rng() % vStore.size()]);
+			else
+			{
+				string str(length(rng), ' ');
+				for (auto& c : str)
+					c = pszLetters[letter(rng)];
+				vStore.push_back(str);
+			}
+		}
+		vector<LPCTSTR> vNames;
+		for (auto& str : vStore)
+			vNames.push_back(str.c_str());
+
+		for (bool bIgnoreCase : { true, false })
+		{
+			CXPerfectHash index;
+			CHECK(index.Build(&vNames[0], nCount, bIgnoreCase));
+			for (int i = 0; i < nCount; i++)
+			{
+				string strProbe = vStore[i];
+				CHECK_EQ(index.Find(strProbe.c_str()), LinearFind(vNames, strProbe.c_str(), (int)strProbe.size(), bIgnoreCase));
+				strProbe[0] = (char)(islower((unsigned char)strProbe[0]) ? toupper((unsigned char)strProbe[0]) : tolower((unsigned char)strProbe[0]));
+				CHECK_EQ(index.Find(strProbe.c_str()), LinearFind(vNames, strProbe.c_str(), (int)strProbe.size(), bIgnoreCase));
+				strProbe += "q";
+				// unterminated probes, as XHtmlDraw passes them
+				CHECK_EQ(index.Find(strProbe.c_str(), (int)strProbe.size() - 1), LinearFind(vNames, strProbe.c_str(), (int)strProbe.size() - 1, bIgnoreCase));
+				CHECK_EQ(index.Find(strProbe.c_str()), LinearFind(vNames, strProbe.c_str(), (int)strProbe.size(), bIgnoreCase));
+			}
+		}
+	}
+	CXPerfectHash empty;
+	CHECK(empty.IsEmpty());
+	CHECK_EQ(empty.Find("red"), -1);
+}
+
+// the tags of CPPHtmlDrawer::m_mapTags, keyed by name
+typedef std::map<CString, int> mapTags;
+
+static void CheckTags(mapTags& tags, CXPerfectHashMap<mapTags>& index, const string& strName)
+{
+	mapTags::iterator iter = tags.find(strName.c_str());
+	CHECK(index.Find(tags, strName.c_str(), (int)strName.size()) == iter);
+	// unterminated, as GetTagFromList passes the name after a '/'
+	string strLonger = strName + "x";
+	CHECK(index.Find(tags, strLonger.c_str(), (int)strName.size()) == iter);
+}
+
+static void TestTags()
+{
+	mt19937 rng(33);
+	uniform_int_distribution<int> length(1, 8), letter(0, 51);
+	const char* pszLetters = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ";
+	auto MakeName = [&]()
+	{
+		string str(length(rng), ' ');
+		for (auto& c : str)
+			c = pszLetters[letter(rng)];
+		return str;
+	};
+
+	mapTags tags;
+	CXPerfectHashMap<mapTags> index;
+	CHECK(index.Find(tags, "b", 1) == tags.end());
+
+	// the default tags of CPPHtmlDrawer and then random ones, added in
+	// batches as AddTagToList does, each batch invalidating the index
+	vector<string> vNames = { "b", "i", "u", "s", "font", "hr", "br", "t", "left", "center", "right", "justify", "baseline", "top", "vcenter", "bottom", "bmp", "icon", "ilst", "string", "a", "body", "table", "tr", "td", "span", "div", "p", "h1", "h2", "h3", "h4", "h5", "h6" };
+	for (int nRound = 0; nRound < 60; nRound++)
+	{
+		for (auto& strName : vNames)
+			tags[strName.c_str()] = nRound;
+		index.Invalidate();
+		for (auto& strName : vNames)
+		{
+			CheckTags(tags, index, strName);
+			string strCase = strName;
+			strCase[0] = (char)(isupper((unsigned char)strCase[0]) ? tolower((unsigned char)strCase[0]) : toupper((unsigned char)strCase[0]));
+			CheckTags(tags, index, strCase);		// case-sensitive, like the map
+			CheckTags(tags, index, strName.substr(0, strName.size() - 1));
+			CheckTags(tags, index, strName + "1");
+		}
+		for (int i = 0; i < 50; i++)
+			CheckTags(tags, index, MakeName());
+		vNames.clear();
+		for (int i = 0; i < 1 + nRound; i++)
+			vNames.push_back(MakeName());
+		// an index that is not invalidated keeps what it had
+		if (nRound % 10 == 0)
+		{
+			string strNew = "new" + to_string(nRound);
+			tags[strNew.c_str()] = nRound;
+			CHECK(index.Find(tags, strNew.c_str(), (int)strNew.size()) == tags.end());
+			tags.erase(strNew.c_str());
+		}
+	}
+}
+
+// CXHtmlDraw before the index: one _tcsistrrep pass per entity, with the
+// two-character code (bCodes) or the symbol
+static void OldReplaceNames(TCHAR* buf, BOOL bCodes)
+{
+	size_t buflen = _tcslen(buf) + 100;
+	vector<TCHAR> vWork(buflen, 0);
+	for (int i = 0; i < CXCharEntities::GetCount(); i++)
+	{
+		TCHAR ent[3] = { _T('\001'), CXCharEntities::GetCode(i), _T('\0') };
+		if (!bCodes)
+		{
+			ent[0] = CXCharEntities::GetSymbol(CXCharEntities::GetCode(i));
+			ent[1] = _T('\0');
+		}
+		int nRep = _tcsistrrep(buf, CXCharEntities::GetName(i), ent, &vWork[0]);
+		if (nRep > 0)
+			_tcscpy(buf, &vWork[0]);
+	}
+}
+
+// CXHtmlDraw::ReplaceCharEntities
+static string DecodeCodes(const string& str)
+{
+	string strResult;
+	for (size_t i = 0; i < str.size(); i++)
+	{
+		if (str[i] == '\001' && i + 1 < str.size())
+			strResult += CXCharEntities::GetSymbol(str[++i]);
+		else
+			strResult += str[i];
+	}
+	return strResult;
+}
+
+static string MakeEntityText(mt19937& rng, int nTokens)
+{
+	static const char* const s_pszNoise[] = { "&", ";", "&;", "&#", "a", "x", " ", "<b>", "1", "&&", ";;", "&amp", "lt;", "q;" };
+	string str;
+	for (int i = 0; i < nTokens; i++)
+	{
+		int nKind = (int)(rng() % 4);
+		if (nKind == 0)
+			str += s_pszNoise[rng() % (sizeof(s_pszNoise) / sizeof(s_pszNoise[0]))];
+		else
+		{
+			string strName = CXCharEntities::GetName((int)(rng() % CXCharEntities::GetCount()));
+			if (nKind == 1)
+			{
+				for (auto& c : strName)
+					c = (char)((rng() % 2) ? toupper((unsigned char)c) : c);
+			}
+			else if (nKind == 2)
+				strName.erase(1 + rng() % (strName.size() - 1), 1);		// a near miss
+			str += strName;
+		}
+	}
+	return str;
+}
+
+static void TestEntities()
+{
+	// every name, in both cases, and every code back to its symbol
+	CHECK_EQ(CXCharEntities::GetCount(), 24);
+	CHECK(CXCharEntities::GetName(CXCharEntities::GetCount()) == NULL);
+	CHECK(CXCharEntities::GetName(-1) == NULL);
+	for (int i = 0; i < CXCharEntities::GetCount(); i++)
+	{
+		string strName = CXCharEntities::GetName(i);
+		for (auto& c : strName)
+			c = (char)toupper((unsigned char)c);
+		vector<char> vBuf(strName.begin(), strName.end());
+		vBuf.push_back(0);
+		CXCharEntities::ReplaceNames(&vBuf[0], true);
+		CHECK_EQ(strlen(&vBuf[0]), 2);
+		CHECK_EQ(vBuf[0], '\001');
+		CHECK_EQ(vBuf[1], CXCharEntities::GetCode(i));
+		CHECK(CXCharEntities::GetCode(i) > 1);
+	}
+	CHECK_EQ(CXCharEntities::GetSymbol(CXCharEntities::GetCode(0)), '&');
+	CHECK_EQ(CXCharEntities::GetSymbol(0), ' ');
+	CHECK_EQ(CXCharEntities::GetSymbol(1), ' ');
+	CHECK_EQ(CXCharEntities::GetSymbol(CXCharEntities::GetCode(CXCharEntities::GetCount())), ' ');
+
+	mt19937 rng(1033);
+	for (int n = 0; n < 20000; n++)
+	{
+		string strText = MakeEntityText(rng, (int)(rng() % 24));
+		vector<char> vOld(strText.begin(), strText.end()), vNew;
+		vOld.push_back(0);
+		vNew = vOld;
+
+		// with codes, which cannot make up a name, every pass of the old
+		// loop sees only the text
+		OldReplaceNames(&vOld[0], true);
+		CXCharEntities::ReplaceNames(&vNew[0], true);
+		CHECK(strcmp(&vOld[0], &vNew[0]) == 0);
+		string strCodes = &vNew[0];
+
+		// with symbols the old loop decoded "&amp;lt;" twice, the new one
+		// decodes every name once, which is what the codes decode to
+		vOld.assign(strText.begin(), strText.end());
+		vOld.push_back(0);
+		vNew = vOld;
+		OldReplaceNames(&vOld[0], false);
+		CXCharEntities::ReplaceNames(&vNew[0], false);
+		CHECK(DecodeCodes(strCodes) == &vNew[0]);
+		if (!_tcsistr(strText.c_str(), "&amp;"))
+			CHECK(strcmp(&vOld[0], &vNew[0]) == 0);
+	}
+
+	char szChained[] = "&amp;lt;";
+	CXCharEntities::ReplaceNames(szChained, false);
+	CHECK(strcmp(szChained, "&lt;") == 0);
+	char szNone[] = "no entities; at all";
+	CXCharEntities::ReplaceNames(szNone, false);
+	CHECK(strcmp(szNone, "no entities; at all") == 0);
+}
+
+template <class F>
+static double Time(F f)
+{
+	double dBest = 1e30;
+	for (int nRound = 0; nRound < 7; nRound++)
+	{
+		auto start = chrono::steady_clock::now();
+		for (int i = 0; i < 200; i++)
+			f();
+		double dMicros = chrono::duration<double, micro>(chrono::steady_clock::now() - start).count() / 200;
+		dBest = min(dBest, dMicros);
+	}
+	return dBest;
+}
+
+static volatile size_t s_nSink;
+
+static void Bench(const vector<string>& vNames)
+{
+	printf("microseconds old -> new\n");
+
+	// every color name once, in lower case
+	vector<string> vLower = vNames;
+	for (auto& str : vLower)
+	{
+		for (auto& c : str)
+			c = (char)tolower((unsigned char)c);
+	}
+	double dOld = Time([&]() { for (auto& str : vLower) s_nSink += LinearColor(vNames, str.c_str()); });
+	double dNew = Time([&]() { for (auto& str : vLower) { CXNamedColors color; color.SetName(str.c_str()); s_nSink += color.GetRGB(); } });
+	printf("  %zu color names        %10.2f -> %8.2f\n", vNames.size(), dOld, dNew);
+
+	// the tags of a tooltip, looked up in 34 tags
+	mapTags tags;
+	vector<string> vTags = { "b", "i", "u", "s", "font", "hr", "br", "t", "left", "center", "right", "justify", "baseline", "top", "vcenter", "bottom", "bmp", "icon", "ilst", "string", "a", "body", "table", "tr", "td", "span", "div", "p", "h1", "h2", "h3", "h4", "h5", "h6" };
+	for (size_t i = 0; i < vTags.size(); i++)
+		tags[vTags[i].c_str()] = (int)i;
+	CXPerfectHashMap<mapTags> index;
+	vector<string> vProbes;
+	mt19937 rng(7);
+	for (int i = 0; i < 1000; i++)
+		vProbes.push_back(vTags[rng() % vTags.size()]);
+	dOld = Time([&]() { for (auto& str : vProbes) s_nSink += tags.find(str.c_str())->second; });
+	dNew = Time([&]() { for (auto& str : vProbes) s_nSink += index.Find(tags, str.c_str(), (int)str.size())->second; });
+	printf("  1000 tag lookups       %10.2f -> %8.2f\n", dOld, dNew);
+
+	// entity names in 8 KB of text
+	string strText;
+	while (strText.size() < 8192)
+		strText += MakeEntityText(rng, 8) + " some plain text between the entities ";
+	vector<char> vWork(strText.size() + 1);
+	auto Load = [&]() { memcpy(&vWork[0], strText.c_str(), strText.size() + 1); };
+	dOld = Time([&]() { Load(); OldReplaceNames(&vWork[0], true); s_nSink += vWork[0]; });
+	dNew = Time([&]() { Load(); CXCharEntities::ReplaceNames(&vWork[0], true); s_nSink += vWork[0]; });
+	printf("  entities in %zu bytes %10.2f -> %8.2f\n", strText.size(), dOld, dNew);
+}
+
+int main(int argc, char* argv[])
+{
+	vector<string> vNames = GetColorNames();
+	if (argc > 1 && strcmp(argv[1], "bench") == 0)
+	{
+		Bench(vNames);
+		return 0;
+	}
+
+	TestConcurrentFirstUse(vNames);
+	TestColorNames(vNames);
+	TestRandomSets();
+	TestTags();
+	TestEntities();
+	return TestResult("XNamedColorsTest");
+}
@@ -0,0 +1,466 @@
+// XStringAlgoTest.cpp : XStringAlgo.cpp against the XString code it replaced
+//
+// The previous _tcsistr, _tcsistrrem, _tcsistrrep, _tcsccnt and _tcscrem
+// are kept below as they were, for char and wchar_t, and random strings are
+// run through them and through the new routines: the narrow XString.cpp
+// functions, which forward to XStringAlgo.cpp, and the wide XStrI* overloads
+// the wide build forwards to. The alphabet keeps matches frequent and sits
+// on both sides of A-Z and a-z, and buffers start at every offset of an SSE2
+// block.
+//
+// "XStringAlgoTest bench" times both on a few KB of HTML-like text instead;
+// make bench builds it optimized and without the sanitizers.
+
+#include "stdafx.h"
+#include "XString.h"
+#include "XStringAlgo.h"
+#include "TestCheck.h"
+
+#include <chrono>
+#include <random>
+
+// _tcsnicmp in the "C" locale: A-Z only
+template <class T>
+static T OldFold(T c)
+{
+	return (c >= 'A' && c <= 'Z') ? (T)(c + ('a' - 'A')) : c;
+}
+
+template <class T>
+static int OldNICmp(const T* p1, const T* p2, size_t nLen)
+{
+	for (size_t i = 0; i < nLen; i++)
+	{
+		T c1 = OldFold(p1[i]), c2 = OldFold(p2[i]);
+		if (c1 != c2)
+			return c1 < c2 ? -1 : 1;
+		if (c1 == 0)
+			break;
+	}
+	return 0;
+}
+
+template <class T>
+static size_t OldLen(const T* p)
+{
+	size_t n = 0;
+	while (p[n])
+		n++;
+	return n;
+}
+
+template <class T>
+static T* OldIStr(const T* str, const T* substr)
+{
+	if (!str || !substr || (substr[0] == 0))
+		return (T*)str;
+
+	size_t nLen = OldLen(substr);
+	while (*str)
+	{
+		if (OldNICmp(str, substr, nLen) == 0)
+			break;
+		str++;
+	}
+
+	if (*str == 0)
+		str = NULL;
+
+	return (T*)str;
+}
+
+// _tcscpy(target, target + nSubstrLen) as the overlapping copy it meant
+template <class T>
+static T* OldIStrRem(T* str, const T* substr)
+{
+	if (!str || !substr)
+		return str;
+
+	T* target = NULL;
+	size_t nSubstrLen = OldLen(substr);
+	T* cp = str;
+	while ((target = OldIStr(cp, substr)) != NULL)
+	{
+		memmove(target, target + nSubstrLen, (OldLen(target + nSubstrLen) + 1) * sizeof(T));
+		cp = target;
+	}
+
+	return str;
+}
+
+template <class T>
+static int OldIStrRep(const T* lpszStr, const T* lpszOld, const T* lpszNew, T* lpszResult)
+{
+	if (!lpszStr || !lpszOld || !lpszNew)
+		return 0;
+	size_t nStrLen = OldLen(lpszStr);
+	if (nStrLen == 0)
+		return 0;
+	size_t nOldLen = OldLen(lpszOld);
+	if (nOldLen == 0)
+		return 0;
+	size_t nNewLen = OldLen(lpszNew);
+
+	// loop once to figure out the size of the result string
+	int nCount = 0;
+	const T* pszStart = lpszStr;
+	const T* pszEnd = lpszStr + nStrLen;
+	const T* pszTarget = NULL;
+	T* pszResultStr = NULL;
+
+	while (pszStart < pszEnd)
+	{
+		while ((pszTarget = OldIStr(pszStart, lpszOld)) != NULL)
+		{
+			nCount++;
+			pszStart = pszTarget + nOldLen;
+		}
+		pszStart += OldLen(pszStart);
+	}
+
+	if (nCount > 0)
+	{
+		size_t nResultStrSize = nStrLen + (nNewLen - nOldLen) * nCount + 2;
+		pszResultStr = new T[nResultStrSize];
+		memset(pszResultStr, 0, nResultStrSize * sizeof(T));
+
+		pszStart = lpszStr;
+		T* cp = pszResultStr;
+		while (pszStart < pszEnd)
+		{
+			while ((pszTarget = OldIStr(pszStart, lpszOld)) != NULL)
+			{
+				size_t nCopyLen = (size_t)(pszTarget - pszStart);
+				memcpy(cp, pszStart, nCopyLen * sizeof(T));
+				cp += nCopyLen;
+				pszStart = pszTarget + nOldLen;
+				memcpy(cp, lpszNew, nNewLen * sizeof(T));
+				cp += nNewLen;
+			}
+			size_t nRest = OldLen(pszStart);
+			memcpy(cp, pszStart, (nRest + 1) * sizeof(T));
+			pszStart += nRest;
+		}
+
+		if (lpszResult)
+			memcpy(lpszResult, pszResultStr, (OldLen(pszResultStr) + 1) * sizeof(T));
+	}
+
+	int nSize = 0;
+	if (pszResultStr)
+	{
+		nSize = (int)OldLen(pszResultStr);
+		delete[] pszResultStr;
+	}
+	return nSize;
+}
+
+template <class T>
+static int OldCCnt(const T* str, T ch)
+{
+	int count = 0;
+	while (*str)
+	{
+		if (*str++ == ch)
+			count++;
+	}
+	return count;
+}
+
+template <class T>
+static T* OldCRem(T* str, T ch)
+{
+	T* cp1 = str;
+	T* cp2 = str;
+	while (*cp2)
+	{
+		if (*cp2 != ch)
+			*cp1++ = *cp2;
+		cp2++;
+	}
+	*cp1 = 0;
+	return str;
+}
+
+// The new code, narrow through XString.cpp as the application calls it and
+// wide through the overloads XString.cpp calls in a UNICODE build, wrapped
+// the way XString.cpp wraps them.
+static char* NewIStr(const char* str, const char* substr) { return _tcsistr(str, substr); }
+static char* NewIStrRem(char* str, const char* substr) { return _tcsistrrem(str, substr); }
+static int NewIStrRep(const char* str, const char* pOld, const char* pNew, char* pResult) { return _tcsistrrep(str, pOld, pNew, pResult); }
+static int NewCCnt(const char* str, char ch) { return _tcsccnt(str, ch); }
+static char* NewCRem(char* str, char ch) { return _tcscrem(str, ch); }
+
+static wchar_t* NewIStr(const wchar_t* str, const wchar_t* substr)
+{
+	if (substr[0] == 0)
+		return (wchar_t*)str;
+	return (wchar_t*)XStrIFind(str, wcslen(str), substr, wcslen(substr));
+}
+
+static wchar_t* NewIStrRem(wchar_t* str, const wchar_t* substr)
+{
+	str[XStrIRemove(str, wcslen(str), substr, wcslen(substr))] = 0;
+	return str;
+}
+
+static int NewIStrRep(const wchar_t* str, const wchar_t* pOld, const wchar_t* pNew, wchar_t* pResult)
+{
+	size_t nStrLen = wcslen(str), nOldLen = wcslen(pOld);
+	if (nStrLen == 0 || nOldLen == 0)
+		return 0;
+	size_t nCount = 0;
+	size_t nSize = XStrIReplace(str, nStrLen, pOld, nOldLen, pNew, wcslen(pNew), NULL, &nCount);
+	if (nCount == 0)
+		return 0;
+	if (pResult)
+	{
+		size_t nCount2 = 0;
+		CHECK_EQ(XStrIReplace(str, nStrLen, pOld, nOldLen, pNew, wcslen(pNew), pResult, &nCount2), nSize);
+		CHECK_EQ(nCount2, nCount);
+		pResult[nSize] = 0;
+	}
+	CHECK_EQ(XStrICount(str, nStrLen, pOld, nOldLen), nCount);
+	return (int)nSize;
+}
+
+static int NewCCnt(const wchar_t* str, wchar_t ch) { return (int)XStrCount(str, wcslen(str), ch); }
+
+static wchar_t* NewCRem(wchar_t* str, wchar_t ch)
+{
+	str[XStrRemove(str, wcslen(str), ch)] = 0;
+	return str;
+}
+
+template <class T>
+struct Alphabet;
+
+template <>
+struct Alphabet<char>
+{
+	static vector<char> Get() { return { 'a', 'A', 'b', 'B', 'z', 'Z', '@', '[', '`', '{', '<', '/', (char)0xC4, (char)0xE4, (char)0xC1, (char)0xE1 }; }
+};
+
+// the low byte of most of these folds as A-Z would
+template <>
+struct Alphabet<wchar_t>
+{
+	static vector<wchar_t> Get() { return { L'a', L'A', L'b', L'B', L'z', L'Z', L'@', L'[', L'`', L'{', L'<', 0x0141, 0x0161, 0xFF21, 0xFF41, 0x4142, 0x00C4, 0x00E4 }; }
+};
+
+template <class T>
+static basic_string<T> RandomString(std::mt19937& rng, size_t nLen, size_t nLetters)
+{
+	static const vector<T> vAlphabet = Alphabet<T>::Get();
+	nLetters = min(nLetters, vAlphabet.size());
+	basic_string<T> str;
+	for (size_t i = 0; i < nLen; i++)
+		str += vAlphabet[rng() % nLetters];
+	return str;
+}
+
+// a piece of str with its case flipped here and there, so it is found
+template <class T>
+static basic_string<T> PieceOf(std::mt19937& rng, const basic_string<T>& str, size_t nLen)
+{
+	if (str.size() < nLen)
+		return str;
+	basic_string<T> strPiece = str.substr(rng() % (str.size() - nLen + 1), nLen);
+	for (T& c : strPiece)
+	{
+		if (rng() % 2 == 0)
+			c = (c >= 'a' && c <= 'z') ? (T)(c - 32) : (c >= 'A' && c <= 'Z') ? (T)(c + 32) : c;
+	}
+	return strPiece;
+}
+
+static int s_nDiffs;
+
+template <class T>
+static void Compare(const basic_string<T>& str, const basic_string<T>& strSub, const basic_string<T>& strNew, size_t nOffset)
+{
+	// the string at nOffset of a buffer, with room behind it for any result
+	size_t nRoom = str.size() * (strNew.size() + 1) + 64;
+	vector<T> vOld(nOffset + nRoom), vNew(nOffset + nRoom);
+	T* pOld = &vOld[nOffset];
+	T* pNew = &vNew[nOffset];
+	auto Load = [&]() {
+		memcpy(pOld, str.c_str(), (str.size() + 1) * sizeof(T));
+		memcpy(pNew, str.c_str(), (str.size() + 1) * sizeof(T));
+	};
+
+	Load();
+	T* pFoundOld = OldIStr(pOld, strSub.c_str());
+	T* pFoundNew = NewIStr(pNew, strSub.c_str());
+	if ((pFoundOld ? pFoundOld - pOld : -1) != (pFoundNew ? pFoundNew - pNew : -1))
+		s_nDiffs++;
+
+	// the old remove never returned for an empty substring
+	if (!strSub.empty())
+	{
+		OldIStrRem(pOld, strSub.c_str());
+		NewIStrRem(pNew, strSub.c_str());
+		if (basic_string<T>(pOld) != basic_string<T>(pNew))
+			s_nDiffs++;
+	}
+
+	// the size alone, then the result, and nothing written without a match
+	Load();
+	vector<T> vOldResult(nRoom, (T)'#'), vNewResult(nRoom, (T)'#');
+	int nOldSize = OldIStrRep(pOld, strSub.c_str(), strNew.c_str(), (T*)NULL);
+	int nNewSize = NewIStrRep(pNew, strSub.c_str(), strNew.c_str(), (T*)NULL);
+	if (nOldSize != nNewSize ||
+		OldIStrRep(pOld, strSub.c_str(), strNew.c_str(), &vOldResult[0]) != nOldSize ||
+		NewIStrRep(pNew, strSub.c_str(), strNew.c_str(), &vNewResult[0]) != nNewSize ||
+		vOldResult != vNewResult)
+		s_nDiffs++;
+
+	T ch = strSub.empty() ? (T)'a' : strSub[0];
+	if (OldCCnt(pOld, ch) != NewCCnt(pNew, ch))
+		s_nDiffs++;
+	OldCRem(pOld, ch);
+	NewCRem(pNew, ch);
+	if (basic_string<T>(pOld) != basic_string<T>(pNew))
+		s_nDiffs++;
+}
+
+template <class T>
+static void TestRandom(unsigned nSeed, int nCases)
+{
+	std::mt19937 rng(nSeed);
+	s_nDiffs = 0;
+	for (int nCase = 0; nCase < nCases; nCase++)
+	{
+		size_t nLen = rng() % 8 == 0 ? 200 + rng() % 3000 : rng() % 80;
+		size_t nLetters = 2 + rng() % 16;
+		basic_string<T> str = RandomString<T>(rng, nLen, nLetters);
+		size_t nSubLen = 1 + rng() % (rng() % 4 == 0 ? 40 : 6);
+		basic_string<T> strSub = rng() % 2 ? PieceOf(rng, str, nSubLen) : RandomString<T>(rng, nSubLen, nLetters);
+		basic_string<T> strNew = RandomString<T>(rng, rng() % 10, nLetters);
+		Compare(str, strSub, strNew, rng() % 17);
+	}
+	CHECK_EQ(s_nDiffs, 0);
+}
+
+// the cases that bit string routines before
+template <class T>
+static void TestEdges()
+{
+	auto S = [](const char* psz) {
+		basic_string<T> str;
+		for (; *psz; psz++)
+			str += (T)(unsigned char)*psz;
+		return str;
+	};
+	const char* pszStrings[] = { "", "a", "A", "aaaa", "aAaAaAaAaAaAaAaAaAaAaAaAaAaAaAaAaA", "abcabcab", "xyzXYZ@[`{",
+		"0123456789abcdef0123456789ABCDEF0123456789abcdef", "<td><TD></Td>", "ababababababababababababababababa" };
+	const char* pszSubs[] = { "", "a", "A", "aa", "aaa", "abc", "ABCA", "@", "[", "`", "{", "fedcba", "</td>", "aba", "bab" };
+	const char* pszNews[] = { "", "X", "aa", "<BR>" };
+	s_nDiffs = 0;
+	for (const char* pszString : pszStrings)
+	{
+		for (const char* pszSub : pszSubs)
+		{
+			for (const char* pszNew : pszNews)
+			{
+				for (size_t nOffset = 0; nOffset < 16; nOffset++)
+					Compare(S(pszString), S(pszSub), S(pszNew), nOffset);
+			}
+		}
+	}
+	CHECK_EQ(s_nDiffs, 0);
+
+	// NULL arguments
+	CHECK(_tcsistr(NULL, "a") == NULL);
+	CHECK(_tcsistrrem(NULL, "a") == NULL);
+	CHECK_EQ(_tcsistrrep(NULL, "a", "b", NULL), 0);
+	CHECK_EQ(_tcsistrrep("a", NULL, "b", NULL), 0);
+	CHECK_EQ(_tcsistrrep("a", "a", NULL, NULL), 0);
+}
+
+// _tcsistrrep into the buffer it reads from
+static void TestOverlap()
+{
+	char szBuffer[64] = "one Two three TWO";
+	CHECK_EQ(_tcsistrrep(szBuffer, "two", "2", szBuffer), 13);
+	CHECK(strcmp(szBuffer, "one 2 three 2") == 0);
+
+	char szGrow[64] = "a-A-a";
+	CHECK_EQ(_tcsistrrep(szGrow, "a", "<a>", szGrow + 1), 11);
+	CHECK(strcmp(szGrow + 1, "<a>-<a>-<a>") == 0);
+}
+
+// timings on a few KB of markup, best of several rounds
+static string MakeHtml(size_t nSize)
+{
+	static const char* const pszRows[] = { "<tr><td class=\"name\">Item %d</td><td>%d</td></tr>\n",
+		"<TR><TD CLASS=\"value\">&nbsp;%d &amp; more</TD><td>%d</td></TR>\n" };
+	string strHtml = "<html><body><table>\n";
+	char szRow[128];
+	for (int n = 0; strHtml.size() < nSize; n++)
+	{
+		snprintf(szRow, sizeof(szRow), pszRows[n % 2], n, n * 7);
+		strHtml += szRow;
+	}
+	return strHtml + "</table></body></html>";
+}
+
+template <class F>
+static double Time(F f)
+{
+	double dBest = 1e30;
+	for (int nRound = 0; nRound < 7; nRound++)
+	{
+		auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < 200; i++)
+			f();
+		double dMicros = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / 200;
+		dBest = min(dBest, dMicros);
+	}
+	return dBest;
+}
+
+static volatile size_t s_nSink;
+
+static void Bench()
+{
+	for (size_t nSize : { 2048, 8192, 65536 })
+	{
+		string strHtml = MakeHtml(nSize);
+		vector<char> vWork(strHtml.size() * 4 + 1);
+		auto Load = [&]() { memcpy(&vWork[0], strHtml.c_str(), strHtml.size() + 1); };
+		printf("%zu bytes of markup, microseconds old -> new\n", strHtml.size());
+
+		double dOld = Time([&]() { s_nSink += (size_t)OldIStr(strHtml.c_str(), "</tbody>"); });
+		double dNew = Time([&]() { s_nSink += (size_t)NewIStr(strHtml.c_str(), "</tbody>"); });
+		printf("  _tcsistr, no match     %10.2f -> %8.2f\n", dOld, dNew);
+		dOld = Time([&]() { s_nSink += OldIStrRep(strHtml.c_str(), "</td>", "</th>", &vWork[0]); });
+		dNew = Time([&]() { s_nSink += NewIStrRep(strHtml.c_str(), "</td>", "</th>", &vWork[0]); });
+		printf("  _tcsistrrep            %10.2f -> %8.2f\n", dOld, dNew);
+		dOld = Time([&]() { Load(); s_nSink += (size_t)OldIStrRem(&vWork[0], "&nbsp;"); });
+		dNew = Time([&]() { Load(); s_nSink += (size_t)NewIStrRem(&vWork[0], "&nbsp;"); });
+		printf("  _tcsistrrem            %10.2f -> %8.2f\n", dOld, dNew);
+		dOld = Time([&]() { s_nSink += OldCCnt(strHtml.c_str(), '<'); });
+		dNew = Time([&]() { s_nSink += NewCCnt(strHtml.c_str(), '<'); });
+		printf("  _tcsccnt               %10.2f -> %8.2f\n", dOld, dNew);
+		dOld = Time([&]() { Load(); s_nSink += (size_t)OldCRem(&vWork[0], '\n'); });
+		dNew = Time([&]() { Load(); s_nSink += (size_t)NewCRem(&vWork[0], '\n'); });
+		printf("  _tcscrem, sparse       %10.2f -> %8.2f\n", dOld, dNew);
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc > 1 && strcmp(argv[1], "bench") == 0)
+	{
+		Bench();
+		return 0;
+	}
+
+	TestEdges<char>();
+	TestEdges<wchar_t>();
+	TestRandom<char>(1, 20000);
+	TestRandom<wchar_t>(2, 20000);
+	TestOverlap();
+	return TestResult("XStringAlgoTest");
+}
@@ -0,0 +1,186 @@
+// XTraceSinkTest.cpp : every traced line reaches the log once, in call order
+//
+// Producers are stalled between taking a sequence number and putting the
+// record (the XTRACE_TESTHOOKS hook), the window in which the flusher used
+// to write later lines ahead of the stalled one. Small rings make threads
+// wait for the flusher and split long messages over several records.
+
+#include "stdafx.h"
+#include "XTraceSink.h"
+#include "TestCheck.h"
+#include <set>
+#include <thread>
+
+static const char* const s_pszLog = "out/XTraceSinkTest.log";
+static const int TEST_THREADS = 8;
+static const int TEST_LINES = 2000;
+static const int TEST_LONG_EVERY = 50;		// every n-th line is longer than a ring part
+
+static void StallSome(uint64_t nSeq)
+{
+	if (nSeq % 7 == 0)
+		std::this_thread::sleep_for(std::chrono::microseconds(300));
+}
+
+static string LongTail(int nThread, int nLine)
+{
+	return string(3000 + nThread * 7 + nLine % 13, (char)('a' + nLine % 26)) + "|end";
+}
+
+static void Trace(int nThread, int nLine)
+{
+	char szHead[64];
+	snprintf(szHead, sizeof(szHead), "T%d L%d ", nThread, nLine);
+	string strMessage = szHead;
+	if (nLine % TEST_LONG_EVERY == 0)
+		strMessage += LongTail(nThread, nLine);
+	CXTraceSink::Instance().Write(__FILE__, __LINE__, XTRACE_THREADID, strMessage.c_str(), strMessage.size());
+}
+
+struct LogLine
+{
+	unsigned long long m_nSeq;
+	int m_nThread;
+	int m_nLine;
+	string m_strTail;
+};
+
+static vector<LogLine> ReadLog()
+{
+	vector<LogLine> vLines;
+	FILE* pFile = fopen(s_pszLog, "rb");
+	if (pFile == NULL)
+		return vLines;
+	string strText;
+	char buf[65536];
+	size_t n;
+	while ((n = fread(buf, 1, sizeof(buf), pFile)) > 0)
+		strText.append(buf, n);
+	fclose(pFile);
+
+	size_t nPos = 0;
+	while (nPos < strText.size())
+	{
+		size_t nEnd = strText.find('\n', nPos);
+		if (nEnd == string::npos)
+			nEnd = strText.size();
+		string strLine = strText.substr(nPos, nEnd - nPos);
+		nPos = nEnd + 1;
+
+		// <seconds> #<seq> file(line) : [thread] T<n> L<n> <tail>
+		LogLine line;
+		double dTime = 0;
+		line.m_nSeq = 0;
+		line.m_nThread = line.m_nLine = -1;
+		sscanf(strLine.c_str(), "%lf #%llu", &dTime, &line.m_nSeq);
+		size_t nMessage = strLine.find("] T");
+		if (nMessage != string::npos)
+		{
+			int nTail = 0;
+			sscanf(strLine.c_str() + nMessage + 2, "T%d L%d %n", &line.m_nThread, &line.m_nLine, &nTail);
+			line.m_strTail = strLine.substr(nMessage + 2 + nTail);
+		}
+		vLines.push_back(line);
+	}
+	return vLines;
+}
+
+// the lines of nThreads threads with nLines lines each, all of them once,
+// in the order of their sequence numbers
+static void CheckLog(const vector<LogLine>& vLines, int nThreadBase, int nThreads, int nLines)
+{
+	CHECK_EQ(vLines.size(), nThreads * nLines);
+	std::set<pair<int, int>> setSeen;
+	vector<int> vLast(nThreads, -1);
+	int nOutOfOrder = 0;
+	int nBadTail = 0;
+	for (size_t i = 0; i < vLines.size(); i++)
+	{
+		const LogLine& line = vLines[i];
+		if (i > 0 && line.m_nSeq <= vLines[i - 1].m_nSeq)
+			nOutOfOrder++;
+		int nThread = line.m_nThread - nThreadBase;
+		CHECK(nThread >= 0 && nThread < nThreads && line.m_nLine >= 0 && line.m_nLine < nLines);
+		if (nThread < 0 || nThread >= nThreads)
+			continue;
+		CHECK(setSeen.insert(make_pair(nThread, line.m_nLine)).second);
+		CHECK(line.m_nLine > vLast[nThread]);
+		vLast[nThread] = line.m_nLine;
+		string strTail = line.m_nLine % TEST_LONG_EVERY == 0 ? LongTail(line.m_nThread, line.m_nLine) : "";
+		if (line.m_strTail != strTail)
+			nBadTail++;
+	}
+	CHECK_EQ(nOutOfOrder, 0);
+	CHECK_EQ(nBadTail, 0);
+	CHECK_EQ(setSeen.size(), nThreads * nLines);
+}
+
+int main()
+{
+	remove(s_pszLog);
+	XTRACECONFIG config;
+	config.m_strPath = s_pszLog;
+	config.m_nMaxFileSize = 0;
+	config.m_nMaxFileAge = 0;
+	config.m_nRingSize = 4096;
+	config.m_nFlushInterval = 5;
+	CXTraceSink& sink = CXTraceSink::Instance();
+	sink.Configure(config);
+	sink.m_pfnClaimed = StallSome;
+
+	// Flush returns with the lines traced before it in the file
+	for (int i = 0; i < 100; i++)
+		Trace(0, i);
+	sink.Flush();
+	CheckLog(ReadLog(), 0, 1, 100);
+
+	// many threads, stalled at random, all of their lines in call order
+	remove(s_pszLog);
+	sink.Configure(config);
+	vector<std::thread> vThreads;
+	for (int t = 0; t < TEST_THREADS; t++)
+	{
+		vThreads.push_back(std::thread([t]() {
+			for (int i = 0; i < TEST_LINES; i++)
+				Trace(t + 1, i);
+		}));
+	}
+	for (auto& it : vThreads)
+		it.join();
+	sink.Flush();
+	CheckLog(ReadLog(), 1, TEST_THREADS, TEST_LINES);
+	CHECK(sink.GetWaitCount() > 0);
+
+	// Shutdown while threads trace does not wait for the flusher to end and
+	// loses nothing: what comes after it is written by the tracing threads
+	remove(s_pszLog);
+	sink.Configure(config);
+	vThreads.clear();
+	std::atomic<int> nStarted(0);
+	for (int t = 0; t < 4; t++)
+	{
+		vThreads.push_back(std::thread([t, &nStarted]() {
+			for (int i = 0; i < TEST_LINES; i++)
+			{
+				Trace(t + 1, i);
+				if (i == 100)
+					nStarted++;
+			}
+		}));
+	}
+	while (nStarted.load() < 4)
+		std::this_thread::yield();
+	sink.Shutdown();
+	for (auto& it : vThreads)
+		it.join();
+	sink.Flush();
+	vector<LogLine> vLines = ReadLog();
+	CHECK_EQ(vLines.size(), 4 * TEST_LINES);
+	std::set<pair<int, int>> setSeen;
+	for (auto& line : vLines)
+		setSeen.insert(make_pair(line.m_nThread, line.m_nLine));
+	CHECK_EQ(setSeen.size(), 4 * TEST_LINES);
+
+	remove(s_pszLog);
+	return TestResult("XTraceSinkTest");
+}
@@ -0,0 +1,628 @@
+// XmlTreeModelTest.cpp : the XML index behind a virtual CTangramHtmlTreeWnd
+//
+// A large random document is indexed into CXmlTreeModel and opened the way
+// the window opens it: LoadXmlChildren() in pages, ReleaseXmlChildren() and
+// TrimXmlItems() down to an item budget. The tree control is a set of fake
+// item handles, and everything the model keeps is checked against a recount
+// from the parent links alone. Check states are checked the same way, after
+// every SetCheck(), SetCheckAll() and Remove() of a random walk, with smart
+// checks on and off.
+
+#include "stdafx.h"
+#include "XmlTreeModel.h"
+#include "TestCheck.h"
+
+#include <random>
+
+typedef CXmlTreeModel Model;
+
+// a document of nCount elements in document order: each one goes under a
+// random element of the path to the one before it, so trees come out both
+// deep and wide
+static vector<int> MakeParents(int nCount, unsigned nSeed)
+{
+	std::mt19937 rng(nSeed);
+	vector<int> vParents, vPath;
+	for (int n = 0; n < nCount; n++)
+	{
+		int nKeep = vPath.empty() ? 0 : (int)(rng() % (vPath.size() + 1));
+		if (rng() % 4 == 0 && nKeep > 0)
+			nKeep--;
+		vPath.resize(nKeep);
+		vParents.push_back(vPath.empty() ? Model::NONE : vPath.back());
+		vPath.push_back(n);
+	}
+	return vParents;
+}
+
+static void Build(Model& model, const vector<int>& vParents)
+{
+	model.Clear();
+	for (int n = 0; n < (int)vParents.size(); n++)
+		model.AddNode(vParents[n], (void*)(intptr_t)(n + 1), false, true, false);
+	model.Aggregate(false);
+}
+
+static void* Item(int n)
+{
+	return (void*)(intptr_t)(n + 1);
+}
+
+static bool HasChildren(const Model& model, int n)
+{
+	return model.GetNode(n).m_nFirstChild != Model::NONE;
+}
+
+// LoadXmlChildren() without the window
+static int Load(Model& model, int n, int nPage)
+{
+	model.Touch(n);
+	int nChild = model.GetPending(n);
+	int nLoaded = 0;
+	while (nChild != Model::NONE && (nPage <= 0 || nLoaded < nPage))
+	{
+		model.SetItem(nChild, Item(nChild));
+		nChild = model.GetNextSibling(nChild);
+		nLoaded++;
+	}
+	model.SetPending(n, nChild);
+	return nLoaded;
+}
+
+static bool IsInside(const Model& model, int n, int nAncestor)
+{
+	for (; n != Model::NONE; n = model.GetNode(n).m_nParent)
+	{
+		if (n == nAncestor)
+			return true;
+	}
+	return false;
+}
+
+// TrimXmlItems() without the window; hKeep and its ancestors stay loaded
+static vector<int> Trim(Model& model, int nBudget, int nKeep)
+{
+	vector<int> vReleased, vLoaded;
+	model.GetLoadedByAge(vLoaded);
+	for (int n : vLoaded)
+	{
+		if (model.GetItemCount() <= nBudget)
+			break;
+		if (model.GetNode(n).m_hItem == NULL || !model.IsLoaded(n) || IsInside(model, nKeep, n))
+			continue;
+		model.ReleaseChildren(n);
+		vReleased.push_back(n);
+	}
+	return vReleased;
+}
+
+// what the model keeps, recounted from the parent links and the items
+static int s_nStructureErrors;
+static int s_nItemErrors;
+
+static void CheckStructure(const Model& model, const vector<int>& vParents)
+{
+	int nCount = (int)vParents.size();
+	vector<int> vDescendants(nCount, 0), vLast(nCount), vFirst(nCount, Model::NONE), vNext(nCount, Model::NONE), vPrev(nCount, Model::NONE);
+	for (int n = 0; n < nCount; n++)
+		vLast[n] = n;
+	for (int n = nCount - 1; n >= 0; n--)
+	{
+		int p = vParents[n];
+		if (p == Model::NONE)
+			continue;
+		vDescendants[p] += 1 + vDescendants[n];
+		vLast[p] = max(vLast[p], vLast[n]);
+	}
+	int nLastRoot = Model::NONE;
+	for (int n = 0; n < nCount; n++)
+	{
+		int p = vParents[n];
+		int nPrev = p == Model::NONE ? nLastRoot : vPrev[p];
+		if (nPrev != Model::NONE)
+			vNext[nPrev] = n;
+		else if (p != Model::NONE)
+			vFirst[p] = n;
+		if (p == Model::NONE)
+			nLastRoot = n;
+		else
+			vPrev[p] = n;
+	}
+	s_nStructureErrors = 0;
+	for (int n = 0; n < nCount; n++)
+	{
+		const XMLTREENODE& node = model.GetNode(n);
+		if (node.m_nParent != vParents[n] || node.m_nDescendants != vDescendants[n] || node.m_nLast != vLast[n] ||
+			node.m_nFirstChild != vFirst[n] || node.m_nNextSibling != vNext[n] || node.m_pSource != Item(n))
+			s_nStructureErrors++;
+	}
+	CHECK_EQ(s_nStructureErrors, 0);
+	CHECK_EQ(model.GetCount(), nCount);
+	CHECK_EQ(model.GetFirstRoot(), 0);
+}
+
+// items form a tree: each one below a parent with an item, the loaded
+// children of a record are a prefix of them up to its pending one, and the
+// pending counts are those of the rest
+static void CheckItems(const Model& model)
+{
+	int nItems = 0;
+	s_nItemErrors = 0;
+	for (int n = 0; n < model.GetCount(); n++)
+	{
+		const XMLTREENODE& node = model.GetNode(n);
+		if (node.m_hItem)
+		{
+			nItems++;
+			if (node.m_hItem != Item(n) || (node.m_nParent != Model::NONE && model.GetNode(node.m_nParent).m_hItem == NULL))
+				s_nItemErrors++;
+		}
+		bool bPending = false;
+		int nDescendants = 0, nSeparators = 0;
+		for (int c = node.m_nFirstChild; c != Model::NONE; c = model.GetNextSibling(c))
+		{
+			bPending = bPending || c == node.m_nPending;
+			if (model.GetNode(c).m_hItem != NULL && bPending)
+				s_nItemErrors++;
+			if (model.GetNode(c).m_hItem == NULL && !bPending && node.m_hItem != NULL)
+				s_nItemErrors++;
+			if (bPending)
+			{
+				nDescendants += 1 + model.GetNode(c).m_nDescendants;
+				nSeparators += model.GetNode(c).m_nSeparators + (model.GetNode(c).m_bSeparator ? 1 : 0);
+			}
+		}
+		if (node.m_nPending != Model::NONE && !bPending)
+			s_nItemErrors++;
+		int nPending, nChecked, nTristate, nPendingSeparators;
+		model.GetPendingCounts(n, nPending, nChecked, nTristate, nPendingSeparators);
+		if (nPending != nDescendants || nPendingSeparators != nSeparators)
+			s_nItemErrors++;
+	}
+	CHECK_EQ(s_nItemErrors, 0);
+	CHECK_EQ(model.GetItemCount(), nItems);
+}
+
+static void TestIndex()
+{
+	Model model;
+	vector<int> vParents = MakeParents(200000, 1);
+	Build(model, vParents);
+	CheckStructure(model, vParents);
+	CHECK_EQ(model.GetItemCount(), 0);
+
+	// Clear() and a second index of another document
+	vParents = MakeParents(5000, 2);
+	Build(model, vParents);
+	CheckStructure(model, vParents);
+
+	// a single chain as deep as the document
+	vector<int> vChain;
+	for (int n = 0; n < 50000; n++)
+		vChain.push_back(n - 1);
+	Build(model, vChain);
+	CheckStructure(model, vChain);
+	CHECK_EQ(model.GetNode(0).m_nDescendants, 49999);
+}
+
+static void TestPages()
+{
+	// one root with 1000 children, each with a few of its own
+	vector<int> vParents = { Model::NONE };
+	for (int c = 0; c < 1000; c++)
+	{
+		int n = (int)vParents.size();
+		vParents.push_back(0);
+		for (int g = 0; g < c % 3; g++)
+			vParents.push_back(n);
+	}
+	Model model;
+	Build(model, vParents);
+	model.SetItem(0, Item(0));
+	CHECK(!model.IsLoaded(0));
+	CheckItems(model);
+
+	// pages of 100 until none are pending
+	for (int nPage = 1; nPage <= 10; nPage++)
+	{
+		CHECK_EQ(Load(model, 0, 100), 100);
+		CHECK_EQ(model.GetItemCount(), 1 + nPage * 100);
+		CHECK(model.IsLoaded(0));
+		CHECK_EQ(model.GetPending(0) == Model::NONE, nPage == 10);
+		CheckItems(model);
+	}
+	CHECK_EQ(Load(model, 0, 100), 0);
+
+	// a leaf is loaded from the start and never listed by age
+	int nLeaf = 1;
+	CHECK(!HasChildren(model, nLeaf) && model.IsLoaded(nLeaf));
+
+	// releasing the root takes every item below it, and its children are
+	// pending again from the first one
+	CHECK_EQ(Load(model, 4, 0), 2);
+	CHECK_EQ(model.GetItemCount(), 1003);
+	model.ReleaseChildren(0);
+	CHECK_EQ(model.GetItemCount(), 1);
+	CHECK_EQ(model.GetPending(0), model.GetNode(0).m_nFirstChild);
+	CHECK_EQ(model.GetPending(4), model.GetNode(4).m_nFirstChild);
+	CHECK(!model.IsLoaded(0));
+	CheckItems(model);
+	CHECK_EQ(Load(model, 0, 0), 1000);
+	CheckItems(model);
+}
+
+// the order TrimXmlItems() releases in: loaded branches with items, least
+// recently opened first
+static void TestAge()
+{
+	Model model;
+	vector<int> vParents = MakeParents(20000, 3);
+	Build(model, vParents);
+	int nRoots = 0;
+	for (int n = model.GetFirstRoot(); n != Model::NONE; n = model.GetNextSibling(n), nRoots++)
+		model.SetItem(n, Item(n));
+
+	// open random branches that have items, checking the age order each time
+	std::mt19937 rng(4);
+	vector<int> vOpened;
+	for (int nStep = 0; nStep < 3000; nStep++)
+	{
+		int n = (int)(rng() % model.GetCount());
+		if (model.GetNode(n).m_hItem == NULL || !HasChildren(model, n))
+			continue;
+		Load(model, n, 20 + (int)(rng() % 50));
+		vOpened.erase(remove(vOpened.begin(), vOpened.end(), n), vOpened.end());
+		vOpened.push_back(n);
+	}
+	CHECK(vOpened.size() > 200);
+	CheckItems(model);
+
+	vector<int> vLoaded, vExpected;
+	model.GetLoadedByAge(vLoaded);
+	for (int n : vOpened)
+	{
+		if (model.GetNode(n).m_hItem && model.IsLoaded(n))
+			vExpected.push_back(n);
+	}
+	CHECK(vLoaded == vExpected);
+
+	// trimming to a budget releases that order from the front, and never the
+	// branch that is being opened or the ones above it
+	int nKeep = vOpened.front();
+	int nBudget = nRoots + (model.GetItemCount() - nRoots) / 2;
+	vector<int> vReleased = Trim(model, nBudget, nKeep);
+	CHECK(!vReleased.empty());
+	CHECK(model.GetItemCount() <= nBudget);
+	CHECK(model.GetNode(nKeep).m_hItem != NULL && model.IsLoaded(nKeep));
+	CheckItems(model);
+	for (size_t i = 1; i < vReleased.size(); i++)
+	{
+		CHECK(find(vExpected.begin(), vExpected.end(), vReleased[i - 1]) <
+			find(vExpected.begin(), vExpected.end(), vReleased[i]));
+	}
+	// what was opened after the last release is still there, unless it was
+	// inside a branch released before
+	vector<int>::iterator it = find(vExpected.begin(), vExpected.end(), vReleased.back());
+	int nStillLoaded = 0, nAfter = 0;
+	for (++it; it != vExpected.end(); ++it)
+	{
+		bool bInside = false;
+		for (int n : vReleased)
+			bInside = bInside || IsInside(model, *it, n);
+		if (bInside)
+			continue;
+		nAfter++;
+		if (model.GetNode(*it).m_hItem && model.IsLoaded(*it))
+			nStillLoaded++;
+	}
+	CHECK(nAfter > 0);
+	CHECK_EQ(nStillLoaded, nAfter);
+
+	// a released branch opened again is the most recent one
+	int nAgain = vReleased.front();
+	if (model.GetNode(nAgain).m_hItem)
+	{
+		Load(model, nAgain, 0);
+		model.GetLoadedByAge(vLoaded);
+		CHECK_EQ(vLoaded.back(), nAgain);
+	}
+
+	// trimming to nothing leaves only the roots and the kept path
+	Trim(model, 0, nKeep);
+	CheckItems(model);
+	model.GetLoadedByAge(vLoaded);
+	for (int n : vLoaded)
+		CHECK(IsInside(model, nKeep, n));
+}
+
+// The check state the window shows, worked out from scratch: a flag per
+// element, and with smart checks a branch is checked when all its
+// non-separator descendants are, whichever of them changed.
+struct CheckReference
+{
+	vector<int> m_vParents;
+	vector<char> m_vChecked, m_vEnabled, m_vSeparator, m_vRemoved;
+	bool m_bSmartCheck = false;
+
+	// the totals of every subtree, each element once
+	vector<int> m_vDescendants, m_vCheckedBelow, m_vTristate, m_vSeparators;
+
+	void Count()
+	{
+		int nCount = (int)m_vParents.size();
+		m_vDescendants.assign(nCount, 0);
+		m_vCheckedBelow.assign(nCount, 0);
+		m_vTristate.assign(nCount, 0);
+		m_vSeparators.assign(nCount, 0);
+		for (int n = nCount - 1; n >= 0; n--)
+		{
+			int p = m_vParents[n];
+			if (m_vRemoved[n] || p == Model::NONE)
+				continue;
+			m_vDescendants[p] += 1 + m_vDescendants[n];
+			m_vCheckedBelow[p] += m_vCheckedBelow[n] + (m_vChecked[n] ? 1 : 0);
+			m_vTristate[p] += m_vTristate[n] + (IsMixed(n) ? 1 : 0);
+			m_vSeparators[p] += m_vSeparators[n] + (m_vSeparator[n] ? 1 : 0);
+		}
+	}
+
+	bool IsMixed(int n) const
+	{
+		int nCheckable = m_vDescendants[n] - m_vSeparators[n];
+		return m_bSmartCheck && !m_vSeparator[n] && m_vCheckedBelow[n] != 0 && m_vCheckedBelow[n] != nCheckable;
+	}
+
+	// with smart checks, a branch takes the state of what is below it
+	void Settle(int n)
+	{
+		Count();
+		if (m_bSmartCheck && !m_vSeparator[n] && m_vDescendants[n] - m_vSeparators[n] > 0)
+			m_vChecked[n] = m_vCheckedBelow[n] == m_vDescendants[n] - m_vSeparators[n];
+	}
+
+	bool IsInside(int n, int nAncestor) const
+	{
+		for (; n != Model::NONE; n = m_vParents[n])
+		{
+			if (n == nAncestor)
+				return true;
+		}
+		return false;
+	}
+
+	void SettleAll()
+	{
+		for (int n = (int)m_vParents.size() - 1; n >= 0; n--)
+		{
+			if (!m_vRemoved[n])
+				Settle(n);
+		}
+		Count();
+	}
+
+	void SettleAncestors(int n)
+	{
+		for (int p = m_vParents[n]; p != Model::NONE; p = m_vParents[p])
+			Settle(p);
+		Count();
+	}
+
+	void SetCheck(int n, bool bCheck)
+	{
+		if (m_vRemoved[n] || m_vSeparator[n])
+			return;
+		m_vChecked[n] = bCheck;
+		if (m_bSmartCheck)
+		{
+			for (int i = (int)m_vParents.size() - 1; i > n; i--)
+			{
+				if (!m_vRemoved[i] && IsInside(i, n) && m_vEnabled[i] && !m_vSeparator[i])
+					m_vChecked[i] = bCheck;
+			}
+			for (int i = (int)m_vParents.size() - 1; i >= n; i--)
+			{
+				if (!m_vRemoved[i] && IsInside(i, n))
+					Settle(i);
+			}
+		}
+		SettleAncestors(n);
+	}
+
+	void SetCheckAll(bool bCheck)
+	{
+		for (size_t n = 0; n < m_vParents.size(); n++)
+		{
+			if (!m_vRemoved[n] && m_vEnabled[n] && !m_vSeparator[n])
+				m_vChecked[n] = bCheck;
+		}
+		SettleAll();
+	}
+
+	void Remove(int n)
+	{
+		if (m_vRemoved[n])
+			return;
+		for (size_t i = n; i < m_vParents.size(); i++)
+		{
+			if (IsInside((int)i, n))
+				m_vRemoved[i] = true;
+		}
+		SettleAncestors(n);
+	}
+};
+
+static CheckReference MakeReference(Model& model, const vector<int>& vParents, bool bSmartCheck, unsigned nSeed)
+{
+	std::mt19937 rng(nSeed);
+	CheckReference ref;
+	ref.m_vParents = vParents;
+	ref.m_bSmartCheck = bSmartCheck;
+	model.Clear();
+	for (int n = 0; n < (int)vParents.size(); n++)
+	{
+		bool bSeparator = rng() % 20 == 0;
+		bool bEnabled = rng() % 10 != 0;
+		bool bChecked = rng() % 3 == 0;
+		model.AddNode(vParents[n], Item(n), bChecked, bEnabled, bSeparator);
+		ref.m_vChecked.push_back(bChecked && !bSeparator);
+		ref.m_vEnabled.push_back(bEnabled);
+		ref.m_vSeparator.push_back(bSeparator);
+		ref.m_vRemoved.push_back(false);
+	}
+	model.Aggregate(bSmartCheck);
+	ref.SettleAll();
+	return ref;
+}
+
+static int s_nCheckErrors;
+
+static void CheckCounts(const Model& model, const CheckReference& ref)
+{
+	int nChecked = 0;
+	s_nCheckErrors = 0;
+	for (int n = 0; n < (int)ref.m_vParents.size(); n++)
+	{
+		const XMLTREENODE& node = model.GetNode(n);
+		if (node.m_bRemoved != (ref.m_vRemoved[n] != 0))
+			s_nCheckErrors++;
+		if (ref.m_vRemoved[n])
+			continue;
+		nChecked += ref.m_vChecked[n] ? 1 : 0;
+		if (model.GetCheck(n) != (ref.m_vChecked[n] != 0) || model.IsMixed(n) != ref.IsMixed(n) ||
+			node.m_nDescendants != ref.m_vDescendants[n] || node.m_nChecked != ref.m_vCheckedBelow[n] ||
+			node.m_nTristate != ref.m_vTristate[n] || node.m_nSeparators != ref.m_vSeparators[n])
+			s_nCheckErrors++;
+		// the children still linked are the ones not removed
+		int nLinked = 0, nLeft = 0;
+		for (int c = node.m_nFirstChild; c != Model::NONE; c = model.GetNextSibling(c))
+			nLinked += ref.m_vRemoved[c] ? 1000000 : 1;
+		for (int c = n + 1; c <= node.m_nLast; c++)
+			nLeft += !ref.m_vRemoved[c] && ref.m_vParents[c] == n ? 1 : 0;
+		if (nLinked != nLeft)
+			s_nCheckErrors++;
+	}
+	CHECK_EQ(s_nCheckErrors, 0);
+	CHECK_EQ(model.GetCheckedCount(), nChecked);
+}
+
+// random checks, unchecks and removals, each followed by a full recount
+static void TestChecks(bool bSmartCheck, unsigned nSeed)
+{
+	Model model;
+	vector<int> vParents = MakeParents(1500, nSeed);
+	CheckReference ref = MakeReference(model, vParents, bSmartCheck, nSeed);
+	CheckCounts(model, ref);
+
+	std::mt19937 rng(nSeed * 7 + 1);
+	int nCount = (int)vParents.size();
+	for (int nStep = 0; nStep < 300; nStep++)
+	{
+		int n = (int)(rng() % nCount);
+		int nOp = (int)(rng() % 20);
+		if (nOp == 0)
+		{
+			bool bCheck = rng() % 2 != 0;
+			model.SetCheckAll(bCheck);
+			ref.SetCheckAll(bCheck);
+		}
+		else if (nOp < 3)
+		{
+			model.Remove(n);
+			ref.Remove(n);
+		}
+		else
+		{
+			// a branch rather than a leaf most of the time, and disabled and
+			// separator elements too, which keep their own state
+			while (rng() % 3 != 0 && vParents[n] != Model::NONE)
+				n = vParents[n];
+			bool bCheck = !model.GetCheck(n) || rng() % 4 == 0;
+			model.SetCheck(n, bCheck);
+			ref.SetCheck(n, bCheck);
+		}
+		CheckCounts(model, ref);
+		if (s_nCheckErrors)
+		{
+			fprintf(stderr, "smart check %d, seed %u: wrong after step %d\n", bSmartCheck, nSeed, nStep);
+			break;
+		}
+	}
+}
+
+// the cases the random walk reaches only by chance
+static void TestCheckCases()
+{
+	// a branch of disabled and separator children only: the separators do
+	// not count, the disabled child keeps its state and holds the branch
+	// back from checked
+	vector<int> vParents = { Model::NONE, 0, 0, 0 };
+	Model model;
+	model.AddNode(Model::NONE, Item(0), false, true, false);
+	model.AddNode(0, Item(1), false, false, false);
+	model.AddNode(0, Item(2), true, true, true);
+	model.AddNode(0, Item(3), false, true, false);
+	model.Aggregate(true);
+	CHECK(!model.GetCheck(2));
+	CHECK_EQ(model.GetNode(0).m_nSeparators, 1);
+	model.SetCheck(0, true);
+	CHECK(!model.GetCheck(1));
+	CHECK(model.GetCheck(3));
+	CHECK(!model.GetCheck(0));
+	CHECK(model.IsMixed(0));
+	CHECK_EQ(model.GetCheckedCount(), 1);
+
+	// removing the disabled child leaves the branch all checked
+	model.Remove(1);
+	CHECK(model.GetCheck(0));
+	CHECK(!model.IsMixed(0));
+	CHECK_EQ(model.GetCheckedCount(), 2);
+	CHECK_EQ(model.GetNode(0).m_nDescendants, 2);
+
+	// a separator is never checked, and checking it changes nothing
+	model.SetCheck(2, true);
+	CHECK(!model.GetCheck(2));
+	CHECK_EQ(model.GetCheckedCount(), 2);
+
+	// a branch whose children are all removed keeps its own state
+	model.Remove(3);
+	model.Remove(2);
+	CHECK(model.GetCheck(0));
+	CHECK_EQ(model.GetNode(0).m_nDescendants, 0);
+	CHECK_EQ(model.GetNode(0).m_nFirstChild, Model::NONE);
+	model.SetCheck(0, false);
+	CHECK_EQ(model.GetCheckedCount(), 0);
+
+	// removed twice, and removing a root
+	model.Remove(3);
+	model.Remove(0);
+	CHECK_EQ(model.GetCount(), 0);
+	CHECK_EQ(model.GetFirstRoot(), Model::NONE);
+	CHECK_EQ(model.GetCheckedCount(), 0);
+
+	// a deep chain with a separator halfway: checking the leaf checks every
+	// element above it but the separator, unchecking it unchecks them
+	model.Clear();
+	for (int n = 0; n < 2000; n++)
+		model.AddNode(n - 1, Item(n), false, true, n == 1000);
+	model.Aggregate(true);
+	model.SetCheck(1999, true);
+	CHECK_EQ(model.GetCheckedCount(), 1999);
+	CHECK(model.GetCheck(0) && !model.GetCheck(1000));
+	CHECK(!model.IsMixed(0));
+	model.SetCheck(1999, false);
+	CHECK_EQ(model.GetCheckedCount(), 0);
+}
+
+int main()
+{
+	TestIndex();
+	TestPages();
+	TestAge();
+	for (unsigned nSeed = 10; nSeed < 16; nSeed++)
+	{
+		TestChecks(false, nSeed);
+		TestChecks(true, nSeed);
+	}
+	TestCheckCases();
+	return TestResult("XmlTreeModelTest");
+}
@@ -0,0 +1,239 @@
+#!/usr/bin/env python3
+# make_surface_fixtures.py : writes PPSurfaceFixtures.h
+#
+# Small PNG and BMP files in every layout CPPSurface reads, encoded here
+# with Python's zlib independently of the codec under test, each with the
+# straight-alpha ARGB pixels it must decode to.
+#
+#   python3 make_surface_fixtures.py > PPSurfaceFixtures.h
+
+import random
+import struct
+import zlib
+
+rng = random.Random(20261019)
+fixtures = []
+
+
+def argb(a, r, g, b):
+    return (a << 24) | (r << 16) | (g << 8) | b
+
+
+def png_chunk(kind, data):
+    return struct.pack('>I', len(data)) + kind + data + struct.pack('>I', zlib.crc32(kind + data) & 0xFFFFFFFF)
+
+
+def pack_samples(samples, depth):
+    if depth == 8:
+        return bytes(samples)
+    if depth == 16:
+        return b''.join(struct.pack('>H', s) for s in samples)
+    out, acc, bits = bytearray(), 0, 0
+    for s in samples:
+        acc = (acc << depth) | s
+        bits += depth
+        if bits == 8:
+            out.append(acc)
+            acc, bits = 0, 0
+    if bits:
+        out.append(acc << (8 - bits))
+    return bytes(out)
+
+
+def paeth(a, b, c):
+    p = a + b - c
+    pa, pb, pc = abs(p - a), abs(p - b), abs(p - c)
+    if pa <= pb and pa <= pc:
+        return a
+    return b if pb <= pc else c
+
+
+def filter_rows(rows, bpp):
+    out, prev = bytearray(), bytes(len(rows[0])) if rows else b''
+    for row in rows:
+        kind = rng.randrange(5)
+        out.append(kind)
+        for i, x in enumerate(row):
+            a = row[i - bpp] if i >= bpp else 0
+            b = prev[i]
+            c = prev[i - bpp] if i >= bpp else 0
+            pred = [0, a, b, (a + b) >> 1, paeth(a, b, c)][kind]
+            out.append((x - pred) & 0xFF)
+        prev = row
+    return bytes(out)
+
+
+ADAM7 = [(0, 0, 8, 8), (4, 0, 8, 8), (0, 4, 4, 8), (2, 0, 4, 4), (0, 2, 2, 4), (1, 0, 2, 2), (0, 1, 1, 2)]
+
+
+def make_png(name, width, height, color_type, depth, interlace=False, trns=None, palette=None):
+    channels = {0: 1, 2: 3, 3: 1, 4: 2, 6: 4}[color_type]
+    top = (1 << depth) - 1
+    pixels = [[[rng.randint(0, top) for _ in range(channels)] for _ in range(width)] for _ in range(height)]
+    if trns is not None and color_type in (0, 2):
+        # make sure the transparent key shows up
+        pixels[0][0] = list(trns)
+
+    def to8(s):
+        return s >> 8 if depth == 16 else s if depth == 8 else s * 255 // top
+
+    expected = []
+    for y in range(height):
+        for x in range(width):
+            s = pixels[y][x]
+            if color_type == 3:
+                r, g, b = palette[s[0]]
+                a = trns[s[0]] if trns is not None and s[0] < len(trns) else 255
+                expected.append(argb(a, r, g, b))
+                continue
+            clear = trns is not None and list(s) == list(trns)
+            v = [to8(c) for c in s]
+            if color_type == 0:
+                p = argb(255, v[0], v[0], v[0])
+            elif color_type == 2:
+                p = argb(255, v[0], v[1], v[2])
+            elif color_type == 4:
+                p = argb(v[1], v[0], v[0], v[0])
+            else:
+                p = argb(v[3], v[0], v[1], v[2])
+            expected.append(p & 0x00FFFFFF if clear else p)
+
+    bpp = max(1, channels * depth // 8)
+    raw = b''
+    passes = ADAM7 if interlace else [(0, 0, 1, 1)]
+    for sx, sy, dx, dy in passes:
+        rows = []
+        for y in range(sy, height, dy):
+            samples = [c for x in range(sx, width, dx) for c in pixels[y][x]]
+            if samples:
+                rows.append(pack_samples(samples, depth))
+        if rows:
+            raw += filter_rows(rows, bpp)
+
+    data = b'\x89PNG\r\n\x1a\n'
+    data += png_chunk(b'IHDR', struct.pack('>IIBBBBB', width, height, depth, color_type, 0, 0, 1 if interlace else 0))
+    if palette is not None:
+        data += png_chunk(b'PLTE', b''.join(bytes(c) for c in palette))
+    if trns is not None:
+        if color_type == 3:
+            data += png_chunk(b'tRNS', bytes(trns))
+        else:
+            data += png_chunk(b'tRNS', b''.join(struct.pack('>H', c) for c in trns))
+    # split the data over two IDAT chunks, as encoders may
+    z = zlib.compress(raw, 9)
+    data += png_chunk(b'IDAT', z[:len(z) // 2]) + png_chunk(b'IDAT', z[len(z) // 2:])
+    data += png_chunk(b'IEND', b'')
+    fixtures.append((name, data, width, height, expected))
+
+
+def make_bmp(name, width, height, bits, top_down=False, masks=None, bitfields=False, colors=None, zero_alpha=False):
+    expected = [0] * (width * height)
+    stride = ((width * bits + 31) // 32) * 4
+    palette = []
+    if bits <= 8:
+        ncolors = colors or (1 << bits)
+        palette = [(rng.randrange(256), rng.randrange(256), rng.randrange(256)) for _ in range(ncolors)]
+    lines = []
+    for line in range(height):
+        y = line if top_down else height - 1 - line
+        samples, out = [], bytearray()
+        for x in range(width):
+            if bits <= 8:
+                i = rng.randrange(len(palette))
+                samples.append(i)
+                r, g, b = palette[i]
+                expected[y * width + x] = argb(255, r, g, b)
+            elif bits == 24:
+                b, g, r = rng.randrange(256), rng.randrange(256), rng.randrange(256)
+                out += bytes((b, g, r))
+                expected[y * width + x] = argb(255, r, g, b)
+            else:
+                m = masks
+                value = rng.getrandbits(bits)
+                if zero_alpha:
+                    value &= ~m[3]
+                ch = []
+                for mask in m:
+                    if not mask:
+                        ch.append(None)
+                        continue
+                    shift = (mask & -mask).bit_length() - 1
+                    top = mask >> shift
+                    ch.append((((value >> shift) & top) * 255 + top // 2) // top)
+                expected[y * width + x] = argb(ch[3] if ch[3] is not None else 255, ch[0], ch[1], ch[2])
+                out += value.to_bytes(bits // 8, 'little')
+        if bits <= 8:
+            out = bytearray(pack_samples(samples, bits))
+        out += bytes(stride - len(out))
+        lines.append(bytes(out))
+    info = struct.pack('<IiiHHIIiiII', 40, width, -height if top_down else height, 1, bits,
+                       3 if bitfields else 0, stride * height, 0, 0, len(palette) if colors else 0, 0)
+    extra = b''
+    if bitfields:
+        extra = b''.join(struct.pack('<I', m) for m in masks[:3])
+    pal = b''.join(bytes((b, g, r, 0)) for r, g, b in palette)
+    off = 14 + len(info) + len(extra) + len(pal)
+    body = info + extra + pal + b''.join(lines)
+    data = b'BM' + struct.pack('<IHHI', 14 + len(body), 0, 0, off) + body
+    if masks is not None and (not masks[3] or zero_alpha):
+        expected = [p | 0xFF000000 for p in expected]
+    fixtures.append((name, data, width, height, expected))
+
+
+for depth in (1, 2, 4, 8, 16):
+    make_png('png_gray%d' % depth, 13, 5, 0, depth)
+make_png('png_gray8_trns', 6, 4, 0, 8, trns=(77,))
+make_png('png_gray16_adam7', 17, 11, 0, 16, interlace=True)
+for depth in (8, 16):
+    make_png('png_rgb%d' % depth, 7, 6, 2, depth)
+    make_png('png_graya%d' % depth, 5, 7, 4, depth)
+    make_png('png_rgba%d' % depth, 9, 3, 6, depth)
+make_png('png_rgb8_trns', 5, 5, 2, 8, trns=(10, 20, 30))
+make_png('png_rgb16_trns', 5, 5, 2, 16, trns=(1000, 2000, 3000))
+make_png('png_rgba8_adam7', 19, 13, 6, 8, interlace=True)
+make_png('png_rgba8_adam7_tiny', 3, 2, 6, 8, interlace=True)
+for depth in (1, 2, 4, 8):
+    n = 1 << depth
+    pal = [(rng.randrange(256), rng.randrange(256), rng.randrange(256)) for _ in range(n)]
+    make_png('png_palette%d' % depth, 11, 4, 3, depth, palette=pal)
+pal = [(rng.randrange(256), rng.randrange(256), rng.randrange(256)) for _ in range(16)]
+make_png('png_palette4_trns', 10, 6, 3, 4, palette=pal, trns=[rng.randrange(256) for _ in range(9)])
+
+make_bmp('bmp_1', 19, 4, 1)
+make_bmp('bmp_4', 9, 5, 4, colors=11)
+make_bmp('bmp_8', 7, 3, 8, top_down=True)
+make_bmp('bmp_24', 5, 6, 24)
+make_bmp('bmp_16', 6, 4, 16, masks=(0x7C00, 0x03E0, 0x001F, 0))
+make_bmp('bmp_16_565', 6, 4, 16, masks=(0xF800, 0x07E0, 0x001F, 0), bitfields=True, top_down=True)
+make_bmp('bmp_32', 5, 3, 32, masks=(0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000))
+make_bmp('bmp_32_noalpha', 5, 3, 32, masks=(0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000), zero_alpha=True)
+make_bmp('bmp_32_bitfields', 4, 4, 32, masks=(0x0000FF00, 0x00FF0000, 0xFF000000, 0), bitfields=True)
+
+print('// PPSurfaceFixtures.h : generated by make_surface_fixtures.py, do not edit')
+print()
+print('#pragma once')
+print()
+print('struct SurfaceFixture')
+print('{')
+print('\tconst char* pszName;')
+print('\tconst uint8_t* pData;')
+print('\tsize_t nSize;')
+print('\tint nWidth;')
+print('\tint nHeight;')
+print('\tconst uint32_t* pExpected;\t// straight alpha, top row first')
+print('};')
+for name, data, w, h, expected in fixtures:
+    print()
+    print('static const uint8_t s_%s[] = {' % name)
+    for i in range(0, len(data), 16):
+        print('\t' + ', '.join('0x%02x' % b for b in data[i:i + 16]) + ',')
+    print('};')
+    print('static const uint32_t s_%s_pixels[] = {' % name)
+    for i in range(0, len(expected), 8):
+        print('\t' + ', '.join('0x%08x' % p for p in expected[i:i + 8]) + ',')
+    print('};')
+print()
+print('static const SurfaceFixture s_SurfaceFixtures[] = {')
+for name, data, w, h, expected in fixtures:
+    print('\t{ "%s", s_%s, sizeof(s_%s), %d, %d, s_%s_pixels },' % (name, name, name, w, h, name))
+print('};')
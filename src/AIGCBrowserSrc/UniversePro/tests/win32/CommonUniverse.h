@@ -0,0 +1,12 @@
+// CommonUniverse.h : the layout attribute and element names of the real header
+
+#pragma once
+
+#define TGM_NAME			_T("name")
+#define TGM_OBJ_ID			_T("objid")
+#define TGM_HEIGHT			_T("height")
+#define TGM_WIDTH			_T("width")
+#define TGM_XOBJ			_T("xobj")
+#define TGM_NUCLEUS			_T("nucleus")
+#define TGM_ROWS			_T("rows")
+#define TGM_COLS			_T("cols")
@@ -0,0 +1,39 @@
+// Cosmos.h : stands in for CSpaceTelescope, the host the JNI bridge calls into
+//
+// The stub JVM tests play the host through m_pfnExtend and the main class
+// InitEclipse names.
+
+#pragma once
+
+#include <functional>
+
+class IWebRTDelegate
+{
+public:
+	JavaVM* m_pJVM = nullptr;
+	JNIEnv* m_pJVMenv = nullptr;
+	jclass systemClass = nullptr;
+	jmethodID exitMethod = nullptr;
+	jmethodID loadMethod = nullptr;
+};
+
+class CSpaceTelescope
+{
+public:
+	int m_nJVMVersion = JNI_VERSION_1_8;
+	CStringA m_strBridgeJavaClass = "org/eclipse/equinox/launcher/JNIBridge";
+	IWebRTDelegate m_Delegate;
+	IWebRTDelegate* m_pWebRTDelegate = &m_Delegate;
+
+	// the answer to a tangram_extend, the key when not set
+	std::function<CString(CString strKey, CString strData, CString strFeatures)> m_pfnExtend;
+	CString m_strMainClass = "org/eclipse/equinox/launcher/Main";
+
+	BOOL InitJNIForTangram() { return TRUE; }
+	CString ConfigJavaVMInfo(CString strOption) { return _T(""); }
+	CString InitEclipse(_TCHAR* jarFile) { return m_strMainClass; }
+	CString tangram_for_eclipse(CString strKey, CString strData, CString strFeatures)
+	{
+		return m_pfnExtend ? m_pfnExtend(strKey, strData, strFeatures) : strKey;
+	}
+};
@@ -0,0 +1,14 @@
+// UniverseApp.h : the application objects the eclipse launcher code reaches for
+
+#pragma once
+
+class CSpaceTelescope;
+
+class CUniverse
+{
+public:
+	HINSTANCE m_hInstance = NULL;
+};
+
+extern CUniverse theApp;
+extern CSpaceTelescope* g_pSpaceTelescope;
@@ -0,0 +1,3 @@
+// WinNucleus.h : nothing of it is used by the sources under test
+
+#pragma once
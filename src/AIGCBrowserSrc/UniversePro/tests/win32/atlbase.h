@@ -0,0 +1,184 @@
+// atlbase.h : IUnknown and the ATL smart pointers and wrappers over it
+//
+// Objects are plain C++ classes counting their own references; an interface
+// is found by dynamic_cast, and IID_IUnknown gives the object's identity.
+
+#pragma once
+
+#include <windows.h>
+#include <oleauto.h>
+#include <atlstr.h>
+
+struct IID
+{
+	int nId;
+};
+typedef IID CLSID;
+typedef const IID& REFIID;
+typedef const CLSID& REFCLSID;
+
+static const IID IID_IUnknown = { 0 };
+
+#define CLSCTX_INPROC_SERVER	1
+
+class IUnknown
+{
+public:
+	IUnknown() : m_nRefs(0) {}
+	virtual ~IUnknown() {}
+
+	ULONG AddRef() { return ++m_nRefs; }
+	ULONG Release()
+	{
+		ULONG nRefs = --m_nRefs;
+		if (nRefs == 0)
+			delete this;
+		return nRefs;
+	}
+	virtual HRESULT QueryInterface(REFIID iid, void** ppv)
+	{
+		if (iid.nId != IID_IUnknown.nId)
+			return QueryOther(iid, ppv);
+		AddRef();
+		*ppv = this;
+		return S_OK;
+	}
+	template <class Q>
+	HRESULT QueryInterface(Q** pp)
+	{
+		Q* p = dynamic_cast<Q*>(this);
+		if (p == NULL)
+			return E_NOINTERFACE;
+		p->AddRef();
+		*pp = p;
+		return S_OK;
+	}
+
+protected:
+	virtual HRESULT QueryOther(REFIID, void** ppv)
+	{
+		*ppv = NULL;
+		return E_NOINTERFACE;
+	}
+
+private:
+	ULONG m_nRefs;
+};
+
+template <class T>
+class CComPtr
+{
+public:
+	CComPtr() : p(NULL) {}
+	CComPtr(T* lp) : p(lp) { if (p) p->AddRef(); }
+	CComPtr(const CComPtr& sp) : p(sp.p) { if (p) p->AddRef(); }
+	~CComPtr() { Release(); }
+
+	CComPtr& operator=(T* lp)
+	{
+		if (lp)
+			lp->AddRef();
+		Release();
+		p = lp;
+		return *this;
+	}
+	CComPtr& operator=(const CComPtr& sp) { return *this = sp.p; }
+
+	operator T*() const { return p; }
+	T* operator->() const { return p; }
+	T** operator&() { return &p; }
+
+	void Release()
+	{
+		T* pTemp = p;
+		p = NULL;
+		if (pTemp)
+			pTemp->Release();
+	}
+	bool IsEqualObject(IUnknown* pOther)
+	{
+		if (p == NULL || pOther == NULL)
+			return p == NULL && pOther == NULL;
+		IUnknown* pUnk1 = NULL;
+		IUnknown* pUnk2 = NULL;
+		p->QueryInterface(IID_IUnknown, (void**)&pUnk1);
+		pOther->QueryInterface(IID_IUnknown, (void**)&pUnk2);
+		bool bEqual = pUnk1 == pUnk2;
+		pUnk1->Release();
+		pUnk2->Release();
+		return bEqual;
+	}
+	template <class Q>
+	HRESULT QueryInterface(Q** pp) const { return p->QueryInterface(pp); }
+
+	T* p;
+};
+
+class CComBSTR
+{
+public:
+	CComBSTR() : m_str(NULL) {}
+	CComBSTR(LPCOLESTR psz) : m_str(SysAllocString(psz)) {}
+	CComBSTR(LPCTSTR psz) : m_str(CString(psz).AllocSysString()) {}
+	CComBSTR(const CComBSTR& src) : m_str(SysAllocString(src.m_str)) {}
+	~CComBSTR() { SysFreeString(m_str); }
+
+	CComBSTR& operator=(const CComBSTR& src)
+	{
+		if (this != &src)
+		{
+			SysFreeString(m_str);
+			m_str = SysAllocString(src.m_str);
+		}
+		return *this;
+	}
+	CComBSTR& operator+=(LPCOLESTR psz)
+	{
+		std::wstring str(m_str ? m_str : L"");
+		str += psz ? psz : L"";
+		SysFreeString(m_str);
+		m_str = SysAllocString(str.c_str());
+		return *this;
+	}
+	CComBSTR& operator+=(LPCTSTR psz) { return *this += CComBSTR(psz); }
+
+	operator BSTR() const { return m_str; }
+	BSTR* operator&() { return &m_str; }
+	BSTR Detach()
+	{
+		BSTR bstr = m_str;
+		m_str = NULL;
+		return bstr;
+	}
+
+	BSTR m_str;
+};
+
+class CComVariant : public VARIANT
+{
+public:
+	CComVariant() { vt = VT_EMPTY; llVal = 0; }
+	// ATL's CComVariant(VT_EMPTY) is this one too: an VT_I4 of 0
+	CComVariant(int nSrc) { vt = VT_I4; llVal = 0; lVal = nSrc; }
+	CComVariant(LPCOLESTR psz) { vt = VT_BSTR; bstrVal = SysAllocString(psz); }
+	CComVariant(LPCTSTR psz) { vt = VT_BSTR; bstrVal = CString(psz).AllocSysString(); }
+	CComVariant(const CComVariant& src) { vt = VT_EMPTY; *this = src; }
+	~CComVariant() { VariantClear(this); }
+
+	CComVariant& operator=(const CComVariant& src)
+	{
+		if (this != &src)
+		{
+			VariantClear(this);
+			vt = src.vt;
+			llVal = src.llVal;
+			if (vt == VT_BSTR)
+				bstrVal = SysAllocString(src.bstrVal);
+		}
+		return *this;
+	}
+};
+
+// ATL converts into a buffer on the stack, a temporary CString here
+#define OLE2T(psz)			((LPCTSTR)CString((LPCWSTR)(psz)))
+#define OLE2CT(psz)			OLE2T(psz)
@@ -0,0 +1,126 @@
+// atlstr.h : the CString and ATL conversion pieces of MFC, narrow flavour
+
+#pragma once
+
+#include <string>
+#include <stdarg.h>
+#include <ctype.h>
+#include <windows.h>
+#include <tchar.h>
+#include <oleauto.h>
+
+class CString
+{
+public:
+	CString() {}
+	CString(LPCTSTR psz) : m_str(psz ? psz : "") {}
+	CString(const std::string& str) : m_str(str) {}		// CMarkup's MARKUP_STL strings
+	CString(LPCWSTR psz) { *this += psz; }
+
+	int GetLength() const { return (int)m_str.size(); }
+	bool IsEmpty() const { return m_str.empty(); }
+	void Empty() { m_str.clear(); }
+	TCHAR GetAt(int n) const { return m_str[n]; }
+	TCHAR operator[](int n) const { return m_str[n]; }
+	LPTSTR GetBuffer() { return &m_str[0]; }
+	void ReleaseBuffer() { m_str.resize(strlen(m_str.c_str())); }
+	operator LPCTSTR() const { return m_str.c_str(); }
+
+	bool operator==(LPCTSTR psz) const { return m_str == psz; }
+	bool operator!=(LPCTSTR psz) const { return m_str != psz; }
+	CString& operator+=(LPCTSTR psz) { m_str += psz; return *this; }
+	CString& operator+=(LPCWSTR psz) { return Append(psz, psz ? (int)wcslen(psz) : 0); }
+	// a wide char outside ASCII has no narrow counterpart here
+	CString& Append(LPCWSTR psz, int nLength)
+	{
+		for (int i = 0; i < nLength; i++)
+			m_str += psz[i] < 0x80 ? (char)psz[i] : '?';
+		return *this;
+	}
+	CString operator+(LPCTSTR psz) const { CString str(*this); return str += psz; }
+	CString operator+(const CString& str) const { return *this + (LPCTSTR)str; }
+	bool operator<(const CString& str) const { return m_str < str.m_str; }
+
+	int Find(LPCTSTR psz, int nStart = 0) const
+	{
+		size_t n = m_str.find(psz, nStart);
+		return n == std::string::npos ? -1 : (int)n;
+	}
+	int Find(TCHAR ch, int nStart = 0) const
+	{
+		size_t n = m_str.find(ch, nStart);
+		return n == std::string::npos ? -1 : (int)n;
+	}
+	// MFC clamps the positions to the string
+	CString Mid(int nFirst) const { return Mid(nFirst, GetLength()); }
+	CString Mid(int nFirst, int nCount) const
+	{
+		nFirst = nFirst < 0 ? 0 : nFirst > GetLength() ? GetLength() : nFirst;
+		return CString(m_str.substr(nFirst, nCount < 0 ? 0 : nCount));
+	}
+	CString Left(int nCount) const { return Mid(0, nCount); }
+	int Compare(LPCTSTR psz) const { return strcmp(m_str.c_str(), psz); }
+	int CompareNoCase(LPCTSTR psz) const { return strcasecmp(m_str.c_str(), psz); }
+	CString& MakeLower()
+	{
+		for (auto& c : m_str)
+			c = (char)tolower((unsigned char)c);
+		return *this;
+	}
+	CString& Trim() { return TrimRight().TrimLeft(); }
+	CString& TrimLeft()
+	{
+		size_t n = 0;
+		while (n < m_str.size() && isspace((unsigned char)m_str[n]))
+			n++;
+		m_str.erase(0, n);
+		return *this;
+	}
+	CString& TrimLeft(TCHAR ch)
+	{
+		m_str.erase(0, m_str.find_first_not_of(ch));
+		return *this;
+	}
+	CString& TrimRight()
+	{
+		size_t n = m_str.size();
+		while (n > 0 && isspace((unsigned char)m_str[n - 1]))
+			n--;
+		m_str.erase(n);
+		return *this;
+	}
+
+	void Format(LPCTSTR pszFormat, ...)
+	{
+		va_list args;
+		va_start(args, pszFormat);
+		int nLength = vsnprintf(NULL, 0, pszFormat, args);
+		va_end(args);
+		m_str.assign(nLength > 0 ? nLength : 0, 0);
+		va_start(args, pszFormat);
+		vsnprintf(&m_str[0], m_str.size() + 1, pszFormat, args);
+		va_end(args);
+	}
+	BSTR AllocSysString() const
+	{
+		BSTR bstr = SysAllocStringLen(NULL, (UINT)m_str.size());
+		for (size_t i = 0; i < m_str.size(); i++)
+			bstr[i] = (unsigned char)m_str[i];
+		return bstr;
+	}
+
+private:
+	std::string m_str;
+};
+
+inline CString operator+(LPCTSTR psz, const CString& str) { return CString(psz) += str; }
+
+typedef CString				CStringA;
+
+namespace ATL {}	// CString lives in ATL, the headers say "using namespace ATL"
+
+// ATL converts into buffers USES_CONVERSION declares, one buffer here
+#define USES_CONVERSION		CString _strConversion; (void)_strConversion
+#define W2A(psz)			((_strConversion = CString(psz)).GetBuffer())
+
+#define ATLTRACE(...)		((void)0)
@@ -0,0 +1,5 @@
+// crtdbg.h : debug CRT, the tests check results themselves
+
+#pragma once
+
+#define _ASSERTE(expr)		((void)0)
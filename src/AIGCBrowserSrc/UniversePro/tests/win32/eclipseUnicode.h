@@ -0,0 +1,11 @@
+// eclipseUnicode.h : ../eclipseunicode.h, whose name only matches on Windows
+//
+// Its _WIN32 branch, which is all there is to it.
+
+#pragma once
+
+#include <windows.h>
+#include <tchar.h>
+#include <ctype.h>
+
+#define _T_ECLIPSE			_T
@@ -0,0 +1,19 @@
+// jniforchrome.h : the JNI header of CommonFile with jni_md.h for gcc
+//
+// CommonFile/jni_md.h is the MSVC one (__declspec, __stdcall, __int64), its
+// guard is set here so the types below take its place.
+
+#pragma once
+
+#include <stdint.h>
+
+#define _JAVASOFT_JNI_MD_H_
+#define JNIEXPORT			__attribute__((visibility("default")))
+#define JNIIMPORT
+#define JNICALL
+
+typedef int32_t				jint;
+typedef int64_t				jlong;
+typedef signed char			jbyte;
+
+#include "../../../CommonFile/jniforchrome.h"
@@ -0,0 +1,621 @@
+// msxml2.h : an in-memory DOM with the MSXML calls CTangramXmlParse makes
+//
+// Elements, attributes and text, a small parser for loadXML and load, and
+// get_xml writing a subtree the way MSXML does: attribute values quoted with
+// '"', '&', '<', '>' and '"' escaped in them, '&', '<' and '>' in text, and
+// an element without children closed as "<tag/>". Child lists and attribute
+// maps are snapshots taken when they are asked for. A node keeps a plain
+// pointer to its document, so a document has to outlive its nodes.
+
+#pragma once
+
+#include <atlbase.h>
+#include <string>
+#include <vector>
+
+static const CLSID CLSID_DOMDocument = { 1 };
+static const IID IID_IXMLDOMDocument = { 2 };
+
+enum DOMNodeType
+{
+	NODE_INVALID = 0,
+	NODE_ELEMENT = 1,
+	NODE_ATTRIBUTE = 2,
+	NODE_TEXT = 3,
+	NODE_COMMENT = 8,
+	NODE_DOCUMENT = 9,
+};
+
+class IXMLDOMDocument;
+class IXMLDOMNodeList;
+class IXMLDOMNamedNodeMap;
+
+class IXMLDOMNode : public IUnknown
+{
+public:
+	IXMLDOMNode(DOMNodeType nType, IXMLDOMDocument* pDoc) : m_nType(nType), m_pDoc(pDoc), m_pParent(NULL) {}
+	~IXMLDOMNode()
+	{
+		for (IXMLDOMNode* pChild : m_vChildren)
+		{
+			pChild->m_pParent = NULL;
+			pChild->Release();
+		}
+	}
+
+	HRESULT get_nodeName(BSTR* pName)
+	{
+		const wchar_t* psz = m_nType == NODE_TEXT ? L"#text" : m_nType == NODE_COMMENT ? L"#comment" : m_nType == NODE_DOCUMENT ? L"#document" : m_strName.c_str();
+		*pName = SysAllocString(psz);
+		return S_OK;
+	}
+	HRESULT get_nodeType(DOMNodeType* pType)
+	{
+		*pType = m_nType;
+		return S_OK;
+	}
+	HRESULT get_text(BSTR* pText)
+	{
+		std::wstring strText;
+		AppendText(strText);
+		*pText = SysAllocString(strText.c_str());
+		return S_OK;
+	}
+	HRESULT put_text(BSTR bstrText)
+	{
+		if (m_nType != NODE_ELEMENT)
+		{
+			m_strValue = bstrText ? bstrText : L"";
+			return S_OK;
+		}
+		while (!m_vChildren.empty())
+			Remove(m_vChildren.back());
+		IXMLDOMNode* pText = new IXMLDOMNode(NODE_TEXT, m_pDoc);
+		pText->m_strValue = bstrText ? bstrText : L"";
+		Append(pText);
+		return S_OK;
+	}
+	HRESULT get_nodeTypedValue(VARIANT* pVar)
+	{
+		VariantClear(pVar);
+		pVar->vt = VT_BSTR;
+		return get_text(&pVar->bstrVal);
+	}
+	HRESULT get_xml(BSTR* pXml)
+	{
+		std::wstring strXml;
+		AppendXml(strXml);
+		*pXml = SysAllocString(strXml.c_str());
+		return S_OK;
+	}
+	HRESULT get_ownerDocument(IXMLDOMDocument** ppDoc);
+	HRESULT get_childNodes(IXMLDOMNodeList** ppList);
+	HRESULT get_attributes(IXMLDOMNamedNodeMap** ppMap);
+
+	HRESULT appendChild(IXMLDOMNode* pNewChild, IXMLDOMNode** ppOut)
+	{
+		if (pNewChild == NULL || !CanAdopt(pNewChild))
+			return E_FAIL;
+		pNewChild->AddRef();
+		if (pNewChild->m_pParent)
+			pNewChild->m_pParent->Remove(pNewChild);
+		Append(pNewChild);
+		pNewChild->Release();
+		return Out(pNewChild, ppOut);
+	}
+	HRESULT removeChild(IXMLDOMNode* pOldChild, IXMLDOMNode** ppOut)
+	{
+		if (pOldChild == NULL || pOldChild->m_pParent != this)
+			return E_FAIL;
+		pOldChild->AddRef();
+		Remove(pOldChild);
+		HRESULT hr = Out(pOldChild, ppOut);
+		pOldChild->Release();
+		return hr;
+	}
+	HRESULT replaceChild(IXMLDOMNode* pNewChild, IXMLDOMNode* pOldChild, IXMLDOMNode** ppOut)
+	{
+		if (pNewChild == NULL || pOldChild == NULL || pOldChild->m_pParent != this || !CanAdopt(pNewChild))
+			return E_FAIL;
+		if (pNewChild == pOldChild)
+			return Out(pOldChild, ppOut);
+		pNewChild->AddRef();
+		pOldChild->AddRef();
+		if (pNewChild->m_pParent)
+			pNewChild->m_pParent->Remove(pNewChild);
+		size_t nIndex = IndexOf(pOldChild);
+		pOldChild->m_pParent = NULL;
+		pOldChild->Release();
+		m_vChildren[nIndex] = pNewChild;
+		pNewChild->m_pParent = this;
+		HRESULT hr = Out(pOldChild, ppOut);
+		pOldChild->Release();
+		return hr;
+	}
+
+	// the DOM behind the interfaces
+	DOMNodeType m_nType;
+	IXMLDOMDocument* m_pDoc;
+	IXMLDOMNode* m_pParent;
+	std::wstring m_strName;
+	std::wstring m_strValue;
+	std::vector<std::pair<std::wstring, std::wstring> > m_vAttrs;
+	std::vector<IXMLDOMNode*> m_vChildren;
+
+	void Append(IXMLDOMNode* pChild)
+	{
+		pChild->AddRef();
+		pChild->m_pParent = this;
+		m_vChildren.push_back(pChild);
+	}
+	void Remove(IXMLDOMNode* pChild)
+	{
+		m_vChildren.erase(m_vChildren.begin() + IndexOf(pChild));
+		pChild->m_pParent = NULL;
+		pChild->Release();
+	}
+	size_t IndexOf(IXMLDOMNode* pChild) const
+	{
+		size_t n = 0;
+		while (m_vChildren[n] != pChild)
+			n++;
+		return n;
+	}
+
+	static void AppendEscaped(std::wstring& strXml, const std::wstring& str, bool bAttr)
+	{
+		for (wchar_t ch : str)
+		{
+			switch (ch)
+			{
+			case L'&': strXml += L"&amp;"; break;
+			case L'<': strXml += L"&lt;"; break;
+			case L'>': strXml += L"&gt;"; break;
+			case L'"':
+				if (bAttr)
+				{
+					strXml += L"&quot;";
+					break;
+				}
+				// fall through
+			default: strXml += ch; break;
+			}
+		}
+	}
+	void AppendXml(std::wstring& strXml) const
+	{
+		switch (m_nType)
+		{
+		case NODE_TEXT:
+			AppendEscaped(strXml, m_strValue, false);
+			return;
+		case NODE_COMMENT:
+			strXml += L"<!--" + m_strValue + L"-->";
+			return;
+		case NODE_ATTRIBUTE:
+			strXml += m_strName + L"=\"";
+			AppendEscaped(strXml, m_strValue, true);
+			strXml += L"\"";
+			return;
+		case NODE_ELEMENT:
+			break;
+		default:
+			for (IXMLDOMNode* pChild : m_vChildren)
+				pChild->AppendXml(strXml);
+			return;
+		}
+		strXml += L"<" + m_strName;
+		for (const auto& attr : m_vAttrs)
+		{
+			strXml += L" " + attr.first + L"=\"";
+			AppendEscaped(strXml, attr.second, true);
+			strXml += L"\"";
+		}
+		if (m_vChildren.empty())
+		{
+			strXml += L"/>";
+			return;
+		}
+		strXml += L">";
+		for (IXMLDOMNode* pChild : m_vChildren)
+			pChild->AppendXml(strXml);
+		strXml += L"</" + m_strName + L">";
+	}
+	void AppendText(std::wstring& strText) const
+	{
+		if (m_nType == NODE_TEXT || m_nType == NODE_ATTRIBUTE || m_nType == NODE_COMMENT)
+			strText += m_strValue;
+		else
+		{
+			for (IXMLDOMNode* pChild : m_vChildren)
+			{
+				if (pChild->m_nType != NODE_COMMENT)
+					pChild->AppendText(strText);
+			}
+		}
+	}
+
+protected:
+	bool CanAdopt(IXMLDOMNode* pChild) const
+	{
+		// not under itself
+		for (const IXMLDOMNode* pNode = this; pNode; pNode = pNode->m_pParent)
+		{
+			if (pNode == pChild)
+				return false;
+		}
+		return pChild->m_nType != NODE_DOCUMENT && pChild->m_nType != NODE_ATTRIBUTE;
+	}
+	static HRESULT Out(IXMLDOMNode* pNode, IXMLDOMNode** ppOut)
+	{
+		if (ppOut)
+		{
+			pNode->AddRef();
+			*ppOut = pNode;
+		}
+		return S_OK;
+	}
+};
+
+class IXMLDOMElement : public IXMLDOMNode
+{
+public:
+	IXMLDOMElement(IXMLDOMDocument* pDoc, LPCOLESTR pszName) : IXMLDOMNode(NODE_ELEMENT, pDoc) { m_strName = pszName; }
+
+	HRESULT get_tagName(BSTR* pName) { return get_nodeName(pName); }
+	HRESULT getAttribute(BSTR bstrName, VARIANT* pVar)
+	{
+		VariantClear(pVar);
+		for (const auto& attr : m_vAttrs)
+		{
+			if (attr.first == bstrName)
+			{
+				pVar->vt = VT_BSTR;
+				pVar->bstrVal = SysAllocString(attr.second.c_str());
+				return S_OK;
+			}
+		}
+		pVar->vt = VT_NULL;
+		return S_FALSE;
+	}
+	HRESULT setAttribute(BSTR bstrName, VARIANT var)
+	{
+		if (bstrName == NULL || *bstrName == 0 || var.vt != VT_BSTR)
+			return E_FAIL;
+		std::wstring strValue(var.bstrVal ? var.bstrVal : L"");
+		for (auto& attr : m_vAttrs)
+		{
+			if (attr.first == bstrName)
+			{
+				attr.second = strValue;
+				return S_OK;
+			}
+		}
+		m_vAttrs.push_back(std::make_pair(std::wstring(bstrName), strValue));
+		return S_OK;
+	}
+};
+
+class IXMLDOMNodeList : public IUnknown
+{
+public:
+	~IXMLDOMNodeList()
+	{
+		for (IXMLDOMNode* pNode : m_vNodes)
+			pNode->Release();
+	}
+
+	HRESULT get_length(long* pLength)
+	{
+		*pLength = (long)m_vNodes.size();
+		return S_OK;
+	}
+	HRESULT get_item(long nIndex, IXMLDOMNode** ppNode)
+	{
+		*ppNode = NULL;
+		if (nIndex < 0 || nIndex >= (long)m_vNodes.size())
+			return S_FALSE;
+		m_vNodes[nIndex]->AddRef();
+		*ppNode = m_vNodes[nIndex];
+		return S_OK;
+	}
+
+	void Add(IXMLDOMNode* pNode)
+	{
+		pNode->AddRef();
+		m_vNodes.push_back(pNode);
+	}
+
+private:
+	std::vector<IXMLDOMNode*> m_vNodes;
+};
+
+// attributes are nodes of their own only while a map hands them out
+class IXMLDOMNamedNodeMap : public IXMLDOMNodeList
+{
+};
+
+class IXMLDOMDocument : public IXMLDOMNode
+{
+public:
+	IXMLDOMDocument() : IXMLDOMNode(NODE_DOCUMENT, NULL) { m_pDoc = this; }
+
+	HRESULT createElement(BSTR bstrName, IXMLDOMElement** ppElem)
+	{
+		*ppElem = NULL;
+		if (bstrName == NULL || *bstrName == 0)
+			return E_FAIL;
+		*ppElem = new IXMLDOMElement(this, bstrName);
+		(*ppElem)->AddRef();
+		return S_OK;
+	}
+	HRESULT get_documentElement(IXMLDOMElement** ppElem)
+	{
+		*ppElem = NULL;
+		for (IXMLDOMNode* pChild : m_vChildren)
+		{
+			if (pChild->m_nType == NODE_ELEMENT)
+				return pChild->QueryInterface(ppElem);
+		}
+		return S_FALSE;
+	}
+	HRESULT loadXML(BSTR bstrXml, VARIANT_BOOL* pSuccess)
+	{
+		while (!m_vChildren.empty())
+			Remove(m_vChildren.back());
+		const wchar_t* p = bstrXml ? bstrXml : L"";
+		bool bOk = Parse(p, this) && *p == 0 && !m_vChildren.empty();
+		if (!bOk)
+		{
+			while (!m_vChildren.empty())
+				Remove(m_vChildren.back());
+		}
+		*pSuccess = bOk ? VARIANT_TRUE : VARIANT_FALSE;
+		return bOk ? S_OK : S_FALSE;
+	}
+	HRESULT load(VARIANT varSource, VARIANT_BOOL* pSuccess)
+	{
+		*pSuccess = VARIANT_FALSE;
+		if (varSource.vt != VT_BSTR)
+			return E_FAIL;
+		FILE* pFile = fopen(CString(varSource.bstrVal), "rb");
+		if (pFile == NULL)
+			return S_FALSE;
+		std::string strFile;
+		char buf[4096];
+		size_t nRead;
+		while ((nRead = fread(buf, 1, sizeof(buf), pFile)) > 0)
+			strFile.append(buf, nRead);
+		fclose(pFile);
+		return loadXML(CComBSTR(strFile.c_str()), pSuccess);
+	}
+	HRESULT save(VARIANT varDest)
+	{
+		if (varDest.vt != VT_BSTR)
+			return E_FAIL;
+		FILE* pFile = fopen(CString(varDest.bstrVal), "wb");
+		if (pFile == NULL)
+			return E_FAIL;
+		std::wstring strXml;
+		AppendXml(strXml);
+		CString str(strXml.c_str());
+		fwrite((LPCTSTR)str, 1, str.GetLength(), pFile);
+		fclose(pFile);
+		return S_OK;
+	}
+
+protected:
+	HRESULT QueryOther(REFIID iid, void** ppv)
+	{
+		if (iid.nId != IID_IXMLDOMDocument.nId)
+			return IUnknown::QueryOther(iid, ppv);
+		AddRef();
+		*ppv = static_cast<IXMLDOMDocument*>(this);
+		return S_OK;
+	}
+
+	static bool IsSpace(wchar_t ch) { return ch == L' ' || ch == L'\t' || ch == L'\r' || ch == L'\n'; }
+	static bool IsNameChar(wchar_t ch) { return ch && !IsSpace(ch) && !wcschr(L"<>/=!?\"'", ch); }
+
+	static std::wstring Decode(const wchar_t* p, const wchar_t* pEnd)
+	{
+		static const struct { const wchar_t* pszName; wchar_t ch; } s_aEntities[] = {
+			{ L"&amp;", L'&' }, { L"&lt;", L'<' }, { L"&gt;", L'>' }, { L"&quot;", L'"' }, { L"&apos;", L'\'' },
+		};
+		std::wstring str;
+		while (p < pEnd)
+		{
+			bool bEntity = false;
+			if (*p == L'&')
+			{
+				for (const auto& entity : s_aEntities)
+				{
+					size_t nLen = wcslen(entity.pszName);
+					if ((size_t)(pEnd - p) >= nLen && wcsncmp(p, entity.pszName, nLen) == 0)
+					{
+						str += entity.ch;
+						p += nLen;
+						bEntity = true;
+						break;
+					}
+				}
+			}
+			if (!bEntity)
+				str += *p++;
+		}
+		return str;
+	}
+
+	// the content of pParent up to its end tag, or the document's content
+	bool Parse(const wchar_t*& p, IXMLDOMNode* pParent)
+	{
+		bool bDocument = pParent->m_nType == NODE_DOCUMENT;
+		while (*p)
+		{
+			if (*p != L'<')
+			{
+				const wchar_t* pBegin = p;
+				while (*p && *p != L'<')
+					p++;
+				std::wstring strText = Decode(pBegin, p);
+				if (bDocument)
+				{
+					// only white space around the document element
+					for (wchar_t ch : strText)
+					{
+						if (!IsSpace(ch))
+							return false;
+					}
+					continue;
+				}
+				IXMLDOMNode* pText = new IXMLDOMNode(NODE_TEXT, this);
+				pText->m_strValue = strText;
+				pParent->Append(pText);
+				continue;
+			}
+			if (wcsncmp(p, L"<?", 2) == 0)
+			{
+				const wchar_t* pEnd = wcsstr(p, L"?>");
+				if (pEnd == NULL)
+					return false;
+				p = pEnd + 2;
+				continue;
+			}
+			if (wcsncmp(p, L"<!--", 4) == 0)
+			{
+				const wchar_t* pEnd = wcsstr(p + 4, L"-->");
+				if (pEnd == NULL)
+					return false;
+				IXMLDOMNode* pComment = new IXMLDOMNode(NODE_COMMENT, this);
+				pComment->m_strValue.assign(p + 4, pEnd);
+				pParent->Append(pComment);
+				p = pEnd + 3;
+				continue;
+			}
+			if (p[1] == L'/')
+			{
+				if (bDocument)
+					return false;
+				p += 2;
+				size_t nLen = pParent->m_strName.size();
+				if (wcsncmp(p, pParent->m_strName.c_str(), nLen) != 0)
+					return false;
+				p += nLen;
+				while (IsSpace(*p))
+					p++;
+				if (*p != L'>')
+					return false;
+				p++;
+				return true;
+			}
+			if (!ParseElement(p, pParent))
+				return false;
+		}
+		return bDocument;
+	}
+
+	bool ParseElement(const wchar_t*& p, IXMLDOMNode* pParent)
+	{
+		if (pParent->m_nType == NODE_DOCUMENT && !pParent->m_vChildren.empty())
+		{
+			for (IXMLDOMNode* pChild : pParent->m_vChildren)
+			{
+				if (pChild->m_nType == NODE_ELEMENT)
+					return false;	// a second document element
+			}
+		}
+		const wchar_t* pName = ++p;
+		while (IsNameChar(*p))
+			p++;
+		if (p == pName)
+			return false;
+		IXMLDOMElement* pElem = new IXMLDOMElement(this, std::wstring(pName, p).c_str());
+		pParent->Append(pElem);
+		for (;;)
+		{
+			while (IsSpace(*p))
+				p++;
+			if (wcsncmp(p, L"/>", 2) == 0)
+			{
+				p += 2;
+				return true;
+			}
+			if (*p == L'>')
+			{
+				p++;
+				return Parse(p, pElem);
+			}
+			const wchar_t* pAttr = p;
+			while (IsNameChar(*p))
+				p++;
+			if (p == pAttr)
+				return false;
+			std::wstring strName(pAttr, p);
+			while (IsSpace(*p))
+				p++;
+			if (*p++ != L'=')
+				return false;
+			while (IsSpace(*p))
+				p++;
+			wchar_t chQuote = *p++;
+			if (chQuote != L'"' && chQuote != L'\'')
+				return false;
+			const wchar_t* pValue = p;
+			while (*p && *p != chQuote)
+				p++;
+			if (*p == 0)
+				return false;
+			CComVariant var(Decode(pValue, p).c_str());
+			if (pElem->setAttribute((BSTR)strName.c_str(), var) != S_OK)
+				return false;
+			p++;
+		}
+	}
+};
+
+inline HRESULT IXMLDOMNode::get_ownerDocument(IXMLDOMDocument** ppDoc)
+{
+	*ppDoc = m_nType == NODE_DOCUMENT ? NULL : m_pDoc;
+	if (*ppDoc == NULL)
+		return S_FALSE;
+	(*ppDoc)->AddRef();
+	return S_OK;
+}
+
+inline HRESULT IXMLDOMNode::get_childNodes(IXMLDOMNodeList** ppList)
+{
+	*ppList = new IXMLDOMNodeList;
+	(*ppList)->AddRef();
+	for (IXMLDOMNode* pChild : m_vChildren)
+		(*ppList)->Add(pChild);
+	return S_OK;
+}
+
+inline HRESULT IXMLDOMNode::get_attributes(IXMLDOMNamedNodeMap** ppMap)
+{
+	*ppMap = NULL;
+	if (m_nType != NODE_ELEMENT)
+		return S_FALSE;
+	*ppMap = new IXMLDOMNamedNodeMap;
+	(*ppMap)->AddRef();
+	for (const auto& attr : m_vAttrs)
+	{
+		IXMLDOMNode* pAttr = new IXMLDOMNode(NODE_ATTRIBUTE, m_pDoc);
+		pAttr->m_strName = attr.first;
+		pAttr->m_strValue = attr.second;
+		(*ppMap)->Add(pAttr);
+	}
+	return S_OK;
+}
+
+inline HRESULT CoCreateInstance(REFCLSID clsid, IUnknown* pOuter, DWORD, REFIID iid, void** ppv)
+{
+	*ppv = NULL;
+	if (clsid.nId != CLSID_DOMDocument.nId || pOuter != NULL)
+		return E_NOINTERFACE;
+	IXMLDOMDocument* pDoc = new IXMLDOMDocument;
+	pDoc->AddRef();
+	HRESULT hr = pDoc->QueryInterface(iid, ppv);
+	pDoc->Release();
+	return hr;
+}
@@ -0,0 +1,64 @@
+// oleauto.h : BSTR and VARIANT, the automation types the MSXML calls pass
+//
+// A BSTR is a plain heap copy here, without the length prefix.
+
+#pragma once
+
+#include <windows.h>
+#include <wchar.h>
+
+typedef wchar_t				OLECHAR;
+typedef OLECHAR*			BSTR;
+typedef const OLECHAR*		LPCOLESTR;
+typedef SHORT				VARIANT_BOOL;
+typedef unsigned short		VARTYPE;
+
+#define VARIANT_TRUE		((VARIANT_BOOL)-1)
+#define VARIANT_FALSE		((VARIANT_BOOL)0)
+
+enum VARENUM
+{
+	VT_EMPTY = 0,
+	VT_NULL = 1,
+	VT_I4 = 3,
+	VT_BSTR = 8,
+	VT_BOOL = 11,
+	VT_I8 = 20,
+};
+
+inline BSTR SysAllocStringLen(const OLECHAR* psz, UINT nLen)
+{
+	BSTR bstr = new OLECHAR[nLen + 1];
+	if (psz)
+		wmemcpy(bstr, psz, nLen);
+	bstr[nLen] = 0;
+	return bstr;
+}
+
+inline BSTR SysAllocString(const OLECHAR* psz)
+{
+	return psz ? SysAllocStringLen(psz, (UINT)wcslen(psz)) : NULL;
+}
+
+inline void SysFreeString(BSTR bstr) { delete[] bstr; }
+
+struct VARIANT
+{
+	VARTYPE vt;
+	union
+	{
+		LONG lVal;
+		LONGLONG llVal;
+		VARIANT_BOOL boolVal;
+		BSTR bstrVal;
+	};
+};
+
+inline HRESULT VariantClear(VARIANT* pVar)
+{
+	if (pVar->vt == VT_BSTR)
+		SysFreeString(pVar->bstrVal);
+	pVar->vt = VT_EMPTY;
+	pVar->llVal = 0;
+	return S_OK;
+}
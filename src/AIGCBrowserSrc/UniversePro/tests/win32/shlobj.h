@@ -0,0 +1,3 @@
+// shlobj.h : the shell folders, unused by the sources under test
+
+#pragma once
@@ -0,0 +1,17 @@
+// stdafx.h : stands in for the MFC precompiled header in the headless tests
+
+#pragma once
+
+#include <windows.h>
+#include <tchar.h>
+#include <crtdbg.h>
+#include <atlstr.h>
+#include <CommonUniverse.h>
+#include <jniforchrome.h>		// CommonUniverse.h brings it in the real header
+#include <vector>
+#include <map>
+#include <string>
+#include <algorithm>
+#include <memory>
+
+using namespace std;
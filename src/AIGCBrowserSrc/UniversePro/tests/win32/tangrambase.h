@@ -0,0 +1,3 @@
+// tangrambase.h : the COM interfaces eclipseCommon.h pulls in, unused by the sources under test
+
+#pragma once
@@ -0,0 +1,49 @@
+// tchar.h : generic-text mappings, narrow flavour only
+
+#pragma once
+
+#include <string.h>
+#include <strings.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <ctype.h>
+
+#define _T(x)				x
+#define _tcslen				strlen
+#define _tcschr				strchr
+#define _tcsstr				strstr
+#define _tcsrchr			strrchr
+#define _tcscmp				strcmp
+#define _tcsncmp			strncmp
+#define _tcsicmp			strcasecmp
+#define _tcsnicmp			strncasecmp
+#define _tcscpy				strcpy
+#define _tcsncpy			strncpy
+#define _tcsdup				strdup
+#define _tcstol				strtol
+#define _tcstoul			strtoul
+#define _ttoi				atoi
+#define _ttoi64				atoll
+#define _stprintf			sprintf
+#define _sntprintf			snprintf
+#define _stscanf			sscanf
+#define _tfopen				fopen
+#define _ftprintf			fprintf
+#define _fgetts				fgets
+#define _fputtc				fputc
+#define _fputts				fputs
+#define _tremove			remove
+#define _tstat				stat
+#define _istspace(c)		isspace((unsigned char)(c))
+
+inline char* _tcslwr(char* psz)
+{
+	for (char* p = psz; *p; p++)
+		*p = (char)tolower((unsigned char)*p);
+	return psz;
+}
+
+// the MSVC CRT names the narrow mappings of other headers use
+#define strnicmp			strncasecmp
+#define _strdup				strdup
+#define _stat				stat